@@ -28,6 +28,7 @@ struct AIPromptConfig {
     int context_length = 2048;
     bool use_gpu = true;
     int gpu_layers = 32;
+    int threads = 0;           // Inference threads (0 = one per hardware thread)
     
     AIPromptConfig();
     void LoadDefaultPrompts();
@@ -84,6 +85,16 @@ public:
     virtual ContentAnalysis AnalyzeText(const std::string& text,
                                        const std::string& context = "") = 0;
 
+    // Text embeddings, one L2-comparable vector per text. Engines without
+    // embedding support return false and report dimension 0.
+    virtual bool Embed(const std::vector<std::string>& texts,
+                       std::vector<std::vector<float>>& embeddings) {
+        (void)texts;
+        embeddings.clear();
+        return false;
+    }
+    virtual int GetEmbeddingDimension() const { return 0; }
+
     // Configuration
     virtual void UpdateConfig(const AIPromptConfig& config) = 0;
     virtual AIPromptConfig GetConfig() const = 0;
@@ -130,6 +141,13 @@ public:
                                                     const std::string& window_title,
                                                     const std::string& app_name);
 
+    // Embeddings for semantic search. The model tag changes whenever the
+    // vectors would (another model or dimension), so stored vectors can be
+    // matched to the model that produced them.
+    bool Embed(const std::vector<std::string>& texts, std::vector<std::vector<float>>& embeddings);
+    int GetEmbeddingDimension() const;
+    std::string GetEmbeddingModelTag() const;
+
     // Productivity analysis
     bool IsProductiveActivity(const ContentAnalysis& analysis) const;
     int CalculateProductivityScore(const std::vector<ContentAnalysis>& recent_activities) const;
@@ -142,6 +160,7 @@ public:
     void SetProductivityThresholds(float min_focused_ratio = 0.6f, 
                                   float max_distraction_level = 3.0f);
     void UpdatePrompts(const AIPromptConfig& config);
+    void SetThreadCount(int threads);  // Applied before the next inference
     void EnableLearning(bool enable = true);  // Future: learn from user feedback
 
     // Statistics and monitoring
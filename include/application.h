@@ -6,12 +6,27 @@
 #include "ai_engine.h"
 #include "storage_engine.h"
 #include "web_server.h"
+#include "startup_sequencer.h"
+#include "thread_pool.h"
+#include "memory_governor.h"
+#include "cpu_governor.h"
+#include "deferred_work_queue.h"
+#include "fingerprint_index.h"
+#include "ocr_scheduler.h"
+#include "semantic_search.h"
+#include "capture_recording.h"
+#include "replication.h"
 #include <memory>
 #include <vector>
 #include <deque>
+#include <atomic>
+#include <array>
+#include <mutex>
 
 namespace work_assistant {
 
+class ConfigManager;
+
 class Application {
 public:
     Application();
@@ -21,13 +36,77 @@ public:
     void Run();
     void Shutdown();
     
+    // Service integration. RequestStop() is async-signal-safe and makes Run()
+    // return; Shutdown() then drains in-flight OCR/AI work before teardown.
+    void RequestStop();
+    bool IsStopRequested() const;
+    bool IsHealthy() const;
+    bool ReloadConfiguration(const ConfigManager& config);
+    // [performance] settings; call before Initialize() so the CPU governor
+    // starts with them, ReloadConfiguration() reapplies them live
+    void ApplyPerformanceConfig(const ConfigManager& config);
+    // [ocr_app_importance] weights for the OCR scheduler; applied at once,
+    // ReloadConfiguration() replaces them
+    void ApplyOCRConfig(const ConfigManager& config);
+    void SetDrainTimeout(std::chrono::milliseconds timeout);
+
+    // Profiling harness; call before Initialize(). Recording writes every
+    // captured frame and window event to path; replay feeds a recording
+    // through the pipeline instead of the screen and stops the run at its end.
+    bool SetCaptureRecording(const std::string& path);
+    bool SetCaptureReplay(const std::string& path, const CaptureReplayOptions& options);
+
+    // Platform capture backend ([monitoring] capture_backend); call before
+    // Initialize()
+    void SetCaptureBackend(CaptureBackend backend);
+
+    // Multi-workstation setup; call before Initialize(). An aggregator runs
+    // only storage and the web server, listening on all interfaces and
+    // accepting workstation deltas that carry its shared token; a
+    // workstation with a replication target pushes its window events and
+    // analyses there in the background.
+    void SetWebPort(int port);
+    bool SetAggregatorMode(bool enabled, const std::string& token);
+    bool SetReplication(const ReplicationConfig& config);
+    
 private:
+    // Startup stages, scheduled by m_startup
+    void RegisterStartupStages();
+    bool InitializeDirectories();
+    bool InitializeWindowMonitor();
+    bool InitializeScreenCapture();
+    bool InitializeOCR();
+    bool LoadDeferredOCREngines();
+    bool InitializeAI();
+    bool InitializeStorage();
+    bool InitializeWebServer();
+    OCRManager* ReadyOCR() const;
+    AIContentAnalyzer* ReadyAI() const;
+    WebServer* ReadyWebServer() const;
+    bool StartDeferredWork();
+    bool StartReplication();
+    bool RunStartupMaintenance();
+    DeferredJobResult RunStorageMaintenanceChunk(DeferredJobRecord& job);
+    DeferredJobResult RunSemanticEmbeddingChunk(DeferredJobRecord& job);
+    void OnFirstFrame();
+    void DrainPendingWork();
+    void RegisterMemoryConsumers();
+    void UnregisterMemoryConsumers();
+    void RegisterCpuConsumers();
+    void UnregisterCpuConsumers();
+    void ApplyCaptureRate();
+
     void OnWindowEvent(const WindowEvent& event);
     void OnScreenCaptureFrame(const CaptureFrame& frame);
     void ProcessFrameWithOCR(const CaptureFrame& frame);
     void ProcessContentWithAI(const OCRDocument& ocr_result, 
                              const std::string& window_title,
-                             const std::string& app_name);
+                             const std::string& app_name,
+                             uint64_t frameHash = 0,
+                             uint64_t ocrRecordId = 0);
+    bool ReuseKnownScreen(uint64_t frameHash);
+    uint64_t PublishAnalysis(const ContentAnalysis& analysis);
+    std::vector<ContentAnalysis> GetRecentActivities() const;
     
     // Analysis and reporting
     void PrintProductivitySummary();
@@ -38,18 +117,103 @@ private:
     std::unique_ptr<IWindowMonitor> m_windowMonitor;
     std::unique_ptr<ScreenCaptureManager> m_screenCapture;
     std::unique_ptr<OCRManager> m_ocrManager;
+    std::shared_ptr<ITextSource> m_textSource;  // Accessibility text, read before pixel OCR
     std::unique_ptr<AIContentAnalyzer> m_aiAnalyzer;
     std::shared_ptr<EncryptedStorageManager> m_storageManager;
     std::unique_ptr<WebServer> m_webServer;
+
+    // Staged startup
+    std::unique_ptr<WorkAssistant::ThreadPool> m_startupPool;
+    std::unique_ptr<StartupSequencer> m_startup;
+    std::chrono::steady_clock::time_point m_initStartTime;
+    std::atomic<bool> m_firstFrameSeen;
+    static constexpr int TARGET_FIRST_CAPTURE_MS = 300;
+
+    // OCR, AI and the web server start after the first frame, while the
+    // capture and window event threads already run. Their stages set these
+    // once the member is in place; other threads go through the Ready*()
+    // accessors, which return null until then.
+    std::atomic<bool> m_ocrReady;
+    std::atomic<bool> m_aiReady;
+    std::atomic<bool> m_webServerReady;
+
+    // Service state
+    std::atomic<bool> m_stopRequested;
+    std::atomic<int64_t> m_lastHeartbeatMs;   // Main loop liveness for the watchdog
+    std::atomic<int> m_inFlightTasks;         // Detached OCR/AI workers still running
+    std::atomic<size_t> m_ocrIntervalFrames;
+    std::chrono::milliseconds m_drainTimeout;
+    int m_webPort;
+    CaptureBackend m_captureBackend;
+    CpuGovernorConfig m_cpuGovernorConfig;
+    static constexpr int HEARTBEAT_TIMEOUT_MS = 5000;
+
+    // Memory governor integration
+    std::vector<int> m_memoryConsumers;
+    std::atomic<int> m_memoryTaskLimit;
+    std::atomic<size_t> m_lastFrameBytes;
+    std::atomic<bool> m_multimodalUnloaded;   // Unloaded by the governor, not the user
+
+    // CPU governor integration; the effective OCR concurrency is the lower
+    // of the memory and CPU limits
+    std::vector<int> m_cpuConsumers;
+    std::atomic<int> m_cpuTaskLimit;
+    std::atomic<int> m_baseCaptureFps;        // Configured rate before CPU scaling
+    std::atomic<double> m_cpuScale;
+    std::atomic<bool> m_cpuYielding;
+    std::atomic<int> m_aiThreads;             // Inference threads for the budget, 0 = engine default
+    static constexpr int MAX_PIPELINE_TASKS = 8;
+
+    // Monitored frames are captured at 1/DETECTION_SCALE for change
+    // detection; OCR re-reads at full resolution
+    static constexpr int DETECTION_SCALE = 4;
+
+    // Heavy, non-urgent work that waits for the user to go idle. Created
+    // up front so window events can report activity before it starts.
+    std::unique_ptr<DeferredWorkQueue> m_deferredWork;
     
-    // Activity history for pattern analysis
+    // Screens already processed, by frame hash; a near match reuses the
+    // stored analysis instead of running OCR and the model again. Created
+    // up front, opened once storage is available.
+    std::unique_ptr<FingerprintIndex> m_fingerprints;
+    static constexpr int FINGERPRINT_MATCH_DISTANCE = 4;
+
+    // Picks the damaged regions each OCR pass covers within its time
+    // budget, focused window and caret area first
+    std::unique_ptr<OCRScheduler> m_ocrScheduler;
+
+    // Embedding index over stored screen text, filled by an idle-time job
+    // once the AI model is loaded. Shared with the web server's search API.
+    std::shared_ptr<SemanticSearch> m_semanticSearch;
+    std::atomic<size_t> m_unembeddedRecords;  // OCR records stored since the last embedding job
+    static constexpr size_t SEMANTIC_EMBED_BATCH = 32;
+
+    // Capture recording/replay; null unless requested
+    std::shared_ptr<CaptureRecorder> m_captureRecorder;
+    std::shared_ptr<CaptureReplay> m_captureReplay;
+
+    // Aggregator mode, or the replication client of a workstation (null
+    // unless a target was set)
+    bool m_aggregatorMode;
+    std::string m_replicationToken;
+    ReplicationConfig m_replicationConfig;
+    std::unique_ptr<ReplicationClient> m_replication;
+    
+    // Activity history for pattern analysis; published from the OCR, AI
+    // and capture threads
     std::deque<ContentAnalysis> m_recentActivities;
+    mutable std::mutex m_activitiesMutex;
     static const size_t MAX_ACTIVITY_HISTORY = 50;
     
+    // Per-monitor frame counts pace OCR independently on each monitor
+    // (frames arrive from one capture worker per monitor)
+    static constexpr int MAX_TRACKED_MONITORS = 8;
+    std::array<std::atomic<size_t>, MAX_TRACKED_MONITORS> m_monitorFrames;
+
     // Statistics
-    size_t m_framesProcessed;
-    size_t m_ocrExtractions;
-    size_t m_aiAnalyses;
+    std::atomic<size_t> m_framesProcessed;
+    std::atomic<size_t> m_ocrExtractions;
+    std::atomic<size_t> m_aiAnalyses;
     std::chrono::steady_clock::time_point m_lastSummaryTime;
 };
 
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "common_types.h"
+#include "screen_capture.h"
+#include "window_monitor_v2.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+// Which capture call produced a recorded frame. Monitored frames feed the
+// change-detection loop; the others answer on-demand reads (e.g. the
+// full-resolution re-read before OCR) and are replayed to the same calls.
+enum class CaptureSource {
+    MONITORED = 0,
+    DESKTOP = 1,
+    MONITOR = 2,
+    REGION = 3,
+    WINDOW = 4
+};
+
+struct CaptureRecorderStatistics {
+    size_t frames = 0;
+    size_t key_frames = 0;          // Stored whole rather than as changed tiles
+    size_t window_events = 0;
+    size_t raw_bytes = 0;           // Pixel bytes of the frames recorded
+    size_t file_bytes = 0;
+};
+
+// Writes capture sessions to an append-only, memory-mapped file: the
+// monitor layout, every captured frame with its dirty rects, and window
+// events, each stamped with its capture time. A frame is stored as the
+// 64x64 tiles that differ from the previous frame of the same source
+// (only tiles under the dirty rects are compared when there are any),
+// deflated when built with zlib. Records become visible to readers once
+// complete, so a recording cut short by a crash stays readable.
+class CaptureRecorder {
+public:
+    CaptureRecorder();
+    ~CaptureRecorder();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    // Thread-safe; frames may come from several capture threads
+    void RecordMonitors(const std::vector<MonitorInfo>& monitors);
+    void RecordFrame(const CaptureFrame& frame, CaptureSource source);
+    void RecordWindowEvent(const WindowEvent& event);
+
+    CaptureRecorderStatistics GetStatistics() const;
+
+    // Capture backend that records everything the wrapped backend returns
+    static std::unique_ptr<IScreenCapture> WrapBackend(std::unique_ptr<IScreenCapture> backend,
+                                                       std::shared_ptr<CaptureRecorder> recorder);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+struct CaptureReplayOptions {
+    double speed = 1.0;             // Relative to the recorded pace; 0 = as fast as possible
+
+    bool IsValid() const {
+        return speed >= 0.0;
+    }
+};
+
+struct CaptureReplayStatistics {
+    size_t records = 0;             // In the file
+    size_t frames_delivered = 0;    // Monitored frames handed to the consumer
+    size_t window_events = 0;
+    size_t reads_served = 0;        // On-demand captures answered with their recorded frame
+    size_t reads_repeated = 0;      // Answered with an earlier frame, none being pending
+    size_t reads_missed = 0;        // Nothing recorded for that source
+    double max_lag_ms = 0.0;        // Worst delay behind the recorded pace
+    bool finished = false;
+};
+
+// Plays a CaptureRecorder file back through the capture and window-monitor
+// interfaces, so the OCR, AI and storage pipeline can run headless on
+// identical input. Monitored frames are streamed in recorded order, at the
+// recorded pace scaled by the speed option (or as fast as possible), with
+// the window events recorded between them; on-demand captures return the
+// frames recorded for the same calls. Frame timestamps are the recorded ones.
+class CaptureReplay : public std::enable_shared_from_this<CaptureReplay> {
+public:
+    CaptureReplay();
+    ~CaptureReplay();
+
+    bool Open(const std::string& path, const CaptureReplayOptions& options = CaptureReplayOptions());
+    void Close();
+    bool IsOpen() const;
+
+    // Backends reading from this replay; playback starts when the capture
+    // backend starts streaming, window events are emitted through the
+    // EventManager while the monitor is monitoring
+    std::unique_ptr<IScreenCapture> CreateScreenCapture();
+    std::unique_ptr<IWindowMonitor> CreateWindowMonitor();
+
+    // Called on the playback thread after the last record
+    void SetFinishedCallback(std::function<void()> callback);
+
+    CaptureReplayStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+
+    friend class ReplayScreenCapture;
+    friend class ReplayWindowMonitor;
+};
+
+} // namespace work_assistant
@@ -53,6 +53,7 @@ public:
     void SetProgramName(const std::string& name) { m_program_name = name; }
     void SetProgramDescription(const std::string& description) { m_program_description = description; }
     void SetProgramVersion(const std::string& version) { m_program_version = version; }
+    void AddExample(const std::string& arguments) { m_examples.push_back(arguments); }
 
 private:
     std::vector<Option> m_options;
@@ -62,6 +63,7 @@ private:
     std::string m_program_name;
     std::string m_program_description;
     std::string m_program_version;
+    std::vector<std::string> m_examples;    // Argument lines listed by PrintHelp()
     std::string m_last_error;
     
     // Helper methods
@@ -92,6 +94,14 @@ public:
     static constexpr const char* VERBOSE = "verbose";
     static constexpr const char* QUIET = "quiet";
     static constexpr const char* TEST_MODE = "test-mode";
+    static constexpr const char* RECORD_CAPTURE = "record-capture";
+    static constexpr const char* REPLAY_CAPTURE = "replay-capture";
+    static constexpr const char* REPLAY_SPEED = "replay-speed";
+    static constexpr const char* AGGREGATOR = "aggregator";
+    static constexpr const char* REPLICATE_TO = "replicate-to";
+    static constexpr const char* WORKSTATION_ID = "workstation-id";
+    static constexpr const char* REPLICATE_TEXT = "replicate-text";
+    static constexpr const char* REPLICATION_TOKEN = "replication-token";
 };
 
 } // namespace work_assistant
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <vector>
 #include <chrono>
 #include <cstdint>
+#include <memory>
+#include <algorithm>
 
 namespace work_assistant {
 
@@ -91,10 +93,44 @@ enum class ImageFormat {
     RGBA = 2,
     BGR = 3,
     BGRA = 4,
-    GRAY = 5
+    GRAY = 5,
+    BGRX = 6    // BGRA with an undefined fourth byte (X11 ZPixmap, GDI)
 };
 
+// Byte offsets of red, green and blue within one pixel. Consumers read
+// captured frames in their native layout through these instead of
+// converting the whole frame up front; GRAY maps all three to byte 0.
+struct ChannelOffsets {
+    int r = 0, g = 1, b = 2;
+};
+
+inline ChannelOffsets GetChannelOffsets(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::BGR:
+        case ImageFormat::BGRA:
+        case ImageFormat::BGRX:
+            return {2, 1, 0};
+        case ImageFormat::GRAY:
+            return {0, 0, 0};
+        default:
+            return {0, 1, 2};
+    }
+}
+
+// BT.601 luma in integer arithmetic
+inline uint8_t PixelLuma(const uint8_t* pixel, const ChannelOffsets& channels) {
+    return static_cast<uint8_t>((77 * pixel[channels.r] + 150 * pixel[channels.g] +
+                                 29 * pixel[channels.b]) >> 8);
+}
+
 // Screen capture types
+
+// Screen area redrawn since the previous frame, in frame coordinates
+struct DirtyRect {
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+};
+
 struct CaptureFrame {
     std::vector<uint8_t> data;
     int width = 0;
@@ -103,6 +139,10 @@ struct CaptureFrame {
     int stride = 0; // Bytes per row
     ImageFormat format = ImageFormat::RGBA;
     std::chrono::system_clock::time_point timestamp;
+    std::vector<DirtyRect> dirty_rects; // Empty when the backend can't tell what changed
+    int monitor_id = -1;                // Source monitor, -1 for desktop/window/region captures
+    int pixel_passes = 0;               // Full-frame passes over the pixels since they left the backend
+    int scale_factor = 1;               // Screen pixels per frame pixel along each axis
     
     // Utility methods
     size_t GetDataSize() const {
@@ -116,6 +156,120 @@ struct CaptureFrame {
     }
 };
 
+// Non-owning, strided view of frame pixels. Crops and sub-tiles are just
+// views with a different origin, so regions flow through preprocessing and
+// OCR without copying. A plain view is only valid while its source frame
+// lives; Shared()/Retain() views keep the pixels alive through owner.
+struct FrameView {
+    const uint8_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;                     // Bytes per row, always set
+    int bytes_per_pixel = 4;
+    ImageFormat format = ImageFormat::RGBA;
+    std::chrono::system_clock::time_point timestamp;
+    int monitor_id = -1;
+    int pixel_passes = 0;
+    int origin_x = 0, origin_y = 0;     // Position within the source frame
+    std::shared_ptr<const void> owner;  // Null for borrowed views
+
+    FrameView() = default;
+
+    // Borrows the frame's buffer (implicit so frames pass where views are expected)
+    FrameView(const CaptureFrame& frame)
+        : data(frame.data.empty() ? nullptr : frame.data.data())
+        , width(frame.width)
+        , height(frame.height)
+        , stride(frame.stride > 0 ? frame.stride : frame.width * frame.bytes_per_pixel)
+        , bytes_per_pixel(frame.bytes_per_pixel)
+        , format(frame.format)
+        , timestamp(frame.timestamp)
+        , monitor_id(frame.monitor_id)
+        , pixel_passes(frame.pixel_passes) {
+        if (!frame.IsValid()) {
+            data = nullptr;
+        }
+    }
+
+    // View that shares ownership of the frame, safe to hand to other threads
+    static FrameView Shared(std::shared_ptr<const CaptureFrame> frame) {
+        if (!frame) {
+            return FrameView();
+        }
+        FrameView view(*frame);
+        view.owner = std::move(frame);
+        return view;
+    }
+
+    bool IsValid() const {
+        return data != nullptr && width > 0 && height > 0 && bytes_per_pixel > 0 &&
+               stride >= width * bytes_per_pixel;
+    }
+
+    size_t GetDataSize() const {
+        return static_cast<size_t>(height) * stride;
+    }
+
+    const uint8_t* Row(int y) const {
+        return data + static_cast<size_t>(y) * stride;
+    }
+
+    const uint8_t* Pixel(int x, int y) const {
+        return Row(y) + static_cast<size_t>(x) * bytes_per_pixel;
+    }
+
+    // Zero-copy crop, clamped to the view; invalid when nothing overlaps
+    FrameView SubView(int x, int y, int w, int h) const {
+        int left = std::max(0, x);
+        int top = std::max(0, y);
+        int right = std::min(width, x + w);
+        int bottom = std::min(height, y + h);
+        if (!IsValid() || right <= left || bottom <= top) {
+            return FrameView();
+        }
+        FrameView view = *this;
+        view.data = Pixel(left, top);
+        view.width = right - left;
+        view.height = bottom - top;
+        view.origin_x = origin_x + left;
+        view.origin_y = origin_y + top;
+        return view;
+    }
+
+    // Deep copy into a tightly packed frame
+    CaptureFrame ToFrame() const {
+        CaptureFrame frame;
+        if (!IsValid()) {
+            return frame;
+        }
+        frame.width = width;
+        frame.height = height;
+        frame.bytes_per_pixel = bytes_per_pixel;
+        frame.stride = width * bytes_per_pixel;
+        frame.format = format;
+        frame.timestamp = timestamp;
+        frame.monitor_id = monitor_id;
+        frame.pixel_passes = pixel_passes + 1;
+        frame.data.resize(frame.GetDataSize());
+        for (int y = 0; y < height; ++y) {
+            std::copy(Row(y), Row(y) + frame.stride, frame.data.begin() + static_cast<size_t>(y) * frame.stride);
+        }
+        return frame;
+    }
+
+    // A view that can outlive the caller: itself when already owning,
+    // otherwise a view over a shared copy of just the viewed pixels
+    FrameView Retain() const {
+        if (owner || !IsValid()) {
+            return *this;
+        }
+        FrameView view = Shared(std::make_shared<const CaptureFrame>(ToFrame()));
+        view.origin_x = origin_x;
+        view.origin_y = origin_y;
+        return view;
+    }
+};
+
 // OCR types
 struct TextBlock {
     std::string text;
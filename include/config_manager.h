@@ -91,6 +91,8 @@ struct DefaultConfig {
     static constexpr const char* OCR_CONFIDENCE_THRESHOLD = "confidence_threshold";
     static constexpr const char* OCR_USE_GPU = "use_gpu";
     static constexpr const char* OCR_MAX_IMAGE_SIZE = "max_image_size";
+    // Keys are process names, values weight the OCR scheduler's focus terms
+    static constexpr const char* OCR_APP_IMPORTANCE_SECTION = "ocr_app_importance";
     
     // AI settings
     static constexpr const char* AI_SECTION = "ai";
@@ -120,6 +122,12 @@ struct DefaultConfig {
     static constexpr const char* MONITOR_SCREEN_CAPTURE = "screen_capture";
     static constexpr const char* MONITOR_CAPTURE_INTERVAL_MS = "capture_interval_ms";
     static constexpr const char* MONITOR_OCR_INTERVAL_FRAMES = "ocr_interval_frames";
+    static constexpr const char* MONITOR_CAPTURE_BACKEND = "capture_backend";
+    
+    // Resource budget settings
+    static constexpr const char* PERFORMANCE_SECTION = "performance";
+    static constexpr const char* PERF_CPU_TARGET_PERCENT = "cpu_target_percent";
+    static constexpr const char* PERF_YIELD_TO_FOREGROUND = "yield_to_foreground";
 };
 
 // Template implementations
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+// What the governor currently allows the pipeline to do
+enum class CpuBudgetMode {
+    NORMAL,      // Within budget, full quality
+    THROTTLED,   // Over budget or cgroup-throttled, work is scaled down
+    YIELDING     // Foreground compile or video call, capture and analysis paused
+};
+
+// Budget handed to consumers. scale is the fraction of nominal work
+// (capture rate, OCR concurrency, inference threads) currently allowed.
+struct CpuBudget {
+    CpuBudgetMode mode = CpuBudgetMode::NORMAL;
+    double scale = 1.0;
+};
+
+// Governor tuning. Shares are percentages of the CPU capacity available to
+// this process: the cgroup quota when one is set, otherwise all online cores.
+struct CpuGovernorConfig {
+    std::chrono::milliseconds poll_interval{2000};
+    double target_share = 25.0;          // Percent of capacity the daemon may use
+    double system_busy_percent = 90.0;   // Back off when the machine is this busy
+    double min_scale = 0.1;
+    double decrease_factor = 0.7;        // Multiplicative decrease when over budget
+    double increase_factor = 1.2;        // Gradual recovery when well under budget
+    double recovery_ratio = 0.6;         // "Well under" = below target * ratio
+    std::chrono::seconds yield_hold{10}; // Keep yielding this long after the load ends
+
+    bool yield_to_foreground = true;
+    std::vector<std::string> compiler_processes = {
+        "cc1", "cc1plus", "cc1obj", "clang", "clang++", "rustc", "javac",
+        "swiftc", "nvcc", "ld", "ld.gold", "ld.lld", "mold"
+    };
+    std::vector<std::string> video_call_processes = {
+        "zoom", "ZoomWebviewHost", "teams", "teams-for-linux", "skypeforlinux", "webex"
+    };
+    // Browsers only count as a video call while they hold a camera open
+    std::vector<std::string> camera_client_processes = {
+        "chrome", "chromium", "firefox", "firefox-esr", "msedge", "brave"
+    };
+
+    bool IsValid() const {
+        return poll_interval.count() > 0 &&
+               target_share > 0.0 && target_share <= 100.0 &&
+               min_scale > 0.0 && min_scale <= 1.0 &&
+               decrease_factor > 0.0 && decrease_factor < 1.0 &&
+               increase_factor > 1.0 && recovery_ratio > 0.0 && recovery_ratio < 1.0;
+    }
+};
+
+// Component whose CPU consumption can be scaled
+struct CpuConsumer {
+    std::string name;
+    std::function<void(const CpuBudget&)> on_budget_changed;
+};
+
+// Counters from cpu.stat (cgroup v2) or cpu.stat + cpuacct (v1)
+struct CgroupCpuStat {
+    uint64_t usage_usec = 0;
+    uint64_t nr_periods = 0;
+    uint64_t nr_throttled = 0;
+    uint64_t throttled_usec = 0;
+};
+
+// Snapshot of what the governor last observed and decided
+struct CpuGovernorStatus {
+    CpuBudget budget;
+    double target_share = 0.0;
+    double process_share = 0.0;          // Percent of capacity used by this process
+    double system_usage_percent = 0.0;
+    double capacity_cores = 0.0;
+    bool cgroup_available = false;
+    double cgroup_quota_cores = 0.0;     // 0 when unlimited
+    uint64_t throttled_periods = 0;      // Since the previous sample
+    uint64_t throttled_usec = 0;
+    std::string reason;                  // Why the budget is what it is
+    size_t budget_changes = 0;
+    std::vector<std::string> consumers;
+};
+
+// The governor's decision rule, kept apart from sampling so it can be fed
+// synthetic samples. AIMD on the work scale: cut quickly when over budget
+// or throttled by the cgroup, recover gradually when well under, and yield
+// while a foreground load runs plus config.yield_hold after it ends.
+class CpuBudgetPolicy {
+public:
+    // Sets sample.reason
+    CpuBudget NextBudget(const CpuGovernorConfig& config, CpuGovernorStatus& sample,
+                         const std::string& foreground, const CpuBudget& previous,
+                         std::chrono::steady_clock::time_point now);
+
+private:
+    std::chrono::steady_clock::time_point m_lastForeground;
+    std::string m_foregroundReason;
+};
+
+// Keeps the daemon within a CPU budget. Samples process and system usage
+// plus cgroup throttling on a background thread, then tells registered
+// consumers how much work they may do.
+class CpuGovernor {
+public:
+    static CpuGovernor& GetInstance();
+
+    bool Start(const CpuGovernorConfig& config = CpuGovernorConfig());
+    void Stop();
+    bool IsRunning() const;
+
+    // A newly registered consumer is immediately told the current budget
+    // if it is not the nominal one
+    int RegisterConsumer(const CpuConsumer& consumer);
+    void UnregisterConsumer(int handle);
+
+    CpuBudget GetBudget() const;
+    CpuGovernorStatus GetStatus() const;
+
+    void Evaluate();
+
+    // Runtime tuning (configuration reload)
+    bool SetTargetShare(double percent);
+    void SetYieldToForeground(bool enabled);
+
+    CpuGovernor(const CpuGovernor&) = delete;
+    CpuGovernor& operator=(const CpuGovernor&) = delete;
+
+private:
+    CpuGovernor();
+    ~CpuGovernor();
+
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+namespace cpu_utils {
+
+std::string BudgetModeToString(CpuBudgetMode mode);
+
+// Kernel interfaces; each returns false (or 0) when unavailable
+bool ReadCgroupCpuStat(CgroupCpuStat& stat);
+double ReadCgroupCpuQuota();            // Cores allowed by cpu.max / cfs quota
+unsigned int GetOnlineCores();
+
+// Returns a human-readable reason when one of the session user's processes
+// is a compile or video call, otherwise an empty string
+std::string DetectForegroundLoad(const CpuGovernorConfig& config);
+
+} // namespace cpu_utils
+
+} // namespace work_assistant
@@ -3,6 +3,9 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <vector>
+#include <chrono>
+#include <sys/types.h>
 
 namespace work_assistant {
 
@@ -18,6 +21,11 @@ struct ServiceConfig {
     bool auto_start = false;
     bool enable_logging = true;
     
+    // systemd integration (Type=notify units)
+    int watchdog_sec = 30;                  // WatchdogSec= written by Install()
+    int web_port = 8080;                    // Dashboard port the service listens on
+    std::chrono::seconds drain_timeout{10}; // Max wait for in-flight work on SIGTERM
+    
     bool IsValid() const {
         return !service_name.empty();
     }
@@ -75,6 +83,9 @@ public:
     pid_t GetDaemonPid() const;
     
 private:
+    std::string GetUnitDirectory() const;
+    std::string GetUnitName() const;
+    
     ServiceConfig m_config;
     mutable ServiceStatus m_status;
 };
@@ -157,7 +168,15 @@ private:
     std::shared_ptr<Application> m_application;
     
     void SetupSignalHandlers();
+    void RestoreSignalHandlers();
     void HandleSignal(int signal);
+    void ServiceLoop();
+    bool ReloadConfiguration();
+    
+    // Self-pipe: the async signal handler only writes the signal number,
+    // ServiceLoop() reads it and calls HandleSignal() in normal context
+    int m_signalPipe[2];
+    bool m_stopRequested;
     
     static ServiceManager* s_instance;
     static void SignalHandler(int signal);
@@ -188,6 +207,12 @@ namespace service_utils {
     bool IsProcessRunning(pid_t pid);
     bool KillProcess(pid_t pid, int signal = 15); // SIGTERM by default
     
+    // systemd service protocol (sd_notify and the watchdog), implemented
+    // directly on top of $NOTIFY_SOCKET and $WATCHDOG_USEC
+    bool IsSystemdNotifyAvailable();
+    bool NotifySystemd(const std::string& state);
+    std::chrono::microseconds GetWatchdogInterval();
+    
     // Configuration file management
     bool LoadConfigFromFile(const std::string& config_path, ServiceConfig& config);
     bool SaveConfigToFile(const std::string& config_path, const ServiceConfig& config);
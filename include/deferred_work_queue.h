@@ -0,0 +1,80 @@
+#pragma once
+
+#include "storage_engine.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace work_assistant {
+
+// Outcome of running one chunk of a deferred job
+enum class DeferredJobResult {
+    DONE,     // Job finished, remove it
+    MORE,     // Chunk done, job.cursor updated; call again
+    FAILED    // Chunk failed; retried later up to max_attempts
+};
+
+// Runs a single bounded chunk of work. Handlers must keep chunks short
+// (well under a second) and record progress in job.cursor so the job can be
+// resumed after preemption or a restart.
+using DeferredJobHandler = std::function<DeferredJobResult(DeferredJobRecord& job)>;
+
+struct DeferredWorkConfig {
+    std::chrono::minutes idle_threshold{5};        // No input/focus events for this long
+    std::chrono::seconds ac_idle_threshold{30};    // Shorter quiet period when on AC power
+    bool run_on_ac_power = true;
+    std::chrono::milliseconds poll_interval{5000};
+    int max_attempts = 3;
+
+    bool IsValid() const {
+        return idle_threshold.count() >= 0 && ac_idle_threshold.count() >= 0 &&
+               poll_interval.count() > 0 && max_attempts > 0;
+    }
+};
+
+struct DeferredWorkStatistics {
+    size_t pending_jobs = 0;
+    size_t completed_jobs = 0;
+    size_t failed_jobs = 0;
+    size_t chunks_run = 0;
+    size_t preemptions = 0;
+    std::string current_job;       // Kind of the job being run, empty when idle
+    bool persistent = false;       // Backed by storage rather than memory only
+};
+
+// Queue for heavy, non-urgent work (re-OCR, index rebuilds, compaction).
+// Jobs are persisted through the storage manager and only run while the
+// user is idle or the machine is plugged in; activity preempts the running
+// job at the next chunk boundary.
+class DeferredWorkQueue {
+public:
+    DeferredWorkQueue();
+    ~DeferredWorkQueue();
+
+    // storage may be null, in which case jobs live in memory only
+    bool Start(std::shared_ptr<EncryptedStorageManager> storage,
+               const DeferredWorkConfig& config = DeferredWorkConfig());
+    void Stop();
+    bool IsRunning() const;
+
+    void RegisterHandler(const std::string& kind, DeferredJobHandler handler);
+
+    // Returns the job id; an identical pending job (same kind and payload)
+    // is reused instead of queued twice
+    uint64_t Enqueue(const std::string& kind, const std::string& payload = "", int priority = 0);
+
+    // Activity signals. The idle source is polled for input idle time
+    // (e.g. IWindowMonitor::GetIdleTime); negative values are ignored.
+    void NotifyUserActivity();
+    void SetIdleTimeSource(std::function<std::chrono::milliseconds()> source);
+
+    bool CanRunNow() const;
+    DeferredWorkStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
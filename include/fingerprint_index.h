@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace work_assistant {
+
+// Stored results for a screen seen before
+struct FingerprintMatch {
+    uint64_t hash = 0;
+    int distance = 0;                 // Hamming distance to the query
+    uint64_t ocr_record_id = 0;       // 0 when not stored
+    uint64_t analysis_record_id = 0;  // 0 when not stored
+};
+
+struct FingerprintIndexStatistics {
+    size_t entries = 0;
+    size_t lookups = 0;
+    size_t hits = 0;
+    size_t memory_bytes = 0;
+};
+
+// Persistent index from 64-bit perceptual frame hashes
+// (capture_utils::CalculateHash) to the OCR and analysis records produced
+// for that screen, so a screen seen again - even in another session - can
+// reuse its results. Lookups use multi-index hashing: the hash is split
+// into four 16-bit substrings, each with its own table, and any hash within
+// distance d shares at least one substring within d/4 of the query's, so
+// only a few buckets are probed regardless of the index size.
+class FingerprintIndex {
+public:
+    FingerprintIndex();
+    ~FingerprintIndex();
+
+    // Loads the index file, creating it if missing; later additions are
+    // appended to it. An empty path keeps the index in memory only.
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    // Adding a hash already present replaces its record ids
+    bool Add(uint64_t hash, uint64_t ocrRecordId, uint64_t analysisRecordId);
+
+    // Closest entry within maxDistance bits (0-15); the newest wins ties
+    bool FindNearest(uint64_t hash, int maxDistance, FingerprintMatch& match) const;
+
+    size_t Size() const;
+    FingerprintIndexStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+// Memory pressure as seen by the governor (ordered by severity)
+enum class MemoryPressureLevel {
+    NORMAL,     // Full quality, all caches at nominal size
+    MODERATE,   // Shrink caches and buffers, lower capture resolution
+    CRITICAL    // Minimal buffers, unload optional models
+};
+
+// Governor thresholds. PSI values are the kernel's avg10 percentages from
+// /proc/pressure/memory; ratios are usage/limit of the enclosing cgroup (or
+// of system RAM when no cgroup limit is set).
+struct MemoryGovernorConfig {
+    std::chrono::milliseconds poll_interval{2000};
+    std::chrono::seconds restore_delay{30};      // Calm period before stepping down
+
+    double psi_some_moderate = 10.0;
+    double psi_full_critical = 5.0;
+    double usage_ratio_moderate = 0.85;
+    double usage_ratio_critical = 0.95;
+    double recovery_margin = 0.10;               // Hysteresis below the enter thresholds
+
+    // Optional self-imposed budget for this process (0 = none)
+    size_t process_budget_mb = 0;
+
+    bool IsValid() const {
+        return poll_interval.count() > 0 &&
+               usage_ratio_moderate > 0.0 && usage_ratio_moderate < usage_ratio_critical &&
+               usage_ratio_critical <= 1.0 && recovery_margin >= 0.0;
+    }
+};
+
+// Component that owns a pool, cache or other reclaimable memory
+struct MemoryConsumer {
+    std::string name;
+    std::function<size_t()> get_usage_bytes;                       // Current footprint
+    std::function<void(MemoryPressureLevel)> on_level_changed;     // Shrink or restore
+};
+
+// Snapshot of what the governor last observed
+struct MemoryGovernorStatus {
+    MemoryPressureLevel level = MemoryPressureLevel::NORMAL;
+    bool psi_available = false;
+    double psi_some_avg10 = 0.0;
+    double psi_full_avg10 = 0.0;
+    size_t cgroup_usage_bytes = 0;
+    size_t cgroup_limit_bytes = 0;       // 0 when unlimited or unknown
+    size_t system_available_bytes = 0;
+    size_t system_total_bytes = 0;
+    size_t process_rss_bytes = 0;
+    size_t level_changes = 0;
+    std::vector<std::pair<std::string, size_t>> consumers;
+};
+
+// The governor's decision rule, kept apart from sampling so it can be fed
+// synthetic samples. Escalates immediately; steps down one level only after
+// the signals have stayed below the thresholds lowered by recovery_margin
+// for restore_delay.
+class MemoryPressurePolicy {
+public:
+    // Level the sample alone indicates, with every threshold times scale
+    static MemoryPressureLevel Classify(const MemoryGovernorConfig& config,
+                                        const MemoryGovernorStatus& sample, double scale = 1.0);
+
+    MemoryPressureLevel NextLevel(const MemoryGovernorConfig& config, const MemoryGovernorStatus& sample,
+                                  MemoryPressureLevel current, std::chrono::steady_clock::time_point now);
+
+private:
+    std::chrono::steady_clock::time_point m_calmSince = std::chrono::steady_clock::now();
+};
+
+// Central memory governor. Watches PSI and cgroup limits on a background
+// thread and tells registered consumers to shrink or restore themselves.
+class MemoryGovernor {
+public:
+    static MemoryGovernor& GetInstance();
+
+    bool Start(const MemoryGovernorConfig& config = MemoryGovernorConfig());
+    void Stop();
+    bool IsRunning() const;
+
+    // Returns a handle for UnregisterConsumer(). A newly registered consumer
+    // is immediately told the current level if it is not NORMAL.
+    int RegisterConsumer(const MemoryConsumer& consumer);
+    void UnregisterConsumer(int handle);
+
+    MemoryPressureLevel GetLevel() const;
+    MemoryGovernorStatus GetStatus() const;
+
+    // Re-sample immediately (also used by tests and the REST layer)
+    void Evaluate();
+
+    // Force a level regardless of measurements; NORMAL clears the override
+    void SetOverride(bool enabled, MemoryPressureLevel level = MemoryPressureLevel::NORMAL);
+
+    MemoryGovernor(const MemoryGovernor&) = delete;
+    MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+private:
+    MemoryGovernor();
+    ~MemoryGovernor();
+
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+namespace memory_utils {
+
+std::string PressureLevelToString(MemoryPressureLevel level);
+
+// Kernel interfaces; each returns false when the file is unavailable
+bool ReadPressureStall(const std::string& path, double& some_avg10, double& full_avg10);
+bool ReadCgroupMemory(size_t& usage_bytes, size_t& limit_bytes);
+bool ReadMemInfo(size_t& total_bytes, size_t& available_bytes);
+size_t ReadProcessRSS();
+
+// Path of this process' cgroup relative to the cgroup mount, for the given
+// v1 controller or the unified (v2) hierarchy when controller is empty
+std::string FindCgroupPath(const std::string& controller);
+
+} // namespace memory_utils
+
+} // namespace work_assistant
@@ -64,10 +64,10 @@ public:
     bool Initialize(const OCROptions& options = OCROptions()) override;
     void Shutdown() override;
 
-    OCRDocument ProcessImage(const CaptureFrame& frame) override;
-    OCRDocument ProcessImageRegion(const CaptureFrame& frame,
+    OCRDocument ProcessImage(const FrameView& frame) override;
+    OCRDocument ProcessImageRegion(const FrameView& frame,
                                   int x, int y, int width, int height) override;
-    std::future<OCRDocument> ProcessImageAsync(const CaptureFrame& frame) override;
+    std::future<OCRDocument> ProcessImageAsync(const FrameView& frame) override;
 
     void SetOptions(const OCROptions& options) override;
     OCROptions GetOptions() const override;
@@ -82,9 +82,9 @@ public:
     MiniCPMVConfig GetMiniCPMConfig() const;
 
     // Advanced multimodal capabilities
-    MultimodalResponse AnswerQuestion(const CaptureFrame& frame, const std::string& question);
-    MultimodalResponse DescribeImage(const CaptureFrame& frame);
-    MultimodalResponse ExtractStructuredData(const CaptureFrame& frame, const std::string& data_type);
+    MultimodalResponse AnswerQuestion(const FrameView& frame, const std::string& question);
+    MultimodalResponse DescribeImage(const FrameView& frame);
+    MultimodalResponse ExtractStructuredData(const FrameView& frame, const std::string& data_type);
 
     // Batch processing
     std::vector<OCRDocument> ProcessImageBatch(const std::vector<CaptureFrame>& frames);
@@ -122,9 +122,9 @@ private:
 namespace minicpm_utils {
 
 // Image preprocessing for vision model
-bool PrepareImageForModel(const CaptureFrame& input, CaptureFrame& output, int target_size);
-bool ValidateImageSize(const CaptureFrame& frame, int max_size);
-std::vector<uint8_t> EncodeImageForModel(const CaptureFrame& frame);
+bool PrepareImageForModel(const FrameView& input, CaptureFrame& output, int target_size);
+bool ValidateImageSize(const FrameView& frame, int max_size);
+std::vector<uint8_t> EncodeImageForModel(const FrameView& frame);
 
 // Prompt engineering
 std::string BuildOCRPrompt(const std::string& language = "auto");
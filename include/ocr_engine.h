@@ -52,13 +52,16 @@ public:
     virtual bool Initialize(const OCROptions& options = OCROptions()) = 0;
     virtual void Shutdown() = 0;
 
-    // Synchronous OCR processing
-    virtual OCRDocument ProcessImage(const CaptureFrame& frame) = 0;
-    virtual OCRDocument ProcessImageRegion(const CaptureFrame& frame, 
+    // Synchronous OCR processing. Frames convert to views implicitly; a
+    // region is processed as a sub-view and its text blocks come back in
+    // the coordinates of the full frame.
+    virtual OCRDocument ProcessImage(const FrameView& frame) = 0;
+    virtual OCRDocument ProcessImageRegion(const FrameView& frame, 
                                           int x, int y, int width, int height) = 0;
 
-    // Asynchronous OCR processing
-    virtual std::future<OCRDocument> ProcessImageAsync(const CaptureFrame& frame) = 0;
+    // Asynchronous OCR processing. Borrowed views are retained (copied)
+    // before the call returns; shared views are passed through as-is.
+    virtual std::future<OCRDocument> ProcessImageAsync(const FrameView& frame) = 0;
 
     // Configuration
     virtual void SetOptions(const OCROptions& options) = 0;
@@ -86,6 +89,33 @@ public:
     static std::vector<EngineType> GetAvailableEngines();
 };
 
+// On-screen text that can be read without OCR, e.g. from the platform
+// accessibility tree. Positions are in screen coordinates.
+class ITextSource {
+public:
+    virtual ~ITextSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Shutdown() = 0;
+
+    // Text shown in the screen area. False when the source cannot vouch
+    // for the whole area (nothing exposed there, stale or untrusted), so
+    // its pixels have to be recognised instead.
+    virtual bool ExtractText(int x, int y, int width, int height, OCRDocument& document) = 0;
+
+    // Text caret in the focused window; false when unknown
+    virtual bool GetCaretPosition(int& x, int& y) const = 0;
+
+    virtual std::string GetSourceInfo() const = 0;
+};
+
+// Text source factory
+class TextSourceFactory {
+public:
+    // The platform's accessibility text source, nullptr where there is none
+    static std::shared_ptr<ITextSource> Create();
+};
+
 // OCR manager - handles multiple engines and content extraction
 class OCRManager {
 public:
@@ -102,20 +132,26 @@ public:
     void Shutdown();
 
     // Process content from screen captures
-    OCRDocument ExtractText(const CaptureFrame& frame);
-    std::future<OCRDocument> ExtractTextAsync(const CaptureFrame& frame);
+    OCRDocument ExtractText(const FrameView& frame);
+    std::future<OCRDocument> ExtractTextAsync(const FrameView& frame);
+
+    // For a view whose top-left is at (screenX, screenY) on screen: text
+    // from the text source when it covers the whole view, otherwise from
+    // pixel OCR. Text blocks are in view coordinates either way.
+    OCRDocument ExtractText(const FrameView& frame, int screenX, int screenY);
+    void SetTextSource(std::shared_ptr<ITextSource> source);
 
     // Process specific window content
     OCRDocument ExtractWindowText(WindowHandle windowHandle);
 
     // Content analysis
-    bool ContainsText(const CaptureFrame& frame, const std::string& searchText);
+    bool ContainsText(const FrameView& frame, const std::string& searchText);
     std::vector<std::string> ExtractKeywords(const OCRDocument& document);
     
     // Multimodal capabilities (MiniCPM-V only)
-    std::string AnswerQuestion(const CaptureFrame& frame, const std::string& question);
-    std::string DescribeImage(const CaptureFrame& frame);
-    std::vector<std::string> ExtractStructuredData(const CaptureFrame& frame, const std::string& dataType);
+    std::string AnswerQuestion(const FrameView& frame, const std::string& question);
+    std::string DescribeImage(const FrameView& frame);
+    std::vector<std::string> ExtractStructuredData(const FrameView& frame, const std::string& dataType);
     
     // Configuration
     void SetLanguage(const std::string& language);
@@ -129,6 +165,17 @@ public:
     void SetMaxImageSize(int max_size);
     void EnableCaching(bool enable, int ttl_seconds = 300);
 
+    // Startup: skip the fallback/multimodal engine in Initialize() and load
+    // it later, once the capture pipeline is already producing frames
+    void DeferSecondaryEngine(bool defer = true);
+    bool LoadDeferredEngines();
+
+    // Memory governor hooks: drop/restore the MiniCPM-V weights. While
+    // unloaded, ACCURATE/MULTIMODAL requests fall back to the fast engine.
+    bool UnloadMultimodalModel();
+    bool ReloadMultimodalModel();
+    bool IsMultimodalModelLoaded() const;
+
     // Performance monitoring
     struct Statistics {
         size_t total_processed = 0;
@@ -149,13 +196,18 @@ private:
 namespace ocr_utils {
 
 // Image preprocessing functions
-bool PreprocessImage(const CaptureFrame& input, CaptureFrame& output, const OCROptions& options);
-bool ScaleImage(const CaptureFrame& input, CaptureFrame& output, float scale);
-bool ConvertToGrayscale(const CaptureFrame& input, CaptureFrame& output);
+bool ScaleImage(const FrameView& input, CaptureFrame& output, float scale);
+bool ConvertToGrayscale(const FrameView& input, CaptureFrame& output);
 bool EnhanceContrast(CaptureFrame& frame, float factor = 1.5f);
 bool DenoiseImage(CaptureFrame& frame);
 bool BinarizeImage(CaptureFrame& frame, int threshold = 128);
 
+// Shift text block positions, e.g. from a sub-view back to its full frame
+void OffsetTextBlocks(OCRDocument& document, int dx, int dy);
+
+// Merge the result of one region into a document built up region by region
+void AppendDocument(OCRDocument& target, const OCRDocument& part);
+
 // Text processing utilities
 std::string CleanExtractedText(const std::string& text);
 std::vector<std::string> SplitIntoLines(const std::string& text);
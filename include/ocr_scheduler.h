@@ -0,0 +1,101 @@
+#pragma once
+
+#include "common_types.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace work_assistant {
+
+// Area of a frame picked for OCR, in full-resolution frame pixels
+struct OCRRegion {
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+    double score = 0.0;
+    int deferrals = 0;      // Passes this region has already waited
+
+    size_t Area() const { return static_cast<size_t>(width) * height; }
+};
+
+struct OCRSchedulerConfig {
+    std::chrono::milliseconds frame_budget{250};    // OCR time allowed per pass
+    int region_padding = 8;             // Grown around damage so text lines stay whole
+    int title_bar_height = 32;          // Top strip of the focused window
+    int caret_radius = 150;             // Caret proximity falls to ~37% at this distance
+    int max_deferrals = 3;              // Passes a region may wait before it is dropped
+    size_t max_regions = 48;            // Per pass, after merging
+    double initial_ms_per_megapixel = 80.0;   // Cost estimate until passes are measured
+
+    bool IsValid() const {
+        return frame_budget.count() > 0 && region_padding >= 0 && title_bar_height >= 0 &&
+               caret_radius > 0 && max_deferrals >= 0 && max_regions > 0 &&
+               initial_ms_per_megapixel > 0.0;
+    }
+};
+
+// Regions chosen for one OCR pass, highest value first
+struct OCRSchedule {
+    std::vector<OCRRegion> regions;
+    std::chrono::milliseconds budget{0};
+    double estimated_ms = 0.0;
+    size_t deferred = 0;    // Held for the next pass
+    size_t dropped = 0;     // Had already waited max_deferrals passes
+};
+
+struct OCRSchedulerStatistics {
+    size_t passes_planned = 0;
+    size_t regions_scheduled = 0;
+    size_t regions_deferred = 0;
+    size_t regions_dropped = 0;
+    double ms_per_megapixel = 0.0;      // Current cost estimate
+};
+
+// Decides which damaged parts of the screen get OCR time. Damage from every
+// delivered frame accumulates per monitor until the next OCR pass, which
+// merges it into regions and ranks them: overlap with the focused window
+// (its title bar and the area around the text caret above all), how often
+// the area changed recently, and the focused application's importance.
+// Regions are taken in rank order while their estimated cost fits the
+// per-pass budget; the tail waits for the next pass and is dropped once it
+// has waited too often. Thread-safe.
+class OCRScheduler {
+public:
+    OCRScheduler();
+    ~OCRScheduler();
+
+    void SetConfig(const OCRSchedulerConfig& config);
+    OCRSchedulerConfig GetConfig() const;
+
+    // Focus context, in screen coordinates. Importance weights the focus
+    // terms per process name (default 1.0).
+    void SetFocusedWindow(const WindowInfo& window);
+    void SetCaretPosition(int x, int y);    // Negative when unknown
+    void SetApplicationImportance(const std::string& processName, double weight);
+    // Replaces every weight, e.g. on a configuration reload
+    void SetApplicationImportance(const std::unordered_map<std::string, double>& weights);
+
+    // Damage of a delivered frame. Rects may be in reduced detection
+    // pixels (frame.scale_factor); none means the whole frame changed.
+    void AddDamage(const CaptureFrame& frame);
+
+    // Plans a pass over the monitor's full-resolution frame of the given
+    // size, whose top-left is at (screenX, screenY), and consumes the
+    // damage accumulated for it
+    OCRSchedule Plan(int monitorId, int width, int height, int screenX, int screenY);
+
+    // Scheduled regions that did not run because the pass overran
+    void Defer(int monitorId, const std::vector<OCRRegion>& regions);
+
+    // Measured cost of one region, refines later estimates
+    void ReportRegionTime(const OCRRegion& region, std::chrono::microseconds elapsed);
+
+    OCRSchedulerStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
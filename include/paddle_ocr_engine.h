@@ -69,10 +69,10 @@ public:
     bool Initialize(const OCROptions& options = OCROptions()) override;
     void Shutdown() override;
     
-    OCRDocument ProcessImage(const CaptureFrame& frame) override;
-    OCRDocument ProcessImageRegion(const CaptureFrame& frame, 
+    OCRDocument ProcessImage(const FrameView& frame) override;
+    OCRDocument ProcessImageRegion(const FrameView& frame, 
                                   int x, int y, int width, int height) override;
-    std::future<OCRDocument> ProcessImageAsync(const CaptureFrame& frame) override;
+    std::future<OCRDocument> ProcessImageAsync(const FrameView& frame) override;
     
     void SetOptions(const OCROptions& options) override;
     OCROptions GetOptions() const override;
@@ -108,8 +108,8 @@ private:
 namespace paddle_utils {
 
 // Image preprocessing
-bool PreprocessImage(const CaptureFrame& input, CaptureFrame& output);
-bool ResizeImage(const CaptureFrame& input, CaptureFrame& output, int target_size);
+bool PreprocessImage(const FrameView& input, CaptureFrame& output);
+bool ResizeImage(const FrameView& input, CaptureFrame& output, int target_size);
 bool NormalizeImage(CaptureFrame& frame);
 
 // Result processing
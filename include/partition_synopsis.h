@@ -0,0 +1,99 @@
+#pragma once
+
+#include "storage_engine.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace work_assistant {
+
+// Bloom filter that grows by adding larger layers as it fills, so a
+// partition's filter stays near its false-positive target however many
+// terms the partition ends up holding
+class ScalableBloomFilter {
+public:
+    ScalableBloomFilter();
+
+    void Add(uint64_t hash);
+    bool MightContain(uint64_t hash) const;
+
+    size_t GetMemoryUsage() const;
+    void Serialize(std::vector<uint8_t>& out) const;
+    bool Deserialize(const uint8_t*& data, const uint8_t* end);
+
+private:
+    struct Layer {
+        std::vector<uint64_t> words;
+        size_t terms = 0;
+        size_t Capacity() const;
+    };
+    std::vector<Layer> m_layers;
+};
+
+// One time partition of stored records that could hold matches, with its
+// zone-map bounds (seconds); scans read only [start, end]
+struct SynopsisCandidate {
+    int64_t partition = 0;
+    int64_t start = 0;
+    int64_t end = 0;
+};
+
+// Summary of the records in one time partition: a zone map (timestamp
+// bounds and bitsets of record types, work categories and content types)
+// and a Bloom filter over the lowercase text trigrams and application names
+// of its records. Deleting records leaves synopses as they are; that only
+// costs extra scans, never missed rows.
+struct PartitionSynopsis {
+    int64_t min_timestamp = INT64_MAX;
+    int64_t max_timestamp = INT64_MIN;
+    uint64_t records = 0;
+    uint64_t type_bits = 0;
+    uint64_t category_bits = 0;
+    uint64_t content_bits = 0;
+    ScalableBloomFilter terms;
+};
+
+// Per-day synopses of every stored record, kept in memory and persisted by
+// the storage engine. Candidates() lists the partitions a query cannot rule
+// out: time range, types, categories and content types are checked against
+// the zone maps; search text (three characters or more) and applications
+// against the Bloom filter. Thread-safe; queries run concurrently with Add().
+class PartitionSynopsisIndex {
+public:
+    static constexpr int64_t PARTITION_SECONDS = 24 * 60 * 60;
+
+    PartitionSynopsisIndex();
+    ~PartitionSynopsisIndex();
+
+    // metadata is the record's metadata map (application_name,
+    // work_category and content_type are read when present); text is the
+    // plaintext record body
+    void Add(RecordType type, int64_t timestamp, const std::string& text,
+             const std::unordered_map<std::string, std::string>& metadata);
+
+    std::vector<SynopsisCandidate> Candidates(const QueryParams& params, PruningStats& stats) const;
+
+    // Drops partitions that end before cutoff and hold no type in
+    // retained_type_bits, i.e. those retention cleanup emptied
+    void DropBefore(int64_t cutoff, uint64_t retained_type_bits, std::vector<int64_t>& dropped);
+    void Clear();
+
+    // Partitions changed since the last TakeDirty(), serialised
+    std::vector<std::pair<int64_t, std::vector<uint8_t>>> TakeDirty();
+    void MarkAllDirty();
+    bool Load(int64_t partition, const std::vector<uint8_t>& blob);
+
+    size_t GetPartitionCount() const;
+    size_t GetMemoryUsage() const;
+
+    static int64_t PartitionOf(int64_t timestamp);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
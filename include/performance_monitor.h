@@ -26,6 +26,7 @@ struct PerformanceStats {
 // System statistics
 struct SystemStats {
     double cpu_usage_percent = 0.0;
+    double process_cpu_percent = 0.0;
     size_t memory_used_mb = 0;
     size_t memory_total_mb = 0;
     pid_t process_id = 0;
@@ -57,6 +58,11 @@ public:
     void RecordCounter(const std::string& name, int64_t value);
     void IncrementCounter(const std::string& name, int64_t delta = 1);
     
+    // Sample retention per metric; shrinking trims existing history
+    void SetMaxSamples(size_t max_samples);
+    size_t GetMaxSamples() const;
+    size_t GetMemoryFootprint() const;
+    
     // Get statistics
     PerformanceStats GetStats(const std::string& name) const;
     std::vector<std::string> GetAllMetricNames() const;
@@ -71,15 +77,25 @@ private:
     std::unordered_map<std::string, std::vector<std::chrono::microseconds>> m_timings;
     std::unordered_map<std::string, size_t> m_memory_usage;
     std::unordered_map<std::string, int64_t> m_counters;
+    size_t m_max_samples = DEFAULT_MAX_SAMPLES;
+    
+    static constexpr size_t DEFAULT_MAX_SAMPLES = 1000;
 };
 
 // System monitoring utilities
 class SystemMonitor {
 public:
     static SystemStats GetSystemStats();
+    // CPU figures are deltas since the previous call (cached for
+    // CPU_SAMPLE_MIN_INTERVAL_MS so concurrent callers don't shrink the window)
     static double GetCPUUsage();
+    static double GetProcessCPUUsage();   // Percent of all online cores
     static void GetMemoryUsage(size_t& used_mb, size_t& total_mb);
     static void GetProcessMemory(size_t& process_mb);
+    static bool IsOnACPower();   // True on machines without a battery
+
+private:
+    static constexpr int CPU_SAMPLE_MIN_INTERVAL_MS = 250;
 };
 
 // Benchmark suite for performance testing
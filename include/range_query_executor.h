@@ -0,0 +1,71 @@
+#pragma once
+
+#include "storage_engine.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace work_assistant {
+
+struct RangeQueryConfig {
+    std::chrono::hours partition_span{24};          // Preferred partition length
+    std::chrono::minutes min_partition_span{60};    // Short ranges are split no finer
+    size_t max_partitions = 512;
+    size_t parallelism = 0;                         // Worker threads; 0 = one per core
+
+    bool IsValid() const {
+        return partition_span.count() > 0 && min_partition_span.count() > 0 && max_partitions > 0;
+    }
+};
+
+// One slice of a partitioned range; bounds are inclusive, like QueryParams
+struct RangePartition {
+    size_t index = 0;
+    std::chrono::system_clock::time_point start;
+    std::chrono::system_clock::time_point end;
+};
+
+struct RangeQueryStatistics {
+    size_t queries = 0;
+    size_t partitions = 0;
+    size_t cancelled = 0;
+    size_t failed = 0;
+    double average_query_ms = 0.0;
+};
+
+// Runs analytics over long time ranges as independent partitions on a
+// worker pool. The caller splits the range with Partition(), gives each
+// partition its own partial result (indexed by RangePartition::index, so
+// tasks share nothing), and merges the partials once Execute() returns.
+// A cancellation check is polled while tasks run; once it fires, or a task
+// fails, the stop flag handed to every task is raised and Execute() returns
+// false after the running tasks have wound down.
+class RangeQueryExecutor {
+public:
+    using PartitionTask = std::function<bool(const RangePartition& partition, const std::atomic<bool>& stop)>;
+
+    explicit RangeQueryExecutor(const RangeQueryConfig& config = RangeQueryConfig());
+    ~RangeQueryExecutor();
+
+    // Contiguous, non-overlapping partitions covering [start, end] on whole
+    // seconds (the storage resolution); at least one per worker when the
+    // range allows
+    std::vector<RangePartition> Partition(const std::chrono::system_clock::time_point& start,
+                                          const std::chrono::system_clock::time_point& end) const;
+
+    // Runs task once per partition, concurrently unless parallel is false
+    // (e.g. the engine serialises reads), and waits for all of them
+    bool Execute(const std::vector<RangePartition>& partitions, const PartitionTask& task,
+                 const CancellationCheck& cancelled = nullptr, bool parallel = true);
+
+    size_t GetParallelism() const;
+    RangeQueryStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "storage_engine.h"
+#include <functional>
+#include <memory>
+
+namespace work_assistant {
+
+// Hit/miss counters and footprint of a RecordCache
+struct RecordCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// Size-bounded LRU cache of decoded (decrypted, parsed) records keyed by id.
+// Ids are spread over independently locked shards, each evicting its least
+// recently used records once it exceeds its share of the byte budget, so
+// concurrent readers rarely contend. Thread-safe.
+class RecordCache {
+public:
+    explicit RecordCache(size_t capacity_bytes, size_t shard_count = 16);
+    ~RecordCache();
+
+    // Copies the cached record into record; counts a hit or a miss
+    bool Get(uint64_t id, DataRecord& record);
+    // Records larger than a shard's budget are not cached
+    void Put(const DataRecord& record);
+    // For records read from storage: take GetEpoch() before the read, and
+    // the record is dropped if anything was invalidated meanwhile, since
+    // the read may have returned the row an update just replaced
+    uint64_t GetEpoch() const;
+    void Put(const DataRecord& record, uint64_t epoch);
+
+    void Erase(uint64_t id);
+    // Drops every cached record the predicate matches (retention cleanup)
+    void EraseIf(const std::function<bool(const DataRecord&)>& predicate);
+    void Clear();
+
+    RecordCacheStats GetStats() const;
+    size_t GetCapacity() const;
+
+    // Approximate heap footprint of one cached record
+    static size_t EstimateSize(const DataRecord& record);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "storage_engine.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+// Workstation side of delta replication to an aggregator
+struct ReplicationConfig {
+    std::string aggregator_url;               // e.g. http://team-host:8080
+    std::string api_prefix = "/api/v1";
+    std::string workstation_id;               // Defaults to the host name
+    std::string token;                        // Shared secret the aggregator requires
+    bool include_text = false;                // Ship window titles, extracted text and keywords
+    std::chrono::seconds interval{30};        // Between sync rounds once caught up
+    size_t batch_records = 500;               // Records per delta
+    std::chrono::milliseconds timeout{10000};
+
+    bool IsValid() const {
+        return !aggregator_url.empty() && !token.empty() && batch_records > 0 && interval.count() > 0;
+    }
+};
+
+// One replication step: the window events and analyses of a workstation
+// database with source ids in (base, sequence]. source_id identifies the
+// database, so a reinstalled workstation starts a fresh sequence.
+struct ReplicationDelta {
+    std::string workstation;
+    uint64_t source_id = 0;
+    uint64_t base = 0;
+    uint64_t sequence = 0;
+    std::vector<WindowActivityRecord> activities;
+    std::vector<ContentAnalysisRecord> analyses;
+};
+
+namespace replication_utils {
+
+constexpr size_t MAX_WORKSTATION_ID = 64;
+
+// Compact wire form: string table, varints and time deltas, deflated
+// when zlib is available. Decoding refuses deltas whose records would
+// expand past the 64 MB delta limit in strings, since every record
+// refers to the table rather than carrying its own copy.
+std::vector<uint8_t> EncodeDelta(const ReplicationDelta& delta);
+bool DecodeDelta(const std::vector<uint8_t>& encoded, ReplicationDelta& delta);
+
+// Letters, digits, '.', '-' and '_', at most MAX_WORKSTATION_ID
+bool IsValidWorkstationId(const std::string& id);
+// Storage state key of a workstation database's applied sequence
+std::string PositionKey(const std::string& workstation, uint64_t source_id);
+// Checks an Authorization header against the shared token ("Bearer <token>"),
+// in time independent of where they differ
+bool IsAuthorized(const std::string& authorization, const std::string& token);
+
+// Minimal blocking HTTP/1.1 client (plain http only); a non-empty token
+// is sent as a bearer Authorization header
+bool ParseHttpUrl(const std::string& url, std::string& host, int& port, std::string& path);
+bool HttpRequest(const std::string& host, int port, const std::string& method,
+                 const std::string& path, const std::string& content_type,
+                 const std::vector<uint8_t>& body, std::chrono::milliseconds timeout,
+                 int& status, std::string& response, const std::string& token = "");
+
+} // namespace replication_utils
+
+// Pushes the local database to an aggregator as sequence-numbered deltas.
+// Every round first asks the aggregator how far it has applied this
+// database, so restarts and reconnects on either side resume there; the
+// aggregator skips records it already holds.
+class ReplicationClient {
+public:
+    ReplicationClient();
+    ~ReplicationClient();
+
+    bool Initialize(const ReplicationConfig& config, std::shared_ptr<EncryptedStorageManager> storage);
+    bool Start();     // Background rounds, backing off while the aggregator is unreachable
+    void Stop();
+    bool IsRunning() const;
+
+    // Sends deltas until the aggregator has everything; false on failure
+    bool SyncOnce();
+
+    struct Statistics {
+        size_t deltas_sent = 0;
+        size_t records_sent = 0;
+        size_t bytes_sent = 0;
+        size_t failures = 0;
+        uint64_t acknowledged_sequence = 0;
+    };
+    Statistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
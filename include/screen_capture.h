@@ -47,12 +47,66 @@ public:
 
     // Set capture quality/performance settings
     virtual void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS = 30) = 0;
+
+    // Damage-driven desktop capture. Sets changed to false, without reading
+    // any pixels, when nothing was redrawn since the previous call; otherwise
+    // fills frame and lists the redrawn areas in frame.dirty_rects. Callers
+    // should pass the same frame on every call so backends can update only
+    // the redrawn areas in place. Backends without damage tracking grab the
+    // whole desktop every time.
+    virtual bool CaptureDesktopIncremental(CaptureFrame& frame, bool& changed) {
+        changed = true;
+        return CaptureDesktop(frame);
+    }
+    virtual bool CaptureMonitorIncremental(int monitorId, CaptureFrame& frame, bool& changed) {
+        changed = true;
+        return CaptureMonitor(monitorId, frame);
+    }
+    virtual bool SupportsDamageTracking() const { return false; }
+
+    // Reduced-resolution capture for change detection: frame is 1/factor
+    // of the area along each axis, with frame.scale_factor set and dirty
+    // rects in frame coordinates. Backends that can scale on the display
+    // server transfer only the reduced pixels; the default grabs at full
+    // resolution and downscales locally.
+    virtual bool CaptureDesktopScaled(int factor, CaptureFrame& frame, bool& changed);
+    virtual bool CaptureMonitorScaled(int monitorId, int factor, CaptureFrame& frame, bool& changed);
+    virtual bool SupportsServerSideScaling() const { return false; }
+
+    // True when CaptureMonitor/CaptureMonitorIncremental may be called from
+    // several threads at once, one thread per monitor
+    virtual bool SupportsParallelMonitorCapture() const { return false; }
+
+    // Push-based desktop capture: the backend calls onFrame from its own
+    // thread for every new frame, paced by SetCaptureSettings' maxFPS.
+    // Returns false when unsupported, in which case callers poll instead.
+    virtual bool StartStreaming(std::function<void(const CaptureFrame&)> onFrame) {
+        (void)onFrame;
+        return false;
+    }
+    virtual void StopStreaming() {}
+
+    // Backends that capture on their own threads stop doing so while
+    // paused; polled backends have nothing to stop
+    virtual void SetPaused(bool paused) {
+        (void)paused;
+    }
+};
+
+// Capture backends the factory can build. NATIVE is the platform's own
+// (XDamage and XRender scaling on X11); SCREEN_CAPTURE_LITE needs the
+// library at build time and falls back to NATIVE without it.
+enum class CaptureBackend {
+    NATIVE,
+    SCREEN_CAPTURE_LITE
 };
 
 // Screen capture factory
 class ScreenCaptureFactory {
 public:
-    static std::unique_ptr<IScreenCapture> Create();
+    static std::unique_ptr<IScreenCapture> Create(CaptureBackend backend = CaptureBackend::NATIVE);
+    // "native" or "screen_capture_lite"; anything else is NATIVE
+    static CaptureBackend BackendFromName(const std::string& name);
 };
 
 // Screen capture manager with change detection
@@ -63,6 +117,9 @@ public:
 
     // Initialize with capture backend
     bool Initialize();
+    // Use the given backend (e.g. a recorder or replay) instead of the
+    // platform's; null falls back to the platform backend
+    bool Initialize(std::unique_ptr<IScreenCapture> backend);
     void Shutdown();
 
     // Start/stop capture monitoring
@@ -78,11 +135,36 @@ public:
     void SetChangeDetectionThreshold(double threshold); // 0.0 - 1.0
     void EnableChangeDetection(bool enable);
 
-    // Performance settings
+    // Performance settings (take effect on the next capture while monitoring)
     void SetMaxFPS(int fps);
+    int GetMaxFPS() const;
     void SetCaptureRegion(int x, int y, int width, int height);
     void ResetCaptureRegion(); // Capture full desktop
 
+    // Deliver monitored frames at 1/factor resolution (1 = native)
+    void SetDownscaleFactor(int factor);
+    int GetDownscaleFactor() const;
+
+    // Monitor at 1/factor resolution, scaled on the display server where
+    // the backend supports it, so change detection transfers only reduced
+    // pixels. Such frames have scale_factor > 1; CaptureFullResolution
+    // re-reads the same monitor/area natively when OCR needs the detail.
+    void SetDetectionScale(int factor);
+    int GetDetectionScale() const;
+    bool SupportsServerSideScaling() const;
+    bool CaptureFullResolution(const CaptureFrame& detectionFrame, CaptureFrame& frame);
+
+    // Suspend monitored capture without tearing down the session
+    void SetPaused(bool paused);
+    bool IsPaused() const;
+
+    // Multi-monitor layouts are monitored with one worker per monitor; the
+    // focused monitor is polled at the full rate, the others at half rate
+    std::vector<MonitorInfo> GetMonitors() const;
+    int GetMonitorAt(int x, int y) const;   // -1 when the point is off-screen
+    void SetFocusedMonitor(int monitorId);
+    int GetFocusedMonitor() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> m_impl;
@@ -92,22 +174,54 @@ private:
 namespace capture_utils {
 
 // Calculate perceptual hash (dHash) for change detection
-uint64_t CalculateHash(const CaptureFrame& frame);
+uint64_t CalculateHash(const FrameView& frame);
 
 // Calculate difference between two hashes (Hamming distance)
 int CompareHashes(uint64_t hash1, uint64_t hash2);
 
 // Convert frame to different format
-bool ConvertFrame(const CaptureFrame& source, CaptureFrame& target, 
+bool ConvertFrame(const FrameView& source, CaptureFrame& target,
                   int targetBytesPerPixel);
 
 // Save frame to file (for debugging)
-bool SaveFrameToFile(const CaptureFrame& frame, const std::string& filename);
+bool SaveFrameToFile(const FrameView& frame, const std::string& filename);
 
-// Crop frame to region
-bool CropFrame(const CaptureFrame& source, CaptureFrame& target,
+// Crop to region. CropView only narrows the view (the source must outlive
+// it); CropFrame copies the region into a tightly packed frame.
+bool CropView(const FrameView& source, FrameView& target,
+              int x, int y, int width, int height);
+bool CropFrame(const FrameView& source, CaptureFrame& target,
                int x, int y, int width, int height);
 
+// Box-filter downscale by an integer factor. The frame overload also
+// carries dirty rects over, scaled to the new size.
+bool DownscaleFrame(const FrameView& source, CaptureFrame& target, int factor);
+bool DownscaleFrame(const CaptureFrame& source, CaptureFrame& target, int factor);
+
+// Map dirty rects onto a frame reduced by factor
+void ScaleDirtyRects(const std::vector<DirtyRect>& source, int factor,
+                     int targetWidth, int targetHeight, std::vector<DirtyRect>& target);
+
+// Area-averaging resize to any smaller size; target is packed RGB (GRAY
+// for grayscale sources)
+bool ResizeFrame(const FrameView& source, CaptureFrame& target, int width, int height);
+
+// Encode as PNG (deflate-compressed when built with zlib)
+bool EncodePNG(const FrameView& frame, std::vector<uint8_t>& png);
+
+// Thumbnail pyramid stored with each screenshot, widest level last. Levels
+// wider than the frame are left out; a frame narrower than the smallest
+// level yields a single level at its own size.
+constexpr int THUMBNAIL_WIDTHS[] = {64, 256, 1024};
+
+struct ThumbnailLevel {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> png;
+};
+
+bool BuildThumbnailPyramid(const FrameView& frame, std::vector<ThumbnailLevel>& levels);
+
 } // namespace capture_utils
 
 } // namespace work_assistant
\ No newline at end of file
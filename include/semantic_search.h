@@ -0,0 +1,98 @@
+#pragma once
+
+#include "deferred_work_queue.h"
+#include "vector_index.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+class AIContentAnalyzer;
+class EncryptedStorageManager;
+
+struct SemanticSearchConfig {
+    size_t chunk_words = 96;            // Words per embedded chunk
+    size_t chunk_overlap = 16;          // Words shared by consecutive chunks
+    size_t max_chunks_per_record = 16;  // Longer screens keep their first chunks
+    size_t chunks_per_step = 8;         // Embedded per background step
+    size_t snippet_chars = 240;
+    VectorIndexConfig index;
+
+    bool IsValid() const {
+        return chunk_words > 0 && chunk_overlap < chunk_words &&
+               max_chunks_per_record > 0 && max_chunks_per_record <= 255 &&
+               chunks_per_step > 0 && index.IsValid();
+    }
+};
+
+struct SemanticSearchResult {
+    uint64_t record_id = 0;             // OCR record the text came from
+    std::chrono::system_clock::time_point timestamp;
+    float similarity = 0.0f;
+    std::string snippet;                // The matching chunk, shortened
+};
+
+struct SemanticSearchStatistics {
+    bool ready = false;
+    size_t indexed_chunks = 0;
+    uint64_t indexed_through = 0;       // Last OCR record embedded
+    size_t embedded_chunks = 0;         // This run
+    size_t searches = 0;
+    double average_search_ms = 0.0;     // Query embedding included
+    VectorIndexStatistics index;
+};
+
+// Meaning-based search over stored screen text. OCR records are split into
+// overlapping word windows, embedded with the AI analyzer's model in small
+// batches from an idle-time job, and kept in an on-disk VectorIndex; a
+// query is embedded the same way and answered from the index, restricted to
+// a time range. The index remembers the last record embedded, so embedding
+// resumes where it stopped, and starts over when the model changes.
+class SemanticSearch {
+public:
+    SemanticSearch();
+    ~SemanticSearch();
+
+    // Fails (and search stays unavailable) when the analyzer's model does
+    // not produce embeddings
+    bool Open(const std::string& path, std::shared_ptr<EncryptedStorageManager> storage,
+              AIContentAnalyzer* analyzer, const SemanticSearchConfig& config = SemanticSearchConfig());
+    void Close();
+    bool IsReady() const;
+
+    // Embeds the next batch of chunks not yet indexed: MORE while records
+    // remain, DONE once caught up. Meant as a DeferredWorkQueue handler.
+    DeferredJobResult RunEmbeddingStep();
+
+    // Up to k matches with start <= timestamp <= end, best first, at most
+    // one per OCR record
+    std::vector<SemanticSearchResult> Search(const std::string& query, size_t k,
+                                             std::chrono::system_clock::time_point start,
+                                             std::chrono::system_clock::time_point end);
+
+    bool Flush();
+    SemanticSearchStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+// Utility functions for semantic search
+namespace semantic_utils {
+
+// Overlapping windows of whitespace-separated words, at most maxChunks
+std::vector<std::string> SplitIntoChunks(const std::string& text, size_t chunkWords,
+                                         size_t overlap, size_t maxChunks);
+
+// Index ids pack the OCR record id and the chunk number
+inline uint64_t MakeChunkId(uint64_t recordId, size_t chunk) { return (recordId << 8) | (chunk & 0xFF); }
+inline uint64_t ChunkRecordId(uint64_t chunkId) { return chunkId >> 8; }
+inline size_t ChunkNumber(uint64_t chunkId) { return static_cast<size_t>(chunkId & 0xFF); }
+
+} // namespace semantic_utils
+
+} // namespace work_assistant
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+// Outcome of a single startup stage
+enum class StageState {
+    PENDING,
+    RUNNING,
+    SUCCEEDED,
+    FAILED,
+    SKIPPED     // A dependency failed, stage never ran
+};
+
+// Per-stage timing report
+struct StageTiming {
+    std::string name;
+    StageState state = StageState::PENDING;
+    bool deferred = false;
+    std::chrono::microseconds queued_at{0};    // Offset from sequencer start
+    std::chrono::microseconds duration{0};
+};
+
+// Dependency-graph initializer. Stages whose dependencies are satisfied are
+// dispatched to the thread pool concurrently; deferred stages are held back
+// until RunDeferred() is called (typically after the first captured frame).
+class StartupSequencer {
+public:
+    using StageFunction = std::function<bool()>;
+
+    StartupSequencer();
+    ~StartupSequencer();
+
+    // Register a stage. Dependencies must name previously or later added
+    // stages; deferred stages may depend on immediate ones but not vice versa.
+    void AddStage(const std::string& name,
+                  StageFunction fn,
+                  const std::vector<std::string>& dependencies = {},
+                  bool deferred = false);
+
+    // Run all immediate stages and block until they complete.
+    // Returns false only if the graph is invalid (unknown dependency, cycle).
+    bool Run(WorkAssistant::ThreadPool& pool);
+
+    // Start deferred stages without blocking. Safe to call more than once.
+    void RunDeferred(WorkAssistant::ThreadPool& pool);
+    void WaitForDeferred();
+
+    bool HasDeferredStarted() const;
+    std::vector<StageTiming> GetTimings() const;
+    std::chrono::microseconds GetElapsed() const;
+    void PrintReport() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -21,7 +21,8 @@ enum class RecordType {
     OCR_RESULT = 3,
     AI_ANALYSIS = 4,
     USER_ACTION = 5,
-    SYSTEM_INFO = 6
+    SYSTEM_INFO = 6,
+    DEFERRED_JOB = 7    // Pending background work, exempt from retention cleanup
 };
 
 // Storage security levels
@@ -57,6 +58,7 @@ struct DataRecord {
 struct WindowActivityRecord {
     uint64_t id = 0;
     std::chrono::system_clock::time_point timestamp;
+    std::string session_id;
     std::string window_title;
     std::string application_name;
     uint32_t process_id = 0;
@@ -101,6 +103,62 @@ struct ContentAnalysisRecord {
     static ContentAnalysisRecord FromDataRecord(const DataRecord& record);
 };
 
+// Running productivity totals over content analyses; partials from separate
+// scans merge exactly
+struct ProductivityTotals {
+    int activities = 0;
+    int productive = 0;
+    int focused = 0;
+    float confidence = 0.0f;
+    int distraction = 0;
+    std::unordered_map<ContentType, int> type_counts;
+    
+    void Add(const ContentAnalysisRecord& analysis);
+    void Merge(const ProductivityTotals& other);
+    // Report keys as returned by GetProductivityReport; empty without activities
+    std::unordered_map<std::string, float> ToReport() const;
+};
+
+// Window events and analyses over one range, gathered in a single scan so
+// several views of the range read storage once
+struct ActivityRollup {
+    std::chrono::system_clock::time_point start_time;
+    std::chrono::system_clock::time_point end_time;
+    std::vector<WindowActivityRecord> activities;   // Oldest first
+    std::vector<ContentAnalysisRecord> analyses;    // Oldest first
+};
+
+// Recognised text of one screen, as stored by StoreOCRResult
+struct OCRTextRecord {
+    uint64_t id = 0;
+    std::chrono::system_clock::time_point timestamp;
+    std::string text;
+};
+
+// Pending background job persisted by the deferred work queue
+struct DeferredJobRecord {
+    uint64_t id = 0;
+    std::chrono::system_clock::time_point enqueued_at;
+    std::string kind;         // Selects the handler
+    std::string payload;      // Handler-defined job parameters
+    std::string cursor;       // Resume point after the last completed chunk
+    int priority = 0;         // Higher runs first
+    int attempts = 0;         // Failed chunks so far
+    
+    // Convert to/from DataRecord
+    DataRecord ToDataRecord() const;
+    static DeferredJobRecord FromDataRecord(const DataRecord& record);
+};
+
+// One level of the thumbnail pyramid stored with a screen capture
+struct ScreenThumbnail {
+    uint64_t capture_id = 0;
+    std::chrono::system_clock::time_point timestamp;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> data;    // PNG; empty in listings
+};
+
 // Storage configuration
 struct StorageConfig {
     std::string storage_path = "data/";
@@ -117,6 +175,7 @@ struct StorageConfig {
     bool enable_compression = true;
     bool enable_indexing = true;
     size_t write_buffer_size_mb = 64;
+    size_t record_cache_size_mb = 32;       // Decoded-record cache, 0 disables
     int backup_interval_hours = 24;
     
     // Security settings
@@ -148,6 +207,16 @@ struct StorageStatistics {
     double avg_read_time_ms = 0.0;
     size_t total_writes = 0;
     size_t total_reads = 0;
+
+    // Time partitions read vs skipped by synopsis pruning, since startup
+    size_t partitions_scanned = 0;
+    size_t partitions_pruned = 0;
+
+    // Decoded-record cache
+    size_t record_cache_hits = 0;
+    size_t record_cache_misses = 0;
+    double record_cache_hit_rate = 0.0;
+    size_t record_cache_bytes = 0;
     
     StorageStatistics() = default;
 };
@@ -164,6 +233,8 @@ struct QueryParams {
     std::vector<ContentType> content_types;
     std::vector<WorkCategory> work_categories;
     std::string search_text;
+    uint64_t after_id = 0;          // Only records with a larger id (paging in id order)
+    bool order_by_id = false;       // Id order instead of time order (with after_id, a stable cursor)
     
     // Result options
     size_t limit = 1000;
@@ -178,6 +249,17 @@ struct QueryParams {
     }
 };
 
+// Time partitions a scan read vs skipped because their synopsis ruled
+// the query out
+struct PruningStats {
+    size_t partitions_scanned = 0;
+    size_t partitions_pruned = 0;
+};
+
+// Polled by long-running reads; returns true once the caller no longer
+// wants the result (e.g. the HTTP client disconnected)
+using CancellationCheck = std::function<bool()>;
+
 // Storage engine interface
 class IStorageEngine {
 public:
@@ -199,6 +281,7 @@ public:
     virtual uint64_t StoreRecord(const DataRecord& record) = 0;
     virtual bool StoreRecords(const std::vector<DataRecord>& records) = 0;
     virtual bool GetRecord(uint64_t id, DataRecord& record) = 0;
+    virtual bool UpdateRecord(const DataRecord& record) = 0;   // Replaces metadata and data
     virtual std::vector<DataRecord> QueryRecords(const QueryParams& params) = 0;
     virtual bool DeleteRecord(uint64_t id) = 0;
     virtual bool DeleteRecords(const QueryParams& params) = 0;
@@ -209,6 +292,15 @@ public:
     virtual uint64_t StoreScreenCapture(const CaptureFrame& frame, 
                                        const std::string& window_title = "") = 0;
 
+    // Screen capture thumbnails. GetScreenCaptureThumbnail returns the
+    // narrowest level at least width wide, else the widest there is;
+    // listings carry every level without image data.
+    virtual bool GetScreenCaptureThumbnail(uint64_t capture_id, int width,
+                                           ScreenThumbnail& thumbnail) = 0;
+    virtual std::vector<ScreenThumbnail> ListScreenCaptureThumbnails(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end) = 0;
+
     // Search and analytics
     virtual std::vector<std::string> SearchText(const std::string& query, 
                                                const QueryParams& params = QueryParams()) = 0;
@@ -219,6 +311,36 @@ public:
         const std::chrono::system_clock::time_point& start,
         const std::chrono::system_clock::time_point& end) = 0;
 
+    // Streams every record matching params (limit and offset are ignored)
+    // to visitor until it returns false. Engines that can serve concurrent
+    // calls from separate reader connections report so, letting range
+    // queries scan partitions in parallel. search_text, applications,
+    // content_types and work_categories are hints an engine may use to
+    // skip records that cannot match; visitors still check them. pruning,
+    // when given, receives the partitions read and skipped.
+    virtual bool ScanRecords(const QueryParams& params,
+                             const std::function<bool(const DataRecord&)>& visitor,
+                             PruningStats* pruning = nullptr) {
+        (void)pruning;
+        QueryParams all = params;
+        all.limit = static_cast<size_t>(INT64_MAX);
+        all.offset = 0;
+        for (const DataRecord& record : QueryRecords(all)) {
+            if (!visitor(record)) {
+                break;
+            }
+        }
+        return true;
+    }
+    virtual bool SupportsConcurrentReads() const { return false; }
+
+    // Named values kept in the database with the records (e.g. replication
+    // positions). StoreRecordsWithState writes the records, which may be
+    // none, and the value in one transaction.
+    virtual bool GetStateValue(const std::string& key, std::string& value) = 0;
+    virtual bool StoreRecordsWithState(const std::vector<DataRecord>& records,
+                                       const std::string& key, const std::string& value) = 0;
+
     // Maintenance operations
     virtual bool CompactDatabase() = 0;
     virtual bool CleanupOldData() = 0;
@@ -250,8 +372,9 @@ public:
     // High-level storage operations
     bool StoreWindowEvent(const WindowEvent& event, const WindowInfo& info);
     bool StoreScreenCapture(const CaptureFrame& frame, const std::string& context = "");
-    bool StoreOCRResult(const OCRDocument& document, const std::string& source = "");
-    bool StoreAIAnalysis(const ContentAnalysis& analysis);
+    // OCR and analysis results return the new record id, 0 on failure
+    uint64_t StoreOCRResult(const OCRDocument& document, const std::string& source = "");
+    uint64_t StoreAIAnalysis(const ContentAnalysis& analysis);
 
     // Batch operations
     bool StoreBatch(const std::vector<WindowActivityRecord>& activities,
@@ -266,18 +389,41 @@ public:
         const std::chrono::system_clock::time_point& start,
         const std::chrono::system_clock::time_point& end);
 
-    // Analytics and reporting
-    std::unordered_map<std::string, float> GetProductivityReport(
+    bool GetContentAnalysis(uint64_t id, ContentAnalysisRecord& analysis);
+    // Stored OCR text with ids above after_id, in id order
+    std::vector<OCRTextRecord> GetOCRResults(uint64_t after_id, size_t limit);
+    bool GetOCRResult(uint64_t id, OCRTextRecord& result);
+    bool GetScreenCaptureThumbnail(uint64_t capture_id, int width, ScreenThumbnail& thumbnail);
+    std::vector<ScreenThumbnail> GetScreenCaptureThumbnails(
         const std::chrono::system_clock::time_point& start,
         const std::chrono::system_clock::time_point& end);
+
+    // Analytics and reporting. Both scan the whole range as time partitions
+    // in parallel; a cancelled query returns an empty result.
+    std::unordered_map<std::string, float> GetProductivityReport(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end,
+        const CancellationCheck& cancelled = nullptr);
     
     std::vector<std::pair<std::string, std::chrono::minutes>> GetTimeSpentByApplication(
         const std::chrono::system_clock::time_point& start,
-        const std::chrono::system_clock::time_point& end);
+        const std::chrono::system_clock::time_point& end,
+        const CancellationCheck& cancelled = nullptr);
+
+    // Every window event and analysis in [start, end] from one partitioned
+    // scan; false if cancelled or the scan failed
+    bool GetActivityRollup(const std::chrono::system_clock::time_point& start,
+                           const std::chrono::system_clock::time_point& end,
+                           ActivityRollup& rollup,
+                           const CancellationCheck& cancelled = nullptr);
 
     // Search functionality
+    // Case-insensitive match on extracted text over the whole history,
+    // newest first, optionally limited to one application
     std::vector<ContentAnalysisRecord> SearchContent(const std::string& query,
-                                                     int max_results = 100);
+                                                     int max_results = 100,
+                                                     const std::string& application = "",
+                                                     PruningStats* pruning = nullptr);
 
     // Data management
     bool ExportData(const std::string& export_path, 
@@ -285,6 +431,27 @@ public:
                    const std::chrono::system_clock::time_point& end);
     bool ImportData(const std::string& import_path);
     bool CleanupOldData(const std::chrono::hours& retention_period);
+    bool CompactDatabase();
+
+    // Deferred job persistence
+    uint64_t StoreDeferredJob(const DeferredJobRecord& job);
+    bool UpdateDeferredJob(const DeferredJobRecord& job);
+    bool RemoveDeferredJob(uint64_t id);
+    std::vector<DeferredJobRecord> GetDeferredJobs();
+
+    // Replication support. GetRecordsAfter returns up to limit window
+    // events and analyses with ids above after_id, in id order, and the id
+    // of the last one in last_id (after_id when there are none).
+    // StoreBatchWithState stores records and a state value atomically.
+    bool GetRecordsAfter(uint64_t after_id, size_t limit,
+                         std::vector<WindowActivityRecord>& activities,
+                         std::vector<ContentAnalysisRecord>& analyses,
+                         uint64_t& last_id);
+    bool StoreBatchWithState(const std::vector<WindowActivityRecord>& activities,
+                             const std::vector<ContentAnalysisRecord>& analyses,
+                             const std::string& key, const std::string& value);
+    bool GetStateValue(const std::string& key, std::string& value);
+    bool SetStateValue(const std::string& key, const std::string& value);
 
     // Security operations
     bool ChangePassword(const std::string& old_password, const std::string& new_password);
@@ -339,6 +506,8 @@ std::string SerializeToJson(const ContentAnalysisRecord& record);
 ContentAnalysisRecord DeserializeFromJson(const std::string& json);
 std::string SerializeToJson(const WindowActivityRecord& record);
 WindowActivityRecord DeserializeWindowFromJson(const std::string& json);
+std::string SerializeToJson(const DeferredJobRecord& record);
+DeferredJobRecord DeserializeDeferredJobFromJson(const std::string& json);
 
 // File operations
 bool EnsureDirectoryExists(const std::string& path);
@@ -346,6 +515,10 @@ bool IsValidDatabasePath(const std::string& path);
 size_t GetDirectorySize(const std::string& path);
 bool SecureDeleteFile(const std::string& path);
 
+// Analytics helpers; each window event stands for about 30 seconds of use
+std::vector<std::pair<std::string, std::chrono::minutes>> EstimateTimeByApplication(
+    const std::unordered_map<std::string, int>& event_counts);
+
 // Time utilities
 std::string FormatTimestamp(const std::chrono::system_clock::time_point& time);
 std::chrono::system_clock::time_point ParseTimestamp(const std::string& timestamp);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace work_assistant {
+
+// One sample of a continuous timeline metric
+struct TimelinePoint {
+    std::chrono::system_clock::time_point timestamp;
+    double value = 0.0;
+    int category = 0;         // Grouping key for bucket aggregation
+};
+
+// Aggregate of the samples of one category in one time bucket
+struct TimelineBucket {
+    std::chrono::system_clock::time_point start;
+    std::chrono::system_clock::time_point end;
+    int category = 0;
+    size_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double avg = 0.0;
+};
+
+// Server-side thinning of long timelines, so the payload and render cost
+// depend on the requested point count rather than on the range
+namespace downsampling {
+
+// Largest-triangle-three-buckets over points sorted by time: indices of
+// `threshold` points that keep the visual shape of the series, always
+// including the first and last. Every index when the series is no longer.
+std::vector<size_t> LargestTriangleThreeBuckets(const std::vector<TimelinePoint>& points,
+                                                size_t threshold);
+
+// Splits [start, end] into bucket_count equal buckets and aggregates the
+// points of each category per bucket; empty buckets are omitted. Ordered by
+// bucket, then category.
+std::vector<TimelineBucket> AggregateBuckets(const std::vector<TimelinePoint>& points,
+                                             const std::chrono::system_clock::time_point& start,
+                                             const std::chrono::system_clock::time_point& end,
+                                             size_t bucket_count);
+
+} // namespace downsampling
+
+} // namespace work_assistant
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+
+namespace work_assistant {
+
+// Lock-free single-producer/single-consumer triple buffer. The writer fills
+// WriteBuffer() and publishes it without ever waiting for the reader; the
+// reader always sees the most recently published buffer. Buffers are reused,
+// so a T that owns storage (e.g. CaptureFrame) stops allocating after warm-up.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_back(0), m_middle(1), m_front(2), m_published(false) {}
+
+    // Writer side
+    T& WriteBuffer() {
+        return m_slots[m_back];
+    }
+
+    void Publish() {
+        int previous = m_middle.exchange(m_back | FRESH_BIT, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+        m_published.store(true, std::memory_order_release);
+    }
+
+    // Reader side. Swaps in the newest published buffer, if any, and returns
+    // whether one was swapped in.
+    bool Update() {
+        if (!(m_middle.load(std::memory_order_acquire) & FRESH_BIT)) {
+            return false;
+        }
+        int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& ReadBuffer() const {
+        return m_slots[m_front];
+    }
+
+    // True once the writer has published at least one buffer
+    bool HasData() const {
+        return m_published.load(std::memory_order_acquire);
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+private:
+    static constexpr int INDEX_MASK = 0x3;
+    static constexpr int FRESH_BIT = 0x4;
+
+    T m_slots[3];
+    int m_back;                 // Owned by the writer
+    std::atomic<int> m_middle;  // Index of the handoff slot plus FRESH_BIT
+    int m_front;                // Owned by the reader
+    std::atomic<bool> m_published;
+};
+
+} // namespace work_assistant
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace work_assistant {
+
+struct VectorIndexConfig {
+    int m = 16;                         // Links per node above level 0 (2m on level 0)
+    int ef_construction = 100;          // Candidate list size while inserting
+    int ef_search = 64;                 // Minimum candidate list size while searching
+    size_t exact_scan_limit = 50000;    // Time ranges with fewer vectors are scanned exactly
+
+    bool IsValid() const {
+        return m >= 4 && m <= 64 && ef_construction >= m && ef_search > 0;
+    }
+};
+
+struct VectorMatch {
+    uint64_t id = 0;
+    std::chrono::system_clock::time_point timestamp;
+    float similarity = 0.0f;            // Cosine similarity, -1..1
+};
+
+struct VectorIndexStatistics {
+    size_t vectors = 0;
+    int dimension = 0;
+    int max_level = 0;
+    size_t file_bytes = 0;
+    size_t searches = 0;
+    size_t exact_scans = 0;             // Searches answered by scanning the time range
+};
+
+// Persistent approximate nearest-neighbour index over embedding vectors.
+// Vectors are L2-normalised and quantised to int8 with a per-vector scale,
+// and linked into an HNSW graph stored in memory-mapped files, so opening a
+// large index costs no load time and only the pages a query visits are
+// read. Each vector carries a caller-defined id and a timestamp; searches
+// take a time range, and ranges holding few vectors are answered by an
+// exact scan instead of a filtered graph walk.
+//
+// Files: <path> holds the header and the fixed-size node records (vector
+// and level-0 links); <path>.upper holds links for the few nodes on higher
+// levels. Both only grow. Thread-safe: searches run concurrently, additions
+// are exclusive.
+class VectorIndex {
+public:
+    VectorIndex();
+    ~VectorIndex();
+
+    // Opens or creates the index. An index built for another dimension or
+    // model tag is discarded and starts empty (see GetWatermark).
+    bool Open(const std::string& path, int dimension, const std::string& modelTag,
+              const VectorIndexConfig& config = VectorIndexConfig());
+    void Close();
+    bool IsOpen() const;
+
+    bool Add(uint64_t id, std::chrono::system_clock::time_point timestamp,
+             const std::vector<float>& vector);
+
+    // Up to k most similar vectors with start <= timestamp <= end, best first
+    std::vector<VectorMatch> Search(const std::vector<float>& query, size_t k,
+                                    std::chrono::system_clock::time_point start,
+                                    std::chrono::system_clock::time_point end) const;
+
+    // Writes dirty pages back to the files
+    bool Flush();
+
+    // Caller-defined progress marker stored with the vectors (e.g. the last
+    // source record embedded), reset together with them
+    void SetWatermark(uint64_t value);
+    uint64_t GetWatermark() const;
+
+    size_t Size() const;
+    int Dimension() const;
+    VectorIndexStatistics GetStatistics() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -15,6 +15,7 @@ using namespace drogon;
 namespace work_assistant {
 
 class EncryptedStorageManager;
+class SemanticSearch;
 
 // Web server configuration
 struct WebServerConfig {
@@ -27,9 +28,12 @@ struct WebServerConfig {
     std::string ssl_key_path;
     std::string api_prefix = "/api/v1";
     bool enable_websocket = true;
+    bool accept_replication = false;  // Aggregator mode: accept workstation deltas
+    std::string replication_token;    // Bearer token workstations must present
     
     bool IsValid() const {
-        return port > 0 && port < 65536 && !host.empty();
+        return port > 0 && port < 65536 && !host.empty() &&
+               (!accept_replication || !replication_token.empty());
     }
 };
 
@@ -43,6 +47,25 @@ struct ApiResponse {
     std::string ToJson() const;
 };
 
+// One named query of a batch request. Types: summary, timeline,
+// applications (all over [start, end]) and status.
+struct BatchSubQuery {
+    std::string name;
+    std::string type;
+    std::chrono::system_clock::time_point start;
+    std::chrono::system_clock::time_point end;
+};
+
+// Server-side downsampling of the activity timeline. raw returns every
+// analysis (newest first, capped); buckets aggregates the metric per work
+// category in `points` equal time buckets; lttb keeps `points` analyses
+// that preserve the shape of the metric over time.
+struct TimelineOptions {
+    std::string mode = "raw";           // raw, buckets or lttb
+    std::string metric = "confidence";  // confidence, distraction or productive
+    size_t points = 0;                  // Target point count; 0 = default
+};
+
 struct ProductivitySummary {
     float productivity_score = 0.0f;
     float focused_time_ratio = 0.0f;
@@ -118,6 +141,9 @@ public:
     void OnOCRResult(const OCRDocument& document);
     void OnAIAnalysis(const ContentAnalysis& analysis);
     
+    // Backs /search/semantic; the endpoint reports 503 until it is ready
+    void SetSemanticSearch(std::shared_ptr<SemanticSearch> search);
+    
     WebServerConfig GetConfig() const;
     void UpdateConfig(const WebServerConfig& config);
     
@@ -139,22 +165,54 @@ private:
 // API Handler functions (used internally)
 namespace api_handlers {
     
-    // Productivity endpoints
+    // Productivity endpoints; a query whose client went away (cancelled
+    // returns true) is abandoned and answered with 499
     ApiResponse GetProductivitySummary(const std::chrono::system_clock::time_point& start,
                                      const std::chrono::system_clock::time_point& end,
-                                     EncryptedStorageManager* storage);
+                                     EncryptedStorageManager* storage,
+                                     const CancellationCheck& cancelled = nullptr);
     
+    constexpr size_t DEFAULT_TIMELINE_POINTS = 500;
+    constexpr size_t MAX_TIMELINE_POINTS = 5000;
     ApiResponse GetActivityTimeline(const std::chrono::system_clock::time_point& start,
                                   const std::chrono::system_clock::time_point& end,
-                                  EncryptedStorageManager* storage);
+                                  EncryptedStorageManager* storage,
+                                  const TimelineOptions& options = TimelineOptions(),
+                                  const CancellationCheck& cancelled = nullptr);
     
     ApiResponse GetApplicationUsage(const std::chrono::system_clock::time_point& start,
                                   const std::chrono::system_clock::time_point& end,
-                                  EncryptedStorageManager* storage);
+                                  EncryptedStorageManager* storage,
+                                  const CancellationCheck& cancelled = nullptr);
+    
+    // Answers several sub-queries in one response. Sub-queries whose ranges
+    // overlap share a single storage scan; "scans" in the result counts them.
+    constexpr size_t MAX_BATCH_QUERIES = 16;
+    ApiResponse ExecuteBatch(const std::vector<BatchSubQuery>& queries,
+                           EncryptedStorageManager* storage,
+                           const CancellationCheck& cancelled = nullptr);
+    
+    // Screenshot thumbnails; the image is returned in thumbnail
+    ApiResponse GetScreenshotTimeline(const std::chrono::system_clock::time_point& start,
+                                    const std::chrono::system_clock::time_point& end,
+                                    const std::string& thumbnail_path,
+                                    EncryptedStorageManager* storage);
+    
+    ApiResponse GetScreenshotThumbnail(uint64_t capture_id, int width,
+                                     EncryptedStorageManager* storage,
+                                     ScreenThumbnail& thumbnail);
     
     // Search endpoints
+    // application, when set, limits matches to that application; the
+    // response reports how many day partitions were scanned and pruned
     ApiResponse SearchContent(const std::string& query, int max_results,
-                            EncryptedStorageManager* storage);
+                            EncryptedStorageManager* storage,
+                            const std::string& application = "");
+    
+    ApiResponse SemanticSearchContent(const std::string& query, int max_results,
+                                    const std::chrono::system_clock::time_point& start,
+                                    const std::chrono::system_clock::time_point& end,
+                                    SemanticSearch* search);
     
     // Export endpoints
     ApiResponse ExportData(const std::chrono::system_clock::time_point& start,
@@ -165,6 +223,15 @@ namespace api_handlers {
     // System endpoints
     ApiResponse GetSystemStatus();
     ApiResponse GetConfiguration();
+    ApiResponse GetResourceBudget();   // CPU and memory governor state
+    
+    // Aggregator endpoints. A delta is applied only if it continues the
+    // stored sequence of its workstation database (409 otherwise, with the
+    // sequence to resume from); repeated deltas are acknowledged unapplied.
+    ApiResponse GetReplicationPosition(const std::string& workstation, uint64_t source_id,
+                                     EncryptedStorageManager* storage);
+    ApiResponse ApplyReplicationDelta(const std::vector<uint8_t>& body,
+                                    EncryptedStorageManager* storage);
     
 } // namespace api_handlers
 
@@ -180,4 +247,14 @@ namespace web_utils {
     
 } // namespace web_utils
 
+// Offline message buffer for WebSocket clients
+namespace websocket_utils {
+    
+    constexpr size_t DEFAULT_QUEUE_LIMIT = 1000;
+    
+    void SetQueueLimit(size_t max_messages);
+    size_t GetQueueMemoryUsage();
+    
+} // namespace websocket_utils
+
 } // namespace work_assistant
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common_types.h"
+#include "websocket_subscription.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -62,8 +63,11 @@ public:
     bool PerformHandshake(const std::string& request);
     void ProcessIncomingData();
     
+    // Frames are identical for every client, so broadcasts encode once
+    static std::string EncodeWebSocketFrame(const std::string& payload);
+    void SendFrame(const std::string& frame);
+    
 private:
-    std::string EncodeWebSocketFrame(const std::string& payload);
     std::string DecodeWebSocketFrame(const std::vector<uint8_t>& frame);
     std::string GenerateWebSocketAccept(const std::string& key);
     
@@ -88,6 +92,8 @@ public:
     // Connection management
     virtual void BroadcastMessage(const WSMessage& message) = 0;
     virtual void SendToClient(const std::string& client_id, const WSMessage& message) = 0;
+    // One serialized message to several clients, framed once
+    virtual void SendToClients(const std::vector<std::string>& client_ids, const std::string& payload) = 0;
     virtual std::vector<std::string> GetConnectedClients() const = 0;
     virtual size_t GetConnectionCount() const = 0;
     
@@ -114,6 +120,7 @@ public:
     
     void BroadcastMessage(const WSMessage& message) override;
     void SendToClient(const std::string& client_id, const WSMessage& message) override;
+    void SendToClients(const std::vector<std::string>& client_ids, const std::string& payload) override;
     std::vector<std::string> GetConnectedClients() const override;
     size_t GetConnectionCount() const override;
     
@@ -165,19 +172,23 @@ public:
     WebSocketClientManager(std::shared_ptr<IWebSocketServer> server);
     ~WebSocketClientManager();
     
-    // Subscription management
+    // Subscription management; the event type list form subscribes
+    // without further filtering
     void HandleClientSubscription(const std::string& client_id, const std::vector<std::string>& subscriptions);
+    void HandleClientSubscription(const std::string& client_id, const WSSubscriptionFilter& filter);
     void UnsubscribeClient(const std::string& client_id);
     
-    // Event broadcasting
+    // Event broadcasting; source identifies the window a result was read
+    // from, for application and window filters
     void BroadcastWindowEvent(const WindowEvent& event, const WindowInfo& info);
-    void BroadcastOCRResult(const OCRDocument& document);
-    void BroadcastAIAnalysis(const ContentAnalysis& analysis);
+    void BroadcastOCRResult(const OCRDocument& document, const WindowInfo& source = WindowInfo());
+    void BroadcastAIAnalysis(const ContentAnalysis& analysis, const WindowInfo& source = WindowInfo());
     void BroadcastProductivityUpdate(int score);
     void BroadcastSystemStatus(const std::string& status);
     
     // Statistics
     size_t GetSubscribedClientCount() const;
+    size_t GetFilterGroupCount() const;
     std::vector<std::string> GetClientSubscriptions(const std::string& client_id) const;
     
 private:
@@ -185,14 +196,13 @@ private:
     void OnClientMessage(std::shared_ptr<IWebSocketConnection> connection, const WSMessage& message);
     void OnClientDisconnected(const std::string& client_id);
     
-    bool IsClientSubscribed(const std::string& client_id, const std::string& event_type) const;
+    // Sends the message, serialized once, to the clients of every filter
+    // group it matches
+    void Dispatch(const WSMessage& message, const WSMessageAttributes& attributes);
     
 private:
     std::shared_ptr<IWebSocketServer> m_server;
-    
-    // Client subscriptions: client_id -> set of subscribed event types
-    std::unordered_map<std::string, std::vector<std::string>> m_client_subscriptions;
-    mutable std::mutex m_subscriptions_mutex;
+    WSSubscriptionRegistry m_subscriptions;
 };
 
 } // namespace work_assistant
\ No newline at end of file
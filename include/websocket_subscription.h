@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace work_assistant {
+
+// Server-side subscription filter, sent by a client as the data of a
+// SUBSCRIPTION message:
+//   {"events":["ai_analysis"],"applications":["code"],"content_types":[2],
+//    "categories":[1],"min_priority":4,"windows":[12345]}
+// Each non-empty field constrains the event types that carry its attribute:
+// applications and windows apply to window events, OCR results and AI
+// analyses; content types, categories and min_priority to AI analyses. A
+// message of such a type that lacks the attribute (e.g. an OCR result whose
+// source window is unknown) does not match. Productivity updates and system
+// status carry none and match on their event type alone. Without events
+// nothing is delivered.
+struct WSSubscriptionFilter {
+    std::vector<std::string> event_types;   // window_events, ocr_results, ai_analysis, productivity_updates, system_status
+    std::vector<std::string> applications;  // Process names
+    std::vector<int> content_types;         // ContentType values
+    std::vector<int> work_categories;       // WorkCategory values
+    int min_priority = 0;                   // ActivityPriority value; 0 = any
+    std::vector<uint64_t> window_ids;
+
+    // Canonical form; clients whose filters have the same key share a group
+    std::string Key() const;
+    static WSSubscriptionFilter FromJSON(const std::string& json);
+};
+
+// What a filter can match an outgoing message on
+struct WSMessageAttributes {
+    std::string event_type;
+    std::string application;    // Empty: unknown
+    int content_type = -1;      // -1: unknown
+    int work_category = -1;
+    int priority = -1;
+    uint64_t window_id = 0;     // 0: unknown
+};
+
+// A filter compiled to bit masks and hash sets
+class WSCompiledFilter {
+public:
+    explicit WSCompiledFilter(const WSSubscriptionFilter& filter);
+
+    bool Matches(const WSMessageAttributes& attributes) const;
+    const WSSubscriptionFilter& GetFilter() const { return m_filter; }
+
+private:
+    WSSubscriptionFilter m_filter;
+    uint32_t m_event_mask;
+    std::unordered_set<std::string> m_applications;
+    std::bitset<64> m_content_types;
+    std::bitset<64> m_work_categories;
+    std::unordered_set<uint64_t> m_window_ids;
+};
+
+// Subscribed clients, grouped by filter: clients with identical filters
+// share one compiled filter, so a message is matched once per group rather
+// than once per client. Thread-safe.
+class WSSubscriptionRegistry {
+public:
+    // Replaces the client's previous subscription
+    void Subscribe(const std::string& client_id, const WSSubscriptionFilter& filter);
+    void Unsubscribe(const std::string& client_id);
+
+    // Clients whose filter matches the message
+    std::vector<std::string> GetRecipients(const WSMessageAttributes& attributes) const;
+
+    size_t GetClientCount() const;
+    size_t GetGroupCount() const;
+    std::vector<std::string> GetEventTypes(const std::string& client_id) const;
+
+private:
+    struct Group {
+        explicit Group(const WSSubscriptionFilter& filter) : filter(filter) {}
+        WSCompiledFilter filter;
+        std::vector<std::string> clients;
+    };
+
+    void UnsubscribeLocked(const std::string& client_id);
+
+    std::unordered_map<std::string, std::shared_ptr<Group>> m_groups;   // filter key -> group
+    std::unordered_map<std::string, std::string> m_client_groups;      // client_id -> filter key
+    mutable std::mutex m_mutex;
+};
+
+} // namespace work_assistant
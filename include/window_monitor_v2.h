@@ -28,6 +28,12 @@ public:
     
     // Get all visible windows
     virtual std::vector<WindowInfo> GetAllWindows() const = 0;
+
+    // Time since the last user input or focus change; negative when the
+    // backend cannot tell
+    virtual std::chrono::milliseconds GetIdleTime() const {
+        return std::chrono::milliseconds(-1);
+    }
 };
 
 // Window monitor factory
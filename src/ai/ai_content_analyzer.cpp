@@ -110,6 +110,27 @@ public:
         return m_engine->AnalyzeContentAsync(ocr_result, window_title, app_name);
     }
 
+    bool Embed(const std::vector<std::string>& texts, std::vector<std::vector<float>>& embeddings) {
+        embeddings.clear();
+        if (!IsReady() || texts.empty()) {
+            return false;
+        }
+        return m_engine->Embed(texts, embeddings) && embeddings.size() == texts.size();
+    }
+
+    int GetEmbeddingDimension() const {
+        return IsReady() ? m_engine->GetEmbeddingDimension() : 0;
+    }
+
+    std::string GetEmbeddingModelTag() const {
+        int dimension = GetEmbeddingDimension();
+        if (dimension <= 0) {
+            return "";
+        }
+        AIModelInfo info = m_engine->GetModelInfo();
+        return info.name + ":" + std::to_string(info.size_mb) + ":" + std::to_string(dimension) + ":mean";
+    }
+
     bool IsProductiveActivity(const ContentAnalysis& analysis) const {
         // Multiple criteria for productivity assessment
         bool is_productive_type = ai_utils::IsProductiveContentType(analysis.content_type);
@@ -271,6 +292,17 @@ public:
         }
     }
 
+    void SetThreadCount(int threads) {
+        if (!m_engine) {
+            return;
+        }
+        AIPromptConfig config = m_engine->GetConfig();
+        if (config.threads != threads) {
+            config.threads = threads;
+            m_engine->UpdateConfig(config);
+        }
+    }
+
     void EnableLearning(bool enable) {
         m_learning_enabled = enable;
         // Future: implement user feedback learning
@@ -392,6 +424,19 @@ std::future<ContentAnalysis> AIContentAnalyzer::AnalyzeWindowAsync(const OCRDocu
     return m_impl->AnalyzeWindowAsync(ocr_result, window_title, app_name);
 }
 
+bool AIContentAnalyzer::Embed(const std::vector<std::string>& texts,
+                              std::vector<std::vector<float>>& embeddings) {
+    return m_impl->Embed(texts, embeddings);
+}
+
+int AIContentAnalyzer::GetEmbeddingDimension() const {
+    return m_impl->GetEmbeddingDimension();
+}
+
+std::string AIContentAnalyzer::GetEmbeddingModelTag() const {
+    return m_impl->GetEmbeddingModelTag();
+}
+
 bool AIContentAnalyzer::IsProductiveActivity(const ContentAnalysis& analysis) const {
     return m_impl->IsProductiveActivity(analysis);
 }
@@ -416,6 +461,10 @@ void AIContentAnalyzer::UpdatePrompts(const AIPromptConfig& config) {
     m_impl->UpdatePrompts(config);
 }
 
+void AIContentAnalyzer::SetThreadCount(int threads) {
+    m_impl->SetThreadCount(threads);
+}
+
 void AIContentAnalyzer::EnableLearning(bool enable) {
     m_impl->EnableLearning(enable);
 }
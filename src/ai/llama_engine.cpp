@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 #if LLAMA_CPP_AVAILABLE
     // Real llama.cpp implementation
@@ -81,7 +82,9 @@ public:
         , m_total_processed(0)
         , m_total_processing_time(0.0)
         , m_model(nullptr)
-        , m_context(nullptr) {
+        , m_context(nullptr)
+        , m_embedding_context(nullptr)
+        , m_requested_threads(0) {
     }
 
     ~LlamaCppEngine() override {
@@ -111,8 +114,10 @@ public:
             m_context_params.n_ctx = config.context_length;
             m_context_params.n_batch = 512;
             m_context_params.n_ubatch = 512;
-            m_context_params.n_threads = std::thread::hardware_concurrency();
-            m_context_params.n_threads_batch = std::thread::hardware_concurrency();
+            int threads = ResolveThreadCount(config.threads);
+            m_context_params.n_threads = threads;
+            m_context_params.n_threads_batch = threads;
+            m_requested_threads = threads;
 
             std::cout << "LLaMA.cpp Engine initialized successfully" << std::endl;
             m_initialized = true;
@@ -204,7 +209,11 @@ public:
             return;
         }
 
-        // Free context
+        // Free contexts
+        if (m_embedding_context) {
+            llama_free(m_embedding_context);
+            m_embedding_context = nullptr;
+        }
         if (m_context) {
             llama_free(m_context);
             m_context = nullptr;
@@ -289,6 +298,8 @@ public:
 
     void UpdateConfig(const AIPromptConfig& config) override {
         m_config = config;
+        // Applied by the next inference so callers never wait on a running one
+        m_requested_threads = ResolveThreadCount(config.threads);
     }
 
     AIPromptConfig GetConfig() const override {
@@ -306,6 +317,75 @@ public:
         return m_total_processed;
     }
 
+    bool Embed(const std::vector<std::string>& texts,
+               std::vector<std::vector<float>>& embeddings) override {
+        embeddings.clear();
+        if (!m_model) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_inference_mutex);
+        if (!m_embedding_context && !CreateEmbeddingContext()) {
+            return false;
+        }
+
+        const int n_embd = llama_n_embd(m_model);
+        llama_batch batch = llama_batch_init(EMBED_BATCH_TOKENS, 0, EMBED_MAX_SEQUENCES);
+        bool success = true;
+        size_t next = 0;
+
+        // Pack as many texts as fit into each decode, one sequence per text
+        while (success && next < texts.size()) {
+            batch.n_tokens = 0;
+            int sequences = 0;
+            while (next < texts.size() && sequences < EMBED_MAX_SEQUENCES) {
+                std::vector<llama_token> tokens = Tokenize(texts[next], true);
+                if (tokens.size() > static_cast<size_t>(EMBED_MAX_TOKENS)) {
+                    tokens.resize(EMBED_MAX_TOKENS);
+                }
+                if (batch.n_tokens + static_cast<int>(tokens.size()) > EMBED_BATCH_TOKENS) {
+                    break;
+                }
+                for (size_t i = 0; i < tokens.size(); ++i) {
+                    const int n = batch.n_tokens++;
+                    batch.token[n] = tokens[i];
+                    batch.pos[n] = static_cast<llama_pos>(i);
+                    batch.n_seq_id[n] = 1;
+                    batch.seq_id[n][0] = sequences;
+                    batch.logits[n] = true;
+                }
+                ++sequences;
+                ++next;
+            }
+
+            llama_kv_cache_clear(m_embedding_context);
+            if (llama_decode(m_embedding_context, batch) != 0) {
+                std::cerr << "Failed to compute embeddings" << std::endl;
+                success = false;
+                break;
+            }
+
+            for (int seq = 0; seq < sequences; ++seq) {
+                const float* embedding = llama_get_embeddings_seq(m_embedding_context, seq);
+                if (!embedding) {
+                    success = false;
+                    break;
+                }
+                embeddings.emplace_back(embedding, embedding + n_embd);
+            }
+        }
+
+        llama_batch_free(batch);
+        if (!success) {
+            embeddings.clear();
+        }
+        return success;
+    }
+
+    int GetEmbeddingDimension() const override {
+        return m_model ? llama_n_embd(m_model) : 0;
+    }
+
     std::string GetEngineInfo() const override {
         if (m_model_loaded) {
             return "LLaMA.cpp Engine v1.0 (" + m_model_info.name + ")";
@@ -422,6 +502,7 @@ private:
     // Real llama.cpp objects
     llama_model* m_model;
     llama_context* m_context;
+    llama_context* m_embedding_context;   // Created on first Embed()
     llama_model_params m_model_params;
     llama_context_params m_context_params;
 
@@ -436,6 +517,45 @@ private:
 
     // Thread safety
     std::mutex m_inference_mutex;
+    std::atomic<int> m_requested_threads;
+
+    static int ResolveThreadCount(int threads) {
+        return threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Called with m_inference_mutex held
+    void ApplyThreadCount() {
+        int threads = m_requested_threads;
+        if (m_context && threads != static_cast<int>(m_context_params.n_threads)) {
+            llama_set_n_threads(m_context, threads, threads);
+            m_context_params.n_threads = threads;
+            m_context_params.n_threads_batch = threads;
+        }
+    }
+
+    // Embedding decode limits: every text of a decode shares one ubatch
+    static constexpr int EMBED_BATCH_TOKENS = 2048;
+    static constexpr int EMBED_MAX_TOKENS = 512;       // Longer texts are truncated
+    static constexpr int EMBED_MAX_SEQUENCES = 16;
+
+    // Second context on the loaded model that returns mean-pooled
+    // embeddings instead of logits. Called with m_inference_mutex held.
+    bool CreateEmbeddingContext() {
+        llama_context_params params = m_context_params;
+        params.embeddings = true;
+        params.pooling_type = LLAMA_POOLING_TYPE_MEAN;
+        params.n_ctx = EMBED_BATCH_TOKENS;
+        params.n_batch = EMBED_BATCH_TOKENS;
+        params.n_ubatch = EMBED_BATCH_TOKENS;
+        params.n_seq_max = EMBED_MAX_SEQUENCES;
+
+        m_embedding_context = llama_new_context_with_model(m_model, params);
+        if (!m_embedding_context) {
+            std::cerr << "Failed to create embedding context" << std::endl;
+            return false;
+        }
+        return true;
+    }
 
     // Helper methods
     std::string ExtractModelName(const std::string& path) {
@@ -495,6 +615,7 @@ private:
         }
 
         std::lock_guard<std::mutex> lock(m_inference_mutex);
+        ApplyThreadCount();
 
         try {
             // Tokenize the prompt
@@ -1,17 +1,76 @@
 #include "application.h"
 #include "event_manager.h"
 #include "directory_manager.h"
+#include "performance_monitor.h"
+#include "config_manager.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <csignal>
 #include <iomanip>
 #include <unordered_map>
+#include <algorithm>
 
 namespace work_assistant {
 
+namespace {
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Releases a slot taken before a detached OCR/AI worker was spawned, so
+// Shutdown() can drain them. Counting before the spawn avoids a window where
+// the drain sees zero while a worker is about to start.
+class InFlightRelease {
+public:
+    explicit InFlightRelease(std::atomic<int>& counter) : m_counter(counter) {}
+    ~InFlightRelease() { m_counter--; }
+private:
+    std::atomic<int>& m_counter;
+};
+
+// Crop of view covering a full-resolution rect of its frame; view holds
+// pixels reduced by scale, so the rect is widened to whole reduced pixels
+FrameView ScaledSubView(const FrameView& view, int x, int y, int width, int height, int scale) {
+    int left = x / scale;
+    int top = y / scale;
+    int right = (x + width + scale - 1) / scale;
+    int bottom = (y + height + scale - 1) / scale;
+    return view.SubView(left - view.origin_x, top - view.origin_y, right - left, bottom - top);
+}
+
+} // namespace
+
 Application::Application() 
     : m_initialized(false)
+    , m_firstFrameSeen(false)
+    , m_ocrReady(false)
+    , m_aiReady(false)
+    , m_webServerReady(false)
+    , m_stopRequested(false)
+    , m_lastHeartbeatMs(0)
+    , m_inFlightTasks(0)
+    , m_ocrIntervalFrames(10)
+    , m_drainTimeout(std::chrono::seconds(10))
+    , m_webPort(8080)
+    , m_captureBackend(CaptureBackend::NATIVE)
+    , m_memoryTaskLimit(MAX_PIPELINE_TASKS)
+    , m_lastFrameBytes(0)
+    , m_multimodalUnloaded(false)
+    , m_cpuTaskLimit(MAX_PIPELINE_TASKS)
+    , m_baseCaptureFps(30)
+    , m_cpuScale(1.0)
+    , m_cpuYielding(false)
+    , m_aiThreads(0)
+    , m_deferredWork(std::make_unique<DeferredWorkQueue>())
+    , m_fingerprints(std::make_unique<FingerprintIndex>())
+    , m_ocrScheduler(std::make_unique<OCRScheduler>())
+    , m_semanticSearch(std::make_shared<SemanticSearch>())
+    , m_unembeddedRecords(0)
+    , m_aggregatorMode(false)
+    , m_monitorFrames()
     , m_framesProcessed(0)
     , m_ocrExtractions(0)
     , m_aiAnalyses(0)
@@ -28,54 +87,186 @@ bool Application::Initialize() {
     }
 
     std::cout << "Initializing Work Study Assistant..." << std::endl;
-    
-    // Initialize directory structure first
+    m_initStartTime = std::chrono::steady_clock::now();
+    m_firstFrameSeen = false;
+
+    // Independent subsystems are brought up in parallel; the pool is sized so
+    // every immediate stage can run at once even on small machines
+    size_t pool_size = std::max<size_t>(4, std::thread::hardware_concurrency());
+    m_startupPool = std::make_unique<WorkAssistant::ThreadPool>(pool_size);
+    m_startup = std::make_unique<StartupSequencer>();
+    RegisterStartupStages();
+
+    if (!m_startup->Run(*m_startupPool)) {
+        std::cerr << "Invalid startup dependency graph" << std::endl;
+        return false;
+    }
+
+    // Pressure-driven degradation; consumers are registered once the
+    // subsystems they adjust exist
+    if (MemoryGovernor::GetInstance().Start()) {
+        RegisterMemoryConsumers();
+    }
+    if (CpuGovernor::GetInstance().Start(m_cpuGovernorConfig)) {
+        RegisterCpuConsumers();
+    }
+
+    // Set up event handling
+    EventManager::GetInstance().Subscribe<WindowEvent>(
+        [this](const WindowEvent& event) {
+            OnWindowEvent(event);
+        }
+    );
+
+    auto init_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_initStartTime);
+    m_initialized = true;
+    std::cout << "Application initialized successfully in " << init_time.count() << "ms" << std::endl;
+    return true;
+}
+
+void Application::RegisterStartupStages() {
+    // Stage graph; Initialize() returns, and capture starts, once these are
+    // done:
+    //   directories -> storage
+    //   window_monitor, screen_capture (no dependencies)
+    // Deferred until the first frame has been delivered:
+    //   directories -> ocr -> ocr_secondary (multimodal engine)
+    //   directories -> ai (model load)
+    //   storage -> web_server
+    //   storage -> deferred_work -> maintenance (queued as idle-time jobs:
+    //   storage maintenance and semantic indexing)
+    //   storage -> replication (when a target is set)
+    // An aggregator captures nothing, so its directories -> storage ->
+    // web_server are all immediate.
+    if (m_aggregatorMode) {
+        m_startup->AddStage("directories", [this]() { return InitializeDirectories(); });
+        m_startup->AddStage("storage", [this]() { return InitializeStorage(); }, {"directories"});
+        m_startup->AddStage("web_server", [this]() { return InitializeWebServer(); }, {"storage"});
+        return;
+    }
+
+    m_startup->AddStage("directories", [this]() { return InitializeDirectories(); });
+    m_startup->AddStage("window_monitor", [this]() { return InitializeWindowMonitor(); });
+    m_startup->AddStage("screen_capture", [this]() { return InitializeScreenCapture(); });
+    m_startup->AddStage("storage", [this]() { return InitializeStorage(); }, {"directories"});
+
+    m_startup->AddStage("ocr", [this]() { return InitializeOCR(); }, {"directories"}, true);
+    m_startup->AddStage("ai", [this]() { return InitializeAI(); }, {"directories"}, true);
+    m_startup->AddStage("web_server", [this]() { return InitializeWebServer(); }, {"storage"}, true);
+    m_startup->AddStage("ocr_secondary", [this]() { return LoadDeferredOCREngines(); }, {"ocr"}, true);
+    m_startup->AddStage("deferred_work", [this]() { return StartDeferredWork(); }, {"storage"}, true);
+    m_startup->AddStage("maintenance", [this]() { return RunStartupMaintenance(); }, {"deferred_work"}, true);
+    if (m_replication) {
+        m_startup->AddStage("replication", [this]() { return StartReplication(); }, {"storage"}, true);
+    }
+}
+
+bool Application::InitializeDirectories() {
     if (!DirectoryManager::InitializeDirectories()) {
         std::cerr << "Failed to initialize directory structure" << std::endl;
         // Don't fail completely, but warn user
     } else {
         std::cout << "Directory structure initialized successfully" << std::endl;
     }
+    return true;
+}
 
-    // Initialize window monitor
-    m_windowMonitor = WindowMonitorFactory::Create();
+bool Application::InitializeWindowMonitor() {
+    m_windowMonitor = m_captureReplay ? m_captureReplay->CreateWindowMonitor() : WindowMonitorFactory::Create();
     if (!m_windowMonitor) {
         std::cerr << "Failed to create window monitor" << std::endl;
         // Don't fail completely - continue without window monitoring
+        return false;
     } else if (!m_windowMonitor->Initialize()) {
         std::cerr << "Failed to initialize window monitor" << std::endl;
         // Don't fail completely - continue without window monitoring
         m_windowMonitor.reset();
+        return false;
+    }
+    return true;
+}
+
+bool Application::InitializeScreenCapture() {
+    std::unique_ptr<IScreenCapture> backend;
+    if (m_captureReplay) {
+        backend = m_captureReplay->CreateScreenCapture();
+    } else {
+        backend = ScreenCaptureFactory::Create(m_captureBackend);
+    }
+    if (m_captureRecorder) {
+        backend = CaptureRecorder::WrapBackend(std::move(backend), m_captureRecorder);
     }
 
-    // Initialize screen capture
     m_screenCapture = std::make_unique<ScreenCaptureManager>();
-    if (!m_screenCapture->Initialize()) {
+    if (!m_screenCapture->Initialize(std::move(backend))) {
         std::cerr << "Failed to initialize screen capture" << std::endl;
         // Don't fail completely if screen capture fails
         m_screenCapture.reset();
+        return false;
     }
+    // Local downscaling still reads every pixel, so reduced detection
+    // frames only pay off when the display server does the scaling
+    if (m_screenCapture->SupportsServerSideScaling()) {
+        m_screenCapture->SetDetectionScale(DETECTION_SCALE);
+    }
+    return true;
+}
 
-    // Initialize OCR manager
-    m_ocrManager = std::make_unique<OCRManager>();
-    if (!m_ocrManager->Initialize(OCREngineFactory::EngineType::AUTO_SELECT)) {
+bool Application::InitializeOCR() {
+    auto ocr = std::make_unique<OCRManager>();
+    // The multimodal fallback engine is loaded by the next stage
+    ocr->DeferSecondaryEngine(true);
+    if (!ocr->Initialize(OCREngineFactory::EngineType::AUTO_SELECT)) {
         std::cerr << "Failed to initialize OCR manager" << std::endl;
         // Don't fail completely if OCR fails
-        m_ocrManager.reset();
+        return false;
+    }
+
+    // Windows that expose their text through the accessibility tree skip
+    // pixel OCR; without it every region is recognised from pixels
+    m_textSource = TextSourceFactory::Create();
+    if (m_textSource && m_textSource->Initialize()) {
+        ocr->SetTextSource(m_textSource);
+    } else {
+        std::cout << "Accessibility text unavailable, using pixel OCR only" << std::endl;
+        m_textSource.reset();
     }
 
-    // Initialize AI content analyzer
-    m_aiAnalyzer = std::make_unique<AIContentAnalyzer>();
+    m_ocrManager = std::move(ocr);
+    m_ocrReady = true;
+    return true;
+}
+
+bool Application::LoadDeferredOCREngines() {
+    if (!m_ocrManager) {
+        return false;
+    }
+    if (!m_ocrManager->LoadDeferredEngines()) {
+        std::cerr << "Secondary OCR engine unavailable, continuing with primary only" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Application::InitializeAI() {
+    auto ai = std::make_unique<AIContentAnalyzer>();
     std::string model_path = DirectoryManager::JoinPath(DirectoryManager::GetModelsDirectory(), "qwen2.5-0.5b-instruct-q4_k_m.gguf");
-    if (!m_aiAnalyzer->Initialize(model_path, AIEngineFactory::EngineType::LLAMA_CPP)) {
+    if (!ai->Initialize(model_path, AIEngineFactory::EngineType::LLAMA_CPP)) {
         std::cerr << "Failed to initialize AI analyzer" << std::endl;
         // Don't fail completely if AI fails
-        m_aiAnalyzer.reset();
-    } else {
-        std::cout << "AI Content Analyzer ready for intelligent classification" << std::endl;
+        return false;
     }
+    // The CPU budget may have changed while the model was loading
+    ai->SetThreadCount(m_aiThreads);
+
+    m_aiAnalyzer = std::move(ai);
+    m_aiReady = true;
+    std::cout << "AI Content Analyzer ready for intelligent classification" << std::endl;
+    return true;
+}
 
-    // Initialize encrypted storage manager
+bool Application::InitializeStorage() {
     m_storageManager = std::make_shared<EncryptedStorageManager>();
     StorageConfig storage_config;
     storage_config.storage_path = DirectoryManager::GetDataDirectory();
@@ -87,40 +278,169 @@ bool Application::Initialize() {
         std::cerr << "Failed to initialize storage manager" << std::endl;
         // Don't fail completely if storage fails
         m_storageManager.reset();
-    } else {
-        std::cout << "Encrypted Storage Manager ready for secure data persistence" << std::endl;
-        m_storageManager->StartSession("main_session");
+        return false;
+    }
+    std::cout << "Encrypted Storage Manager ready for secure data persistence" << std::endl;
+    m_storageManager->StartSession("main_session");
+    
+    // Without the index every frame is simply processed from scratch
+    if (!m_fingerprints->Open(DirectoryManager::JoinPath(storage_config.storage_path, "screen_fingerprints.idx"))) {
+        std::cerr << "Screen fingerprint index unavailable" << std::endl;
     }
+    return true;
+}
 
-    // Initialize web server
-    m_webServer = std::make_unique<WebServer>();
+bool Application::InitializeWebServer() {
+    auto server = std::make_unique<WebServer>();
     WebServerConfig web_config;
-    web_config.host = "127.0.0.1";
-    web_config.port = 8080;
+    web_config.host = m_aggregatorMode ? "0.0.0.0" : "127.0.0.1";
+    web_config.port = m_webPort;
     web_config.static_files_path = DirectoryManager::JoinPath(DirectoryManager::GetDataDirectory(), "web/static");
     web_config.enable_cors = true;
     web_config.enable_websocket = true;
+    web_config.accept_replication = m_aggregatorMode;
+    web_config.replication_token = m_replicationToken;
     
-    if (!m_webServer->Initialize(web_config, m_storageManager)) {
+    if (!server->Initialize(web_config, m_storageManager)) {
         std::cerr << "Failed to initialize web server" << std::endl;
         // Don't fail completely if web server fails
-        m_webServer.reset();
-    } else {
-        std::cout << "Web Server ready at http://" << web_config.host << ":" << web_config.port << std::endl;
+        return false;
+    }
+    server->SetSemanticSearch(m_semanticSearch);
+    if (!server->Start()) {
+        std::cerr << "Failed to start web server" << std::endl;
+        return false;
     }
 
-    // Set up event handling
-    EventManager::GetInstance().Subscribe<WindowEvent>(
-        [this](const WindowEvent& event) {
-            OnWindowEvent(event);
-        }
-    );
+    m_webServer = std::move(server);
+    m_webServerReady = true;
+    std::cout << "Web Server running at http://" << web_config.host << ":" << web_config.port << std::endl;
+    return true;
+}
 
-    m_initialized = true;
-    std::cout << "Application initialized successfully" << std::endl;
+OCRManager* Application::ReadyOCR() const {
+    return m_ocrReady ? m_ocrManager.get() : nullptr;
+}
+
+AIContentAnalyzer* Application::ReadyAI() const {
+    return m_aiReady ? m_aiAnalyzer.get() : nullptr;
+}
+
+WebServer* Application::ReadyWebServer() const {
+    return m_webServerReady ? m_webServer.get() : nullptr;
+}
+
+bool Application::StartDeferredWork() {
+    if (!m_storageManager) {
+        return false;
+    }
+
+    // Window monitor is an immediate stage, so it is settled by now
+    m_deferredWork->SetIdleTimeSource([this]() {
+        return m_windowMonitor ? m_windowMonitor->GetIdleTime() : std::chrono::milliseconds(-1);
+    });
+    m_deferredWork->RegisterHandler("storage.maintenance", [this](DeferredJobRecord& job) {
+        return RunStorageMaintenanceChunk(job);
+    });
+    m_deferredWork->RegisterHandler("semantic.embed", [this](DeferredJobRecord& job) {
+        return RunSemanticEmbeddingChunk(job);
+    });
+    return m_deferredWork->Start(m_storageManager);
+}
+
+bool Application::StartReplication() {
+    if (!m_storageManager || !m_replication->Initialize(m_replicationConfig, m_storageManager)) {
+        std::cerr << "Replication disabled" << std::endl;
+        return false;
+    }
+    return m_replication->Start();
+}
+
+bool Application::RunStartupMaintenance() {
+    if (!m_storageManager || !m_deferredWork->IsRunning()) {
+        return false;
+    }
+
+    // Cleanup, integrity check and VACUUM can take seconds on a large
+    // database; run them when the user is away instead of at startup
+    m_deferredWork->Enqueue("storage.maintenance");
+    // Catch up on screens stored while the model was unavailable
+    m_deferredWork->Enqueue("semantic.embed");
     return true;
 }
 
+DeferredJobResult Application::RunStorageMaintenanceChunk(DeferredJobRecord& job) {
+    if (!m_storageManager) {
+        return DeferredJobResult::FAILED;
+    }
+
+    // One step per chunk so user activity can preempt between them
+    if (job.cursor.empty()) {
+        StorageConfig config = m_storageManager->GetConfig();
+        if (config.auto_cleanup && !m_storageManager->CleanupOldData(config.data_retention_hours)) {
+            return DeferredJobResult::FAILED;
+        }
+        job.cursor = "verify";
+        return DeferredJobResult::MORE;
+    }
+    if (job.cursor == "verify") {
+        if (!m_storageManager->VerifyIntegrity()) {
+            std::cerr << "Storage integrity check failed during maintenance" << std::endl;
+        }
+        job.cursor = "compact";
+        return DeferredJobResult::MORE;
+    }
+    if (job.cursor == "compact") {
+        return m_storageManager->CompactDatabase() ? DeferredJobResult::DONE : DeferredJobResult::FAILED;
+    }
+
+    std::cerr << "Unknown storage maintenance step: " << job.cursor << std::endl;
+    return DeferredJobResult::DONE;
+}
+
+DeferredJobResult Application::RunSemanticEmbeddingChunk(DeferredJobRecord& job) {
+    (void)job;   // Progress is kept in the index itself
+    if (!m_storageManager) {
+        return DeferredJobResult::FAILED;
+    }
+
+    // The index needs the model's embedding dimension, so it opens here
+    // rather than at startup; without embeddings there is nothing to do
+    if (!m_semanticSearch->IsReady()) {
+        AIContentAnalyzer* ai = ReadyAI();
+        if (!ai || !m_semanticSearch->Open(
+                DirectoryManager::JoinPath(DirectoryManager::GetDataDirectory(), "semantic_index.vdb"),
+                m_storageManager, ai)) {
+            return DeferredJobResult::DONE;
+        }
+    }
+
+    m_unembeddedRecords = 0;
+    DeferredJobResult result = m_semanticSearch->RunEmbeddingStep();
+    if (result == DeferredJobResult::DONE) {
+        m_semanticSearch->Flush();
+    }
+    return result;
+}
+
+void Application::OnFirstFrame() {
+    auto time_to_first_capture = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_initStartTime);
+    PerformanceMonitor::GetInstance().RecordTiming("startup.time_to_first_capture", time_to_first_capture);
+
+    double ms = time_to_first_capture.count() / 1000.0;
+    std::cout << "First frame captured " << std::fixed << std::setprecision(1) << ms << "ms after startup";
+    if (ms > TARGET_FIRST_CAPTURE_MS) {
+        std::cout << " (target " << TARGET_FIRST_CAPTURE_MS << "ms)";
+    }
+    std::cout << std::endl;
+
+    if (m_startup && m_startupPool) {
+        m_startup->PrintReport();
+        m_startup->RunDeferred(*m_startupPool);
+    }
+}
+
 void Application::Run() {
     if (!m_initialized) {
         std::cerr << "Application not initialized" << std::endl;
@@ -130,11 +450,21 @@ void Application::Run() {
     std::cout << "Starting application..." << std::endl;
 
     // Start window monitoring
-    if (!m_windowMonitor->StartMonitoring()) {
+    if (m_windowMonitor && !m_windowMonitor->StartMonitoring()) {
         std::cerr << "Failed to start window monitoring" << std::endl;
         return;
     }
 
+    // A recording starts from the window focused at the time, which no
+    // event would otherwise report
+    if (m_captureRecorder && m_windowMonitor) {
+        WindowEvent focused;
+        focused.type = WindowEventType::WINDOW_FOCUSED;
+        focused.timestamp = std::chrono::system_clock::now();
+        focused.window_info = m_windowMonitor->GetActiveWindow();
+        m_captureRecorder->RecordWindowEvent(focused);
+    }
+
     // Start screen capture if available
     if (m_screenCapture) {
         auto callback = [this](const CaptureFrame& frame) {
@@ -143,29 +473,292 @@ void Application::Run() {
         
         if (!m_screenCapture->StartMonitoring(callback)) {
             std::cerr << "Failed to start screen capture monitoring" << std::endl;
+            m_startup->RunDeferred(*m_startupPool);
         } else {
             std::cout << "Screen capture monitoring started" << std::endl;
         }
+    } else {
+        // No frames will ever arrive, so don't hold deferred stages back
+        m_startup->RunDeferred(*m_startupPool);
     }
 
-    // Start web server if available
-    if (m_webServer) {
-        if (!m_webServer->Start()) {
-            std::cerr << "Failed to start web server" << std::endl;
-        } else {
-            std::cout << "Web server started successfully" << std::endl;
+    std::cout << "Application running. Press Ctrl+C to exit..." << std::endl;
+
+    // Main application loop; the heartbeat feeds the service watchdog
+    m_lastHeartbeatMs = SteadyNowMs();
+    while (!m_stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        m_lastHeartbeatMs = SteadyNowMs();
+    }
+
+    std::cout << "Application main loop stopped" << std::endl;
+}
+
+void Application::RequestStop() {
+    m_stopRequested = true;
+}
+
+bool Application::IsStopRequested() const {
+    return m_stopRequested;
+}
+
+bool Application::IsHealthy() const {
+    if (!m_initialized || m_stopRequested) {
+        return false;
+    }
+
+    // A stalled main loop means the process is wedged even if threads exist
+    int64_t last = m_lastHeartbeatMs;
+    if (last == 0 || SteadyNowMs() - last > HEARTBEAT_TIMEOUT_MS) {
+        return false;
+    }
+
+    // The capture thread exits on its own only if something went wrong
+    if (m_screenCapture && m_firstFrameSeen && !m_screenCapture->IsMonitoring()) {
+        return false;
+    }
+    return true;
+}
+
+bool Application::ReloadConfiguration(const ConfigManager& config) {
+    std::cout << "Reloading configuration..." << std::endl;
+
+    int interval_frames = config.GetInt(DefaultConfig::MONITOR_SECTION,
+                                        DefaultConfig::MONITOR_OCR_INTERVAL_FRAMES, 10);
+    m_ocrIntervalFrames = static_cast<size_t>(std::max(1, interval_frames));
+
+    if (m_screenCapture) {
+        int interval_ms = config.GetInt(DefaultConfig::MONITOR_SECTION,
+                                        DefaultConfig::MONITOR_CAPTURE_INTERVAL_MS, 1000);
+        if (interval_ms > 0) {
+            m_baseCaptureFps = std::max(1, 1000 / interval_ms);
+            ApplyCaptureRate();
         }
     }
 
-    std::cout << "Application running. Press Ctrl+C to exit..." << std::endl;
+    ApplyPerformanceConfig(config);
+    ApplyOCRConfig(config);
 
-    // Main application loop
-    while (true) {
-        // Process events
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        
-        // Check for shutdown conditions
-        // For now, run indefinitely until signal
+    if (OCRManager* ocr = ReadyOCR()) {
+        ocr->SetLanguage(config.GetString(DefaultConfig::OCR_SECTION,
+                                          DefaultConfig::OCR_LANGUAGE, "eng"));
+        ocr->SetConfidenceThreshold(static_cast<float>(
+            config.GetDouble(DefaultConfig::OCR_SECTION, DefaultConfig::OCR_CONFIDENCE_THRESHOLD, 0.6)));
+    }
+
+    std::cout << "Configuration reloaded (OCR every " << m_ocrIntervalFrames << " frames)" << std::endl;
+    return true;
+}
+
+void Application::ApplyPerformanceConfig(const ConfigManager& config) {
+    double target = config.GetDouble(DefaultConfig::PERFORMANCE_SECTION,
+                                     DefaultConfig::PERF_CPU_TARGET_PERCENT, 25.0);
+    bool yield = config.GetBool(DefaultConfig::PERFORMANCE_SECTION,
+                                DefaultConfig::PERF_YIELD_TO_FOREGROUND, true);
+
+    auto& cpu_governor = CpuGovernor::GetInstance();
+    if (cpu_governor.SetTargetShare(target)) {
+        m_cpuGovernorConfig.target_share = target;
+    }
+    cpu_governor.SetYieldToForeground(yield);
+    m_cpuGovernorConfig.yield_to_foreground = yield;
+}
+
+void Application::ApplyOCRConfig(const ConfigManager& config) {
+    std::unordered_map<std::string, double> weights;
+    for (const auto& processName : config.GetSectionKeys(DefaultConfig::OCR_APP_IMPORTANCE_SECTION)) {
+        weights[processName] = config.GetDouble(DefaultConfig::OCR_APP_IMPORTANCE_SECTION, processName, 1.0);
+    }
+    m_ocrScheduler->SetApplicationImportance(weights);
+}
+
+void Application::SetDrainTimeout(std::chrono::milliseconds timeout) {
+    m_drainTimeout = timeout;
+}
+
+void Application::SetWebPort(int port) {
+    m_webPort = port;
+}
+
+void Application::SetCaptureBackend(CaptureBackend backend) {
+    m_captureBackend = backend;
+}
+
+bool Application::SetAggregatorMode(bool enabled, const std::string& token) {
+    // The delta endpoint writes to storage, so it is never left open
+    if (enabled && token.empty()) {
+        std::cerr << "Aggregator mode requires a replication token" << std::endl;
+        return false;
+    }
+    m_aggregatorMode = enabled;
+    m_replicationToken = enabled ? token : std::string();
+    return true;
+}
+
+bool Application::SetReplication(const ReplicationConfig& config) {
+    if (!config.IsValid()) {
+        std::cerr << "Invalid replication target (an aggregator URL and token are required)" << std::endl;
+        return false;
+    }
+    m_replicationConfig = config;
+    m_replication = std::make_unique<ReplicationClient>();
+    return true;
+}
+
+bool Application::SetCaptureRecording(const std::string& path) {
+    auto recorder = std::make_shared<CaptureRecorder>();
+    if (!recorder->Open(path)) {
+        return false;
+    }
+    m_captureRecorder = recorder;
+    return true;
+}
+
+bool Application::SetCaptureReplay(const std::string& path, const CaptureReplayOptions& options) {
+    auto replay = std::make_shared<CaptureReplay>();
+    if (!replay->Open(path, options)) {
+        return false;
+    }
+    // Shutdown() drains the work the last frames started
+    replay->SetFinishedCallback([this]() { RequestStop(); });
+    m_captureReplay = replay;
+    return true;
+}
+
+void Application::RegisterMemoryConsumers() {
+    auto& governor = MemoryGovernor::GetInstance();
+
+    MemoryConsumer samples;
+    samples.name = "performance_samples";
+    samples.get_usage_bytes = []() { return PerformanceMonitor::GetInstance().GetMemoryFootprint(); };
+    samples.on_level_changed = [](MemoryPressureLevel level) {
+        size_t limit = level == MemoryPressureLevel::NORMAL ? 1000
+                     : level == MemoryPressureLevel::MODERATE ? 200 : 50;
+        PerformanceMonitor::GetInstance().SetMaxSamples(limit);
+    };
+    m_memoryConsumers.push_back(governor.RegisterConsumer(samples));
+
+    // Each in-flight OCR task holds a full frame copy
+    MemoryConsumer pipeline;
+    pipeline.name = "pipeline_frames";
+    pipeline.get_usage_bytes = [this]() {
+        return static_cast<size_t>(std::max(0, m_inFlightTasks.load())) * m_lastFrameBytes.load();
+    };
+    pipeline.on_level_changed = [this](MemoryPressureLevel level) {
+        m_memoryTaskLimit = level == MemoryPressureLevel::NORMAL ? MAX_PIPELINE_TASKS
+                          : level == MemoryPressureLevel::MODERATE ? 2 : 1;
+    };
+    m_memoryConsumers.push_back(governor.RegisterConsumer(pipeline));
+
+    if (m_screenCapture) {
+        MemoryConsumer capture;
+        capture.name = "capture_resolution";
+        capture.get_usage_bytes = [this]() { return m_lastFrameBytes.load(); };
+        capture.on_level_changed = [this](MemoryPressureLevel level) {
+            if (m_screenCapture) {
+                m_screenCapture->SetDownscaleFactor(level == MemoryPressureLevel::NORMAL ? 1 : 2);
+            }
+        };
+        m_memoryConsumers.push_back(governor.RegisterConsumer(capture));
+    }
+
+    // OCR starts after the first frame; until then there is nothing to unload
+    if (!m_aggregatorMode) {
+        MemoryConsumer multimodal;
+        multimodal.name = "multimodal_model";
+        multimodal.on_level_changed = [this](MemoryPressureLevel level) {
+            OCRManager* ocr = ReadyOCR();
+            if (!ocr) {
+                return;
+            }
+            if (level == MemoryPressureLevel::CRITICAL) {
+                if (ocr->UnloadMultimodalModel()) {
+                    m_multimodalUnloaded = true;
+                }
+            } else if (level == MemoryPressureLevel::NORMAL && m_multimodalUnloaded.exchange(false)) {
+                ocr->ReloadMultimodalModel();
+            }
+        };
+        m_memoryConsumers.push_back(governor.RegisterConsumer(multimodal));
+    }
+}
+
+void Application::UnregisterMemoryConsumers() {
+    auto& governor = MemoryGovernor::GetInstance();
+    for (int handle : m_memoryConsumers) {
+        governor.UnregisterConsumer(handle);
+    }
+    m_memoryConsumers.clear();
+}
+
+void Application::RegisterCpuConsumers() {
+    auto& governor = CpuGovernor::GetInstance();
+
+    if (m_screenCapture) {
+        CpuConsumer capture;
+        capture.name = "capture_rate";
+        capture.on_budget_changed = [this](const CpuBudget& budget) {
+            m_cpuScale = budget.scale;
+            m_cpuYielding = budget.mode == CpuBudgetMode::YIELDING;
+            ApplyCaptureRate();
+        };
+        m_cpuConsumers.push_back(governor.RegisterConsumer(capture));
+    }
+
+    CpuConsumer pipeline;
+    pipeline.name = "ocr_concurrency";
+    pipeline.on_budget_changed = [this](const CpuBudget& budget) {
+        m_cpuTaskLimit = budget.mode == CpuBudgetMode::YIELDING ? 0
+                       : std::max(1, static_cast<int>(MAX_PIPELINE_TASKS * budget.scale));
+    };
+    m_cpuConsumers.push_back(governor.RegisterConsumer(pipeline));
+
+    // The model loads after the first frame and picks up m_aiThreads then
+    if (!m_aggregatorMode) {
+        CpuConsumer inference;
+        inference.name = "llm_threads";
+        inference.on_budget_changed = [this](const CpuBudget& budget) {
+            // Back to the engine default (all hardware threads) at full budget
+            int hardware = std::max(1u, std::thread::hardware_concurrency());
+            int threads = budget.mode == CpuBudgetMode::YIELDING ? 1
+                        : budget.scale >= 1.0 ? 0
+                        : std::max(1, static_cast<int>(hardware * budget.scale));
+            m_aiThreads = threads;
+            if (AIContentAnalyzer* ai = ReadyAI()) {
+                ai->SetThreadCount(threads);
+            }
+        };
+        m_cpuConsumers.push_back(governor.RegisterConsumer(inference));
+    }
+}
+
+void Application::UnregisterCpuConsumers() {
+    auto& governor = CpuGovernor::GetInstance();
+    for (int handle : m_cpuConsumers) {
+        governor.UnregisterConsumer(handle);
+    }
+    m_cpuConsumers.clear();
+}
+
+void Application::ApplyCaptureRate() {
+    if (!m_screenCapture) {
+        return;
+    }
+    int fps = static_cast<int>(m_baseCaptureFps * m_cpuScale + 0.5);
+    m_screenCapture->SetMaxFPS(std::max(1, fps));
+    m_screenCapture->SetPaused(m_cpuYielding);
+}
+
+void Application::DrainPendingWork() {
+    auto deadline = std::chrono::steady_clock::now() + m_drainTimeout;
+    if (m_inFlightTasks > 0) {
+        std::cout << "Draining " << m_inFlightTasks << " in-flight pipeline tasks..." << std::endl;
+    }
+    while (m_inFlightTasks > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    if (m_inFlightTasks > 0) {
+        std::cerr << "Drain timed out with " << m_inFlightTasks << " tasks still running" << std::endl;
     }
 }
 
@@ -175,6 +768,24 @@ void Application::Shutdown() {
     }
 
     std::cout << "Shutting down application..." << std::endl;
+    m_stopRequested = true;
+
+    // Consumers capture this; stop callbacks before members go away
+    UnregisterMemoryConsumers();
+    MemoryGovernor::GetInstance().Stop();
+    UnregisterCpuConsumers();
+    CpuGovernor::GetInstance().Stop();
+
+    // Deferred stages touch the subsystems below; let them finish first
+    if (m_startup) {
+        m_startup->WaitForDeferred();
+    }
+
+    // Idle-time jobs use storage and the window monitor's idle time
+    m_deferredWork->Stop();
+    if (m_replication) {
+        m_replication->Stop();
+    }
 
     // Stop monitoring
     if (m_windowMonitor) {
@@ -189,28 +800,58 @@ void Application::Shutdown() {
         m_screenCapture.reset();
     }
 
+    if (m_captureRecorder) {
+        m_captureRecorder->Close();
+    }
+    if (m_captureReplay) {
+        auto stats = m_captureReplay->GetStatistics();
+        std::cout << "Capture replay: " << stats.frames_delivered << " frames delivered, "
+                  << stats.reads_served << " reads served, " << stats.reads_repeated << " repeated, "
+                  << stats.reads_missed << " missed" << std::endl;
+        m_captureReplay->Close();
+    }
+
+    // No new frames can arrive now; let queued OCR/AI work reach storage
+    DrainPendingWork();
+
+    m_ocrReady = false;
     if (m_ocrManager) {
         m_ocrManager->Shutdown();
         m_ocrManager.reset();
     }
 
+    if (m_textSource) {
+        m_textSource->Shutdown();
+        m_textSource.reset();
+    }
+
+    // Waits for in-flight searches, which use the analyzer
+    m_semanticSearch->Close();
+
+    m_aiReady = false;
     if (m_aiAnalyzer) {
         m_aiAnalyzer->Shutdown();
         m_aiAnalyzer.reset();
     }
 
+    m_webServerReady = false;
     if (m_webServer) {
         m_webServer->Stop();
         m_webServer->Shutdown();
         m_webServer.reset();
     }
 
+    m_fingerprints->Close();
+
     if (m_storageManager) {
         m_storageManager->EndSession();
         m_storageManager->Shutdown();
         m_storageManager.reset();
     }
 
+    m_startup.reset();
+    m_startupPool.reset();
+
     m_initialized = false;
     std::cout << "Application shut down" << std::endl;
 }
@@ -238,18 +879,33 @@ void Application::OnWindowEvent(const WindowEvent& event) {
     std::cout << " - " << event.window_info.title 
               << " (" << event.window_info.process_name << ")" << std::endl;
 
+    m_deferredWork->NotifyUserActivity();
+
+    if (m_captureRecorder) {
+        m_captureRecorder->RecordWindowEvent(event);
+    }
+
     // Store window event in encrypted storage
     if (m_storageManager) {
         m_storageManager->StoreWindowEvent(event, event.window_info);
     }
 
     // Send real-time update to web clients
-    if (m_webServer) {
-        m_webServer->OnWindowEvent(event, event.window_info);
+    if (WebServer* server = ReadyWebServer()) {
+        server->OnWindowEvent(event, event.window_info);
+    }
+
+    if (event.type == WindowEventType::WINDOW_FOCUSED) {
+        m_ocrScheduler->SetFocusedWindow(event.window_info);
     }
 
     // Trigger screen capture on focus change
     if (event.type == WindowEventType::WINDOW_FOCUSED && m_screenCapture) {
+        // The monitor under the window's centre gets OCR priority
+        const auto& info = event.window_info;
+        m_screenCapture->SetFocusedMonitor(
+            m_screenCapture->GetMonitorAt(info.x + info.width / 2, info.y + info.height / 2));
+
         CaptureFrame frame;
         if (m_screenCapture->CaptureWindow(event.window_info.window_handle, frame)) {
             std::cout << "Captured window: " << frame.width << "x" << frame.height << std::endl;
@@ -263,23 +919,32 @@ void Application::OnWindowEvent(const WindowEvent& event) {
 }
 
 void Application::OnScreenCaptureFrame(const CaptureFrame& frame) {
-    m_framesProcessed++;
+    if (!m_firstFrameSeen.exchange(true)) {
+        OnFirstFrame();
+    }
+
+    size_t frameCount = ++m_framesProcessed;
+    m_lastFrameBytes = frame.data.size();
+
+    // Every frame's damage counts towards the next OCR pass, not just the
+    // frames that trigger one
+    m_ocrScheduler->AddDamage(frame);
     
     // Log frame info periodically
-    if (m_framesProcessed % 30 == 0) { // Log every 30 frames
+    if (frameCount % 30 == 0) { // Log every 30 frames
         std::cout << "Screen capture frame: " << frame.width << "x" << frame.height 
                   << " (" << frame.data.size() << " bytes)" << std::endl;
         
-        if (m_ocrManager) {
-            auto stats = m_ocrManager->GetStatistics();
+        if (OCRManager* ocr = ReadyOCR()) {
+            auto stats = ocr->GetStatistics();
             std::cout << "OCR Stats: " << stats.successful_extractions 
                       << "/" << stats.total_processed << " successful, "
                       << "avg time: " << stats.average_processing_time_ms << "ms, "
                       << "avg confidence: " << stats.average_confidence << std::endl;
         }
         
-        if (m_aiAnalyzer) {
-            auto aiStats = m_aiAnalyzer->GetStatistics();
+        if (AIContentAnalyzer* ai = ReadyAI()) {
+            auto aiStats = ai->GetStatistics();
             std::cout << "AI Stats: " << aiStats.successful_classifications
                       << "/" << aiStats.total_analyzed << " classified, "
                       << "avg time: " << aiStats.average_processing_time_ms << "ms, "
@@ -295,25 +960,156 @@ void Application::OnScreenCaptureFrame(const CaptureFrame& frame) {
         }
     }
 
-    // Process frame with OCR (every 10th frame to reduce load)
-    if (m_framesProcessed % 10 == 0) {
+    // Process frame with OCR (every Nth frame to reduce load). Each monitor
+    // counts its own frames, so a busy monitor can't starve a quiet one.
+    size_t monitorCount = frameCount;
+    if (frame.monitor_id >= 0 && frame.monitor_id < MAX_TRACKED_MONITORS) {
+        monitorCount = ++m_monitorFrames[frame.monitor_id];
+    }
+    if (monitorCount % m_ocrIntervalFrames == 0) {
         ProcessFrameWithOCR(frame);
     }
 }
 
 void Application::ProcessFrameWithOCR(const CaptureFrame& frame) {
-    if (!m_ocrManager) {
+    // Until the OCR stage is done, damage keeps accumulating in the scheduler
+    if (!ReadyOCR()) {
         return;
     }
 
-    // Process OCR asynchronously to avoid blocking
-    auto future = m_ocrManager->ExtractTextAsync(frame);
-    
-    // In a real application, you would store this future and process results later
-    // For demonstration, we'll just log when text is found
-    std::thread([this, future = std::move(future)]() mutable {
+    // Backpressure: each pending task pins a frame copy and a share of the
+    // CPU, so the limit is tightened by both governors
+    int limit = std::min(m_memoryTaskLimit.load(), m_cpuTaskLimit.load());
+    if (limit == 0) {
+        PerformanceMonitor::GetInstance().IncrementCounter("pipeline.ocr_skipped_cpu_yield");
+        return;
+    }
+    // Frames from monitors other than the focused one leave a slot free,
+    // so the monitor the user is working on never waits behind them
+    int focused = m_screenCapture ? m_screenCapture->GetFocusedMonitor() : -1;
+    bool secondary = frame.monitor_id >= 0 && focused >= 0 && frame.monitor_id != focused;
+    if (secondary && limit > 1) {
+        limit--;
+    }
+    // Claim the slot up front: frames arrive from one capture worker per
+    // monitor, and a separate check and increment would let them overshoot
+    int inFlight = m_inFlightTasks.load();
+    do {
+        if (inFlight >= limit) {
+            PerformanceMonitor::GetInstance().IncrementCounter(
+                secondary ? "pipeline.ocr_skipped_secondary_monitor" : "pipeline.ocr_skipped_backpressure");
+            return;
+        }
+    } while (!m_inFlightTasks.compare_exchange_weak(inFlight, inFlight + 1));
+    auto slot = std::make_unique<InFlightRelease>(m_inFlightTasks);
+
+    // dHash is resolution-independent, so the detection frame is enough
+    // to recognise a screen processed before
+    uint64_t frameHash = capture_utils::CalculateHash(frame);
+    if (ReuseKnownScreen(frameHash)) {
+        return;
+    }
+
+    // Detection frames are reduced; the full-resolution read happens only
+    // here, once OCR is actually going to run. The re-read frame is handed
+    // over as shared so the async path doesn't copy it again.
+    FrameView ocrFrame(frame);
+    bool fullResolution = frame.scale_factor <= 1;
+    if (frame.scale_factor > 1 && m_screenCapture) {
+        auto fullFrame = std::make_shared<CaptureFrame>();
+        if (m_screenCapture->CaptureFullResolution(frame, *fullFrame)) {
+            m_lastFrameBytes = fullFrame->data.size();
+            ocrFrame = FrameView::Shared(std::move(fullFrame));
+            fullResolution = true;
+        }
+    }
+
+    // Only the highest-ranked damaged regions that fit the time budget
+    // are recognised; the rest wait for a later pass
+    int screenX = 0, screenY = 0;
+    if (m_screenCapture && ocrFrame.monitor_id >= 0) {
+        for (const auto& monitor : m_screenCapture->GetMonitors()) {
+            if (monitor.id == ocrFrame.monitor_id) {
+                screenX = monitor.x;
+                screenY = monitor.y;
+                break;
+            }
+        }
+    }
+    int caretX = -1, caretY = -1;
+    if (m_textSource) {
+        m_textSource->GetCaretPosition(caretX, caretY);
+    }
+    m_ocrScheduler->SetCaretPosition(caretX, caretY);
+    // Damage is tracked in full-resolution pixels; if the re-read failed,
+    // plan over the full-resolution size and crop the reduced frame at
+    // the regions divided by its scale
+    const int regionScale = fullResolution ? 1 : std::max(1, frame.scale_factor);
+    OCRSchedule schedule = m_ocrScheduler->Plan(ocrFrame.monitor_id, ocrFrame.width * regionScale,
+                                                ocrFrame.height * regionScale, screenX, screenY);
+    auto& perf = PerformanceMonitor::GetInstance();
+    perf.RecordCounter("ocr.frame_budget_ms", static_cast<int64_t>(schedule.budget.count()));
+    perf.RecordCounter("ocr.regions_skipped_per_frame", static_cast<int64_t>(schedule.deferred + schedule.dropped));
+    perf.IncrementCounter("ocr.regions_deferred", static_cast<int64_t>(schedule.deferred));
+    perf.IncrementCounter("ocr.regions_dropped", static_cast<int64_t>(schedule.dropped));
+    if (schedule.regions.empty()) {
+        return;
+    }
+
+    // The worker keeps just the scheduled area alive; a frame that is
+    // already shared is kept as is
+    int left = ocrFrame.width * regionScale, top = ocrFrame.height * regionScale, right = 0, bottom = 0;
+    for (const auto& region : schedule.regions) {
+        left = std::min(left, region.x);
+        top = std::min(top, region.y);
+        right = std::max(right, region.x + region.width);
+        bottom = std::max(bottom, region.y + region.height);
+    }
+    FrameView workFrame = ocrFrame.owner ? ocrFrame :
+        ScaledSubView(ocrFrame, left, top, right - left, bottom - top, regionScale).Retain();
+
+    // Process OCR asynchronously to avoid blocking; the worker releases
+    // the slot claimed above
+    std::thread([this, frameHash, workFrame, fullResolution, regionScale, screenX, screenY,
+                 schedule = std::move(schedule), slot = std::move(slot)]() {
         try {
-            OCRDocument document = future.get();
+            auto& perf = PerformanceMonitor::GetInstance();
+            auto start = std::chrono::steady_clock::now();
+            OCRDocument document;
+            document.timestamp = std::chrono::system_clock::now();
+            size_t processed = 0;
+            for (; processed < schedule.regions.size(); ++processed) {
+                // Estimates can be off; a pass that has used up its budget
+                // leaves the rest for the next one
+                if (processed > 0 && std::chrono::steady_clock::now() - start >= schedule.budget) {
+                    break;
+                }
+                const OCRRegion& region = schedule.regions[processed];
+                FrameView view = ScaledSubView(workFrame, region.x, region.y, region.width, region.height,
+                                               regionScale);
+                if (!view.IsValid()) {
+                    continue;
+                }
+                auto regionStart = std::chrono::steady_clock::now();
+                // Only full-resolution pixels line up with screen positions
+                OCRDocument part = fullResolution ?
+                    this->m_ocrManager->ExtractText(view, screenX + view.origin_x, screenY + view.origin_y) :
+                    this->m_ocrManager->ExtractText(view);
+                // Reduced crops would understate the full-resolution cost
+                if (fullResolution) {
+                    this->m_ocrScheduler->ReportRegionTime(region, std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - regionStart));
+                }
+                ocr_utils::OffsetTextBlocks(part, view.origin_x, view.origin_y);
+                ocr_utils::AppendDocument(document, part);
+            }
+            if (processed < schedule.regions.size()) {
+                this->m_ocrScheduler->Defer(workFrame.monitor_id, std::vector<OCRRegion>(
+                    schedule.regions.begin() + processed, schedule.regions.end()));
+            }
+            perf.IncrementCounter("ocr.regions_processed", static_cast<int64_t>(processed));
+            perf.RecordTiming("ocr.frame_time", std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start));
             
             if (!document.text_blocks.empty()) {
                 m_ocrExtractions++;
@@ -336,18 +1132,27 @@ void Application::ProcessFrameWithOCR(const CaptureFrame& frame) {
                     }
                     
                     // Store OCR result
+                    uint64_t ocrRecordId = 0;
                     if (this->m_storageManager) {
-                        this->m_storageManager->StoreOCRResult(document, "Screen Capture");
+                        ocrRecordId = this->m_storageManager->StoreOCRResult(document, "Screen Capture");
+                    }
+                    if (ocrRecordId > 0 && ++this->m_unembeddedRecords >= SEMANTIC_EMBED_BATCH) {
+                        this->m_unembeddedRecords = 0;
+                        this->m_deferredWork->Enqueue("semantic.embed");
                     }
 
                     // Send real-time update to web clients
-                    if (this->m_webServer) {
-                        this->m_webServer->OnOCRResult(document);
+                    if (WebServer* server = this->ReadyWebServer()) {
+                        server->OnOCRResult(document);
                     }
                     
-                    // Process with AI for content classification
-                    if (this->m_aiAnalyzer) {
-                        this->ProcessContentWithAI(document, "Screen Capture", "Unknown");
+                    // Process with AI for content classification; the
+                    // screen is indexed once its final result is stored
+                    if (this->ReadyAI()) {
+                        this->ProcessContentWithAI(document, "Screen Capture", "Unknown",
+                                                   frameHash, ocrRecordId);
+                    } else if (ocrRecordId > 0) {
+                        this->m_fingerprints->Add(frameHash, ocrRecordId, 0);
                     }
                 }
             }
@@ -359,33 +1164,27 @@ void Application::ProcessFrameWithOCR(const CaptureFrame& frame) {
 
 void Application::ProcessContentWithAI(const OCRDocument& ocr_result,
                                       const std::string& window_title,
-                                      const std::string& app_name) {
-    if (!m_aiAnalyzer) {
+                                      const std::string& app_name,
+                                      uint64_t frameHash,
+                                      uint64_t ocrRecordId) {
+    AIContentAnalyzer* ai = ReadyAI();
+    if (!ai) {
         return;
     }
 
     // Process AI analysis asynchronously
-    auto future = m_aiAnalyzer->AnalyzeWindowAsync(ocr_result, window_title, app_name);
+    auto future = ai->AnalyzeWindowAsync(ocr_result, window_title, app_name);
     
-    std::thread([this, future = std::move(future)]() mutable {
+    m_inFlightTasks++;
+    std::thread([this, ai, frameHash, ocrRecordId, future = std::move(future)]() mutable {
+        InFlightRelease release(m_inFlightTasks);
         try {
             ContentAnalysis analysis = future.get();
             m_aiAnalyses++;
             
-            // Store AI analysis in encrypted storage
-            if (this->m_storageManager) {
-                this->m_storageManager->StoreAIAnalysis(analysis);
-            }
-
-            // Send real-time update to web clients
-            if (this->m_webServer) {
-                this->m_webServer->OnAIAnalysis(analysis);
-            }
-            
-            // Add to activity history
-            m_recentActivities.push_back(analysis);
-            if (m_recentActivities.size() > MAX_ACTIVITY_HISTORY) {
-                m_recentActivities.pop_front();
+            uint64_t analysisRecordId = this->PublishAnalysis(analysis);
+            if (ocrRecordId > 0 && analysisRecordId > 0) {
+                this->m_fingerprints->Add(frameHash, ocrRecordId, analysisRecordId);
             }
             
             // Log interesting classifications
@@ -405,10 +1204,9 @@ void Application::ProcessContentWithAI(const OCRDocument& ocr_result,
                           << analysis.classification_confidence << ")" << std::endl;
                 
                 // Show productivity insights
-                if (m_recentActivities.size() >= 5) {
-                    int productivity_score = m_aiAnalyzer->CalculateProductivityScore(
-                        std::vector<ContentAnalysis>(m_recentActivities.begin(), m_recentActivities.end())
-                    );
+                auto activities = this->GetRecentActivities();
+                if (activities.size() >= 5) {
+                    int productivity_score = ai->CalculateProductivityScore(activities);
                     
                     if (m_aiAnalyses % 10 == 0) { // Every 10 analyses
                         std::cout << "📊 Productivity Score: " << productivity_score << "/100" << std::endl;
@@ -422,16 +1220,90 @@ void Application::ProcessContentWithAI(const OCRDocument& ocr_result,
     }).detach();
 }
 
+// Stores an analysis and makes it visible: web clients and the recent
+// activity history. Returns the stored record id, 0 when not stored.
+uint64_t Application::PublishAnalysis(const ContentAnalysis& analysis) {
+    uint64_t recordId = 0;
+    
+    // Store AI analysis in encrypted storage
+    if (m_storageManager) {
+        recordId = m_storageManager->StoreAIAnalysis(analysis);
+    }
+
+    // Send real-time update to web clients
+    if (WebServer* server = ReadyWebServer()) {
+        server->OnAIAnalysis(analysis);
+    }
+    
+    // Add to activity history
+    {
+        std::lock_guard<std::mutex> lock(m_activitiesMutex);
+        m_recentActivities.push_back(analysis);
+        if (m_recentActivities.size() > MAX_ACTIVITY_HISTORY) {
+            m_recentActivities.pop_front();
+        }
+    }
+    
+    return recordId;
+}
+
+std::vector<ContentAnalysis> Application::GetRecentActivities() const {
+    std::lock_guard<std::mutex> lock(m_activitiesMutex);
+    return std::vector<ContentAnalysis>(m_recentActivities.begin(), m_recentActivities.end());
+}
+
+// A screen near one already processed gets that screen's stored analysis,
+// re-published with the current time, instead of OCR and a model run.
+// Entries whose records were removed by retention count as misses.
+bool Application::ReuseKnownScreen(uint64_t frameHash) {
+    auto& perf = PerformanceMonitor::GetInstance();
+    auto start = std::chrono::steady_clock::now();
+    
+    FingerprintMatch match;
+    bool found = m_fingerprints->FindNearest(frameHash, FINGERPRINT_MATCH_DISTANCE, match);
+    perf.RecordTiming("pipeline.fingerprint_lookup", std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start));
+    
+    bool reused = false;
+    if (found && match.analysis_record_id > 0 && m_storageManager) {
+        ContentAnalysisRecord record;
+        if (m_storageManager->GetContentAnalysis(match.analysis_record_id, record)) {
+            ContentAnalysis analysis;
+            analysis.timestamp = std::chrono::system_clock::now();
+            analysis.title = record.window_title;
+            analysis.application = record.application_name;
+            analysis.extracted_text = record.extracted_text;
+            analysis.keywords = record.keywords;
+            analysis.content_type = record.content_type;
+            analysis.work_category = record.work_category;
+            analysis.priority = record.priority;
+            analysis.is_productive = record.is_productive;
+            analysis.is_focused_work = record.is_focused_work;
+            analysis.classification_confidence = record.ai_confidence;
+            analysis.distraction_level = record.distraction_level;
+            PublishAnalysis(analysis);
+            reused = true;
+        }
+    } else if (found && match.ocr_record_id > 0 && !ReadyAI()) {
+        // Text already stored and there is no model to run on it
+        reused = true;
+    }
+    
+    perf.IncrementCounter(reused ? "pipeline.fingerprint_hits" : "pipeline.fingerprint_misses");
+    return reused;
+}
+
 void Application::PrintProductivitySummary() {
-    if (m_recentActivities.empty() || !m_aiAnalyzer) {
+    std::vector<ContentAnalysis> activities = GetRecentActivities();
+    AIContentAnalyzer* ai = ReadyAI();
+    if (activities.empty() || !ai) {
         return;
     }
 
     std::cout << "\n=== 📈 PRODUCTIVITY SUMMARY ===" << std::endl;
     
     // Calculate overall productivity
-    std::vector<ContentAnalysis> activities(m_recentActivities.begin(), m_recentActivities.end());
-    int productivity_score = m_aiAnalyzer->CalculateProductivityScore(activities);
+    int productivity_score = ai->CalculateProductivityScore(activities);
     
     std::cout << "Overall Productivity Score: " << productivity_score << "/100 ";
     if (productivity_score >= 80) std::cout << "🔥 Excellent!";
@@ -448,7 +1320,7 @@ void Application::PrintProductivitySummary() {
     for (const auto& activity : activities) {
         type_counts[activity.content_type]++;
         category_counts[activity.work_category]++;
-        if (m_aiAnalyzer->IsProductiveActivity(activity)) {
+        if (ai->IsProductiveActivity(activity)) {
             productive_count++;
         }
     }
@@ -468,14 +1340,15 @@ void Application::PrintProductivitySummary() {
 }
 
 void Application::PrintWorkPatterns() {
-    if (m_recentActivities.empty() || !m_aiAnalyzer) {
+    std::vector<ContentAnalysis> activities = GetRecentActivities();
+    AIContentAnalyzer* ai = ReadyAI();
+    if (activities.empty() || !ai) {
         return;
     }
 
     std::cout << "\n=== 🎯 WORK PATTERNS ===" << std::endl;
     
-    std::vector<ContentAnalysis> activities(m_recentActivities.begin(), m_recentActivities.end());
-    auto patterns = m_aiAnalyzer->DetectWorkPatterns(activities);
+    auto patterns = ai->DetectWorkPatterns(activities);
     
     if (patterns.empty()) {
         std::cout << "No significant patterns detected yet." << std::endl;
@@ -486,7 +1359,7 @@ void Application::PrintWorkPatterns() {
     }
     
     // Predict next activity
-    ContentType predicted = m_aiAnalyzer->PredictNextActivity(activities);
+    ContentType predicted = ai->PredictNextActivity(activities);
     if (predicted != ContentType::UNKNOWN) {
         std::cout << "Predicted next activity: " 
                   << ai_utils::ContentTypeToString(predicted) << std::endl;
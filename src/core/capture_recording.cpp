@@ -0,0 +1,1262 @@
+#include "capture_recording.h"
+#include "event_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace work_assistant {
+
+namespace {
+
+// File: header, then records of RecordHeader + payload, each padded to 8
+// bytes. data_end in the header is advanced after a record is written.
+const char FILE_MAGIC[4] = {'W', 'A', 'C', 'R'};
+const uint32_t FILE_VERSION = 1;
+const size_t GROWTH_BYTES = 64 * 1024 * 1024;
+const int TILE_SIZE = 64;
+
+// On-demand frames kept per source until read during replay
+const size_t MAX_PENDING_READS = 2;
+
+enum RecordType : uint32_t {
+    RECORD_MONITORS = 1,
+    RECORD_FRAME = 2,
+    RECORD_WINDOW_EVENT = 3
+};
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t created_us;
+    uint64_t data_end;          // Committed bytes, header included
+    uint64_t record_count;
+    uint8_t reserved[32];
+};
+
+struct RecordHeader {
+    uint32_t type;
+    uint32_t size;              // Payload bytes
+    int64_t time_us;            // System clock
+};
+
+struct FrameHeader {
+    uint8_t source;
+    uint8_t key;                // Whole frame rather than changed tiles
+    uint8_t compressed;
+    uint8_t reserved;
+    int32_t monitor_id;
+    int32_t width;
+    int32_t height;
+    int32_t bytes_per_pixel;
+    int32_t format;
+    int32_t scale_factor;
+    int32_t pixel_passes;
+    uint32_t dirty_count;
+    uint32_t tile_count;
+    uint32_t raw_bytes;         // Pixel bytes before compression
+    uint32_t stored_bytes;
+};
+
+int64_t ToMicros(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point FromMicros(int64_t us) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(us)));
+}
+
+size_t Align8(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+class ByteWriter {
+public:
+    template <typename T>
+    void Put(const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void PutString(const std::string& value) {
+        Put(static_cast<uint32_t>(value.size()));
+        m_data.insert(m_data.end(), value.begin(), value.end());
+    }
+
+    void PutBytes(const uint8_t* data, size_t size) {
+        m_data.insert(m_data.end(), data, data + size);
+    }
+
+    std::vector<uint8_t>& Data() { return m_data; }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+// Bounds-checked reads; any overrun marks the reader failed
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    template <typename T>
+    bool Get(T& value) {
+        if (!Has(sizeof(T))) {
+            return false;
+        }
+        std::memcpy(&value, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool GetString(std::string& value) {
+        uint32_t length = 0;
+        if (!Get(length) || !Has(length)) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+    const uint8_t* Take(size_t size) {
+        if (!Has(size)) {
+            return nullptr;
+        }
+        const uint8_t* data = m_data + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+    bool Ok() const { return m_ok; }
+    size_t Remaining() const { return m_ok ? m_size - m_offset : 0; }
+
+private:
+    bool Has(size_t size) {
+        m_ok = m_ok && size <= m_size - m_offset;
+        return m_ok;
+    }
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+    bool m_ok = true;
+};
+
+void WriteWindowEvent(ByteWriter& writer, const WindowEvent& event) {
+    const WindowInfo& info = event.window_info;
+    writer.Put(static_cast<uint32_t>(event.type));
+    writer.Put(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(info.window_handle)));
+    writer.Put(info.process_id);
+    writer.Put(static_cast<int32_t>(info.x));
+    writer.Put(static_cast<int32_t>(info.y));
+    writer.Put(static_cast<int32_t>(info.width));
+    writer.Put(static_cast<int32_t>(info.height));
+    writer.Put(static_cast<uint8_t>(info.is_visible ? 1 : 0));
+    writer.Put(ToMicros(info.timestamp));
+    writer.PutString(info.title);
+    writer.PutString(info.class_name);
+    writer.PutString(info.process_name);
+}
+
+bool ReadWindowEvent(ByteReader& reader, WindowEvent& event) {
+    uint32_t type = 0;
+    uint64_t handle = 0;
+    int32_t x = 0, y = 0, width = 0, height = 0;
+    uint8_t visible = 0;
+    int64_t timestamp = 0;
+    WindowInfo& info = event.window_info;
+    if (!reader.Get(type) || !reader.Get(handle) || !reader.Get(info.process_id) ||
+        !reader.Get(x) || !reader.Get(y) || !reader.Get(width) || !reader.Get(height) ||
+        !reader.Get(visible) || !reader.Get(timestamp) || !reader.GetString(info.title) ||
+        !reader.GetString(info.class_name) || !reader.GetString(info.process_name) ||
+        type > static_cast<uint32_t>(WindowEventType::WINDOW_RESTORED)) {
+        return false;
+    }
+    event.type = static_cast<WindowEventType>(type);
+    info.window_handle = reinterpret_cast<WindowHandle>(static_cast<uintptr_t>(handle));
+    info.x = x;
+    info.y = y;
+    info.width = width;
+    info.height = height;
+    info.is_visible = visible != 0;
+    info.timestamp = FromMicros(timestamp);
+    return true;
+}
+
+// Frames of one source and monitor are stored relative to the previous one
+struct TileChain {
+    int width = 0, height = 0, bytes_per_pixel = 0, format = 0, scale_factor = 0;
+    std::vector<uint8_t> pixels;    // Packed rows
+
+    bool Matches(int w, int h, int bpp, int f, int s) const {
+        return !pixels.empty() && width == w && height == h && bytes_per_pixel == bpp &&
+               format == f && scale_factor == s;
+    }
+
+    void Reset(int w, int h, int bpp, int f, int s) {
+        width = w;
+        height = h;
+        bytes_per_pixel = bpp;
+        format = f;
+        scale_factor = s;
+        pixels.assign(static_cast<size_t>(w) * h * bpp, 0);
+    }
+
+    int Columns() const { return (width + TILE_SIZE - 1) / TILE_SIZE; }
+    int Rows() const { return (height + TILE_SIZE - 1) / TILE_SIZE; }
+};
+
+using ChainKey = std::pair<int, int>;   // Source, monitor
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Recorder
+
+class CaptureRecorder::Impl {
+public:
+    ~Impl() {
+        Close();
+    }
+
+    bool Open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CloseLocked();
+
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0 || !Grow(GROWTH_BYTES)) {
+            std::cerr << "Failed to open capture recording: " << path << std::endl;
+            CloseLocked();
+            return false;
+        }
+
+        FileHeader* header = Header();
+        std::memcpy(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header->version = FILE_VERSION;
+        header->created_us = ToMicros(std::chrono::system_clock::now());
+        header->data_end = Align8(sizeof(FileHeader));
+        header->record_count = 0;
+
+        m_path = path;
+        m_stats = CaptureRecorderStatistics();
+        std::cout << "Recording capture session to " << path << std::endl;
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CloseLocked();
+    }
+
+    bool IsOpen() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_data != nullptr;
+    }
+
+    void RecordMonitors(const std::vector<MonitorInfo>& monitors) {
+        ByteWriter writer;
+        writer.Put(static_cast<uint32_t>(monitors.size()));
+        for (const auto& monitor : monitors) {
+            writer.Put(static_cast<int32_t>(monitor.id));
+            writer.Put(static_cast<int32_t>(monitor.x));
+            writer.Put(static_cast<int32_t>(monitor.y));
+            writer.Put(static_cast<int32_t>(monitor.width));
+            writer.Put(static_cast<int32_t>(monitor.height));
+            writer.Put(static_cast<uint8_t>(monitor.is_primary ? 1 : 0));
+            writer.PutString(monitor.name);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Append(RECORD_MONITORS, ToMicros(std::chrono::system_clock::now()), writer.Data());
+    }
+
+    void RecordFrame(const CaptureFrame& frame, CaptureSource source) {
+        if (!frame.IsValid() || frame.bytes_per_pixel <= 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_data) {
+            return;
+        }
+
+        const int bpp = frame.bytes_per_pixel;
+        const size_t rowBytes = static_cast<size_t>(frame.width) * bpp;
+        const size_t stride = frame.stride > 0 ? static_cast<size_t>(frame.stride) : rowBytes;
+        const int format = static_cast<int>(frame.format);
+
+        TileChain& chain = m_chains[ChainKey(static_cast<int>(source), frame.monitor_id)];
+        const bool key = !chain.Matches(frame.width, frame.height, bpp, format, frame.scale_factor);
+        if (key) {
+            chain.Reset(frame.width, frame.height, bpp, format, frame.scale_factor);
+        }
+
+        // Key frames store every tile; otherwise only tiles under the
+        // dirty rects (all, without rects) are compared with the chain
+        std::vector<uint8_t> candidates(static_cast<size_t>(chain.Columns()) * chain.Rows(),
+                                        key || frame.dirty_rects.empty() ? 1 : 0);
+        if (!key) {
+            for (const DirtyRect& rect : frame.dirty_rects) {
+                int x0 = std::max(0, rect.x) / TILE_SIZE;
+                int y0 = std::max(0, rect.y) / TILE_SIZE;
+                int x1 = std::min(frame.width, rect.x + rect.width);
+                int y1 = std::min(frame.height, rect.y + rect.height);
+                for (int ty = y0; ty * TILE_SIZE < y1; ++ty) {
+                    for (int tx = x0; tx * TILE_SIZE < x1; ++tx) {
+                        candidates[static_cast<size_t>(ty) * chain.Columns() + tx] = 1;
+                    }
+                }
+            }
+        }
+
+        std::vector<uint32_t> tiles;
+        std::vector<uint8_t> raw;
+        for (int ty = 0; ty < chain.Rows(); ++ty) {
+            for (int tx = 0; tx < chain.Columns(); ++tx) {
+                const size_t index = static_cast<size_t>(ty) * chain.Columns() + tx;
+                if (!candidates[index]) {
+                    continue;
+                }
+                const int x0 = tx * TILE_SIZE;
+                const int y0 = ty * TILE_SIZE;
+                const size_t tileRow = static_cast<size_t>(std::min(TILE_SIZE, frame.width - x0)) * bpp;
+                const int y1 = std::min(frame.height, y0 + TILE_SIZE);
+
+                bool changed = key;
+                for (int y = y0; y < y1 && !changed; ++y) {
+                    changed = std::memcmp(frame.data.data() + y * stride + x0 * bpp,
+                                          chain.pixels.data() + y * rowBytes + x0 * bpp, tileRow) != 0;
+                }
+                if (!changed) {
+                    continue;
+                }
+
+                tiles.push_back(static_cast<uint32_t>(index));
+                for (int y = y0; y < y1; ++y) {
+                    const uint8_t* source_row = frame.data.data() + y * stride + x0 * bpp;
+                    raw.insert(raw.end(), source_row, source_row + tileRow);
+                    std::memcpy(chain.pixels.data() + y * rowBytes + x0 * bpp, source_row, tileRow);
+                }
+            }
+        }
+
+        std::vector<uint8_t> stored;
+        bool compressed = Compress(raw, stored);
+
+        FrameHeader header = {};
+        header.source = static_cast<uint8_t>(source);
+        header.key = key ? 1 : 0;
+        header.compressed = compressed ? 1 : 0;
+        header.monitor_id = frame.monitor_id;
+        header.width = frame.width;
+        header.height = frame.height;
+        header.bytes_per_pixel = bpp;
+        header.format = format;
+        header.scale_factor = frame.scale_factor;
+        header.pixel_passes = frame.pixel_passes;
+        header.dirty_count = static_cast<uint32_t>(frame.dirty_rects.size());
+        header.tile_count = static_cast<uint32_t>(tiles.size());
+        header.raw_bytes = static_cast<uint32_t>(raw.size());
+        header.stored_bytes = static_cast<uint32_t>(compressed ? stored.size() : raw.size());
+
+        ByteWriter writer;
+        writer.Put(header);
+        for (const DirtyRect& rect : frame.dirty_rects) {
+            writer.Put(static_cast<int32_t>(rect.x));
+            writer.Put(static_cast<int32_t>(rect.y));
+            writer.Put(static_cast<int32_t>(rect.width));
+            writer.Put(static_cast<int32_t>(rect.height));
+        }
+        if (!key) {
+            writer.PutBytes(reinterpret_cast<const uint8_t*>(tiles.data()), tiles.size() * sizeof(uint32_t));
+        }
+        const std::vector<uint8_t>& pixels = compressed ? stored : raw;
+        writer.PutBytes(pixels.data(), pixels.size());
+
+        auto timestamp = frame.timestamp.time_since_epoch().count() != 0 ? frame.timestamp
+                                                                         : std::chrono::system_clock::now();
+        if (Append(RECORD_FRAME, ToMicros(timestamp), writer.Data())) {
+            m_stats.frames++;
+            m_stats.key_frames += key ? 1 : 0;
+            m_stats.raw_bytes += static_cast<size_t>(frame.height) * rowBytes;
+        }
+    }
+
+    void RecordWindowEvent(const WindowEvent& event) {
+        ByteWriter writer;
+        WriteWindowEvent(writer, event);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (Append(RECORD_WINDOW_EVENT, ToMicros(event.timestamp), writer.Data())) {
+            m_stats.window_events++;
+        }
+    }
+
+    CaptureRecorderStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CaptureRecorderStatistics stats = m_stats;
+        stats.file_bytes = m_data ? Header()->data_end : stats.file_bytes;
+        return stats;
+    }
+
+private:
+    FileHeader* Header() const {
+        return reinterpret_cast<FileHeader*>(m_data);
+    }
+
+    // Remaps the file at a larger size; called with m_mutex held
+    bool Grow(size_t size) {
+        if (m_data) {
+            munmap(m_data, m_mapped);
+            m_data = nullptr;
+        }
+        if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+            return false;
+        }
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        m_data = static_cast<uint8_t*>(data);
+        m_mapped = size;
+        return true;
+    }
+
+    bool Append(uint32_t type, int64_t time_us, const std::vector<uint8_t>& payload) {
+        if (!m_data || payload.size() > UINT32_MAX) {
+            return false;
+        }
+
+        const size_t offset = Header()->data_end;
+        const size_t total = Align8(sizeof(RecordHeader) + payload.size());
+        if (offset + total > m_mapped && !Grow(m_mapped + std::max(GROWTH_BYTES, total))) {
+            std::cerr << "Capture recording stopped: failed to grow " << m_path << std::endl;
+            CloseLocked();
+            return false;
+        }
+
+        RecordHeader record;
+        record.type = type;
+        record.size = static_cast<uint32_t>(payload.size());
+        record.time_us = time_us;
+        std::memcpy(m_data + offset, &record, sizeof(record));
+        if (!payload.empty()) {
+            std::memcpy(m_data + offset + sizeof(record), payload.data(), payload.size());
+        }
+
+        // Publish only complete records
+        Header()->data_end = offset + total;
+        Header()->record_count++;
+        return true;
+    }
+
+    static bool Compress(const std::vector<uint8_t>& raw, std::vector<uint8_t>& out) {
+#ifdef HAVE_ZLIB
+        if (raw.empty()) {
+            return false;
+        }
+        uLongf length = compressBound(static_cast<uLong>(raw.size()));
+        out.resize(length);
+        // Fastest level: the recorder runs on the capture threads
+        if (compress2(out.data(), &length, raw.data(), static_cast<uLong>(raw.size()), 1) != Z_OK ||
+            length >= raw.size()) {
+            return false;
+        }
+        out.resize(length);
+        return true;
+#else
+        (void)raw;
+        (void)out;
+        return false;
+#endif
+    }
+
+    void CloseLocked() {
+        if (m_data) {
+            const size_t end = Header()->data_end;
+            m_stats.file_bytes = end;
+            munmap(m_data, m_mapped);
+            m_data = nullptr;
+            if (ftruncate(m_fd, static_cast<off_t>(end)) != 0) {
+                std::cerr << "Failed to trim capture recording: " << m_path << std::endl;
+            }
+            std::cout << "Capture recording closed: " << m_stats.frames << " frames, "
+                      << m_stats.window_events << " window events, "
+                      << std::fixed << std::setprecision(1) << end / (1024.0 * 1024.0) << "MB" << std::endl;
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        m_mapped = 0;
+        m_chains.clear();
+    }
+
+    mutable std::mutex m_mutex;
+    std::string m_path;
+    int m_fd = -1;
+    uint8_t* m_data = nullptr;
+    size_t m_mapped = 0;
+    std::map<ChainKey, TileChain> m_chains;
+    CaptureRecorderStatistics m_stats;
+};
+
+namespace {
+
+// Forwards to a real backend and records every frame it returns
+class RecordingScreenCapture : public IScreenCapture {
+public:
+    RecordingScreenCapture(std::unique_ptr<IScreenCapture> backend, std::shared_ptr<CaptureRecorder> recorder)
+        : m_backend(std::move(backend)), m_recorder(std::move(recorder)) {}
+
+    bool Initialize() override {
+        if (!m_backend->Initialize()) {
+            return false;
+        }
+        m_recorder->RecordMonitors(m_backend->GetMonitors());
+        return true;
+    }
+
+    void Shutdown() override {
+        m_backend->Shutdown();
+    }
+
+    std::vector<MonitorInfo> GetMonitors() const override {
+        return m_backend->GetMonitors();
+    }
+
+    bool CaptureDesktop(CaptureFrame& frame) override {
+        return Record(m_backend->CaptureDesktop(frame), frame, CaptureSource::DESKTOP);
+    }
+
+    bool CaptureMonitor(int monitorId, CaptureFrame& frame) override {
+        bool captured = m_backend->CaptureMonitor(monitorId, frame);
+        frame.monitor_id = monitorId;
+        return Record(captured, frame, CaptureSource::MONITOR);
+    }
+
+    bool CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) override {
+        return Record(m_backend->CaptureWindow(windowHandle, frame), frame, CaptureSource::WINDOW);
+    }
+
+    bool CaptureRegion(int x, int y, int width, int height, CaptureFrame& frame) override {
+        return Record(m_backend->CaptureRegion(x, y, width, height, frame), frame, CaptureSource::REGION);
+    }
+
+    bool SupportsHardwareAcceleration() const override {
+        return m_backend->SupportsHardwareAcceleration();
+    }
+
+    void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) override {
+        m_backend->SetCaptureSettings(useHardwareAcceleration, maxFPS);
+    }
+
+    bool CaptureDesktopIncremental(CaptureFrame& frame, bool& changed) override {
+        bool captured = m_backend->CaptureDesktopIncremental(frame, changed);
+        return RecordIfChanged(captured, changed, frame);
+    }
+
+    bool CaptureMonitorIncremental(int monitorId, CaptureFrame& frame, bool& changed) override {
+        bool captured = m_backend->CaptureMonitorIncremental(monitorId, frame, changed);
+        return RecordIfChanged(captured, changed, frame);
+    }
+
+    bool SupportsDamageTracking() const override {
+        return m_backend->SupportsDamageTracking();
+    }
+
+    bool CaptureDesktopScaled(int factor, CaptureFrame& frame, bool& changed) override {
+        bool captured = m_backend->CaptureDesktopScaled(factor, frame, changed);
+        return RecordIfChanged(captured, changed, frame);
+    }
+
+    bool CaptureMonitorScaled(int monitorId, int factor, CaptureFrame& frame, bool& changed) override {
+        bool captured = m_backend->CaptureMonitorScaled(monitorId, factor, frame, changed);
+        return RecordIfChanged(captured, changed, frame);
+    }
+
+    bool SupportsServerSideScaling() const override {
+        return m_backend->SupportsServerSideScaling();
+    }
+
+    bool SupportsParallelMonitorCapture() const override {
+        return m_backend->SupportsParallelMonitorCapture();
+    }
+
+    bool StartStreaming(std::function<void(const CaptureFrame&)> onFrame) override {
+        auto recorder = m_recorder;
+        return m_backend->StartStreaming([recorder, onFrame](const CaptureFrame& frame) {
+            recorder->RecordFrame(frame, CaptureSource::MONITORED);
+            onFrame(frame);
+        });
+    }
+
+    void StopStreaming() override {
+        m_backend->StopStreaming();
+    }
+
+    void SetPaused(bool paused) override {
+        m_backend->SetPaused(paused);
+    }
+
+private:
+    bool Record(bool captured, const CaptureFrame& frame, CaptureSource source) {
+        if (captured) {
+            m_recorder->RecordFrame(frame, source);
+        }
+        return captured;
+    }
+
+    // Takes changed by value, so callers must run the backend first: the
+    // evaluation order of the arguments of one call is unspecified
+    bool RecordIfChanged(bool captured, bool changed, const CaptureFrame& frame) {
+        return Record(captured && changed, frame, CaptureSource::MONITORED) || captured;
+    }
+
+    std::unique_ptr<IScreenCapture> m_backend;
+    std::shared_ptr<CaptureRecorder> m_recorder;
+};
+
+} // namespace
+
+CaptureRecorder::CaptureRecorder() : m_impl(std::make_unique<Impl>()) {}
+CaptureRecorder::~CaptureRecorder() = default;
+
+bool CaptureRecorder::Open(const std::string& path) {
+    return m_impl->Open(path);
+}
+
+void CaptureRecorder::Close() {
+    m_impl->Close();
+}
+
+bool CaptureRecorder::IsOpen() const {
+    return m_impl->IsOpen();
+}
+
+void CaptureRecorder::RecordMonitors(const std::vector<MonitorInfo>& monitors) {
+    m_impl->RecordMonitors(monitors);
+}
+
+void CaptureRecorder::RecordFrame(const CaptureFrame& frame, CaptureSource source) {
+    m_impl->RecordFrame(frame, source);
+}
+
+void CaptureRecorder::RecordWindowEvent(const WindowEvent& event) {
+    m_impl->RecordWindowEvent(event);
+}
+
+CaptureRecorderStatistics CaptureRecorder::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+std::unique_ptr<IScreenCapture> CaptureRecorder::WrapBackend(std::unique_ptr<IScreenCapture> backend,
+                                                             std::shared_ptr<CaptureRecorder> recorder) {
+    if (!backend || !recorder) {
+        return backend;
+    }
+    return std::make_unique<RecordingScreenCapture>(std::move(backend), std::move(recorder));
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+
+class CaptureReplay::Impl {
+public:
+    ~Impl() {
+        Close();
+    }
+
+    bool Open(const std::string& path, const CaptureReplayOptions& options) {
+        Close();
+        if (!options.IsValid()) {
+            return false;
+        }
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+            std::cerr << "Failed to open capture recording: " << path << std::endl;
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return false;
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            std::cerr << "Failed to map capture recording: " << path << std::endl;
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(data);
+
+        FileHeader header;
+        std::memcpy(&header, m_data, sizeof(header));
+        if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION) {
+            std::cerr << "Not a capture recording: " << path << std::endl;
+            Close();
+            return false;
+        }
+
+        // Index complete records; a torn tail is ignored
+        const size_t end = std::min(static_cast<size_t>(header.data_end), m_size);
+        size_t offset = Align8(sizeof(FileHeader));
+        while (offset + sizeof(RecordHeader) <= end) {
+            RecordHeader record;
+            std::memcpy(&record, m_data + offset, sizeof(record));
+            const size_t total = Align8(sizeof(RecordHeader) + record.size);
+            if (record.type < RECORD_MONITORS || record.type > RECORD_WINDOW_EVENT || total > end - offset) {
+                break;
+            }
+            if (record.type == RECORD_MONITORS && m_monitors.empty()) {
+                ReadMonitors(Payload(offset), record.size);
+            }
+            m_records.push_back(offset);
+            offset += total;
+        }
+
+        m_options = options;
+        m_stats = CaptureReplayStatistics();
+        m_stats.records = m_records.size();
+        std::cout << "Replaying capture session " << path << " (" << m_records.size() << " records, "
+                  << (options.speed > 0.0 ? "speed " + std::to_string(options.speed) : std::string("unpaced"))
+                  << ")" << std::endl;
+        return true;
+    }
+
+    void Close() {
+        Stop();
+        if (m_data) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+            m_data = nullptr;
+        }
+        m_size = 0;
+        m_records.clear();
+        m_monitors.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_reads.clear();
+        m_lastReads.clear();
+        m_windows.clear();
+    }
+
+    bool IsOpen() const {
+        return m_data != nullptr;
+    }
+
+    bool Start(std::function<void(const CaptureFrame&)> onFrame) {
+        if (!m_data || m_thread.joinable()) {
+            return false;
+        }
+        m_onFrame = std::move(onFrame);
+        m_stopRequested = false;
+        m_thread = std::thread(&Impl::PlaybackLoop, this);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_stopRequested = true;
+        }
+        m_waitCondition.notify_all();
+        if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+            m_thread.join();
+        }
+    }
+
+    bool TakeRead(CaptureSource source, int monitorId, CaptureFrame& frame) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ChainKey key(static_cast<int>(source), monitorId);
+        auto pending = m_reads.find(key);
+        if (pending != m_reads.end() && !pending->second.empty()) {
+            frame = std::move(pending->second.front());
+            pending->second.pop_front();
+            m_lastReads[key] = frame;
+            m_stats.reads_served++;
+            return true;
+        }
+        auto last = m_lastReads.find(key);
+        if (last != m_lastReads.end()) {
+            frame = last->second;
+            m_stats.reads_repeated++;
+            return true;
+        }
+        m_stats.reads_missed++;
+        return false;
+    }
+
+    std::vector<MonitorInfo> GetMonitors() const {
+        return m_monitors;
+    }
+
+    void SetEmitWindowEvents(bool emit) {
+        m_emitWindowEvents = emit;
+    }
+
+    bool IsEmittingWindowEvents() const {
+        return m_emitWindowEvents;
+    }
+
+    WindowInfo GetActiveWindow() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_activeWindow;
+    }
+
+    std::vector<WindowInfo> GetAllWindows() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<WindowInfo> windows;
+        for (const auto& entry : m_windows) {
+            windows.push_back(entry.second);
+        }
+        return windows;
+    }
+
+    void SetFinishedCallback(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finishedCallback = std::move(callback);
+    }
+
+    CaptureReplayStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    const uint8_t* Payload(size_t offset) const {
+        return m_data + offset + sizeof(RecordHeader);
+    }
+
+    void ReadMonitors(const uint8_t* payload, size_t size) {
+        ByteReader reader(payload, size);
+        uint32_t count = 0;
+        reader.Get(count);
+        for (uint32_t i = 0; i < count && reader.Ok(); ++i) {
+            MonitorInfo monitor;
+            int32_t id = 0, x = 0, y = 0, width = 0, height = 0;
+            uint8_t primary = 0;
+            if (reader.Get(id) && reader.Get(x) && reader.Get(y) && reader.Get(width) &&
+                reader.Get(height) && reader.Get(primary) && reader.GetString(monitor.name)) {
+                monitor.id = id;
+                monitor.x = x;
+                monitor.y = y;
+                monitor.width = width;
+                monitor.height = height;
+                monitor.is_primary = primary != 0;
+                m_monitors.push_back(monitor);
+            }
+        }
+    }
+
+    // Rebuilds a frame from its record and the previous frame of its chain
+    bool DecodeFrame(const uint8_t* payload, size_t size, int64_t time_us,
+                     CaptureFrame& frame, CaptureSource& source) {
+        ByteReader reader(payload, size);
+        FrameHeader header;
+        if (!reader.Get(header) || header.source > static_cast<uint8_t>(CaptureSource::WINDOW) ||
+            header.width <= 0 || header.height <= 0 || header.bytes_per_pixel <= 0) {
+            return false;
+        }
+        // Each dirty rect is four int32 fields; a count the payload cannot
+        // hold is corrupt and must not drive the allocation
+        if (header.dirty_count > reader.Remaining() / (4 * sizeof(int32_t)) ||
+            (!header.compressed && header.raw_bytes != header.stored_bytes)) {
+            return false;
+        }
+
+        frame.dirty_rects.resize(header.dirty_count);
+        for (DirtyRect& rect : frame.dirty_rects) {
+            int32_t x = 0, y = 0, width = 0, height = 0;
+            reader.Get(x);
+            reader.Get(y);
+            reader.Get(width);
+            reader.Get(height);
+            rect.x = x;
+            rect.y = y;
+            rect.width = width;
+            rect.height = height;
+        }
+        const uint8_t* tileIndices = header.key ? nullptr : reader.Take(header.tile_count * sizeof(uint32_t));
+        const uint8_t* stored = reader.Take(header.stored_bytes);
+        if (!reader.Ok()) {
+            return false;
+        }
+
+        std::vector<uint8_t> inflated;
+        const uint8_t* raw = stored;
+        if (header.compressed) {
+#ifdef HAVE_ZLIB
+            inflated.resize(header.raw_bytes);
+            uLongf length = header.raw_bytes;
+            if (uncompress(inflated.data(), &length, stored, header.stored_bytes) != Z_OK ||
+                length != header.raw_bytes) {
+                return false;
+            }
+            raw = inflated.data();
+#else
+            std::cerr << "Capture recording is compressed but zlib is unavailable" << std::endl;
+            return false;
+#endif
+        }
+
+        source = static_cast<CaptureSource>(header.source);
+        TileChain& chain = m_chains[ChainKey(header.source, header.monitor_id)];
+        const int bpp = header.bytes_per_pixel;
+        if (header.key) {
+            chain.Reset(header.width, header.height, bpp, header.format, header.scale_factor);
+        } else if (!chain.Matches(header.width, header.height, bpp, header.format, header.scale_factor)) {
+            return false;
+        }
+
+        // Key frames list every tile implicitly, in order
+        const size_t rowBytes = static_cast<size_t>(header.width) * bpp;
+        const size_t tileCount = header.key ? static_cast<size_t>(chain.Columns()) * chain.Rows() : header.tile_count;
+        size_t consumed = 0;
+        for (size_t i = 0; i < tileCount; ++i) {
+            uint32_t index = static_cast<uint32_t>(i);
+            if (!header.key) {
+                std::memcpy(&index, tileIndices + i * sizeof(uint32_t), sizeof(index));
+            }
+            const int tx = static_cast<int>(index % chain.Columns());
+            const int ty = static_cast<int>(index / chain.Columns());
+            if (ty >= chain.Rows()) {
+                return false;
+            }
+            const int x0 = tx * TILE_SIZE;
+            const int y0 = ty * TILE_SIZE;
+            const size_t tileRow = static_cast<size_t>(std::min(TILE_SIZE, header.width - x0)) * bpp;
+            const int y1 = std::min(header.height, y0 + TILE_SIZE);
+            if (consumed + tileRow * (y1 - y0) > header.raw_bytes) {
+                return false;
+            }
+            for (int y = y0; y < y1; ++y) {
+                std::memcpy(chain.pixels.data() + y * rowBytes + x0 * bpp, raw + consumed, tileRow);
+                consumed += tileRow;
+            }
+        }
+
+        frame.data = chain.pixels;
+        frame.width = header.width;
+        frame.height = header.height;
+        frame.bytes_per_pixel = bpp;
+        frame.stride = static_cast<int>(rowBytes);
+        frame.format = static_cast<ImageFormat>(header.format);
+        frame.timestamp = FromMicros(time_us);
+        frame.monitor_id = header.monitor_id;
+        frame.pixel_passes = header.pixel_passes;
+        frame.scale_factor = header.scale_factor;
+        return true;
+    }
+
+    // Sleeps until a record is due at the configured pace; false when stopped
+    bool WaitUntil(int64_t time_us) {
+        if (m_options.speed <= 0.0) {
+            return !m_stopRequested;
+        }
+        auto due = m_playbackStart + std::chrono::microseconds(
+            static_cast<int64_t>((time_us - m_firstRecordUs) / m_options.speed));
+        auto now = std::chrono::steady_clock::now();
+        if (now > due) {
+            double lag = std::chrono::duration<double, std::milli>(now - due).count();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.max_lag_ms = std::max(m_stats.max_lag_ms, lag);
+            return !m_stopRequested;
+        }
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        return !m_waitCondition.wait_until(lock, due, [this]() { return m_stopRequested.load(); });
+    }
+
+    void EmitWindowEvent(const WindowEvent& event) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const WindowInfo& info = event.window_info;
+            switch (event.type) {
+                case WindowEventType::WINDOW_DESTROYED:
+                    m_windows.erase(info.window_handle);
+                    break;
+                case WindowEventType::WINDOW_FOCUSED:
+                    m_activeWindow = info;
+                    m_windows[info.window_handle] = info;
+                    break;
+                default:
+                    m_windows[info.window_handle] = info;
+                    break;
+            }
+            m_stats.window_events++;
+        }
+        if (m_emitWindowEvents) {
+            EventManager::GetInstance().EmitEvent(event);
+        }
+    }
+
+    // Monitored frame i is delivered once every on-demand frame recorded
+    // before frame i+1 is decoded, so reads issued while handling frame i
+    // find the frames the live run captured for them. Window events
+    // recorded after frame i follow its delivery.
+    void PlaybackLoop() {
+        m_playbackStart = std::chrono::steady_clock::now();
+        m_firstRecordUs = 0;
+        if (!m_records.empty()) {
+            RecordHeader first;
+            std::memcpy(&first, m_data + m_records.front(), sizeof(first));
+            m_firstRecordUs = first.time_us;
+        }
+
+        CaptureFrame pending;
+        int64_t pendingTime = 0;
+        bool hasPending = false;
+        std::vector<std::pair<int64_t, WindowEvent>> pendingEvents;
+
+        auto flush = [&]() {
+            if (hasPending) {
+                if (!WaitUntil(pendingTime)) {
+                    return false;
+                }
+                m_onFrame(pending);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.frames_delivered++;
+                hasPending = false;
+            }
+            for (const auto& entry : pendingEvents) {
+                if (!WaitUntil(entry.first)) {
+                    return false;
+                }
+                EmitWindowEvent(entry.second);
+            }
+            pendingEvents.clear();
+            return true;
+        };
+
+        for (size_t offset : m_records) {
+            if (m_stopRequested) {
+                return;
+            }
+            RecordHeader record;
+            std::memcpy(&record, m_data + offset, sizeof(record));
+
+            if (record.type == RECORD_WINDOW_EVENT) {
+                ByteReader reader(Payload(offset), record.size);
+                WindowEvent event;
+                event.timestamp = FromMicros(record.time_us);
+                if (ReadWindowEvent(reader, event)) {
+                    pendingEvents.emplace_back(record.time_us, event);
+                    if (!hasPending && !flush()) {
+                        return;
+                    }
+                }
+            } else if (record.type == RECORD_FRAME) {
+                CaptureFrame frame;
+                CaptureSource source = CaptureSource::MONITORED;
+                if (!DecodeFrame(Payload(offset), record.size, record.time_us, frame, source)) {
+                    std::cerr << "Skipping unreadable frame in capture recording" << std::endl;
+                    continue;
+                }
+                if (source == CaptureSource::MONITORED) {
+                    if (!flush()) {
+                        return;
+                    }
+                    pending = std::move(frame);
+                    pendingTime = record.time_us;
+                    hasPending = true;
+                } else {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto& queue = m_reads[ChainKey(static_cast<int>(source), frame.monitor_id)];
+                    queue.push_back(std::move(frame));
+                    if (queue.size() > MAX_PENDING_READS) {
+                        queue.pop_front();
+                    }
+                }
+            }
+        }
+        if (!flush()) {
+            return;
+        }
+
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.finished = true;
+            callback = m_finishedCallback;
+            std::cout << "Capture replay finished: " << m_stats.frames_delivered << " frames, "
+                      << m_stats.window_events << " window events, max lag "
+                      << std::fixed << std::setprecision(1) << m_stats.max_lag_ms << "ms" << std::endl;
+        }
+        if (callback) {
+            callback();
+        }
+    }
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<size_t> m_records;          // Offsets of complete records
+    std::vector<MonitorInfo> m_monitors;
+    CaptureReplayOptions m_options;
+
+    // Playback thread
+    std::thread m_thread;
+    std::function<void(const CaptureFrame&)> m_onFrame;
+    std::atomic<bool> m_stopRequested{false};
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+    std::chrono::steady_clock::time_point m_playbackStart;
+    int64_t m_firstRecordUs = 0;
+    std::map<ChainKey, TileChain> m_chains;  // Playback thread only
+
+    // Shared with the capture and window-monitor callers
+    mutable std::mutex m_mutex;
+    std::map<ChainKey, std::deque<CaptureFrame>> m_reads;
+    std::map<ChainKey, CaptureFrame> m_lastReads;
+    std::map<WindowHandle, WindowInfo> m_windows;
+    WindowInfo m_activeWindow;
+    std::atomic<bool> m_emitWindowEvents{false};
+    std::function<void()> m_finishedCallback;
+    CaptureReplayStatistics m_stats;
+};
+
+class ReplayScreenCapture : public IScreenCapture {
+public:
+    explicit ReplayScreenCapture(std::shared_ptr<CaptureReplay> replay) : m_replay(std::move(replay)) {}
+
+    ~ReplayScreenCapture() override {
+        Shutdown();
+    }
+
+    bool Initialize() override {
+        return m_replay->IsOpen();
+    }
+
+    void Shutdown() override {
+        StopStreaming();
+    }
+
+    std::vector<MonitorInfo> GetMonitors() const override {
+        return m_replay->m_impl->GetMonitors();
+    }
+
+    bool CaptureDesktop(CaptureFrame& frame) override {
+        return m_replay->m_impl->TakeRead(CaptureSource::DESKTOP, -1, frame);
+    }
+
+    bool CaptureMonitor(int monitorId, CaptureFrame& frame) override {
+        return m_replay->m_impl->TakeRead(CaptureSource::MONITOR, monitorId, frame);
+    }
+
+    bool CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) override {
+        (void)windowHandle;
+        return m_replay->m_impl->TakeRead(CaptureSource::WINDOW, -1, frame);
+    }
+
+    bool CaptureRegion(int x, int y, int width, int height, CaptureFrame& frame) override {
+        (void)x;
+        (void)y;
+        (void)width;
+        (void)height;
+        return m_replay->m_impl->TakeRead(CaptureSource::REGION, -1, frame);
+    }
+
+    bool SupportsHardwareAcceleration() const override {
+        return false;
+    }
+
+    // Pacing comes from the recording
+    void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) override {
+        (void)useHardwareAcceleration;
+        (void)maxFPS;
+    }
+
+    bool StartStreaming(std::function<void(const CaptureFrame&)> onFrame) override {
+        return m_replay->m_impl->Start(std::move(onFrame));
+    }
+
+    void StopStreaming() override {
+        m_replay->m_impl->Stop();
+    }
+
+private:
+    std::shared_ptr<CaptureReplay> m_replay;
+};
+
+class ReplayWindowMonitor : public IWindowMonitor {
+public:
+    explicit ReplayWindowMonitor(std::shared_ptr<CaptureReplay> replay) : m_replay(std::move(replay)) {}
+
+    bool Initialize() override {
+        return m_replay->IsOpen();
+    }
+
+    void Shutdown() override {
+        StopMonitoring();
+    }
+
+    bool StartMonitoring() override {
+        m_replay->m_impl->SetEmitWindowEvents(true);
+        return true;
+    }
+
+    void StopMonitoring() override {
+        m_replay->m_impl->SetEmitWindowEvents(false);
+    }
+
+    bool IsMonitoring() const override {
+        return m_replay->m_impl->IsEmittingWindowEvents();
+    }
+
+    WindowInfo GetActiveWindow() const override {
+        return m_replay->m_impl->GetActiveWindow();
+    }
+
+    std::vector<WindowInfo> GetAllWindows() const override {
+        return m_replay->m_impl->GetAllWindows();
+    }
+
+private:
+    std::shared_ptr<CaptureReplay> m_replay;
+};
+
+CaptureReplay::CaptureReplay() : m_impl(std::make_unique<Impl>()) {}
+CaptureReplay::~CaptureReplay() = default;
+
+bool CaptureReplay::Open(const std::string& path, const CaptureReplayOptions& options) {
+    return m_impl->Open(path, options);
+}
+
+void CaptureReplay::Close() {
+    m_impl->Close();
+}
+
+bool CaptureReplay::IsOpen() const {
+    return m_impl->IsOpen();
+}
+
+std::unique_ptr<IScreenCapture> CaptureReplay::CreateScreenCapture() {
+    return std::make_unique<ReplayScreenCapture>(shared_from_this());
+}
+
+std::unique_ptr<IWindowMonitor> CaptureReplay::CreateWindowMonitor() {
+    return std::make_unique<ReplayWindowMonitor>(shared_from_this());
+}
+
+void CaptureReplay::SetFinishedCallback(std::function<void()> callback) {
+    m_impl->SetFinishedCallback(std::move(callback));
+}
+
+CaptureReplayStatistics CaptureReplay::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
@@ -3,12 +3,16 @@
 #include <algorithm>
 #include <fstream>
 #include <vector>
+#include <cstdlib>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 namespace work_assistant {
 namespace capture_utils {
 
 // Calculate perceptual hash (dHash) for change detection
-uint64_t CalculateHash(const CaptureFrame& frame) {
+uint64_t CalculateHash(const FrameView& frame) {
     if (!frame.IsValid()) {
         return 0;
     }
@@ -17,8 +21,9 @@ uint64_t CalculateHash(const CaptureFrame& frame) {
     const int hashWidth = 9;
     const int hashHeight = 8;
     
-    // Simple downsampling
+    // Simple downsampling, reading the frame's native channel order
     std::vector<uint8_t> resized(hashWidth * hashHeight);
+    const ChannelOffsets channels = GetChannelOffsets(frame.format);
     
     for (int y = 0; y < hashHeight; ++y) {
         for (int x = 0; x < hashWidth; ++x) {
@@ -27,18 +32,11 @@ uint64_t CalculateHash(const CaptureFrame& frame) {
             int srcY = y * frame.height / hashHeight;
             
             // Get pixel value (convert to grayscale if needed)
-            int actual_stride = (frame.stride > 0) ? frame.stride : frame.width * frame.bytes_per_pixel;
-            int offset = srcY * actual_stride + srcX * frame.bytes_per_pixel;
-            if (offset + frame.bytes_per_pixel <= static_cast<int>(frame.data.size())) {
-                if (frame.bytes_per_pixel >= 3) {
-                    // Convert RGB to grayscale
-                    uint8_t r = frame.data[offset];
-                    uint8_t g = frame.data[offset + 1];
-                    uint8_t b = frame.data[offset + 2];
-                    resized[y * hashWidth + x] = static_cast<uint8_t>((r + g + b) / 3);
-                } else {
-                    resized[y * hashWidth + x] = frame.data[offset];
-                }
+            const uint8_t* pixel = frame.Pixel(srcX, srcY);
+            if (frame.bytes_per_pixel >= 3) {
+                resized[y * hashWidth + x] = PixelLuma(pixel, channels);
+            } else {
+                resized[y * hashWidth + x] = pixel[0];
             }
         }
     }
@@ -73,55 +71,66 @@ int CompareHashes(uint64_t hash1, uint64_t hash2) {
     return distance;
 }
 
-// Convert frame to different format
-bool ConvertFrame(const CaptureFrame& source, CaptureFrame& target, int targetBytesPerPixel) {
+// Convert frame to different format. Reads any packed source layout;
+// writes RGB, RGBA or GRAY in a single pass.
+bool ConvertFrame(const FrameView& source, CaptureFrame& target, int targetBytesPerPixel) {
     if (!source.IsValid()) {
         return false;
     }
     
-    target.width = source.width;
-    target.height = source.height;
-    target.bytes_per_pixel = targetBytesPerPixel;
-    target.stride = source.width * targetBytesPerPixel;
-    target.timestamp = source.timestamp;
-    
     // Determine target format
+    ImageFormat format;
     if (targetBytesPerPixel == 4) {
-        target.format = ImageFormat::RGBA;
+        format = ImageFormat::RGBA;
     } else if (targetBytesPerPixel == 3) {
-        target.format = ImageFormat::RGB;
+        format = ImageFormat::RGB;
     } else if (targetBytesPerPixel == 1) {
-        target.format = ImageFormat::GRAY;
+        format = ImageFormat::GRAY;
     } else {
         return false;
     }
     
-    target.data.resize(target.height * target.stride);
+    target.width = source.width;
+    target.height = source.height;
+    target.bytes_per_pixel = targetBytesPerPixel;
+    target.stride = source.width * targetBytesPerPixel;
+    target.format = format;
+    target.timestamp = source.timestamp;
+    target.monitor_id = source.monitor_id;
+    target.pixel_passes = source.pixel_passes + 1;
+    target.dirty_rects.clear();
+    target.data.resize(static_cast<size_t>(target.height) * target.stride);
     
     // Perform conversion
-    int src_stride = (source.stride > 0) ? source.stride : source.width * source.bytes_per_pixel;
+    const ChannelOffsets channels = GetChannelOffsets(source.format);
+    const bool sourceHasAlpha = source.format == ImageFormat::RGBA || source.format == ImageFormat::BGRA;
     for (int y = 0; y < source.height; ++y) {
+        const uint8_t* srcRow = source.Row(y);
+        uint8_t* dstRow = &target.data[static_cast<size_t>(y) * target.stride];
         for (int x = 0; x < source.width; ++x) {
-            int srcOffset = y * src_stride + x * source.bytes_per_pixel;
-            int dstOffset = y * target.stride + x * target.bytes_per_pixel;
+            const uint8_t* src = srcRow + x * source.bytes_per_pixel;
+            uint8_t* dst = dstRow + x * target.bytes_per_pixel;
             
-            if (source.bytes_per_pixel == 4 && target.bytes_per_pixel == 3) {
-                // RGBA to RGB
-                std::memcpy(&target.data[dstOffset], &source.data[srcOffset], 3);
-            } else if (source.bytes_per_pixel == 3 && target.bytes_per_pixel == 4) {
-                // RGB to RGBA
-                std::memcpy(&target.data[dstOffset], &source.data[srcOffset], 3);
-                target.data[dstOffset + 3] = 255; // Alpha
+            if (source.bytes_per_pixel >= 3 && target.bytes_per_pixel >= 3) {
+                // Any colour layout to RGB/RGBA
+                dst[0] = src[channels.r];
+                dst[1] = src[channels.g];
+                dst[2] = src[channels.b];
+                if (target.bytes_per_pixel == 4) {
+                    dst[3] = sourceHasAlpha ? src[3] : 255; // Alpha
+                }
             } else if (source.bytes_per_pixel >= 3 && target.bytes_per_pixel == 1) {
-                // RGB/RGBA to Grayscale
-                uint8_t r = source.data[srcOffset];
-                uint8_t g = source.data[srcOffset + 1];
-                uint8_t b = source.data[srcOffset + 2];
-                target.data[dstOffset] = static_cast<uint8_t>((r + g + b) / 3);
+                // Colour to Grayscale
+                dst[0] = PixelLuma(src, channels);
+            } else if (source.bytes_per_pixel == 1 && target.bytes_per_pixel >= 3) {
+                // Grayscale to RGB/RGBA
+                std::memset(dst, src[0], 3);
+                if (target.bytes_per_pixel == 4) {
+                    dst[3] = 255;
+                }
             } else {
                 // Direct copy for same format
-                std::memcpy(&target.data[dstOffset], &source.data[srcOffset], 
-                           std::min(source.bytes_per_pixel, target.bytes_per_pixel));
+                std::memcpy(dst, src, std::min(source.bytes_per_pixel, target.bytes_per_pixel));
             }
         }
     }
@@ -130,7 +139,7 @@ bool ConvertFrame(const CaptureFrame& source, CaptureFrame& target, int targetBy
 }
 
 // Save frame to file (for debugging)
-bool SaveFrameToFile(const CaptureFrame& frame, const std::string& filename) {
+bool SaveFrameToFile(const FrameView& frame, const std::string& filename) {
     if (!frame.IsValid()) {
         return false;
     }
@@ -145,12 +154,15 @@ bool SaveFrameToFile(const CaptureFrame& frame, const std::string& filename) {
         // PPM header
         file << "P6\n" << frame.width << " " << frame.height << "\n255\n";
         
-        // Write pixel data
-        int actual_stride = (frame.stride > 0) ? frame.stride : frame.width * frame.bytes_per_pixel;
+        // Write pixel data in RGB order
+        const ChannelOffsets channels = GetChannelOffsets(frame.format);
         for (int y = 0; y < frame.height; ++y) {
             for (int x = 0; x < frame.width; ++x) {
-                int offset = y * actual_stride + x * frame.bytes_per_pixel;
-                file.write(reinterpret_cast<const char*>(&frame.data[offset]), 3);
+                const uint8_t* pixel = frame.Pixel(x, y);
+                const char rgb[3] = {static_cast<char>(pixel[channels.r]),
+                                     static_cast<char>(pixel[channels.g]),
+                                     static_cast<char>(pixel[channels.b])};
+                file.write(rgb, 3);
             }
         }
         
@@ -166,9 +178,8 @@ bool SaveFrameToFile(const CaptureFrame& frame, const std::string& filename) {
         file << "P5\n" << frame.width << " " << frame.height << "\n255\n";
         
         // Write pixel data
-        int actual_stride = (frame.stride > 0) ? frame.stride : frame.width * frame.bytes_per_pixel;
         for (int y = 0; y < frame.height; ++y) {
-            file.write(reinterpret_cast<const char*>(&frame.data[y * actual_stride]), frame.width);
+            file.write(reinterpret_cast<const char*>(frame.Row(y)), frame.width);
         }
         
         return true;
@@ -177,35 +188,377 @@ bool SaveFrameToFile(const CaptureFrame& frame, const std::string& filename) {
     return false;
 }
 
-// Crop frame to region
-bool CropFrame(const CaptureFrame& source, CaptureFrame& target,
-               int x, int y, int width, int height) {
+// Crop view to region without copying
+bool CropView(const FrameView& source, FrameView& target,
+              int x, int y, int width, int height) {
     if (!source.IsValid()) {
         return false;
     }
     
     // Validate region
-    if (x < 0 || y < 0 || x + width > source.width || y + height > source.height) {
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > source.width || y + height > source.height) {
         return false;
     }
     
+    target = source.SubView(x, y, width, height);
+    return target.IsValid();
+}
+
+// Crop frame to region
+bool CropFrame(const FrameView& source, CaptureFrame& target,
+               int x, int y, int width, int height) {
+    FrameView region;
+    if (!CropView(source, region, x, y, width, height)) {
+        return false;
+    }
+    
+    target = region.ToFrame();
+    return true;
+}
+
+// Box-filter downscale by an integer factor
+bool DownscaleFrame(const FrameView& source, CaptureFrame& target, int factor) {
+    if (!source.IsValid() || factor < 1) {
+        return false;
+    }
+    if (factor == 1) {
+        target = source.ToFrame();
+        return true;
+    }
+
+    const int bpp = source.bytes_per_pixel;
+
+    target.width = std::max(1, source.width / factor);
+    target.height = std::max(1, source.height / factor);
+    target.bytes_per_pixel = bpp;
+    target.stride = target.width * bpp;
+    target.format = source.format;
+    target.timestamp = source.timestamp;
+    target.monitor_id = source.monitor_id;
+    target.pixel_passes = source.pixel_passes + 1;
+    target.scale_factor = factor;
+    target.dirty_rects.clear();
+    target.data.resize(static_cast<size_t>(target.height) * target.stride);
+
+    const int block_w = std::min(factor, source.width);
+    const int block_h = std::min(factor, source.height);
+    const int area = block_w * block_h;
+    std::vector<uint32_t> sums(bpp);
+
+    for (int ty = 0; ty < target.height; ++ty) {
+        for (int tx = 0; tx < target.width; ++tx) {
+            std::fill(sums.begin(), sums.end(), 0u);
+            for (int dy = 0; dy < block_h; ++dy) {
+                const uint8_t* row = source.Pixel(tx * factor, ty * factor + dy);
+                for (int dx = 0; dx < block_w; ++dx) {
+                    for (int c = 0; c < bpp; ++c) {
+                        sums[c] += row[dx * bpp + c];
+                    }
+                }
+            }
+            uint8_t* dst = &target.data[ty * target.stride + tx * bpp];
+            for (int c = 0; c < bpp; ++c) {
+                dst[c] = static_cast<uint8_t>(sums[c] / area);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool DownscaleFrame(const CaptureFrame& source, CaptureFrame& target, int factor) {
+    if (factor == 1) {
+        if (!source.IsValid()) {
+            return false;
+        }
+        target = source;
+        target.pixel_passes++;
+        return true;
+    }
+    if (!DownscaleFrame(FrameView(source), target, factor)) {
+        return false;
+    }
+
+    target.scale_factor = source.scale_factor * factor;
+    ScaleDirtyRects(source.dirty_rects, factor, target.width, target.height, target.dirty_rects);
+    return true;
+}
+
+// Scale rects outwards so they still cover every changed pixel
+void ScaleDirtyRects(const std::vector<DirtyRect>& source, int factor,
+                     int targetWidth, int targetHeight, std::vector<DirtyRect>& target) {
+    target.clear();
+    if (factor < 1 || targetWidth <= 0 || targetHeight <= 0) {
+        return;
+    }
+    for (const auto& rect : source) {
+        DirtyRect scaled;
+        scaled.x = std::min(rect.x / factor, targetWidth - 1);
+        scaled.y = std::min(rect.y / factor, targetHeight - 1);
+        scaled.width = std::min((rect.x + rect.width + factor - 1) / factor, targetWidth) - scaled.x;
+        scaled.height = std::min((rect.y + rect.height + factor - 1) / factor, targetHeight) - scaled.y;
+        if (scaled.width > 0 && scaled.height > 0) {
+            target.push_back(scaled);
+        }
+    }
+}
+
+// Area-averaging resize. Source rows are summed into per-column
+// accumulators, so each source pixel is read exactly once.
+bool ResizeFrame(const FrameView& source, CaptureFrame& target, int width, int height) {
+    if (!source.IsValid() || width <= 0 || height <= 0 ||
+        width > source.width || height > source.height) {
+        return false;
+    }
+
+    const int bpp = source.bytes_per_pixel;
+    const int channelCount = bpp >= 3 ? 3 : 1;
+    const ChannelOffsets channels = GetChannelOffsets(source.format);
+    const int offsets[3] = {channels.r, channels.g, channels.b};
+
     target.width = width;
     target.height = height;
-    target.bytes_per_pixel = source.bytes_per_pixel;
-    target.stride = width * source.bytes_per_pixel;
-    target.format = source.format;
+    target.bytes_per_pixel = channelCount;
+    target.stride = width * channelCount;
+    target.format = channelCount == 3 ? ImageFormat::RGB : ImageFormat::GRAY;
     target.timestamp = source.timestamp;
-    
-    target.data.resize(height * target.stride);
-    
-    // Copy cropped region
-    int src_stride = (source.stride > 0) ? source.stride : source.width * source.bytes_per_pixel;
-    for (int row = 0; row < height; ++row) {
-        int srcOffset = (y + row) * src_stride + x * source.bytes_per_pixel;
-        int dstOffset = row * target.stride;
-        std::memcpy(&target.data[dstOffset], &source.data[srcOffset], target.stride);
+    target.monitor_id = source.monitor_id;
+    target.pixel_passes = source.pixel_passes + 1;
+    target.scale_factor = 1;
+    target.dirty_rects.clear();
+    target.data.resize(static_cast<size_t>(height) * target.stride);
+
+    // Source column span of each target column
+    std::vector<int> columnStart(width + 1);
+    for (int x = 0; x <= width; ++x) {
+        columnStart[x] = static_cast<int>(static_cast<int64_t>(x) * source.width / width);
     }
-    
+
+    std::vector<uint32_t> sums(static_cast<size_t>(width) * channelCount);
+    for (int ty = 0; ty < height; ++ty) {
+        const int rowStart = static_cast<int>(static_cast<int64_t>(ty) * source.height / height);
+        const int rowEnd = static_cast<int>(static_cast<int64_t>(ty + 1) * source.height / height);
+
+        std::fill(sums.begin(), sums.end(), 0u);
+        for (int sy = rowStart; sy < rowEnd; ++sy) {
+            const uint8_t* row = source.Row(sy);
+            for (int tx = 0; tx < width; ++tx) {
+                const uint8_t* pixel = row + static_cast<size_t>(columnStart[tx]) * bpp;
+                const uint8_t* end = row + static_cast<size_t>(columnStart[tx + 1]) * bpp;
+                uint32_t* sum = &sums[static_cast<size_t>(tx) * channelCount];
+                for (; pixel < end; pixel += bpp) {
+                    for (int c = 0; c < channelCount; ++c) {
+                        sum[c] += pixel[offsets[c]];
+                    }
+                }
+            }
+        }
+
+        uint8_t* dst = &target.data[static_cast<size_t>(ty) * target.stride];
+        for (int tx = 0; tx < width; ++tx) {
+            const uint32_t area = static_cast<uint32_t>(
+                (columnStart[tx + 1] - columnStart[tx]) * (rowEnd - rowStart));
+            for (int c = 0; c < channelCount; ++c) {
+                dst[tx * channelCount + c] = static_cast<uint8_t>(
+                    (sums[static_cast<size_t>(tx) * channelCount + c] + area / 2) / area);
+            }
+        }
+    }
+
+    return true;
+}
+
+namespace {
+
+uint32_t Crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> entries(256);
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+        return entries;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void AppendChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& payload) {
+    AppendBigEndian(png, static_cast<uint32_t>(payload.size()));
+    const size_t typeOffset = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), payload.begin(), payload.end());
+    AppendBigEndian(png, Crc32(&png[typeOffset], png.size() - typeOffset));
+}
+
+// zlib stream of the filtered scanlines
+bool Deflate(const std::vector<uint8_t>& raw, std::vector<uint8_t>& out) {
+#ifdef HAVE_ZLIB
+    uLongf length = compressBound(static_cast<uLong>(raw.size()));
+    out.resize(length);
+    if (compress2(out.data(), &length, raw.data(), static_cast<uLong>(raw.size()), 6) != Z_OK) {
+        return false;
+    }
+    out.resize(length);
+    return true;
+#else
+    // Stored (uncompressed) deflate blocks: still a valid PNG, just larger
+    const size_t maxBlock = 65535;
+    out.clear();
+    out.reserve(raw.size() + raw.size() / maxBlock * 5 + 16);
+    out.push_back(0x78);
+    out.push_back(0x01);
+    size_t offset = 0;
+    do {
+        const size_t length = std::min(maxBlock, raw.size() - offset);
+        const bool last = offset + length == raw.size();
+        out.push_back(last ? 1 : 0);
+        out.push_back(static_cast<uint8_t>(length));
+        out.push_back(static_cast<uint8_t>(length >> 8));
+        out.push_back(static_cast<uint8_t>(~length));
+        out.push_back(static_cast<uint8_t>(~length >> 8));
+        out.insert(out.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    AppendBigEndian(out, (b << 16) | a);
+    return true;
+#endif
+}
+
+} // namespace
+
+// Encode as 8-bit RGB or grayscale PNG. Each scanline takes whichever of
+// the None/Sub/Up filters leaves the smallest residuals.
+bool EncodePNG(const FrameView& frame, std::vector<uint8_t>& png) {
+    if (!frame.IsValid()) {
+        return false;
+    }
+
+    const int channelCount = frame.bytes_per_pixel >= 3 ? 3 : 1;
+    const ChannelOffsets channels = GetChannelOffsets(frame.format);
+    const int offsets[3] = {channels.r, channels.g, channels.b};
+    const size_t rowBytes = static_cast<size_t>(frame.width) * channelCount;
+
+    std::vector<uint8_t> raw(static_cast<size_t>(frame.height) * (rowBytes + 1));
+    std::vector<uint8_t> previous(rowBytes, 0);
+    std::vector<uint8_t> current(rowBytes);
+    std::vector<uint8_t> candidates[3] = {std::vector<uint8_t>(rowBytes),
+                                          std::vector<uint8_t>(rowBytes),
+                                          std::vector<uint8_t>(rowBytes)};
+
+    for (int y = 0; y < frame.height; ++y) {
+        const uint8_t* src = frame.Row(y);
+        for (int x = 0; x < frame.width; ++x) {
+            for (int c = 0; c < channelCount; ++c) {
+                current[static_cast<size_t>(x) * channelCount + c] = src[offsets[c]];
+            }
+            src += frame.bytes_per_pixel;
+        }
+
+        uint64_t costs[3] = {0, 0, 0};
+        for (size_t i = 0; i < rowBytes; ++i) {
+            const uint8_t left = i >= static_cast<size_t>(channelCount) ? current[i - channelCount] : 0;
+            candidates[0][i] = current[i];
+            candidates[1][i] = static_cast<uint8_t>(current[i] - left);
+            candidates[2][i] = static_cast<uint8_t>(current[i] - previous[i]);
+            for (int f = 0; f < 3; ++f) {
+                costs[f] += std::abs(static_cast<int8_t>(candidates[f][i]));
+            }
+        }
+        const int filter = static_cast<int>(std::min_element(costs, costs + 3) - costs);
+
+        uint8_t* dst = &raw[static_cast<size_t>(y) * (rowBytes + 1)];
+        dst[0] = static_cast<uint8_t>(filter);
+        std::memcpy(dst + 1, candidates[filter].data(), rowBytes);
+        previous.swap(current);
+    }
+
+    std::vector<uint8_t> compressed;
+    if (!Deflate(raw, compressed)) {
+        return false;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    png.assign(signature, signature + 8);
+
+    std::vector<uint8_t> header;
+    AppendBigEndian(header, static_cast<uint32_t>(frame.width));
+    AppendBigEndian(header, static_cast<uint32_t>(frame.height));
+    header.push_back(8);                            // Bit depth
+    header.push_back(channelCount == 3 ? 2 : 0);    // Colour type: RGB or gray
+    header.push_back(0);                            // Compression
+    header.push_back(0);                            // Filter method
+    header.push_back(0);                            // No interlace
+    AppendChunk(png, "IHDR", header);
+    AppendChunk(png, "IDAT", compressed);
+    AppendChunk(png, "IEND", {});
+    return true;
+}
+
+// Largest level first, each smaller level resized from the one before it,
+// so the full frame is only read once
+bool BuildThumbnailPyramid(const FrameView& frame, std::vector<ThumbnailLevel>& levels) {
+    levels.clear();
+    if (!frame.IsValid()) {
+        return false;
+    }
+
+    std::vector<int> widths;
+    for (int width : THUMBNAIL_WIDTHS) {
+        if (width <= frame.width) {
+            widths.push_back(width);
+        }
+    }
+    if (widths.empty()) {
+        widths.push_back(frame.width);
+    }
+
+    CaptureFrame previous;
+    FrameView source = frame;
+    for (auto it = widths.rbegin(); it != widths.rend(); ++it) {
+        const int width = *it;
+        const int height = std::max(1, static_cast<int>(
+            (static_cast<int64_t>(frame.height) * width + frame.width / 2) / frame.width));
+
+        CaptureFrame resized;
+        if (!ResizeFrame(source, resized, width, std::min(height, source.height))) {
+            return false;
+        }
+
+        ThumbnailLevel level;
+        level.width = resized.width;
+        level.height = resized.height;
+        if (!EncodePNG(resized, level.png)) {
+            return false;
+        }
+        levels.push_back(std::move(level));
+
+        previous = std::move(resized);
+        source = FrameView(previous);
+    }
+
+    std::reverse(levels.begin(), levels.end());
     return true;
 }
 
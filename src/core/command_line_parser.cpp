@@ -248,11 +248,12 @@ void CommandLineParser::PrintHelp() const {
         }
     }
     
-    std::cout << "\nExamples:\n";
-    std::cout << "  " << m_program_name << " --help\n";
-    std::cout << "  " << m_program_name << " --config /path/to/config.conf\n";
-    std::cout << "  " << m_program_name << " --daemon --web-port 8080\n";
-    std::cout << "  " << m_program_name << " --no-gui --ocr-mode fast\n";
+    if (!m_examples.empty()) {
+        std::cout << "\nExamples:\n";
+        for (const auto& example : m_examples) {
+            std::cout << "  " << m_program_name << " " << example << "\n";
+        }
+    }
     std::cout << "\n";
 }
 
@@ -362,6 +363,23 @@ void WorkAssistantCommandLine::SetupStandardOptions(CommandLineParser& parser) {
     // OCR and AI configuration
     parser.AddOption("", OCR_MODE, "OCR mode (fast, accurate, multimodal, auto)", true);
     parser.AddOption("m", AI_MODEL, "AI model file path", true);
+
+    // Profiling harness
+    parser.AddOption("", RECORD_CAPTURE, "Record captured frames and window events to a file", true);
+    parser.AddOption("", REPLAY_CAPTURE, "Replay a capture recording instead of the screen", true);
+    parser.AddOption("", REPLAY_SPEED, "Replay speed relative to the recording (0 = as fast as possible)", true);
+
+    // Multi-workstation aggregation
+    parser.AddOption("", AGGREGATOR, "Run as an aggregator of workstation deltas (no capture)");
+    parser.AddOption("", REPLICATE_TO, "Replicate to an aggregator (http://host:port)", true);
+    parser.AddOption("", WORKSTATION_ID, "Name of this workstation on the aggregator (default: host name)", true);
+    parser.AddOption("", REPLICATE_TEXT, "Also replicate window titles, extracted text and keywords");
+    parser.AddOption("", REPLICATION_TOKEN, "Shared secret between workstations and the aggregator (or WA_REPLICATION_TOKEN)", true);
+
+    parser.AddExample("--help");
+    parser.AddExample("--config /path/to/config.conf");
+    parser.AddExample("--daemon --web-port 8080");
+    parser.AddExample("--no-gui --ocr-mode fast");
     
     // Add validators for specific options
     auto port_validator = [](const std::string& value) {
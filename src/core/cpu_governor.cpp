@@ -0,0 +1,538 @@
+#include "cpu_governor.h"
+#include "memory_governor.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace work_assistant {
+
+namespace {
+
+const char* CGROUP_ROOT = "/sys/fs/cgroup";
+
+// Minimum scale change worth waking consumers for
+constexpr double SCALE_NOTIFY_STEP = 0.05;
+
+std::string CgroupDirectory(const std::string& mount, const std::string& path) {
+    return std::string(CGROUP_ROOT) + mount + (path == "/" ? "" : path);
+}
+
+// Parses "key value" lines such as cpu.stat
+std::map<std::string, uint64_t> ReadKeyValueFile(const std::string& path) {
+    std::map<std::string, uint64_t> values;
+    std::ifstream file(path);
+    std::string key;
+    uint64_t value;
+    while (file >> key >> value) {
+        values[key] = value;
+    }
+    return values;
+}
+
+std::string ParentCgroup(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return (slash == 0 || slash == std::string::npos) ? "/" : path.substr(0, slash);
+}
+
+bool IsNumeric(const char* name) {
+    if (!*name) {
+        return false;
+    }
+    for (; *name; ++name) {
+        if (*name < '0' || *name > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HoldsCamera(const std::string& pid) {
+    std::string fd_dir = "/proc/" + pid + "/fd";
+    DIR* dir = opendir(fd_dir.c_str());
+    if (!dir) {
+        return false;  // Other users' processes are not inspectable
+    }
+    bool found = false;
+    char target[256];
+    while (struct dirent* entry = readdir(dir)) {
+        if (!IsNumeric(entry->d_name)) {
+            continue;
+        }
+        std::string link = fd_dir + "/" + entry->d_name;
+        ssize_t len = readlink(link.c_str(), target, sizeof(target) - 1);
+        if (len > 0) {
+            target[len] = '\0';
+            if (std::string(target).compare(0, 10, "/dev/video") == 0) {
+                found = true;
+                break;
+            }
+        }
+    }
+    closedir(dir);
+    return found;
+}
+
+} // namespace
+
+namespace cpu_utils {
+
+std::string BudgetModeToString(CpuBudgetMode mode) {
+    switch (mode) {
+        case CpuBudgetMode::NORMAL:    return "normal";
+        case CpuBudgetMode::THROTTLED: return "throttled";
+        case CpuBudgetMode::YIELDING:  return "yielding";
+    }
+    return "unknown";
+}
+
+bool ReadCgroupCpuStat(CgroupCpuStat& stat) {
+    stat = CgroupCpuStat();
+
+    std::string unified = memory_utils::FindCgroupPath("");
+    if (!unified.empty()) {
+        auto values = ReadKeyValueFile(CgroupDirectory("", unified) + "/cpu.stat");
+        if (!values.empty()) {
+            stat.usage_usec = values["usage_usec"];
+            stat.nr_periods = values["nr_periods"];
+            stat.nr_throttled = values["nr_throttled"];
+            stat.throttled_usec = values["throttled_usec"];
+            return true;
+        }
+    }
+
+    // cgroup v1: throttling lives in the cpu controller (nanoseconds)
+    std::string v1 = memory_utils::FindCgroupPath("cpu");
+    if (!v1.empty()) {
+        for (const char* mount : {"/cpu", "/cpu,cpuacct"}) {
+            auto values = ReadKeyValueFile(CgroupDirectory(mount, v1) + "/cpu.stat");
+            if (!values.empty()) {
+                stat.nr_periods = values["nr_periods"];
+                stat.nr_throttled = values["nr_throttled"];
+                stat.throttled_usec = values["throttled_time"] / 1000;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+double ReadCgroupCpuQuota() {
+    double quota_cores = 0.0;
+
+    // cgroup v2: "max 100000" or "<quota> <period>"; a parent's limit
+    // applies to all descendants, so keep the tightest one
+    std::string path = memory_utils::FindCgroupPath("");
+    if (!path.empty()) {
+        while (true) {
+            std::ifstream file(CgroupDirectory("", path) + "/cpu.max");
+            std::string quota;
+            uint64_t period = 0;
+            if ((file >> quota >> period) && quota != "max" && period > 0) {
+                double cores = std::strtod(quota.c_str(), nullptr) / period;
+                if (cores > 0.0 && (quota_cores == 0.0 || cores < quota_cores)) {
+                    quota_cores = cores;
+                }
+            }
+            if (path == "/") {
+                break;
+            }
+            path = ParentCgroup(path);
+        }
+        if (quota_cores > 0.0) {
+            return quota_cores;
+        }
+    }
+
+    std::string v1 = memory_utils::FindCgroupPath("cpu");
+    if (!v1.empty()) {
+        for (const char* mount : {"/cpu", "/cpu,cpuacct"}) {
+            std::string dir = CgroupDirectory(mount, v1);
+            std::ifstream quota_file(dir + "/cpu.cfs_quota_us");
+            std::ifstream period_file(dir + "/cpu.cfs_period_us");
+            long long quota = -1, period = 0;
+            if ((quota_file >> quota) && (period_file >> period)) {
+                return (quota > 0 && period > 0) ? static_cast<double>(quota) / period : 0.0;
+            }
+        }
+    }
+    return 0.0;
+}
+
+unsigned int GetOnlineCores() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? static_cast<unsigned int>(cores) : 1;
+}
+
+std::string DetectForegroundLoad(const CpuGovernorConfig& config) {
+    DIR* proc = opendir("/proc");
+    if (!proc) {
+        return "";
+    }
+
+    // Only the session user's own work counts; builds and calls by other
+    // users on a shared machine are not what we are yielding to
+    const std::string self = std::to_string(getpid());
+    const uid_t session_uid = getuid();
+    std::string reason;
+    while (struct dirent* entry = readdir(proc)) {
+        if (!IsNumeric(entry->d_name) || self == entry->d_name) {
+            continue;
+        }
+        std::string pid = entry->d_name;
+        struct stat owner;
+        if (stat(("/proc/" + pid).c_str(), &owner) != 0 || owner.st_uid != session_uid) {
+            continue;
+        }
+        std::ifstream comm_file("/proc/" + pid + "/comm");
+        std::string comm;
+        if (!std::getline(comm_file, comm)) {
+            continue;  // Exited while scanning
+        }
+
+        auto matches = [&comm](const std::vector<std::string>& names) {
+            return std::find(names.begin(), names.end(), comm) != names.end();
+        };
+        if (matches(config.compiler_processes)) {
+            reason = "compile in progress (" + comm + ")";
+        } else if (matches(config.video_call_processes)) {
+            reason = "video call (" + comm + ")";
+        } else if (matches(config.camera_client_processes) && HoldsCamera(pid)) {
+            reason = "camera in use (" + comm + ")";
+        }
+        if (!reason.empty()) {
+            break;
+        }
+    }
+    closedir(proc);
+    return reason;
+}
+
+} // namespace cpu_utils
+
+CpuBudget CpuBudgetPolicy::NextBudget(const CpuGovernorConfig& config, CpuGovernorStatus& sample,
+                                      const std::string& foreground, const CpuBudget& previous,
+                                      std::chrono::steady_clock::time_point now) {
+    CpuBudget next = previous;
+
+    if (!foreground.empty()) {
+        m_lastForeground = now;
+        m_foregroundReason = foreground;
+        next.mode = CpuBudgetMode::YIELDING;
+        sample.reason = foreground;
+        return next;
+    }
+    if (previous.mode == CpuBudgetMode::YIELDING && now - m_lastForeground < config.yield_hold) {
+        sample.reason = "recently " + m_foregroundReason;
+        return next;
+    }
+
+    bool throttled = sample.throttled_periods > 0;
+    bool over_target = sample.process_share > config.target_share;
+    bool system_busy = sample.system_usage_percent >= config.system_busy_percent &&
+                       sample.process_share > config.target_share * config.recovery_ratio;
+
+    if (throttled || over_target || system_busy) {
+        next.scale = std::max(config.min_scale, previous.scale * config.decrease_factor);
+        sample.reason = throttled ? "cgroup throttling"
+                      : over_target ? "over target share" : "system busy";
+    } else if (sample.process_share < config.target_share * config.recovery_ratio) {
+        next.scale = std::min(1.0, previous.scale * config.increase_factor);
+        sample.reason = "within budget";
+    } else {
+        sample.reason = "near target share";
+    }
+
+    next.mode = next.scale < 1.0 ? CpuBudgetMode::THROTTLED : CpuBudgetMode::NORMAL;
+    return next;
+}
+
+class CpuGovernor::Impl {
+public:
+    Impl()
+        : m_running(false)
+        , m_nextHandle(1)
+        , m_notifiedScale(1.0)
+        , m_haveCgroupSample(false) {
+    }
+
+    ~Impl() {
+        Stop();
+    }
+
+    bool Start(const CpuGovernorConfig& config) {
+        if (!config.IsValid()) {
+            std::cerr << "Invalid CPU governor configuration" << std::endl;
+            return false;
+        }
+        if (m_running) {
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_config = config;
+            m_status.target_share = config.target_share;
+        }
+        // Prime the delta-based readings so the first evaluation is meaningful
+        SystemMonitor::GetCPUUsage();
+        SystemMonitor::GetProcessCPUUsage();
+
+        m_running = true;
+        m_thread = std::thread(&Impl::MonitorLoop, this);
+        std::cout << "CPU governor started (target " << config.target_share << "% of capacity)" << std::endl;
+        return true;
+    }
+
+    void Stop() {
+        if (!m_running) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wakeup.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool IsRunning() const {
+        return m_running;
+    }
+
+    int RegisterConsumer(const CpuConsumer& consumer) {
+        CpuBudget budget;
+        int handle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            handle = m_nextHandle++;
+            m_consumers[handle] = consumer;
+            budget = m_status.budget;
+        }
+        if ((budget.mode != CpuBudgetMode::NORMAL || budget.scale < 1.0) && consumer.on_budget_changed) {
+            consumer.on_budget_changed(budget);
+        }
+        return handle;
+    }
+
+    void UnregisterConsumer(int handle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_consumers.erase(handle);
+    }
+
+    CpuBudget GetBudget() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_status.budget;
+    }
+
+    CpuGovernorStatus GetStatus() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CpuGovernorStatus status = m_status;
+        status.consumers.clear();
+        for (const auto& entry : m_consumers) {
+            status.consumers.push_back(entry.second.name);
+        }
+        return status;
+    }
+
+    bool SetTargetShare(double percent) {
+        if (percent <= 0.0 || percent > 100.0) {
+            std::cerr << "Invalid CPU target share: " << percent << std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config.target_share = percent;
+        m_status.target_share = percent;
+        return true;
+    }
+
+    void SetYieldToForeground(bool enabled) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config.yield_to_foreground = enabled;
+    }
+
+    void Evaluate() {
+        // The monitor thread and public callers both evaluate; one at a
+        // time, so consumers see budgets in the order they were decided
+        std::lock_guard<std::mutex> evaluating(m_evaluateMutex);
+        CpuGovernorConfig config;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            config = m_config;
+        }
+
+        // Sampling reads /proc and cgroupfs; keep it outside the lock
+        CpuGovernorStatus sample;
+        sample.target_share = config.target_share;
+        sample.system_usage_percent = SystemMonitor::GetCPUUsage();
+        double process_percent = SystemMonitor::GetProcessCPUUsage();
+
+        unsigned int cores = cpu_utils::GetOnlineCores();
+        sample.cgroup_quota_cores = cpu_utils::ReadCgroupCpuQuota();
+        sample.capacity_cores = sample.cgroup_quota_cores > 0.0
+            ? std::min(sample.cgroup_quota_cores, static_cast<double>(cores))
+            : static_cast<double>(cores);
+        sample.process_share = std::min(100.0, process_percent * cores / sample.capacity_cores);
+
+        CgroupCpuStat cgroup;
+        sample.cgroup_available = cpu_utils::ReadCgroupCpuStat(cgroup);
+
+        std::string foreground = config.yield_to_foreground
+            ? cpu_utils::DetectForegroundLoad(config) : std::string();
+
+        CpuBudget previous;
+        CpuBudget next;
+        std::vector<CpuConsumer> consumers;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (sample.cgroup_available && m_haveCgroupSample) {
+                sample.throttled_periods = cgroup.nr_throttled - std::min(cgroup.nr_throttled, m_lastCgroup.nr_throttled);
+                sample.throttled_usec = cgroup.throttled_usec - std::min(cgroup.throttled_usec, m_lastCgroup.throttled_usec);
+            }
+            m_lastCgroup = cgroup;
+            m_haveCgroupSample = sample.cgroup_available;
+
+            previous = m_status.budget;
+            next = m_policy.NextBudget(config, sample, foreground, previous,
+                                       std::chrono::steady_clock::now());
+
+            sample.budget = next;
+            sample.budget_changes = m_status.budget_changes + (next.mode != previous.mode ? 1 : 0);
+            m_status = sample;
+
+            bool notify = next.mode != previous.mode ||
+                          std::fabs(next.scale - m_notifiedScale) >= SCALE_NOTIFY_STEP ||
+                          (next.scale >= 1.0 && m_notifiedScale < 1.0);
+            if (notify) {
+                m_notifiedScale = next.scale;
+                for (const auto& entry : m_consumers) {
+                    consumers.push_back(entry.second);
+                }
+            }
+        }
+
+        auto& perf = PerformanceMonitor::GetInstance();
+        perf.RecordCounter("cpu_governor.process_share_pct", static_cast<int64_t>(sample.process_share));
+        perf.RecordCounter("cpu_governor.scale_pct", static_cast<int64_t>(next.scale * 100.0));
+        perf.RecordCounter("cpu_governor.mode", static_cast<int64_t>(next.mode));
+        if (sample.throttled_periods > 0) {
+            perf.RecordCounter("cpu_governor.cgroup_throttled_periods", static_cast<int64_t>(sample.throttled_periods));
+        }
+
+        if (consumers.empty()) {
+            return;
+        }
+
+        if (next.mode != previous.mode) {
+            std::cout << "CPU budget " << cpu_utils::BudgetModeToString(previous.mode)
+                      << " -> " << cpu_utils::BudgetModeToString(next.mode)
+                      << " (scale " << next.scale << ", " << sample.reason << ")" << std::endl;
+        }
+
+        // Callbacks may take their own locks; never call them under m_mutex
+        for (const auto& consumer : consumers) {
+            if (!consumer.on_budget_changed) {
+                continue;
+            }
+            try {
+                consumer.on_budget_changed(next);
+            } catch (const std::exception& e) {
+                std::cerr << "CPU consumer '" << consumer.name << "' failed to adapt: "
+                          << e.what() << std::endl;
+            }
+        }
+    }
+
+private:
+    void MonitorLoop() {
+        while (true) {
+            Evaluate();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait_for(lock, m_config.poll_interval, [this]() { return !m_running; });
+            if (!m_running) {
+                break;
+            }
+        }
+    }
+
+    CpuGovernorConfig m_config;
+    std::atomic<bool> m_running;
+    std::map<int, CpuConsumer> m_consumers;
+    int m_nextHandle;
+    CpuGovernorStatus m_status;
+    double m_notifiedScale;
+
+    CgroupCpuStat m_lastCgroup;
+    bool m_haveCgroupSample;
+    CpuBudgetPolicy m_policy;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::mutex m_evaluateMutex;
+    std::condition_variable m_wakeup;
+};
+
+// CpuGovernor public interface
+CpuGovernor& CpuGovernor::GetInstance() {
+    static CpuGovernor instance;
+    return instance;
+}
+
+CpuGovernor::CpuGovernor() : m_impl(std::make_unique<Impl>()) {}
+CpuGovernor::~CpuGovernor() = default;
+
+bool CpuGovernor::Start(const CpuGovernorConfig& config) {
+    return m_impl->Start(config);
+}
+
+void CpuGovernor::Stop() {
+    m_impl->Stop();
+}
+
+bool CpuGovernor::IsRunning() const {
+    return m_impl->IsRunning();
+}
+
+int CpuGovernor::RegisterConsumer(const CpuConsumer& consumer) {
+    return m_impl->RegisterConsumer(consumer);
+}
+
+void CpuGovernor::UnregisterConsumer(int handle) {
+    m_impl->UnregisterConsumer(handle);
+}
+
+CpuBudget CpuGovernor::GetBudget() const {
+    return m_impl->GetBudget();
+}
+
+CpuGovernorStatus CpuGovernor::GetStatus() const {
+    return m_impl->GetStatus();
+}
+
+void CpuGovernor::Evaluate() {
+    m_impl->Evaluate();
+}
+
+bool CpuGovernor::SetTargetShare(double percent) {
+    return m_impl->SetTargetShare(percent);
+}
+
+void CpuGovernor::SetYieldToForeground(bool enabled) {
+    m_impl->SetYieldToForeground(enabled);
+}
+
+} // namespace work_assistant
@@ -0,0 +1,372 @@
+#include "deferred_work_queue.h"
+#include "cpu_governor.h"
+#include "memory_governor.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace work_assistant {
+
+namespace {
+
+// Ids for jobs that could not be persisted; kept clear of SQLite rowids
+constexpr uint64_t MEMORY_JOB_ID_BASE = 1ull << 62;
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+class DeferredWorkQueue::Impl {
+public:
+    Impl()
+        : m_running(false)
+        , m_lastActivityMs(SteadyNowMs())
+        , m_nextMemoryId(MEMORY_JOB_ID_BASE) {
+    }
+
+    ~Impl() {
+        Stop();
+    }
+
+    bool Start(std::shared_ptr<EncryptedStorageManager> storage, const DeferredWorkConfig& config) {
+        if (!config.IsValid()) {
+            std::cerr << "Invalid deferred work configuration" << std::endl;
+            return false;
+        }
+        if (m_running) {
+            return true;
+        }
+
+        std::vector<DeferredJobRecord> restored;
+        if (storage && storage->IsReady()) {
+            restored = storage->GetDeferredJobs();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_config = config;
+            m_storage = storage;
+            m_jobs.insert(m_jobs.end(), restored.begin(), restored.end());
+            m_running = true;
+        }
+        m_thread = std::thread(&Impl::WorkerLoop, this);
+
+        std::cout << "Deferred work queue started (" << restored.size()
+                  << " jobs restored)" << std::endl;
+        return true;
+    }
+
+    void Stop() {
+        if (!m_running) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wakeup.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool IsRunning() const {
+        return m_running;
+    }
+
+    void RegisterHandler(const std::string& kind, DeferredJobHandler handler) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_handlers[kind] = std::move(handler);
+        }
+        m_wakeup.notify_all();
+    }
+
+    uint64_t Enqueue(const std::string& kind, const std::string& payload, int priority) {
+        std::shared_ptr<EncryptedStorageManager> storage;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& job : m_jobs) {
+                if (job.kind == kind && job.payload == payload) {
+                    return job.id;
+                }
+            }
+            storage = m_storage;
+        }
+
+        DeferredJobRecord job;
+        job.enqueued_at = std::chrono::system_clock::now();
+        job.kind = kind;
+        job.payload = payload;
+        job.priority = priority;
+
+        // Storage does its own locking; don't hold ours across the write
+        if (storage) {
+            job.id = storage->StoreDeferredJob(job);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (job.id == 0) {
+                job.id = m_nextMemoryId++;
+            }
+            m_jobs.push_back(job);
+        }
+        m_wakeup.notify_all();
+        return job.id;
+    }
+
+    void NotifyUserActivity() {
+        m_lastActivityMs = SteadyNowMs();
+    }
+
+    void SetIdleTimeSource(std::function<std::chrono::milliseconds()> source) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_idleSource = std::move(source);
+    }
+
+    bool CanRunNow() const {
+        DeferredWorkConfig config;
+        std::function<std::chrono::milliseconds()> idle_source;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            config = m_config;
+            idle_source = m_idleSource;
+        }
+
+        // Never compete with a foreground compile/call or a memory crunch
+        if (CpuGovernor::GetInstance().GetBudget().mode == CpuBudgetMode::YIELDING ||
+            MemoryGovernor::GetInstance().GetLevel() == MemoryPressureLevel::CRITICAL) {
+            return false;
+        }
+
+        std::chrono::milliseconds idle(SteadyNowMs() - m_lastActivityMs);
+        if (idle_source) {
+            auto input_idle = idle_source();
+            if (input_idle.count() >= 0) {
+                idle = std::min(idle, input_idle);
+            }
+        }
+
+        std::chrono::milliseconds required = config.idle_threshold;
+        if (config.run_on_ac_power && SystemMonitor::IsOnACPower()) {
+            required = config.ac_idle_threshold;
+        }
+        return idle >= required;
+    }
+
+    DeferredWorkStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DeferredWorkStatistics stats = m_stats;
+        stats.pending_jobs = m_jobs.size();
+        stats.persistent = m_storage != nullptr;
+        return stats;
+    }
+
+private:
+    // Called with m_mutex held. Highest priority first, then oldest.
+    bool PickNext(DeferredJobRecord& job, DeferredJobHandler& handler) const {
+        const DeferredJobRecord* best = nullptr;
+        for (const auto& candidate : m_jobs) {
+            if (m_handlers.find(candidate.kind) == m_handlers.end()) {
+                continue;  // Handler not registered (yet)
+            }
+            if (!best || candidate.priority > best->priority ||
+                (candidate.priority == best->priority && candidate.enqueued_at < best->enqueued_at)) {
+                best = &candidate;
+            }
+        }
+        if (!best) {
+            return false;
+        }
+        job = *best;
+        handler = m_handlers.at(best->kind);
+        return true;
+    }
+
+    void WorkerLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeup.wait_for(lock, m_config.poll_interval, [this]() { return !m_running; });
+                if (!m_running) {
+                    break;
+                }
+            }
+
+            while (m_running && CanRunNow()) {
+                DeferredJobRecord job;
+                DeferredJobHandler handler;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!PickNext(job, handler)) {
+                        break;
+                    }
+                    m_stats.current_job = job.kind;
+                }
+                bool finished = RunJob(job, handler);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stats.current_job.clear();
+                }
+                if (!finished) {
+                    break;  // Failed or preempted; wait a poll interval before retrying
+                }
+            }
+        }
+    }
+
+    // Runs chunks until the job completes, fails or activity resumes.
+    // Returns true only when the job completed.
+    bool RunJob(DeferredJobRecord& job, const DeferredJobHandler& handler) {
+        bool started = false;
+        while (true) {
+            if (!m_running || !CanRunNow()) {
+                if (started) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stats.preemptions++;
+                    PerformanceMonitor::GetInstance().IncrementCounter("deferred_work.preemptions");
+                }
+                return false;
+            }
+            started = true;
+
+            DeferredJobResult result = DeferredJobResult::FAILED;
+            {
+                PERF_TIMER("deferred_work.chunk");
+                try {
+                    result = handler(job);
+                } catch (const std::exception& e) {
+                    std::cerr << "Deferred job '" << job.kind << "' threw: " << e.what() << std::endl;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.chunks_run++;
+            }
+
+            switch (result) {
+                case DeferredJobResult::MORE:
+                    Persist(job);
+                    continue;
+                case DeferredJobResult::DONE:
+                    Remove(job.id);
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stats.completed_jobs++;
+                    }
+                    return true;
+                case DeferredJobResult::FAILED:
+                    job.attempts++;
+                    if (job.attempts >= m_config.max_attempts) {
+                        std::cerr << "Deferred job '" << job.kind << "' dropped after "
+                                  << job.attempts << " failed attempts" << std::endl;
+                        Remove(job.id);
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stats.failed_jobs++;
+                    } else {
+                        Persist(job);
+                    }
+                    return false;
+            }
+        }
+    }
+
+    // Saves progress so a preempted or interrupted job resumes from its cursor
+    void Persist(const DeferredJobRecord& job) {
+        std::shared_ptr<EncryptedStorageManager> storage;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& entry : m_jobs) {
+                if (entry.id == job.id) {
+                    entry = job;
+                    break;
+                }
+            }
+            storage = m_storage;
+        }
+        if (storage && job.id < MEMORY_JOB_ID_BASE) {
+            storage->UpdateDeferredJob(job);
+        }
+    }
+
+    void Remove(uint64_t id) {
+        std::shared_ptr<EncryptedStorageManager> storage;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(),
+                                        [id](const DeferredJobRecord& job) { return job.id == id; }),
+                         m_jobs.end());
+            storage = m_storage;
+        }
+        if (storage && id < MEMORY_JOB_ID_BASE) {
+            storage->RemoveDeferredJob(id);
+        }
+    }
+
+    DeferredWorkConfig m_config;
+    std::shared_ptr<EncryptedStorageManager> m_storage;
+    std::vector<DeferredJobRecord> m_jobs;
+    std::unordered_map<std::string, DeferredJobHandler> m_handlers;
+    std::function<std::chrono::milliseconds()> m_idleSource;
+    DeferredWorkStatistics m_stats;
+
+    std::atomic<bool> m_running;
+    std::atomic<int64_t> m_lastActivityMs;
+    uint64_t m_nextMemoryId;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+};
+
+// DeferredWorkQueue public interface
+DeferredWorkQueue::DeferredWorkQueue() : m_impl(std::make_unique<Impl>()) {}
+DeferredWorkQueue::~DeferredWorkQueue() = default;
+
+bool DeferredWorkQueue::Start(std::shared_ptr<EncryptedStorageManager> storage,
+                              const DeferredWorkConfig& config) {
+    return m_impl->Start(std::move(storage), config);
+}
+
+void DeferredWorkQueue::Stop() {
+    m_impl->Stop();
+}
+
+bool DeferredWorkQueue::IsRunning() const {
+    return m_impl->IsRunning();
+}
+
+void DeferredWorkQueue::RegisterHandler(const std::string& kind, DeferredJobHandler handler) {
+    m_impl->RegisterHandler(kind, std::move(handler));
+}
+
+uint64_t DeferredWorkQueue::Enqueue(const std::string& kind, const std::string& payload, int priority) {
+    return m_impl->Enqueue(kind, payload, priority);
+}
+
+void DeferredWorkQueue::NotifyUserActivity() {
+    m_impl->NotifyUserActivity();
+}
+
+void DeferredWorkQueue::SetIdleTimeSource(std::function<std::chrono::milliseconds()> source) {
+    m_impl->SetIdleTimeSource(std::move(source));
+}
+
+bool DeferredWorkQueue::CanRunNow() const {
+    return m_impl->CanRunNow();
+}
+
+DeferredWorkStatistics DeferredWorkQueue::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
@@ -0,0 +1,514 @@
+#include "memory_governor.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace work_assistant {
+
+namespace {
+
+const char* CGROUP_ROOT = "/sys/fs/cgroup";
+
+bool ReadSizeFile(const std::string& path, size_t& value, bool& unlimited) {
+    std::ifstream file(path);
+    std::string text;
+    if (!(file >> text)) {
+        return false;
+    }
+    unlimited = (text == "max");
+    if (unlimited) {
+        value = 0;
+        return true;
+    }
+    try {
+        value = static_cast<size_t>(std::stoull(text));
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace memory_utils {
+
+// Path of this process' cgroup for the given v1 controller, or the unified
+// (v2) hierarchy when controller is empty
+std::string FindCgroupPath(const std::string& controller) {
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        // Format: hierarchy-ID:controller-list:path
+        size_t first = line.find(':');
+        size_t second = line.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos) {
+            continue;
+        }
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+
+        if (controller.empty() && line.compare(0, 2, "0:") == 0 && controllers.empty()) {
+            return path;
+        }
+        if (!controller.empty()) {
+            std::stringstream list(controllers);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (item == controller) {
+                    return path;
+                }
+            }
+        }
+    }
+    return "";
+}
+
+std::string PressureLevelToString(MemoryPressureLevel level) {
+    switch (level) {
+        case MemoryPressureLevel::NORMAL:   return "normal";
+        case MemoryPressureLevel::MODERATE: return "moderate";
+        case MemoryPressureLevel::CRITICAL: return "critical";
+    }
+    return "unknown";
+}
+
+bool ReadPressureStall(const std::string& path, double& some_avg10, double& full_avg10) {
+    // Lines look like: "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    bool found = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find("avg10=");
+        if (pos == std::string::npos) {
+            continue;
+        }
+        double value = std::atof(line.c_str() + pos + 6);
+        if (line.compare(0, 4, "some") == 0) {
+            some_avg10 = value;
+            found = true;
+        } else if (line.compare(0, 4, "full") == 0) {
+            full_avg10 = value;
+        }
+    }
+    return found;
+}
+
+bool ReadCgroupMemory(size_t& usage_bytes, size_t& limit_bytes) {
+    usage_bytes = 0;
+    limit_bytes = 0;
+
+    // cgroup v2: walk up from our cgroup and report the most constrained
+    // ancestor, since a parent's memory.max applies to all descendants
+    std::string unified = FindCgroupPath("");
+    if (!unified.empty()) {
+        std::string path = unified;
+        double worst_ratio = -1.0;
+        bool any = false;
+        while (true) {
+            std::string dir = std::string(CGROUP_ROOT) + (path == "/" ? "" : path);
+            size_t usage = 0, limit = 0;
+            bool unlimited = false, dummy = false;
+            if (ReadSizeFile(dir + "/memory.current", usage, dummy) &&
+                ReadSizeFile(dir + "/memory.max", limit, unlimited)) {
+                any = true;
+                if (!unlimited && limit > 0) {
+                    double ratio = static_cast<double>(usage) / limit;
+                    if (ratio > worst_ratio) {
+                        worst_ratio = ratio;
+                        usage_bytes = usage;
+                        limit_bytes = limit;
+                    }
+                } else if (worst_ratio < 0.0 && usage_bytes == 0) {
+                    usage_bytes = usage;
+                }
+            }
+            if (path.empty() || path == "/") {
+                break;
+            }
+            size_t slash = path.find_last_of('/');
+            path = slash == 0 ? "/" : path.substr(0, slash);
+        }
+        if (any) {
+            return true;
+        }
+    }
+
+    // cgroup v1 memory controller
+    std::string v1 = FindCgroupPath("memory");
+    if (!v1.empty()) {
+        std::string dir = std::string(CGROUP_ROOT) + "/memory" + (v1 == "/" ? "" : v1);
+        size_t usage = 0, limit = 0;
+        bool unlimited = false;
+        if (ReadSizeFile(dir + "/memory.usage_in_bytes", usage, unlimited) &&
+            ReadSizeFile(dir + "/memory.limit_in_bytes", limit, unlimited)) {
+            usage_bytes = usage;
+            // v1 reports "no limit" as a page-rounded LONG_MAX
+            size_t total = 0, available = 0;
+            if (ReadMemInfo(total, available) && limit >= total) {
+                limit = 0;
+            }
+            limit_bytes = limit;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReadMemInfo(size_t& total_bytes, size_t& available_bytes) {
+    std::ifstream file("/proc/meminfo");
+    if (!file.is_open()) {
+        return false;
+    }
+
+    total_bytes = 0;
+    available_bytes = 0;
+    std::string key;
+    size_t value_kb;
+    std::string unit;
+    while (file >> key >> value_kb) {
+        std::getline(file, unit);
+        if (key == "MemTotal:") {
+            total_bytes = value_kb * 1024;
+        } else if (key == "MemAvailable:") {
+            available_bytes = value_kb * 1024;
+        }
+        if (total_bytes && available_bytes) {
+            break;
+        }
+    }
+    return total_bytes > 0;
+}
+
+size_t ReadProcessRSS() {
+    std::ifstream file("/proc/self/statm");
+    size_t size_pages = 0, resident_pages = 0;
+    if (!(file >> size_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+} // namespace memory_utils
+
+namespace {
+
+// Highest usage ratio across the cgroup limit, system RAM and our own budget
+double UsageRatio(const MemoryGovernorConfig& config, const MemoryGovernorStatus& sample) {
+    double ratio = 0.0;
+    if (sample.cgroup_limit_bytes > 0) {
+        ratio = std::max(ratio, static_cast<double>(sample.cgroup_usage_bytes) / sample.cgroup_limit_bytes);
+    }
+    if (sample.system_total_bytes > 0) {
+        ratio = std::max(ratio, 1.0 - static_cast<double>(sample.system_available_bytes) /
+                                      sample.system_total_bytes);
+    }
+    if (config.process_budget_mb > 0) {
+        double budget = static_cast<double>(config.process_budget_mb) * 1024 * 1024;
+        ratio = std::max(ratio, sample.process_rss_bytes / budget);
+    }
+    return ratio;
+}
+
+} // namespace
+
+MemoryPressureLevel MemoryPressurePolicy::Classify(const MemoryGovernorConfig& config,
+                                                   const MemoryGovernorStatus& sample, double scale) {
+    double ratio = UsageRatio(config, sample);
+    if (sample.psi_full_avg10 >= config.psi_full_critical * scale ||
+        ratio >= config.usage_ratio_critical * scale) {
+        return MemoryPressureLevel::CRITICAL;
+    }
+    if (sample.psi_some_avg10 >= config.psi_some_moderate * scale ||
+        ratio >= config.usage_ratio_moderate * scale) {
+        return MemoryPressureLevel::MODERATE;
+    }
+    return MemoryPressureLevel::NORMAL;
+}
+
+MemoryPressureLevel MemoryPressurePolicy::NextLevel(const MemoryGovernorConfig& config,
+                                                    const MemoryGovernorStatus& sample,
+                                                    MemoryPressureLevel current,
+                                                    std::chrono::steady_clock::time_point now) {
+    MemoryPressureLevel raw = Classify(config, sample);
+    if (raw > current) {
+        m_calmSince = now;
+        return raw;
+    }
+
+    MemoryPressureLevel calm = Classify(config, sample, 1.0 - config.recovery_margin);
+    if (calm >= current) {
+        m_calmSince = now;
+        return current;
+    }
+    if (now - m_calmSince < config.restore_delay) {
+        return current;
+    }
+    m_calmSince = now;
+    return static_cast<MemoryPressureLevel>(static_cast<int>(current) - 1);
+}
+
+class MemoryGovernor::Impl {
+public:
+    Impl()
+        : m_running(false)
+        , m_level(MemoryPressureLevel::NORMAL)
+        , m_nextHandle(1)
+        , m_overrideEnabled(false)
+        , m_overrideLevel(MemoryPressureLevel::NORMAL) {
+    }
+
+    ~Impl() {
+        Stop();
+    }
+
+    bool Start(const MemoryGovernorConfig& config) {
+        if (!config.IsValid()) {
+            std::cerr << "Invalid memory governor configuration" << std::endl;
+            return false;
+        }
+        if (m_running) {
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_config = config;
+        }
+        m_running = true;
+        m_thread = std::thread(&Impl::MonitorLoop, this);
+        std::cout << "Memory governor started" << std::endl;
+        return true;
+    }
+
+    void Stop() {
+        if (!m_running) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wakeup.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool IsRunning() const {
+        return m_running;
+    }
+
+    int RegisterConsumer(const MemoryConsumer& consumer) {
+        MemoryPressureLevel level;
+        int handle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            handle = m_nextHandle++;
+            m_consumers[handle] = consumer;
+            level = m_level;
+        }
+        if (level != MemoryPressureLevel::NORMAL && consumer.on_level_changed) {
+            consumer.on_level_changed(level);
+        }
+        return handle;
+    }
+
+    void UnregisterConsumer(int handle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_consumers.erase(handle);
+    }
+
+    MemoryPressureLevel GetLevel() const {
+        return m_level;
+    }
+
+    MemoryGovernorStatus GetStatus() const {
+        std::vector<MemoryConsumer> consumers;
+        MemoryGovernorStatus status;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            status = m_status;
+            for (const auto& entry : m_consumers) {
+                consumers.push_back(entry.second);
+            }
+        }
+        status.level = m_level;
+        status.consumers.clear();
+        for (const auto& consumer : consumers) {
+            size_t bytes = consumer.get_usage_bytes ? consumer.get_usage_bytes() : 0;
+            status.consumers.emplace_back(consumer.name, bytes);
+        }
+        return status;
+    }
+
+    void SetOverride(bool enabled, MemoryPressureLevel level) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_overrideEnabled = enabled && level != MemoryPressureLevel::NORMAL;
+            m_overrideLevel = level;
+        }
+        Evaluate();
+    }
+
+    void Evaluate() {
+        // The monitor thread and SetOverride() both evaluate; one at a time,
+        // so consumers see level changes in order
+        std::lock_guard<std::mutex> evaluating(m_evaluateMutex);
+        MemoryGovernorStatus sample = Sample();
+
+        MemoryPressureLevel previous;
+        MemoryPressureLevel next;
+        std::vector<MemoryConsumer> consumers;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            previous = m_level;
+            next = m_overrideEnabled ? m_overrideLevel
+                                     : m_policy.NextLevel(m_config, sample, previous, std::chrono::steady_clock::now());
+
+            sample.level_changes = m_status.level_changes + (next != previous ? 1 : 0);
+            m_status = sample;
+            m_level = next;
+
+            if (next != previous) {
+                for (const auto& entry : m_consumers) {
+                    consumers.push_back(entry.second);
+                }
+            }
+        }
+
+        auto& perf = PerformanceMonitor::GetInstance();
+        perf.RecordMemoryUsage("memory_governor.process_rss", sample.process_rss_bytes);
+        perf.RecordCounter("memory_governor.level", static_cast<int64_t>(next));
+
+        if (next == previous) {
+            return;
+        }
+
+        std::cout << "Memory pressure " << memory_utils::PressureLevelToString(previous)
+                  << " -> " << memory_utils::PressureLevelToString(next)
+                  << " (psi some=" << sample.psi_some_avg10 << " full=" << sample.psi_full_avg10
+                  << ", rss=" << sample.process_rss_bytes / (1024 * 1024) << "MB)" << std::endl;
+
+        // Callbacks may take their own locks; never call them under m_mutex
+        for (const auto& consumer : consumers) {
+            if (!consumer.on_level_changed) {
+                continue;
+            }
+            try {
+                consumer.on_level_changed(next);
+            } catch (const std::exception& e) {
+                std::cerr << "Memory consumer '" << consumer.name << "' failed to adapt: "
+                          << e.what() << std::endl;
+            }
+        }
+    }
+
+private:
+    MemoryGovernorStatus Sample() const {
+        MemoryGovernorStatus sample;
+
+        // Prefer the cgroup's own pressure file so a container sees its
+        // own stalls rather than the host's
+        std::string unified = memory_utils::FindCgroupPath("");
+        if (!unified.empty()) {
+            std::string path = std::string(CGROUP_ROOT) + (unified == "/" ? "" : unified) + "/memory.pressure";
+            sample.psi_available = memory_utils::ReadPressureStall(
+                path, sample.psi_some_avg10, sample.psi_full_avg10);
+        }
+        if (!sample.psi_available) {
+            sample.psi_available = memory_utils::ReadPressureStall(
+                "/proc/pressure/memory", sample.psi_some_avg10, sample.psi_full_avg10);
+        }
+
+        memory_utils::ReadCgroupMemory(sample.cgroup_usage_bytes, sample.cgroup_limit_bytes);
+        memory_utils::ReadMemInfo(sample.system_total_bytes, sample.system_available_bytes);
+        sample.process_rss_bytes = memory_utils::ReadProcessRSS();
+        return sample;
+    }
+
+    void MonitorLoop() {
+        while (true) {
+            Evaluate();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait_for(lock, m_config.poll_interval, [this]() { return !m_running; });
+            if (!m_running) {
+                break;
+            }
+        }
+    }
+
+    MemoryGovernorConfig m_config;
+    std::atomic<bool> m_running;
+    std::atomic<MemoryPressureLevel> m_level;
+    std::map<int, MemoryConsumer> m_consumers;
+    int m_nextHandle;
+    bool m_overrideEnabled;
+    MemoryPressureLevel m_overrideLevel;
+    MemoryPressurePolicy m_policy;
+    MemoryGovernorStatus m_status;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::mutex m_evaluateMutex;
+    std::condition_variable m_wakeup;
+};
+
+// MemoryGovernor public interface
+MemoryGovernor& MemoryGovernor::GetInstance() {
+    static MemoryGovernor instance;
+    return instance;
+}
+
+MemoryGovernor::MemoryGovernor() : m_impl(std::make_unique<Impl>()) {}
+MemoryGovernor::~MemoryGovernor() = default;
+
+bool MemoryGovernor::Start(const MemoryGovernorConfig& config) {
+    return m_impl->Start(config);
+}
+
+void MemoryGovernor::Stop() {
+    m_impl->Stop();
+}
+
+bool MemoryGovernor::IsRunning() const {
+    return m_impl->IsRunning();
+}
+
+int MemoryGovernor::RegisterConsumer(const MemoryConsumer& consumer) {
+    return m_impl->RegisterConsumer(consumer);
+}
+
+void MemoryGovernor::UnregisterConsumer(int handle) {
+    m_impl->UnregisterConsumer(handle);
+}
+
+MemoryPressureLevel MemoryGovernor::GetLevel() const {
+    return m_impl->GetLevel();
+}
+
+MemoryGovernorStatus MemoryGovernor::GetStatus() const {
+    return m_impl->GetStatus();
+}
+
+void MemoryGovernor::Evaluate() {
+    m_impl->Evaluate();
+}
+
+void MemoryGovernor::SetOverride(bool enabled, MemoryPressureLevel level) {
+    m_impl->SetOverride(enabled, level);
+}
+
+} // namespace work_assistant
@@ -63,7 +63,7 @@ public:
         std::cout << "MiniCPM-V Engine shut down" << std::endl;
     }
 
-    OCRDocument ProcessImage(const CaptureFrame& frame) {
+    OCRDocument ProcessImage(const FrameView& frame) {
         if (!m_initialized || !m_model_loaded || !frame.IsValid()) {
             return OCRDocument();
         }
@@ -88,19 +88,27 @@ public:
         return document;
     }
 
-    OCRDocument ProcessImageRegion(const CaptureFrame& frame, int x, int y, int width, int height) {
+    OCRDocument ProcessImageRegion(const FrameView& frame, int x, int y, int width, int height) {
         if (!m_initialized || !m_model_loaded || !frame.IsValid()) {
             return OCRDocument();
         }
 
-        // Create cropped frame (simplified)
-        CaptureFrame cropped_frame = frame; // In real implementation, crop the image
-        return ProcessImage(cropped_frame);
+        FrameView region;
+        if (!capture_utils::CropView(frame, region, x, y, width, height)) {
+            return OCRDocument();
+        }
+
+        // The crop is clamped to the frame, so blocks are offset by where it
+        // actually starts rather than by the requested corner
+        OCRDocument document = ProcessImage(region);
+        ocr_utils::OffsetTextBlocks(document, region.origin_x - frame.origin_x,
+                                    region.origin_y - frame.origin_y);
+        return document;
     }
 
-    std::future<OCRDocument> ProcessImageAsync(const CaptureFrame& frame) {
-        return std::async(std::launch::async, [this, frame]() {
-            return ProcessImage(frame);
+    std::future<OCRDocument> ProcessImageAsync(const FrameView& frame) {
+        return std::async(std::launch::async, [this, view = frame.Retain()]() {
+            return ProcessImage(view);
         });
     }
 
@@ -139,7 +147,7 @@ public:
         return m_config;
     }
 
-    MultimodalResponse AnswerQuestion(const CaptureFrame& frame, const std::string& question) {
+    MultimodalResponse AnswerQuestion(const FrameView& frame, const std::string& question) {
         if (!m_initialized || !m_model_loaded) {
             return MultimodalResponse{"Multimodal capabilities not available", 0.0f};
         }
@@ -156,7 +164,7 @@ public:
         return response;
     }
 
-    MultimodalResponse DescribeImage(const CaptureFrame& frame) {
+    MultimodalResponse DescribeImage(const FrameView& frame) {
         if (!m_initialized || !m_model_loaded) {
             return MultimodalResponse{"Image description not available", 0.0f};
         }
@@ -173,7 +181,7 @@ public:
         return response;
     }
 
-    MultimodalResponse ExtractStructuredData(const CaptureFrame& frame, const std::string& data_type) {
+    MultimodalResponse ExtractStructuredData(const FrameView& frame, const std::string& data_type) {
         if (!m_initialized || !m_model_loaded) {
             return MultimodalResponse{"Structured data extraction not available", 0.0f};
         }
@@ -311,7 +319,7 @@ private:
         }
     }
 
-    MultimodalResponse InferenceWithPrompt(const CaptureFrame& frame, const std::string& prompt) {
+    MultimodalResponse InferenceWithPrompt(const FrameView& frame, const std::string& prompt) {
         // Mock inference with MiniCPM-V
         auto start_time = std::chrono::high_resolution_clock::now();
         
@@ -415,19 +423,34 @@ private:
 // MiniCPM-V utility functions implementation
 namespace minicpm_utils {
 
-bool PrepareImageForModel(const CaptureFrame& input, CaptureFrame& output, int target_size) {
-    // Simple resize logic (mock)
-    output = input;
-    return true;
+bool PrepareImageForModel(const FrameView& input, CaptureFrame& output, int target_size) {
+    // Simple resize logic (mock); channel order is fixed up in the same pass
+    return capture_utils::ConvertFrame(input, output, 3);
 }
 
-bool ValidateImageSize(const CaptureFrame& frame, int max_size) {
+bool ValidateImageSize(const FrameView& frame, int max_size) {
     return (frame.width <= max_size && frame.height <= max_size);
 }
 
-std::vector<uint8_t> EncodeImageForModel(const CaptureFrame& frame) {
-    // Mock image encoding for model input
-    return frame.data;
+std::vector<uint8_t> EncodeImageForModel(const FrameView& frame) {
+    // Mock image encoding for model input: packed RGB, read from the
+    // frame's native layout in a single pass
+    std::vector<uint8_t> encoded;
+    if (!frame.IsValid()) {
+        return encoded;
+    }
+    const ChannelOffsets channels = GetChannelOffsets(frame.format);
+    encoded.resize(static_cast<size_t>(frame.width) * frame.height * 3);
+    uint8_t* dst = encoded.data();
+    for (int y = 0; y < frame.height; ++y) {
+        const uint8_t* src = frame.Row(y);
+        for (int x = 0; x < frame.width; ++x, src += frame.bytes_per_pixel, dst += 3) {
+            dst[0] = src[channels.r];
+            dst[1] = src[channels.g];
+            dst[2] = src[channels.b];
+        }
+    }
+    return encoded;
 }
 
 std::string BuildOCRPrompt(const std::string& language) {
@@ -607,16 +630,16 @@ void MiniCPMVEngine::Shutdown() {
     m_impl->Shutdown();
 }
 
-OCRDocument MiniCPMVEngine::ProcessImage(const CaptureFrame& frame) {
+OCRDocument MiniCPMVEngine::ProcessImage(const FrameView& frame) {
     return m_impl->ProcessImage(frame);
 }
 
-OCRDocument MiniCPMVEngine::ProcessImageRegion(const CaptureFrame& frame,
+OCRDocument MiniCPMVEngine::ProcessImageRegion(const FrameView& frame,
                                               int x, int y, int width, int height) {
     return m_impl->ProcessImageRegion(frame, x, y, width, height);
 }
 
-std::future<OCRDocument> MiniCPMVEngine::ProcessImageAsync(const CaptureFrame& frame) {
+std::future<OCRDocument> MiniCPMVEngine::ProcessImageAsync(const FrameView& frame) {
     return m_impl->ProcessImageAsync(frame);
 }
 
@@ -652,15 +675,15 @@ MiniCPMVConfig MiniCPMVEngine::GetMiniCPMConfig() const {
     return m_impl->GetMiniCPMConfig();
 }
 
-MultimodalResponse MiniCPMVEngine::AnswerQuestion(const CaptureFrame& frame, const std::string& question) {
+MultimodalResponse MiniCPMVEngine::AnswerQuestion(const FrameView& frame, const std::string& question) {
     return m_impl->AnswerQuestion(frame, question);
 }
 
-MultimodalResponse MiniCPMVEngine::DescribeImage(const CaptureFrame& frame) {
+MultimodalResponse MiniCPMVEngine::DescribeImage(const FrameView& frame) {
     return m_impl->DescribeImage(frame);
 }
 
-MultimodalResponse MiniCPMVEngine::ExtractStructuredData(const CaptureFrame& frame, const std::string& data_type) {
+MultimodalResponse MiniCPMVEngine::ExtractStructuredData(const FrameView& frame, const std::string& data_type) {
     return m_impl->ExtractStructuredData(frame, data_type);
 }
 
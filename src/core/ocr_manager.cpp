@@ -1,6 +1,7 @@
 #include "ocr_engine.h"
 #include "paddle_ocr_engine.h"
 #include "minicpm_v_engine.h"
+#include "performance_monitor.h"
 #include <iostream>
 #include <algorithm>
 #include <regex>
@@ -8,6 +9,7 @@
 #include <chrono>
 #include <sstream>
 #include <set>
+#include <mutex>
 
 namespace work_assistant {
 
@@ -49,7 +51,7 @@ std::vector<OCREngineFactory::EngineType> OCREngineFactory::GetAvailableEngines(
 // Dual-mode OCR Manager implementation
 class OCRManager::Impl {
 public:
-    Impl() : m_initialized(false), m_current_mode(OCRMode::AUTO), m_statistics{} {}
+    Impl() : m_initialized(false), m_current_mode(OCRMode::AUTO), m_defer_secondary(false), m_statistics{} {}
 
     bool Initialize(OCREngineFactory::EngineType engineType) {
         if (m_initialized) {
@@ -74,11 +76,19 @@ public:
             return false;
         }
 
-        // Try to initialize secondary engine for fallback
-        InitializeSecondaryEngine();
+        {
+            std::lock_guard<std::mutex> lock(m_engine_mutex);
+            m_current_options = options;
+        }
+
+        // Try to initialize secondary engine for fallback. When deferred the
+        // caller loads it later via LoadDeferredEngines() so startup is not
+        // blocked on the multimodal model.
+        if (!m_defer_secondary) {
+            InitializeSecondaryEngine();
+        }
 
         m_initialized = true;
-        m_current_options = options;
         
         std::cout << "Dual-mode OCR Manager initialized with " 
                   << m_primary_engine->GetEngineInfo() << std::endl;
@@ -146,29 +156,36 @@ public:
             return;
         }
 
-        if (m_primary_engine) {
-            m_primary_engine->Shutdown();
-            m_primary_engine.reset();
+        std::shared_ptr<IOCREngine> primary, secondary;
+        {
+            std::lock_guard<std::mutex> lock(m_engine_mutex);
+            primary = std::move(m_primary_engine);
+            secondary = std::move(m_secondary_engine);
         }
-
-        if (m_secondary_engine) {
-            m_secondary_engine->Shutdown();
-            m_secondary_engine.reset();
+        if (primary) {
+            primary->Shutdown();
+        }
+        if (secondary) {
+            secondary->Shutdown();
         }
 
         m_initialized = false;
         std::cout << "Dual-mode OCR Manager shut down" << std::endl;
     }
 
-    OCRDocument ExtractText(const CaptureFrame& frame) {
-        if (!m_initialized || !m_primary_engine) {
+    OCRDocument ExtractText(const FrameView& frame) {
+        if (!m_initialized) {
             return OCRDocument();
         }
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
-        // Choose engine based on current mode
-        IOCREngine* engine = SelectEngine(frame);
+        // Choose engine based on current mode; the reference keeps it alive
+        // if it is swapped out meanwhile
+        std::shared_ptr<IOCREngine> engine = SelectEngine(frame);
+        if (!engine) {
+            return OCRDocument();
+        }
         
         OCRDocument document = engine->ProcessImage(frame);
         document.timestamp = std::chrono::system_clock::now();
@@ -182,14 +199,42 @@ public:
         return document;
     }
 
-    std::future<OCRDocument> ExtractTextAsync(const CaptureFrame& frame) {
-        if (!m_initialized || !m_primary_engine) {
+    OCRDocument ExtractText(const FrameView& frame, int screenX, int screenY) {
+        std::shared_ptr<ITextSource> source;
+        {
+            std::lock_guard<std::mutex> lock(m_source_mutex);
+            source = m_text_source;
+        }
+        if (source && frame.IsValid()) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            OCRDocument document;
+            if (source->ExtractText(screenX, screenY, frame.width, frame.height, document)) {
+                ocr_utils::OffsetTextBlocks(document, -screenX, -screenY);
+                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::high_resolution_clock::now() - start_time);
+                document.processing_time = duration;
+                UpdateStatistics(document, duration.count());
+                PerformanceMonitor::GetInstance().IncrementCounter("ocr.text_source_hits");
+                return document;
+            }
+            PerformanceMonitor::GetInstance().IncrementCounter("ocr.text_source_fallbacks");
+        }
+        return ExtractText(frame);
+    }
+
+    void SetTextSource(std::shared_ptr<ITextSource> source) {
+        std::lock_guard<std::mutex> lock(m_source_mutex);
+        m_text_source = std::move(source);
+    }
+
+    std::future<OCRDocument> ExtractTextAsync(const FrameView& frame) {
+        std::shared_ptr<IOCREngine> engine = m_initialized ? SelectEngine(frame) : nullptr;
+        if (!engine) {
             std::promise<OCRDocument> promise;
             promise.set_value(OCRDocument());
             return promise.get_future();
         }
 
-        IOCREngine* engine = SelectEngine(frame);
         return engine->ProcessImageAsync(frame);
     }
 
@@ -206,40 +251,28 @@ public:
     }
 
     // Multimodal capabilities (MiniCPM-V only)
-    std::string AnswerQuestion(const CaptureFrame& frame, const std::string& question) {
-        if (!EnsureMiniCPMVEngine()) {
-            return "Multimodal capabilities not available";
-        }
-
-        auto* minicpm_engine = dynamic_cast<MiniCPMVEngine*>(GetMiniCPMVEngine());
+    std::string AnswerQuestion(const FrameView& frame, const std::string& question) {
+        auto minicpm_engine = GetMultimodalEngine();
         if (!minicpm_engine) {
-            return "MiniCPM-V engine not available";
+            return "Multimodal capabilities not available";
         }
 
         auto response = minicpm_engine->AnswerQuestion(frame, question);
         return response.text_content;
     }
 
-    std::string DescribeImage(const CaptureFrame& frame) {
-        if (!EnsureMiniCPMVEngine()) {
-            return "Image description not available";
-        }
-
-        auto* minicpm_engine = dynamic_cast<MiniCPMVEngine*>(GetMiniCPMVEngine());
+    std::string DescribeImage(const FrameView& frame) {
+        auto minicpm_engine = GetMultimodalEngine();
         if (!minicpm_engine) {
-            return "MiniCPM-V engine not available";
+            return "Image description not available";
         }
 
         auto response = minicpm_engine->DescribeImage(frame);
         return response.text_content;
     }
 
-    std::vector<std::string> ExtractStructuredData(const CaptureFrame& frame, const std::string& dataType) {
-        if (!EnsureMiniCPMVEngine()) {
-            return {};
-        }
-
-        auto* minicpm_engine = dynamic_cast<MiniCPMVEngine*>(GetMiniCPMVEngine());
+    std::vector<std::string> ExtractStructuredData(const FrameView& frame, const std::string& dataType) {
+        auto minicpm_engine = GetMultimodalEngine();
         if (!minicpm_engine) {
             return {};
         }
@@ -248,7 +281,7 @@ public:
         return response.detected_elements;
     }
 
-    bool ContainsText(const CaptureFrame& frame, const std::string& searchText) {
+    bool ContainsText(const FrameView& frame, const std::string& searchText) {
         OCRDocument document = ExtractText(frame);
         std::string text = document.GetOrderedText();
         
@@ -291,143 +324,241 @@ public:
     }
 
     void SetLanguage(const std::string& language) {
-        m_current_options.language = language;
-        if (m_primary_engine) {
-            m_primary_engine->SetOptions(m_current_options);
-        }
-        if (m_secondary_engine) {
-            m_secondary_engine->SetOptions(m_current_options);
-        }
+        UpdateOptions([&language](OCROptions& options) { options.language = language; });
     }
 
     void SetConfidenceThreshold(float threshold) {
-        m_current_options.confidence_threshold = threshold;
-        if (m_primary_engine) {
-            m_primary_engine->SetOptions(m_current_options);
-        }
-        if (m_secondary_engine) {
-            m_secondary_engine->SetOptions(m_current_options);
-        }
+        UpdateOptions([threshold](OCROptions& options) { options.confidence_threshold = threshold; });
     }
 
     void EnablePreprocessing(bool enable) {
-        m_current_options.auto_preprocess = enable;
-        if (m_primary_engine) {
-            m_primary_engine->SetOptions(m_current_options);
-        }
-        if (m_secondary_engine) {
-            m_secondary_engine->SetOptions(m_current_options);
-        }
+        UpdateOptions([enable](OCROptions& options) { options.auto_preprocess = enable; });
     }
 
     void SetOptions(const OCROptions& options) {
-        m_current_options = options;
-        if (m_primary_engine) {
-            m_primary_engine->SetOptions(options);
-        }
-        if (m_secondary_engine) {
-            m_secondary_engine->SetOptions(options);
-        }
+        UpdateOptions([&options](OCROptions& current) { current = options; });
     }
 
     OCROptions GetOptions() const {
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
         return m_current_options;
     }
 
     void EnableGPU(bool enable) {
-        m_current_options.use_gpu = enable;
-        SetOptions(m_current_options);
+        UpdateOptions([enable](OCROptions& options) { options.use_gpu = enable; });
     }
 
     void SetMaxImageSize(int max_size) {
-        m_current_options.max_image_size = max_size;
-        SetOptions(m_current_options);
+        UpdateOptions([max_size](OCROptions& options) { options.max_image_size = max_size; });
     }
 
     void EnableCaching(bool enable, int ttl_seconds) {
-        m_current_options.enable_caching = enable;
-        m_current_options.cache_ttl_seconds = ttl_seconds;
-        SetOptions(m_current_options);
+        UpdateOptions([enable, ttl_seconds](OCROptions& options) {
+            options.enable_caching = enable;
+            options.cache_ttl_seconds = ttl_seconds;
+        });
     }
 
     OCRManager::Statistics GetStatistics() const {
         return m_statistics;
     }
 
+    void DeferSecondaryEngine(bool defer) {
+        m_defer_secondary = defer;
+    }
+
+    bool LoadDeferredEngines() {
+        if (!m_initialized) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_engine_mutex);
+            if (m_secondary_engine) {
+                return true;
+            }
+        }
+        InitializeSecondaryEngine();
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
+        return m_secondary_engine != nullptr;
+    }
+
+    bool UnloadMultimodalModel() {
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
+        auto* engine = GetLoadedMultimodalEngine();
+        if (!engine) {
+            return false;
+        }
+        engine->UnloadModel();
+        std::cout << "Multimodal OCR model unloaded" << std::endl;
+        return true;
+    }
+
+    bool ReloadMultimodalModel() {
+        std::shared_ptr<IOCREngine> current;
+        MiniCPMVConfig config;
+        OCROptions options;
+        {
+            std::lock_guard<std::mutex> lock(m_engine_mutex);
+            current = GetMiniCPMVEngine();
+            if (!current) {
+                return false;
+            }
+            auto* engine = static_cast<MiniCPMVEngine*>(current.get());
+            if (engine->IsModelLoaded()) {
+                return true;
+            }
+            config = engine->GetMiniCPMConfig();
+            options = m_current_options;
+        }
+
+        // Loading takes about a second; OCR threads keep selecting engines
+        // meanwhile and see the new one only once it is ready
+        auto fresh = std::make_shared<MiniCPMVEngine>();
+        fresh->SetMiniCPMConfig(config);
+        if (!fresh->Initialize(options) ||
+            (!fresh->IsModelLoaded() && !fresh->LoadModel(config.model_path))) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
+        if (m_primary_engine == current) {
+            m_primary_engine = fresh;
+        } else if (m_secondary_engine == current) {
+            m_secondary_engine = fresh;
+        } else {
+            return false;   // Shut down or replaced meanwhile
+        }
+        return true;
+    }
+
+    bool IsMultimodalModelLoaded() {
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
+        return GetLoadedMultimodalEngine() != nullptr;
+    }
+
     void ResetStatistics() {
         m_statistics = OCRManager::Statistics{};
     }
 
 private:
     void InitializeSecondaryEngine() {
+        std::shared_ptr<IOCREngine> primary;
+        OCROptions options;
+        {
+            std::lock_guard<std::mutex> lock(m_engine_mutex);
+            primary = m_primary_engine;
+            options = m_current_options;
+        }
+
         // Try to initialize the other engine type for fallback
-        if (dynamic_cast<PaddleOCREngine*>(m_primary_engine.get())) {
+        std::unique_ptr<IOCREngine> engine;
+        if (dynamic_cast<PaddleOCREngine*>(primary.get())) {
             // Primary is PaddleOCR, try MiniCPM-V as secondary
-            m_secondary_engine = std::make_unique<MiniCPMVEngine>();
+            engine = std::make_unique<MiniCPMVEngine>();
         } else {
             // Primary is MiniCPM-V, try PaddleOCR as secondary
-            m_secondary_engine = std::make_unique<PaddleOCREngine>();
+            engine = std::make_unique<PaddleOCREngine>();
         }
 
-        if (m_secondary_engine) {
-            OCROptions options = m_current_options;
-            if (!m_secondary_engine->Initialize(options)) {
-                m_secondary_engine.reset(); // Failed to initialize, remove it
-            }
+        if (!engine->Initialize(options)) {
+            return; // Failed to initialize, run without fallback
+        }
+
+        // May run after startup while frames are being processed
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
+        m_secondary_engine = std::move(engine);
+    }
+
+    // Edits the options and pushes the result to both engines, which are
+    // called outside the lock
+    template <typename Edit>
+    void UpdateOptions(Edit edit) {
+        std::shared_ptr<IOCREngine> primary, secondary;
+        OCROptions options;
+        {
+            std::lock_guard<std::mutex> lock(m_engine_mutex);
+            edit(m_current_options);
+            options = m_current_options;
+            primary = m_primary_engine;
+            secondary = m_secondary_engine;
+        }
+        if (primary) {
+            primary->SetOptions(options);
         }
+        if (secondary) {
+            secondary->SetOptions(options);
+        }
+    }
+
+    std::shared_ptr<MiniCPMVEngine> GetMultimodalEngine() {
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
+        return std::dynamic_pointer_cast<MiniCPMVEngine>(GetMiniCPMVEngine());
     }
 
-    IOCREngine* SelectEngine(const CaptureFrame& frame) {
+    // Called with m_engine_mutex held
+    MiniCPMVEngine* GetLoadedMultimodalEngine() {
+        auto* engine = dynamic_cast<MiniCPMVEngine*>(GetMiniCPMVEngine().get());
+        return (engine && engine->IsModelLoaded()) ? engine : nullptr;
+    }
+
+    std::shared_ptr<IOCREngine> SelectEngine(const FrameView& frame) {
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
         switch (m_current_mode) {
             case OCRMode::FAST:
                 return GetPaddleOCREngine();
             case OCRMode::ACCURATE:
             case OCRMode::MULTIMODAL:
-                return GetMiniCPMVEngine();
+                // The model may have been unloaded under memory pressure
+                if (GetLoadedMultimodalEngine()) {
+                    return GetMiniCPMVEngine();
+                }
+                return GetPaddleOCREngine();
             case OCRMode::AUTO:
                 // Intelligent selection based on image characteristics
                 return SelectEngineIntelligently(frame);
         }
-        return m_primary_engine.get();
+        return m_primary_engine;
     }
 
-    IOCREngine* SelectEngineIntelligently(const CaptureFrame& frame) {
+    // This and the two lookups below are called with m_engine_mutex held
+    std::shared_ptr<IOCREngine> SelectEngineIntelligently(const FrameView& frame) {
         // Simple heuristics for engine selection
-        if (frame.GetDataSize() > 1920 * 1080 * 4) {
+        if (static_cast<size_t>(frame.width) * frame.height * frame.bytes_per_pixel > 1920 * 1080 * 4) {
             // Large image, use fast engine
             return GetPaddleOCREngine();
         }
         
         // Default to primary engine
-        return m_primary_engine.get();
+        return m_primary_engine;
     }
 
-    IOCREngine* GetPaddleOCREngine() {
+    std::shared_ptr<IOCREngine> GetPaddleOCREngine() {
         if (dynamic_cast<PaddleOCREngine*>(m_primary_engine.get())) {
-            return m_primary_engine.get();
+            return m_primary_engine;
         }
         if (dynamic_cast<PaddleOCREngine*>(m_secondary_engine.get())) {
-            return m_secondary_engine.get();
+            return m_secondary_engine;
         }
-        return m_primary_engine.get(); // Fallback
+        return m_primary_engine; // Fallback
     }
 
-    IOCREngine* GetMiniCPMVEngine() {
+    std::shared_ptr<IOCREngine> GetMiniCPMVEngine() {
         if (dynamic_cast<MiniCPMVEngine*>(m_primary_engine.get())) {
-            return m_primary_engine.get();
+            return m_primary_engine;
         }
         if (dynamic_cast<MiniCPMVEngine*>(m_secondary_engine.get())) {
-            return m_secondary_engine.get();
+            return m_secondary_engine;
         }
         return nullptr;
     }
 
     bool EnsurePaddleOCREngine() {
+        std::lock_guard<std::mutex> lock(m_engine_mutex);
         return GetPaddleOCREngine() != nullptr;
     }
 
     bool EnsureMiniCPMVEngine() {
-        return GetMiniCPMVEngine() != nullptr;
+        return GetMultimodalEngine() != nullptr;
     }
 
     void UpdateStatistics(const OCRDocument& document, double processing_time_ms) {
@@ -475,10 +606,15 @@ private:
 private:
     bool m_initialized;
     OCRMode m_current_mode;
-    std::unique_ptr<IOCREngine> m_primary_engine;
-    std::unique_ptr<IOCREngine> m_secondary_engine;
+    // Shared so a caller keeps using an engine that is swapped out under it
+    std::shared_ptr<IOCREngine> m_primary_engine;
+    std::shared_ptr<IOCREngine> m_secondary_engine;
+    mutable std::mutex m_engine_mutex;  // Guards both engine pointers and m_current_options
+    bool m_defer_secondary;
     OCROptions m_current_options;
     OCRManager::Statistics m_statistics;
+    std::shared_ptr<ITextSource> m_text_source;
+    std::mutex m_source_mutex;
 };
 
 // OCRManager public interface
@@ -505,31 +641,39 @@ void OCRManager::Shutdown() {
     m_impl->Shutdown();
 }
 
-OCRDocument OCRManager::ExtractText(const CaptureFrame& frame) {
+OCRDocument OCRManager::ExtractText(const FrameView& frame) {
     return m_impl->ExtractText(frame);
 }
 
-std::future<OCRDocument> OCRManager::ExtractTextAsync(const CaptureFrame& frame) {
+std::future<OCRDocument> OCRManager::ExtractTextAsync(const FrameView& frame) {
     return m_impl->ExtractTextAsync(frame);
 }
 
+OCRDocument OCRManager::ExtractText(const FrameView& frame, int screenX, int screenY) {
+    return m_impl->ExtractText(frame, screenX, screenY);
+}
+
+void OCRManager::SetTextSource(std::shared_ptr<ITextSource> source) {
+    m_impl->SetTextSource(std::move(source));
+}
+
 OCRDocument OCRManager::ExtractWindowText(WindowHandle windowHandle) {
     return m_impl->ExtractWindowText(windowHandle);
 }
 
-std::string OCRManager::AnswerQuestion(const CaptureFrame& frame, const std::string& question) {
+std::string OCRManager::AnswerQuestion(const FrameView& frame, const std::string& question) {
     return m_impl->AnswerQuestion(frame, question);
 }
 
-std::string OCRManager::DescribeImage(const CaptureFrame& frame) {
+std::string OCRManager::DescribeImage(const FrameView& frame) {
     return m_impl->DescribeImage(frame);
 }
 
-std::vector<std::string> OCRManager::ExtractStructuredData(const CaptureFrame& frame, const std::string& dataType) {
+std::vector<std::string> OCRManager::ExtractStructuredData(const FrameView& frame, const std::string& dataType) {
     return m_impl->ExtractStructuredData(frame, dataType);
 }
 
-bool OCRManager::ContainsText(const CaptureFrame& frame, const std::string& searchText) {
+bool OCRManager::ContainsText(const FrameView& frame, const std::string& searchText) {
     return m_impl->ContainsText(frame, searchText);
 }
 
@@ -577,4 +721,24 @@ void OCRManager::ResetStatistics() {
     m_impl->ResetStatistics();
 }
 
+void OCRManager::DeferSecondaryEngine(bool defer) {
+    m_impl->DeferSecondaryEngine(defer);
+}
+
+bool OCRManager::LoadDeferredEngines() {
+    return m_impl->LoadDeferredEngines();
+}
+
+bool OCRManager::UnloadMultimodalModel() {
+    return m_impl->UnloadMultimodalModel();
+}
+
+bool OCRManager::ReloadMultimodalModel() {
+    return m_impl->ReloadMultimodalModel();
+}
+
+bool OCRManager::IsMultimodalModelLoaded() const {
+    return m_impl->IsMultimodalModelLoaded();
+}
+
 } // namespace work_assistant
\ No newline at end of file
@@ -0,0 +1,449 @@
+#include "ocr_scheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace work_assistant {
+
+namespace {
+
+// Score weights; focus terms are scaled by the application's importance
+const double FOCUS_WEIGHT = 4.0;
+const double TITLE_WEIGHT = 2.0;
+const double CARET_WEIGHT = 3.0;
+const double RECENT_WEIGHT = 1.0;
+const double DEFERRAL_WEIGHT = 0.5;
+
+// Recent-change history, in cells relative to the frame size
+const int HEAT_COLUMNS = 16;
+const int HEAT_ROWS = 9;
+const float HEAT_DECAY = 0.9f;
+
+// Past this many pending rects, damage collapses into its bounding box
+const size_t MAX_PENDING_RECTS = 256;
+
+struct Rect {
+    int x = 0, y = 0, width = 0, height = 0;
+
+    int Right() const { return x + width; }
+    int Bottom() const { return y + height; }
+    bool Empty() const { return width <= 0 || height <= 0; }
+    size_t Area() const { return Empty() ? 0 : static_cast<size_t>(width) * height; }
+};
+
+Rect Intersect(const Rect& a, const Rect& b) {
+    Rect r;
+    r.x = std::max(a.x, b.x);
+    r.y = std::max(a.y, b.y);
+    r.width = std::min(a.Right(), b.Right()) - r.x;
+    r.height = std::min(a.Bottom(), b.Bottom()) - r.y;
+    return r.Empty() ? Rect() : r;
+}
+
+Rect Union(const Rect& a, const Rect& b) {
+    Rect r;
+    r.x = std::min(a.x, b.x);
+    r.y = std::min(a.y, b.y);
+    r.width = std::max(a.Right(), b.Right()) - r.x;
+    r.height = std::max(a.Bottom(), b.Bottom()) - r.y;
+    return r;
+}
+
+bool Touches(const Rect& a, const Rect& b) {
+    return a.x <= b.Right() && b.x <= a.Right() && a.y <= b.Bottom() && b.y <= a.Bottom();
+}
+
+// Merge touching rects until none touch
+void MergeRects(std::vector<Rect>& rects) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                if (Touches(rects[i], rects[j])) {
+                    rects[i] = Union(rects[i], rects[j]);
+                    rects.erase(rects.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Split rect into its part inside window and up to four bands outside it
+void SplitByWindow(const Rect& rect, const Rect& window, std::vector<Rect>& out) {
+    Rect inside = Intersect(rect, window);
+    if (inside.Empty() || inside.Area() == rect.Area()) {
+        out.push_back(rect);
+        return;
+    }
+    out.push_back(inside);
+    Rect top{rect.x, rect.y, rect.width, inside.y - rect.y};
+    Rect bottom{rect.x, inside.Bottom(), rect.width, rect.Bottom() - inside.Bottom()};
+    Rect left{rect.x, inside.y, inside.x - rect.x, inside.height};
+    Rect right{inside.Right(), inside.y, rect.Right() - inside.Right(), inside.height};
+    for (const Rect& band : {top, bottom, left, right}) {
+        if (!band.Empty()) {
+            out.push_back(band);
+        }
+    }
+}
+
+} // namespace
+
+class OCRScheduler::Impl {
+public:
+    Impl() : m_msPerMegapixel(m_config.initial_ms_per_megapixel) {}
+
+    void SetConfig(const OCRSchedulerConfig& config) {
+        if (!config.IsValid()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = config;
+    }
+
+    OCRSchedulerConfig GetConfig() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_config;
+    }
+
+    void SetFocusedWindow(const WindowInfo& window) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_focus = Rect{window.x, window.y, window.width, window.height};
+        m_focusProcess = window.process_name;
+    }
+
+    void SetCaretPosition(int x, int y) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_caretX = x;
+        m_caretY = y;
+    }
+
+    void SetApplicationImportance(const std::string& processName, double weight) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_importance[processName] = std::max(0.0, weight);
+    }
+
+    void SetApplicationImportance(const std::unordered_map<std::string, double>& weights) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_importance.clear();
+        for (const auto& [processName, weight] : weights) {
+            m_importance[processName] = std::max(0.0, weight);
+        }
+    }
+
+    void AddDamage(const CaptureFrame& frame) {
+        if (frame.width <= 0 || frame.height <= 0) {
+            return;
+        }
+        const int scale = std::max(1, frame.scale_factor);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        MonitorState& state = m_monitors[frame.monitor_id];
+
+        for (float& cell : state.heat) {
+            cell *= HEAT_DECAY;
+        }
+
+        if (frame.dirty_rects.empty()) {
+            state.wholeFrame = true;
+            state.pending.clear();
+            AddHeat(state, 0.0, 0.0, 1.0, 1.0);
+            return;
+        }
+
+        for (const auto& dirty : frame.dirty_rects) {
+            AddHeat(state,
+                    static_cast<double>(dirty.x) / frame.width,
+                    static_cast<double>(dirty.y) / frame.height,
+                    static_cast<double>(dirty.x + dirty.width) / frame.width,
+                    static_cast<double>(dirty.y + dirty.height) / frame.height);
+            if (!state.wholeFrame) {
+                state.pending.push_back(Rect{dirty.x * scale, dirty.y * scale,
+                                             dirty.width * scale, dirty.height * scale});
+            }
+        }
+
+        if (state.pending.size() > MAX_PENDING_RECTS) {
+            Rect bounds = state.pending.front();
+            for (const Rect& rect : state.pending) {
+                bounds = Union(bounds, rect);
+            }
+            state.pending.assign(1, bounds);
+        }
+    }
+
+    OCRSchedule Plan(int monitorId, int width, int height, int screenX, int screenY) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        OCRSchedule schedule;
+        schedule.budget = m_config.frame_budget;
+        m_stats.passes_planned++;
+        if (width <= 0 || height <= 0) {
+            return schedule;
+        }
+
+        MonitorState& state = m_monitors[monitorId];
+        const Rect frameRect{0, 0, width, height};
+
+        // Accumulated damage, padded, clipped and merged; no damage report
+        // at all (e.g. polling without tracking) means everything
+        std::vector<Rect> rects;
+        if (state.wholeFrame || (state.pending.empty() && !state.seen)) {
+            rects.push_back(frameRect);
+        } else {
+            const int pad = m_config.region_padding;
+            for (const Rect& rect : state.pending) {
+                Rect padded = Intersect(Rect{rect.x - pad, rect.y - pad,
+                                             rect.width + 2 * pad, rect.height + 2 * pad}, frameRect);
+                if (!padded.Empty()) {
+                    rects.push_back(padded);
+                }
+            }
+            MergeRects(rects);
+        }
+        state.pending.clear();
+        state.wholeFrame = false;
+        state.seen = true;
+
+        if (rects.size() > m_config.max_regions) {
+            // Keep the largest; fold the rest into one bounding region
+            std::sort(rects.begin(), rects.end(),
+                      [](const Rect& a, const Rect& b) { return a.Area() > b.Area(); });
+            Rect rest = rects[m_config.max_regions - 1];
+            for (size_t i = m_config.max_regions; i < rects.size(); ++i) {
+                rest = Union(rest, rects[i]);
+            }
+            rects.resize(m_config.max_regions - 1);
+            rects.push_back(rest);
+        }
+
+        // Focus geometry in frame coordinates
+        const Rect window = Intersect(Rect{m_focus.x - screenX, m_focus.y - screenY,
+                                           m_focus.width, m_focus.height}, frameRect);
+        const Rect titleBar = Intersect(Rect{window.x, window.y, window.width,
+                                             m_config.title_bar_height}, window);
+        const bool hasCaret = m_caretX >= 0 && m_caretY >= 0;
+        const int caretX = m_caretX - screenX;
+        const int caretY = m_caretY - screenY;
+        auto importance = m_importance.find(m_focusProcess);
+        const double focusWeight = importance != m_importance.end() ? importance->second : 1.0;
+
+        // Regions straddling the focused window are split so the part
+        // inside it ranks on its own
+        std::vector<OCRRegion> candidates;
+        std::vector<Rect> pieces;
+        for (const Rect& rect : rects) {
+            pieces.clear();
+            if (window.Empty()) {
+                pieces.push_back(rect);
+            } else {
+                SplitByWindow(rect, window, pieces);
+            }
+            for (const Rect& piece : pieces) {
+                candidates.push_back(ToRegion(piece, 0));
+            }
+        }
+
+        // Regions left over from earlier passes, unless new damage covers them
+        for (const OCRRegion& waiting : state.deferred) {
+            Rect rect = Intersect(Rect{waiting.x, waiting.y, waiting.width, waiting.height}, frameRect);
+            bool covered = rect.Empty() || std::any_of(candidates.begin(), candidates.end(),
+                [&rect](const OCRRegion& c) {
+                    return Intersect(Rect{c.x, c.y, c.width, c.height}, rect).Area() == rect.Area();
+                });
+            if (!covered) {
+                candidates.push_back(ToRegion(rect, waiting.deferrals));
+            }
+        }
+        state.deferred.clear();
+
+        for (OCRRegion& region : candidates) {
+            const Rect rect{region.x, region.y, region.width, region.height};
+            double focus = window.Empty() ? 0.0 :
+                static_cast<double>(Intersect(rect, window).Area()) / rect.Area();
+            double title = Intersect(rect, titleBar).Empty() ? 0.0 : 1.0;
+            double caret = 0.0;
+            if (hasCaret) {
+                double dx = std::max({rect.x - caretX, 0, caretX - rect.Right()});
+                double dy = std::max({rect.y - caretY, 0, caretY - rect.Bottom()});
+                caret = std::exp(-std::sqrt(dx * dx + dy * dy) / m_config.caret_radius);
+            }
+            region.score = focusWeight * (FOCUS_WEIGHT * focus + TITLE_WEIGHT * title + CARET_WEIGHT * caret) +
+                           RECENT_WEIGHT * Heat(state, rect, width, height) +
+                           DEFERRAL_WEIGHT * region.deferrals;
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const OCRRegion& a, const OCRRegion& b) { return a.score > b.score; });
+
+        // Rank order until the budget is spent; the best region always runs
+        const double budgetMs = static_cast<double>(m_config.frame_budget.count());
+        bool full = false;
+        for (OCRRegion& region : candidates) {
+            double cost = EstimateMs(region);
+            if (!full && (schedule.regions.empty() || schedule.estimated_ms + cost <= budgetMs)) {
+                schedule.estimated_ms += cost;
+                schedule.regions.push_back(region);
+                continue;
+            }
+            full = true;
+            DeferLocked(state, region, schedule);
+        }
+
+        m_stats.regions_scheduled += schedule.regions.size();
+        return schedule;
+    }
+
+    void Defer(int monitorId, const std::vector<OCRRegion>& regions) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        MonitorState& state = m_monitors[monitorId];
+        OCRSchedule unused;
+        for (const OCRRegion& region : regions) {
+            DeferLocked(state, region, unused);
+        }
+    }
+
+    void ReportRegionTime(const OCRRegion& region, std::chrono::microseconds elapsed) {
+        const double megapixels = std::max(0.01, region.Area() / 1e6);
+        const double measured = elapsed.count() / 1000.0 / megapixels;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_msPerMegapixel = 0.8 * m_msPerMegapixel + 0.2 * measured;
+    }
+
+    OCRSchedulerStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        OCRSchedulerStatistics stats = m_stats;
+        stats.ms_per_megapixel = m_msPerMegapixel;
+        return stats;
+    }
+
+private:
+    struct MonitorState {
+        std::vector<Rect> pending;              // Damage since the last pass
+        bool wholeFrame = false;
+        bool seen = false;                      // Planned at least once
+        std::vector<OCRRegion> deferred;
+        std::vector<float> heat = std::vector<float>(HEAT_COLUMNS * HEAT_ROWS, 0.0f);
+    };
+
+    static OCRRegion ToRegion(const Rect& rect, int deferrals) {
+        OCRRegion region;
+        region.x = rect.x;
+        region.y = rect.y;
+        region.width = rect.width;
+        region.height = rect.height;
+        region.deferrals = deferrals;
+        return region;
+    }
+
+    // Bounds are fractions of the frame size
+    static void AddHeat(MonitorState& state, double left, double top, double right, double bottom) {
+        int c0 = std::clamp(static_cast<int>(left * HEAT_COLUMNS), 0, HEAT_COLUMNS - 1);
+        int c1 = std::clamp(static_cast<int>(std::ceil(right * HEAT_COLUMNS)), c0 + 1, HEAT_COLUMNS);
+        int r0 = std::clamp(static_cast<int>(top * HEAT_ROWS), 0, HEAT_ROWS - 1);
+        int r1 = std::clamp(static_cast<int>(std::ceil(bottom * HEAT_ROWS)), r0 + 1, HEAT_ROWS);
+        for (int r = r0; r < r1; ++r) {
+            for (int c = c0; c < c1; ++c) {
+                state.heat[r * HEAT_COLUMNS + c] += 1.0f;
+            }
+        }
+    }
+
+    // Mean heat under rect relative to the hottest cell, 0..1
+    static double Heat(const MonitorState& state, const Rect& rect, int width, int height) {
+        float hottest = *std::max_element(state.heat.begin(), state.heat.end());
+        if (hottest <= 0.0f) {
+            return 0.0;
+        }
+        int c0 = std::clamp(rect.x * HEAT_COLUMNS / width, 0, HEAT_COLUMNS - 1);
+        int c1 = std::clamp((rect.Right() * HEAT_COLUMNS + width - 1) / width, c0 + 1, HEAT_COLUMNS);
+        int r0 = std::clamp(rect.y * HEAT_ROWS / height, 0, HEAT_ROWS - 1);
+        int r1 = std::clamp((rect.Bottom() * HEAT_ROWS + height - 1) / height, r0 + 1, HEAT_ROWS);
+        double sum = 0.0;
+        for (int r = r0; r < r1; ++r) {
+            for (int c = c0; c < c1; ++c) {
+                sum += state.heat[r * HEAT_COLUMNS + c];
+            }
+        }
+        return sum / ((r1 - r0) * (c1 - c0)) / hottest;
+    }
+
+    double EstimateMs(const OCRRegion& region) const {
+        return region.Area() / 1e6 * m_msPerMegapixel;
+    }
+
+    void DeferLocked(MonitorState& state, OCRRegion region, OCRSchedule& schedule) {
+        if (region.deferrals >= m_config.max_deferrals) {
+            schedule.dropped++;
+            m_stats.regions_dropped++;
+            return;
+        }
+        region.deferrals++;
+        state.deferred.push_back(region);
+        schedule.deferred++;
+        m_stats.regions_deferred++;
+    }
+
+    mutable std::mutex m_mutex;
+    OCRSchedulerConfig m_config;
+    std::map<int, MonitorState> m_monitors;     // By monitor id (-1 for the desktop)
+    Rect m_focus;
+    std::string m_focusProcess;
+    int m_caretX = -1, m_caretY = -1;
+    std::unordered_map<std::string, double> m_importance;
+    double m_msPerMegapixel;
+    OCRSchedulerStatistics m_stats;
+};
+
+OCRScheduler::OCRScheduler() : m_impl(std::make_unique<Impl>()) {}
+OCRScheduler::~OCRScheduler() = default;
+
+void OCRScheduler::SetConfig(const OCRSchedulerConfig& config) {
+    m_impl->SetConfig(config);
+}
+
+OCRSchedulerConfig OCRScheduler::GetConfig() const {
+    return m_impl->GetConfig();
+}
+
+void OCRScheduler::SetFocusedWindow(const WindowInfo& window) {
+    m_impl->SetFocusedWindow(window);
+}
+
+void OCRScheduler::SetCaretPosition(int x, int y) {
+    m_impl->SetCaretPosition(x, y);
+}
+
+void OCRScheduler::SetApplicationImportance(const std::string& processName, double weight) {
+    m_impl->SetApplicationImportance(processName, weight);
+}
+
+void OCRScheduler::SetApplicationImportance(const std::unordered_map<std::string, double>& weights) {
+    m_impl->SetApplicationImportance(weights);
+}
+
+void OCRScheduler::AddDamage(const CaptureFrame& frame) {
+    m_impl->AddDamage(frame);
+}
+
+OCRSchedule OCRScheduler::Plan(int monitorId, int width, int height, int screenX, int screenY) {
+    return m_impl->Plan(monitorId, width, height, screenX, screenY);
+}
+
+void OCRScheduler::Defer(int monitorId, const std::vector<OCRRegion>& regions) {
+    m_impl->Defer(monitorId, regions);
+}
+
+void OCRScheduler::ReportRegionTime(const OCRRegion& region, std::chrono::microseconds elapsed) {
+    m_impl->ReportRegionTime(region, elapsed);
+}
+
+OCRSchedulerStatistics OCRScheduler::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
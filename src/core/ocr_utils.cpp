@@ -1,5 +1,7 @@
 #include "ocr_engine.h"
+#include "screen_capture.h"
 #include <algorithm>
+#include <cmath>
 #include <regex>
 #include <cctype>
 #include <sstream>
@@ -7,22 +9,22 @@
 namespace work_assistant {
 namespace ocr_utils {
 
-bool PreprocessImage(const CaptureFrame& input, CaptureFrame& output, const OCROptions& options) {
-    // Simple implementation - just copy the input to output
-    output = input;
-    return true;
-}
+bool ScaleImage(const FrameView& input, CaptureFrame& output, float scale) {
+    if (!input.IsValid() || scale <= 0.0f) {
+        return false;
+    }
 
-bool ScaleImage(const CaptureFrame& input, CaptureFrame& output, float scale) {
-    // Simple implementation - just copy the input to output
-    output = input;
+    // Integer downscales use the box filter; anything else keeps full size
+    int factor = static_cast<int>(std::lround(1.0f / scale));
+    if (scale < 1.0f && factor > 1) {
+        return capture_utils::DownscaleFrame(input, output, factor);
+    }
+    output = input.ToFrame();
     return true;
 }
 
-bool ConvertToGrayscale(const CaptureFrame& input, CaptureFrame& output) {
-    // Simple implementation - just copy the input to output
-    output = input;
-    return true;
+bool ConvertToGrayscale(const FrameView& input, CaptureFrame& output) {
+    return capture_utils::ConvertFrame(input, output, 1);
 }
 
 bool EnhanceContrast(CaptureFrame& frame, float factor) {
@@ -40,6 +42,42 @@ bool BinarizeImage(CaptureFrame& frame, int threshold) {
     return true;
 }
 
+void OffsetTextBlocks(OCRDocument& document, int dx, int dy) {
+    if (dx == 0 && dy == 0) {
+        return;
+    }
+    for (auto& block : document.text_blocks) {
+        block.x += dx;
+        block.y += dy;
+    }
+}
+
+void AppendDocument(OCRDocument& target, const OCRDocument& part) {
+    if (part.text_blocks.empty()) {
+        target.processing_time += part.processing_time;
+        return;
+    }
+
+    // Confidence stays weighted by block count across the merged parts
+    size_t before = target.text_blocks.size();
+    size_t total = before + part.text_blocks.size();
+    target.overall_confidence = static_cast<float>(
+        (target.overall_confidence * before + part.overall_confidence * part.text_blocks.size()) / total);
+
+    target.text_blocks.insert(target.text_blocks.end(), part.text_blocks.begin(), part.text_blocks.end());
+    std::string text = part.GetOrderedText();
+    if (!text.empty()) {
+        if (!target.full_text.empty()) {
+            target.full_text += "\n";
+        }
+        target.full_text += text;
+    }
+    target.processing_time += part.processing_time;
+    if (part.timestamp > target.timestamp) {
+        target.timestamp = part.timestamp;
+    }
+}
+
 std::string CleanExtractedText(const std::string& text) {
     std::string cleaned = text;
     
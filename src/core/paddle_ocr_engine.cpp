@@ -56,7 +56,7 @@ public:
         std::cout << "PaddleOCR Engine shut down" << std::endl;
     }
 
-    OCRDocument ProcessImage(const CaptureFrame& frame) {
+    OCRDocument ProcessImage(const FrameView& frame) {
         if (!m_initialized || !frame.IsValid()) {
             return OCRDocument();
         }
@@ -82,19 +82,27 @@ public:
         return document;
     }
 
-    OCRDocument ProcessImageRegion(const CaptureFrame& frame, int x, int y, int width, int height) {
+    OCRDocument ProcessImageRegion(const FrameView& frame, int x, int y, int width, int height) {
         if (!m_initialized || !frame.IsValid()) {
             return OCRDocument();
         }
 
-        // Create cropped frame (simplified)
-        CaptureFrame cropped_frame = frame; // In real implementation, crop the image
-        return ProcessImage(cropped_frame);
+        FrameView region;
+        if (!capture_utils::CropView(frame, region, x, y, width, height)) {
+            return OCRDocument();
+        }
+
+        // The crop is clamped to the frame, so blocks are offset by where it
+        // actually starts rather than by the requested corner
+        OCRDocument document = ProcessImage(region);
+        ocr_utils::OffsetTextBlocks(document, region.origin_x - frame.origin_x,
+                                    region.origin_y - frame.origin_y);
+        return document;
     }
 
-    std::future<OCRDocument> ProcessImageAsync(const CaptureFrame& frame) {
-        return std::async(std::launch::async, [this, frame]() {
-            return ProcessImage(frame);
+    std::future<OCRDocument> ProcessImageAsync(const FrameView& frame) {
+        return std::async(std::launch::async, [this, view = frame.Retain()]() {
+            return ProcessImage(view);
         });
     }
 
@@ -196,7 +204,7 @@ private:
         }
     }
 
-    PaddleDetectionResult MockDetection(const CaptureFrame& frame) {
+    PaddleDetectionResult MockDetection(const FrameView& frame) {
         // Simulate text detection
         PaddleDetectionResult result;
 
@@ -268,16 +276,16 @@ private:
 // PaddleOCR utility functions implementation
 namespace paddle_utils {
 
-bool PreprocessImage(const CaptureFrame& input, CaptureFrame& output) {
-    // Simple preprocessing - copy input to output
-    output = input;
-    return true;
+bool PreprocessImage(const FrameView& input, CaptureFrame& output) {
+    // The RGB input tensor is built straight from the capture's native
+    // layout in one pass
+    return capture_utils::ConvertFrame(input, output, 3);
 }
 
-bool ResizeImage(const CaptureFrame& input, CaptureFrame& output, int target_size) {
+bool ResizeImage(const FrameView& input, CaptureFrame& output, int target_size) {
     // Simple resize - copy input to output (mock)
-    output = input;
-    return true;
+    output = input.ToFrame();
+    return output.IsValid();
 }
 
 bool NormalizeImage(CaptureFrame& frame) {
@@ -380,16 +388,16 @@ void PaddleOCREngine::Shutdown() {
     m_impl->Shutdown();
 }
 
-OCRDocument PaddleOCREngine::ProcessImage(const CaptureFrame& frame) {
+OCRDocument PaddleOCREngine::ProcessImage(const FrameView& frame) {
     return m_impl->ProcessImage(frame);
 }
 
-OCRDocument PaddleOCREngine::ProcessImageRegion(const CaptureFrame& frame,
+OCRDocument PaddleOCREngine::ProcessImageRegion(const FrameView& frame,
                                                int x, int y, int width, int height) {
     return m_impl->ProcessImageRegion(frame, x, y, width, height);
 }
 
-std::future<OCRDocument> PaddleOCREngine::ProcessImageAsync(const CaptureFrame& frame) {
+std::future<OCRDocument> PaddleOCREngine::ProcessImageAsync(const FrameView& frame) {
     return m_impl->ProcessImageAsync(frame);
 }
 
@@ -1,4 +1,5 @@
 #include "performance_monitor.h"
+#include "memory_governor.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -6,6 +7,8 @@
 #include <numeric>
 #include <random>
 #include <cstdlib>
+#include <sstream>
+#include <dirent.h>
 
 namespace work_assistant {
 
@@ -31,12 +34,39 @@ void PerformanceMonitor::RecordTiming(const std::string& name, std::chrono::micr
     std::lock_guard<std::mutex> lock(m_mutex);
     m_timings[name].push_back(duration);
     
-    // Keep only recent measurements (last 1000)
-    if (m_timings[name].size() > 1000) {
-        m_timings[name].erase(m_timings[name].begin());
+    // Keep only recent measurements
+    auto& samples = m_timings[name];
+    if (samples.size() > m_max_samples) {
+        samples.erase(samples.begin(), samples.begin() + (samples.size() - m_max_samples));
     }
 }
 
+void PerformanceMonitor::SetMaxSamples(size_t max_samples) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_samples = std::max<size_t>(1, max_samples);
+    for (auto& entry : m_timings) {
+        auto& samples = entry.second;
+        if (samples.size() > m_max_samples) {
+            samples.erase(samples.begin(), samples.begin() + (samples.size() - m_max_samples));
+        }
+        samples.shrink_to_fit();
+    }
+}
+
+size_t PerformanceMonitor::GetMaxSamples() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_max_samples;
+}
+
+size_t PerformanceMonitor::GetMemoryFootprint() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t bytes = 0;
+    for (const auto& entry : m_timings) {
+        bytes += entry.first.capacity() + entry.second.capacity() * sizeof(std::chrono::microseconds);
+    }
+    return bytes;
+}
+
 void PerformanceMonitor::RecordMemoryUsage(const std::string& name, size_t bytes) {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_memory_usage[name] = bytes;
@@ -235,8 +265,9 @@ void PerformanceMonitor::Reset() {
 SystemStats SystemMonitor::GetSystemStats() {
     SystemStats stats;
     
-    // Get CPU usage (simplified)
+    // Get CPU usage
     stats.cpu_usage_percent = GetCPUUsage();
+    stats.process_cpu_percent = GetProcessCPUUsage();
     
     // Get memory usage
     GetMemoryUsage(stats.memory_used_mb, stats.memory_total_mb);
@@ -249,27 +280,141 @@ SystemStats SystemMonitor::GetSystemStats() {
 }
 
 double SystemMonitor::GetCPUUsage() {
-    // Simplified CPU usage calculation
-    // In a real implementation, this would read from /proc/stat on Linux
-    // or use Windows performance counters
-    static double mock_cpu = 2.5;
-    mock_cpu += (rand() % 20 - 10) * 0.1; // Simulate fluctuation
-    return std::max(0.0, std::min(100.0, mock_cpu));
+    // Aggregate "cpu" line of /proc/stat; busy share of the jiffies elapsed
+    // since the previous sample
+    static std::mutex sample_mutex;
+    static uint64_t last_total = 0, last_idle = 0;
+    static double last_usage = 0.0;
+    static std::chrono::steady_clock::time_point last_sample;
+
+    std::lock_guard<std::mutex> lock(sample_mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (last_total != 0 && now - last_sample < std::chrono::milliseconds(CPU_SAMPLE_MIN_INTERVAL_MS)) {
+        return last_usage;
+    }
+
+    std::ifstream file("/proc/stat");
+    std::string label;
+    uint64_t user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+    if (!(file >> label >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal) ||
+        label != "cpu") {
+        return last_usage;
+    }
+
+    uint64_t idle_all = idle + iowait;
+    uint64_t total = user + nice + system + idle_all + irq + softirq + steal;
+    if (last_total != 0 && total > last_total) {
+        double total_delta = static_cast<double>(total - last_total);
+        double idle_delta = static_cast<double>(idle_all - std::min(idle_all, last_idle));
+        last_usage = std::max(0.0, std::min(100.0, (1.0 - idle_delta / total_delta) * 100.0));
+    }
+    last_total = total;
+    last_idle = idle_all;
+    last_sample = now;
+    return last_usage;
+}
+
+double SystemMonitor::GetProcessCPUUsage() {
+    // utime + stime from /proc/self/stat against wall time and core count
+    static std::mutex sample_mutex;
+    static uint64_t last_ticks = 0;
+    static double last_usage = 0.0;
+    static std::chrono::steady_clock::time_point last_sample;
+
+    std::lock_guard<std::mutex> lock(sample_mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (last_ticks != 0 && now - last_sample < std::chrono::milliseconds(CPU_SAMPLE_MIN_INTERVAL_MS)) {
+        return last_usage;
+    }
+
+    std::ifstream file("/proc/self/stat");
+    std::string content;
+    std::getline(file, content);
+    // The command name may contain spaces; fields resume after the last ')'
+    size_t paren = content.rfind(')');
+    if (paren == std::string::npos) {
+        return last_usage;
+    }
+    std::istringstream fields(content.substr(paren + 2));
+    std::string field;
+    uint64_t utime = 0, stime = 0;
+    for (int index = 3; fields >> field; ++index) {
+        if (index == 14) {
+            utime = std::strtoull(field.c_str(), nullptr, 10);
+        } else if (index == 15) {
+            stime = std::strtoull(field.c_str(), nullptr, 10);
+            break;
+        }
+    }
+
+    uint64_t ticks = utime + stime;
+    if (last_ticks != 0) {
+        double wall_seconds = std::chrono::duration<double>(now - last_sample).count();
+        double cores = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+        double cpu_seconds = static_cast<double>(ticks - std::min(ticks, last_ticks)) / sysconf(_SC_CLK_TCK);
+        if (wall_seconds > 0.0) {
+            last_usage = std::max(0.0, std::min(100.0, cpu_seconds / (wall_seconds * cores) * 100.0));
+        }
+    }
+    last_ticks = std::max<uint64_t>(ticks, 1);
+    last_sample = now;
+    return last_usage;
 }
 
 void SystemMonitor::GetMemoryUsage(size_t& used_mb, size_t& total_mb) {
-    // Simplified memory usage
-    // In a real implementation, this would read from /proc/meminfo on Linux
-    // or use GlobalMemoryStatusEx on Windows
-    total_mb = 8192; // 8GB mock
-    used_mb = 4096 + (rand() % 1024); // Mock usage
+    size_t total_bytes = 0, available_bytes = 0;
+    if (!memory_utils::ReadMemInfo(total_bytes, available_bytes)) {
+        total_mb = 0;
+        used_mb = 0;
+        return;
+    }
+    total_mb = total_bytes / (1024 * 1024);
+    used_mb = (total_bytes - available_bytes) / (1024 * 1024);
 }
 
 void SystemMonitor::GetProcessMemory(size_t& process_mb) {
-    // Simplified process memory
-    // In a real implementation, this would read from /proc/self/status on Linux
-    // or use GetProcessMemoryInfo on Windows
-    process_mb = 150 + (rand() % 50); // Mock 150-200MB
+    process_mb = memory_utils::ReadProcessRSS() / (1024 * 1024);
+}
+
+bool SystemMonitor::IsOnACPower() {
+    // Any online mains adapter wins; otherwise a discharging battery means
+    // battery power, and no power supply information means a desktop
+    DIR* dir = opendir("/sys/class/power_supply");
+    if (!dir) {
+        return true;
+    }
+
+    bool mains_present = false;
+    bool mains_online = false;
+    bool discharging = false;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string base = std::string("/sys/class/power_supply/") + entry->d_name;
+        std::string type, value;
+        std::ifstream type_file(base + "/type");
+        std::getline(type_file, type);
+
+        if (type == "Mains") {
+            mains_present = true;
+            std::ifstream online_file(base + "/online");
+            if (std::getline(online_file, value) && value == "1") {
+                mains_online = true;
+            }
+        } else if (type == "Battery") {
+            std::ifstream status_file(base + "/status");
+            if (std::getline(status_file, value) && value == "Discharging") {
+                discharging = true;
+            }
+        }
+    }
+    closedir(dir);
+
+    if (mains_online) {
+        return true;
+    }
+    return !mains_present && !discharging;
 }
 
 // BenchmarkSuite implementation
@@ -1,4 +1,5 @@
 #include "screen_capture.h"
+#include "performance_monitor.h"
 #include <iostream>
 #include <thread>
 #include <atomic>
@@ -8,6 +9,10 @@
 #include <cmath>
 #include <cstring>
 
+#ifdef SCREEN_CAPTURE_LITE_FOUND
+#include "../platform/screen_capture_lite_impl.h"
+#endif
+
 #ifdef _WIN32
 #include "../platform/windows/win32_screen_capture.h"
 #elif defined(__linux__)
@@ -17,11 +22,17 @@
 namespace work_assistant {
 
 // Screen capture factory implementation
-std::unique_ptr<IScreenCapture> ScreenCaptureFactory::Create() {
+std::unique_ptr<IScreenCapture> ScreenCaptureFactory::Create(CaptureBackend backend) {
 #ifdef SCREEN_CAPTURE_LITE_FOUND
-    // Prefer screen_capture_lite if available
-    return std::make_unique<ScreenCaptureLiteImpl>();
-#elif defined(_WIN32)
+    if (backend == CaptureBackend::SCREEN_CAPTURE_LITE) {
+        return std::make_unique<ScreenCaptureLiteImpl>();
+    }
+#else
+    if (backend == CaptureBackend::SCREEN_CAPTURE_LITE) {
+        std::cerr << "screen_capture_lite not available, using the native capture backend" << std::endl;
+    }
+#endif
+#if defined(_WIN32)
     return std::make_unique<Win32ScreenCapture>();
 #elif defined(__linux__)
     return std::make_unique<LinuxScreenCapture>();
@@ -30,6 +41,33 @@ std::unique_ptr<IScreenCapture> ScreenCaptureFactory::Create() {
 #endif
 }
 
+CaptureBackend ScreenCaptureFactory::BackendFromName(const std::string& name) {
+    if (name == "screen_capture_lite") {
+        return CaptureBackend::SCREEN_CAPTURE_LITE;
+    }
+    if (!name.empty() && name != "native") {
+        std::cerr << "Unknown capture backend '" << name << "', using native" << std::endl;
+    }
+    return CaptureBackend::NATIVE;
+}
+
+// Default scaled capture: full-resolution grab, reduced locally
+bool IScreenCapture::CaptureDesktopScaled(int factor, CaptureFrame& frame, bool& changed) {
+    CaptureFrame full;
+    if (!CaptureDesktopIncremental(full, changed)) {
+        return false;
+    }
+    return !changed || capture_utils::DownscaleFrame(full, frame, factor);
+}
+
+bool IScreenCapture::CaptureMonitorScaled(int monitorId, int factor, CaptureFrame& frame, bool& changed) {
+    CaptureFrame full;
+    if (!CaptureMonitorIncremental(monitorId, full, changed)) {
+        return false;
+    }
+    return !changed || capture_utils::DownscaleFrame(full, frame, factor);
+}
+
 // Screen capture manager implementation
 class ScreenCaptureManager::Impl {
 public:
@@ -43,6 +81,11 @@ public:
         , m_captureWidth(0), m_captureHeight(0)
         , m_useCustomRegion(false)
         , m_lastHash(0)
+        , m_downscaleFactor(1)
+        , m_detectionScale(1)
+        , m_paused(false)
+        , m_streaming(false)
+        , m_focusedMonitor(-1)
     {
     }
 
@@ -50,12 +93,12 @@ public:
         Shutdown();
     }
 
-    bool Initialize() {
+    bool Initialize(std::unique_ptr<IScreenCapture> backend) {
         if (m_initialized) {
             return true;
         }
 
-        m_capture = ScreenCaptureFactory::Create();
+        m_capture = backend ? std::move(backend) : ScreenCaptureFactory::Create();
         if (!m_capture) {
             std::cerr << "Failed to create screen capture backend" << std::endl;
             return false;
@@ -96,6 +139,28 @@ public:
         m_monitoring = true;
         m_shutdownRequested = false;
 
+        // Backends that stream drive monitoring from their own frame
+        // callbacks; custom regions and everything else use the polling loop
+        m_capture->SetCaptureSettings(m_capture->SupportsHardwareAcceleration(), m_maxFPS);
+        if (!m_useCustomRegion &&
+            m_capture->StartStreaming([this](const CaptureFrame& frame) { OnStreamedFrame(frame); })) {
+            m_streaming = true;
+            std::cout << "Started screen capture monitoring (streaming)" << std::endl;
+            return true;
+        }
+
+        // Several monitors: one worker each, so an idle monitor costs
+        // nothing and a change on one doesn't re-deliver the others
+        auto monitors = m_capture->GetMonitors();
+        if (!m_useCustomRegion && monitors.size() > 1 && m_capture->SupportsParallelMonitorCapture()) {
+            for (const auto& monitor : monitors) {
+                m_monitorWorkers.emplace_back(&Impl::MonitorWorkerLoop, this, monitor.id);
+            }
+            std::cout << "Started screen capture monitoring (" << monitors.size()
+                      << " monitor workers)" << std::endl;
+            return true;
+        }
+
         // Start monitoring thread
         m_monitorThread = std::thread(&Impl::MonitoringLoop, this);
         
@@ -111,9 +176,20 @@ public:
         m_shutdownRequested = true;
         m_monitoring = false;
 
+        if (m_streaming) {
+            m_capture->StopStreaming();
+            m_streaming = false;
+        }
+
         if (m_monitorThread.joinable()) {
             m_monitorThread.join();
         }
+        for (auto& worker : m_monitorWorkers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        m_monitorWorkers.clear();
 
         std::cout << "Stopped screen capture monitoring" << std::endl;
     }
@@ -153,6 +229,14 @@ public:
 
     void SetMaxFPS(int fps) {
         m_maxFPS = std::max(1, std::min(120, fps));
+        if (m_streaming) {
+            // Streaming backends pace themselves
+            m_capture->SetCaptureSettings(m_capture->SupportsHardwareAcceleration(), m_maxFPS);
+        }
+    }
+
+    int GetMaxFPS() const {
+        return m_maxFPS;
     }
 
     void SetCaptureRegion(int x, int y, int width, int height) {
@@ -167,39 +251,181 @@ public:
         m_useCustomRegion = false;
     }
 
+    void SetDownscaleFactor(int factor) {
+        m_downscaleFactor = std::max(1, std::min(8, factor));
+    }
+
+    int GetDownscaleFactor() const {
+        return m_downscaleFactor;
+    }
+
+    void SetDetectionScale(int factor) {
+        m_detectionScale = std::max(1, std::min(MAX_DETECTION_SCALE, factor));
+    }
+
+    int GetDetectionScale() const {
+        return m_detectionScale;
+    }
+
+    bool SupportsServerSideScaling() const {
+        return m_capture && m_capture->SupportsServerSideScaling();
+    }
+
+    bool CaptureFullResolution(const CaptureFrame& detectionFrame, CaptureFrame& frame) {
+        if (!m_initialized) {
+            return false;
+        }
+
+        // Re-read the area the detection frame was taken from
+        bool captured = false;
+        if (detectionFrame.monitor_id >= 0) {
+            captured = m_capture->CaptureMonitor(detectionFrame.monitor_id, frame);
+            frame.monitor_id = detectionFrame.monitor_id;
+        } else {
+            captured = CaptureNow(frame);
+        }
+        if (!captured) {
+            return false;
+        }
+        PerformanceMonitor::GetInstance().IncrementCounter("capture.full_resolution_reads");
+
+        // The memory governor's reduction still applies
+        int factor = m_downscaleFactor;
+        if (factor > 1) {
+            CaptureFrame scaled;
+            if (capture_utils::DownscaleFrame(frame, scaled, factor)) {
+                frame = std::move(scaled);
+            }
+        }
+        return true;
+    }
+
+    void SetPaused(bool paused) {
+        m_paused = paused;
+        if (m_initialized) {
+            m_capture->SetPaused(paused);
+        }
+    }
+
+    bool IsPaused() const {
+        return m_paused;
+    }
+
+    std::vector<MonitorInfo> GetMonitors() const {
+        if (!m_initialized) {
+            return {};
+        }
+        return m_capture->GetMonitors();
+    }
+
+    int GetMonitorAt(int x, int y) const {
+        for (const auto& monitor : GetMonitors()) {
+            if (x >= monitor.x && x < monitor.x + monitor.width &&
+                y >= monitor.y && y < monitor.y + monitor.height) {
+                return monitor.id;
+            }
+        }
+        return -1;
+    }
+
+    void SetFocusedMonitor(int monitorId) {
+        m_focusedMonitor = monitorId;
+    }
+
+    int GetFocusedMonitor() const {
+        return m_focusedMonitor;
+    }
+
 private:
+    // Monitored capture; full-desktop capture goes through the backend's
+    // damage tracking when it has any
+    bool CaptureNext(CaptureFrame& frame, bool& changed) {
+        if (m_useCustomRegion) {
+            changed = true;
+            frame.dirty_rects.clear();
+            return CaptureNow(frame);
+        }
+        int scale = m_detectionScale;
+        if (scale > 1) {
+            return m_capture->CaptureDesktopScaled(scale, frame, changed);
+        }
+        return m_capture->CaptureDesktopIncremental(frame, changed);
+    }
+
+    bool CaptureMonitorNext(int monitorId, CaptureFrame& frame, bool& changed) {
+        int scale = m_detectionScale;
+        if (scale > 1) {
+            return m_capture->CaptureMonitorScaled(monitorId, scale, frame, changed);
+        }
+        return m_capture->CaptureMonitorIncremental(monitorId, frame, changed);
+    }
+
+    // Called on the backend's capture thread while streaming
+    void OnStreamedFrame(const CaptureFrame& frame) {
+        if (m_shutdownRequested || m_paused) {
+            return;
+        }
+        HandleFrame(frame, m_lastHash);
+    }
+
+    // Change detection, downscaling and delivery for one captured frame.
+    // lastHash belongs to the calling loop, so monitors are compared only
+    // against their own previous frame.
+    void HandleFrame(const CaptureFrame& frame, uint64_t& lastHash) {
+        bool shouldProcess = true;
+
+        // Check for changes if enabled
+        if (m_changeDetectionEnabled) {
+            uint64_t currentHash = capture_utils::CalculateHash(frame);
+            
+            if (lastHash != 0) {
+                int hammingDistance = capture_utils::CompareHashes(currentHash, lastHash);
+                double changeRatio = static_cast<double>(hammingDistance) / 64.0;
+                
+                if (changeRatio < m_changeThreshold) {
+                    shouldProcess = false;
+                }
+            }
+            
+            lastHash = currentHash;
+        }
+
+        if (shouldProcess && m_frameCallback) {
+            // Detection frames are already below native resolution
+            int factor = frame.scale_factor > 1 ? 1 : m_downscaleFactor.load();
+            CaptureFrame scaled;
+            const CaptureFrame* delivered = &frame;
+            if (factor > 1 && capture_utils::DownscaleFrame(frame, scaled, factor)) {
+                delivered = &scaled;
+            }
+            // Full-frame passes spent before consumers see the pixels;
+            // one (the backend's read-back) when nothing converts them
+            auto& perf = PerformanceMonitor::GetInstance();
+            perf.RecordCounter("capture.pixel_passes_per_frame", delivered->pixel_passes);
+            perf.IncrementCounter("capture.pixel_passes", delivered->pixel_passes);
+            perf.IncrementCounter("capture.frames_delivered");
+            m_frameCallback(*delivered);
+        }
+    }
+
     void MonitoringLoop() {
-        const auto frameDuration = std::chrono::milliseconds(1000 / m_maxFPS);
         auto lastCaptureTime = std::chrono::steady_clock::now();
+        CaptureFrame frame;  // Reused so damage-tracking backends update it in place
 
         while (!m_shutdownRequested) {
+            // Re-read each iteration so governors can retune a running loop
+            const auto frameDuration = std::chrono::milliseconds(1000 / m_maxFPS);
             auto currentTime = std::chrono::steady_clock::now();
             auto elapsed = currentTime - lastCaptureTime;
 
-            if (elapsed >= frameDuration) {
-                CaptureFrame frame;
-                if (CaptureNow(frame)) {
-                    bool shouldProcess = true;
-
-                    // Check for changes if enabled
-                    if (m_changeDetectionEnabled) {
-                        uint64_t currentHash = capture_utils::CalculateHash(frame);
-                        
-                        if (m_lastHash != 0) {
-                            int hammingDistance = capture_utils::CompareHashes(currentHash, m_lastHash);
-                            double changeRatio = static_cast<double>(hammingDistance) / 64.0;
-                            
-                            if (changeRatio < m_changeThreshold) {
-                                shouldProcess = false;
-                            }
-                        }
-                        
-                        m_lastHash = currentHash;
-                    }
-
-                    if (shouldProcess && m_frameCallback) {
-                        m_frameCallback(frame);
-                    }
+            if (!m_paused && elapsed >= frameDuration) {
+                bool changed = true;
+                bool captured = CaptureNext(frame, changed);
+                if (captured && !changed) {
+                    // Damage tracking saw no redraws: no read-back, no hashing
+                    PerformanceMonitor::GetInstance().IncrementCounter("capture.unchanged_ticks");
+                } else if (captured) {
+                    HandleFrame(frame, m_lastHash);
                 }
 
                 lastCaptureTime = currentTime;
@@ -210,6 +436,38 @@ private:
         }
     }
 
+    void MonitorWorkerLoop(int monitorId) {
+        auto lastCaptureTime = std::chrono::steady_clock::now();
+        uint64_t lastHash = 0;
+        CaptureFrame frame;
+
+        while (!m_shutdownRequested) {
+            // Secondary monitors are polled at half rate while another
+            // monitor has focus
+            int focused = m_focusedMonitor;
+            int fps = m_maxFPS;
+            if (focused >= 0 && focused != monitorId) {
+                fps = std::max(1, fps / 2);
+            }
+            const auto frameDuration = std::chrono::milliseconds(1000 / fps);
+            auto currentTime = std::chrono::steady_clock::now();
+
+            if (!m_paused && currentTime - lastCaptureTime >= frameDuration) {
+                bool changed = true;
+                bool captured = CaptureMonitorNext(monitorId, frame, changed);
+                if (captured && !changed) {
+                    PerformanceMonitor::GetInstance().IncrementCounter("capture.unchanged_ticks");
+                } else if (captured) {
+                    frame.monitor_id = monitorId;
+                    HandleFrame(frame, lastHash);
+                }
+                lastCaptureTime = currentTime;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
 private:
     bool m_initialized;
     std::atomic<bool> m_monitoring;
@@ -218,11 +476,12 @@ private:
     std::unique_ptr<IScreenCapture> m_capture;
     std::function<void(const CaptureFrame&)> m_frameCallback;
     std::thread m_monitorThread;
+    std::vector<std::thread> m_monitorWorkers;
 
     // Settings
     bool m_changeDetectionEnabled;
     double m_changeThreshold;
-    int m_maxFPS;
+    std::atomic<int> m_maxFPS;
     
     // Capture region
     int m_captureX, m_captureY;
@@ -231,6 +490,23 @@ private:
 
     // Change detection
     uint64_t m_lastHash;
+
+    // Resolution reduction requested by the memory governor
+    std::atomic<int> m_downscaleFactor;
+
+    // Monitored frames are captured at this reduction for change detection;
+    // consumers fetch full resolution on demand
+    std::atomic<int> m_detectionScale;
+    static constexpr int MAX_DETECTION_SCALE = 8;
+
+    // Set by the CPU governor while yielding to foreground work
+    std::atomic<bool> m_paused;
+
+    // Frames are pushed by the backend instead of polled
+    std::atomic<bool> m_streaming;
+
+    // Monitor holding the focused window, -1 when unknown
+    std::atomic<int> m_focusedMonitor;
 };
 
 // ScreenCaptureManager implementation
@@ -241,7 +517,11 @@ ScreenCaptureManager::ScreenCaptureManager()
 ScreenCaptureManager::~ScreenCaptureManager() = default;
 
 bool ScreenCaptureManager::Initialize() {
-    return m_impl->Initialize();
+    return m_impl->Initialize(nullptr);
+}
+
+bool ScreenCaptureManager::Initialize(std::unique_ptr<IScreenCapture> backend) {
+    return m_impl->Initialize(std::move(backend));
 }
 
 void ScreenCaptureManager::Shutdown() {
@@ -280,6 +560,10 @@ void ScreenCaptureManager::SetMaxFPS(int fps) {
     m_impl->SetMaxFPS(fps);
 }
 
+int ScreenCaptureManager::GetMaxFPS() const {
+    return m_impl->GetMaxFPS();
+}
+
 void ScreenCaptureManager::SetCaptureRegion(int x, int y, int width, int height) {
     m_impl->SetCaptureRegion(x, y, width, height);
 }
@@ -288,155 +572,52 @@ void ScreenCaptureManager::ResetCaptureRegion() {
     m_impl->ResetCaptureRegion();
 }
 
-// Utility functions
-namespace capture_utils {
-
-uint64_t CalculateHash(const CaptureFrame& frame) {
-    if (!frame.IsValid() || frame.bytes_per_pixel < 3) {
-        return 0;
-    }
-
-    // Simple dHash implementation
-    const int hashSize = 8;
-    const int scaledSize = hashSize + 1;
-    
-    // Create a scaled down grayscale version
-    std::vector<uint8_t> grayscale(scaledSize * scaledSize);
-    
-    for (int y = 0; y < scaledSize; ++y) {
-        for (int x = 0; x < scaledSize; ++x) {
-            // Calculate source pixel position
-            int srcX = (x * frame.width) / scaledSize;
-            int srcY = (y * frame.height) / scaledSize;
-            
-            if (srcX >= frame.width) srcX = frame.width - 1;
-            if (srcY >= frame.height) srcY = frame.height - 1;
-            
-            int srcIndex = (srcY * frame.width + srcX) * frame.bytes_per_pixel;
-            
-            // Convert to grayscale (assuming RGB/RGBA format)
-            uint8_t r = frame.data[srcIndex];
-            uint8_t g = frame.data[srcIndex + 1];
-            uint8_t b = frame.data[srcIndex + 2];
-            
-            uint8_t gray = static_cast<uint8_t>(0.299 * r + 0.587 * g + 0.114 * b);
-            grayscale[y * scaledSize + x] = gray;
-        }
-    }
-    
-    // Calculate hash
-    uint64_t hash = 0;
-    for (int y = 0; y < hashSize; ++y) {
-        for (int x = 0; x < hashSize; ++x) {
-            int current = grayscale[y * scaledSize + x];
-            int next = grayscale[y * scaledSize + x + 1];
-            
-            if (current > next) {
-                hash |= (1ULL << (y * hashSize + x));
-            }
-        }
-    }
-    
-    return hash;
+void ScreenCaptureManager::SetDownscaleFactor(int factor) {
+    m_impl->SetDownscaleFactor(factor);
 }
 
-int CompareHashes(uint64_t hash1, uint64_t hash2) {
-    uint64_t diff = hash1 ^ hash2;
-    
-    // Count set bits (Hamming distance)
-    int count = 0;
-    while (diff) {
-        count += diff & 1;
-        diff >>= 1;
-    }
-    
-    return count;
+int ScreenCaptureManager::GetDownscaleFactor() const {
+    return m_impl->GetDownscaleFactor();
 }
 
-bool ConvertFrame(const CaptureFrame& source, CaptureFrame& target, int targetBytesPerPixel) {
-    if (!source.IsValid() || targetBytesPerPixel < 1 || targetBytesPerPixel > 4) {
-        return false;
-    }
-
-    target.width = source.width;
-    target.height = source.height;
-    target.bytes_per_pixel = targetBytesPerPixel;
-    target.timestamp = source.timestamp;
-    target.data.resize(target.GetDataSize());
-
-    // Simple conversion (just copy/truncate channels)
-    for (int i = 0; i < source.width * source.height; ++i) {
-        int srcIndex = i * source.bytes_per_pixel;
-        int dstIndex = i * target.bytes_per_pixel;
-        
-        int copyBytes = std::min(source.bytes_per_pixel, target.bytes_per_pixel);
-        memcpy(target.data.data() + dstIndex, 
-               source.data.data() + srcIndex, copyBytes);
-    }
-
-    return true;
+void ScreenCaptureManager::SetDetectionScale(int factor) {
+    m_impl->SetDetectionScale(factor);
 }
 
-bool SaveFrameToFile(const CaptureFrame& frame, const std::string& filename) {
-    // Simple PPM format output for debugging
-    if (!frame.IsValid()) {
-        return false;
-    }
-
-    std::FILE* file = std::fopen(filename.c_str(), "wb");
-    if (!file) {
-        return false;
-    }
+int ScreenCaptureManager::GetDetectionScale() const {
+    return m_impl->GetDetectionScale();
+}
 
-    // Write PPM header
-    std::fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height);
+bool ScreenCaptureManager::SupportsServerSideScaling() const {
+    return m_impl->SupportsServerSideScaling();
+}
 
-    // Write pixel data (convert to RGB if needed)
-    for (int i = 0; i < frame.width * frame.height; ++i) {
-        int srcIndex = i * frame.bytes_per_pixel;
-        
-        if (frame.bytes_per_pixel >= 3) {
-            // Assume RGB or RGBA
-            std::fwrite(frame.data.data() + srcIndex, 1, 3, file);
-        } else {
-            // Grayscale or other format
-            uint8_t gray = frame.data[srcIndex];
-            std::fwrite(&gray, 1, 1, file);
-            std::fwrite(&gray, 1, 1, file);
-            std::fwrite(&gray, 1, 1, file);
-        }
-    }
+bool ScreenCaptureManager::CaptureFullResolution(const CaptureFrame& detectionFrame, CaptureFrame& frame) {
+    return m_impl->CaptureFullResolution(detectionFrame, frame);
+}
 
-    std::fclose(file);
-    return true;
+void ScreenCaptureManager::SetPaused(bool paused) {
+    m_impl->SetPaused(paused);
 }
 
-bool CropFrame(const CaptureFrame& source, CaptureFrame& target,
-               int x, int y, int width, int height) {
-    if (!source.IsValid() || x < 0 || y < 0 || 
-        x + width > source.width || y + height > source.height) {
-        return false;
-    }
+bool ScreenCaptureManager::IsPaused() const {
+    return m_impl->IsPaused();
+}
 
-    target.width = width;
-    target.height = height;
-    target.bytes_per_pixel = source.bytes_per_pixel;
-    target.timestamp = source.timestamp;
-    target.data.resize(target.GetDataSize());
+std::vector<MonitorInfo> ScreenCaptureManager::GetMonitors() const {
+    return m_impl->GetMonitors();
+}
 
-    for (int row = 0; row < height; ++row) {
-        int srcRow = y + row;
-        int srcOffset = (srcRow * source.width + x) * source.bytes_per_pixel;
-        int dstOffset = row * width * source.bytes_per_pixel;
-        
-        memcpy(target.data.data() + dstOffset,
-               source.data.data() + srcOffset,
-               width * source.bytes_per_pixel);
-    }
+int ScreenCaptureManager::GetMonitorAt(int x, int y) const {
+    return m_impl->GetMonitorAt(x, y);
+}
 
-    return true;
+void ScreenCaptureManager::SetFocusedMonitor(int monitorId) {
+    m_impl->SetFocusedMonitor(monitorId);
 }
 
-} // namespace capture_utils
+int ScreenCaptureManager::GetFocusedMonitor() const {
+    return m_impl->GetFocusedMonitor();
+}
 
-} // namespace work_assistant
\ No newline at end of file
+} // namespace work_assistant
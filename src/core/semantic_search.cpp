@@ -0,0 +1,309 @@
+#include "semantic_search.h"
+#include "ai_engine.h"
+#include "performance_monitor.h"
+#include "storage_engine.h"
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <unordered_set>
+
+namespace work_assistant {
+
+namespace {
+
+// Chunk number marking a record whose chunks are all indexed
+const size_t RECORD_DONE = 0xFF;
+
+// Extra matches fetched per result, since several chunks of one record may
+// outrank the next record
+const size_t MATCHES_PER_RESULT = 4;
+
+std::string Shorten(const std::string& text, size_t maxChars) {
+    if (text.size() <= maxChars) {
+        return text;
+    }
+    size_t cut = text.rfind(' ', maxChars);
+    if (cut == std::string::npos || cut < maxChars / 2) {
+        cut = maxChars;
+    }
+    // Don't split a UTF-8 sequence
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+        --cut;
+    }
+    return text.substr(0, cut) + "...";
+}
+
+} // namespace
+
+class SemanticSearch::Impl {
+public:
+    Impl() : m_analyzer(nullptr), m_embeddedChunks(0), m_searches(0), m_totalSearchMs(0.0) {}
+
+    bool Open(const std::string& path, std::shared_ptr<EncryptedStorageManager> storage,
+              AIContentAnalyzer* analyzer, const SemanticSearchConfig& config) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        if (m_index.IsOpen()) {
+            return true;
+        }
+        if (!storage || !analyzer || !config.IsValid()) {
+            return false;
+        }
+
+        int dimension = analyzer->GetEmbeddingDimension();
+        if (dimension <= 0) {
+            std::cerr << "Semantic search unavailable: model provides no embeddings" << std::endl;
+            return false;
+        }
+        if (!m_index.Open(path, dimension, analyzer->GetEmbeddingModelTag(), config.index)) {
+            return false;
+        }
+
+        m_storage = storage;
+        m_analyzer = analyzer;
+        m_config = config;
+        std::cout << "Semantic search ready (" << m_index.Size() << " chunks, dimension "
+                  << dimension << ")" << std::endl;
+        return true;
+    }
+
+    void Close() {
+        // Waits for running searches and embedding steps
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_index.Close();
+        m_storage.reset();
+        m_analyzer = nullptr;
+    }
+
+    bool IsReady() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_index.IsOpen();
+    }
+
+    DeferredJobResult RunEmbeddingStep() {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        std::lock_guard<std::mutex> stepLock(m_stepMutex);
+        if (!m_index.IsOpen()) {
+            return DeferredJobResult::DONE;
+        }
+
+        // The watermark is the id of the last chunk indexed
+        const uint64_t watermark = m_index.GetWatermark();
+        const uint64_t lastRecord = semantic_utils::ChunkRecordId(watermark);
+        const size_t lastChunk = semantic_utils::ChunkNumber(watermark);
+        const bool lastDone = watermark == 0 || lastChunk == RECORD_DONE;
+        const uint64_t afterId = lastDone ? lastRecord : lastRecord - 1;
+
+        const size_t limit = m_config.chunks_per_step;
+        std::vector<OCRTextRecord> records = m_storage->GetOCRResults(afterId, limit);
+
+        // Gather chunks in record order; progress only ever covers a
+        // contiguous prefix of them
+        std::vector<uint64_t> ids;
+        std::vector<std::chrono::system_clock::time_point> times;
+        std::vector<std::string> texts;
+        uint64_t progress = watermark;
+        bool full = false;
+        for (const OCRTextRecord& record : records) {
+            std::vector<std::string> chunks = semantic_utils::SplitIntoChunks(
+                record.text, m_config.chunk_words, m_config.chunk_overlap, m_config.max_chunks_per_record);
+            size_t chunk = record.id == lastRecord ? lastChunk + 1 : 0;
+            for (; chunk < chunks.size(); ++chunk) {
+                if (texts.size() >= limit) {
+                    full = true;
+                    break;
+                }
+                ids.push_back(semantic_utils::MakeChunkId(record.id, chunk));
+                times.push_back(record.timestamp);
+                texts.push_back(std::move(chunks[chunk]));
+                progress = ids.back();
+            }
+            if (full) {
+                break;
+            }
+            progress = semantic_utils::MakeChunkId(record.id, RECORD_DONE);
+        }
+
+        if (!texts.empty()) {
+            std::vector<std::vector<float>> embeddings;
+            if (!m_analyzer->Embed(texts, embeddings)) {
+                std::cerr << "Failed to embed screen text for semantic search" << std::endl;
+                return DeferredJobResult::FAILED;
+            }
+            for (size_t i = 0; i < embeddings.size(); ++i) {
+                // Blank chunks have no direction and are skipped by the index
+                m_index.Add(ids[i], times[i], embeddings[i]);
+            }
+            m_embeddedChunks += texts.size();
+            PerformanceMonitor::GetInstance().IncrementCounter("semantic.chunks_embedded",
+                                                               static_cast<int64_t>(texts.size()));
+        }
+
+        if (progress == watermark) {
+            return DeferredJobResult::DONE;
+        }
+        m_index.SetWatermark(progress);
+        return (full || records.size() == limit) ? DeferredJobResult::MORE : DeferredJobResult::DONE;
+    }
+
+    std::vector<SemanticSearchResult> Search(const std::string& query, size_t k,
+                                             std::chrono::system_clock::time_point start,
+                                             std::chrono::system_clock::time_point end) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        std::vector<SemanticSearchResult> results;
+        if (!m_index.IsOpen() || query.empty() || k == 0) {
+            return results;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        std::vector<std::vector<float>> embeddings;
+        if (!m_analyzer->Embed({query}, embeddings)) {
+            return results;
+        }
+        auto matches = m_index.Search(embeddings[0], k * MATCHES_PER_RESULT, start, end);
+
+        std::unordered_set<uint64_t> seen;
+        for (const VectorMatch& match : matches) {
+            if (results.size() >= k) {
+                break;
+            }
+            uint64_t recordId = semantic_utils::ChunkRecordId(match.id);
+            if (!seen.insert(recordId).second) {
+                continue;
+            }
+
+            // Records removed by retention cleanup leave stale vectors
+            OCRTextRecord record;
+            if (!m_storage->GetOCRResult(recordId, record)) {
+                continue;
+            }
+            std::vector<std::string> chunks = semantic_utils::SplitIntoChunks(
+                record.text, m_config.chunk_words, m_config.chunk_overlap, m_config.max_chunks_per_record);
+            size_t chunk = semantic_utils::ChunkNumber(match.id);
+
+            SemanticSearchResult result;
+            result.record_id = recordId;
+            result.timestamp = record.timestamp;
+            result.similarity = match.similarity;
+            result.snippet = Shorten(chunk < chunks.size() ? chunks[chunk] : record.text, m_config.snippet_chars);
+            results.push_back(std::move(result));
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        PerformanceMonitor::GetInstance().RecordTiming("semantic.search_time", duration);
+        {
+            std::lock_guard<std::mutex> statsLock(m_statsMutex);
+            m_searches++;
+            m_totalSearchMs += duration.count() / 1000.0;
+        }
+        return results;
+    }
+
+    bool Flush() {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return !m_index.IsOpen() || m_index.Flush();
+    }
+
+    SemanticSearchStatistics GetStatistics() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        SemanticSearchStatistics stats;
+        stats.ready = m_index.IsOpen();
+        stats.indexed_chunks = m_index.Size();
+        stats.indexed_through = semantic_utils::ChunkRecordId(m_index.GetWatermark());
+        stats.embedded_chunks = m_embeddedChunks;
+        stats.index = m_index.GetStatistics();
+
+        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+        stats.searches = m_searches;
+        stats.average_search_ms = m_searches > 0 ? m_totalSearchMs / m_searches : 0.0;
+        return stats;
+    }
+
+private:
+    // Shared by searches and embedding steps, exclusive for Open/Close
+    mutable std::shared_mutex m_mutex;
+    std::mutex m_stepMutex;
+    VectorIndex m_index;
+    std::shared_ptr<EncryptedStorageManager> m_storage;
+    AIContentAnalyzer* m_analyzer;
+    SemanticSearchConfig m_config;
+
+    mutable std::mutex m_statsMutex;
+    size_t m_embeddedChunks;
+    size_t m_searches;
+    double m_totalSearchMs;
+};
+
+SemanticSearch::SemanticSearch() : m_impl(std::make_unique<Impl>()) {}
+SemanticSearch::~SemanticSearch() = default;
+
+bool SemanticSearch::Open(const std::string& path, std::shared_ptr<EncryptedStorageManager> storage,
+                          AIContentAnalyzer* analyzer, const SemanticSearchConfig& config) {
+    return m_impl->Open(path, std::move(storage), analyzer, config);
+}
+
+void SemanticSearch::Close() {
+    m_impl->Close();
+}
+
+bool SemanticSearch::IsReady() const {
+    return m_impl->IsReady();
+}
+
+DeferredJobResult SemanticSearch::RunEmbeddingStep() {
+    return m_impl->RunEmbeddingStep();
+}
+
+std::vector<SemanticSearchResult> SemanticSearch::Search(const std::string& query, size_t k,
+                                                         std::chrono::system_clock::time_point start,
+                                                         std::chrono::system_clock::time_point end) {
+    return m_impl->Search(query, k, start, end);
+}
+
+bool SemanticSearch::Flush() {
+    return m_impl->Flush();
+}
+
+SemanticSearchStatistics SemanticSearch::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+namespace semantic_utils {
+
+std::vector<std::string> SplitIntoChunks(const std::string& text, size_t chunkWords,
+                                         size_t overlap, size_t maxChunks) {
+    std::vector<std::string> chunks;
+    if (chunkWords == 0 || overlap >= chunkWords || maxChunks == 0) {
+        return chunks;
+    }
+
+    std::vector<std::string> words;
+    std::istringstream stream(text);
+    std::string word;
+    while (stream >> word) {
+        words.push_back(std::move(word));
+    }
+
+    const size_t stride = chunkWords - overlap;
+    for (size_t begin = 0; begin < words.size() && chunks.size() < maxChunks; begin += stride) {
+        size_t end = std::min(words.size(), begin + chunkWords);
+        std::string chunk;
+        for (size_t i = begin; i < end; ++i) {
+            if (i > begin) {
+                chunk += ' ';
+            }
+            chunk += words[i];
+        }
+        chunks.push_back(std::move(chunk));
+        if (end == words.size()) {
+            break;
+        }
+    }
+    return chunks;
+}
+
+} // namespace semantic_utils
+
+} // namespace work_assistant
@@ -0,0 +1,329 @@
+#include "startup_sequencer.h"
+#include "performance_monitor.h"
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace work_assistant {
+
+class StartupSequencer::Impl {
+public:
+    struct Stage {
+        std::string name;
+        StageFunction fn;
+        std::vector<std::string> dependencies;
+        bool deferred = false;
+
+        StageState state = StageState::PENDING;
+        size_t remaining_deps = 0;
+        std::vector<size_t> dependents;
+        std::chrono::microseconds queued_at{0};
+        std::chrono::microseconds duration{0};
+    };
+
+    Impl() : m_pool(nullptr), m_prepared(false), m_deferredStarted(false) {}
+
+    void AddStage(const std::string& name, StageFunction fn,
+                  const std::vector<std::string>& dependencies, bool deferred) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_prepared) {
+            std::cerr << "StartupSequencer: cannot add stage '" << name
+                      << "' after startup has begun" << std::endl;
+            return;
+        }
+
+        Stage stage;
+        stage.name = name;
+        stage.fn = std::move(fn);
+        stage.dependencies = dependencies;
+        stage.deferred = deferred;
+        m_stages.push_back(std::move(stage));
+    }
+
+    bool Run(WorkAssistant::ThreadPool& pool) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_prepared) {
+            if (!PrepareGraph()) {
+                return false;
+            }
+            m_prepared = true;
+            m_startTime = std::chrono::steady_clock::now();
+        }
+        m_pool = &pool;
+
+        for (size_t i = 0; i < m_stages.size(); ++i) {
+            if (!m_stages[i].deferred && IsReady(i)) {
+                Dispatch(i);
+            }
+        }
+
+        m_cv.wait(lock, [this]() { return AllDone(false); });
+
+        auto elapsed = Elapsed();
+        PerformanceMonitor::GetInstance().RecordTiming("startup.immediate_stages", elapsed);
+        return true;
+    }
+
+    void RunDeferred(WorkAssistant::ThreadPool& pool) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_prepared || m_deferredStarted) {
+            return;
+        }
+        m_pool = &pool;
+        m_deferredStarted = true;
+
+        for (size_t i = 0; i < m_stages.size(); ++i) {
+            if (m_stages[i].deferred && IsReady(i)) {
+                Dispatch(i);
+            }
+        }
+    }
+
+    void WaitForDeferred() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_deferredStarted) {
+            return;
+        }
+        m_cv.wait(lock, [this]() { return AllDone(true); });
+    }
+
+    bool HasDeferredStarted() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_deferredStarted;
+    }
+
+    std::vector<StageTiming> GetTimings() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<StageTiming> timings;
+        timings.reserve(m_stages.size());
+        for (const auto& stage : m_stages) {
+            StageTiming timing;
+            timing.name = stage.name;
+            timing.state = stage.state;
+            timing.deferred = stage.deferred;
+            timing.queued_at = stage.queued_at;
+            timing.duration = stage.duration;
+            timings.push_back(timing);
+        }
+        return timings;
+    }
+
+    std::chrono::microseconds GetElapsed() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_prepared ? Elapsed() : std::chrono::microseconds(0);
+    }
+
+private:
+    bool PrepareGraph() {
+        std::unordered_map<std::string, size_t> index;
+        for (size_t i = 0; i < m_stages.size(); ++i) {
+            if (!index.emplace(m_stages[i].name, i).second) {
+                std::cerr << "StartupSequencer: duplicate stage '" << m_stages[i].name << "'" << std::endl;
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < m_stages.size(); ++i) {
+            auto& stage = m_stages[i];
+            stage.remaining_deps = stage.dependencies.size();
+            for (const auto& dep : stage.dependencies) {
+                auto it = index.find(dep);
+                if (it == index.end()) {
+                    std::cerr << "StartupSequencer: stage '" << stage.name
+                              << "' depends on unknown stage '" << dep << "'" << std::endl;
+                    return false;
+                }
+                if (!stage.deferred && m_stages[it->second].deferred) {
+                    std::cerr << "StartupSequencer: immediate stage '" << stage.name
+                              << "' cannot depend on deferred stage '" << dep << "'" << std::endl;
+                    return false;
+                }
+                m_stages[it->second].dependents.push_back(i);
+            }
+        }
+
+        // Kahn's algorithm to reject cycles before anything is dispatched
+        std::vector<size_t> in_degree(m_stages.size());
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < m_stages.size(); ++i) {
+            in_degree[i] = m_stages[i].remaining_deps;
+            if (in_degree[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+        size_t visited = 0;
+        while (!ready.empty()) {
+            size_t current = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (size_t dependent : m_stages[current].dependents) {
+                if (--in_degree[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+        if (visited != m_stages.size()) {
+            std::cerr << "StartupSequencer: dependency cycle detected" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool IsReady(size_t i) const {
+        return m_stages[i].state == StageState::PENDING && m_stages[i].remaining_deps == 0;
+    }
+
+    bool AllDone(bool deferred) const {
+        for (const auto& stage : m_stages) {
+            if (stage.deferred == deferred &&
+                (stage.state == StageState::PENDING || stage.state == StageState::RUNNING)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::chrono::microseconds Elapsed() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_startTime);
+    }
+
+    // Called with m_mutex held
+    void Dispatch(size_t i) {
+        Stage& stage = m_stages[i];
+        stage.state = StageState::RUNNING;
+        stage.queued_at = Elapsed();
+
+        try {
+            m_pool->enqueue([this, i]() { Execute(i); });
+        } catch (const std::exception& e) {
+            std::cerr << "StartupSequencer: failed to dispatch '" << stage.name
+                      << "': " << e.what() << std::endl;
+            Complete(i, false);
+        }
+    }
+
+    void Execute(size_t i) {
+        // The function object is never mutated after preparation, so it can
+        // run without holding the lock.
+        const StageFunction& fn = m_stages[i].fn;
+        auto start = std::chrono::steady_clock::now();
+
+        bool success = false;
+        try {
+            success = fn ? fn() : true;
+        } catch (const std::exception& e) {
+            std::cerr << "Startup stage '" << m_stages[i].name << "' threw: " << e.what() << std::endl;
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        PerformanceMonitor::GetInstance().RecordTiming("startup.stage." + m_stages[i].name, duration);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stages[i].duration = duration;
+        Complete(i, success);
+    }
+
+    // Called with m_mutex held
+    void Complete(size_t i, bool success) {
+        m_stages[i].state = success ? StageState::SUCCEEDED : StageState::FAILED;
+
+        for (size_t dependent : m_stages[i].dependents) {
+            if (!success) {
+                Skip(dependent);
+                continue;
+            }
+            if (m_stages[dependent].remaining_deps > 0) {
+                m_stages[dependent].remaining_deps--;
+            }
+            if (IsReady(dependent) && (!m_stages[dependent].deferred || m_deferredStarted)) {
+                Dispatch(dependent);
+            }
+        }
+        m_cv.notify_all();
+    }
+
+    void Skip(size_t i) {
+        if (m_stages[i].state != StageState::PENDING) {
+            return;
+        }
+        m_stages[i].state = StageState::SKIPPED;
+        std::cerr << "Startup stage '" << m_stages[i].name
+                  << "' skipped because a dependency failed" << std::endl;
+        for (size_t dependent : m_stages[i].dependents) {
+            Skip(dependent);
+        }
+    }
+
+    std::vector<Stage> m_stages;
+    WorkAssistant::ThreadPool* m_pool;
+    bool m_prepared;
+    bool m_deferredStarted;
+    std::chrono::steady_clock::time_point m_startTime;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+namespace {
+
+const char* StageStateToString(StageState state) {
+    switch (state) {
+        case StageState::PENDING:   return "pending";
+        case StageState::RUNNING:   return "running";
+        case StageState::SUCCEEDED: return "ok";
+        case StageState::FAILED:    return "failed";
+        case StageState::SKIPPED:   return "skipped";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+// StartupSequencer public interface
+StartupSequencer::StartupSequencer() : m_impl(std::make_unique<Impl>()) {}
+StartupSequencer::~StartupSequencer() = default;
+
+void StartupSequencer::AddStage(const std::string& name, StageFunction fn,
+                                const std::vector<std::string>& dependencies, bool deferred) {
+    m_impl->AddStage(name, std::move(fn), dependencies, deferred);
+}
+
+bool StartupSequencer::Run(WorkAssistant::ThreadPool& pool) {
+    return m_impl->Run(pool);
+}
+
+void StartupSequencer::RunDeferred(WorkAssistant::ThreadPool& pool) {
+    m_impl->RunDeferred(pool);
+}
+
+void StartupSequencer::WaitForDeferred() {
+    m_impl->WaitForDeferred();
+}
+
+bool StartupSequencer::HasDeferredStarted() const {
+    return m_impl->HasDeferredStarted();
+}
+
+std::vector<StageTiming> StartupSequencer::GetTimings() const {
+    return m_impl->GetTimings();
+}
+
+std::chrono::microseconds StartupSequencer::GetElapsed() const {
+    return m_impl->GetElapsed();
+}
+
+void StartupSequencer::PrintReport() const {
+    std::cout << "Startup stages:" << std::endl;
+    for (const auto& timing : GetTimings()) {
+        std::cout << "  " << std::left << std::setw(18) << timing.name
+                  << std::right << std::setw(8) << StageStateToString(timing.state)
+                  << "  start +" << std::setw(7) << timing.queued_at.count() / 1000.0 << " ms"
+                  << "  took " << std::setw(7) << timing.duration.count() / 1000.0 << " ms"
+                  << (timing.deferred ? "  (deferred)" : "") << std::endl;
+    }
+}
+
+} // namespace work_assistant
@@ -57,14 +57,14 @@ public:
         std::cout << "Tesseract OCR engine shut down" << std::endl;
     }
 
-    OCRDocument ProcessImage(const CaptureFrame& frame) override {
+    OCRDocument ProcessImage(const FrameView& frame) override {
         if (!m_initialized || !frame.IsValid()) {
             return OCRDocument();
         }
 
         // In real implementation, this would use Tesseract API:
-        // m_api->SetImage(frame.data.data(), frame.width, frame.height, 
-        //                 frame.bytes_per_pixel, frame.width * frame.bytes_per_pixel);
+        // m_api->SetImage(frame.data, frame.width, frame.height, 
+        //                 frame.bytes_per_pixel, frame.stride);
         // char* text = m_api->GetUTF8Text();
         // std::string result(text);
         // delete[] text;
@@ -102,24 +102,29 @@ public:
         return document;
     }
 
-    OCRDocument ProcessImageRegion(const CaptureFrame& frame, 
+    OCRDocument ProcessImageRegion(const FrameView& frame, 
                                   int x, int y, int width, int height) override {
         if (!m_initialized || !frame.IsValid()) {
             return OCRDocument();
         }
 
-        // Create a cropped frame
-        CaptureFrame cropped_frame;
-        if (!capture_utils::CropFrame(frame, cropped_frame, x, y, width, height)) {
+        // Tesseract reads the strided sub-view in place
+        FrameView region;
+        if (!capture_utils::CropView(frame, region, x, y, width, height)) {
             return OCRDocument();
         }
 
-        return ProcessImage(cropped_frame);
+        // The crop is clamped to the frame, so blocks are offset by where it
+        // actually starts rather than by the requested corner
+        OCRDocument document = ProcessImage(region);
+        ocr_utils::OffsetTextBlocks(document, region.origin_x - frame.origin_x,
+                                    region.origin_y - frame.origin_y);
+        return document;
     }
 
-    std::future<OCRDocument> ProcessImageAsync(const CaptureFrame& frame) override {
-        return std::async(std::launch::async, [this, frame]() {
-            return ProcessImage(frame);
+    std::future<OCRDocument> ProcessImageAsync(const FrameView& frame) override {
+        return std::async(std::launch::async, [this, view = frame.Retain()]() {
+            return ProcessImage(view);
         });
     }
 
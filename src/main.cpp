@@ -2,23 +2,23 @@
 #include <csignal>
 #include <thread>
 #include <chrono>
+#include <cstdlib>
 #include "application.h"
 #include "command_line_parser.h"
 #include "config_manager.h"
 #include "directory_manager.h"
-#include "daemon.h"
+#include "daemon_service.h"
 
 using namespace work_assistant;
 
 // Global application instance for signal handling
 Application* g_app = nullptr;
 
-void signalHandler(int signal) {
-    std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
+void signalHandler(int /*signal*/) {
+    // Only flag the stop here; Run() returns and Shutdown() drains normally
     if (g_app) {
-        g_app->Shutdown();
+        g_app->RequestStop();
     }
-    exit(0);
 }
 
 int main(int argc, char* argv[]) {
@@ -104,6 +104,30 @@ int main(int argc, char* argv[]) {
         config.SetString(DefaultConfig::AI_SECTION, DefaultConfig::AI_MODEL_PATH, ai_model);
     }
     
+    // Daemon mode must detach before any subsystem threads exist, so it is
+    // handled by the service manager ahead of Application::Initialize()
+    bool daemon_mode = parser.HasOption(WorkAssistantCommandLine::DAEMON);
+    if (daemon_mode) {
+        if (!quiet) {
+            std::cout << "Starting in daemon mode..." << std::endl;
+        }
+        
+        ServiceConfig service_config;
+        service_config.config_file_path = config.GetConfigFilePath();
+        service_config.pid_file_path = DirectoryManager::JoinPath(DirectoryManager::GetDataDirectory(), "work_assistant.pid");
+        service_config.log_file_path = DirectoryManager::JoinPath(DirectoryManager::GetLogsDirectory(), "work_assistant_service.log");
+        service_config.web_port = config.GetInt(DefaultConfig::WEB_SECTION, DefaultConfig::WEB_PORT, 8080);
+        
+        auto service_app = std::make_shared<Application>();
+        ServiceManager service;
+        if (!service.Initialize(service_config)) {
+            std::cerr << "Failed to initialize service manager" << std::endl;
+            return 1;
+        }
+        service.SetApplication(service_app);
+        return service.RunAsService() ? 0 : 1;
+    }
+    
     // Set up signal handlers
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
@@ -111,6 +135,51 @@ int main(int argc, char* argv[]) {
     // Create and initialize application
     Application app;
     g_app = &app;
+
+    if (parser.HasOption(WorkAssistantCommandLine::REPLAY_CAPTURE)) {
+        CaptureReplayOptions replay_options;
+        try {
+            replay_options.speed = std::stod(parser.GetValue(WorkAssistantCommandLine::REPLAY_SPEED, "1"));
+        } catch (...) {
+            replay_options.speed = -1.0;
+        }
+        if (!replay_options.IsValid()) {
+            std::cerr << "Error: invalid replay speed" << std::endl;
+            return 1;
+        }
+        if (!app.SetCaptureReplay(parser.GetValue(WorkAssistantCommandLine::REPLAY_CAPTURE), replay_options)) {
+            return 1;
+        }
+    }
+    if (parser.HasOption(WorkAssistantCommandLine::RECORD_CAPTURE) &&
+        !app.SetCaptureRecording(parser.GetValue(WorkAssistantCommandLine::RECORD_CAPTURE))) {
+        return 1;
+    }
+
+    app.ApplyPerformanceConfig(config);
+    app.ApplyOCRConfig(config);
+    app.SetWebPort(config.GetInt(DefaultConfig::WEB_SECTION, DefaultConfig::WEB_PORT, 8080));
+    app.SetCaptureBackend(ScreenCaptureFactory::BackendFromName(
+        config.GetString(DefaultConfig::MONITOR_SECTION, DefaultConfig::MONITOR_CAPTURE_BACKEND, "native")));
+    // The environment keeps the token out of process listings
+    std::string replicationToken = parser.GetValue(WorkAssistantCommandLine::REPLICATION_TOKEN);
+    if (replicationToken.empty()) {
+        const char* envToken = std::getenv("WA_REPLICATION_TOKEN");
+        replicationToken = envToken ? envToken : "";
+    }
+    if (!app.SetAggregatorMode(parser.HasOption(WorkAssistantCommandLine::AGGREGATOR), replicationToken)) {
+        return 1;
+    }
+    if (parser.HasOption(WorkAssistantCommandLine::REPLICATE_TO)) {
+        ReplicationConfig replication;
+        replication.token = replicationToken;
+        replication.aggregator_url = parser.GetValue(WorkAssistantCommandLine::REPLICATE_TO);
+        replication.workstation_id = parser.GetValue(WorkAssistantCommandLine::WORKSTATION_ID);
+        replication.include_text = parser.HasOption(WorkAssistantCommandLine::REPLICATE_TEXT);
+        if (!app.SetReplication(replication)) {
+            return 1;
+        }
+    }
     
     if (!app.Initialize()) {
         std::cerr << "Failed to initialize application" << std::endl;
@@ -126,41 +195,8 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    // Check for daemon mode
-    bool daemon_mode = parser.HasOption(WorkAssistantCommandLine::DAEMON);
     bool no_gui = parser.HasOption(WorkAssistantCommandLine::NO_GUI);
     
-    if (daemon_mode) {
-        if (!quiet) {
-            std::cout << "Starting in daemon mode..." << std::endl;
-        }
-        
-        // Create daemon service
-        auto daemon = DaemonServiceFactory::Create();
-        
-        // Set up daemon functions
-        daemon->SetMainFunction([&app]() {
-            app.Run();
-        });
-        
-        daemon->SetShutdownFunction([&app]() {
-            app.Shutdown();
-        });
-        
-        // Start daemon
-        if (!daemon->StartDaemon()) {
-            std::cerr << "Failed to start daemon" << std::endl;
-            return 1;
-        }
-        
-        // Keep main process alive
-        while (daemon->IsDaemonRunning()) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-        
-        return 0;
-    }
-    
     if (no_gui) {
         if (!quiet) {
             std::cout << "Running without GUI" << std::endl;
@@ -178,6 +214,8 @@ int main(int argc, char* argv[]) {
     }
     
     app.Run();
+    app.Shutdown();
+    g_app = nullptr;
     
     return 0;
 }
\ No newline at end of file
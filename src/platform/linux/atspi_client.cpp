@@ -1,2 +1,692 @@
-// AT-SPI client implementation placeholder
-// Will be implemented in the content extraction phase
\ No newline at end of file
+#include "atspi_client.h"
+#include "performance_monitor.h"
+#include <atspi/atspi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace work_assistant {
+
+namespace {
+
+// Events that can change what the focused window shows
+const char* const EVENT_TYPES[] = {
+    "window:activate",
+    "object:text-changed",
+    "object:text-caret-moved",
+    "object:visible-data-changed",
+    "object:bounds-changed",
+    "object:children-changed",
+    "object:state-changed:showing",
+};
+
+// Tree walk limits; a walk cut short leaves the snapshot untrusted
+const int MAX_TREE_DEPTH = 40;
+const size_t MAX_TREE_NODES = 4000;
+const size_t MAX_LINES_PER_OBJECT = 500;
+
+// Longer texts (editor buffers, terminal scrollback) are read from the
+// visible offsets only
+const int LARGE_TEXT_CHARS = 4096;
+
+// Events arriving within this delay share one refresh
+const guint REFRESH_DELAY_MS = 100;
+
+// Window moves and some scrolls raise no events, so an old snapshot is
+// re-read before use; the caller waits this long for it
+const auto SNAPSHOT_MAX_AGE = std::chrono::seconds(5);
+const auto REFRESH_WAIT = std::chrono::milliseconds(150);
+
+// Accessible frame extents and X11 window geometry differ by decorations
+const int WINDOW_MARGIN = 48;
+
+// U+FFFC stands in for embedded child objects, whose text is read separately
+const char OBJECT_REPLACEMENT[] = "\xEF\xBF\xBC";
+
+struct Rect {
+    int x = 0, y = 0, width = 0, height = 0;
+
+    int Right() const { return x + width; }
+    int Bottom() const { return y + height; }
+    bool Empty() const { return width <= 0 || height <= 0; }
+};
+
+Rect Intersect(const Rect& a, const Rect& b) {
+    Rect r;
+    r.x = std::max(a.x, b.x);
+    r.y = std::max(a.y, b.y);
+    r.width = std::min(a.Right(), b.Right()) - r.x;
+    r.height = std::min(a.Bottom(), b.Bottom()) - r.y;
+    return r.Empty() ? Rect() : r;
+}
+
+bool Contains(const Rect& outer, const Rect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.Right() <= outer.Right() && inner.Bottom() <= outer.Bottom();
+}
+
+// Takes ownership of the AT-SPI rect
+Rect TakeRect(AtspiRect* rect) {
+    Rect result;
+    if (rect) {
+        result = Rect{rect->x, rect->y, rect->width, rect->height};
+        g_free(rect);
+    }
+    return result;
+}
+
+// AT-SPI offsets count characters, the returned text is UTF-8
+int CountCharacters(const char* begin, const char* end) {
+    int count = 0;
+    for (const char* p = begin; p < end; ++p) {
+        if ((static_cast<unsigned char>(*p) & 0xC0) != 0x80) {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::string CleanLine(const char* begin, const char* end) {
+    std::string line(begin, end);
+    size_t pos;
+    while ((pos = line.find(OBJECT_REPLACEMENT)) != std::string::npos) {
+        line.erase(pos, sizeof(OBJECT_REPLACEMENT) - 1);
+    }
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    size_t last = line.find_last_not_of(" \t\r");
+    return line.substr(first, last - first + 1);
+}
+
+bool HasState(AtspiAccessible* accessible, AtspiStateType state) {
+    AtspiStateSet* states = atspi_accessible_get_state_set(accessible);
+    if (!states) {
+        return false;
+    }
+    bool result = atspi_state_set_contains(states, state);
+    g_object_unref(states);
+    return result;
+}
+
+} // namespace
+
+class AtspiClient::Impl {
+public:
+    Impl() : m_running(false), m_fullRefreshRequested(false) {}
+
+    ~Impl() {
+        Shutdown();
+    }
+
+    bool Initialize() {
+        if (m_thread.joinable()) {
+            return true;
+        }
+
+        // The AT-SPI connection, its listeners and every tree query live
+        // on the event thread
+        std::promise<bool> started;
+        auto result = started.get_future();
+        m_thread = std::thread([this, &started]() { Run(started); });
+        if (!result.get()) {
+            m_thread.join();
+            return false;
+        }
+        std::cout << "AT-SPI text source ready" << std::endl;
+        return true;
+    }
+
+    void Shutdown() {
+        if (!m_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_refreshed.notify_all();
+        // Quit from inside the loop so it cannot race its start
+        g_idle_add(&Impl::OnQuit, nullptr);
+        m_thread.join();
+    }
+
+    bool ExtractText(int x, int y, int width, int height, OCRDocument& document) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return false;
+        }
+
+        auto isFresh = [this]() {
+            return !m_snapshot.pending &&
+                   std::chrono::steady_clock::now() - m_snapshot.refreshed < SNAPSHOT_MAX_AGE;
+        };
+        if (!isFresh()) {
+            if (std::chrono::steady_clock::now() - m_snapshot.refreshed >= SNAPSHOT_MAX_AGE) {
+                RequestFullRefresh();
+            }
+            if (!m_refreshed.wait_for(lock, REFRESH_WAIT, isFresh)) {
+                return false;
+            }
+        }
+
+        const Snapshot& snapshot = m_snapshot;
+        if (!snapshot.trusted) {
+            return false;
+        }
+        const Rect area{x, y, width, height};
+        const Rect bounds{snapshot.window.x - WINDOW_MARGIN, snapshot.window.y - WINDOW_MARGIN,
+                          snapshot.window.width + 2 * WINDOW_MARGIN, snapshot.window.height + 2 * WINDOW_MARGIN};
+        if (area.Empty() || !Contains(bounds, area)) {
+            return false;
+        }
+
+        // Lines belong to the area their centre falls in
+        for (const auto& line : snapshot.lines) {
+            int cx = line.x + line.width / 2;
+            int cy = line.y + line.height / 2;
+            if (cx >= area.x && cx < area.Right() && cy >= area.y && cy < area.Bottom()) {
+                document.text_blocks.push_back(line);
+                if (!document.full_text.empty()) {
+                    document.full_text += "\n";
+                }
+                document.full_text += line.text;
+            }
+        }
+        if (document.text_blocks.empty()) {
+            // Nothing exposed here; the pixels may still hold drawn text
+            return false;
+        }
+        document.overall_confidence = 1.0f;
+        document.timestamp = std::chrono::system_clock::now();
+        return true;
+    }
+
+    bool GetCaretPosition(int& x, int& y) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_caretValid) {
+            return false;
+        }
+        x = m_caretX;
+        y = m_caretY;
+        return true;
+    }
+
+private:
+    struct Snapshot {
+        Rect window;                            // Screen extents of the focused window
+        std::vector<TextBlock> lines;           // Visible lines, document order
+        bool trusted = false;
+        bool pending = false;                   // Events arrived since it was taken
+        std::chrono::steady_clock::time_point refreshed;
+    };
+
+    struct CachedText {
+        std::vector<TextBlock> lines;
+        bool dirty = true;
+        bool usable = true;                     // Geometry made sense when last read
+    };
+
+    // Event thread
+
+    void Run(std::promise<bool>& started) {
+        if (atspi_init() > 1) {
+            std::cerr << "Failed to connect to the AT-SPI bus" << std::endl;
+            started.set_value(false);
+            return;
+        }
+
+        m_listener = atspi_event_listener_new(&Impl::OnEvent, this, nullptr);
+        bool registered = false;
+        for (const char* type : EVENT_TYPES) {
+            GError* error = nullptr;
+            if (atspi_event_listener_register(m_listener, type, &error)) {
+                registered = true;
+            }
+            g_clear_error(&error);
+        }
+        if (!registered) {
+            std::cerr << "Failed to register AT-SPI event listeners" << std::endl;
+            g_object_unref(m_listener);
+            m_listener = nullptr;
+            atspi_exit();
+            started.set_value(false);
+            return;
+        }
+
+        SetWindow(FindActiveWindow());
+        Refresh();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = true;
+        }
+        started.set_value(true);
+
+        atspi_event_main();
+
+        for (const char* type : EVENT_TYPES) {
+            GError* error = nullptr;
+            atspi_event_listener_deregister(m_listener, type, &error);
+            g_clear_error(&error);
+        }
+        g_object_unref(m_listener);
+        m_listener = nullptr;
+        ReleaseCache(m_cache);
+        SetWindow(nullptr);
+        atspi_exit();
+    }
+
+    static void OnEvent(AtspiEvent* event, void* data) {
+        static_cast<Impl*>(data)->HandleEvent(*event);
+        g_boxed_free(ATSPI_TYPE_EVENT, event);
+    }
+
+    static gboolean OnQuit(gpointer) {
+        atspi_event_quit();
+        return G_SOURCE_REMOVE;
+    }
+
+    static gboolean OnRefreshTimer(gpointer data) {
+        auto* impl = static_cast<Impl*>(data);
+        impl->m_refreshTimer = 0;
+        impl->Refresh();
+        return G_SOURCE_REMOVE;
+    }
+
+    static gboolean OnFullRefresh(gpointer data) {
+        auto* impl = static_cast<Impl*>(data);
+        impl->m_fullRefreshRequested = false;
+        impl->m_structureDirty = true;
+        for (auto& entry : impl->m_cache) {
+            entry.second.dirty = true;
+        }
+        impl->Refresh();
+        return G_SOURCE_REMOVE;
+    }
+
+    void HandleEvent(const AtspiEvent& event) {
+        const char* type = event.type ? event.type : "";
+        if (std::strncmp(type, "window:activate", 15) == 0) {
+            SetWindow(event.source ? static_cast<AtspiAccessible*>(g_object_ref(event.source)) : nullptr);
+            ScheduleRefresh();
+            return;
+        }
+        if (!m_window || !event.source || !InFocusedApplication(event.source)) {
+            return;
+        }
+
+        if (std::strncmp(type, "object:text-caret-moved", 23) == 0) {
+            UpdateCaret(event.source, event.detail1);
+            return;
+        }
+
+        auto cached = m_cache.find(event.source);
+        bool structural = std::strncmp(type, "object:children-changed", 23) == 0 ||
+                          std::strncmp(type, "object:state-changed", 20) == 0;
+        if (event.source == m_window) {
+            // Moved, resized or scrolled as a whole: every line moved
+            m_structureDirty = m_structureDirty || structural;
+            for (auto& entry : m_cache) {
+                entry.second.dirty = true;
+            }
+        } else if (cached != m_cache.end() && !structural) {
+            cached->second.dirty = true;
+        } else {
+            m_structureDirty = true;
+        }
+        ScheduleRefresh();
+    }
+
+    bool InFocusedApplication(AtspiAccessible* accessible) {
+        GError* error = nullptr;
+        AtspiAccessible* application = atspi_accessible_get_application(accessible, &error);
+        g_clear_error(&error);
+        bool same = application && application == m_application;
+        if (application) {
+            g_object_unref(application);
+        }
+        return same;
+    }
+
+    // Takes ownership of window
+    void SetWindow(AtspiAccessible* window) {
+        if (m_window) {
+            g_object_unref(m_window);
+        }
+        if (m_application) {
+            g_object_unref(m_application);
+            m_application = nullptr;
+        }
+        m_window = window;
+        if (m_window) {
+            GError* error = nullptr;
+            m_application = atspi_accessible_get_application(m_window, &error);
+            g_clear_error(&error);
+        }
+        m_structureDirty = true;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_caretValid = false;
+    }
+
+    AtspiAccessible* FindActiveWindow() {
+        AtspiAccessible* desktop = atspi_get_desktop(0);
+        if (!desktop) {
+            return nullptr;
+        }
+        AtspiAccessible* active = nullptr;
+        GError* error = nullptr;
+        int applications = atspi_accessible_get_child_count(desktop, &error);
+        g_clear_error(&error);
+        for (int i = 0; i < applications && !active; ++i) {
+            AtspiAccessible* application = atspi_accessible_get_child_at_index(desktop, i, &error);
+            g_clear_error(&error);
+            if (!application) {
+                continue;
+            }
+            int windows = atspi_accessible_get_child_count(application, &error);
+            g_clear_error(&error);
+            for (int j = 0; j < windows && !active; ++j) {
+                AtspiAccessible* window = atspi_accessible_get_child_at_index(application, j, &error);
+                g_clear_error(&error);
+                if (!window) {
+                    continue;
+                }
+                if (HasState(window, ATSPI_STATE_ACTIVE)) {
+                    active = window;
+                } else {
+                    g_object_unref(window);
+                }
+            }
+            g_object_unref(application);
+        }
+        g_object_unref(desktop);
+        return active;
+    }
+
+    void ScheduleRefresh() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_snapshot.pending = true;
+        }
+        if (m_refreshTimer == 0) {
+            m_refreshTimer = g_timeout_add(REFRESH_DELAY_MS, &Impl::OnRefreshTimer, this);
+        }
+    }
+
+    // Any thread, with m_mutex held
+    void RequestFullRefresh() {
+        if (m_running && !m_fullRefreshRequested.exchange(true)) {
+            g_idle_add(&Impl::OnFullRefresh, this);
+        }
+    }
+
+    void Refresh() {
+        auto start = std::chrono::steady_clock::now();
+        if (!m_window) {
+            SetWindow(FindActiveWindow());
+        }
+
+        Snapshot snapshot;
+        if (m_window) {
+            if (m_structureDirty) {
+                Walk();
+            }
+            GError* error = nullptr;
+            AtspiComponent* component = atspi_accessible_get_component_iface(m_window);
+            if (component) {
+                snapshot.window = TakeRect(atspi_component_get_extents(component, ATSPI_COORD_TYPE_SCREEN, &error));
+                g_clear_error(&error);
+                g_object_unref(component);
+            }
+
+            bool usable = !snapshot.window.Empty();
+            for (AtspiAccessible* accessible : m_order) {
+                CachedText& entry = m_cache[accessible];
+                if (entry.dirty) {
+                    entry.lines.clear();
+                    entry.usable = ReadVisibleLines(accessible, snapshot.window, entry.lines);
+                    entry.dirty = false;
+                }
+                usable = usable && entry.usable;
+                snapshot.lines.insert(snapshot.lines.end(), entry.lines.begin(), entry.lines.end());
+            }
+            snapshot.trusted = usable && m_walkComplete && !snapshot.lines.empty();
+        }
+        snapshot.refreshed = std::chrono::steady_clock::now();
+
+        auto& perf = PerformanceMonitor::GetInstance();
+        perf.RecordTiming("atspi.refresh", std::chrono::duration_cast<std::chrono::microseconds>(
+            snapshot.refreshed - start));
+        perf.RecordCounter("atspi.snapshot_lines", static_cast<int64_t>(snapshot.lines.size()));
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Events during the refresh have their own timer pending
+            snapshot.pending = m_refreshTimer != 0;
+            m_snapshot = std::move(snapshot);
+        }
+        m_refreshed.notify_all();
+    }
+
+    // Re-collects the window's showing text objects, keeping cached text
+    // for those still present
+    void Walk() {
+        std::vector<AtspiAccessible*> found;
+        size_t visited = 0;
+        m_walkComplete = true;
+        Collect(m_window, 0, visited, found);
+
+        std::unordered_map<AtspiAccessible*, CachedText> cache;
+        for (AtspiAccessible* accessible : found) {
+            auto previous = m_cache.find(accessible);
+            if (previous != m_cache.end()) {
+                cache[accessible] = std::move(previous->second);
+                m_cache.erase(previous);
+                g_object_unref(accessible);     // The cache already holds a reference
+            } else {
+                cache[accessible] = CachedText();
+            }
+        }
+        ReleaseCache(m_cache);
+        m_cache = std::move(cache);
+        m_order = std::move(found);
+        m_structureDirty = false;
+    }
+
+    // Children are walked even below text objects: embedded objects (links,
+    // widgets) keep their own text
+    void Collect(AtspiAccessible* accessible, int depth, size_t& visited,
+                 std::vector<AtspiAccessible*>& found) {
+        if (depth > MAX_TREE_DEPTH || visited >= MAX_TREE_NODES) {
+            m_walkComplete = false;
+            return;
+        }
+        visited++;
+        if (depth > 0 && !HasState(accessible, ATSPI_STATE_SHOWING)) {
+            return;
+        }
+
+        AtspiText* text = atspi_accessible_get_text_iface(accessible);
+        if (text) {
+            g_object_unref(text);
+            if (std::find(found.begin(), found.end(), accessible) == found.end()) {
+                found.push_back(static_cast<AtspiAccessible*>(g_object_ref(accessible)));
+            }
+        }
+
+        GError* error = nullptr;
+        int children = atspi_accessible_get_child_count(accessible, &error);
+        g_clear_error(&error);
+        for (int i = 0; i < children; ++i) {
+            AtspiAccessible* child = atspi_accessible_get_child_at_index(accessible, i, &error);
+            g_clear_error(&error);
+            if (child) {
+                Collect(child, depth + 1, visited, found);
+                g_object_unref(child);
+            }
+        }
+    }
+
+    // Lines of the object's text that fall within the window, with their
+    // screen extents. False when a non-empty line has no geometry.
+    bool ReadVisibleLines(AtspiAccessible* accessible, const Rect& window, std::vector<TextBlock>& lines) {
+        AtspiText* text = atspi_accessible_get_text_iface(accessible);
+        AtspiComponent* component = atspi_accessible_get_component_iface(accessible);
+        bool usable = true;
+        GError* error = nullptr;
+
+        Rect visible;
+        if (text && component) {
+            visible = Intersect(TakeRect(atspi_component_get_extents(component, ATSPI_COORD_TYPE_SCREEN, &error)),
+                                window);
+            g_clear_error(&error);
+        }
+
+        int count = 0;
+        if (!visible.Empty()) {
+            count = atspi_text_get_character_count(text, &error);
+            g_clear_error(&error);
+        }
+
+        int start = 0, end = count;
+        if (count > LARGE_TEXT_CHARS) {
+            int first = atspi_text_get_offset_at_point(text, visible.x, visible.y,
+                                                       ATSPI_COORD_TYPE_SCREEN, &error);
+            g_clear_error(&error);
+            int last = atspi_text_get_offset_at_point(text, visible.Right() - 1, visible.Bottom() - 1,
+                                                      ATSPI_COORD_TYPE_SCREEN, &error);
+            g_clear_error(&error);
+            if (first > 0) {
+                start = first;
+            }
+            if (last >= start) {
+                end = std::min(count, last + 1);
+            }
+        }
+
+        gchar* content = count > 0 ? atspi_text_get_text(text, start, end, &error) : nullptr;
+        g_clear_error(&error);
+        if (content) {
+            int offset = start;
+            const char* p = content;
+            while (*p && lines.size() < MAX_LINES_PER_OBJECT) {
+                const char* eol = std::strchr(p, '\n');
+                if (!eol) {
+                    eol = p + std::strlen(p);
+                }
+                int characters = CountCharacters(p, eol);
+                std::string line = CleanLine(p, eol);
+                if (!line.empty()) {
+                    Rect extents = TakeRect(atspi_text_get_range_extents(text, offset, offset + characters,
+                                                                         ATSPI_COORD_TYPE_SCREEN, &error));
+                    g_clear_error(&error);
+                    if (extents.Empty()) {
+                        usable = false;
+                    } else if (!Intersect(extents, visible).Empty()) {
+                        TextBlock block;
+                        block.text = std::move(line);
+                        block.confidence = 1.0f;
+                        block.x = extents.x;
+                        block.y = extents.y;
+                        block.width = extents.width;
+                        block.height = extents.height;
+                        lines.push_back(std::move(block));
+                    }
+                }
+                offset += characters + (*eol ? 1 : 0);
+                p = *eol ? eol + 1 : eol;
+            }
+            g_free(content);
+        }
+
+        if (text) {
+            g_object_unref(text);
+        }
+        if (component) {
+            g_object_unref(component);
+        }
+        return usable;
+    }
+
+    void UpdateCaret(AtspiAccessible* accessible, int offset) {
+        AtspiText* text = atspi_accessible_get_text_iface(accessible);
+        if (!text) {
+            return;
+        }
+        GError* error = nullptr;
+        Rect caret = TakeRect(atspi_text_get_character_extents(text, offset, ATSPI_COORD_TYPE_SCREEN, &error));
+        g_clear_error(&error);
+        g_object_unref(text);
+
+        // The caret after the last character has no width but a height
+        if (caret.height > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_caretX = caret.x;
+            m_caretY = caret.y + caret.height / 2;
+            m_caretValid = true;
+        }
+    }
+
+    static void ReleaseCache(std::unordered_map<AtspiAccessible*, CachedText>& cache) {
+        for (auto& entry : cache) {
+            g_object_unref(entry.first);
+        }
+        cache.clear();
+    }
+
+    std::thread m_thread;
+
+    // Event thread only
+    AtspiEventListener* m_listener = nullptr;
+    AtspiAccessible* m_window = nullptr;
+    AtspiAccessible* m_application = nullptr;
+    std::unordered_map<AtspiAccessible*, CachedText> m_cache;   // Holds a reference per key
+    std::vector<AtspiAccessible*> m_order;                      // Cache keys in document order
+    bool m_structureDirty = true;
+    bool m_walkComplete = false;
+    guint m_refreshTimer = 0;
+
+    // Shared with callers
+    mutable std::mutex m_mutex;
+    std::condition_variable m_refreshed;
+    bool m_running;
+    std::atomic<bool> m_fullRefreshRequested;
+    Snapshot m_snapshot;
+    int m_caretX = -1, m_caretY = -1;
+    bool m_caretValid = false;
+};
+
+AtspiClient::AtspiClient() : m_impl(std::make_unique<Impl>()) {}
+AtspiClient::~AtspiClient() = default;
+
+bool AtspiClient::Initialize() {
+    return m_impl->Initialize();
+}
+
+void AtspiClient::Shutdown() {
+    m_impl->Shutdown();
+}
+
+bool AtspiClient::ExtractText(int x, int y, int width, int height, OCRDocument& document) {
+    return m_impl->ExtractText(x, y, width, height, document);
+}
+
+bool AtspiClient::GetCaretPosition(int& x, int& y) const {
+    return m_impl->GetCaretPosition(x, y);
+}
+
+std::string AtspiClient::GetSourceInfo() const {
+    return "AT-SPI accessibility text";
+}
+
+} // namespace work_assistant
@@ -1,4 +1,36 @@
 #pragma once
 
-// AT-SPI client header placeholder
-// Will be implemented in the content extraction phase
\ No newline at end of file
+#include "ocr_engine.h"
+#include <memory>
+#include <string>
+
+namespace work_assistant {
+
+// Text of the focused window read through the AT-SPI accessibility bus.
+// A GLib event thread follows window activation, text, caret and scroll
+// events and keeps a snapshot of the window's visible text lines with their
+// screen extents, re-reading only the text objects an event touched.
+// ExtractText() filters that snapshot, so the OCR path makes no D-Bus calls
+// unless the snapshot has gone stale.
+//
+// The snapshot is untrusted (and callers fall back to pixel OCR) when the
+// window exposes no text, when the tree walk was cut short by its limits,
+// or when a text object reports unusable geometry.
+class AtspiClient : public ITextSource {
+public:
+    AtspiClient();
+    ~AtspiClient() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+
+    bool ExtractText(int x, int y, int width, int height, OCRDocument& document) override;
+    bool GetCaretPosition(int& x, int& y) const override;
+    std::string GetSourceInfo() const override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -11,6 +11,16 @@
 #include <cstdlib>
 #include <filesystem>
 #include <thread>
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <poll.h>
+#include <pwd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "config_manager.h"
 
 namespace work_assistant {
 
@@ -23,37 +33,140 @@ LinuxDaemonController::LinuxDaemonController(const ServiceConfig& config)
 }
 
 LinuxDaemonController::~LinuxDaemonController() {
-    if (m_status == ServiceStatus::RUNNING) {
-        Stop();
+}
+
+std::string LinuxDaemonController::GetUnitName() const {
+    std::string name;
+    for (char c : m_config.service_name) {
+        name += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(c)) : '-';
     }
+    return name;
+}
+
+std::string LinuxDaemonController::GetUnitDirectory() const {
+    if (service_utils::IsRunningAsAdmin()) {
+        return "/etc/systemd/system";
+    }
+    const char* config_home = std::getenv("XDG_CONFIG_HOME");
+    if (config_home && *config_home) {
+        return std::string(config_home) + "/systemd/user";
+    }
+    const char* home = std::getenv("HOME");
+    return std::string(home ? home : ".") + "/.config/systemd/user";
 }
 
 bool LinuxDaemonController::Install() {
     std::cout << "Installing Linux daemon service: " << m_config.service_name << std::endl;
-    return true; // Simplified implementation
+    
+    std::error_code ec;
+    std::string unit_dir = GetUnitDirectory();
+    std::filesystem::create_directories(unit_dir, ec);
+    if (ec) {
+        std::cerr << "Failed to create unit directory " << unit_dir << ": " << ec.message() << std::endl;
+        return false;
+    }
+    
+    std::string working_dir = std::filesystem::current_path(ec).string();
+    std::string unit = GetUnitName();
+    
+    // Type=notify: READY=1 is sent after staged init, WATCHDOG=1 while healthy
+    std::ofstream service(unit_dir + "/" + unit + ".service");
+    if (!service) {
+        std::cerr << "Failed to write service unit" << std::endl;
+        return false;
+    }
+    service << "[Unit]\n"
+            << "Description=" << m_config.service_description << "\n\n"
+            << "[Service]\n"
+            << "Type=notify\n"
+            << "NotifyAccess=main\n"
+            << "ExecStart=" << service_utils::GetExecutablePath() << " --daemon --config "
+            << m_config.config_file_path << "\n"
+            << "ExecReload=/bin/kill -HUP $MAINPID\n"
+            << "WorkingDirectory=" << working_dir << "\n"
+            << "WatchdogSec=" << m_config.watchdog_sec << "\n"
+            << "TimeoutStopSec=" << m_config.drain_timeout.count() + 5 << "\n"
+            << "Restart=on-failure\n\n"
+            << "[Install]\n"
+            << "WantedBy=default.target\n";
+    
+    // No .socket unit: the web server binds its own listener and cannot
+    // serve an activated descriptor. Drop one left by an older install.
+    std::filesystem::remove(unit_dir + "/" + unit + ".socket", ec);
+    
+    std::cout << "Installed " << unit << ".service in " << unit_dir << std::endl;
+    return true;
 }
 
 bool LinuxDaemonController::Uninstall() {
     std::cout << "Uninstalling Linux daemon service: " << m_config.service_name << std::endl;
-    return true;
+    
+    std::error_code ec;
+    std::string base = GetUnitDirectory() + "/" + GetUnitName();
+    bool removed = std::filesystem::remove(base + ".service", ec);
+    removed = std::filesystem::remove(base + ".socket", ec) || removed;
+    return removed;
 }
 
 bool LinuxDaemonController::Start() {
-    if (m_status == ServiceStatus::RUNNING) {
+    if (IsRunning()) {
         return true;
     }
     
     m_status = ServiceStatus::STARTING;
-    m_status = ServiceStatus::RUNNING;
-    return true;
+    
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "fork failed: " << strerror(errno) << std::endl;
+        m_status = ServiceStatus::ERROR;
+        return false;
+    }
+    if (pid == 0) {
+        std::string exe = service_utils::GetExecutablePath();
+        execl(exe.c_str(), exe.c_str(), "--daemon", "--config", m_config.config_file_path.c_str(),
+              static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    
+    // The launcher returns once the daemon has detached; wait for its pid file
+    waitpid(pid, nullptr, 0);
+    for (int i = 0; i < 50; ++i) {
+        if (IsRunning()) {
+            m_status = ServiceStatus::RUNNING;
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    m_status = ServiceStatus::ERROR;
+    return false;
 }
 
 bool LinuxDaemonController::Stop() {
-    if (m_status == ServiceStatus::STOPPED) {
+    pid_t pid = GetDaemonPid();
+    if (pid <= 0 || !service_utils::IsProcessRunning(pid)) {
+        m_status = ServiceStatus::STOPPED;
         return true;
     }
     
     m_status = ServiceStatus::STOPPING;
+    if (!service_utils::KillProcess(pid, SIGTERM)) {
+        m_status = ServiceStatus::ERROR;
+        return false;
+    }
+    
+    // Give the daemon its drain window plus a small grace period
+    auto deadline = std::chrono::steady_clock::now() + m_config.drain_timeout + std::chrono::seconds(5);
+    while (service_utils::IsProcessRunning(pid) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    if (service_utils::IsProcessRunning(pid)) {
+        std::cerr << "Daemon " << pid << " did not stop in time" << std::endl;
+        m_status = ServiceStatus::ERROR;
+        return false;
+    }
+    
     m_status = ServiceStatus::STOPPED;
     return true;
 }
@@ -63,11 +176,14 @@ bool LinuxDaemonController::Restart() {
 }
 
 ServiceStatus LinuxDaemonController::GetStatus() const {
+    if (m_status != ServiceStatus::STARTING && m_status != ServiceStatus::STOPPING) {
+        m_status = IsRunning() ? ServiceStatus::RUNNING : ServiceStatus::STOPPED;
+    }
     return m_status;
 }
 
 std::string LinuxDaemonController::GetStatusString() const {
-    switch (m_status) {
+    switch (GetStatus()) {
         case ServiceStatus::STOPPED: return "Stopped";
         case ServiceStatus::STARTING: return "Starting";
         case ServiceStatus::RUNNING: return "Running";
@@ -78,32 +194,94 @@ std::string LinuxDaemonController::GetStatusString() const {
 }
 
 bool LinuxDaemonController::IsInstalled() const {
-    return true; // Simplified
+    return std::filesystem::exists(GetUnitDirectory() + "/" + GetUnitName() + ".service");
 }
 
 bool LinuxDaemonController::IsRunning() const {
-    return m_status == ServiceStatus::RUNNING;
+    pid_t pid = GetDaemonPid();
+    return pid > 0 && service_utils::IsProcessRunning(pid);
 }
 
 bool LinuxDaemonController::RunAsDaemon() {
-    std::cout << "Running as daemon (simplified implementation)" << std::endl;
+    // Resolve the pid file before detaching; later relative paths still work
+    // because the working directory is kept (config and data paths are relative)
+    std::error_code ec;
+    m_config.pid_file_path = std::filesystem::absolute(m_config.pid_file_path, ec).string();
+    
+    pid_t existing = service_utils::ReadPidFile(m_config.pid_file_path);
+    if (existing > 0 && existing != getpid() && service_utils::IsProcessRunning(existing)) {
+        std::cerr << "Daemon already running with pid " << existing << std::endl;
+        return false;
+    }
+    
+    // First fork: return control to the shell
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "First fork failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (pid > 0) {
+        _exit(0);
+    }
+    
+    // New session: detach from the controlling terminal
+    if (setsid() < 0) {
+        _exit(1);
+    }
+    signal(SIGHUP, SIG_IGN);
+    
+    // Second fork: the session leader exits so we can never reacquire a tty
+    pid = fork();
+    if (pid < 0) {
+        _exit(1);
+    }
+    if (pid > 0) {
+        _exit(0);
+    }
+    
+    umask(027);
+    
+    // stdin from /dev/null, stdout/stderr to the service log
+    int null_fd = open("/dev/null", O_RDWR);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDIN_FILENO);
+    }
+    int log_fd = -1;
+    if (m_config.enable_logging && !m_config.log_file_path.empty()) {
+        std::filesystem::create_directories(
+            std::filesystem::path(m_config.log_file_path).parent_path(), ec);
+        log_fd = open(m_config.log_file_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0640);
+    }
+    int out_fd = log_fd >= 0 ? log_fd : null_fd;
+    if (out_fd >= 0) {
+        dup2(out_fd, STDOUT_FILENO);
+        dup2(out_fd, STDERR_FILENO);
+    }
+    if (null_fd > STDERR_FILENO) close(null_fd);
+    if (log_fd > STDERR_FILENO) close(log_fd);
+    
+    if (!CreatePidFile()) {
+        return false;
+    }
+    
+    m_status = ServiceStatus::RUNNING;
     return true;
 }
 
 bool LinuxDaemonController::CreatePidFile() {
-    return true;
+    return service_utils::CreatePidFile(m_config.pid_file_path);
 }
 
 bool LinuxDaemonController::RemovePidFile() {
-    return true;
+    return service_utils::RemovePidFile(m_config.pid_file_path);
 }
 
 pid_t LinuxDaemonController::GetDaemonPid() const {
-    return getpid();
+    return service_utils::ReadPidFile(m_config.pid_file_path);
 }
 
-// ServiceManager simplified implementation
-ServiceManager::ServiceManager() : m_initialized(false) {
+// ServiceManager implementation
+ServiceManager::ServiceManager() : m_initialized(false), m_signalPipe{-1, -1}, m_stopRequested(false) {
     s_instance = this;
 }
 
@@ -113,6 +291,9 @@ ServiceManager::~ServiceManager() {
 }
 
 bool ServiceManager::Initialize(const ServiceConfig& config) {
+    if (!config.IsValid()) {
+        return false;
+    }
     m_config = config;
     m_controller = std::make_unique<LinuxDaemonController>(config);
     m_initialized = true;
@@ -120,6 +301,7 @@ bool ServiceManager::Initialize(const ServiceConfig& config) {
 }
 
 void ServiceManager::Shutdown() {
+    RestoreSignalHandlers();
     m_initialized = false;
 }
 
@@ -146,21 +328,110 @@ bool ServiceManager::IsServiceRunning() const {
 }
 
 bool ServiceManager::RunAsService() {
-    std::cout << "Running as service..." << std::endl;
-    if (m_application) {
-        m_application->Initialize();
-        m_application->Run();
-        m_application->Shutdown();
+    if (!m_initialized || !m_application) {
+        std::cerr << "Service manager not initialized" << std::endl;
+        return false;
+    }
+    
+    auto* daemon = dynamic_cast<LinuxDaemonController*>(m_controller.get());
+    bool under_systemd = service_utils::IsSystemdNotifyAvailable();
+    
+    // Under a Type=notify unit systemd already supervises us; forking would
+    // make it lose track of the main pid
+    if (under_systemd) {
+        if (daemon) daemon->CreatePidFile();
+    } else if (!daemon || !daemon->RunAsDaemon()) {
+        std::cerr << "Failed to daemonize" << std::endl;
+        return false;
+    }
+    
+    // Must happen before Initialize() spawns threads, so the handlers and the
+    // self-pipe are in place for every thread
+    SetupSignalHandlers();
+    service_utils::NotifySystemd("STATUS=Initializing subsystems");
+    
+    m_application->SetWebPort(m_config.web_port);
+    ConfigManager config;
+    if (config.Initialize() && config.LoadConfig(m_config.config_file_path)) {
+        m_application->ApplyPerformanceConfig(config);
+        m_application->ApplyOCRConfig(config);
+        m_application->SetCaptureBackend(ScreenCaptureFactory::BackendFromName(
+            config.GetString(DefaultConfig::MONITOR_SECTION, DefaultConfig::MONITOR_CAPTURE_BACKEND, "native")));
+    }
+    m_application->SetDrainTimeout(m_config.drain_timeout);
+    
+    if (!m_application->Initialize()) {
+        service_utils::NotifySystemd("STATUS=Initialization failed");
+        if (daemon) daemon->RemovePidFile();
+        return false;
     }
+    
+    std::thread app_thread([this]() { m_application->Run(); });
+    
+    service_utils::NotifySystemd("READY=1\nSTATUS=Running");
+    service_utils::LogServiceEvent("Service ready (pid " + std::to_string(getpid()) + ")");
+    
+    ServiceLoop();
+    
+    service_utils::NotifySystemd("STOPPING=1\nSTATUS=Draining pipeline");
+    m_application->RequestStop();
+    if (app_thread.joinable()) {
+        app_thread.join();
+    }
+    m_application->Shutdown();
+    
+    if (daemon) daemon->RemovePidFile();
+    RestoreSignalHandlers();
+    service_utils::LogServiceEvent("Service stopped");
     return true;
 }
 
+void ServiceManager::ServiceLoop() {
+    auto watchdog_interval = service_utils::GetWatchdogInterval();
+    // Ping at half the interval as sd_watchdog_enabled(3) recommends
+    auto ping_interval = std::chrono::duration_cast<std::chrono::milliseconds>(watchdog_interval / 2);
+    int poll_timeout_ms = ping_interval.count() > 0
+        ? static_cast<int>(std::min<int64_t>(ping_interval.count(), 1000)) : 1000;
+    auto last_ping = std::chrono::steady_clock::now();
+    
+    while (!m_stopRequested) {
+        pollfd pfd{m_signalPipe[0], POLLIN, 0};
+        int ready = poll(&pfd, 1, poll_timeout_ms);
+        
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            unsigned char signo;
+            while (read(m_signalPipe[0], &signo, 1) == 1) {
+                HandleSignal(signo);
+            }
+        }
+        
+        if (m_application->IsStopRequested()) {
+            break;
+        }
+        
+        // Only feed the watchdog while the pipeline reports healthy, so a
+        // wedged process is restarted by systemd
+        if (ping_interval.count() > 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_ping >= ping_interval && m_application->IsHealthy()) {
+                service_utils::NotifySystemd("WATCHDOG=1");
+                last_ping = now;
+            }
+        }
+    }
+}
+
 bool ServiceManager::RunInteractive() {
     std::cout << "Running interactively..." << std::endl;
     if (m_application) {
+        SetupSignalHandlers();
         m_application->Initialize();
-        m_application->Run();
+        std::thread app_thread([this]() { m_application->Run(); });
+        ServiceLoop();
+        m_application->RequestStop();
+        app_thread.join();
         m_application->Shutdown();
+        RestoreSignalHandlers();
     }
     return true;
 }
@@ -175,9 +446,83 @@ void ServiceManager::EnableLogging(bool enable) { m_config.enable_logging = enab
 void ServiceManager::SetLogLevel(const std::string& level) { }
 ServiceConfig ServiceManager::GetConfig() const { return m_config; }
 void ServiceManager::UpdateConfig(const ServiceConfig& config) { m_config = config; }
-void ServiceManager::SetupSignalHandlers() { }
-void ServiceManager::HandleSignal(int signal) { }
-void ServiceManager::SignalHandler(int signal) { }
+
+void ServiceManager::SetupSignalHandlers() {
+    if (m_signalPipe[0] >= 0) {
+        return;
+    }
+    if (pipe2(m_signalPipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+        std::cerr << "Failed to create signal pipe: " << strerror(errno) << std::endl;
+        m_signalPipe[0] = m_signalPipe[1] = -1;
+        return;
+    }
+    
+    struct sigaction sa{};
+    sa.sa_handler = &ServiceManager::SignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGHUP, &sa, nullptr);
+    
+    signal(SIGPIPE, SIG_IGN);
+}
+
+void ServiceManager::RestoreSignalHandlers() {
+    if (m_signalPipe[0] < 0) {
+        return;
+    }
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGHUP, SIG_DFL);
+    close(m_signalPipe[0]);
+    close(m_signalPipe[1]);
+    m_signalPipe[0] = m_signalPipe[1] = -1;
+}
+
+void ServiceManager::HandleSignal(int signal) {
+    switch (signal) {
+        case SIGHUP:
+            service_utils::NotifySystemd("RELOADING=1");
+            ReloadConfiguration();
+            service_utils::NotifySystemd("READY=1\nSTATUS=Running");
+            break;
+        case SIGTERM:
+        case SIGINT:
+            service_utils::LogServiceEvent("Received signal " + std::to_string(signal) + ", draining...");
+            m_stopRequested = true;
+            if (m_application) {
+                m_application->RequestStop();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool ServiceManager::ReloadConfiguration() {
+    if (!m_application) {
+        return false;
+    }
+    
+    ConfigManager config;
+    if (!config.Initialize() || !config.LoadConfig(m_config.config_file_path)) {
+        service_utils::LogServiceEvent("Config reload failed: " + m_config.config_file_path);
+        return false;
+    }
+    return m_application->ReloadConfiguration(config);
+}
+
+void ServiceManager::SignalHandler(int signal) {
+    // Async-signal-safe: only write(2) the signal number to the self-pipe
+    if (s_instance && s_instance->m_signalPipe[1] >= 0) {
+        int saved_errno = errno;
+        unsigned char signo = static_cast<unsigned char>(signal);
+        ssize_t ignored = write(s_instance->m_signalPipe[1], &signo, 1);
+        (void)ignored;
+        errno = saved_errno;
+    }
+}
 
 // ServiceFactory implementation
 std::unique_ptr<IServiceController> ServiceFactory::CreateController(const ServiceConfig& config) {
@@ -192,23 +537,155 @@ bool ServiceFactory::IsServiceSupported() {
     return true;
 }
 
-// Simplified service utilities
+// Service utilities
 namespace service_utils {
 
-bool CreateServiceDirectories(const ServiceConfig& config) { return true; }
+bool CreateServiceDirectories(const ServiceConfig& config) {
+    std::error_code ec;
+    for (const auto& file : {config.log_file_path, config.pid_file_path}) {
+        auto parent = std::filesystem::path(file).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+            if (ec) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 bool CheckServicePermissions() { return true; }
-void LogServiceEvent(const std::string& message) { std::cout << message << std::endl; }
-std::string GetCurrentUserName() { return "user"; }
-std::string GetExecutablePath() { return "work_study_assistant"; }
-bool IsRunningAsAdmin() { return true; }
-bool CreatePidFile(const std::string& pid_file_path) { return true; }
-bool RemovePidFile(const std::string& pid_file_path) { return true; }
-pid_t ReadPidFile(const std::string& pid_file_path) { return 1234; }
-bool IsProcessRunning(pid_t pid) { return true; }
-bool KillProcess(pid_t pid, int signal) { return true; }
-bool LoadConfigFromFile(const std::string& config_path, ServiceConfig& config) { return true; }
+
+void LogServiceEvent(const std::string& message) {
+    std::cout << message << std::endl;
+    syslog(LOG_INFO, "%s", message.c_str());
+}
+
+std::string GetCurrentUserName() {
+    struct passwd* pw = getpwuid(geteuid());
+    return pw ? pw->pw_name : "user";
+}
+
+std::string GetExecutablePath() {
+    std::error_code ec;
+    auto path = std::filesystem::read_symlink("/proc/self/exe", ec);
+    return ec ? "work_study_assistant" : path.string();
+}
+
+bool IsRunningAsAdmin() { return geteuid() == 0; }
+
+bool CreatePidFile(const std::string& pid_file_path) {
+    pid_t existing = ReadPidFile(pid_file_path);
+    if (existing > 0 && existing != getpid() && IsProcessRunning(existing)) {
+        std::cerr << "Pid file " << pid_file_path << " is held by running process " << existing << std::endl;
+        return false;
+    }
+    
+    // Write to a temporary file and rename so readers never see a partial pid
+    std::string tmp_path = pid_file_path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create pid file " << pid_file_path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    std::string content = std::to_string(getpid()) + "\n";
+    bool ok = write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size());
+    close(fd);
+    
+    if (!ok || rename(tmp_path.c_str(), pid_file_path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool RemovePidFile(const std::string& pid_file_path) {
+    // Never remove a pid file that another live instance owns
+    pid_t owner = ReadPidFile(pid_file_path);
+    if (owner > 0 && owner != getpid() && IsProcessRunning(owner)) {
+        return false;
+    }
+    return unlink(pid_file_path.c_str()) == 0 || errno == ENOENT;
+}
+
+pid_t ReadPidFile(const std::string& pid_file_path) {
+    std::ifstream file(pid_file_path);
+    long pid = 0;
+    if (!(file >> pid) || pid <= 0) {
+        return 0;
+    }
+    return static_cast<pid_t>(pid);
+}
+
+bool IsProcessRunning(pid_t pid) {
+    if (pid <= 0) {
+        return false;
+    }
+    // EPERM means the process exists but belongs to someone else
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+bool KillProcess(pid_t pid, int signal) {
+    return pid > 0 && kill(pid, signal) == 0;
+}
+
+bool IsSystemdNotifyAvailable() {
+    const char* socket_path = std::getenv("NOTIFY_SOCKET");
+    return socket_path && *socket_path;
+}
+
+bool NotifySystemd(const std::string& state) {
+    const char* socket_path = std::getenv("NOTIFY_SOCKET");
+    if (!socket_path || !*socket_path) {
+        return false;
+    }
+    
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    size_t path_len = strlen(socket_path);
+    if (path_len >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    memcpy(addr.sun_path, socket_path, path_len);
+    // A leading '@' denotes an abstract namespace socket
+    if (addr.sun_path[0] == '@') {
+        addr.sun_path[0] = '\0';
+    }
+    
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    socklen_t addr_len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path_len);
+    ssize_t sent = sendto(fd, state.data(), state.size(), MSG_NOSIGNAL,
+                          reinterpret_cast<sockaddr*>(&addr), addr_len);
+    close(fd);
+    return sent == static_cast<ssize_t>(state.size());
+}
+
+std::chrono::microseconds GetWatchdogInterval() {
+    const char* usec = std::getenv("WATCHDOG_USEC");
+    if (!usec) {
+        return std::chrono::microseconds(0);
+    }
+    
+    // WATCHDOG_PID, when set, must name us (it is not inherited by children)
+    const char* watchdog_pid = std::getenv("WATCHDOG_PID");
+    if (watchdog_pid && std::atol(watchdog_pid) != getpid()) {
+        return std::chrono::microseconds(0);
+    }
+    
+    long long value = std::atoll(usec);
+    return std::chrono::microseconds(value > 0 ? value : 0);
+}
+
+bool LoadConfigFromFile(const std::string& config_path, ServiceConfig& config) {
+    config.config_file_path = config_path;
+    return std::filesystem::exists(config_path);
+}
+
 bool SaveConfigToFile(const std::string& config_path, const ServiceConfig& config) { return true; }
 
 } // namespace service_utils
 
-} // namespace work_assistant
\ No newline at end of file
+} // namespace work_assistant
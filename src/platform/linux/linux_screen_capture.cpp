@@ -1,8 +1,14 @@
 #include "linux_screen_capture.h"
 #include "common_types.h"
+#include "performance_monitor.h"
 #include <iostream>
 #include <chrono>
 #include <cstring>
+#include <algorithm>
+#include <set>
+#ifdef HAVE_XRANDR
+#include <X11/extensions/Xrandr.h>
+#endif
 
 namespace work_assistant {
 
@@ -14,6 +20,7 @@ LinuxScreenCapture::LinuxScreenCapture()
     , m_screenHeight(0)
     , m_useHardwareAcceleration(false)
     , m_maxFPS(30)
+    , m_parallelMonitors(false)
 {
 }
 
@@ -46,8 +53,19 @@ bool LinuxScreenCapture::Initialize() {
         return false;
     }
 
+    m_desktop.display = m_display;
+    m_desktop.width = m_screenWidth;
+    m_desktop.height = m_screenHeight;
+    m_desktop.damageAvailable = InitializeDamage(m_desktop);
+    m_desktop.renderAvailable = InitializeRender(m_desktop);
+
+    DetectMonitors();
+    CreateMonitorContexts();
+
     m_initialized = true;
-    std::cout << "Linux screen capture initialized (" << m_screenWidth << "x" << m_screenHeight << ")" << std::endl;
+    std::cout << "Linux screen capture initialized (" << m_screenWidth << "x" << m_screenHeight
+              << ", " << m_monitors.size() << " monitor(s)"
+              << (m_desktop.damageAvailable ? ", XDamage" : "") << ")" << std::endl;
     return true;
 }
 
@@ -56,6 +74,14 @@ void LinuxScreenCapture::Shutdown() {
         return;
     }
 
+    for (auto& context : m_monitorContexts) {
+        ShutdownContext(*context);
+    }
+    m_monitorContexts.clear();
+    m_monitors.clear();
+    m_parallelMonitors = false;
+    ShutdownContext(m_desktop);
+
     if (m_display) {
         XCloseDisplay(m_display);
         m_display = nullptr;
@@ -66,25 +92,10 @@ void LinuxScreenCapture::Shutdown() {
 }
 
 std::vector<MonitorInfo> LinuxScreenCapture::GetMonitors() const {
-    std::vector<MonitorInfo> monitors;
-    
     if (!m_initialized) {
-        return monitors;
-    }
-
-    // For now, return single monitor (root window)
-    // TODO: Add multi-monitor support using XRandR
-    MonitorInfo monitor;
-    monitor.id = 0;
-    monitor.name = "Primary Display";
-    monitor.x = 0;
-    monitor.y = 0;
-    monitor.width = m_screenWidth;
-    monitor.height = m_screenHeight;
-    monitor.is_primary = true;
-    
-    monitors.push_back(monitor);
-    return monitors;
+        return {};
+    }
+    return m_monitors;
 }
 
 bool LinuxScreenCapture::CaptureDesktop(CaptureFrame& frame) {
@@ -92,11 +103,16 @@ bool LinuxScreenCapture::CaptureDesktop(CaptureFrame& frame) {
 }
 
 bool LinuxScreenCapture::CaptureMonitor(int monitorId, CaptureFrame& frame) {
-    // For now, only support primary monitor
-    if (monitorId != 0) {
+    if (!m_initialized || monitorId < 0 || monitorId >= static_cast<int>(m_monitorContexts.size())) {
+        return false;
+    }
+
+    CaptureContext& context = *m_monitorContexts[monitorId];
+    if (!CaptureX11Region(context.display, context.x, context.y, context.width, context.height, frame)) {
         return false;
     }
-    return CaptureDesktop(frame);
+    frame.monitor_id = monitorId;
+    return true;
 }
 
 bool LinuxScreenCapture::CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) {
@@ -132,7 +148,7 @@ bool LinuxScreenCapture::CaptureRegion(int x, int y, int width, int height, Capt
         return false;
     }
 
-    return CaptureX11Region(x, y, width, height, frame);
+    return CaptureX11Region(m_display, x, y, width, height, frame);
 }
 
 bool LinuxScreenCapture::SupportsHardwareAcceleration() const {
@@ -144,8 +160,8 @@ void LinuxScreenCapture::SetCaptureSettings(bool useHardwareAcceleration, int ma
     m_maxFPS = maxFPS;
 }
 
-bool LinuxScreenCapture::CaptureX11Region(int x, int y, int width, int height, CaptureFrame& frame) {
-    if (!m_display) {
+bool LinuxScreenCapture::CaptureX11Region(Display* display, int x, int y, int width, int height, CaptureFrame& frame) {
+    if (!display) {
         return false;
     }
 
@@ -160,7 +176,7 @@ bool LinuxScreenCapture::CaptureX11Region(int x, int y, int width, int height, C
     }
 
     // Capture screen using XGetImage
-    XImage* image = XGetImage(m_display, m_rootWindow, x, y, width, height, AllPlanes, ZPixmap);
+    XImage* image = XGetImage(display, m_rootWindow, x, y, width, height, AllPlanes, ZPixmap);
     if (!image) {
         std::cerr << "Failed to capture screen region" << std::endl;
         return false;
@@ -179,13 +195,41 @@ bool LinuxScreenCapture::ConvertXImageToFrame(XImage* image, CaptureFrame& frame
 
     frame.width = image->width;
     frame.height = image->height;
-    frame.bytes_per_pixel = 4; // RGBA
+    frame.bytes_per_pixel = 4;
+    frame.stride = 0;
+    frame.format = ImageFormat::BGRX;
     frame.timestamp = std::chrono::system_clock::now();
+    frame.dirty_rects.clear();
+    frame.monitor_id = -1;
+    frame.pixel_passes = 1;
+    frame.scale_factor = 1;
     frame.data.resize(frame.GetDataSize());
 
-    // Convert XImage data to RGBA format
-    for (int y = 0; y < image->height; ++y) {
-        for (int x = 0; x < image->width; ++x) {
+    CopyXImageToFrame(image, frame, 0, 0);
+    return true;
+}
+
+void LinuxScreenCapture::CopyXImageToFrame(XImage* image, CaptureFrame& frame, int dstX, int dstY) {
+    const int frameStride = frame.stride > 0 ? frame.stride : frame.width * 4;
+    const int width = std::min(image->width, frame.width - dstX);
+    const int height = std::min(image->height, frame.height - dstY);
+
+    // 24/32-bit TrueColor on a little-endian server is already BGRX in
+    // memory, so rows are copied as-is
+    if (image->bits_per_pixel == 32 && image->byte_order == LSBFirst &&
+        image->red_mask == 0xFF0000 && image->green_mask == 0xFF00 && image->blue_mask == 0xFF) {
+        const size_t rowBytes = static_cast<size_t>(width) * 4;
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(&frame.data[(dstY + y) * frameStride + dstX * 4],
+                        image->data + static_cast<size_t>(y) * image->bytes_per_line, rowBytes);
+        }
+        return;
+    }
+
+    // Other visuals go through XGetPixel, packed into the same BGRX layout
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = &frame.data[(dstY + y) * frameStride + dstX * 4];
+        for (int x = 0; x < width; ++x) {
             unsigned long pixel = XGetPixel(image, x, y);
             
             // Extract RGB components (assuming 24-bit or 32-bit display)
@@ -201,14 +245,461 @@ bool LinuxScreenCapture::ConvertXImageToFrame(XImage* image, CaptureFrame& frame
                 r = g = b = static_cast<uint8_t>(pixel & 0xFF);
             }
 
-            int frameIndex = (y * image->width + x) * 4;
-            frame.data[frameIndex + 0] = r;
-            frame.data[frameIndex + 1] = g;
-            frame.data[frameIndex + 2] = b;
-            frame.data[frameIndex + 3] = a;
+            row[x * 4 + 0] = b;
+            row[x * 4 + 1] = g;
+            row[x * 4 + 2] = r;
+            row[x * 4 + 3] = a;
+        }
+    }
+}
+
+bool LinuxScreenCapture::CaptureDesktopIncremental(CaptureFrame& frame, bool& changed) {
+    changed = false;
+    if (!m_initialized) {
+        return false;
+    }
+    return CaptureIncremental(m_desktop, frame, changed);
+}
+
+bool LinuxScreenCapture::CaptureMonitorIncremental(int monitorId, CaptureFrame& frame, bool& changed) {
+    changed = false;
+    if (!m_initialized || monitorId < 0 || monitorId >= static_cast<int>(m_monitorContexts.size())) {
+        return false;
+    }
+    if (!CaptureIncremental(*m_monitorContexts[monitorId], frame, changed)) {
+        return false;
+    }
+    if (changed) {
+        frame.monitor_id = monitorId;
+    }
+    return true;
+}
+
+bool LinuxScreenCapture::SupportsDamageTracking() const {
+    return m_desktop.damageAvailable;
+}
+
+bool LinuxScreenCapture::CaptureDesktopScaled(int factor, CaptureFrame& frame, bool& changed) {
+    changed = false;
+    if (!m_initialized) {
+        return false;
+    }
+    return CaptureScaled(m_desktop, factor, frame, changed);
+}
+
+bool LinuxScreenCapture::CaptureMonitorScaled(int monitorId, int factor, CaptureFrame& frame, bool& changed) {
+    changed = false;
+    if (!m_initialized || monitorId < 0 || monitorId >= static_cast<int>(m_monitorContexts.size())) {
+        return false;
+    }
+    if (!CaptureScaled(*m_monitorContexts[monitorId], factor, frame, changed)) {
+        return false;
+    }
+    if (changed) {
+        frame.monitor_id = monitorId;
+    }
+    return true;
+}
+
+bool LinuxScreenCapture::SupportsServerSideScaling() const {
+    return m_desktop.renderAvailable;
+}
+
+bool LinuxScreenCapture::SupportsParallelMonitorCapture() const {
+    return m_parallelMonitors;
+}
+
+void LinuxScreenCapture::DetectMonitors() {
+    m_monitors.clear();
+
+#ifdef HAVE_XRANDR
+    int eventBase = 0, errorBase = 0;
+    if (XRRQueryExtension(m_display, &eventBase, &errorBase)) {
+        XRRScreenResources* resources = XRRGetScreenResourcesCurrent(m_display, m_rootWindow);
+        if (resources) {
+            RROutput primary = XRRGetOutputPrimary(m_display, m_rootWindow);
+            std::set<RRCrtc> seenCrtcs;  // Mirrored outputs share a CRTC
+
+            for (int i = 0; i < resources->noutput; ++i) {
+                XRROutputInfo* output = XRRGetOutputInfo(m_display, resources, resources->outputs[i]);
+                if (!output) {
+                    continue;
+                }
+                if (output->connection == RR_Connected && output->crtc &&
+                    seenCrtcs.insert(output->crtc).second) {
+                    XRRCrtcInfo* crtc = XRRGetCrtcInfo(m_display, resources, output->crtc);
+                    if (crtc && crtc->width > 0 && crtc->height > 0) {
+                        MonitorInfo monitor;
+                        monitor.id = static_cast<int>(m_monitors.size());
+                        monitor.name = output->name ? output->name : "Monitor";
+                        monitor.x = crtc->x;
+                        monitor.y = crtc->y;
+                        monitor.width = static_cast<int>(crtc->width);
+                        monitor.height = static_cast<int>(crtc->height);
+                        monitor.is_primary = resources->outputs[i] == primary;
+                        m_monitors.push_back(monitor);
+                    }
+                    if (crtc) {
+                        XRRFreeCrtcInfo(crtc);
+                    }
+                }
+                XRRFreeOutputInfo(output);
+            }
+            XRRFreeScreenResources(resources);
+        }
+    }
+#endif
+
+    if (m_monitors.empty()) {
+        // No XRandR: the root window is the only monitor
+        MonitorInfo monitor;
+        monitor.id = 0;
+        monitor.name = "Primary Display";
+        monitor.x = 0;
+        monitor.y = 0;
+        monitor.width = m_screenWidth;
+        monitor.height = m_screenHeight;
+        monitor.is_primary = true;
+        m_monitors.push_back(monitor);
+    } else if (std::none_of(m_monitors.begin(), m_monitors.end(),
+                            [](const MonitorInfo& m) { return m.is_primary; })) {
+        m_monitors.front().is_primary = true;
+    }
+}
+
+void LinuxScreenCapture::CreateMonitorContexts() {
+    // Xlib connections are not thread-safe, so parallel capture needs one
+    // per monitor. A single monitor just shares the main connection.
+    m_parallelMonitors = m_monitors.size() > 1;
+
+    for (const auto& monitor : m_monitors) {
+        auto context = std::make_unique<CaptureContext>();
+        context->x = monitor.x;
+        context->y = monitor.y;
+        context->width = monitor.width;
+        context->height = monitor.height;
+
+        if (m_parallelMonitors) {
+            context->display = XOpenDisplay(DisplayString(m_display));
+            context->ownsDisplay = context->display != nullptr;
+        }
+        if (!context->display) {
+            context->display = m_display;
+            m_parallelMonitors = false;
+        }
+        context->damageAvailable = InitializeDamage(*context);
+        context->renderAvailable = InitializeRender(*context);
+        m_monitorContexts.push_back(std::move(context));
+    }
+}
+
+bool LinuxScreenCapture::CaptureIncremental(CaptureContext& context, CaptureFrame& frame, bool& changed) {
+    if (!context.damageAvailable) {
+        changed = true;
+        return CaptureX11Region(context.display, context.x, context.y, context.width, context.height, frame);
+    }
+
+    std::vector<DirtyRect> rects;
+    CollectDamage(context, rects);
+
+    if (!IsDeliveredFrame(context, frame, 1)) {
+        // A frame we haven't filled before; everything counts as changed
+        rects.assign(1, DirtyRect{0, 0, context.width, context.height});
+    } else if (rects.empty()) {
+        return true;  // Nothing redrawn, nothing read
+    }
+
+    if (!RefreshFrame(context, frame, rects)) {
+        context.delivered = false;
+        return false;
+    }
+
+    frame.timestamp = std::chrono::system_clock::now();
+    frame.dirty_rects = std::move(rects);
+    context.deliveredAt = frame.timestamp;
+    context.deliveredScale = 1;
+    context.delivered = true;
+    changed = true;
+    return true;
+}
+
+bool LinuxScreenCapture::CaptureScaled(CaptureContext& context, int factor, CaptureFrame& frame, bool& changed) {
+    if (factor <= 1) {
+        return CaptureIncremental(context, frame, changed);
+    }
+
+    // Damage still decides whether anything needs reading. The reduced
+    // frame is always read whole; it is small.
+    std::vector<DirtyRect> rects;
+    if (context.damageAvailable) {
+        CollectDamage(context, rects);
+        if (rects.empty() && IsDeliveredFrame(context, frame, factor)) {
+            return true;
+        }
+    }
+    if (rects.empty()) {
+        rects.assign(1, DirtyRect{0, 0, context.width, context.height});
+    }
+
+    if (!ReadScaled(context, factor, frame)) {
+        context.delivered = false;
+        return false;
+    }
+
+    frame.scale_factor = factor;
+    frame.timestamp = std::chrono::system_clock::now();
+    capture_utils::ScaleDirtyRects(rects, factor, frame.width, frame.height, frame.dirty_rects);
+    context.deliveredAt = frame.timestamp;
+    context.deliveredScale = factor;
+    context.delivered = true;
+    changed = true;
+    return true;
+}
+
+bool LinuxScreenCapture::ReadScaled(CaptureContext& context, int factor, CaptureFrame& frame) {
+#ifdef HAVE_XRENDER
+    if (context.renderAvailable && PrepareRender(context, factor)) {
+        const int width = std::max(1, context.width / factor);
+        const int height = std::max(1, context.height / factor);
+
+        // Source coordinates go through the transform, so the area's
+        // origin is given in reduced units; the transform's translation
+        // carries the remainder when it is not a multiple of the factor
+        XRenderComposite(context.display, PictOpSrc, context.sourcePicture, None, context.scaledPicture,
+                         context.x / factor, context.y / factor, 0, 0, 0, 0, width, height);
+        XImage* image = XGetImage(context.display, context.scaledPixmap, 0, 0, width, height,
+                                  AllPlanes, ZPixmap);
+        if (image) {
+            bool success = ConvertXImageToFrame(image, frame);
+            XDestroyImage(image);
+            if (success) {
+                PerformanceMonitor::GetInstance().IncrementCounter("capture.server_scaled_reads");
+                return true;
+            }
+        }
+        std::cerr << "Failed to read server-scaled capture, falling back to full reads" << std::endl;
+        ReleaseRender(context);
+        context.renderAvailable = false;
+    }
+#endif
+
+    // Without XRender the reduction happens locally after a full read
+    CaptureFrame full;
+    if (!CaptureX11Region(context.display, context.x, context.y, context.width, context.height, full)) {
+        return false;
+    }
+    return capture_utils::DownscaleFrame(FrameView(full), frame, factor);
+}
+
+bool LinuxScreenCapture::InitializeRender(CaptureContext& context) {
+#ifdef HAVE_XRENDER
+    int eventBase = 0, errorBase = 0;
+    return context.display && XRenderQueryExtension(context.display, &eventBase, &errorBase);
+#else
+    (void)context;
+    return false;
+#endif
+}
+
+bool LinuxScreenCapture::PrepareRender(CaptureContext& context, int factor) {
+#ifdef HAVE_XRENDER
+    if (context.renderFactor == factor && context.sourcePicture) {
+        return true;
+    }
+    ReleaseRender(context);
+
+    Display* display = context.display;
+    int screen = DefaultScreen(display);
+    XRenderPictFormat* format = XRenderFindVisualFormat(display, DefaultVisual(display, screen));
+    if (!format) {
+        return false;
+    }
+
+    // Windows are sampled through the root, including their children
+    XRenderPictureAttributes attributes;
+    attributes.subwindow_mode = IncludeInferiors;
+    context.sourcePicture = XRenderCreatePicture(display, m_rootWindow, format, CPSubwindowMode, &attributes);
+
+    // Maps a reduced pixel u to factor * u + remainder, so that with the
+    // origin passed as context.x / factor it lands on context.x exactly
+    XTransform transform = {{
+        {XDoubleToFixed(factor), XDoubleToFixed(0), XDoubleToFixed(context.x % factor)},
+        {XDoubleToFixed(0), XDoubleToFixed(factor), XDoubleToFixed(context.y % factor)},
+        {XDoubleToFixed(0), XDoubleToFixed(0), XDoubleToFixed(1)}
+    }};
+    XRenderSetPictureTransform(display, context.sourcePicture, &transform);
+
+    // A factor x factor box kernel averages every source pixel, like a
+    // mipmap level, instead of point-sampling one in factor^2
+    std::vector<XFixed> kernel(2 + factor * factor, XDoubleToFixed(1.0 / (factor * factor)));
+    kernel[0] = XDoubleToFixed(factor);
+    kernel[1] = XDoubleToFixed(factor);
+    XRenderSetPictureFilter(display, context.sourcePicture, FilterConvolution,
+                            kernel.data(), static_cast<int>(kernel.size()));
+
+    const int width = std::max(1, context.width / factor);
+    const int height = std::max(1, context.height / factor);
+    context.scaledPixmap = XCreatePixmap(display, m_rootWindow, width, height, DefaultDepth(display, screen));
+    context.scaledPicture = XRenderCreatePicture(display, context.scaledPixmap, format, 0, nullptr);
+    context.renderFactor = factor;
+    return context.sourcePicture && context.scaledPixmap && context.scaledPicture;
+#else
+    (void)context;
+    (void)factor;
+    return false;
+#endif
+}
+
+void LinuxScreenCapture::ReleaseRender(CaptureContext& context) {
+#ifdef HAVE_XRENDER
+    if (context.display) {
+        if (context.scaledPicture) {
+            XRenderFreePicture(context.display, context.scaledPicture);
+        }
+        if (context.scaledPixmap) {
+            XFreePixmap(context.display, context.scaledPixmap);
+        }
+        if (context.sourcePicture) {
+            XRenderFreePicture(context.display, context.sourcePicture);
+        }
+    }
+    context.scaledPicture = 0;
+    context.scaledPixmap = 0;
+    context.sourcePicture = 0;
+    context.renderFactor = 0;
+#else
+    (void)context;
+#endif
+}
+
+bool LinuxScreenCapture::IsDeliveredFrame(const CaptureContext& context, const CaptureFrame& frame, int scale) const {
+    return context.delivered && context.deliveredScale == scale && frame.scale_factor == scale &&
+           frame.timestamp == context.deliveredAt &&
+           frame.width == std::max(1, context.width / scale) &&
+           frame.height == std::max(1, context.height / scale) &&
+           frame.format == ImageFormat::BGRX && frame.IsValid();
+}
+
+bool LinuxScreenCapture::InitializeDamage(CaptureContext& context) {
+#ifdef HAVE_XDAMAGE
+    // Extension setup is per connection
+    int damageEvent = 0, damageError = 0;
+    int fixesEvent = 0, fixesError = 0;
+    if (!XDamageQueryExtension(context.display, &damageEvent, &damageError) ||
+        !XFixesQueryExtension(context.display, &fixesEvent, &fixesError)) {
+        std::cout << "XDamage not available, capturing full frames" << std::endl;
+        return false;
+    }
+
+    // Both extensions require the version handshake before first use
+    int major = 0, minor = 0;
+    XDamageQueryVersion(context.display, &major, &minor);
+    XFixesQueryVersion(context.display, &major, &minor);
+
+    // NonEmpty sends one event until the damage is subtracted, so a busy
+    // screen doesn't flood the connection between ticks
+    context.damage = XDamageCreate(context.display, m_rootWindow, XDamageReportNonEmpty);
+    context.damageRegion = XFixesCreateRegion(context.display, nullptr, 0);
+    if (!context.damage || !context.damageRegion) {
+        ShutdownContext(context);
+        return false;
+    }
+    return true;
+#else
+    (void)context;
+    return false;
+#endif
+}
+
+void LinuxScreenCapture::ShutdownContext(CaptureContext& context) {
+#ifdef HAVE_XDAMAGE
+    if (context.display) {
+        if (context.damageRegion) {
+            XFixesDestroyRegion(context.display, context.damageRegion);
+        }
+        if (context.damage) {
+            XDamageDestroy(context.display, context.damage);
+        }
+    }
+    context.damageRegion = 0;
+    context.damage = 0;
+#endif
+    context.damageAvailable = false;
+    context.delivered = false;
+    ReleaseRender(context);
+    context.renderAvailable = false;
+
+    if (context.ownsDisplay && context.display) {
+        XCloseDisplay(context.display);
+    }
+    context.display = nullptr;
+    context.ownsDisplay = false;
+}
+
+void LinuxScreenCapture::CollectDamage(CaptureContext& context, std::vector<DirtyRect>& rects) {
+#ifdef HAVE_XDAMAGE
+    // Only damage notifies are selected on capture connections; the region
+    // accumulated by the server is what matters, not the events. The main
+    // connection is only ever read by the capture thread as well.
+    while (XPending(context.display) > 0) {
+        XEvent event;
+        XNextEvent(context.display, &event);
+    }
+
+    // Move the accumulated damage into our region and reset it
+    XDamageSubtract(context.display, context.damage, None, context.damageRegion);
+
+    int count = 0;
+    XRectangle* area = XFixesFetchRegion(context.display, context.damageRegion, &count);
+    if (!area) {
+        return;
+    }
+
+    // Clip to the context's area and make the rects relative to it, so
+    // damage on other monitors is dropped here
+    for (int i = 0; i < count; ++i) {
+        int x = std::max(context.x, static_cast<int>(area[i].x));
+        int y = std::max(context.y, static_cast<int>(area[i].y));
+        int right = std::min(context.x + context.width, area[i].x + static_cast<int>(area[i].width));
+        int bottom = std::min(context.y + context.height, area[i].y + static_cast<int>(area[i].height));
+        if (right > x && bottom > y) {
+            rects.push_back(DirtyRect{x - context.x, y - context.y, right - x, bottom - y});
         }
     }
+    XFree(area);
+#else
+    (void)context;
+    (void)rects;
+#endif
+}
+
+bool LinuxScreenCapture::RefreshFrame(CaptureContext& context, CaptureFrame& frame,
+                                      const std::vector<DirtyRect>& rects) {
+    size_t damagedPixels = 0;
+    for (const auto& rect : rects) {
+        damagedPixels += static_cast<size_t>(rect.width) * rect.height;
+    }
+    const size_t areaPixels = static_cast<size_t>(context.width) * context.height;
 
+    if (!IsDeliveredFrame(context, frame, 1) || rects.size() > MAX_DAMAGE_RECTS ||
+        damagedPixels > areaPixels * FULL_GRAB_DAMAGE_RATIO) {
+        return CaptureX11Region(context.display, context.x, context.y,
+                                context.width, context.height, frame);
+    }
+
+    // Partial reads touch only the damaged pixels, not a full-frame pass
+    frame.pixel_passes = 0;
+    for (const auto& rect : rects) {
+        XImage* image = XGetImage(context.display, m_rootWindow, context.x + rect.x, context.y + rect.y,
+                                  rect.width, rect.height, AllPlanes, ZPixmap);
+        if (!image) {
+            // Resolution change or similar; resync with a full grab next time
+            std::cerr << "Failed to read damaged screen region" << std::endl;
+            return false;
+        }
+        CopyXImageToFrame(image, frame, rect.x, rect.y);
+        XDestroyImage(image);
+    }
     return true;
 }
 
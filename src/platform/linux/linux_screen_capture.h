@@ -4,8 +4,16 @@
 #include "common_types.h"
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#ifdef HAVE_XDAMAGE
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
+#endif
+#ifdef HAVE_XRENDER
+#include <X11/extensions/Xrender.h>
+#endif
 #include <memory>
 #include <vector>
+#include <chrono>
 
 namespace work_assistant {
 
@@ -17,6 +25,7 @@ public:
     bool Initialize() override;
     void Shutdown() override;
 
+    // Monitors are the active XRandR CRTCs when XRandR is available
     std::vector<MonitorInfo> GetMonitors() const override;
     bool CaptureDesktop(CaptureFrame& frame) override;
     bool CaptureMonitor(int monitorId, CaptureFrame& frame) override;
@@ -26,10 +35,70 @@ public:
     bool SupportsHardwareAcceleration() const override;
     void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) override;
 
+    // Reads back only what XDamage reported, straight into the frame this
+    // backend returned on the previous call (any other frame gets a full
+    // grab). Frames are delivered in the server's native BGRX layout.
+    bool CaptureDesktopIncremental(CaptureFrame& frame, bool& changed) override;
+    bool CaptureMonitorIncremental(int monitorId, CaptureFrame& frame, bool& changed) override;
+    bool SupportsDamageTracking() const override;
+
+    // Detection frames are reduced by an XRender transform on the server,
+    // so only 1/factor^2 of the pixels cross the connection
+    bool CaptureDesktopScaled(int factor, CaptureFrame& frame, bool& changed) override;
+    bool CaptureMonitorScaled(int monitorId, int factor, CaptureFrame& frame, bool& changed) override;
+    bool SupportsServerSideScaling() const override;
+
+    // Each monitor has its own X connection, so different monitors can be
+    // captured from different threads
+    bool SupportsParallelMonitorCapture() const override;
+
 private:
-    bool CaptureX11Region(int x, int y, int width, int height, CaptureFrame& frame);
+    // Everything needed to capture one area of the root window. The desktop
+    // context uses m_display; monitor contexts get their own connection
+    // when there is more than one monitor.
+    struct CaptureContext {
+        Display* display = nullptr;
+        bool ownsDisplay = false;
+        int x = 0, y = 0;
+        int width = 0, height = 0;
+        bool damageAvailable = false;
+#ifdef HAVE_XDAMAGE
+        Damage damage = 0;
+        XserverRegion damageRegion = 0;
+#endif
+        bool renderAvailable = false;
+#ifdef HAVE_XRENDER
+        int renderFactor = 0;           // Factor the pictures below were built for
+        Picture sourcePicture = 0;      // Root window, sampled through the scale transform
+        Pixmap scaledPixmap = 0;
+        Picture scaledPicture = 0;
+#endif
+        // Identifies the frame last filled from this context (at
+        // deliveredScale), whose pixels are then known to be current
+        // apart from new damage
+        std::chrono::system_clock::time_point deliveredAt;
+        int deliveredScale = 1;
+        bool delivered = false;
+    };
+
+    bool CaptureX11Region(Display* display, int x, int y, int width, int height, CaptureFrame& frame);
     bool ConvertXImageToFrame(XImage* image, CaptureFrame& frame);
-    
+    void CopyXImageToFrame(XImage* image, CaptureFrame& frame, int dstX, int dstY);
+
+    void DetectMonitors();
+    void CreateMonitorContexts();
+    bool CaptureIncremental(CaptureContext& context, CaptureFrame& frame, bool& changed);
+    bool CaptureScaled(CaptureContext& context, int factor, CaptureFrame& frame, bool& changed);
+    bool ReadScaled(CaptureContext& context, int factor, CaptureFrame& frame);
+    bool InitializeRender(CaptureContext& context);
+    bool PrepareRender(CaptureContext& context, int factor);
+    void ReleaseRender(CaptureContext& context);
+    bool InitializeDamage(CaptureContext& context);
+    void ShutdownContext(CaptureContext& context);
+    void CollectDamage(CaptureContext& context, std::vector<DirtyRect>& rects);
+    bool IsDeliveredFrame(const CaptureContext& context, const CaptureFrame& frame, int scale) const;
+    bool RefreshFrame(CaptureContext& context, CaptureFrame& frame, const std::vector<DirtyRect>& rects);
+
 private:
     bool m_initialized;
     Display* m_display;
@@ -38,6 +107,15 @@ private:
     int m_screenHeight;
     bool m_useHardwareAcceleration;
     int m_maxFPS;
+
+    std::vector<MonitorInfo> m_monitors;
+    CaptureContext m_desktop;
+    std::vector<std::unique_ptr<CaptureContext>> m_monitorContexts;  // Indexed by monitor id
+    bool m_parallelMonitors;
+
+    // Past these limits one full grab is cheaper than many small ones
+    static constexpr size_t MAX_DAMAGE_RECTS = 32;
+    static constexpr double FULL_GRAB_DAMAGE_RATIO = 0.5;
 };
 
-} // namespace work_assistant
\ No newline at end of file
+} // namespace work_assistant
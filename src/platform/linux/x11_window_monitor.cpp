@@ -2,14 +2,27 @@
 #include "event_manager.h"
 #include <X11/Xatom.h>
 #include <X11/Xutil.h>
+#ifdef HAVE_XSS
+#include <X11/extensions/scrnsaver.h>
+#endif
 #include <iostream>
 #include <cstring>
 #include <unistd.h>
 
 namespace work_assistant {
 
+namespace {
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 X11WindowMonitor::X11WindowMonitor()
-    : m_display(nullptr), m_root(0), m_monitoring(false), m_initialized(false) {
+    : m_display(nullptr), m_root(0), m_monitoring(false), m_initialized(false)
+    , m_lastActivityMs(SteadyNowMs()) {
 }
 
 X11WindowMonitor::~X11WindowMonitor() {
@@ -139,10 +152,12 @@ void X11WindowMonitor::MonitorLoop() {
         int revert_to;
         XGetInputFocus(m_display, &current_focused, &revert_to);
 
-        if (current_focused != last_focused) {
+        bool focus_changed = current_focused != last_focused;
+        if (focus_changed) {
             // Focus changed - could emit event here if needed
             last_focused = current_focused;
         }
+        UpdateIdleTime(focus_changed);
 
         // Process X11 events
         while (XPending(m_display) > 0) {
@@ -163,6 +178,44 @@ void X11WindowMonitor::MonitorLoop() {
     }
 }
 
+// Xlib is only touched from the monitor thread; other threads read the
+// cached timestamp through GetIdleTime()
+void X11WindowMonitor::UpdateIdleTime(bool focus_changed) {
+    int64_t now = SteadyNowMs();
+    if (focus_changed) {
+        m_lastActivityMs = now;
+    }
+
+#ifdef HAVE_XSS
+    static thread_local int64_t last_query = 0;
+    if (now - last_query < 1000) {
+        return;
+    }
+    last_query = now;
+
+    int event_base = 0, error_base = 0;
+    if (XScreenSaverQueryExtension(m_display, &event_base, &error_base)) {
+        XScreenSaverInfo* info = XScreenSaverAllocInfo();
+        if (info && XScreenSaverQueryInfo(m_display, m_root, info)) {
+            int64_t last_input = now - static_cast<int64_t>(info->idle);
+            if (last_input > m_lastActivityMs) {
+                m_lastActivityMs = last_input;
+            }
+        }
+        if (info) {
+            XFree(info);
+        }
+    }
+#endif
+}
+
+std::chrono::milliseconds X11WindowMonitor::GetIdleTime() const {
+    if (!m_monitoring) {
+        return std::chrono::milliseconds(-1);
+    }
+    return std::chrono::milliseconds(SteadyNowMs() - m_lastActivityMs);
+}
+
 WindowInfo X11WindowMonitor::GetWindowInfo(Window window) const {
     WindowInfo info = {};
     info.window_handle = reinterpret_cast<WindowHandle>(window);
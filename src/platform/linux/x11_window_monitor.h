@@ -20,6 +20,7 @@ public:
     bool IsMonitoring() const override;
     WindowInfo GetActiveWindow() const override;
     std::vector<WindowInfo> GetAllWindows() const override;
+    std::chrono::milliseconds GetIdleTime() const override;
 
 private:
     Display* m_display;
@@ -27,8 +28,10 @@ private:
     std::unique_ptr<std::thread> m_monitorThread;
     std::atomic<bool> m_monitoring;
     std::atomic<bool> m_initialized;
+    std::atomic<int64_t> m_lastActivityMs;   // Steady clock; updated by MonitorLoop
     
     void MonitorLoop();
+    void UpdateIdleTime(bool focus_changed);
     WindowInfo GetWindowInfo(Window window) const;
     std::string GetWindowTitle(Window window) const;
     std::string GetWindowClassName(Window window) const;
@@ -1,44 +1,130 @@
-#include "screen_capture.h"
+#include "screen_capture_lite_impl.h"
+#include "triple_buffer.h"
 #include <ScreenCapture.h>
 #include <iostream>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <map>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 
 namespace work_assistant {
 
-// Implementation using screen_capture_lite library
-class ScreenCaptureLiteImpl : public IScreenCapture {
+namespace {
+
+// Wait for the first frame of a freshly started session; afterwards reads
+// never wait
+constexpr auto FIRST_FRAME_TIMEOUT = std::chrono::milliseconds(100);
+
+// Focus changes capture the newly focused window; keep a few of those
+// sessions warm and drop the least recently used beyond that
+constexpr size_t MAX_WINDOW_SESSIONS = 4;
+
+void CopyImageToFrame(const SL::Screen_Capture::Image& img, CaptureFrame& frame) {
+    frame.width = img.Width;
+    frame.height = img.Height;
+    frame.stride = img.Stride;
+    frame.bytes_per_pixel = img.BytesToNextRow / img.Width;
+    // The library hands out its native BGRA; consumers read it as-is
+    frame.format = (frame.bytes_per_pixel == 4) ? ImageFormat::BGRA : ImageFormat::BGR;
+
+    // Buffers are recycled by the triple buffer, so this only allocates
+    // until the first frame of each size
+    size_t dataSize = img.Height * img.Stride;
+    frame.data.resize(dataSize);
+    std::memcpy(frame.data.data(), img.Data, dataSize);
+
+    frame.timestamp = std::chrono::system_clock::now();
+    frame.dirty_rects.clear();
+    frame.pixel_passes = 1;
+    frame.scale_factor = 1;
+}
+
+} // namespace
+
+// Latest frames of one capture target. The library's capture thread is the
+// only writer; readers serialize on readMutex.
+struct FrameStream {
+    TripleBuffer<CaptureFrame> buffer;
+    std::mutex readMutex;
+    std::mutex firstFrameMutex;
+    std::condition_variable firstFrame;
+
+    void Write(const SL::Screen_Capture::Image& img) {
+        CopyImageToFrame(img, buffer.WriteBuffer());
+    }
+
+    void Publish() {
+        bool first = !buffer.HasData();
+        buffer.Publish();
+        if (first) {
+            std::lock_guard<std::mutex> lock(firstFrameMutex);
+            firstFrame.notify_all();
+        }
+    }
+
+    bool WaitForFirstFrame() {
+        if (buffer.HasData()) {
+            return true;
+        }
+        std::unique_lock<std::mutex> lock(firstFrameMutex);
+        return firstFrame.wait_for(lock, FIRST_FRAME_TIMEOUT, [this]() { return buffer.HasData(); });
+    }
+
+    // Copies out the newest frame; never waits for the writer
+    bool ReadLatest(CaptureFrame& frame) {
+        if (!WaitForFirstFrame()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(readMutex);
+        buffer.Update();
+        frame = buffer.ReadBuffer();
+        frame.pixel_passes++;
+        return frame.IsValid();
+    }
+};
+
+struct WindowSession {
+    FrameStream stream;
+    std::shared_ptr<SL::Screen_Capture::IScreenCaptureManager> session;
+    std::chrono::steady_clock::time_point lastUsed;
+};
+
+class ScreenCaptureLiteImpl::Impl {
 public:
-    ScreenCaptureLiteImpl() 
+    Impl()
         : m_initialized(false)
         , m_useHardwareAcceleration(true)
         , m_maxFPS(30)
+        , m_streaming(false)
+        , m_paused(false)
     {}
 
-    ~ScreenCaptureLiteImpl() override {
+    ~Impl() {
         Shutdown();
     }
 
-    bool Initialize() override {
+    bool Initialize() {
         if (m_initialized) {
             return true;
         }
 
         try {
             // Get all monitors
-            auto monitors = SL::Screen_Capture::GetMonitors();
-            if (monitors.empty()) {
+            m_slMonitors = SL::Screen_Capture::GetMonitors();
+            if (m_slMonitors.empty()) {
                 std::cerr << "No monitors found" << std::endl;
                 return false;
             }
 
             // Store monitor information
             m_monitors.clear();
+            m_monitorStreams.clear();
             int id = 0;
-            for (const auto& mon : monitors) {
+            for (const auto& mon : m_slMonitors) {
                 MonitorInfo info;
                 info.id = id++;
                 info.name = mon.Name;
@@ -48,6 +134,14 @@ public:
                 info.height = mon.Height;
                 info.is_primary = (id == 1); // First monitor is primary
                 m_monitors.push_back(info);
+                m_monitorStreams.push_back(std::make_unique<FrameStream>());
+            }
+            m_frameSetSeen.assign(m_monitorStreams.size(), false);
+
+            if (!StartDesktopSession()) {
+                m_monitors.clear();
+                m_monitorStreams.clear();
+                return false;
             }
 
             m_initialized = true;
@@ -60,234 +154,414 @@ public:
         }
     }
 
-    void Shutdown() override {
+    void Shutdown() {
         if (!m_initialized) {
             return;
         }
 
+        StopStreaming();
+
+        // Sessions go first: their capture threads write into the streams
+        {
+            std::lock_guard<std::mutex> lock(m_windowsMutex);
+            for (auto& entry : m_windowSessions) {
+                entry.second->session.reset();
+            }
+            m_windowSessions.clear();
+        }
+        m_desktopSession.reset();
+        m_monitorStreams.clear();
+
         m_monitors.clear();
+        m_slMonitors.clear();
         m_initialized = false;
         std::cout << "Screen capture shut down" << std::endl;
     }
 
-    std::vector<MonitorInfo> GetMonitors() const override {
+    std::vector<MonitorInfo> GetMonitors() const {
         return m_monitors;
     }
 
-    bool CaptureDesktop(CaptureFrame& frame) override {
+    bool CaptureDesktop(CaptureFrame& frame) {
         if (!m_initialized) {
             return false;
         }
+        if (m_monitorStreams.size() == 1) {
+            return m_monitorStreams[0]->ReadLatest(frame);
+        }
+        return ComposeDesktop(frame);
+    }
 
-        try {
-            std::mutex captureMutex;
-            std::condition_variable captureCV;
-            bool captureComplete = false;
-            bool captureSuccess = false;
+    bool CaptureMonitor(int monitorId, CaptureFrame& frame) {
+        if (!m_initialized || monitorId < 0 || monitorId >= static_cast<int>(m_monitorStreams.size())) {
+            return false;
+        }
+        return m_monitorStreams[monitorId]->ReadLatest(frame);
+    }
 
-            auto monitors = SL::Screen_Capture::GetMonitors();
-            if (monitors.empty()) {
-                return false;
-            }
+    bool CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) {
+        if (!m_initialized) {
+            return false;
+        }
 
-            // Create capture configuration for all monitors
-            auto captureConfig = SL::Screen_Capture::CreateCaptureConfiguration([&]() {
-                return monitors;
-            });
+        std::shared_ptr<WindowSession> window = GetWindowSession(windowHandle);
+        if (!window) {
+            return false;
+        }
+        return window->stream.ReadLatest(frame);
+    }
 
-            captureConfig->onNewFrame([&](const SL::Screen_Capture::Image& img, const SL::Screen_Capture::Monitor& monitor) {
-                std::lock_guard<std::mutex> lock(captureMutex);
-                
-                // Copy image data to frame
-                frame.width = img.Width;
-                frame.height = img.Height;
-                frame.stride = img.Stride;
-                frame.bytes_per_pixel = img.BytesToNextRow / img.Width;
-                frame.format = (frame.bytes_per_pixel == 4) ? ImageFormat::RGBA : ImageFormat::RGB;
-                
-                size_t dataSize = img.Height * img.Stride;
-                frame.data.resize(dataSize);
-                std::memcpy(frame.data.data(), img.Data, dataSize);
-                
-                frame.timestamp = std::chrono::system_clock::now();
-                captureSuccess = true;
-                captureComplete = true;
-                captureCV.notify_one();
-            });
+    bool CaptureRegion(int x, int y, int width, int height, CaptureFrame& frame) {
+        if (!m_initialized) {
+            return false;
+        }
 
-            // Start capture
-            auto captureManager = captureConfig->start_capturing();
+        // Capture desktop first
+        CaptureFrame desktopFrame;
+        if (!CaptureDesktop(desktopFrame)) {
+            return false;
+        }
 
-            // Wait for capture to complete
-            std::unique_lock<std::mutex> lock(captureMutex);
-            captureCV.wait_for(lock, std::chrono::milliseconds(100), [&] { return captureComplete; });
+        // Crop to region
+        return capture_utils::CropFrame(desktopFrame, frame, x, y, width, height);
+    }
+
+    bool SupportsHardwareAcceleration() const {
+        // screen_capture_lite uses hardware acceleration when available
+        return true;
+    }
 
-            return captureSuccess;
+    void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) {
+        m_useHardwareAcceleration = useHardwareAcceleration;
+        m_maxFPS = std::max(1, maxFPS);
+
+        // Retune running sessions in place rather than restarting them
+        auto interval = FrameInterval();
+        if (m_desktopSession) {
+            m_desktopSession->setFrameChangeInterval(interval);
         }
-        catch (const std::exception& e) {
-            std::cerr << "Desktop capture failed: " << e.what() << std::endl;
-            return false;
+        std::lock_guard<std::mutex> lock(m_windowsMutex);
+        for (auto& entry : m_windowSessions) {
+            if (entry.second->session) {
+                entry.second->session->setFrameChangeInterval(interval);
+            }
         }
     }
 
-    bool CaptureMonitor(int monitorId, CaptureFrame& frame) override {
-        if (!m_initialized || monitorId < 0 || monitorId >= static_cast<int>(m_monitors.size())) {
+    bool StartStreaming(std::function<void(const CaptureFrame&)> onFrame) {
+        if (!m_initialized || !onFrame) {
             return false;
         }
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_streamCallback = std::move(onFrame);
+        m_streaming = true;
+        return true;
+    }
 
-        try {
-            std::mutex captureMutex;
-            std::condition_variable captureCV;
-            bool captureComplete = false;
-            bool captureSuccess = false;
+    void StopStreaming() {
+        // Taking the lock waits out a callback already in progress
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_streaming = false;
+        m_streamCallback = nullptr;
+    }
 
-            auto monitors = SL::Screen_Capture::GetMonitors();
-            if (monitorId >= static_cast<int>(monitors.size())) {
-                return false;
+    // Pausing the sessions stops the library's capture threads, not just
+    // the delivery of their frames
+    void SetPaused(bool paused) {
+        if (m_paused.exchange(paused) == paused) {
+            return;
+        }
+        if (m_desktopSession) {
+            SetSessionPaused(*m_desktopSession, paused);
+        }
+        std::lock_guard<std::mutex> lock(m_windowsMutex);
+        for (auto& entry : m_windowSessions) {
+            if (entry.second->session) {
+                SetSessionPaused(*entry.second->session, paused);
             }
+        }
+    }
 
-            // Create vector with single monitor
-            std::vector<SL::Screen_Capture::Monitor> targetMonitor = { monitors[monitorId] };
+private:
+    static void SetSessionPaused(SL::Screen_Capture::IScreenCaptureManager& session, bool paused) {
+        if (paused) {
+            session.pause();
+        } else {
+            session.resume();
+        }
+    }
 
-            auto captureConfig = SL::Screen_Capture::CreateCaptureConfiguration([&]() {
-                return targetMonitor;
-            });
+    std::chrono::milliseconds FrameInterval() const {
+        return std::chrono::milliseconds(1000 / m_maxFPS);
+    }
 
-            captureConfig->onNewFrame([&](const SL::Screen_Capture::Image& img, const SL::Screen_Capture::Monitor& monitor) {
-                std::lock_guard<std::mutex> lock(captureMutex);
-                
-                // Copy image data to frame
-                frame.width = img.Width;
-                frame.height = img.Height;
-                frame.stride = img.Stride;
-                frame.bytes_per_pixel = img.BytesToNextRow / img.Width;
-                frame.format = (frame.bytes_per_pixel == 4) ? ImageFormat::RGBA : ImageFormat::RGB;
-                
-                size_t dataSize = img.Height * img.Stride;
-                frame.data.resize(dataSize);
-                std::memcpy(frame.data.data(), img.Data, dataSize);
-                
-                frame.timestamp = std::chrono::system_clock::now();
-                captureSuccess = true;
-                captureComplete = true;
-                captureCV.notify_one();
-            });
+    bool StartDesktopSession() {
+        auto monitors = m_slMonitors;
+        auto captureConfig = SL::Screen_Capture::CreateCaptureConfiguration([monitors]() {
+            return monitors;
+        });
+
+        captureConfig->onNewFrame([this](const SL::Screen_Capture::Image& img, const SL::Screen_Capture::Monitor& monitor) {
+            OnMonitorFrame(img, monitor);
+        });
+
+        m_desktopSession = captureConfig->start_capturing();
+        if (!m_desktopSession) {
+            std::cerr << "Failed to start desktop capture session" << std::endl;
+            return false;
+        }
+        m_desktopSession->setFrameChangeInterval(FrameInterval());
+        return true;
+    }
 
-            // Start capture
-            auto captureManager = captureConfig->start_capturing();
+    // Runs on the library's capture thread
+    void OnMonitorFrame(const SL::Screen_Capture::Image& img, const SL::Screen_Capture::Monitor& monitor) {
+        int index = monitor.Index;
+        if (index < 0 || index >= static_cast<int>(m_monitorStreams.size())) {
+            return;
+        }
 
-            // Wait for capture to complete
-            std::unique_lock<std::mutex> lock(captureMutex);
-            captureCV.wait_for(lock, std::chrono::milliseconds(100), [&] { return captureComplete; });
+        FrameStream& stream = *m_monitorStreams[index];
+        stream.Write(img);
+
+        if (m_streaming) {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            if (m_streamCallback) {
+                if (m_monitorStreams.size() == 1) {
+                    // Hand out the write buffer itself; it's ours until Publish()
+                    m_streamCallback(stream.buffer.WriteBuffer());
+                    stream.Publish();
+                    return;
+                }
+                stream.Publish();
+                CaptureFrame desktop;
+                if (CloseFrameSet(index) && ComposeDesktop(desktop)) {
+                    m_streamCallback(desktop);
+                }
+                return;
+            }
+        }
 
-            return captureSuccess;
+        stream.Publish();
+    }
+
+    // Called with m_streamMutex held. The library delivers each monitor's
+    // frame separately; the desktop is composed once every monitor has
+    // delivered, or early when one repeats so a stalled display can't hold
+    // the others back.
+    bool CloseFrameSet(int index) {
+        if (m_frameSetSeen[index]) {
+            std::fill(m_frameSetSeen.begin(), m_frameSetSeen.end(), false);
+            m_frameSetSeen[index] = true;
+            return true;
         }
-        catch (const std::exception& e) {
-            std::cerr << "Monitor capture failed: " << e.what() << std::endl;
+        m_frameSetSeen[index] = true;
+        if (std::find(m_frameSetSeen.begin(), m_frameSetSeen.end(), false) != m_frameSetSeen.end()) {
             return false;
         }
+        std::fill(m_frameSetSeen.begin(), m_frameSetSeen.end(), false);
+        return true;
     }
 
-    bool CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) override {
-        if (!m_initialized) {
-            return false;
+    // Stitches the latest frame of every monitor into one desktop image.
+    // Right after startup nothing may have arrived yet; wait for the first
+    // frame once and give up if there is still nothing to show.
+    bool ComposeDesktop(CaptureFrame& frame) {
+        if (ComposeLatest(frame)) {
+            return true;
         }
+        return !m_monitorStreams.empty() && m_monitorStreams[0]->WaitForFirstFrame() &&
+               ComposeLatest(frame);
+    }
 
-        try {
-            std::mutex captureMutex;
-            std::condition_variable captureCV;
-            bool captureComplete = false;
-            bool captureSuccess = false;
+    bool ComposeLatest(CaptureFrame& frame) {
+        int minX = 0, minY = 0, maxX = 0, maxY = 0;
+        for (size_t i = 0; i < m_monitors.size(); ++i) {
+            const auto& mon = m_monitors[i];
+            if (i == 0) {
+                minX = mon.x; minY = mon.y;
+                maxX = mon.x + mon.width; maxY = mon.y + mon.height;
+            } else {
+                minX = std::min(minX, mon.x); minY = std::min(minY, mon.y);
+                maxX = std::max(maxX, mon.x + mon.width); maxY = std::max(maxY, mon.y + mon.height);
+            }
+        }
 
-            // Get window list
-            auto windows = SL::Screen_Capture::GetWindows();
-            
+        frame.width = maxX - minX;
+        frame.height = maxY - minY;
+        frame.bytes_per_pixel = 4;
+        frame.stride = frame.width * frame.bytes_per_pixel;
+        frame.format = ImageFormat::BGRA;
+        frame.timestamp = std::chrono::system_clock::now();
+        frame.dirty_rects.clear();
+        frame.pixel_passes = 2;  // The library's copy plus composition
+        frame.scale_factor = 1;
+        frame.data.assign(frame.GetDataSize(), 0);
+
+        bool any = false;
+        for (size_t i = 0; i < m_monitorStreams.size(); ++i) {
+            FrameStream& stream = *m_monitorStreams[i];
+            if (!stream.buffer.HasData()) {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(stream.readMutex);
+            stream.buffer.Update();
+            const CaptureFrame& mon = stream.buffer.ReadBuffer();
+            if (mon.bytes_per_pixel != frame.bytes_per_pixel) {
+                continue;
+            }
+
+            int offsetX = m_monitors[i].x - minX;
+            int offsetY = m_monitors[i].y - minY;
+            int srcStride = (mon.stride > 0) ? mon.stride : mon.width * mon.bytes_per_pixel;
+            int rows = std::min(mon.height, frame.height - offsetY);
+            int rowBytes = std::min(mon.width, frame.width - offsetX) * frame.bytes_per_pixel;
+            for (int row = 0; row < rows; ++row) {
+                std::memcpy(&frame.data[(offsetY + row) * frame.stride + offsetX * frame.bytes_per_pixel],
+                            &mon.data[row * srcStride], rowBytes);
+            }
+            any = true;
+        }
+        return any;
+    }
+
+    // Shared so a reader keeps its session alive across an eviction by a
+    // concurrent focus change
+    std::shared_ptr<WindowSession> GetWindowSession(WindowHandle windowHandle) {
+        std::lock_guard<std::mutex> lock(m_windowsMutex);
+
+        auto it = m_windowSessions.find(windowHandle);
+        if (it != m_windowSessions.end()) {
+            it->second->lastUsed = std::chrono::steady_clock::now();
+            return it->second;
+        }
+
+        try {
             // Find window by handle
-            auto it = std::find_if(windows.begin(), windows.end(), 
+            auto windows = SL::Screen_Capture::GetWindows();
+            auto found = std::find_if(windows.begin(), windows.end(),
                 [windowHandle](const SL::Screen_Capture::Window& w) {
                     return reinterpret_cast<WindowHandle>(w.Handle) == windowHandle;
                 });
-
-            if (it == windows.end()) {
-                return false;
+            if (found == windows.end()) {
+                return nullptr;
             }
 
-            std::vector<SL::Screen_Capture::Window> targetWindow = { *it };
+            EvictWindowSessions();
+
+            auto window = std::make_shared<WindowSession>();
+            WindowSession* raw = window.get();
+            std::vector<SL::Screen_Capture::Window> targetWindow = { *found };
 
-            auto captureConfig = SL::Screen_Capture::CreateCaptureConfiguration([&]() {
+            auto captureConfig = SL::Screen_Capture::CreateCaptureConfiguration([targetWindow]() {
                 return targetWindow;
             });
-
-            captureConfig->onNewFrame([&](const SL::Screen_Capture::Image& img, const SL::Screen_Capture::Window& window) {
-                std::lock_guard<std::mutex> lock(captureMutex);
-                
-                // Copy image data to frame
-                frame.width = img.Width;
-                frame.height = img.Height;
-                frame.stride = img.Stride;
-                frame.bytes_per_pixel = img.BytesToNextRow / img.Width;
-                frame.format = (frame.bytes_per_pixel == 4) ? ImageFormat::RGBA : ImageFormat::RGB;
-                
-                size_t dataSize = img.Height * img.Stride;
-                frame.data.resize(dataSize);
-                std::memcpy(frame.data.data(), img.Data, dataSize);
-                
-                frame.timestamp = std::chrono::system_clock::now();
-                captureSuccess = true;
-                captureComplete = true;
-                captureCV.notify_one();
+            captureConfig->onNewFrame([raw](const SL::Screen_Capture::Image& img, const SL::Screen_Capture::Window&) {
+                raw->stream.Write(img);
+                raw->stream.Publish();
             });
 
-            // Start capture
-            auto captureManager = captureConfig->start_capturing();
-
-            // Wait for capture to complete
-            std::unique_lock<std::mutex> lock(captureMutex);
-            captureCV.wait_for(lock, std::chrono::milliseconds(100), [&] { return captureComplete; });
+            window->session = captureConfig->start_capturing();
+            if (!window->session) {
+                return nullptr;
+            }
+            window->session->setFrameChangeInterval(FrameInterval());
+            if (m_paused) {
+                window->session->pause();
+            }
+            window->lastUsed = std::chrono::steady_clock::now();
 
-            return captureSuccess;
+            m_windowSessions[windowHandle] = window;
+            return window;
         }
         catch (const std::exception& e) {
             std::cerr << "Window capture failed: " << e.what() << std::endl;
-            return false;
+            return nullptr;
         }
     }
 
-    bool CaptureRegion(int x, int y, int width, int height, CaptureFrame& frame) override {
-        if (!m_initialized) {
-            return false;
-        }
-
-        // Capture desktop first
-        CaptureFrame desktopFrame;
-        if (!CaptureDesktop(desktopFrame)) {
-            return false;
+    // Called with m_windowsMutex held
+    void EvictWindowSessions() {
+        while (m_windowSessions.size() >= MAX_WINDOW_SESSIONS) {
+            auto oldest = std::min_element(m_windowSessions.begin(), m_windowSessions.end(),
+                [](const auto& a, const auto& b) { return a.second->lastUsed < b.second->lastUsed; });
+            oldest->second->session.reset();
+            m_windowSessions.erase(oldest);
         }
-
-        // Crop to region
-        return capture_utils::CropFrame(desktopFrame, frame, x, y, width, height);
     }
 
-    bool SupportsHardwareAcceleration() const override {
-        // screen_capture_lite uses hardware acceleration when available
-        return true;
-    }
-
-    void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) override {
-        m_useHardwareAcceleration = useHardwareAcceleration;
-        m_maxFPS = maxFPS;
-    }
-
-private:
     bool m_initialized;
     std::vector<MonitorInfo> m_monitors;
+    std::vector<SL::Screen_Capture::Monitor> m_slMonitors;
     bool m_useHardwareAcceleration;
-    int m_maxFPS;
+    std::atomic<int> m_maxFPS;
+
+    // One session covers all monitors, with a stream per monitor (indexed
+    // like m_monitors)
+    std::shared_ptr<SL::Screen_Capture::IScreenCaptureManager> m_desktopSession;
+    std::vector<std::unique_ptr<FrameStream>> m_monitorStreams;
+
+    std::map<WindowHandle, std::shared_ptr<WindowSession>> m_windowSessions;
+    std::mutex m_windowsMutex;
+
+    std::atomic<bool> m_streaming;
+    std::atomic<bool> m_paused;
+    std::function<void(const CaptureFrame&)> m_streamCallback;
+    std::mutex m_streamMutex;
+    std::vector<bool> m_frameSetSeen;  // Monitors delivered since the last composition
 };
 
-// Update factory to use screen_capture_lite implementation
-std::unique_ptr<IScreenCapture> ScreenCaptureFactory::Create() {
-    return std::make_unique<ScreenCaptureLiteImpl>();
+// ScreenCaptureLiteImpl public interface
+ScreenCaptureLiteImpl::ScreenCaptureLiteImpl() : m_impl(std::make_unique<Impl>()) {}
+ScreenCaptureLiteImpl::~ScreenCaptureLiteImpl() = default;
+
+bool ScreenCaptureLiteImpl::Initialize() {
+    return m_impl->Initialize();
+}
+
+void ScreenCaptureLiteImpl::Shutdown() {
+    m_impl->Shutdown();
+}
+
+std::vector<MonitorInfo> ScreenCaptureLiteImpl::GetMonitors() const {
+    return m_impl->GetMonitors();
+}
+
+bool ScreenCaptureLiteImpl::CaptureDesktop(CaptureFrame& frame) {
+    return m_impl->CaptureDesktop(frame);
+}
+
+bool ScreenCaptureLiteImpl::CaptureMonitor(int monitorId, CaptureFrame& frame) {
+    return m_impl->CaptureMonitor(monitorId, frame);
+}
+
+bool ScreenCaptureLiteImpl::CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) {
+    return m_impl->CaptureWindow(windowHandle, frame);
+}
+
+bool ScreenCaptureLiteImpl::CaptureRegion(int x, int y, int width, int height, CaptureFrame& frame) {
+    return m_impl->CaptureRegion(x, y, width, height, frame);
+}
+
+bool ScreenCaptureLiteImpl::SupportsHardwareAcceleration() const {
+    return m_impl->SupportsHardwareAcceleration();
+}
+
+void ScreenCaptureLiteImpl::SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) {
+    m_impl->SetCaptureSettings(useHardwareAcceleration, maxFPS);
+}
+
+bool ScreenCaptureLiteImpl::StartStreaming(std::function<void(const CaptureFrame&)> onFrame) {
+    return m_impl->StartStreaming(std::move(onFrame));
+}
+
+void ScreenCaptureLiteImpl::StopStreaming() {
+    m_impl->StopStreaming();
+}
+
+void ScreenCaptureLiteImpl::SetPaused(bool paused) {
+    m_impl->SetPaused(paused);
 }
 
-} // namespace work_assistant
\ No newline at end of file
+} // namespace work_assistant
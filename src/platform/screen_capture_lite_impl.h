@@ -0,0 +1,38 @@
+#pragma once
+
+#include "screen_capture.h"
+#include <memory>
+
+namespace work_assistant {
+
+// Backend built on screen_capture_lite. One long-lived capture session per
+// target (all monitors, or a window) writes frames into triple buffers, so
+// capture calls read the latest frame instead of setting up a session each
+// time, and monitoring runs off the library's own frame callbacks.
+class ScreenCaptureLiteImpl : public IScreenCapture {
+public:
+    ScreenCaptureLiteImpl();
+    ~ScreenCaptureLiteImpl() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+
+    std::vector<MonitorInfo> GetMonitors() const override;
+    bool CaptureDesktop(CaptureFrame& frame) override;
+    bool CaptureMonitor(int monitorId, CaptureFrame& frame) override;
+    bool CaptureWindow(WindowHandle windowHandle, CaptureFrame& frame) override;
+    bool CaptureRegion(int x, int y, int width, int height, CaptureFrame& frame) override;
+
+    bool SupportsHardwareAcceleration() const override;
+    void SetCaptureSettings(bool useHardwareAcceleration, int maxFPS) override;
+
+    bool StartStreaming(std::function<void(const CaptureFrame&)> onFrame) override;
+    void StopStreaming() override;
+    void SetPaused(bool paused) override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace work_assistant
@@ -0,0 +1,17 @@
+#include "ocr_engine.h"
+
+#if defined(__linux__)
+#include "linux/atspi_client.h"
+#endif
+
+namespace work_assistant {
+
+std::shared_ptr<ITextSource> TextSourceFactory::Create() {
+#if defined(__linux__)
+    return std::make_shared<AtspiClient>();
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace work_assistant
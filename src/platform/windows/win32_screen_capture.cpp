@@ -148,7 +148,11 @@ bool Win32ScreenCapture::CaptureRegion(int x, int y, int width, int height, Capt
         frame.width = width;
         frame.height = height;
         frame.bytes_per_pixel = 4;
+        frame.stride = 0;
+        frame.format = fullFrame.format;
         frame.timestamp = fullFrame.timestamp;
+        frame.pixel_passes = fullFrame.pixel_passes + 1;
+        frame.scale_factor = 1;
         frame.data.resize(width * height * 4);
 
         for (int row = 0; row < height; ++row) {
@@ -303,7 +307,11 @@ bool Win32ScreenCapture::CaptureDXGI(CaptureFrame& frame) {
     frame.width = m_screenWidth;
     frame.height = m_screenHeight;
     frame.bytes_per_pixel = 4;
+    frame.stride = 0;
+    frame.format = ImageFormat::BGRA;  // Desktop duplication's native layout
     frame.timestamp = std::chrono::system_clock::now();
+    frame.pixel_passes = 1;
+    frame.scale_factor = 1;
     frame.data.resize(m_screenWidth * m_screenHeight * 4);
 
     uint8_t* src = static_cast<uint8_t*>(mappedResource.pData);
@@ -315,9 +323,6 @@ bool Win32ScreenCapture::CaptureDXGI(CaptureFrame& frame) {
                    m_screenWidth * 4);
     }
 
-    // Convert BGRA to RGBA
-    ConvertBGRAToRGBA(frame.data);
-
     // Unmap and release
     m_context->Unmap(m_stagingTexture, 0);
     m_duplication->ReleaseFrame();
@@ -372,7 +377,11 @@ bool Win32ScreenCapture::CaptureGDI(int x, int y, int width, int height, Capture
     frame.width = width;
     frame.height = height;
     frame.bytes_per_pixel = 4;
+    frame.stride = 0;
+    frame.format = ImageFormat::BGRX;  // GDI leaves the fourth byte undefined
     frame.timestamp = std::chrono::system_clock::now();
+    frame.pixel_passes = 1;
+    frame.scale_factor = 1;
     frame.data.resize(width * height * 4);
 
     BITMAPINFO bmpInfo = m_bitmapInfo;
@@ -389,22 +398,6 @@ bool Win32ScreenCapture::CaptureGDI(int x, int y, int width, int height, Capture
         return false;
     }
 
-    // Convert BGRA to RGBA
-    ConvertBGRAToRGBA(frame.data);
-
-    return true;
-}
-
-bool Win32ScreenCapture::ConvertBGRAToRGBA(std::vector<uint8_t>& data) {
-    if (data.size() % 4 != 0) {
-        return false;
-    }
-
-    for (size_t i = 0; i < data.size(); i += 4) {
-        // Swap B and R channels
-        std::swap(data[i], data[i + 2]);
-    }
-
     return true;
 }
 
@@ -50,9 +50,6 @@ private:
     // GDI methods (fallback for older Windows)
     bool CaptureGDI(int x, int y, int width, int height, CaptureFrame& frame);
 
-    // Helper methods
-    bool ConvertBGRAToRGBA(std::vector<uint8_t>& data);
-
 private:
     bool m_initialized;
     bool m_supportsDXGI;
@@ -311,6 +311,10 @@ void ConfigManager::SetDefaultConfiguration() {
     SetBool(DefaultConfig::MONITOR_SECTION, DefaultConfig::MONITOR_SCREEN_CAPTURE, true);
     SetInt(DefaultConfig::MONITOR_SECTION, DefaultConfig::MONITOR_CAPTURE_INTERVAL_MS, 1000);
     SetInt(DefaultConfig::MONITOR_SECTION, DefaultConfig::MONITOR_OCR_INTERVAL_FRAMES, 10);
+    
+    // Resource budget settings
+    SetDouble(DefaultConfig::PERFORMANCE_SECTION, DefaultConfig::PERF_CPU_TARGET_PERCENT, 25.0);
+    SetBool(DefaultConfig::PERFORMANCE_SECTION, DefaultConfig::PERF_YIELD_TO_FOREGROUND, true);
 }
 
 bool ConfigManager::ParseConfigLine(const std::string& line, std::string& section, std::string& key, std::string& value) {
@@ -1,4 +1,5 @@
 #include "storage_engine.h"
+#include "range_query_executor.h"
 #include "common_types.h"
 #include "ocr_engine.h"
 #include "ai_engine.h"
@@ -7,6 +8,7 @@
 #include <random>
 #include <iomanip>
 #include <algorithm>
+#include <iterator>
 #include <fstream>
 
 namespace work_assistant {
@@ -57,6 +59,8 @@ public:
             }
         }
 
+        m_rangeQueries = std::make_unique<RangeQueryExecutor>();
+
         m_initialized = true;
         std::cout << "Encrypted Storage Manager initialized" << std::endl;
         return true;
@@ -166,9 +170,9 @@ public:
         return id > 0;
     }
 
-    bool StoreOCRResult(const OCRDocument& document, const std::string& source) {
+    uint64_t StoreOCRResult(const OCRDocument& document, const std::string& source) {
         if (!IsReady()) {
-            return false;
+            return 0;
         }
 
         DataRecord record;
@@ -182,13 +186,12 @@ public:
         record.SetStringData(document.GetOrderedText());
         record.checksum = storage_utils::CalculateChecksum(record.data);
 
-        uint64_t id = m_storage->StoreRecord(record);
-        return id > 0;
+        return m_storage->StoreRecord(record);
     }
 
-    bool StoreAIAnalysis(const ContentAnalysis& analysis) {
+    uint64_t StoreAIAnalysis(const ContentAnalysis& analysis) {
         if (!IsReady()) {
-            return false;
+            return 0;
         }
 
         ContentAnalysisRecord record;
@@ -207,8 +210,7 @@ public:
         record.distraction_level = analysis.distraction_level;
         record.processing_time = analysis.processing_time;
 
-        uint64_t id = m_storage->StoreContentAnalysis(record);
-        return id > 0;
+        return m_storage->StoreContentAnalysis(record);
     }
 
     bool StoreBatch(const std::vector<WindowActivityRecord>& activities,
@@ -265,114 +267,219 @@ public:
         return m_storage->GetProductivityData(start, end);
     }
 
-    std::unordered_map<std::string, float> GetProductivityReport(
-        const std::chrono::system_clock::time_point& start,
-        const std::chrono::system_clock::time_point& end) {
-        
-        std::unordered_map<std::string, float> report;
+    bool GetContentAnalysis(uint64_t id, ContentAnalysisRecord& analysis) {
         if (!IsReady()) {
-            return report;
+            return false;
         }
 
-        auto analyses = GetContentAnalyses(start, end);
-        if (analyses.empty()) {
-            return report;
+        DataRecord record;
+        if (!m_storage->GetRecord(id, record) || record.type != RecordType::AI_ANALYSIS) {
+            return false;
         }
 
-        // Calculate productivity metrics
-        int total_activities = analyses.size();
-        int productive_activities = 0;
-        int focused_activities = 0;
-        float total_confidence = 0.0f;
-        int total_distraction = 0;
+        analysis = ContentAnalysisRecord::FromDataRecord(record);
+        analysis.id = id;
+        return true;
+    }
 
-        std::unordered_map<ContentType, int> type_counts;
-        std::unordered_map<WorkCategory, int> category_counts;
+    std::vector<OCRTextRecord> GetOCRResults(uint64_t after_id, size_t limit) {
+        std::vector<OCRTextRecord> results;
+        if (!IsReady()) {
+            return results;
+        }
 
-        for (const auto& analysis : analyses) {
-            if (analysis.is_productive) productive_activities++;
-            if (analysis.is_focused_work) focused_activities++;
-            
-            total_confidence += analysis.ai_confidence;
-            total_distraction += analysis.distraction_level;
-            
-            type_counts[analysis.content_type]++;
-            category_counts[analysis.work_category]++;
-        }
-
-        // Generate report
-        report["total_activities"] = static_cast<float>(total_activities);
-        report["productive_ratio"] = static_cast<float>(productive_activities) / total_activities;
-        report["focused_ratio"] = static_cast<float>(focused_activities) / total_activities;
-        report["avg_confidence"] = total_confidence / total_activities;
-        report["avg_distraction"] = static_cast<float>(total_distraction) / total_activities;
-        
-        // Most common activity type
-        auto max_type = std::max_element(type_counts.begin(), type_counts.end(),
-                                       [](const auto& a, const auto& b) {
-                                           return a.second < b.second;
-                                       });
-        if (max_type != type_counts.end()) {
-            report["dominant_content_type"] = static_cast<float>(static_cast<int>(max_type->first));
+        // Callers page with the last id they saw, so the results must be
+        // the id prefix after it: a time order (or an end time of now)
+        // would skip records whose clock stamps run out of id order
+        QueryParams params;
+        params.start_time = std::chrono::system_clock::time_point();
+        params.end_time = std::chrono::system_clock::time_point::max();
+        params.record_types = {RecordType::OCR_RESULT};
+        params.after_id = after_id;
+        params.order_by_id = true;
+        params.limit = limit;
+        params.order_descending = false;
+
+        for (const auto& record : m_storage->QueryRecords(params)) {
+            OCRTextRecord result;
+            result.id = record.id;
+            result.timestamp = record.timestamp;
+            result.text = record.GetStringData();
+            results.push_back(std::move(result));
         }
+        return results;
+    }
 
-        return report;
+    bool GetOCRResult(uint64_t id, OCRTextRecord& result) {
+        if (!IsReady()) {
+            return false;
+        }
+
+        DataRecord record;
+        if (!m_storage->GetRecord(id, record) || record.type != RecordType::OCR_RESULT) {
+            return false;
+        }
+
+        result.id = id;
+        result.timestamp = record.timestamp;
+        result.text = record.GetStringData();
+        return true;
     }
 
-    std::vector<std::pair<std::string, std::chrono::minutes>> GetTimeSpentByApplication(
+    bool GetScreenCaptureThumbnail(uint64_t capture_id, int width, ScreenThumbnail& thumbnail) {
+        if (!IsReady()) {
+            return false;
+        }
+
+        return m_storage->GetScreenCaptureThumbnail(capture_id, width, thumbnail);
+    }
+
+    std::vector<ScreenThumbnail> GetScreenCaptureThumbnails(
         const std::chrono::system_clock::time_point& start,
         const std::chrono::system_clock::time_point& end) {
         
-        std::vector<std::pair<std::string, std::chrono::minutes>> time_spent;
         if (!IsReady()) {
-            return time_spent;
+            return {};
+        }
+
+        return m_storage->ListScreenCaptureThumbnails(start, end);
+    }
+
+    std::unordered_map<std::string, float> GetProductivityReport(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end,
+        const CancellationCheck& cancelled) {
+        
+        if (!IsReady()) {
+            return {};
         }
 
-        auto usage = m_storage->GetApplicationUsage(start, end);
+        // Per-partition totals, merged once every partition is done
+        std::vector<ProductivityTotals> partials;
+        bool complete = ScanPartitioned(start, end, {RecordType::AI_ANALYSIS}, cancelled, partials,
+            [](ProductivityTotals& partial, const DataRecord& record) {
+                partial.Add(ContentAnalysisRecord::FromDataRecord(record));
+            });
+        if (!complete) {
+            return {};
+        }
+
+        ProductivityTotals total;
+        for (const auto& partial : partials) {
+            total.Merge(partial);
+        }
+        return total.ToReport();
+    }
+
+    std::vector<std::pair<std::string, std::chrono::minutes>> GetTimeSpentByApplication(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end,
+        const CancellationCheck& cancelled) {
         
-        for (const auto& [app, count] : usage) {
-            // Rough estimation: assume each event represents 30 seconds
-            auto minutes = std::chrono::minutes(count / 2);
-            time_spent.emplace_back(app, minutes);
+        if (!IsReady()) {
+            return {};
         }
 
-        // Sort by time spent (descending)
-        std::sort(time_spent.begin(), time_spent.end(),
-                 [](const auto& a, const auto& b) {
-                     return a.second > b.second;
-                 });
+        std::vector<std::unordered_map<std::string, int>> partials;
+        bool complete = ScanPartitioned(start, end, {RecordType::WINDOW_EVENT}, cancelled, partials,
+            [](std::unordered_map<std::string, int>& partial, const DataRecord& record) {
+                auto activity = WindowActivityRecord::FromDataRecord(record);
+                if (!activity.application_name.empty()) {
+                    partial[activity.application_name]++;
+                }
+            });
+        if (!complete) {
+            return {};
+        }
 
-        return time_spent;
+        std::unordered_map<std::string, int> usage;
+        for (const auto& partial : partials) {
+            for (const auto& [app, count] : partial) {
+                usage[app] += count;
+            }
+        }
+        return storage_utils::EstimateTimeByApplication(usage);
     }
 
-    std::vector<ContentAnalysisRecord> SearchContent(const std::string& query, int max_results) {
-        std::vector<ContentAnalysisRecord> results;
+    bool GetActivityRollup(const std::chrono::system_clock::time_point& start,
+                           const std::chrono::system_clock::time_point& end,
+                           ActivityRollup& rollup,
+                           const CancellationCheck& cancelled) {
         if (!IsReady()) {
+            return false;
+        }
+
+        // The stored row carries the exact id and timestamp; the serialised
+        // body may not round-trip them
+        std::vector<ActivityRollup> partials;
+        bool complete = ScanPartitioned(start, end, {RecordType::WINDOW_EVENT, RecordType::AI_ANALYSIS},
+            cancelled, partials,
+            [](ActivityRollup& partial, const DataRecord& record) {
+                if (record.type == RecordType::WINDOW_EVENT) {
+                    auto activity = WindowActivityRecord::FromDataRecord(record);
+                    activity.id = record.id;
+                    activity.timestamp = record.timestamp;
+                    partial.activities.push_back(std::move(activity));
+                } else {
+                    auto analysis = ContentAnalysisRecord::FromDataRecord(record);
+                    analysis.id = record.id;
+                    analysis.timestamp = record.timestamp;
+                    partial.analyses.push_back(std::move(analysis));
+                }
+            });
+        if (!complete) {
+            return false;
+        }
+
+        // Partitions are in time order and each was scanned ascending
+        ActivityRollup merged;
+        merged.start_time = start;
+        merged.end_time = end;
+        for (auto& partial : partials) {
+            std::move(partial.activities.begin(), partial.activities.end(), std::back_inserter(merged.activities));
+            std::move(partial.analyses.begin(), partial.analyses.end(), std::back_inserter(merged.analyses));
+        }
+        rollup = std::move(merged);
+        return true;
+    }
+
+    std::vector<ContentAnalysisRecord> SearchContent(const std::string& query, int max_results,
+                                                     const std::string& application,
+                                                     PruningStats* pruning) {
+        std::vector<ContentAnalysisRecord> results;
+        if (!IsReady() || max_results <= 0) {
             return results;
         }
 
-        // Simple search implementation
+        // Whole history, newest first; the text and application let the
+        // engine skip partitions that cannot hold a match
         QueryParams params;
+        params.start_time = std::chrono::system_clock::time_point();
+        params.end_time = std::chrono::system_clock::now();
         params.record_types = {RecordType::AI_ANALYSIS};
-        params.limit = max_results;
         params.search_text = query;
+        if (!application.empty()) {
+            params.applications = {application};
+        }
 
-        auto records = m_storage->QueryRecords(params);
-        for (const auto& record : records) {
+        std::string lower_query = query;
+        std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(), ::tolower);
+
+        m_storage->ScanRecords(params, [&](const DataRecord& record) {
             if (record.type == RecordType::AI_ANALYSIS) {
                 auto analysis = ContentAnalysisRecord::FromDataRecord(record);
                 
                 // Check if query matches extracted text
                 std::string text = analysis.extracted_text;
                 std::transform(text.begin(), text.end(), text.begin(), ::tolower);
-                std::string lower_query = query;
-                std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(), ::tolower);
                 
-                if (text.find(lower_query) != std::string::npos) {
+                if (text.find(lower_query) != std::string::npos &&
+                    (application.empty() || analysis.application_name == application)) {
                     results.push_back(analysis);
                 }
             }
-        }
+            return results.size() < static_cast<size_t>(max_results);
+        }, pruning);
 
         return results;
     }
@@ -446,6 +553,118 @@ public:
         return m_storage->CleanupOldData();
     }
 
+    bool CompactDatabase() {
+        if (!IsReady()) {
+            return false;
+        }
+
+        return m_storage->CompactDatabase();
+    }
+
+    uint64_t StoreDeferredJob(const DeferredJobRecord& job) {
+        if (!IsReady()) {
+            return 0;
+        }
+        return m_storage->StoreRecord(job.ToDataRecord());
+    }
+
+    bool UpdateDeferredJob(const DeferredJobRecord& job) {
+        if (!IsReady() || job.id == 0) {
+            return false;
+        }
+        return m_storage->UpdateRecord(job.ToDataRecord());
+    }
+
+    bool RemoveDeferredJob(uint64_t id) {
+        if (!IsReady()) {
+            return false;
+        }
+        return m_storage->DeleteRecord(id);
+    }
+
+    std::vector<DeferredJobRecord> GetDeferredJobs() {
+        std::vector<DeferredJobRecord> jobs;
+        if (!IsReady()) {
+            return jobs;
+        }
+
+        // Jobs may have been queued long before this run
+        QueryParams params;
+        params.start_time = std::chrono::system_clock::time_point();
+        params.end_time = std::chrono::system_clock::now();
+        params.record_types = {RecordType::DEFERRED_JOB};
+        params.limit = 10000;
+        params.order_descending = false;
+
+        for (const auto& record : m_storage->QueryRecords(params)) {
+            DeferredJobRecord job = DeferredJobRecord::FromDataRecord(record);
+            if (!job.kind.empty()) {
+                jobs.push_back(job);
+            }
+        }
+        return jobs;
+    }
+
+    bool GetRecordsAfter(uint64_t after_id, size_t limit,
+                         std::vector<WindowActivityRecord>& activities,
+                         std::vector<ContentAnalysisRecord>& analyses,
+                         uint64_t& last_id) {
+        last_id = after_id;
+        if (!IsReady()) {
+            return false;
+        }
+
+        // Ids, not timestamps, order the stream: records can be stored
+        // with times earlier than ones already sent
+        QueryParams params;
+        params.start_time = std::chrono::system_clock::time_point();
+        params.end_time = std::chrono::system_clock::time_point::max();
+        params.record_types = {RecordType::WINDOW_EVENT, RecordType::AI_ANALYSIS};
+        params.after_id = after_id;
+        params.order_by_id = true;
+        params.order_descending = false;
+        params.limit = limit;
+
+        for (const auto& record : m_storage->QueryRecords(params)) {
+            if (record.type == RecordType::WINDOW_EVENT) {
+                WindowActivityRecord activity = WindowActivityRecord::FromDataRecord(record);
+                activity.id = record.id;
+                activities.push_back(activity);
+            } else {
+                ContentAnalysisRecord analysis = ContentAnalysisRecord::FromDataRecord(record);
+                analysis.id = record.id;
+                analyses.push_back(analysis);
+            }
+            last_id = record.id;
+        }
+        return true;
+    }
+
+    bool StoreBatchWithState(const std::vector<WindowActivityRecord>& activities,
+                             const std::vector<ContentAnalysisRecord>& analyses,
+                             const std::string& key, const std::string& value) {
+        if (!IsReady()) {
+            return false;
+        }
+
+        std::vector<DataRecord> records;
+        for (const auto& activity : activities) {
+            records.push_back(activity.ToDataRecord());
+        }
+        for (const auto& analysis : analyses) {
+            records.push_back(analysis.ToDataRecord());
+        }
+        return m_storage->StoreRecordsWithState(records, key, value);
+    }
+
+    bool GetStateValue(const std::string& key, std::string& value) {
+        return IsReady() && m_storage->GetStateValue(key, value);
+    }
+
+    bool SetStateValue(const std::string& key, const std::string& value) {
+        return IsReady() && m_storage->StoreRecordsWithState({}, key, value);
+    }
+
     bool ChangePassword(const std::string& old_password, const std::string& new_password) {
         if (!IsReady()) {
             return false;
@@ -507,8 +726,39 @@ public:
     }
 
 private:
+    // Scans records of the given types over [start, end] as time partitions, folding
+    // each partition into its own entry of partials. Returns false if the
+    // scan was cancelled or a partition failed; partials are then incomplete.
+    template<typename Partial, typename Accumulate>
+    bool ScanPartitioned(const std::chrono::system_clock::time_point& start,
+                         const std::chrono::system_clock::time_point& end,
+                         const std::vector<RecordType>& types, const CancellationCheck& cancelled,
+                         std::vector<Partial>& partials, Accumulate accumulate) {
+        auto partitions = m_rangeQueries->Partition(start, end);
+        partials.assign(partitions.size(), Partial());
+
+        return m_rangeQueries->Execute(partitions,
+            [this, &types, &partials, &accumulate](const RangePartition& partition, const std::atomic<bool>& stop) {
+                QueryParams params;
+                params.start_time = partition.start;
+                params.end_time = partition.end;
+                params.record_types = types;
+                params.order_descending = false;
+
+                Partial& partial = partials[partition.index];
+                return m_storage->ScanRecords(params, [&](const DataRecord& record) {
+                    if (std::find(types.begin(), types.end(), record.type) != types.end()) {
+                        accumulate(partial, record);
+                    }
+                    return !stop;
+                });
+            },
+            cancelled, m_storage->SupportsConcurrentReads());
+    }
+
     bool m_initialized;
     std::unique_ptr<IStorageEngine> m_storage;
+    std::unique_ptr<RangeQueryExecutor> m_rangeQueries;
     StorageConfig m_config;
     std::string m_current_session_id;
     std::chrono::system_clock::time_point m_session_start_time;
@@ -550,11 +800,11 @@ bool EncryptedStorageManager::StoreScreenCapture(const CaptureFrame& frame, cons
     return m_impl->StoreScreenCapture(frame, context);
 }
 
-bool EncryptedStorageManager::StoreOCRResult(const OCRDocument& document, const std::string& source) {
+uint64_t EncryptedStorageManager::StoreOCRResult(const OCRDocument& document, const std::string& source) {
     return m_impl->StoreOCRResult(document, source);
 }
 
-bool EncryptedStorageManager::StoreAIAnalysis(const ContentAnalysis& analysis) {
+uint64_t EncryptedStorageManager::StoreAIAnalysis(const ContentAnalysis& analysis) {
     return m_impl->StoreAIAnalysis(analysis);
 }
 
@@ -575,21 +825,55 @@ std::vector<ContentAnalysisRecord> EncryptedStorageManager::GetContentAnalyses(
     return m_impl->GetContentAnalyses(start, end);
 }
 
-std::unordered_map<std::string, float> EncryptedStorageManager::GetProductivityReport(
+bool EncryptedStorageManager::GetContentAnalysis(uint64_t id, ContentAnalysisRecord& analysis) {
+    return m_impl->GetContentAnalysis(id, analysis);
+}
+
+std::vector<OCRTextRecord> EncryptedStorageManager::GetOCRResults(uint64_t after_id, size_t limit) {
+    return m_impl->GetOCRResults(after_id, limit);
+}
+
+bool EncryptedStorageManager::GetOCRResult(uint64_t id, OCRTextRecord& result) {
+    return m_impl->GetOCRResult(id, result);
+}
+
+bool EncryptedStorageManager::GetScreenCaptureThumbnail(uint64_t capture_id, int width,
+                                                        ScreenThumbnail& thumbnail) {
+    return m_impl->GetScreenCaptureThumbnail(capture_id, width, thumbnail);
+}
+
+std::vector<ScreenThumbnail> EncryptedStorageManager::GetScreenCaptureThumbnails(
     const std::chrono::system_clock::time_point& start,
     const std::chrono::system_clock::time_point& end) {
-    return m_impl->GetProductivityReport(start, end);
+    return m_impl->GetScreenCaptureThumbnails(start, end);
+}
+
+std::unordered_map<std::string, float> EncryptedStorageManager::GetProductivityReport(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end,
+    const CancellationCheck& cancelled) {
+    return m_impl->GetProductivityReport(start, end, cancelled);
 }
 
 std::vector<std::pair<std::string, std::chrono::minutes>> EncryptedStorageManager::GetTimeSpentByApplication(
     const std::chrono::system_clock::time_point& start,
-    const std::chrono::system_clock::time_point& end) {
-    return m_impl->GetTimeSpentByApplication(start, end);
+    const std::chrono::system_clock::time_point& end,
+    const CancellationCheck& cancelled) {
+    return m_impl->GetTimeSpentByApplication(start, end, cancelled);
+}
+
+bool EncryptedStorageManager::GetActivityRollup(const std::chrono::system_clock::time_point& start,
+                                                const std::chrono::system_clock::time_point& end,
+                                                ActivityRollup& rollup,
+                                                const CancellationCheck& cancelled) {
+    return m_impl->GetActivityRollup(start, end, rollup, cancelled);
 }
 
 std::vector<ContentAnalysisRecord> EncryptedStorageManager::SearchContent(const std::string& query,
-                                                                         int max_results) {
-    return m_impl->SearchContent(query, max_results);
+                                                                         int max_results,
+                                                                         const std::string& application,
+                                                                         PruningStats* pruning) {
+    return m_impl->SearchContent(query, max_results, application, pruning);
 }
 
 bool EncryptedStorageManager::ExportData(const std::string& export_path,
@@ -606,6 +890,47 @@ bool EncryptedStorageManager::CleanupOldData(const std::chrono::hours& retention
     return m_impl->CleanupOldData(retention_period);
 }
 
+bool EncryptedStorageManager::CompactDatabase() {
+    return m_impl->CompactDatabase();
+}
+
+uint64_t EncryptedStorageManager::StoreDeferredJob(const DeferredJobRecord& job) {
+    return m_impl->StoreDeferredJob(job);
+}
+
+bool EncryptedStorageManager::UpdateDeferredJob(const DeferredJobRecord& job) {
+    return m_impl->UpdateDeferredJob(job);
+}
+
+bool EncryptedStorageManager::RemoveDeferredJob(uint64_t id) {
+    return m_impl->RemoveDeferredJob(id);
+}
+
+std::vector<DeferredJobRecord> EncryptedStorageManager::GetDeferredJobs() {
+    return m_impl->GetDeferredJobs();
+}
+
+bool EncryptedStorageManager::GetRecordsAfter(uint64_t after_id, size_t limit,
+                                              std::vector<WindowActivityRecord>& activities,
+                                              std::vector<ContentAnalysisRecord>& analyses,
+                                              uint64_t& last_id) {
+    return m_impl->GetRecordsAfter(after_id, limit, activities, analyses, last_id);
+}
+
+bool EncryptedStorageManager::StoreBatchWithState(const std::vector<WindowActivityRecord>& activities,
+                                                  const std::vector<ContentAnalysisRecord>& analyses,
+                                                  const std::string& key, const std::string& value) {
+    return m_impl->StoreBatchWithState(activities, analyses, key, value);
+}
+
+bool EncryptedStorageManager::GetStateValue(const std::string& key, std::string& value) {
+    return m_impl->GetStateValue(key, value);
+}
+
+bool EncryptedStorageManager::SetStateValue(const std::string& key, const std::string& value) {
+    return m_impl->SetStateValue(key, value);
+}
+
 bool EncryptedStorageManager::ChangePassword(const std::string& old_password, const std::string& new_password) {
     return m_impl->ChangePassword(old_password, new_password);
 }
@@ -0,0 +1,375 @@
+#include "fingerprint_index.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <mutex>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <algorithm>
+
+namespace work_assistant {
+
+namespace {
+
+// On-disk layout: header, then fixed-size entries in insertion order.
+// A replaced hash is simply appended again; the last occurrence wins.
+const char FILE_MAGIC[4] = {'W', 'A', 'F', 'P'};
+const uint32_t FILE_VERSION = 1;
+
+struct FileEntry {
+    uint64_t hash;
+    uint64_t ocr_record_id;
+    uint64_t analysis_record_id;
+};
+
+const size_t HEADER_SIZE = sizeof(FILE_MAGIC) + sizeof(FILE_VERSION);
+
+// Rewrite the file once replaced entries outnumber live ones, but not for
+// small files where the waste doesn't matter
+const size_t COMPACT_MIN_DEAD_ENTRIES = 4096;
+
+int HammingDistance(uint64_t a, uint64_t b) {
+    return __builtin_popcountll(a ^ b);
+}
+
+} // namespace
+
+class FingerprintIndex::Impl {
+public:
+    Impl() : m_lookups(0), m_hits(0) {}
+
+    ~Impl() {
+        Close();
+    }
+
+    bool Open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CloseLocked();
+
+        if (path.empty()) {
+            m_open = true;
+            return true;
+        }
+
+        if (!Load(path)) {
+            return false;
+        }
+
+        // Appends must start on an entry boundary, or every entry after a
+        // torn one would be read shifted
+        std::error_code ec;
+        size_t valid = m_fileEntries * sizeof(FileEntry) + HEADER_SIZE;
+        size_t size = FileSize(path);
+        if (size > valid) {
+            std::filesystem::resize_file(path, valid, ec);
+            if (ec) {
+                std::cerr << "Failed to truncate fingerprint index: " << ec.message() << std::endl;
+                return false;
+            }
+        }
+
+        m_path = path;
+        if (!(size == 0 ? Rewrite() : OpenForAppend())) {
+            return false;
+        }
+        m_open = true;
+        CompactIfNeeded();
+        std::cout << "Fingerprint index loaded: " << m_entries.size() << " screens" << std::endl;
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CloseLocked();
+    }
+
+    bool IsOpen() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_open;
+    }
+
+    bool Add(uint64_t hash, uint64_t ocrRecordId, uint64_t analysisRecordId) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_open) {
+            return false;
+        }
+
+        FileEntry entry{hash, ocrRecordId, analysisRecordId};
+        Insert(entry);
+
+        if (m_file.is_open()) {
+            m_file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            m_file.flush();
+            if (!m_file) {
+                std::cerr << "Failed to append to fingerprint index" << std::endl;
+                return false;
+            }
+            m_fileEntries++;
+            CompactIfNeeded();
+        }
+        return true;
+    }
+
+    bool FindNearest(uint64_t hash, int maxDistance, FingerprintMatch& match) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lookups++;
+        if (m_entries.empty() || maxDistance < 0 || maxDistance > MAX_DISTANCE) {
+            return false;
+        }
+
+        // Pigeonhole: some substring differs by at most maxDistance / SUBSTRINGS bits
+        const int substringRadius = maxDistance / SUBSTRINGS;
+        int best = -1;
+        int bestDistance = maxDistance + 1;
+        for (int table = 0; table < SUBSTRINGS; ++table) {
+            Probe(table, Substring(hash, table), 0, substringRadius, hash, best, bestDistance);
+        }
+
+        if (best < 0) {
+            return false;
+        }
+
+        const FileEntry& entry = m_entries[best];
+        match.hash = entry.hash;
+        match.distance = bestDistance;
+        match.ocr_record_id = entry.ocr_record_id;
+        match.analysis_record_id = entry.analysis_record_id;
+        m_hits++;
+        return true;
+    }
+
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    FingerprintIndexStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FingerprintIndexStatistics stats;
+        stats.entries = m_entries.size();
+        stats.lookups = m_lookups;
+        stats.hits = m_hits;
+        stats.memory_bytes = m_entries.capacity() * sizeof(FileEntry) +
+                             m_sequences.capacity() * sizeof(uint64_t);
+        for (const auto& table : m_tables) {
+            stats.memory_bytes += table.capacity() * sizeof(std::vector<uint32_t>);
+            for (const auto& bucket : table) {
+                stats.memory_bytes += bucket.capacity() * sizeof(uint32_t);
+            }
+        }
+        return stats;
+    }
+
+private:
+    static constexpr int SUBSTRINGS = 4;
+    static constexpr int SUBSTRING_BITS = 16;
+    static constexpr size_t BUCKETS = size_t(1) << SUBSTRING_BITS;
+    static constexpr int MAX_DISTANCE = 15;     // Up to 3-bit probes per substring
+
+    static uint32_t Substring(uint64_t hash, int table) {
+        return static_cast<uint32_t>((hash >> (table * SUBSTRING_BITS)) & (BUCKETS - 1));
+    }
+
+    static size_t FileSize(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return file ? static_cast<size_t>(file.tellg()) : 0;
+    }
+
+    bool Load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return true;   // Created on first use
+        }
+
+        char magic[sizeof(FILE_MAGIC)] = {};
+        uint32_t version = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (file.gcount() == 0 && file.eof()) {
+            return true;   // Empty file
+        }
+        if (!file || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || version != FILE_VERSION) {
+            std::cerr << "Unrecognized fingerprint index file: " << path << std::endl;
+            return false;
+        }
+
+        // Read in blocks; a torn final entry from a crash is ignored here
+        // and cut off by Open()
+        std::vector<FileEntry> block(4096);
+        while (file) {
+            file.read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(FileEntry));
+            size_t count = static_cast<size_t>(file.gcount()) / sizeof(FileEntry);
+            for (size_t i = 0; i < count; ++i) {
+                Insert(block[i]);
+            }
+            m_fileEntries += count;
+        }
+        return true;
+    }
+
+    bool OpenForAppend() {
+        m_file.open(m_path, std::ios::binary | std::ios::app);
+        if (!m_file) {
+            std::cerr << "Failed to open fingerprint index: " << m_path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Writes the live entries to a fresh file, oldest first so a reload
+    // sees the same recency, and swaps it in, leaving the old file
+    // untouched if anything fails
+    bool Rewrite() {
+        std::vector<uint32_t> order(m_entries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return m_sequences[a] < m_sequences[b];
+        });
+
+        std::string temp = m_path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+            out.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+            for (uint32_t index : order) {
+                out.write(reinterpret_cast<const char*>(&m_entries[index]), sizeof(FileEntry));
+            }
+            out.flush();
+            if (!out) {
+                std::cerr << "Failed to write fingerprint index: " << temp << std::endl;
+                return false;
+            }
+        }
+
+        if (m_file.is_open()) {
+            m_file.close();
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, m_path, ec);
+        if (ec) {
+            std::cerr << "Failed to replace fingerprint index: " << ec.message() << std::endl;
+            std::filesystem::remove(temp, ec);
+            return OpenForAppend();
+        }
+        m_fileEntries = m_entries.size();
+        return OpenForAppend();
+    }
+
+    void CompactIfNeeded() {
+        size_t dead = m_fileEntries - m_entries.size();
+        if (dead < COMPACT_MIN_DEAD_ENTRIES || dead < m_entries.size()) {
+            return;
+        }
+        if (Rewrite()) {
+            std::cout << "Fingerprint index compacted: dropped " << dead << " replaced entries" << std::endl;
+        }
+    }
+
+    void Insert(const FileEntry& entry) {
+        if (m_tables[0].empty()) {
+            for (auto& table : m_tables) {
+                table.resize(BUCKETS);
+            }
+        }
+
+        // Exact repeats update the existing entry in place and become the
+        // newest
+        for (uint32_t index : m_tables[0][Substring(entry.hash, 0)]) {
+            if (m_entries[index].hash == entry.hash) {
+                m_entries[index] = entry;
+                m_sequences[index] = m_nextSequence++;
+                return;
+            }
+        }
+
+        const uint32_t index = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back(entry);
+        m_sequences.push_back(m_nextSequence++);
+        for (int table = 0; table < SUBSTRINGS; ++table) {
+            m_tables[table][Substring(entry.hash, table)].push_back(index);
+        }
+    }
+
+    // Visit every bucket whose key is within radius bits of key, flipping
+    // bits at or above firstBit so each key is generated once
+    void Probe(int table, uint32_t key, int firstBit, int radius, uint64_t hash,
+               int& best, int& bestDistance) const {
+        for (uint32_t index : m_tables[table][key]) {
+            int distance = HammingDistance(m_entries[index].hash, hash);
+            if (distance < bestDistance ||
+                (distance == bestDistance && best >= 0 && m_sequences[index] > m_sequences[best])) {
+                best = static_cast<int>(index);
+                bestDistance = distance;
+            }
+        }
+        if (radius == 0) {
+            return;
+        }
+        for (int bit = firstBit; bit < SUBSTRING_BITS; ++bit) {
+            Probe(table, key ^ (1u << bit), bit + 1, radius - 1, hash, best, bestDistance);
+        }
+    }
+
+    void CloseLocked() {
+        if (m_file.is_open()) {
+            m_file.close();
+        }
+        m_path.clear();
+        m_fileEntries = 0;
+        m_entries.clear();
+        m_entries.shrink_to_fit();
+        m_sequences.clear();
+        m_sequences.shrink_to_fit();
+        m_nextSequence = 0;
+        for (auto& table : m_tables) {
+            std::vector<std::vector<uint32_t>>().swap(table);
+        }
+        m_open = false;
+    }
+
+    mutable std::mutex m_mutex;
+    bool m_open = false;
+    std::string m_path;
+    std::ofstream m_file;
+    size_t m_fileEntries = 0;           // Entries in the file, replaced ones included
+    std::vector<FileEntry> m_entries;
+    std::vector<uint64_t> m_sequences;  // Per entry: when it was last added
+    uint64_t m_nextSequence = 0;
+    std::vector<std::vector<uint32_t>> m_tables[SUBSTRINGS];   // Substring value -> entry indices
+    mutable size_t m_lookups;
+    mutable size_t m_hits;
+};
+
+FingerprintIndex::FingerprintIndex() : m_impl(std::make_unique<Impl>()) {}
+FingerprintIndex::~FingerprintIndex() = default;
+
+bool FingerprintIndex::Open(const std::string& path) {
+    return m_impl->Open(path);
+}
+
+void FingerprintIndex::Close() {
+    m_impl->Close();
+}
+
+bool FingerprintIndex::IsOpen() const {
+    return m_impl->IsOpen();
+}
+
+bool FingerprintIndex::Add(uint64_t hash, uint64_t ocrRecordId, uint64_t analysisRecordId) {
+    return m_impl->Add(hash, ocrRecordId, analysisRecordId);
+}
+
+bool FingerprintIndex::FindNearest(uint64_t hash, int maxDistance, FingerprintMatch& match) const {
+    return m_impl->FindNearest(hash, maxDistance, match);
+}
+
+size_t FingerprintIndex::Size() const {
+    return m_impl->Size();
+}
+
+FingerprintIndexStatistics FingerprintIndex::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
@@ -0,0 +1,415 @@
+#include "partition_synopsis.h"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+
+namespace work_assistant {
+
+namespace {
+
+const uint32_t SYNOPSIS_VERSION = 1;
+const size_t FIRST_LAYER_WORDS = 128;     // 8192 bits
+const size_t LAYER_GROWTH = 4;
+const size_t BITS_PER_TERM = 10;          // About 1% false positives per layer
+const int PROBES = 5;
+
+uint64_t Mix(uint64_t x) {
+    // splitmix64 finaliser
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t HashTrigram(unsigned char a, unsigned char b, unsigned char c) {
+    return Mix((static_cast<uint64_t>(a) << 16) | (static_cast<uint64_t>(b) << 8) | c);
+}
+
+uint64_t HashApplication(const std::string& lowercase_name) {
+    // FNV-1a, then mixed; the tag keeps names apart from trigrams
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : "app:" + lowercase_name) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return Mix(hash ^ 0x5bd1e995ULL);
+}
+
+std::string ToLower(const std::string& text) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+uint64_t BitOf(int value) {
+    return (value >= 0 && value < 64) ? (1ULL << value) : 0;
+}
+
+// Records without the key cannot match a filter on it; a value that is not
+// an enum number (SetJsonData() overwrites content_type with a MIME type)
+// could match anything
+uint64_t ZoneBits(const std::unordered_map<std::string, std::string>& metadata, const char* key) {
+    auto it = metadata.find(key);
+    if (it == metadata.end()) {
+        return 0;
+    }
+    try {
+        size_t used = 0;
+        int value = std::stoi(it->second, &used);
+        if (used == it->second.size()) {
+            return BitOf(value);
+        }
+    } catch (...) {
+    }
+    return ~0ULL;
+}
+
+void PutU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+bool GetU64(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+    if (end - data < 8) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    data += 8;
+    return true;
+}
+
+} // namespace
+
+// ScalableBloomFilter
+
+size_t ScalableBloomFilter::Layer::Capacity() const {
+    return words.size() * 64 / BITS_PER_TERM;
+}
+
+ScalableBloomFilter::ScalableBloomFilter() = default;
+
+void ScalableBloomFilter::Add(uint64_t hash) {
+    if (MightContain(hash)) {
+        return;
+    }
+    if (m_layers.empty() || m_layers.back().terms >= m_layers.back().Capacity()) {
+        Layer layer;
+        layer.words.assign(m_layers.empty() ? FIRST_LAYER_WORDS : m_layers.back().words.size() * LAYER_GROWTH, 0);
+        m_layers.push_back(std::move(layer));
+    }
+
+    Layer& layer = m_layers.back();
+    const uint64_t mask = layer.words.size() * 64 - 1;
+    const uint64_t step = Mix(hash) | 1;
+    for (int i = 0; i < PROBES; ++i) {
+        uint64_t bit = (hash + i * step) & mask;
+        layer.words[bit >> 6] |= 1ULL << (bit & 63);
+    }
+    layer.terms++;
+}
+
+bool ScalableBloomFilter::MightContain(uint64_t hash) const {
+    const uint64_t step = Mix(hash) | 1;
+    for (const Layer& layer : m_layers) {
+        const uint64_t mask = layer.words.size() * 64 - 1;
+        bool all = true;
+        for (int i = 0; i < PROBES && all; ++i) {
+            uint64_t bit = (hash + i * step) & mask;
+            all = (layer.words[bit >> 6] >> (bit & 63)) & 1;
+        }
+        if (all) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ScalableBloomFilter::GetMemoryUsage() const {
+    size_t bytes = 0;
+    for (const Layer& layer : m_layers) {
+        bytes += layer.words.size() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void ScalableBloomFilter::Serialize(std::vector<uint8_t>& out) const {
+    PutU64(out, m_layers.size());
+    for (const Layer& layer : m_layers) {
+        PutU64(out, layer.words.size());
+        PutU64(out, layer.terms);
+        for (uint64_t word : layer.words) {
+            PutU64(out, word);
+        }
+    }
+}
+
+bool ScalableBloomFilter::Deserialize(const uint8_t*& data, const uint8_t* end) {
+    m_layers.clear();
+    uint64_t count = 0;
+    if (!GetU64(data, end, count) || count > 64) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t words = 0;
+        Layer layer;
+        if (!GetU64(data, end, words) || !GetU64(data, end, layer.terms) ||
+            words == 0 || (words & (words - 1)) != 0 ||
+            static_cast<uint64_t>(end - data) < words * 8) {
+            m_layers.clear();
+            return false;
+        }
+        layer.words.resize(words);
+        for (uint64_t& word : layer.words) {
+            GetU64(data, end, word);
+        }
+        m_layers.push_back(std::move(layer));
+    }
+    return true;
+}
+
+// PartitionSynopsisIndex
+
+class PartitionSynopsisIndex::Impl {
+public:
+    void Add(RecordType type, int64_t timestamp, const std::string& text,
+             const std::unordered_map<std::string, std::string>& metadata) {
+        std::string lower = ToLower(text);
+        std::string application;
+        auto app = metadata.find("application_name");
+        if (app != metadata.end() && !app->second.empty()) {
+            application = ToLower(app->second);
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        int64_t partition = PartitionOf(timestamp);
+        PartitionSynopsis& synopsis = m_partitions[partition];
+        synopsis.min_timestamp = std::min(synopsis.min_timestamp, timestamp);
+        synopsis.max_timestamp = std::max(synopsis.max_timestamp, timestamp);
+        synopsis.records++;
+        synopsis.type_bits |= BitOf(static_cast<int>(type));
+        synopsis.category_bits |= ZoneBits(metadata, "work_category");
+        synopsis.content_bits |= ZoneBits(metadata, "content_type");
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(lower.data());
+        for (size_t i = 0; i + 3 <= lower.size(); ++i) {
+            synopsis.terms.Add(HashTrigram(bytes[i], bytes[i + 1], bytes[i + 2]));
+        }
+        if (!application.empty()) {
+            synopsis.terms.Add(HashApplication(application));
+        }
+        m_dirty.insert(partition);
+    }
+
+    std::vector<SynopsisCandidate> Candidates(const QueryParams& params, PruningStats& stats) const {
+        using std::chrono::duration_cast;
+        using std::chrono::seconds;
+
+        const int64_t first = duration_cast<seconds>(params.start_time.time_since_epoch()).count();
+        const int64_t last = duration_cast<seconds>(params.end_time.time_since_epoch()).count();
+
+        uint64_t wanted_types = 0;
+        for (RecordType type : params.record_types) {
+            wanted_types |= BitOf(static_cast<int>(type));
+        }
+        uint64_t wanted_categories = 0;
+        for (WorkCategory category : params.work_categories) {
+            wanted_categories |= BitOf(static_cast<int>(category));
+        }
+        uint64_t wanted_content = 0;
+        for (ContentType content : params.content_types) {
+            wanted_content |= BitOf(static_cast<int>(content));
+        }
+
+        // Shorter search text has no complete trigram to test
+        std::vector<uint64_t> trigrams;
+        std::string text = ToLower(params.search_text);
+        const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+        for (size_t i = 0; i + 3 <= text.size(); ++i) {
+            trigrams.push_back(HashTrigram(bytes[i], bytes[i + 1], bytes[i + 2]));
+        }
+        std::vector<uint64_t> applications;
+        for (const auto& application : params.applications) {
+            applications.push_back(HashApplication(ToLower(application)));
+        }
+
+        std::vector<SynopsisCandidate> candidates;
+        if (last < first) {
+            return candidates;
+        }
+
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        for (auto it = m_partitions.lower_bound(PartitionOf(first));
+             it != m_partitions.end() && it->first <= PartitionOf(last); ++it) {
+            const PartitionSynopsis& synopsis = it->second;
+            bool possible = synopsis.max_timestamp >= first && synopsis.min_timestamp <= last &&
+                            (wanted_types == 0 || (synopsis.type_bits & wanted_types)) &&
+                            (wanted_categories == 0 || (synopsis.category_bits & wanted_categories)) &&
+                            (wanted_content == 0 || (synopsis.content_bits & wanted_content));
+            for (size_t i = 0; possible && i < trigrams.size(); ++i) {
+                possible = synopsis.terms.MightContain(trigrams[i]);
+            }
+            if (possible && !applications.empty()) {
+                possible = std::any_of(applications.begin(), applications.end(),
+                                       [&synopsis](uint64_t hash) { return synopsis.terms.MightContain(hash); });
+            }
+
+            if (!possible) {
+                stats.partitions_pruned++;
+                continue;
+            }
+            stats.partitions_scanned++;
+
+            SynopsisCandidate candidate;
+            candidate.partition = it->first;
+            candidate.start = std::max(first, synopsis.min_timestamp);
+            candidate.end = std::min(last, synopsis.max_timestamp);
+            candidates.push_back(candidate);
+        }
+        return candidates;
+    }
+
+    void DropBefore(int64_t cutoff, uint64_t retained_type_bits, std::vector<int64_t>& dropped) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        for (auto it = m_partitions.begin(); it != m_partitions.end() && it->second.min_timestamp < cutoff;) {
+            if (it->second.max_timestamp < cutoff && !(it->second.type_bits & retained_type_bits)) {
+                dropped.push_back(it->first);
+                m_dirty.erase(it->first);
+                it = m_partitions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void Clear() {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_partitions.clear();
+        m_dirty.clear();
+    }
+
+    std::vector<std::pair<int64_t, std::vector<uint8_t>>> TakeDirty() {
+        std::vector<std::pair<int64_t, std::vector<uint8_t>>> blobs;
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        for (int64_t partition : m_dirty) {
+            auto it = m_partitions.find(partition);
+            if (it == m_partitions.end()) {
+                continue;
+            }
+            const PartitionSynopsis& synopsis = it->second;
+            std::vector<uint8_t> blob;
+            PutU64(blob, SYNOPSIS_VERSION);
+            PutU64(blob, static_cast<uint64_t>(synopsis.min_timestamp));
+            PutU64(blob, static_cast<uint64_t>(synopsis.max_timestamp));
+            PutU64(blob, synopsis.records);
+            PutU64(blob, synopsis.type_bits);
+            PutU64(blob, synopsis.category_bits);
+            PutU64(blob, synopsis.content_bits);
+            synopsis.terms.Serialize(blob);
+            blobs.emplace_back(partition, std::move(blob));
+        }
+        m_dirty.clear();
+        return blobs;
+    }
+
+    void MarkAllDirty() {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        for (const auto& entry : m_partitions) {
+            m_dirty.insert(entry.first);
+        }
+    }
+
+    bool Load(int64_t partition, const std::vector<uint8_t>& blob) {
+        const uint8_t* data = blob.data();
+        const uint8_t* end = data + blob.size();
+        uint64_t version = 0, min_timestamp = 0, max_timestamp = 0;
+        PartitionSynopsis synopsis;
+        if (!GetU64(data, end, version) || version != SYNOPSIS_VERSION ||
+            !GetU64(data, end, min_timestamp) || !GetU64(data, end, max_timestamp) ||
+            !GetU64(data, end, synopsis.records) || !GetU64(data, end, synopsis.type_bits) ||
+            !GetU64(data, end, synopsis.category_bits) || !GetU64(data, end, synopsis.content_bits) ||
+            !synopsis.terms.Deserialize(data, end)) {
+            return false;
+        }
+        synopsis.min_timestamp = static_cast<int64_t>(min_timestamp);
+        synopsis.max_timestamp = static_cast<int64_t>(max_timestamp);
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_partitions[partition] = std::move(synopsis);
+        return true;
+    }
+
+    size_t GetPartitionCount() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_partitions.size();
+    }
+
+    size_t GetMemoryUsage() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        size_t bytes = 0;
+        for (const auto& entry : m_partitions) {
+            bytes += sizeof(PartitionSynopsis) + entry.second.terms.GetMemoryUsage();
+        }
+        return bytes;
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::map<int64_t, PartitionSynopsis> m_partitions;
+    std::set<int64_t> m_dirty;
+};
+
+PartitionSynopsisIndex::PartitionSynopsisIndex() : m_impl(std::make_unique<Impl>()) {}
+PartitionSynopsisIndex::~PartitionSynopsisIndex() = default;
+
+void PartitionSynopsisIndex::Add(RecordType type, int64_t timestamp, const std::string& text,
+                                 const std::unordered_map<std::string, std::string>& metadata) {
+    m_impl->Add(type, timestamp, text, metadata);
+}
+
+std::vector<SynopsisCandidate> PartitionSynopsisIndex::Candidates(const QueryParams& params,
+                                                                  PruningStats& stats) const {
+    return m_impl->Candidates(params, stats);
+}
+
+void PartitionSynopsisIndex::DropBefore(int64_t cutoff, uint64_t retained_type_bits,
+                                        std::vector<int64_t>& dropped) {
+    m_impl->DropBefore(cutoff, retained_type_bits, dropped);
+}
+
+void PartitionSynopsisIndex::Clear() {
+    m_impl->Clear();
+}
+
+std::vector<std::pair<int64_t, std::vector<uint8_t>>> PartitionSynopsisIndex::TakeDirty() {
+    return m_impl->TakeDirty();
+}
+
+void PartitionSynopsisIndex::MarkAllDirty() {
+    m_impl->MarkAllDirty();
+}
+
+bool PartitionSynopsisIndex::Load(int64_t partition, const std::vector<uint8_t>& blob) {
+    return m_impl->Load(partition, blob);
+}
+
+size_t PartitionSynopsisIndex::GetPartitionCount() const {
+    return m_impl->GetPartitionCount();
+}
+
+size_t PartitionSynopsisIndex::GetMemoryUsage() const {
+    return m_impl->GetMemoryUsage();
+}
+
+int64_t PartitionSynopsisIndex::PartitionOf(int64_t timestamp) {
+    // Floor division, so times before the epoch fall in the right day
+    int64_t partition = timestamp / PARTITION_SECONDS;
+    return (timestamp % PARTITION_SECONDS < 0) ? partition - 1 : partition;
+}
+
+} // namespace work_assistant
@@ -0,0 +1,172 @@
+#include "range_query_executor.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <mutex>
+
+namespace work_assistant {
+
+namespace {
+
+// How often a waiting Execute() polls the cancellation check
+const auto CANCEL_POLL_INTERVAL = std::chrono::milliseconds(20);
+
+} // namespace
+
+class RangeQueryExecutor::Impl {
+public:
+    explicit Impl(const RangeQueryConfig& config)
+        : m_config(config.IsValid() ? config : RangeQueryConfig()) {
+        m_parallelism = m_config.parallelism > 0 ? m_config.parallelism
+                                                 : std::max(1u, std::thread::hardware_concurrency());
+        m_pool = std::make_unique<WorkAssistant::ThreadPool>(m_parallelism);
+    }
+
+    std::vector<RangePartition> Partition(const std::chrono::system_clock::time_point& start,
+                                          const std::chrono::system_clock::time_point& end) const {
+        using std::chrono::duration_cast;
+        using std::chrono::seconds;
+
+        std::vector<RangePartition> partitions;
+        const int64_t first = duration_cast<seconds>(start.time_since_epoch()).count();
+        const int64_t last = duration_cast<seconds>(end.time_since_epoch()).count();
+        if (last < first) {
+            return partitions;
+        }
+
+        // Day-sized partitions for long ranges; shorter ranges are still
+        // spread over the workers down to the minimum span
+        const int64_t span = last - first + 1;
+        const int64_t preferred = duration_cast<seconds>(m_config.partition_span).count();
+        const int64_t smallest = duration_cast<seconds>(m_config.min_partition_span).count();
+        int64_t count = (span + preferred - 1) / preferred;
+        count = std::max(count, std::min<int64_t>(static_cast<int64_t>(m_parallelism), (span + smallest - 1) / smallest));
+        count = std::max<int64_t>(1, std::min<int64_t>(count, static_cast<int64_t>(m_config.max_partitions)));
+
+        const int64_t width = (span + count - 1) / count;
+        for (int64_t begin = first; begin <= last; begin += width) {
+            RangePartition partition;
+            partition.index = partitions.size();
+            partition.start = std::chrono::system_clock::time_point(seconds(begin));
+            partition.end = std::chrono::system_clock::time_point(seconds(std::min(last, begin + width - 1)));
+            partitions.push_back(partition);
+        }
+        // The caller's exact bounds, not their truncation to seconds
+        partitions.front().start = start;
+        partitions.back().end = end;
+        return partitions;
+    }
+
+    bool Execute(const std::vector<RangePartition>& partitions, const PartitionTask& task,
+                 const CancellationCheck& cancelled, bool parallel) {
+        if (partitions.empty()) {
+            return true;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        std::atomic<bool> stop{false};
+        std::atomic<bool> failed{false};
+
+        auto run = [&task, &stop, &failed](const RangePartition& partition) {
+            if (stop) {
+                return;
+            }
+            bool ok = false;
+            try {
+                ok = task(partition, stop);
+            } catch (const std::exception& e) {
+                std::cerr << "Range query partition failed: " << e.what() << std::endl;
+            }
+            if (!ok && !stop) {
+                failed = true;
+                stop = true;
+            }
+        };
+
+        std::vector<std::future<void>> pending;
+        if (parallel && partitions.size() > 1) {
+            for (const RangePartition& partition : partitions) {
+                pending.push_back(m_pool->enqueue([&run, &partition]() { run(partition); }));
+            }
+        } else {
+            // Serialised reads: one task walks the partitions in order, so
+            // cancellation still takes effect between and within them
+            pending.push_back(m_pool->enqueue([&run, &partitions]() {
+                for (const RangePartition& partition : partitions) {
+                    run(partition);
+                }
+            }));
+        }
+
+        // Tasks reference this frame, so every one is waited for even after
+        // cancellation; the stop flag makes that quick
+        bool wasCancelled = false;
+        for (auto& future : pending) {
+            while (future.wait_for(CANCEL_POLL_INTERVAL) != std::future_status::ready) {
+                if (!stop && cancelled && cancelled()) {
+                    wasCancelled = true;
+                    stop = true;
+                }
+            }
+        }
+        if (!stop && cancelled && cancelled()) {
+            wasCancelled = true;
+        }
+
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_stats.queries++;
+            m_stats.partitions += partitions.size();
+            m_stats.cancelled += wasCancelled ? 1 : 0;
+            m_stats.failed += failed ? 1 : 0;
+            m_totalMs += elapsed;
+            m_stats.average_query_ms = m_totalMs / m_stats.queries;
+        }
+        return !wasCancelled && !failed;
+    }
+
+    size_t GetParallelism() const {
+        return m_parallelism;
+    }
+
+    RangeQueryStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_stats;
+    }
+
+private:
+    RangeQueryConfig m_config;
+    size_t m_parallelism;
+    std::unique_ptr<WorkAssistant::ThreadPool> m_pool;
+
+    mutable std::mutex m_statsMutex;
+    RangeQueryStatistics m_stats;
+    double m_totalMs = 0.0;
+};
+
+RangeQueryExecutor::RangeQueryExecutor(const RangeQueryConfig& config)
+    : m_impl(std::make_unique<Impl>(config)) {}
+
+RangeQueryExecutor::~RangeQueryExecutor() = default;
+
+std::vector<RangePartition> RangeQueryExecutor::Partition(const std::chrono::system_clock::time_point& start,
+                                                          const std::chrono::system_clock::time_point& end) const {
+    return m_impl->Partition(start, end);
+}
+
+bool RangeQueryExecutor::Execute(const std::vector<RangePartition>& partitions, const PartitionTask& task,
+                                 const CancellationCheck& cancelled, bool parallel) {
+    return m_impl->Execute(partitions, task, cancelled, parallel);
+}
+
+size_t RangeQueryExecutor::GetParallelism() const {
+    return m_impl->GetParallelism();
+}
+
+RangeQueryStatistics RangeQueryExecutor::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
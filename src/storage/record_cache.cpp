@@ -0,0 +1,200 @@
+#include "record_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace work_assistant {
+
+class RecordCache::Impl {
+public:
+    Impl(size_t capacity_bytes, size_t shard_count)
+        : m_capacity(capacity_bytes)
+        , m_shards(std::max<size_t>(shard_count, 1)) {
+        for (Shard& shard : m_shards) {
+            shard.capacity = m_capacity / m_shards.size();
+        }
+    }
+
+    bool Get(uint64_t id, DataRecord& record) {
+        Shard& shard = ShardOf(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(id);
+        if (it == shard.index.end()) {
+            m_misses++;
+            return false;
+        }
+        // Move to the front: most recently used
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        record = it->second->record;
+        m_hits++;
+        return true;
+    }
+
+    uint64_t GetEpoch() const {
+        return m_epoch.load();
+    }
+
+    // Invalidations bump the epoch before touching the shards, so a Put
+    // either sees the new epoch or lands before the entry is removed
+    void Put(const DataRecord& record, const uint64_t* epoch) {
+        size_t size = EstimateSize(record);
+        Shard& shard = ShardOf(record.id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (epoch && *epoch != m_epoch.load()) {
+            return;
+        }
+        EraseLocked(shard, record.id);
+        if (record.id == 0 || size > shard.capacity) {
+            return;
+        }
+
+        shard.lru.push_front(Entry{record, size});
+        shard.index[record.id] = shard.lru.begin();
+        shard.bytes += size;
+        while (shard.bytes > shard.capacity) {
+            const Entry& oldest = shard.lru.back();
+            shard.bytes -= oldest.size;
+            shard.index.erase(oldest.record.id);
+            shard.lru.pop_back();
+        }
+    }
+
+    void Erase(uint64_t id) {
+        m_epoch++;
+        Shard& shard = ShardOf(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        EraseLocked(shard, id);
+    }
+
+    void EraseIf(const std::function<bool(const DataRecord&)>& predicate) {
+        m_epoch++;
+        for (Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+                if (predicate(it->record)) {
+                    shard.bytes -= it->size;
+                    shard.index.erase(it->record.id);
+                    it = shard.lru.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    void Clear() {
+        m_epoch++;
+        for (Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.lru.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+        }
+    }
+
+    RecordCacheStats GetStats() {
+        RecordCacheStats stats;
+        stats.hits = m_hits;
+        stats.misses = m_misses;
+        for (Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.entries += shard.index.size();
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+
+    size_t GetCapacity() const {
+        return m_capacity;
+    }
+
+private:
+    struct Entry {
+        DataRecord record;
+        size_t size;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;           // Front is most recently used
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        size_t capacity = 0;
+    };
+
+    Shard& ShardOf(uint64_t id) {
+        // Ids are sequential; a multiplicative hash spreads neighbours
+        return m_shards[(id * 0x9e3779b97f4a7c15ULL >> 32) % m_shards.size()];
+    }
+
+    void EraseLocked(Shard& shard, uint64_t id) {
+        auto it = shard.index.find(id);
+        if (it != shard.index.end()) {
+            shard.bytes -= it->second->size;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+    }
+
+    const size_t m_capacity;
+    std::vector<Shard> m_shards;
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+    std::atomic<uint64_t> m_epoch{0};
+};
+
+RecordCache::RecordCache(size_t capacity_bytes, size_t shard_count)
+    : m_impl(std::make_unique<Impl>(capacity_bytes, shard_count)) {}
+
+RecordCache::~RecordCache() = default;
+
+bool RecordCache::Get(uint64_t id, DataRecord& record) {
+    return m_impl->Get(id, record);
+}
+
+void RecordCache::Put(const DataRecord& record) {
+    m_impl->Put(record, nullptr);
+}
+
+uint64_t RecordCache::GetEpoch() const {
+    return m_impl->GetEpoch();
+}
+
+void RecordCache::Put(const DataRecord& record, uint64_t epoch) {
+    m_impl->Put(record, &epoch);
+}
+
+void RecordCache::Erase(uint64_t id) {
+    m_impl->Erase(id);
+}
+
+void RecordCache::EraseIf(const std::function<bool(const DataRecord&)>& predicate) {
+    m_impl->EraseIf(predicate);
+}
+
+void RecordCache::Clear() {
+    m_impl->Clear();
+}
+
+RecordCacheStats RecordCache::GetStats() const {
+    return m_impl->GetStats();
+}
+
+size_t RecordCache::GetCapacity() const {
+    return m_impl->GetCapacity();
+}
+
+size_t RecordCache::EstimateSize(const DataRecord& record) {
+    // Node and map overhead are rounded into a fixed per-entry cost
+    size_t size = sizeof(DataRecord) + 64 + record.data.capacity() +
+                  record.session_id.capacity() + record.checksum.capacity();
+    for (const auto& [key, value] : record.metadata) {
+        size += 32 + key.capacity() + value.capacity();
+    }
+    return size;
+}
+
+} // namespace work_assistant
@@ -1,5 +1,8 @@
 #include "storage_engine.h"
+#include "partition_synopsis.h"
+#include "record_cache.h"
 #include "common_types.h"
+#include "screen_capture.h"
 #include "ocr_engine.h"
 #include "ai_engine.h"
 #include <iostream>
@@ -8,6 +11,9 @@
 #include <random>
 #include <iomanip>
 #include <filesystem>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 #include <sqlite3.h>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
@@ -75,6 +81,7 @@ public:
         }
 
         m_config = config;
+        m_recordCache = std::make_unique<RecordCache>(m_config.record_cache_size_mb * 1024 * 1024);
 
         // Ensure storage directory exists
         if (!storage_utils::EnsureDirectoryExists(m_config.storage_path)) {
@@ -130,6 +137,13 @@ public:
             return false;
         }
 
+        LoadSynopses();
+
+        {
+            std::lock_guard<std::mutex> lock(m_readerMutex);
+            m_readersOpen = true;
+        }
+
         std::cout << "Database created successfully: " << db_path << std::endl;
         return true;
     }
@@ -166,15 +180,46 @@ public:
         ExecuteSQL("PRAGMA journal_mode = WAL");
         ExecuteSQL("PRAGMA synchronous = NORMAL");
 
+        // sqlite3_open creates missing files, and databases from older
+        // versions lack newer tables; the schema is idempotent
+        if (!CreateTables()) {
+            std::cerr << "Failed to create database tables" << std::endl;
+            sqlite3_close(m_db);
+            m_db = nullptr;
+            return false;
+        }
+
+        LoadSynopses();
+
+        {
+            std::lock_guard<std::mutex> lock(m_readerMutex);
+            m_readersOpen = true;
+        }
+
         std::cout << "Database opened successfully" << std::endl;
         return true;
     }
 
     bool CloseDatabase() override {
+        {
+            // Readers still scanning close themselves on release
+            std::lock_guard<std::mutex> lock(m_readerMutex);
+            m_readersOpen = false;
+            for (sqlite3* reader : m_idleReaders) {
+                sqlite3_close(reader);
+            }
+            m_idleReaders.clear();
+        }
         if (m_db) {
+            FlushSynopses();
             sqlite3_close(m_db);
             m_db = nullptr;
         }
+        m_synopsesReady = false;
+        m_synopses.Clear();
+        if (m_recordCache) {
+            m_recordCache->Clear();
+        }
         return true;
     }
 
@@ -217,7 +262,8 @@ public:
     }
 
     uint64_t StoreRecord(const DataRecord& record) override {
-        if (!m_db || !record.IsValid()) {
+        // New records have no id yet, so IsValid() does not apply here
+        if (!m_db || record.data.empty() || record.type == static_cast<RecordType>(0)) {
             return 0;
         }
 
@@ -264,6 +310,26 @@ public:
 
         sqlite3_finalize(stmt);
 
+        if (record_id != 0) {
+            // Cached as GetRecord would decode it; captures are read
+            // through their thumbnails, and would only evict hot records
+            if (record.type != RecordType::SCREEN_CAPTURE) {
+                DataRecord decoded = record;
+                decoded.id = record_id;
+                decoded.timestamp = std::chrono::system_clock::from_time_t(
+                    std::chrono::system_clock::to_time_t(record.timestamp));
+                decoded.metadata = {{"raw", metadata_json}};
+                m_recordCache->Put(decoded);
+            }
+
+            AddToSynopsis(record.type, record.timestamp, record.data, record.metadata);
+            // Rows past the watermark are re-read on open, so flushing in
+            // batches loses nothing; inside a transaction it waits for COMMIT
+            if (++m_unflushedSynopses >= SYNOPSIS_FLUSH_INTERVAL && sqlite3_get_autocommit(m_db)) {
+                FlushSynopses();
+            }
+        }
+
         // Update statistics
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -281,22 +347,98 @@ public:
         ExecuteSQL("BEGIN TRANSACTION");
 
         bool success = true;
+        std::vector<uint64_t> stored_ids;
         for (const auto& record : records) {
-            if (StoreRecord(record) == 0) {
+            uint64_t id = StoreRecord(record);
+            if (id == 0) {
                 success = false;
                 break;
             }
+            stored_ids.push_back(id);
         }
 
         if (success) {
             ExecuteSQL("COMMIT");
+            if (m_unflushedSynopses >= SYNOPSIS_FLUSH_INTERVAL) {
+                FlushSynopses();
+            }
         } else {
             ExecuteSQL("ROLLBACK");
+            for (uint64_t id : stored_ids) {
+                m_recordCache->Erase(id);
+            }
         }
 
         return success;
     }
 
+    bool GetStateValue(const std::string& key, std::string& value) override {
+        if (!m_db) {
+            return false;
+        }
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, "SELECT value FROM metadata WHERE key = ?", -1, &stmt, nullptr) != SQLITE_OK) {
+            return false;
+        }
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_STATIC);
+
+        bool found = false;
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            value = text ? text : "";
+            found = true;
+        }
+        sqlite3_finalize(stmt);
+        return found;
+    }
+
+    bool StoreRecordsWithState(const std::vector<DataRecord>& records,
+                               const std::string& key, const std::string& value) override {
+        if (!m_db) {
+            return false;
+        }
+
+        ExecuteSQL("BEGIN TRANSACTION");
+
+        bool success = true;
+        std::vector<uint64_t> stored_ids;
+        for (const auto& record : records) {
+            uint64_t id = StoreRecord(record);
+            if (id == 0) {
+                success = false;
+                break;
+            }
+            stored_ids.push_back(id);
+        }
+
+        sqlite3_stmt* stmt;
+        if (success && sqlite3_prepare_v2(m_db,
+                "INSERT OR REPLACE INTO metadata (key, value, updated_at) VALUES (?, ?, CURRENT_TIMESTAMP)",
+                -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_STATIC);
+            success = sqlite3_step(stmt) == SQLITE_DONE;
+            sqlite3_finalize(stmt);
+        } else {
+            success = false;
+        }
+
+        if (success && ExecuteSQL("COMMIT")) {
+            if (m_unflushedSynopses >= SYNOPSIS_FLUSH_INTERVAL) {
+                FlushSynopses();
+            }
+            return true;
+        }
+
+        std::cerr << "Failed to store records with state " << key << ": " << sqlite3_errmsg(m_db) << std::endl;
+        ExecuteSQL("ROLLBACK");
+        for (uint64_t id : stored_ids) {
+            m_recordCache->Erase(id);
+        }
+        return false;
+    }
+
     bool GetRecord(uint64_t id, DataRecord& record) override {
         if (!m_db) {
             return false;
@@ -304,6 +446,14 @@ public:
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
+        const uint64_t epoch = m_recordCache->GetEpoch();
+        if (m_recordCache->Get(id, record)) {
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - start_time);
+            UpdateReadStatistics(duration.count());
+            return true;
+        }
+
         const char* sql = R"(
             SELECT id, type, timestamp, session_id, metadata, data, checksum
             FROM data_records WHERE id = ?
@@ -319,6 +469,9 @@ public:
         bool found = false;
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             found = ParseRecordFromStatement(stmt, record);
+            if (found) {
+                m_recordCache->Put(record, epoch);
+            }
         }
 
         sqlite3_finalize(stmt);
@@ -338,6 +491,7 @@ public:
         }
 
         std::string sql = BuildQuerySQL(params);
+        const uint64_t epoch = m_recordCache->GetEpoch();
         
         sqlite3_stmt* stmt;
         if (sqlite3_prepare_v2(m_db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
@@ -350,7 +504,7 @@ public:
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             DataRecord record;
-            if (ParseRecordFromStatement(stmt, record)) {
+            if (ReadRecord(stmt, record, true, epoch)) {
                 results.push_back(record);
             }
         }
@@ -359,6 +513,136 @@ public:
         return results;
     }
 
+    // Runs on a pooled read-only connection so concurrent scans neither
+    // serialise on m_db nor block writers (WAL readers see a snapshot).
+    // Only the day partitions whose synopsis admits the query are read, each
+    // clipped to its zone-map bounds.
+    bool ScanRecords(const QueryParams& params,
+                     const std::function<bool(const DataRecord&)>& visitor,
+                     PruningStats* pruning = nullptr) override {
+        if (!m_db) {
+            return false;
+        }
+
+        QueryParams all = params;
+        all.limit = static_cast<size_t>(INT64_MAX);
+        all.offset = 0;
+
+        std::vector<QueryParams> slices;
+        const bool use_synopses = m_synopsesReady;
+        if (use_synopses) {
+            PruningStats stats;
+            for (const auto& candidate : m_synopses.Candidates(params, stats)) {
+                QueryParams slice = all;
+                slice.start_time = std::chrono::system_clock::time_point(std::chrono::seconds(candidate.start));
+                slice.end_time = std::chrono::system_clock::time_point(std::chrono::seconds(candidate.end));
+                slices.push_back(slice);
+            }
+            if (params.order_descending) {
+                std::reverse(slices.begin(), slices.end());
+            }
+
+            // Scanned partitions are counted as they are read, since the
+            // visitor may stop early
+            m_partitionsPruned += stats.partitions_pruned;
+            if (pruning) {
+                pruning->partitions_pruned += stats.partitions_pruned;
+            }
+        } else {
+            slices.push_back(all);
+        }
+        if (slices.empty()) {
+            return true;
+        }
+
+        sqlite3* reader = AcquireReader();
+        if (!reader) {
+            return false;
+        }
+
+        int result = SQLITE_DONE;
+        bool stopped = false;
+        for (size_t i = 0; i < slices.size() && !stopped && result == SQLITE_DONE; ++i) {
+            std::string sql = BuildQuerySQL(slices[i]);
+
+            sqlite3_stmt* stmt;
+            if (sqlite3_prepare_v2(reader, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                std::cerr << "Failed to prepare scan: " << sqlite3_errmsg(reader) << std::endl;
+                ReleaseReader(reader);
+                return false;
+            }
+
+            if (use_synopses) {
+                m_partitionsScanned++;
+                if (pruning) {
+                    pruning->partitions_scanned++;
+                }
+            }
+
+            while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+                DataRecord record;
+                if (ReadRecord(stmt, record, false) && !visitor(record)) {
+                    result = SQLITE_DONE;
+                    stopped = true;
+                    break;
+                }
+            }
+            if (result != SQLITE_DONE) {
+                std::cerr << "Scan failed: " << sqlite3_errmsg(reader) << std::endl;
+            }
+
+            sqlite3_finalize(stmt);
+        }
+
+        ReleaseReader(reader);
+        return result == SQLITE_DONE;
+    }
+
+    bool SupportsConcurrentReads() const override {
+        return true;
+    }
+
+    bool UpdateRecord(const DataRecord& record) override {
+        if (!m_db || record.id == 0) {
+            return false;
+        }
+
+        const char* sql = "UPDATE data_records SET metadata = ?, data = ?, checksum = ? WHERE id = ?";
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare update: " << sqlite3_errmsg(m_db) << std::endl;
+            return false;
+        }
+
+        std::string metadata_json = SerializeMetadata(record.metadata);
+        sqlite3_bind_text(stmt, 1, metadata_json.c_str(), -1, SQLITE_STATIC);
+
+        std::vector<uint8_t> data_to_store = record.data;
+        if (m_config.security_level >= SecurityLevel::BASIC) {
+            data_to_store = storage_utils::EncryptData(record.data, m_config.master_password);
+        }
+        sqlite3_bind_blob(stmt, 2, data_to_store.data(), data_to_store.size(), SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, record.checksum.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 4, record.id);
+
+        bool success = (sqlite3_step(stmt) == SQLITE_DONE) && sqlite3_changes(m_db) > 0;
+        sqlite3_finalize(stmt);
+        m_recordCache->Erase(record.id);
+
+        // Updated rows are not past the watermark, so their terms are
+        // persisted right away rather than with the next batch
+        RecordType type;
+        int64_t timestamp = 0;
+        if (success && LookupTypeAndTimestamp(record.id, type, timestamp)) {
+            AddToSynopsis(type, std::chrono::system_clock::time_point(std::chrono::seconds(timestamp)),
+                          record.data, record.metadata);
+            if (sqlite3_get_autocommit(m_db)) {
+                FlushSynopses();
+            }
+        }
+        return success;
+    }
+
     bool DeleteRecord(uint64_t id) override {
         if (!m_db) {
             return false;
@@ -375,6 +659,11 @@ public:
         bool success = (sqlite3_step(stmt) == SQLITE_DONE);
         sqlite3_finalize(stmt);
 
+        if (success) {
+            m_recordCache->Erase(id);
+            ExecuteSQL("DELETE FROM screen_thumbnails WHERE capture_id = " + std::to_string(id));
+        }
+
         return success;
     }
 
@@ -401,6 +690,7 @@ public:
         record.metadata["width"] = std::to_string(frame.width);
         record.metadata["height"] = std::to_string(frame.height);
         record.metadata["bytes_per_pixel"] = std::to_string(frame.bytes_per_pixel);
+        record.metadata["format"] = std::to_string(static_cast<int>(frame.format));
         
         // Compress image data
         if (m_config.enable_compression) {
@@ -411,7 +701,92 @@ public:
         }
         
         record.checksum = storage_utils::CalculateChecksum(record.data);
-        return StoreRecord(record);
+        uint64_t id = StoreRecord(record);
+        
+        // The timeline shows these instead of decompressing the full frame
+        std::vector<capture_utils::ThumbnailLevel> levels;
+        if (id > 0 && capture_utils::BuildThumbnailPyramid(frame, levels)) {
+            StoreThumbnails(id, record.timestamp, levels);
+        }
+        return id;
+    }
+
+    bool GetScreenCaptureThumbnail(uint64_t capture_id, int width,
+                                   ScreenThumbnail& thumbnail) override {
+        if (!m_db) {
+            return false;
+        }
+
+        // Narrowest level covering the requested width, else the widest
+        const char* sql = R"(
+            SELECT capture_id, timestamp, width, height, data FROM screen_thumbnails
+            WHERE capture_id = ?
+            ORDER BY (width >= ?) DESC,
+                     CASE WHEN width >= ? THEN width ELSE -width END ASC
+            LIMIT 1
+        )";
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            return false;
+        }
+
+        sqlite3_bind_int64(stmt, 1, capture_id);
+        sqlite3_bind_int(stmt, 2, width);
+        sqlite3_bind_int(stmt, 3, width);
+
+        bool found = false;
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            ParseThumbnailFromStatement(stmt, thumbnail);
+            const void* blob = sqlite3_column_blob(stmt, 4);
+            int size = sqlite3_column_bytes(stmt, 4);
+            if (blob && size > 0) {
+                const uint8_t* bytes = static_cast<const uint8_t*>(blob);
+                thumbnail.data.assign(bytes, bytes + size);
+                if (m_config.security_level >= SecurityLevel::BASIC) {
+                    thumbnail.data = storage_utils::DecryptData(thumbnail.data, m_config.master_password);
+                }
+                found = true;
+            }
+        }
+
+        sqlite3_finalize(stmt);
+        return found;
+    }
+
+    std::vector<ScreenThumbnail> ListScreenCaptureThumbnails(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end) override {
+        
+        std::vector<ScreenThumbnail> thumbnails;
+        if (!m_db) {
+            return thumbnails;
+        }
+
+        const char* sql = R"(
+            SELECT capture_id, timestamp, width, height FROM screen_thumbnails
+            WHERE timestamp >= ? AND timestamp <= ?
+            ORDER BY timestamp, capture_id, width
+        )";
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            return thumbnails;
+        }
+
+        sqlite3_bind_int64(stmt, 1, std::chrono::duration_cast<std::chrono::seconds>(
+            start.time_since_epoch()).count());
+        sqlite3_bind_int64(stmt, 2, std::chrono::duration_cast<std::chrono::seconds>(
+            end.time_since_epoch()).count());
+
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            ScreenThumbnail thumbnail;
+            ParseThumbnailFromStatement(stmt, thumbnail);
+            thumbnails.push_back(std::move(thumbnail));
+        }
+
+        sqlite3_finalize(stmt);
+        return thumbnails;
     }
 
     std::vector<std::string> SearchText(const std::string& query, const QueryParams& params) override {
@@ -463,7 +838,8 @@ public:
     }
 
     bool CompactDatabase() override {
-        return ExecuteSQL("VACUUM");
+        // VACUUM goes through the WAL; truncate it so the space is returned
+        return ExecuteSQL("VACUUM") && ExecuteSQL("PRAGMA wal_checkpoint(TRUNCATE)");
     }
 
     bool CleanupOldData() override {
@@ -471,8 +847,25 @@ public:
         int64_t cutoff_timestamp = std::chrono::duration_cast<std::chrono::seconds>(
             cutoff_time.time_since_epoch()).count();
 
-        std::string sql = "DELETE FROM data_records WHERE timestamp < " + std::to_string(cutoff_timestamp);
-        return ExecuteSQL(sql);
+        // Pending jobs are removed by the queue when they finish, never by age
+        std::string sql = "DELETE FROM data_records WHERE timestamp < " + std::to_string(cutoff_timestamp) +
+                          " AND type != " + std::to_string(static_cast<int>(RecordType::DEFERRED_JOB));
+        if (!ExecuteSQL(sql) ||
+            !ExecuteSQL("DELETE FROM screen_thumbnails WHERE capture_id NOT IN (SELECT id FROM data_records)")) {
+            return false;
+        }
+
+        auto cutoff_second = std::chrono::system_clock::time_point(std::chrono::seconds(cutoff_timestamp));
+        m_recordCache->EraseIf([&cutoff_second](const DataRecord& record) {
+            return record.timestamp < cutoff_second && record.type != RecordType::DEFERRED_JOB;
+        });
+
+        std::vector<int64_t> dropped;
+        m_synopses.DropBefore(cutoff_timestamp, 1ULL << static_cast<int>(RecordType::DEFERRED_JOB), dropped);
+        for (int64_t partition : dropped) {
+            ExecuteSQL("DELETE FROM partition_synopses WHERE partition = " + std::to_string(partition));
+        }
+        return true;
     }
 
     bool ReindexDatabase() override {
@@ -485,6 +878,15 @@ public:
 
     StorageStatistics GetStatistics() override {
         UpdateStatistics();
+        m_statistics.partitions_scanned = m_partitionsScanned;
+        m_statistics.partitions_pruned = m_partitionsPruned;
+
+        RecordCacheStats cache = m_recordCache ? m_recordCache->GetStats() : RecordCacheStats();
+        m_statistics.record_cache_hits = cache.hits;
+        m_statistics.record_cache_misses = cache.misses;
+        m_statistics.record_cache_bytes = cache.bytes;
+        m_statistics.record_cache_hit_rate = (cache.hits + cache.misses) > 0
+            ? static_cast<double>(cache.hits) / (cache.hits + cache.misses) : 0.0;
         return m_statistics;
     }
 
@@ -520,11 +922,27 @@ private:
             CREATE INDEX IF NOT EXISTS idx_records_session ON data_records(session_id);
             CREATE INDEX IF NOT EXISTS idx_records_timestamp ON data_records(timestamp);
 
+            CREATE TABLE IF NOT EXISTS screen_thumbnails (
+                capture_id INTEGER NOT NULL,
+                width INTEGER NOT NULL,
+                height INTEGER NOT NULL,
+                timestamp INTEGER NOT NULL,
+                data BLOB,
+                PRIMARY KEY (capture_id, width)
+            );
+
+            CREATE INDEX IF NOT EXISTS idx_thumbnails_timestamp ON screen_thumbnails(timestamp);
+
             CREATE TABLE IF NOT EXISTS metadata (
                 key TEXT PRIMARY KEY,
                 value TEXT,
                 updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
             );
+
+            CREATE TABLE IF NOT EXISTS partition_synopses (
+                partition INTEGER PRIMARY KEY,
+                data BLOB
+            );
         )";
 
         return ExecuteSQL(create_tables_sql);
@@ -542,6 +960,37 @@ private:
         return true;
     }
 
+    sqlite3* AcquireReader() {
+        {
+            std::lock_guard<std::mutex> lock(m_readerMutex);
+            if (!m_idleReaders.empty()) {
+                sqlite3* reader = m_idleReaders.back();
+                m_idleReaders.pop_back();
+                return reader;
+            }
+        }
+
+        std::string db_path = m_config.storage_path + "/" + m_config.database_name;
+        sqlite3* reader = nullptr;
+        if (sqlite3_open_v2(db_path.c_str(), &reader, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                            nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to open reader connection: " << sqlite3_errmsg(reader) << std::endl;
+            sqlite3_close(reader);
+            return nullptr;
+        }
+        sqlite3_busy_timeout(reader, 5000);
+        return reader;
+    }
+
+    void ReleaseReader(sqlite3* reader) {
+        std::lock_guard<std::mutex> lock(m_readerMutex);
+        if (m_readersOpen) {
+            m_idleReaders.push_back(reader);
+        } else {
+            sqlite3_close(reader);
+        }
+    }
+
     bool VerifyPassword(const std::string& password) {
         // Simple password verification - in production use proper key derivation
         return password == m_config.master_password;
@@ -560,6 +1009,164 @@ private:
         return oss.str();
     }
 
+    // Inverse of SerializeMetadata; values end at a quote followed by a
+    // comma-quote or the closing brace, as SerializeMetadata does not escape
+    std::unordered_map<std::string, std::string> ParseMetadata(const std::string& json) {
+        std::unordered_map<std::string, std::string> metadata;
+        size_t pos = 1;
+        while (pos < json.size() && json[pos] == '"') {
+            size_t key_end = json.find("\":\"", pos + 1);
+            if (key_end == std::string::npos) {
+                break;
+            }
+            size_t value_start = key_end + 3;
+            size_t value_end = value_start;
+            while ((value_end = json.find('"', value_end)) != std::string::npos &&
+                   json.compare(value_end, 3, "\",\"") != 0 && value_end + 2 != json.size()) {
+                value_end++;
+            }
+            if (value_end == std::string::npos) {
+                break;
+            }
+            metadata[json.substr(pos + 1, key_end - pos - 1)] = json.substr(value_start, value_end - value_start);
+            pos = value_end + 2;
+        }
+        return metadata;
+    }
+
+    void AddToSynopsis(RecordType type, const std::chrono::system_clock::time_point& timestamp,
+                       const std::vector<uint8_t>& data,
+                       const std::unordered_map<std::string, std::string>& metadata) {
+        // Image bytes would only fill the filter with noise
+        std::string text;
+        if (type != RecordType::SCREEN_CAPTURE) {
+            text.assign(data.begin(), data.end());
+        }
+        m_synopses.Add(type, std::chrono::duration_cast<std::chrono::seconds>(
+            timestamp.time_since_epoch()).count(), text, metadata);
+    }
+
+    bool LookupTypeAndTimestamp(uint64_t id, RecordType& type, int64_t& timestamp) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, "SELECT type, timestamp FROM data_records WHERE id = ?",
+                               -1, &stmt, nullptr) != SQLITE_OK) {
+            return false;
+        }
+        sqlite3_bind_int64(stmt, 1, id);
+        bool found = sqlite3_step(stmt) == SQLITE_ROW;
+        if (found) {
+            type = static_cast<RecordType>(sqlite3_column_int(stmt, 0));
+            timestamp = sqlite3_column_int64(stmt, 1);
+        }
+        sqlite3_finalize(stmt);
+        return found;
+    }
+
+    // Reads the persisted synopses, then folds in the rows stored after the
+    // last flush (ids above the watermark). Unreadable synopses, e.g. from a
+    // different password, are rebuilt from every row.
+    void LoadSynopses() {
+        m_synopses.Clear();
+        m_unflushedSynopses = 0;
+
+        int64_t watermark = 0;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, "SELECT value FROM metadata WHERE key = 'synopsis_watermark'",
+                               -1, &stmt, nullptr) == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                watermark = sqlite3_column_int64(stmt, 0);
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        bool intact = true;
+        if (watermark > 0 &&
+            sqlite3_prepare_v2(m_db, "SELECT partition, data FROM partition_synopses",
+                               -1, &stmt, nullptr) == SQLITE_OK) {
+            while (intact && sqlite3_step(stmt) == SQLITE_ROW) {
+                const uint8_t* blob = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 1));
+                std::vector<uint8_t> data(blob, blob + sqlite3_column_bytes(stmt, 1));
+                if (m_config.security_level >= SecurityLevel::BASIC) {
+                    data = storage_utils::DecryptData(data, m_config.master_password);
+                }
+                intact = m_synopses.Load(sqlite3_column_int64(stmt, 0), data);
+            }
+            sqlite3_finalize(stmt);
+        }
+        if (!intact) {
+            std::cerr << "Partition synopses unreadable, rebuilding" << std::endl;
+            m_synopses.Clear();
+            watermark = 0;
+        }
+
+        size_t rebuilt = 0;
+        if (sqlite3_prepare_v2(m_db, "SELECT type, timestamp, metadata, data FROM data_records WHERE id > ?",
+                               -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_int64(stmt, 1, watermark);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                const char* metadata = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+                const uint8_t* blob = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 3));
+                std::vector<uint8_t> data(blob, blob + sqlite3_column_bytes(stmt, 3));
+                RecordType type = static_cast<RecordType>(sqlite3_column_int(stmt, 0));
+                if (m_config.security_level >= SecurityLevel::BASIC && type != RecordType::SCREEN_CAPTURE) {
+                    data = storage_utils::DecryptData(data, m_config.master_password);
+                }
+                AddToSynopsis(type, std::chrono::system_clock::time_point(
+                                  std::chrono::seconds(sqlite3_column_int64(stmt, 1))),
+                              data, ParseMetadata(metadata ? metadata : "{}"));
+                rebuilt++;
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        if (!intact) {
+            ExecuteSQL("DELETE FROM partition_synopses");
+            m_synopses.MarkAllDirty();
+        }
+        if (rebuilt > 0 || !intact) {
+            FlushSynopses();
+        }
+        m_synopsesReady = true;
+    }
+
+    // Writes changed synopses and advances the watermark in one transaction
+    bool FlushSynopses() {
+        m_unflushedSynopses = 0;
+        auto dirty = m_synopses.TakeDirty();
+
+        sqlite3_stmt* stmt;
+        if (!ExecuteSQL("BEGIN") ||
+            sqlite3_prepare_v2(m_db, "INSERT OR REPLACE INTO partition_synopses (partition, data) VALUES (?, ?)",
+                               -1, &stmt, nullptr) != SQLITE_OK) {
+            ExecuteSQL("ROLLBACK");
+            m_synopses.MarkAllDirty();
+            return false;
+        }
+
+        bool success = true;
+        for (auto& [partition, blob] : dirty) {
+            if (m_config.security_level >= SecurityLevel::BASIC) {
+                blob = storage_utils::EncryptData(blob, m_config.master_password);
+            }
+            sqlite3_bind_int64(stmt, 1, partition);
+            sqlite3_bind_blob(stmt, 2, blob.data(), blob.size(), SQLITE_STATIC);
+            success = sqlite3_step(stmt) == SQLITE_DONE && success;
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+
+        success = success && ExecuteSQL(
+            "INSERT OR REPLACE INTO metadata (key, value) "
+            "SELECT 'synopsis_watermark', COALESCE(MAX(id), 0) FROM data_records");
+        if (!success || !ExecuteSQL("COMMIT")) {
+            std::cerr << "Failed to persist partition synopses" << std::endl;
+            ExecuteSQL("ROLLBACK");
+            m_synopses.MarkAllDirty();
+            return false;
+        }
+        return true;
+    }
+
     std::string BuildQuerySQL(const QueryParams& params) {
         std::ostringstream sql;
         sql << "SELECT id, type, timestamp, session_id, metadata, data, checksum FROM data_records WHERE 1=1";
@@ -570,6 +1177,10 @@ private:
         sql << " AND timestamp <= " << std::chrono::duration_cast<std::chrono::seconds>(
             params.end_time.time_since_epoch()).count();
         
+        if (params.after_id > 0) {
+            sql << " AND id > " << params.after_id;
+        }
+        
         // Add type filter
         if (!params.record_types.empty()) {
             sql << " AND type IN (";
@@ -581,7 +1192,12 @@ private:
         }
         
         // Add ordering and limit
-        sql << " ORDER BY timestamp " << (params.order_descending ? "DESC" : "ASC");
+        const char* direction = params.order_descending ? "DESC" : "ASC";
+        if (params.order_by_id) {
+            sql << " ORDER BY id " << direction;
+        } else {
+            sql << " ORDER BY timestamp " << direction << ", id " << direction;
+        }
         sql << " LIMIT " << params.limit;
         if (params.offset > 0) {
             sql << " OFFSET " << params.offset;
@@ -633,6 +1249,70 @@ private:
         return true;
     }
 
+    // Decodes the current row, from the cache when it holds the id. Range
+    // scans pass populate = false so one long scan cannot evict the records
+    // the dashboard keeps asking for. epoch is the cache's, taken before
+    // the query ran.
+    bool ReadRecord(sqlite3_stmt* stmt, DataRecord& record, bool populate, uint64_t epoch = 0) {
+        if (m_recordCache->Get(sqlite3_column_int64(stmt, 0), record)) {
+            return true;
+        }
+        if (!ParseRecordFromStatement(stmt, record)) {
+            return false;
+        }
+        if (populate) {
+            m_recordCache->Put(record, epoch);
+        }
+        return true;
+    }
+
+    bool StoreThumbnails(uint64_t capture_id, const std::chrono::system_clock::time_point& timestamp,
+                         const std::vector<capture_utils::ThumbnailLevel>& levels) {
+        const char* sql = R"(
+            INSERT OR REPLACE INTO screen_thumbnails (capture_id, width, height, timestamp, data)
+            VALUES (?, ?, ?, ?, ?)
+        )";
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare thumbnail insert: " << sqlite3_errmsg(m_db) << std::endl;
+            return false;
+        }
+
+        int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            timestamp.time_since_epoch()).count();
+
+        bool success = true;
+        for (const auto& level : levels) {
+            std::vector<uint8_t> data_to_store = level.png;
+            if (m_config.security_level >= SecurityLevel::BASIC) {
+                data_to_store = storage_utils::EncryptData(level.png, m_config.master_password);
+            }
+
+            sqlite3_bind_int64(stmt, 1, capture_id);
+            sqlite3_bind_int(stmt, 2, level.width);
+            sqlite3_bind_int(stmt, 3, level.height);
+            sqlite3_bind_int64(stmt, 4, seconds);
+            sqlite3_bind_blob(stmt, 5, data_to_store.data(), data_to_store.size(), SQLITE_TRANSIENT);
+
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Failed to store thumbnail: " << sqlite3_errmsg(m_db) << std::endl;
+                success = false;
+            }
+            sqlite3_reset(stmt);
+        }
+
+        sqlite3_finalize(stmt);
+        return success;
+    }
+
+    void ParseThumbnailFromStatement(sqlite3_stmt* stmt, ScreenThumbnail& thumbnail) {
+        thumbnail.capture_id = sqlite3_column_int64(stmt, 0);
+        thumbnail.timestamp = std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 1));
+        thumbnail.width = sqlite3_column_int(stmt, 2);
+        thumbnail.height = sqlite3_column_int(stmt, 3);
+    }
+
     void UpdateWriteStatistics(double write_time_ms) {
         m_statistics.total_writes++;
         double total_time = m_statistics.avg_write_time_ms * (m_statistics.total_writes - 1);
@@ -674,6 +1354,24 @@ private:
 private:
     sqlite3* m_db;
     bool m_initialized;
+
+    // Read-only connections for ScanRecords, reused across scans
+    std::mutex m_readerMutex;
+    std::vector<sqlite3*> m_idleReaders;
+    bool m_readersOpen = false;
+
+    // Day-partition synopses for scan pruning; rows with ids above the
+    // persisted watermark are folded in again on open
+    static constexpr size_t SYNOPSIS_FLUSH_INTERVAL = 256;
+    PartitionSynopsisIndex m_synopses;
+    std::atomic<bool> m_synopsesReady{false};
+    size_t m_unflushedSynopses = 0;
+    std::atomic<size_t> m_partitionsScanned{0};
+    std::atomic<size_t> m_partitionsPruned{0};
+
+    // Decoded records by id; created with the configured budget
+    std::unique_ptr<RecordCache> m_recordCache;
+
     StorageConfig m_config;
     StorageStatistics m_statistics;
 };
@@ -701,6 +1399,7 @@ DataRecord WindowActivityRecord::ToDataRecord() const {
     DataRecord record;
     record.type = RecordType::WINDOW_EVENT;
     record.timestamp = timestamp;
+    record.session_id = session_id;
     record.metadata["window_title"] = window_title;
     record.metadata["application_name"] = application_name;
     record.metadata["process_id"] = std::to_string(process_id);
@@ -724,7 +1423,34 @@ WindowActivityRecord WindowActivityRecord::FromDataRecord(const DataRecord& reco
     }
     
     std::string json = record.GetJsonData();
-    return storage_utils::DeserializeWindowFromJson(json);
+    WindowActivityRecord activity = storage_utils::DeserializeWindowFromJson(json);
+    activity.session_id = record.session_id;
+    return activity;
+}
+
+DataRecord DeferredJobRecord::ToDataRecord() const {
+    DataRecord record;
+    record.id = id;
+    record.type = RecordType::DEFERRED_JOB;
+    record.timestamp = enqueued_at;
+    record.metadata["kind"] = kind;
+    record.metadata["priority"] = std::to_string(priority);
+    
+    std::string json = storage_utils::SerializeToJson(*this);
+    record.SetJsonData(json);
+    record.checksum = storage_utils::CalculateChecksum(record.data);
+    
+    return record;
+}
+
+DeferredJobRecord DeferredJobRecord::FromDataRecord(const DataRecord& record) {
+    if (record.type != RecordType::DEFERRED_JOB) {
+        return DeferredJobRecord();
+    }
+    
+    DeferredJobRecord job = storage_utils::DeserializeDeferredJobFromJson(record.GetJsonData());
+    job.id = record.id;
+    return job;
 }
 
 DataRecord ContentAnalysisRecord::ToDataRecord() const {
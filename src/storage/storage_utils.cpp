@@ -8,11 +8,57 @@
 #include <random>
 #include <iomanip>
 #include <filesystem>
+#include <algorithm>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <openssl/sha.h>
 
 namespace work_assistant {
+
+void ProductivityTotals::Add(const ContentAnalysisRecord& analysis) {
+    activities++;
+    if (analysis.is_productive) productive++;
+    if (analysis.is_focused_work) focused++;
+    confidence += analysis.ai_confidence;
+    distraction += analysis.distraction_level;
+    type_counts[analysis.content_type]++;
+}
+
+void ProductivityTotals::Merge(const ProductivityTotals& other) {
+    activities += other.activities;
+    productive += other.productive;
+    focused += other.focused;
+    confidence += other.confidence;
+    distraction += other.distraction;
+    for (const auto& [type, count] : other.type_counts) {
+        type_counts[type] += count;
+    }
+}
+
+std::unordered_map<std::string, float> ProductivityTotals::ToReport() const {
+    std::unordered_map<std::string, float> report;
+    if (activities == 0) {
+        return report;
+    }
+
+    report["total_activities"] = static_cast<float>(activities);
+    report["productive_ratio"] = static_cast<float>(productive) / activities;
+    report["focused_ratio"] = static_cast<float>(focused) / activities;
+    report["avg_confidence"] = confidence / activities;
+    report["avg_distraction"] = static_cast<float>(distraction) / activities;
+
+    // Most common activity type
+    auto max_type = std::max_element(type_counts.begin(), type_counts.end(),
+                                   [](const auto& a, const auto& b) {
+                                       return a.second < b.second;
+                                   });
+    if (max_type != type_counts.end()) {
+        report["dominant_content_type"] = static_cast<float>(static_cast<int>(max_type->first));
+    }
+
+    return report;
+}
+
 namespace storage_utils {
 
 // Mock encryption functions (in production, use libsodium or similar)
@@ -259,6 +305,76 @@ WindowActivityRecord DeserializeWindowFromJson(const std::string& json) {
     return record;
 }
 
+std::string SerializeToJson(const DeferredJobRecord& record) {
+    // Payload and cursor are opaque handler strings, so escape them fully
+    auto escape = [](const std::string& value) {
+        std::string out;
+        out.reserve(value.size());
+        for (char c : value) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:   out += c; break;
+            }
+        }
+        return out;
+    };
+
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"enqueued_at\": \"" << FormatTimestamp(record.enqueued_at) << "\",\n";
+    json << "  \"kind\": \"" << escape(record.kind) << "\",\n";
+    json << "  \"payload\": \"" << escape(record.payload) << "\",\n";
+    json << "  \"cursor\": \"" << escape(record.cursor) << "\",\n";
+    json << "  \"priority\": " << record.priority << ",\n";
+    json << "  \"attempts\": " << record.attempts << "\n";
+    json << "}";
+    return json.str();
+}
+
+DeferredJobRecord DeserializeDeferredJobFromJson(const std::string& json) {
+    DeferredJobRecord record;
+
+    auto find_value = [&json](const std::string& key) -> std::string {
+        std::string search = "\"" + key + "\": ";
+        size_t pos = json.find(search);
+        if (pos == std::string::npos) return "";
+
+        pos += search.length();
+        if (json[pos] != '"') {
+            size_t end = json.find_first_of(",\n}", pos);
+            return end == std::string::npos ? "" : json.substr(pos, end - pos);
+        }
+
+        std::string value;
+        for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+            if (json[pos] == '\\' && pos + 1 < json.size()) {
+                char next = json[++pos];
+                value += next == 'n' ? '\n' : next == 'r' ? '\r' : next == 't' ? '\t' : next;
+            } else {
+                value += json[pos];
+            }
+        }
+        return value;
+    };
+
+    try {
+        record.enqueued_at = ParseTimestamp(find_value("enqueued_at"));
+        record.kind = find_value("kind");
+        record.payload = find_value("payload");
+        record.cursor = find_value("cursor");
+        record.priority = std::stoi(find_value("priority"));
+        record.attempts = std::stoi(find_value("attempts"));
+    } catch (const std::exception& e) {
+        std::cerr << "JSON parsing error: " << e.what() << std::endl;
+    }
+
+    return record;
+}
+
 // File operation utilities
 bool EnsureDirectoryExists(const std::string& path) {
     try {
@@ -350,6 +466,21 @@ bool SecureDeleteFile(const std::string& path) {
     }
 }
 
+std::vector<std::pair<std::string, std::chrono::minutes>> EstimateTimeByApplication(
+    const std::unordered_map<std::string, int>& event_counts) {
+    std::vector<std::pair<std::string, std::chrono::minutes>> time_spent;
+    for (const auto& [app, count] : event_counts) {
+        time_spent.emplace_back(app, std::chrono::minutes(count / 2));
+    }
+
+    // Sort by time spent (descending)
+    std::sort(time_spent.begin(), time_spent.end(),
+             [](const auto& a, const auto& b) {
+                 return a.second > b.second;
+             });
+    return time_spent;
+}
+
 // Time utilities
 std::string FormatTimestamp(const std::chrono::system_clock::time_point& time) {
     auto time_t = std::chrono::system_clock::to_time_t(time);
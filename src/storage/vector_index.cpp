@@ -0,0 +1,813 @@
+#include "vector_index.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <shared_mutex>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace work_assistant {
+
+namespace {
+
+// Node file: a page-sized header, then fixed-size node records in
+// insertion order. The header's count is written after a node is complete,
+// so a record beyond it (torn by a crash) is ignored and overwritten.
+const char FILE_MAGIC[4] = {'W', 'A', 'V', 'X'};
+const uint32_t FILE_VERSION = 1;
+const size_t HEADER_BYTES = 4096;
+const uint32_t FLAG_TIME_ORDERED = 1;     // Node timestamps never decrease
+
+// Levels above 0 hold ~1/m of the nodes each; four are plenty for the
+// tens of millions of vectors a node file can reasonably hold
+const int MAX_LEVEL = 4;
+const size_t INITIAL_NODES = 1024;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t dimension;
+    uint32_t m;
+    uint64_t model_tag;
+    uint64_t record_bytes;
+    uint64_t count;
+    uint64_t upper_count;
+    int32_t entry_point;
+    int32_t max_level;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t watermark;
+};
+
+struct NodeHeader {
+    uint64_t id;
+    int64_t timestamp_ms;
+    float scale;            // Dequantisation factor of the int8 vector
+    int32_t upper_slot;     // Record in the .upper file, -1 on level 0 only
+    uint32_t level;
+    uint32_t link_count;    // Level-0 links in use
+};
+
+uint64_t HashTag(const std::string& tag) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : tag) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+int32_t DotInt8(const int8_t* a, const int8_t* b, int n) {
+    int32_t sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+int64_t ToMillis(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+// Read-write shared mapping of a whole file, remapped when resized
+class MappedFile {
+public:
+    ~MappedFile() {
+        Close();
+    }
+
+    bool Open(const std::string& path) {
+        Close();
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+        if (m_fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(m_fd, &info) != 0) {
+            Close();
+            return false;
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        return Map();
+    }
+
+    bool Resize(size_t size) {
+        if (size == m_size) {
+            return true;
+        }
+        Unmap();
+        if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+            Map();
+            return false;
+        }
+        m_size = size;
+        return Map();
+    }
+
+    bool Sync(bool wait) {
+        return !m_data || msync(m_data, m_size, wait ? MS_SYNC : MS_ASYNC) == 0;
+    }
+
+    void Close() {
+        Unmap();
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        m_fd = -1;
+        m_size = 0;
+    }
+
+    uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    bool Map() {
+        if (m_size == 0) {
+            return true;
+        }
+        void* data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED) {
+            m_size = 0;
+            return false;
+        }
+        m_data = static_cast<uint8_t*>(data);
+        return true;
+    }
+
+    void Unmap() {
+        if (m_data) {
+            munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+    }
+
+    int m_fd = -1;
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace
+
+class VectorIndex::Impl {
+public:
+    Impl() : m_rng(std::random_device{}()), m_searches(0), m_exactScans(0) {}
+
+    ~Impl() {
+        Close();
+    }
+
+    bool Open(const std::string& path, int dimension, const std::string& modelTag,
+              const VectorIndexConfig& config) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        CloseLocked();
+
+        if (dimension <= 0 || !config.IsValid()) {
+            std::cerr << "Invalid vector index configuration" << std::endl;
+            return false;
+        }
+
+        m_config = config;
+        m_dimension = dimension;
+        m_vectorBytes = (static_cast<size_t>(dimension) + 7) & ~size_t(7);
+        m_recordBytes = sizeof(NodeHeader) + m_vectorBytes + 2 * config.m * sizeof(uint32_t);
+        m_upperBytes = MAX_LEVEL * (config.m + 1) * sizeof(uint32_t);
+        m_levelFactor = 1.0 / std::log(static_cast<double>(config.m));
+
+        if (!m_nodes.Open(path) || !m_upper.Open(path + ".upper")) {
+            std::cerr << "Failed to open vector index: " << path << std::endl;
+            m_nodes.Close();
+            m_upper.Close();
+            return false;
+        }
+
+        const uint64_t tag = HashTag(modelTag);
+        if (!Validate(tag)) {
+            if (m_nodes.Size() > 0) {
+                std::cout << "Vector index does not match the embedding model, starting a new one" << std::endl;
+            }
+            if (!Reset(tag)) {
+                std::cerr << "Failed to initialize vector index: " << path << std::endl;
+                m_nodes.Close();
+                m_upper.Close();
+                return false;
+            }
+        }
+
+        m_open = true;
+        if (!(Header().flags & FLAG_TIME_ORDERED)) {
+            BuildTimeOrder();
+        }
+        std::cout << "Vector index loaded: " << Header().count << " vectors" << std::endl;
+        return true;
+    }
+
+    void Close() {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        CloseLocked();
+    }
+
+    bool IsOpen() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_open;
+    }
+
+    bool Add(uint64_t id, std::chrono::system_clock::time_point timestamp, const std::vector<float>& vector) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        if (!m_open || static_cast<int>(vector.size()) != m_dimension) {
+            return false;
+        }
+
+        Quantized query;
+        if (!Quantize(vector, query)) {
+            return false;
+        }
+
+        const uint32_t node = static_cast<uint32_t>(Header().count);
+        if (!EnsureNodeCapacity(node + size_t(1))) {
+            std::cerr << "Failed to grow vector index" << std::endl;
+            return false;
+        }
+        int level = RandomLevel();
+        if (level > 0 && !EnsureUpperCapacity(Header().upper_count + 1)) {
+            level = 0;
+        }
+
+        NodeHeader& header = Node(node);
+        header.id = id;
+        header.timestamp_ms = ToMillis(timestamp);
+        header.scale = query.scale;
+        header.level = static_cast<uint32_t>(level);
+        header.link_count = 0;
+        header.upper_slot = -1;
+        if (level > 0) {
+            header.upper_slot = static_cast<int32_t>(Header().upper_count++);
+            std::memset(m_upper.Data() + header.upper_slot * m_upperBytes, 0, m_upperBytes);
+        }
+        std::memcpy(Vector(node), query.values.data(), m_vectorBytes);
+
+        if (node == 0) {
+            Header().entry_point = 0;
+            Header().max_level = level;
+        } else {
+            Link(node, query, level);
+        }
+
+        UpdateTimeOrder(node);
+        Header().count = node + 1;
+        return true;
+    }
+
+    std::vector<VectorMatch> Search(const std::vector<float>& vector, size_t k,
+                                    std::chrono::system_clock::time_point start,
+                                    std::chrono::system_clock::time_point end) const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        std::vector<VectorMatch> matches;
+        if (!m_open || k == 0 || Header().count == 0 || static_cast<int>(vector.size()) != m_dimension) {
+            return matches;
+        }
+
+        Quantized query;
+        if (!Quantize(vector, query)) {
+            return matches;
+        }
+        m_searches++;
+
+        const int64_t from = ToMillis(start);
+        const int64_t to = ToMillis(end);
+        size_t first = 0, last = 0;
+        TimeRange(from, to, first, last);
+        if (first >= last) {
+            return matches;
+        }
+
+        std::vector<Candidate> found;
+        if (last - first <= m_config.exact_scan_limit) {
+            m_exactScans++;
+            found = ExactScan(query, k, first, last);
+        } else {
+            uint32_t entry = static_cast<uint32_t>(Header().entry_point);
+            for (int level = Header().max_level; level > 0; --level) {
+                entry = SearchLayer(query, entry, 1, level, nullptr).front().second;
+            }
+            TimeFilter filter{from, to};
+            found = SearchLayer(query, entry, std::max(static_cast<size_t>(m_config.ef_search), k), 0, &filter);
+        }
+
+        for (size_t i = 0; i < found.size() && matches.size() < k; ++i) {
+            const NodeHeader& header = Node(found[i].second);
+            VectorMatch match;
+            match.id = header.id;
+            match.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(header.timestamp_ms));
+            match.similarity = 1.0f - found[i].first;
+            matches.push_back(match);
+        }
+        return matches;
+    }
+
+    bool Flush() {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return !m_open || (m_nodes.Sync(false) && m_upper.Sync(false));
+    }
+
+    void SetWatermark(uint64_t value) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        if (m_open) {
+            Header().watermark = value;
+        }
+    }
+
+    uint64_t GetWatermark() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_open ? Header().watermark : 0;
+    }
+
+    size_t Size() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_open ? Header().count : 0;
+    }
+
+    int Dimension() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_open ? m_dimension : 0;
+    }
+
+    VectorIndexStatistics GetStatistics() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        VectorIndexStatistics stats;
+        if (m_open) {
+            stats.vectors = Header().count;
+            stats.dimension = m_dimension;
+            stats.max_level = Header().max_level;
+            stats.file_bytes = m_nodes.Size() + m_upper.Size();
+        }
+        stats.searches = m_searches;
+        stats.exact_scans = m_exactScans;
+        return stats;
+    }
+
+private:
+    using Candidate = std::pair<float, uint32_t>;     // Distance, node
+
+    struct Quantized {
+        std::vector<int8_t> values;
+        float scale = 0.0f;
+    };
+
+    struct TimeFilter {
+        int64_t from, to;
+    };
+
+    // File layout
+
+    FileHeader& Header() const {
+        return *reinterpret_cast<FileHeader*>(m_nodes.Data());
+    }
+
+    uint8_t* Record(uint32_t node) const {
+        return m_nodes.Data() + HEADER_BYTES + static_cast<size_t>(node) * m_recordBytes;
+    }
+
+    NodeHeader& Node(uint32_t node) const {
+        return *reinterpret_cast<NodeHeader*>(Record(node));
+    }
+
+    int8_t* Vector(uint32_t node) const {
+        return reinterpret_cast<int8_t*>(Record(node) + sizeof(NodeHeader));
+    }
+
+    // Links of a node on a level and the count of those in use
+    uint32_t* Links(uint32_t node, int level, uint32_t*& count) const {
+        if (level == 0) {
+            count = &Node(node).link_count;
+            return reinterpret_cast<uint32_t*>(Record(node) + sizeof(NodeHeader) + m_vectorBytes);
+        }
+        auto* block = reinterpret_cast<uint32_t*>(m_upper.Data() + Node(node).upper_slot * m_upperBytes +
+                                                  (level - 1) * (m_config.m + 1) * sizeof(uint32_t));
+        count = block;
+        return block + 1;
+    }
+
+    size_t Capacity(int level) const {
+        return level == 0 ? 2 * m_config.m : m_config.m;
+    }
+
+    bool Validate(uint64_t tag) const {
+        if (m_nodes.Size() < HEADER_BYTES) {
+            return false;
+        }
+        const FileHeader& header = Header();
+        return std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+               header.version == FILE_VERSION &&
+               header.dimension == static_cast<uint32_t>(m_dimension) &&
+               header.m == static_cast<uint32_t>(m_config.m) &&
+               header.model_tag == tag &&
+               header.record_bytes == m_recordBytes &&
+               m_nodes.Size() >= HEADER_BYTES + header.count * m_recordBytes &&
+               m_upper.Size() >= header.upper_count * m_upperBytes;
+    }
+
+    bool Reset(uint64_t tag) {
+        if (!m_nodes.Resize(0) || !m_upper.Resize(0) ||
+            !m_nodes.Resize(HEADER_BYTES + INITIAL_NODES * m_recordBytes)) {
+            return false;
+        }
+        FileHeader& header = Header();
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.dimension = static_cast<uint32_t>(m_dimension);
+        header.m = static_cast<uint32_t>(m_config.m);
+        header.model_tag = tag;
+        header.record_bytes = m_recordBytes;
+        header.count = 0;
+        header.upper_count = 0;
+        header.entry_point = -1;
+        header.max_level = 0;
+        header.flags = FLAG_TIME_ORDERED;
+        header.watermark = 0;
+        return m_nodes.Sync(true);
+    }
+
+    // Files grow by doubling; growing remaps, so no pointer into them may
+    // be held across these calls
+    bool EnsureNodeCapacity(size_t nodes) {
+        size_t needed = HEADER_BYTES + nodes * m_recordBytes;
+        if (m_nodes.Size() >= needed) {
+            return true;
+        }
+        return m_nodes.Resize(std::max(needed, HEADER_BYTES + 2 * (m_nodes.Size() - HEADER_BYTES)));
+    }
+
+    bool EnsureUpperCapacity(size_t slots) {
+        size_t needed = slots * m_upperBytes;
+        if (m_upper.Size() >= needed) {
+            return true;
+        }
+        return m_upper.Resize(std::max(needed, std::max(2 * m_upper.Size(), INITIAL_NODES * m_upperBytes / 8)));
+    }
+
+    void CloseLocked() {
+        if (m_open) {
+            m_nodes.Sync(true);
+            m_upper.Sync(true);
+        }
+        m_nodes.Close();
+        m_upper.Close();
+        m_byTime.clear();
+        m_byTime.shrink_to_fit();
+        m_open = false;
+    }
+
+    // Vectors
+
+    bool Quantize(const std::vector<float>& vector, Quantized& quantized) const {
+        double norm = 0.0;
+        float largest = 0.0f;
+        for (float value : vector) {
+            norm += static_cast<double>(value) * value;
+            largest = std::max(largest, std::fabs(value));
+        }
+        if (norm <= 0.0 || !std::isfinite(norm)) {
+            return false;
+        }
+        const float inverseNorm = static_cast<float>(1.0 / std::sqrt(norm));
+        const float step = largest * inverseNorm / 127.0f;
+        quantized.scale = step;
+        quantized.values.assign(m_vectorBytes, 0);
+        for (int i = 0; i < m_dimension; ++i) {
+            float q = std::round(vector[i] * inverseNorm / step);
+            quantized.values[i] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+        }
+        return true;
+    }
+
+    // 1 - cosine similarity
+    float Distance(const Quantized& query, uint32_t node) const {
+        return 1.0f - DotInt8(query.values.data(), Vector(node), m_dimension) * query.scale * Node(node).scale;
+    }
+
+    float Distance(uint32_t a, uint32_t b) const {
+        return 1.0f - DotInt8(Vector(a), Vector(b), m_dimension) * Node(a).scale * Node(b).scale;
+    }
+
+    // Graph
+
+    int RandomLevel() {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        double draw = std::max(uniform(m_rng), 1e-12);
+        return std::min(MAX_LEVEL, static_cast<int>(-std::log(draw) * m_levelFactor));
+    }
+
+    // Best-first search of one level; with a filter, only matching nodes
+    // enter the results but every node can be passed through
+    std::vector<Candidate> SearchLayer(const Quantized& query, uint32_t entry, size_t ef, int level,
+                                       const TimeFilter* filter) const {
+        auto passes = [this, filter](uint32_t node) {
+            if (!filter) {
+                return true;
+            }
+            int64_t time = Node(node).timestamp_ms;
+            return time >= filter->from && time <= filter->to;
+        };
+
+        Visited& visited = VisitedSet(Header().count + 1);
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+        std::priority_queue<Candidate> results;
+
+        float distance = Distance(query, entry);
+        visited.Mark(entry);
+        candidates.push({distance, entry});
+        if (passes(entry)) {
+            results.push({distance, entry});
+        }
+
+        while (!candidates.empty()) {
+            Candidate current = candidates.top();
+            if (results.size() >= ef && current.first > results.top().first) {
+                break;
+            }
+            candidates.pop();
+
+            uint32_t* count;
+            const uint32_t* links = Links(current.second, level, count);
+            for (uint32_t i = 0; i < *count; ++i) {
+                uint32_t neighbour = links[i];
+                if (visited.Mark(neighbour)) {
+                    continue;
+                }
+                float d = Distance(query, neighbour);
+                if (results.size() < ef || d < results.top().first) {
+                    candidates.push({d, neighbour});
+                    if (passes(neighbour)) {
+                        results.push({d, neighbour});
+                        if (results.size() > ef) {
+                            results.pop();
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<Candidate> found(results.size());
+        for (size_t i = found.size(); i > 0; --i) {
+            found[i - 1] = results.top();
+            results.pop();
+        }
+        if (found.empty() && !filter) {
+            found.push_back({distance, entry});
+        }
+        return found;
+    }
+
+    // Keeps candidates (closest first) that are nearer to the base node
+    // than to any neighbour already kept, so links spread in all
+    // directions; the rest fill remaining slots
+    std::vector<uint32_t> SelectNeighbours(const std::vector<Candidate>& candidates, size_t max) const {
+        std::vector<uint32_t> selected, skipped;
+        for (const Candidate& candidate : candidates) {
+            if (selected.size() >= max) {
+                break;
+            }
+            bool diverse = true;
+            for (uint32_t kept : selected) {
+                if (Distance(candidate.second, kept) < candidate.first) {
+                    diverse = false;
+                    break;
+                }
+            }
+            (diverse ? selected : skipped).push_back(candidate.second);
+        }
+        for (size_t i = 0; i < skipped.size() && selected.size() < max; ++i) {
+            selected.push_back(skipped[i]);
+        }
+        return selected;
+    }
+
+    void Link(uint32_t node, const Quantized& query, int level) {
+        FileHeader& header = Header();
+        uint32_t entry = static_cast<uint32_t>(header.entry_point);
+        for (int l = header.max_level; l > level; --l) {
+            entry = SearchLayer(query, entry, 1, l, nullptr).front().second;
+        }
+
+        for (int l = std::min(level, header.max_level); l >= 0; --l) {
+            std::vector<Candidate> found = SearchLayer(query, entry, m_config.ef_construction, l, nullptr);
+            std::vector<uint32_t> neighbours = SelectNeighbours(found, m_config.m);
+
+            uint32_t* count;
+            uint32_t* links = Links(node, l, count);
+            std::copy(neighbours.begin(), neighbours.end(), links);
+            *count = static_cast<uint32_t>(neighbours.size());
+            for (uint32_t neighbour : neighbours) {
+                Connect(neighbour, node, l);
+            }
+            entry = found.front().second;
+        }
+
+        if (level > header.max_level) {
+            header.max_level = level;
+            header.entry_point = static_cast<int32_t>(node);
+        }
+    }
+
+    // Adds a back link, re-selecting the neighbour's links when full
+    void Connect(uint32_t from, uint32_t to, int level) {
+        uint32_t* count;
+        uint32_t* links = Links(from, level, count);
+        const size_t capacity = Capacity(level);
+        if (*count < capacity) {
+            links[(*count)++] = to;
+            return;
+        }
+
+        std::vector<Candidate> candidates;
+        candidates.reserve(capacity + 1);
+        for (uint32_t i = 0; i < *count; ++i) {
+            candidates.push_back({Distance(from, links[i]), links[i]});
+        }
+        candidates.push_back({Distance(from, to), to});
+        std::sort(candidates.begin(), candidates.end());
+        std::vector<uint32_t> kept = SelectNeighbours(candidates, capacity);
+        std::copy(kept.begin(), kept.end(), links);
+        *count = static_cast<uint32_t>(kept.size());
+    }
+
+    // Time ranges
+
+    // Nodes with timestamps in [from, to] are positions [first, last) of the
+    // node order, or of m_byTime once insertions went out of order
+    void TimeRange(int64_t from, int64_t to, size_t& first, size_t& last) const {
+        const size_t count = Header().count;
+        if (Header().flags & FLAG_TIME_ORDERED) {
+            auto lowerBound = [this, count](int64_t time, bool inclusive) {
+                size_t low = 0, high = count;
+                while (low < high) {
+                    size_t mid = (low + high) / 2;
+                    int64_t t = Node(static_cast<uint32_t>(mid)).timestamp_ms;
+                    if (t < time || (inclusive && t == time)) {
+                        low = mid + 1;
+                    } else {
+                        high = mid;
+                    }
+                }
+                return low;
+            };
+            first = lowerBound(from, false);
+            last = lowerBound(to, true);
+        } else {
+            auto begin = std::lower_bound(m_byTime.begin(), m_byTime.end(), std::make_pair(from, uint32_t(0)));
+            auto end = std::upper_bound(m_byTime.begin(), m_byTime.end(),
+                                        std::make_pair(to, std::numeric_limits<uint32_t>::max()));
+            first = static_cast<size_t>(begin - m_byTime.begin());
+            last = std::max(first, static_cast<size_t>(end - m_byTime.begin()));
+        }
+    }
+
+    std::vector<Candidate> ExactScan(const Quantized& query, size_t k, size_t first, size_t last) const {
+        const bool ordered = Header().flags & FLAG_TIME_ORDERED;
+        std::priority_queue<Candidate> best;
+        for (size_t i = first; i < last; ++i) {
+            uint32_t node = ordered ? static_cast<uint32_t>(i) : m_byTime[i].second;
+            float d = Distance(query, node);
+            if (best.size() < k) {
+                best.push({d, node});
+            } else if (d < best.top().first) {
+                best.pop();
+                best.push({d, node});
+            }
+        }
+        std::vector<Candidate> found(best.size());
+        for (size_t i = found.size(); i > 0; --i) {
+            found[i - 1] = best.top();
+            best.pop();
+        }
+        return found;
+    }
+
+    void BuildTimeOrder() {
+        const uint32_t count = static_cast<uint32_t>(Header().count);
+        m_byTime.clear();
+        m_byTime.reserve(count);
+        for (uint32_t node = 0; node < count; ++node) {
+            m_byTime.emplace_back(Node(node).timestamp_ms, node);
+        }
+        std::sort(m_byTime.begin(), m_byTime.end());
+    }
+
+    void UpdateTimeOrder(uint32_t node) {
+        FileHeader& header = Header();
+        const int64_t time = Node(node).timestamp_ms;
+        if (header.flags & FLAG_TIME_ORDERED) {
+            if (node == 0 || Node(node - 1).timestamp_ms <= time) {
+                return;
+            }
+            // First out-of-order insertion: keep a sorted side index from now on
+            header.count = node;
+            BuildTimeOrder();
+            header.flags &= ~FLAG_TIME_ORDERED;
+        }
+        auto entry = std::make_pair(time, node);
+        m_byTime.insert(std::upper_bound(m_byTime.begin(), m_byTime.end(), entry), entry);
+    }
+
+    // Per-thread visited marks, cleared by bumping the epoch
+    struct Visited {
+        std::vector<uint32_t> marks;
+        uint32_t epoch = 0;
+
+        // True when already visited
+        bool Mark(uint32_t node) {
+            if (marks[node] == epoch) {
+                return true;
+            }
+            marks[node] = epoch;
+            return false;
+        }
+    };
+
+    static Visited& VisitedSet(size_t nodes) {
+        thread_local Visited visited;
+        if (visited.marks.size() < nodes) {
+            visited.marks.resize(nodes + nodes / 2, 0);
+        }
+        if (++visited.epoch == 0) {
+            std::fill(visited.marks.begin(), visited.marks.end(), 0);
+            visited.epoch = 1;
+        }
+        return visited;
+    }
+
+    mutable std::shared_mutex m_mutex;
+    bool m_open = false;
+    VectorIndexConfig m_config;
+    int m_dimension = 0;
+    size_t m_vectorBytes = 0;
+    size_t m_recordBytes = 0;
+    size_t m_upperBytes = 0;
+    double m_levelFactor = 0.0;
+    MappedFile m_nodes;
+    MappedFile m_upper;
+    std::vector<std::pair<int64_t, uint32_t>> m_byTime;   // Only when not time ordered
+    std::mt19937_64 m_rng;
+    mutable std::atomic<size_t> m_searches;
+    mutable std::atomic<size_t> m_exactScans;
+};
+
+VectorIndex::VectorIndex() : m_impl(std::make_unique<Impl>()) {}
+VectorIndex::~VectorIndex() = default;
+
+bool VectorIndex::Open(const std::string& path, int dimension, const std::string& modelTag,
+                       const VectorIndexConfig& config) {
+    return m_impl->Open(path, dimension, modelTag, config);
+}
+
+void VectorIndex::Close() {
+    m_impl->Close();
+}
+
+bool VectorIndex::IsOpen() const {
+    return m_impl->IsOpen();
+}
+
+bool VectorIndex::Add(uint64_t id, std::chrono::system_clock::time_point timestamp,
+                      const std::vector<float>& vector) {
+    return m_impl->Add(id, timestamp, vector);
+}
+
+std::vector<VectorMatch> VectorIndex::Search(const std::vector<float>& query, size_t k,
+                                             std::chrono::system_clock::time_point start,
+                                             std::chrono::system_clock::time_point end) const {
+    return m_impl->Search(query, k, start, end);
+}
+
+bool VectorIndex::Flush() {
+    return m_impl->Flush();
+}
+
+void VectorIndex::SetWatermark(uint64_t value) {
+    m_impl->SetWatermark(value);
+}
+
+uint64_t VectorIndex::GetWatermark() const {
+    return m_impl->GetWatermark();
+}
+
+size_t VectorIndex::Size() const {
+    return m_impl->Size();
+}
+
+int VectorIndex::Dimension() const {
+    return m_impl->Dimension();
+}
+
+VectorIndexStatistics VectorIndex::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
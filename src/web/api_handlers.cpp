@@ -1,9 +1,15 @@
 #include "web_server.h"
 #include "storage_engine.h"
+#include "cpu_governor.h"
+#include "memory_governor.h"
+#include "semantic_search.h"
+#include "timeline_downsampling.h"
+#include "replication.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <unordered_map>
+#include <mutex>
 
 namespace work_assistant {
 namespace api_handlers {
@@ -27,95 +33,202 @@ ApiResponse CreateSuccessResponse(const std::string& data, const std::string& me
     return response;
 }
 
-ApiResponse GetProductivitySummary(const std::chrono::system_clock::time_point& start,
-                                 const std::chrono::system_clock::time_point& end,
-                                 EncryptedStorageManager* storage) {
-    if (!storage || !storage->IsReady()) {
-        return CreateErrorResponse("Storage not available", 503);
+// Response builders shared by the single endpoints and batched queries
+namespace {
+
+ApiResponse BuildProductivitySummary(const std::chrono::system_clock::time_point& start,
+                                     const std::chrono::system_clock::time_point& end,
+                                     const std::unordered_map<std::string, float>& report,
+                                     const std::vector<std::pair<std::string, std::chrono::minutes>>& app_usage) {
+    if (report.empty()) {
+        std::ostringstream json;
+        json << "{";
+        json << "\"total_activities\": 0,";
+        json << "\"productive_ratio\": 0.0,";
+        json << "\"focused_ratio\": 0.0,";
+        json << "\"avg_confidence\": 0.0,";
+        json << "\"message\": \"No data available for the specified time range\"";
+        json << "}";
+        
+        return CreateSuccessResponse(json.str(), "No activities found");
     }
     
-    if (!web_utils::ValidateTimeRange(start, end)) {
-        return CreateErrorResponse("Invalid time range", 400);
+    // Build JSON response
+    std::ostringstream json;
+    json << "{";
+    json << "\"period\": {";
+    json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
+    json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
+    json << "},";
+    json << "\"summary\": {";
+    json << "  \"total_activities\": " << static_cast<int>(report.at("total_activities")) << ",";
+    json << "  \"productive_ratio\": " << std::fixed << std::setprecision(2) << report.at("productive_ratio") << ",";
+    json << "  \"focused_ratio\": " << std::fixed << std::setprecision(2) << report.at("focused_ratio") << ",";
+    json << "  \"avg_confidence\": " << std::fixed << std::setprecision(2) << report.at("avg_confidence") << ",";
+    json << "  \"avg_distraction\": " << std::fixed << std::setprecision(1) << report.at("avg_distraction");
+    
+    if (report.find("dominant_content_type") != report.end()) {
+        int type_val = static_cast<int>(report.at("dominant_content_type"));
+        ContentType dominant_type = static_cast<ContentType>(type_val);
+        json << ",";
+        json << "  \"dominant_content_type\": " << static_cast<int>(dominant_type) << "";
     }
     
-    try {
-        // Get productivity report from storage
-        auto report = storage->GetProductivityReport(start, end);
-        
-        if (report.empty()) {
-            std::ostringstream json;
-            json << "{";
-            json << "\"total_activities\": 0,";
-            json << "\"productive_ratio\": 0.0,";
-            json << "\"focused_ratio\": 0.0,";
-            json << "\"avg_confidence\": 0.0,";
-            json << "\"message\": \"No data available for the specified time range\"";
-            json << "}";
-            
-            return CreateSuccessResponse(json.str(), "No activities found");
-        }
+    json << "},";
+    
+    // Calculate productivity score
+    float productivity_score = report.at("productive_ratio") * 100.0f;
+    std::string productivity_level;
+    if (productivity_score >= 80) productivity_level = "Excellent";
+    else if (productivity_score >= 60) productivity_level = "Good";
+    else if (productivity_score >= 40) productivity_level = "Fair";
+    else productivity_level = "Poor";
+    
+    json << "\"productivity\": {";
+    json << "  \"score\": " << static_cast<int>(productivity_score) << ",";
+    json << "  \"level\": \"" << productivity_level << "\",";
+    json << "  \"recommendation\": \"";
+    
+    if (productivity_score < 60) {
+        json << "Consider taking more focused work sessions and reducing distractions";
+    } else if (productivity_score < 80) {
+        json << "Good productivity! Try to maintain focused work sessions";
+    } else {
+        json << "Excellent productivity! Keep up the great work";
+    }
+    
+    json << "\"";
+    json << "},";
+    
+    json << "\"applications\": [";
+    for (size_t i = 0; i < std::min(app_usage.size(), size_t(10)); ++i) {
+        if (i > 0) json << ",";
+        json << "{";
+        json << "\"name\": \"" << web_utils::EscapeJsonString(app_usage[i].first) << "\",";
+        json << "\"time_minutes\": " << app_usage[i].second.count();
+        json << "}";
+    }
+    json << "]";
+    json << "}";
+    
+    return CreateSuccessResponse(json.str(), "Productivity summary generated");
+}
+
+ApiResponse BuildActivityTimeline(const std::chrono::system_clock::time_point& start,
+                                  const std::chrono::system_clock::time_point& end,
+                                  const std::vector<ContentAnalysisRecord>& activities) {
+    std::ostringstream json;
+    json << "{";
+    json << "\"period\": {";
+    json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
+    json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
+    json << "},";
+    json << "\"total_activities\": " << activities.size() << ",";
+    json << "\"activities\": [";
+    
+    for (size_t i = 0; i < activities.size(); ++i) {
+        if (i > 0) json << ",";
         
-        // Build JSON response
-        std::ostringstream json;
+        const auto& activity = activities[i];
         json << "{";
-        json << "\"period\": {";
-        json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
-        json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
-        json << "},";
-        json << "\"summary\": {";
-        json << "  \"total_activities\": " << static_cast<int>(report.at("total_activities")) << ",";
-        json << "  \"productive_ratio\": " << std::fixed << std::setprecision(2) << report.at("productive_ratio") << ",";
-        json << "  \"focused_ratio\": " << std::fixed << std::setprecision(2) << report.at("focused_ratio") << ",";
-        json << "  \"avg_confidence\": " << std::fixed << std::setprecision(2) << report.at("avg_confidence") << ",";
-        json << "  \"avg_distraction\": " << std::fixed << std::setprecision(1) << report.at("avg_distraction");
-        
-        if (report.find("dominant_content_type") != report.end()) {
-            int type_val = static_cast<int>(report.at("dominant_content_type"));
-            ContentType dominant_type = static_cast<ContentType>(type_val);
-            json << ",";
-            json << "  \"dominant_content_type\": " << static_cast<int>(dominant_type) << "";
+        json << "\"id\": " << activity.id << ",";
+        json << "\"timestamp\": \"" << storage_utils::FormatTimestamp(activity.timestamp) << "\",";
+        json << "\"application\": \"" << web_utils::EscapeJsonString(activity.application_name) << "\",";
+        json << "\"window_title\": \"" << web_utils::EscapeJsonString(activity.window_title) << "\",";
+        json << "\"content_type\": " << static_cast<int>(activity.content_type) << ",";
+        json << "\"work_category\": " << static_cast<int>(activity.work_category) << ",";
+        json << "\"is_productive\": " << (activity.is_productive ? "true" : "false") << ",";
+        json << "\"is_focused\": " << (activity.is_focused_work ? "true" : "false") << ",";
+        json << "\"confidence\": " << std::fixed << std::setprecision(2) << activity.ai_confidence << ",";
+        json << "\"distraction_level\": " << activity.distraction_level << ",";
+        json << "\"priority\": " << static_cast<int>(activity.priority);
+        
+        if (!activity.keywords.empty()) {
+            json << ",\"keywords\": [";
+            for (size_t j = 0; j < std::min(activity.keywords.size(), size_t(5)); ++j) {
+                if (j > 0) json << ",";
+                json << "\"" << web_utils::EscapeJsonString(activity.keywords[j]) << "\"";
+            }
+            json << "]";
         }
         
-        json << "},";
+        json << "}";
+    }
+    
+    json << "]";
+    json << "}";
+    
+    return CreateSuccessResponse(json.str(), "Activity timeline generated");
+}
+
+ApiResponse BuildApplicationUsage(const std::chrono::system_clock::time_point& start,
+                                  const std::chrono::system_clock::time_point& end,
+                                  const std::vector<std::pair<std::string, std::chrono::minutes>>& app_usage) {
+    std::ostringstream json;
+    json << "{";
+    json << "\"period\": {";
+    json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
+    json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
+    json << "},";
+    json << "\"total_applications\": " << app_usage.size() << ",";
+    json << "\"applications\": [";
+    
+    for (size_t i = 0; i < app_usage.size(); ++i) {
+        if (i > 0) json << ",";
         
-        // Calculate productivity score
-        float productivity_score = report.at("productive_ratio") * 100.0f;
-        std::string productivity_level;
-        if (productivity_score >= 80) productivity_level = "Excellent";
-        else if (productivity_score >= 60) productivity_level = "Good";
-        else if (productivity_score >= 40) productivity_level = "Fair";
-        else productivity_level = "Poor";
-        
-        json << "\"productivity\": {";
-        json << "  \"score\": " << static_cast<int>(productivity_score) << ",";
-        json << "  \"level\": \"" << productivity_level << "\",";
-        json << "  \"recommendation\": \"";
-        
-        if (productivity_score < 60) {
-            json << "Consider taking more focused work sessions and reducing distractions";
-        } else if (productivity_score < 80) {
-            json << "Good productivity! Try to maintain focused work sessions";
+        json << "{";
+        json << "\"name\": \"" << web_utils::EscapeJsonString(app_usage[i].first) << "\",";
+        json << "\"time_minutes\": " << app_usage[i].second.count() << ",";
+        json << "\"time_formatted\": \"";
+        
+        auto minutes = app_usage[i].second.count();
+        if (minutes >= 60) {
+            json << (minutes / 60) << "h " << (minutes % 60) << "m";
         } else {
-            json << "Excellent productivity! Keep up the great work";
+            json << minutes << "m";
         }
         
-        json << "\"";
-        json << "},";
+        json << "\",";
         
-        // Get application usage
-        auto app_usage = storage->GetTimeSpentByApplication(start, end);
-        json << "\"applications\": [";
-        for (size_t i = 0; i < std::min(app_usage.size(), size_t(10)); ++i) {
-            if (i > 0) json << ",";
-            json << "{";
-            json << "\"name\": \"" << web_utils::EscapeJsonString(app_usage[i].first) << "\",";
-            json << "\"time_minutes\": " << app_usage[i].second.count();
-            json << "}";
-        }
-        json << "]";
+        // Calculate percentage of total time
+        auto total_minutes = std::chrono::duration_cast<std::chrono::minutes>(end - start).count();
+        float percentage = total_minutes > 0 ? (static_cast<float>(minutes) / total_minutes) * 100.0f : 0.0f;
+        json << "\"percentage\": " << std::fixed << std::setprecision(1) << percentage;
         json << "}";
+    }
+    
+    json << "]";
+    json << "}";
+    
+    return CreateSuccessResponse(json.str(), "Application usage report generated");
+}
+
+} // namespace
+
+ApiResponse GetProductivitySummary(const std::chrono::system_clock::time_point& start,
+                                 const std::chrono::system_clock::time_point& end,
+                                 EncryptedStorageManager* storage,
+                                 const CancellationCheck& cancelled) {
+    if (!storage || !storage->IsReady()) {
+        return CreateErrorResponse("Storage not available", 503);
+    }
+    
+    if (!web_utils::ValidateTimeRange(start, end)) {
+        return CreateErrorResponse("Invalid time range", 400);
+    }
+    
+    try {
+        // Get productivity report from storage
+        auto report = storage->GetProductivityReport(start, end, cancelled);
+        std::vector<std::pair<std::string, std::chrono::minutes>> app_usage;
+        if (!report.empty()) {
+            app_usage = storage->GetTimeSpentByApplication(start, end, cancelled);
+        }
+        if (cancelled && cancelled()) {
+            return CreateErrorResponse("Request cancelled", 499);
+        }
         
-        return CreateSuccessResponse(json.str(), "Productivity summary generated");
+        return BuildProductivitySummary(start, end, report, app_usage);
         
     } catch (const std::exception& e) {
         return CreateErrorResponse("Failed to generate productivity summary: " + std::string(e.what()), 500);
@@ -124,7 +237,9 @@ ApiResponse GetProductivitySummary(const std::chrono::system_clock::time_point&
 
 ApiResponse GetActivityTimeline(const std::chrono::system_clock::time_point& start,
                               const std::chrono::system_clock::time_point& end,
-                              EncryptedStorageManager* storage) {
+                              EncryptedStorageManager* storage,
+                              const TimelineOptions& options,
+                              const CancellationCheck& cancelled) {
     if (!storage || !storage->IsReady()) {
         return CreateErrorResponse("Storage not available", 503);
     }
@@ -133,8 +248,47 @@ ApiResponse GetActivityTimeline(const std::chrono::system_clock::time_point& sta
         return CreateErrorResponse("Invalid time range", 400);
     }
     
+    if (options.mode != "raw" && options.mode != "buckets" && options.mode != "lttb") {
+        return CreateErrorResponse("Unknown timeline mode: " + options.mode, 400);
+    }
+    if (options.metric != "confidence" && options.metric != "distraction" && options.metric != "productive") {
+        return CreateErrorResponse("Unknown timeline metric: " + options.metric, 400);
+    }
+    if (options.points > MAX_TIMELINE_POINTS) {
+        return CreateErrorResponse("At most " + std::to_string(MAX_TIMELINE_POINTS) + " points", 400);
+    }
+    
     try {
-        auto activities = storage->GetContentAnalyses(start, end);
+        if (options.mode == "raw") {
+            auto activities = storage->GetContentAnalyses(start, end);
+            return BuildActivityTimeline(start, end, activities);
+        }
+        
+        // Downsampling needs the whole range, not one query page
+        ActivityRollup rollup;
+        if (!storage->GetActivityRollup(start, end, rollup, cancelled)) {
+            if (cancelled && cancelled()) {
+                return CreateErrorResponse("Request cancelled", 499);
+            }
+            return CreateErrorResponse("Failed to read activity data", 500);
+        }
+        
+        std::vector<TimelinePoint> points;
+        points.reserve(rollup.analyses.size());
+        for (const auto& analysis : rollup.analyses) {
+            TimelinePoint point;
+            point.timestamp = analysis.timestamp;
+            point.category = static_cast<int>(analysis.work_category);
+            if (options.metric == "distraction") {
+                point.value = analysis.distraction_level;
+            } else if (options.metric == "productive") {
+                point.value = analysis.is_productive ? 1.0 : 0.0;
+            } else {
+                point.value = analysis.ai_confidence;
+            }
+            points.push_back(point);
+        }
+        size_t target = options.points > 0 ? options.points : DEFAULT_TIMELINE_POINTS;
         
         std::ostringstream json;
         json << "{";
@@ -142,39 +296,45 @@ ApiResponse GetActivityTimeline(const std::chrono::system_clock::time_point& sta
         json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
         json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
         json << "},";
-        json << "\"total_activities\": " << activities.size() << ",";
-        json << "\"activities\": [";
+        json << "\"mode\": \"" << options.mode << "\",";
+        json << "\"metric\": \"" << options.metric << "\",";
+        json << "\"total_activities\": " << points.size() << ",";
         
-        for (size_t i = 0; i < activities.size(); ++i) {
-            if (i > 0) json << ",";
-            
-            const auto& activity = activities[i];
-            json << "{";
-            json << "\"id\": " << activity.id << ",";
-            json << "\"timestamp\": \"" << storage_utils::FormatTimestamp(activity.timestamp) << "\",";
-            json << "\"application\": \"" << web_utils::EscapeJsonString(activity.application_name) << "\",";
-            json << "\"window_title\": \"" << web_utils::EscapeJsonString(activity.window_title) << "\",";
-            json << "\"content_type\": " << static_cast<int>(activity.content_type) << ",";
-            json << "\"work_category\": " << static_cast<int>(activity.work_category) << ",";
-            json << "\"is_productive\": " << (activity.is_productive ? "true" : "false") << ",";
-            json << "\"is_focused\": " << (activity.is_focused_work ? "true" : "false") << ",";
-            json << "\"confidence\": " << std::fixed << std::setprecision(2) << activity.ai_confidence << ",";
-            json << "\"distraction_level\": " << activity.distraction_level << ",";
-            json << "\"priority\": " << static_cast<int>(activity.priority);
-            
-            if (!activity.keywords.empty()) {
-                json << ",\"keywords\": [";
-                for (size_t j = 0; j < std::min(activity.keywords.size(), size_t(5)); ++j) {
-                    if (j > 0) json << ",";
-                    json << "\"" << web_utils::EscapeJsonString(activity.keywords[j]) << "\"";
-                }
-                json << "]";
+        if (options.mode == "buckets") {
+            auto buckets = downsampling::AggregateBuckets(points, start, end, target);
+            json << "\"bucket_seconds\": " << std::fixed << std::setprecision(1)
+                 << std::chrono::duration<double>(end - start).count() / target << ",";
+            json << "\"buckets\": [";
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                if (i > 0) json << ",";
+                const auto& bucket = buckets[i];
+                json << "{";
+                json << "\"start\": \"" << storage_utils::FormatTimestamp(bucket.start) << "\",";
+                json << "\"end\": \"" << storage_utils::FormatTimestamp(bucket.end) << "\",";
+                json << "\"work_category\": " << bucket.category << ",";
+                json << "\"count\": " << bucket.count << ",";
+                json << "\"min\": " << std::fixed << std::setprecision(2) << bucket.min << ",";
+                json << "\"max\": " << std::fixed << std::setprecision(2) << bucket.max << ",";
+                json << "\"avg\": " << std::fixed << std::setprecision(2) << bucket.avg;
+                json << "}";
             }
-            
-            json << "}";
+            json << "]";
+        } else {
+            auto selected = downsampling::LargestTriangleThreeBuckets(points, target);
+            json << "\"points\": [";
+            for (size_t i = 0; i < selected.size(); ++i) {
+                if (i > 0) json << ",";
+                const auto& analysis = rollup.analyses[selected[i]];
+                json << "{";
+                json << "\"id\": " << analysis.id << ",";
+                json << "\"timestamp\": \"" << storage_utils::FormatTimestamp(analysis.timestamp) << "\",";
+                json << "\"application\": \"" << web_utils::EscapeJsonString(analysis.application_name) << "\",";
+                json << "\"work_category\": " << static_cast<int>(analysis.work_category) << ",";
+                json << "\"value\": " << std::fixed << std::setprecision(2) << points[selected[i]].value;
+                json << "}";
+            }
+            json << "]";
         }
-        
-        json << "]";
         json << "}";
         
         return CreateSuccessResponse(json.str(), "Activity timeline generated");
@@ -186,7 +346,8 @@ ApiResponse GetActivityTimeline(const std::chrono::system_clock::time_point& sta
 
 ApiResponse GetApplicationUsage(const std::chrono::system_clock::time_point& start,
                               const std::chrono::system_clock::time_point& end,
-                              EncryptedStorageManager* storage) {
+                              EncryptedStorageManager* storage,
+                              const CancellationCheck& cancelled) {
     if (!storage || !storage->IsReady()) {
         return CreateErrorResponse("Storage not available", 503);
     }
@@ -196,53 +357,150 @@ ApiResponse GetApplicationUsage(const std::chrono::system_clock::time_point& sta
     }
     
     try {
-        auto app_usage = storage->GetTimeSpentByApplication(start, end);
+        auto app_usage = storage->GetTimeSpentByApplication(start, end, cancelled);
+        if (cancelled && cancelled()) {
+            return CreateErrorResponse("Request cancelled", 499);
+        }
+        
+        return BuildApplicationUsage(start, end, app_usage);
+        
+    } catch (const std::exception& e) {
+        return CreateErrorResponse("Failed to generate usage report: " + std::string(e.what()), 500);
+    }
+}
+
+ApiResponse ExecuteBatch(const std::vector<BatchSubQuery>& queries,
+                        EncryptedStorageManager* storage,
+                        const CancellationCheck& cancelled) {
+    if (queries.empty() || queries.size() > MAX_BATCH_QUERIES) {
+        return CreateErrorResponse("A batch needs between 1 and " + std::to_string(MAX_BATCH_QUERIES) + " queries", 400);
+    }
+    
+    // Validate everything before touching storage
+    std::vector<size_t> ranged;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const auto& query = queries[i];
+        for (size_t j = 0; j < i; ++j) {
+            if (queries[j].name == query.name) {
+                return CreateErrorResponse("Duplicate query name: " + query.name, 400);
+            }
+        }
+        if (query.type == "status") {
+            continue;
+        }
+        if (query.type != "summary" && query.type != "timeline" && query.type != "applications") {
+            return CreateErrorResponse("Unknown query type for " + query.name + ": " + query.type, 400);
+        }
+        if (!web_utils::ValidateTimeRange(query.start, query.end)) {
+            return CreateErrorResponse("Invalid time range for " + query.name, 400);
+        }
+        ranged.push_back(i);
+    }
+    if (!ranged.empty() && (!storage || !storage->IsReady())) {
+        return CreateErrorResponse("Storage not available", 503);
+    }
+    
+    try {
+        // Overlapping ranges merge into one scan; each query then reads its
+        // own slice of that scan's rollup
+        std::sort(ranged.begin(), ranged.end(), [&queries](size_t a, size_t b) {
+            return queries[a].start < queries[b].start;
+        });
+        std::vector<ActivityRollup> rollups;
+        std::vector<size_t> rollup_of(queries.size(), 0);
+        for (size_t index : ranged) {
+            const auto& query = queries[index];
+            if (rollups.empty() || query.start > rollups.back().end_time) {
+                ActivityRollup rollup;
+                rollup.start_time = query.start;
+                rollup.end_time = query.end;
+                rollups.push_back(rollup);
+            } else {
+                rollups.back().end_time = std::max(rollups.back().end_time, query.end);
+            }
+            rollup_of[index] = rollups.size() - 1;
+        }
+        for (auto& rollup : rollups) {
+            if (!storage->GetActivityRollup(rollup.start_time, rollup.end_time, rollup, cancelled)) {
+                if (cancelled && cancelled()) {
+                    return CreateErrorResponse("Request cancelled", 499);
+                }
+                return CreateErrorResponse("Failed to read activity data", 500);
+            }
+        }
         
         std::ostringstream json;
         json << "{";
-        json << "\"period\": {";
-        json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
-        json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
-        json << "},";
-        json << "\"total_applications\": " << app_usage.size() << ",";
-        json << "\"applications\": [";
-        
-        for (size_t i = 0; i < app_usage.size(); ++i) {
+        json << "\"scans\": " << rollups.size() << ",";
+        json << "\"results\": {";
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const auto& query = queries[i];
             if (i > 0) json << ",";
+            json << "\"" << web_utils::EscapeJsonString(query.name) << "\": ";
             
-            json << "{";
-            json << "\"name\": \"" << web_utils::EscapeJsonString(app_usage[i].first) << "\",";
-            json << "\"time_minutes\": " << app_usage[i].second.count() << ",";
-            json << "\"time_formatted\": \"";
+            if (query.type == "status") {
+                json << GetSystemStatus().ToJson();
+                continue;
+            }
             
-            auto minutes = app_usage[i].second.count();
-            if (minutes >= 60) {
-                json << (minutes / 60) << "h " << (minutes % 60) << "m";
-            } else {
-                json << minutes << "m";
+            // Stored timestamps are whole seconds and queries compare at that
+            // resolution, so the slice does too
+            const auto& rollup = rollups[rollup_of[i]];
+            auto first = std::chrono::time_point_cast<std::chrono::seconds>(query.start);
+            auto last = std::chrono::time_point_cast<std::chrono::seconds>(query.end);
+            auto analyses_begin = std::lower_bound(rollup.analyses.begin(), rollup.analyses.end(), first,
+                [](const ContentAnalysisRecord& a, const auto& t) { return a.timestamp < t; });
+            auto analyses_end = std::upper_bound(analyses_begin, rollup.analyses.end(), last,
+                [](const auto& t, const ContentAnalysisRecord& a) { return t < a.timestamp; });
+            
+            if (query.type == "timeline") {
+                // Newest first and capped, as the timeline endpoint returns them
+                std::vector<ContentAnalysisRecord> activities;
+                for (auto it = analyses_end; it != analyses_begin && activities.size() < QueryParams().limit;) {
+                    activities.push_back(*--it);
+                }
+                json << BuildActivityTimeline(query.start, query.end, activities).ToJson();
+                continue;
             }
             
-            json << "\",";
+            auto activities_begin = std::lower_bound(rollup.activities.begin(), rollup.activities.end(), first,
+                [](const WindowActivityRecord& a, const auto& t) { return a.timestamp < t; });
+            auto activities_end = std::upper_bound(activities_begin, rollup.activities.end(), last,
+                [](const auto& t, const WindowActivityRecord& a) { return t < a.timestamp; });
+            std::unordered_map<std::string, int> event_counts;
+            for (auto it = activities_begin; it != activities_end; ++it) {
+                if (!it->application_name.empty()) {
+                    event_counts[it->application_name]++;
+                }
+            }
+            auto app_usage = storage_utils::EstimateTimeByApplication(event_counts);
             
-            // Calculate percentage of total time
-            auto total_minutes = std::chrono::duration_cast<std::chrono::minutes>(end - start).count();
-            float percentage = total_minutes > 0 ? (static_cast<float>(minutes) / total_minutes) * 100.0f : 0.0f;
-            json << "\"percentage\": " << std::fixed << std::setprecision(1) << percentage;
-            json << "}";
+            if (query.type == "applications") {
+                json << BuildApplicationUsage(query.start, query.end, app_usage).ToJson();
+            } else {
+                ProductivityTotals totals;
+                for (auto it = analyses_begin; it != analyses_end; ++it) {
+                    totals.Add(*it);
+                }
+                auto report = totals.ToReport();
+                if (report.empty()) {
+                    app_usage.clear();
+                }
+                json << BuildProductivitySummary(query.start, query.end, report, app_usage).ToJson();
+            }
         }
-        
-        json << "]";
+        json << "}";
         json << "}";
         
-        return CreateSuccessResponse(json.str(), "Application usage report generated");
+        return CreateSuccessResponse(json.str(), "Batch executed");
         
     } catch (const std::exception& e) {
-        return CreateErrorResponse("Failed to generate usage report: " + std::string(e.what()), 500);
+        return CreateErrorResponse("Failed to execute batch: " + std::string(e.what()), 500);
     }
 }
 
 ApiResponse SearchContent(const std::string& query, int max_results,
-                        EncryptedStorageManager* storage) {
+                        EncryptedStorageManager* storage, const std::string& application) {
     if (!storage || !storage->IsReady()) {
         return CreateErrorResponse("Storage not available", 503);
     }
@@ -256,13 +514,19 @@ ApiResponse SearchContent(const std::string& query, int max_results,
     }
     
     try {
-        auto results = storage->SearchContent(query, max_results);
+        PruningStats pruning;
+        auto results = storage->SearchContent(query, max_results, application, &pruning);
         
         std::ostringstream json;
         json << "{";
         json << "\"query\": \"" << web_utils::EscapeJsonString(query) << "\",";
+        if (!application.empty()) {
+            json << "\"application\": \"" << web_utils::EscapeJsonString(application) << "\",";
+        }
         json << "\"total_results\": " << results.size() << ",";
         json << "\"max_results\": " << max_results << ",";
+        json << "\"partitions\": {\"scanned\": " << pruning.partitions_scanned
+             << ", \"pruned\": " << pruning.partitions_pruned << "},";
         json << "\"results\": [";
         
         for (size_t i = 0; i < results.size(); ++i) {
@@ -297,6 +561,61 @@ ApiResponse SearchContent(const std::string& query, int max_results,
     }
 }
 
+ApiResponse SemanticSearchContent(const std::string& query, int max_results,
+                                const std::chrono::system_clock::time_point& start,
+                                const std::chrono::system_clock::time_point& end,
+                                SemanticSearch* search) {
+    if (!search || !search->IsReady()) {
+        return CreateErrorResponse("Semantic search not available", 503);
+    }
+    
+    if (query.empty()) {
+        return CreateErrorResponse("Search query cannot be empty", 400);
+    }
+    
+    // Unlike the reports, searches may span the whole history
+    if (start > end) {
+        return CreateErrorResponse("Invalid time range", 400);
+    }
+    
+    if (max_results <= 0 || max_results > 100) {
+        max_results = 20; // Default limit
+    }
+    
+    try {
+        auto results = search->Search(query, max_results, start, end);
+        auto stats = search->GetStatistics();
+        
+        std::ostringstream json;
+        json << "{";
+        json << "\"query\": \"" << web_utils::EscapeJsonString(query) << "\",";
+        json << "\"total_results\": " << results.size() << ",";
+        json << "\"max_results\": " << max_results << ",";
+        json << "\"indexed_chunks\": " << stats.indexed_chunks << ",";
+        json << "\"results\": [";
+        
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (i > 0) json << ",";
+            
+            const auto& result = results[i];
+            json << "{";
+            json << "\"ocr_record_id\": " << result.record_id << ",";
+            json << "\"timestamp\": \"" << storage_utils::FormatTimestamp(result.timestamp) << "\",";
+            json << "\"similarity\": " << std::fixed << std::setprecision(3) << result.similarity << ",";
+            json << "\"snippet\": \"" << web_utils::EscapeJsonString(result.snippet) << "\"";
+            json << "}";
+        }
+        
+        json << "]";
+        json << "}";
+        
+        return CreateSuccessResponse(json.str(), "Search completed");
+        
+    } catch (const std::exception& e) {
+        return CreateErrorResponse("Semantic search failed: " + std::string(e.what()), 500);
+    }
+}
+
 ApiResponse ExportData(const std::chrono::system_clock::time_point& start,
                      const std::chrono::system_clock::time_point& end,
                      const std::string& format,
@@ -349,6 +668,78 @@ ApiResponse ExportData(const std::chrono::system_clock::time_point& start,
     }
 }
 
+ApiResponse GetScreenshotTimeline(const std::chrono::system_clock::time_point& start,
+                                const std::chrono::system_clock::time_point& end,
+                                const std::string& thumbnail_path,
+                                EncryptedStorageManager* storage) {
+    if (!storage || !storage->IsReady()) {
+        return CreateErrorResponse("Storage not available", 503);
+    }
+    
+    if (!web_utils::ValidateTimeRange(start, end)) {
+        return CreateErrorResponse("Invalid time range", 400);
+    }
+    
+    try {
+        // One entry per level, grouped by capture
+        auto thumbnails = storage->GetScreenCaptureThumbnails(start, end);
+        
+        std::ostringstream json;
+        json << "{";
+        json << "\"period\": {";
+        json << "  \"start\": \"" << storage_utils::FormatTimestamp(start) << "\",";
+        json << "  \"end\": \"" << storage_utils::FormatTimestamp(end) << "\"";
+        json << "},";
+        json << "\"screenshots\": [";
+        
+        size_t count = 0;
+        for (size_t i = 0; i < thumbnails.size(); ) {
+            const uint64_t capture_id = thumbnails[i].capture_id;
+            if (count++ > 0) json << ",";
+            
+            json << "{";
+            json << "\"id\": " << capture_id << ",";
+            json << "\"timestamp\": \"" << storage_utils::FormatTimestamp(thumbnails[i].timestamp) << "\",";
+            json << "\"url\": \"" << thumbnail_path << "?id=" << capture_id << "\",";
+            json << "\"levels\": [";
+            for (size_t first = i; i < thumbnails.size() && thumbnails[i].capture_id == capture_id; ++i) {
+                if (i > first) json << ",";
+                json << "{\"width\": " << thumbnails[i].width << ", \"height\": " << thumbnails[i].height << "}";
+            }
+            json << "]";
+            json << "}";
+        }
+        
+        json << "],";
+        json << "\"total_screenshots\": " << count;
+        json << "}";
+        
+        return CreateSuccessResponse(json.str(), "Screenshot timeline generated");
+        
+    } catch (const std::exception& e) {
+        return CreateErrorResponse("Failed to list screenshots: " + std::string(e.what()), 500);
+    }
+}
+
+ApiResponse GetScreenshotThumbnail(uint64_t capture_id, int width,
+                                 EncryptedStorageManager* storage,
+                                 ScreenThumbnail& thumbnail) {
+    if (!storage || !storage->IsReady()) {
+        return CreateErrorResponse("Storage not available", 503);
+    }
+    
+    if (capture_id == 0 || width <= 0) {
+        return CreateErrorResponse("Invalid thumbnail request", 400);
+    }
+    
+    if (!storage->GetScreenCaptureThumbnail(capture_id, width, thumbnail)) {
+        return CreateErrorResponse("Thumbnail not found", 404);
+    }
+    
+    // The image itself is returned in thumbnail, not in the JSON body
+    return CreateSuccessResponse("", "Thumbnail found");
+}
+
 ApiResponse GetSystemStatus() {
     try {
         std::ostringstream json;
@@ -442,6 +833,155 @@ ApiResponse GetConfiguration() {
     }
 }
 
+ApiResponse GetResourceBudget() {
+    try {
+        auto cpu = CpuGovernor::GetInstance().GetStatus();
+        auto memory = MemoryGovernor::GetInstance().GetStatus();
+
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(2);
+        json << "{";
+        json << "\"cpu\": {";
+        json << "  \"running\": " << (CpuGovernor::GetInstance().IsRunning() ? "true" : "false") << ",";
+        json << "  \"mode\": \"" << cpu_utils::BudgetModeToString(cpu.budget.mode) << "\",";
+        json << "  \"scale\": " << cpu.budget.scale << ",";
+        json << "  \"reason\": \"" << web_utils::EscapeJsonString(cpu.reason) << "\",";
+        json << "  \"target_share_percent\": " << cpu.target_share << ",";
+        json << "  \"process_share_percent\": " << cpu.process_share << ",";
+        json << "  \"system_usage_percent\": " << cpu.system_usage_percent << ",";
+        json << "  \"capacity_cores\": " << cpu.capacity_cores << ",";
+        json << "  \"cgroup\": {";
+        json << "    \"available\": " << (cpu.cgroup_available ? "true" : "false") << ",";
+        json << "    \"quota_cores\": " << cpu.cgroup_quota_cores << ",";
+        json << "    \"throttled_periods\": " << cpu.throttled_periods << ",";
+        json << "    \"throttled_usec\": " << cpu.throttled_usec;
+        json << "  },";
+        json << "  \"budget_changes\": " << cpu.budget_changes << ",";
+        json << "  \"consumers\": [";
+        for (size_t i = 0; i < cpu.consumers.size(); ++i) {
+            if (i > 0) json << ",";
+            json << "\"" << web_utils::EscapeJsonString(cpu.consumers[i]) << "\"";
+        }
+        json << "]";
+        json << "},";
+        json << "\"memory\": {";
+        json << "  \"running\": " << (MemoryGovernor::GetInstance().IsRunning() ? "true" : "false") << ",";
+        json << "  \"level\": \"" << memory_utils::PressureLevelToString(memory.level) << "\",";
+        json << "  \"psi_available\": " << (memory.psi_available ? "true" : "false") << ",";
+        json << "  \"psi_some_avg10\": " << memory.psi_some_avg10 << ",";
+        json << "  \"psi_full_avg10\": " << memory.psi_full_avg10 << ",";
+        json << "  \"cgroup_usage_bytes\": " << memory.cgroup_usage_bytes << ",";
+        json << "  \"cgroup_limit_bytes\": " << memory.cgroup_limit_bytes << ",";
+        json << "  \"process_rss_bytes\": " << memory.process_rss_bytes << ",";
+        json << "  \"level_changes\": " << memory.level_changes << ",";
+        json << "  \"consumers\": [";
+        for (size_t i = 0; i < memory.consumers.size(); ++i) {
+            if (i > 0) json << ",";
+            json << "{\"name\": \"" << web_utils::EscapeJsonString(memory.consumers[i].first)
+                 << "\", \"bytes\": " << memory.consumers[i].second << "}";
+        }
+        json << "]";
+        json << "}";
+        json << "}";
+
+        return CreateSuccessResponse(json.str(), "Resource budget retrieved");
+
+    } catch (const std::exception& e) {
+        return CreateErrorResponse("Failed to get resource budget: " + std::string(e.what()), 500);
+    }
+}
+
+namespace {
+
+// Serializes position checks with the writes that advance them
+std::mutex g_replicationMutex;
+
+uint64_t ReplicationPosition(EncryptedStorageManager* storage, const std::string& key) {
+    std::string value;
+    if (!storage->GetStateValue(key, value)) {
+        return 0;
+    }
+    try {
+        return std::stoull(value);
+    } catch (...) {
+        return 0;
+    }
+}
+
+std::string ReplicationData(const std::string& workstation, uint64_t sequence) {
+    std::ostringstream json;
+    json << "{\"workstation\":\"" << web_utils::EscapeJsonString(workstation)
+         << "\",\"sequence\":" << sequence;
+    return json.str();
+}
+
+} // namespace
+
+ApiResponse GetReplicationPosition(const std::string& workstation, uint64_t source_id,
+                                 EncryptedStorageManager* storage) {
+    if (!storage || !storage->IsReady()) {
+        return CreateErrorResponse("Storage not available", 500);
+    }
+    if (!replication_utils::IsValidWorkstationId(workstation) || source_id == 0) {
+        return CreateErrorResponse("Invalid workstation or source id");
+    }
+
+    std::lock_guard<std::mutex> lock(g_replicationMutex);
+    uint64_t position = ReplicationPosition(storage, replication_utils::PositionKey(workstation, source_id));
+    return CreateSuccessResponse(ReplicationData(workstation, position) + "}");
+}
+
+ApiResponse ApplyReplicationDelta(const std::vector<uint8_t>& body,
+                                EncryptedStorageManager* storage) {
+    if (!storage || !storage->IsReady()) {
+        return CreateErrorResponse("Storage not available", 500);
+    }
+
+    ReplicationDelta delta;
+    if (!replication_utils::DecodeDelta(body, delta)) {
+        return CreateErrorResponse("Malformed replication delta");
+    }
+    if (!replication_utils::IsValidWorkstationId(delta.workstation) || delta.source_id == 0) {
+        return CreateErrorResponse("Invalid workstation or source id");
+    }
+
+    std::lock_guard<std::mutex> lock(g_replicationMutex);
+    const std::string key = replication_utils::PositionKey(delta.workstation, delta.source_id);
+    uint64_t position = ReplicationPosition(storage, key);
+    if (delta.base > position) {
+        ApiResponse response = CreateErrorResponse("Delta does not continue the applied sequence", 409);
+        response.data = ReplicationData(delta.workstation, position) + "}";
+        return response;
+    }
+    if (delta.sequence <= position) {
+        return CreateSuccessResponse(ReplicationData(delta.workstation, position) + ",\"applied\":0}",
+                                     "Already applied");
+    }
+
+    // Overlapping deltas (a retry after a lost acknowledgement) only add
+    // what is new; records are tagged with their workstation
+    std::vector<WindowActivityRecord> activities;
+    std::vector<ContentAnalysisRecord> analyses;
+    for (auto& activity : delta.activities) {
+        if (activity.id > position) {
+            activity.session_id = delta.workstation;
+            activities.push_back(std::move(activity));
+        }
+    }
+    for (auto& analysis : delta.analyses) {
+        if (analysis.id > position) {
+            analysis.session_id = delta.workstation;
+            analyses.push_back(std::move(analysis));
+        }
+    }
+
+    if (!storage->StoreBatchWithState(activities, analyses, key, std::to_string(delta.sequence))) {
+        return CreateErrorResponse("Failed to store replication delta", 500);
+    }
+    return CreateSuccessResponse(ReplicationData(delta.workstation, delta.sequence) +
+                                 ",\"applied\":" + std::to_string(activities.size() + analyses.size()) + "}");
+}
+
 } // namespace api_handlers
 
 // Web utility functions
@@ -0,0 +1,825 @@
+#include "replication.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace work_assistant {
+
+namespace {
+
+const char DELTA_MAGIC[4] = {'W', 'A', 'R', 'D'};
+const uint8_t DELTA_VERSION = 1;
+const uint8_t FLAG_DEFLATED = 1;
+const size_t MAX_DELTA_BYTES = 64 * 1024 * 1024;
+
+// Writes varints; strings go through a table so repeated application
+// names, event types and titles cost one byte or two each
+class DeltaWriter {
+public:
+    void PutVarint(uint64_t value) {
+        while (value >= 0x80) {
+            m_body.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        m_body.push_back(static_cast<uint8_t>(value));
+    }
+
+    void PutSigned(int64_t value) {
+        PutVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void PutString(const std::string& value) {
+        auto it = m_index.find(value);
+        if (it == m_index.end()) {
+            it = m_index.emplace(value, m_strings.size()).first;
+            m_strings.push_back(&it->first);
+        }
+        PutVarint(it->second);
+    }
+
+    void PutFraction(float value) {
+        PutVarint(value > 0.0f ? static_cast<uint64_t>(value * 1000.0f + 0.5f) : 0);
+    }
+
+    // Table first, then the body that refers to it
+    std::vector<uint8_t> Finish() {
+        std::vector<uint8_t> body;
+        body.swap(m_body);
+        PutVarint(m_strings.size());
+        for (const std::string* value : m_strings) {
+            PutVarint(value->size());
+            m_body.insert(m_body.end(), value->begin(), value->end());
+        }
+        m_body.insert(m_body.end(), body.begin(), body.end());
+        return std::move(m_body);
+    }
+
+private:
+    std::vector<uint8_t> m_body;
+    std::unordered_map<std::string, uint64_t> m_index;
+    std::vector<const std::string*> m_strings;
+};
+
+class DeltaReader {
+public:
+    DeltaReader(const uint8_t* data, size_t size)
+        : m_data(data), m_end(data + size), m_stringBudget(MAX_DELTA_BYTES) {}
+
+    bool ReadTable() {
+        uint64_t count = 0;
+        if (!GetVarint(count) || count > static_cast<uint64_t>(m_end - m_data)) {
+            return false;
+        }
+        m_strings.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t length = 0;
+            if (!GetVarint(length) || length > static_cast<uint64_t>(m_end - m_data)) {
+                return false;
+            }
+            m_strings.emplace_back(reinterpret_cast<const char*>(m_data), length);
+            m_data += length;
+        }
+        return true;
+    }
+
+    bool GetVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && m_data < m_end; shift += 7) {
+            uint8_t byte = *m_data++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool GetSigned(int64_t& value) {
+        uint64_t raw = 0;
+        if (!GetVarint(raw)) {
+            return false;
+        }
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    // Each reference copies its table entry, so the copies are charged
+    // against a budget: a small body can't expand without bound
+    bool GetString(std::string& value) {
+        uint64_t index = 0;
+        if (!GetVarint(index) || index >= m_strings.size() ||
+            m_strings[index].size() > m_stringBudget) {
+            return false;
+        }
+        m_stringBudget -= m_strings[index].size();
+        value = m_strings[index];
+        return true;
+    }
+
+    bool GetFraction(float& value) {
+        uint64_t raw = 0;
+        if (!GetVarint(raw)) {
+            return false;
+        }
+        value = raw / 1000.0f;
+        return true;
+    }
+
+    bool GetInt(int& value) {
+        int64_t raw = 0;
+        if (!GetSigned(raw)) {
+            return false;
+        }
+        value = static_cast<int>(raw);
+        return true;
+    }
+
+    bool AtEnd() const {
+        return m_data == m_end;
+    }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    std::vector<std::string> m_strings;
+    size_t m_stringBudget;
+};
+
+int64_t Seconds(const std::chrono::system_clock::time_point& time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point FromSeconds(int64_t seconds) {
+    return std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+}
+
+// Reads a non-negative integer following "key": in a JSON response
+bool ExtractUnsigned(const std::string& json, const std::string& key, uint64_t& value) {
+    size_t pos = json.find("\"" + key + "\":");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos = json.find_first_not_of(" \t\r\n", pos + key.size() + 3);
+    if (pos == std::string::npos || !std::isdigit(static_cast<unsigned char>(json[pos]))) {
+        return false;
+    }
+    try {
+        value = std::stoull(json.substr(pos));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+std::string DecodeChunked(const std::string& body) {
+    std::string decoded;
+    size_t pos = 0;
+    while (pos < body.size()) {
+        size_t line_end = body.find("\r\n", pos);
+        if (line_end == std::string::npos) {
+            break;
+        }
+        size_t length = 0;
+        try {
+            length = std::stoul(body.substr(pos, line_end - pos), nullptr, 16);
+        } catch (...) {
+            break;
+        }
+        if (length == 0) {
+            break;
+        }
+        decoded.append(body, line_end + 2, length);
+        pos = line_end + 2 + length + 2;
+    }
+    return decoded;
+}
+
+std::string DefaultWorkstationId() {
+    char name[256] = {};
+    std::string id = (gethostname(name, sizeof(name) - 1) == 0 && name[0]) ? name : "workstation";
+    for (char& c : id) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') {
+            c = '_';
+        }
+    }
+    return id.substr(0, replication_utils::MAX_WORKSTATION_ID);
+}
+
+} // namespace
+
+namespace replication_utils {
+
+std::vector<uint8_t> EncodeDelta(const ReplicationDelta& delta) {
+    DeltaWriter writer;
+    writer.PutString(delta.workstation);
+    writer.PutVarint(delta.source_id);
+    writer.PutVarint(delta.base);
+    writer.PutVarint(delta.sequence);
+
+    // Ids ascend within each list, and timestamps mostly do: both are
+    // written as differences from the previous record
+    uint64_t previous_id = delta.base;
+    int64_t previous_time = 0;
+    writer.PutVarint(delta.activities.size());
+    for (const auto& activity : delta.activities) {
+        writer.PutVarint(activity.id - previous_id);
+        writer.PutSigned(Seconds(activity.timestamp) - previous_time);
+        writer.PutString(activity.application_name);
+        writer.PutString(activity.window_title);
+        writer.PutString(activity.event_type);
+        writer.PutVarint(static_cast<uint64_t>(std::max<int64_t>(activity.duration.count(), 0)));
+        previous_id = activity.id;
+        previous_time = Seconds(activity.timestamp);
+    }
+
+    previous_id = delta.base;
+    previous_time = 0;
+    writer.PutVarint(delta.analyses.size());
+    for (const auto& analysis : delta.analyses) {
+        writer.PutVarint(analysis.id - previous_id);
+        writer.PutSigned(Seconds(analysis.timestamp) - previous_time);
+        writer.PutString(analysis.application_name);
+        writer.PutString(analysis.window_title);
+        writer.PutString(analysis.extracted_text);
+        writer.PutVarint(analysis.keywords.size());
+        for (const auto& keyword : analysis.keywords) {
+            writer.PutString(keyword);
+        }
+        writer.PutFraction(analysis.ocr_confidence);
+        writer.PutSigned(static_cast<int>(analysis.content_type));
+        writer.PutSigned(static_cast<int>(analysis.work_category));
+        writer.PutSigned(static_cast<int>(analysis.priority));
+        writer.PutVarint((analysis.is_productive ? 1 : 0) | (analysis.is_focused_work ? 2 : 0));
+        writer.PutFraction(analysis.ai_confidence);
+        writer.PutSigned(analysis.distraction_level);
+        writer.PutVarint(static_cast<uint64_t>(std::max<int64_t>(analysis.processing_time.count(), 0)));
+        previous_id = analysis.id;
+        previous_time = Seconds(analysis.timestamp);
+    }
+
+    std::vector<uint8_t> raw = writer.Finish();
+
+    std::vector<uint8_t> encoded(DELTA_MAGIC, DELTA_MAGIC + 4);
+    encoded.push_back(DELTA_VERSION);
+    uint8_t flags = 0;
+    std::vector<uint8_t> payload;
+#ifdef HAVE_ZLIB
+    uLongf length = compressBound(static_cast<uLong>(raw.size()));
+    payload.resize(length);
+    if (compress2(payload.data(), &length, raw.data(), static_cast<uLong>(raw.size()), 6) == Z_OK &&
+        length < raw.size()) {
+        payload.resize(length);
+        flags |= FLAG_DEFLATED;
+    }
+#endif
+    if (!(flags & FLAG_DEFLATED)) {
+        payload.swap(raw);
+    }
+    encoded.push_back(flags);
+
+    // Uncompressed size, so the receiver can size its buffer
+    uint64_t size = (flags & FLAG_DEFLATED) ? raw.size() : payload.size();
+    while (size >= 0x80) {
+        encoded.push_back(static_cast<uint8_t>(size | 0x80));
+        size >>= 7;
+    }
+    encoded.push_back(static_cast<uint8_t>(size));
+    encoded.insert(encoded.end(), payload.begin(), payload.end());
+    return encoded;
+}
+
+bool DecodeDelta(const std::vector<uint8_t>& encoded, ReplicationDelta& delta) {
+    if (encoded.size() < 7 || std::memcmp(encoded.data(), DELTA_MAGIC, 4) != 0 ||
+        encoded[4] != DELTA_VERSION) {
+        return false;
+    }
+    const uint8_t flags = encoded[5];
+    DeltaReader header(encoded.data() + 6, encoded.size() - 6);
+    uint64_t raw_size = 0;
+    if (!header.GetVarint(raw_size) || raw_size > MAX_DELTA_BYTES) {
+        return false;
+    }
+    size_t header_size = 6;
+    for (uint64_t v = raw_size; ; v >>= 7) {
+        header_size++;
+        if (v < 0x80) {
+            break;
+        }
+    }
+
+    std::vector<uint8_t> raw;
+    const uint8_t* body = encoded.data() + header_size;
+    size_t body_size = encoded.size() - header_size;
+    if (flags & FLAG_DEFLATED) {
+#ifdef HAVE_ZLIB
+        raw.resize(raw_size);
+        uLongf length = static_cast<uLongf>(raw_size);
+        if (uncompress(raw.data(), &length, body, static_cast<uLong>(body_size)) != Z_OK ||
+            length != raw_size) {
+            return false;
+        }
+        body = raw.data();
+        body_size = raw.size();
+#else
+        std::cerr << "Replication delta is compressed but zlib is unavailable" << std::endl;
+        return false;
+#endif
+    } else if (body_size != raw_size) {
+        return false;
+    }
+
+    DeltaReader reader(body, body_size);
+    ReplicationDelta decoded;
+    uint64_t activity_count = 0;
+    if (!reader.ReadTable() || !reader.GetString(decoded.workstation) ||
+        !reader.GetVarint(decoded.source_id) || !reader.GetVarint(decoded.base) ||
+        !reader.GetVarint(decoded.sequence) || decoded.sequence < decoded.base ||
+        !reader.GetVarint(activity_count) || activity_count > body_size) {
+        return false;
+    }
+
+    // Every id must lie in (base, sequence] and ascend
+    uint64_t previous_id = decoded.base;
+    int64_t previous_time = 0;
+    for (uint64_t i = 0; i < activity_count; ++i) {
+        WindowActivityRecord activity;
+        uint64_t id_delta = 0, duration = 0;
+        int64_t time_delta = 0;
+        if (!reader.GetVarint(id_delta) || id_delta == 0 || id_delta > decoded.sequence - previous_id ||
+            !reader.GetSigned(time_delta) || !reader.GetString(activity.application_name) ||
+            !reader.GetString(activity.window_title) || !reader.GetString(activity.event_type) ||
+            !reader.GetVarint(duration)) {
+            return false;
+        }
+        previous_id += id_delta;
+        previous_time += time_delta;
+        activity.id = previous_id;
+        activity.timestamp = FromSeconds(previous_time);
+        activity.duration = std::chrono::milliseconds(duration);
+        decoded.activities.push_back(std::move(activity));
+    }
+
+    uint64_t analysis_count = 0;
+    if (!reader.GetVarint(analysis_count) || analysis_count > body_size) {
+        return false;
+    }
+    previous_id = decoded.base;
+    previous_time = 0;
+    for (uint64_t i = 0; i < analysis_count; ++i) {
+        ContentAnalysisRecord analysis;
+        uint64_t id_delta = 0, keyword_count = 0, flags_bits = 0, processing = 0;
+        int64_t time_delta = 0;
+        int content_type = 0, work_category = 0, priority = 0;
+        if (!reader.GetVarint(id_delta) || id_delta == 0 || id_delta > decoded.sequence - previous_id ||
+            !reader.GetSigned(time_delta) || !reader.GetString(analysis.application_name) ||
+            !reader.GetString(analysis.window_title) || !reader.GetString(analysis.extracted_text) ||
+            !reader.GetVarint(keyword_count) || keyword_count > body_size) {
+            return false;
+        }
+        for (uint64_t k = 0; k < keyword_count; ++k) {
+            std::string keyword;
+            if (!reader.GetString(keyword)) {
+                return false;
+            }
+            analysis.keywords.push_back(std::move(keyword));
+        }
+        if (!reader.GetFraction(analysis.ocr_confidence) || !reader.GetInt(content_type) ||
+            !reader.GetInt(work_category) || !reader.GetInt(priority) ||
+            !reader.GetVarint(flags_bits) || !reader.GetFraction(analysis.ai_confidence) ||
+            !reader.GetInt(analysis.distraction_level) || !reader.GetVarint(processing)) {
+            return false;
+        }
+        previous_id += id_delta;
+        previous_time += time_delta;
+        analysis.id = previous_id;
+        analysis.timestamp = FromSeconds(previous_time);
+        analysis.content_type = static_cast<ContentType>(content_type);
+        analysis.work_category = static_cast<WorkCategory>(work_category);
+        analysis.priority = static_cast<ActivityPriority>(priority);
+        analysis.is_productive = flags_bits & 1;
+        analysis.is_focused_work = flags_bits & 2;
+        analysis.processing_time = std::chrono::milliseconds(processing);
+        decoded.analyses.push_back(std::move(analysis));
+    }
+
+    if (!reader.AtEnd()) {
+        return false;
+    }
+    delta = std::move(decoded);
+    return true;
+}
+
+bool IsValidWorkstationId(const std::string& id) {
+    if (id.empty() || id.size() > MAX_WORKSTATION_ID) {
+        return false;
+    }
+    for (char c : id) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string PositionKey(const std::string& workstation, uint64_t source_id) {
+    return "replication.position." + workstation + "." + std::to_string(source_id);
+}
+
+bool IsAuthorized(const std::string& authorization, const std::string& token) {
+    const std::string expected = "Bearer " + token;
+    if (token.empty() || authorization.size() != expected.size()) {
+        return false;
+    }
+    unsigned char difference = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        difference |= static_cast<unsigned char>(authorization[i] ^ expected[i]);
+    }
+    return difference == 0;
+}
+
+bool ParseHttpUrl(const std::string& url, std::string& host, int& port, std::string& path) {
+    const std::string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0) {
+        return false;
+    }
+    std::string rest = url.substr(scheme.size());
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    path = (slash == std::string::npos) ? "" : rest.substr(slash);
+    if (!path.empty() && path.back() == '/') {
+        path.pop_back();
+    }
+
+    size_t colon = authority.rfind(':');
+    host = authority.substr(0, colon);
+    port = 80;
+    if (colon != std::string::npos) {
+        try {
+            port = std::stoi(authority.substr(colon + 1));
+        } catch (...) {
+            return false;
+        }
+    }
+    return !host.empty() && port > 0 && port < 65536;
+}
+
+bool HttpRequest(const std::string& host, int port, const std::string& method,
+                 const std::string& path, const std::string& content_type,
+                 const std::vector<uint8_t>& body, std::chrono::milliseconds timeout,
+                 int& status, std::string& response, const std::string& token) {
+    status = 0;
+    response.clear();
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        std::cerr << "Cannot resolve " << host << std::endl;
+        return false;
+    }
+
+    // Non-blocking connect, so an unreachable host fails within the timeout
+    int fd = -1;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        int result = connect(fd, address->ai_addr, address->ai_addrlen);
+        if (result != 0 && errno == EINPROGRESS) {
+            pollfd pending = {fd, POLLOUT, 0};
+            int error = 0;
+            socklen_t length = sizeof(error);
+            result = (poll(&pending, 1, static_cast<int>(timeout.count())) == 1 &&
+                      getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0) ? 0 : -1;
+        }
+        if (result != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    timeval tv;
+    tv.tv_sec = timeout.count() / 1000;
+    tv.tv_usec = (timeout.count() % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    std::ostringstream request;
+    request << method << " " << path << " HTTP/1.1\r\n"
+            << "Host: " << host << ":" << port << "\r\n"
+            << "Connection: close\r\n";
+    if (!content_type.empty()) {
+        request << "Content-Type: " << content_type << "\r\n";
+    }
+    if (!token.empty()) {
+        request << "Authorization: Bearer " << token << "\r\n";
+    }
+    request << "Content-Length: " << body.size() << "\r\n\r\n";
+    std::string head = request.str();
+
+    bool sent = SendAll(fd, head.data(), head.size()) &&
+                SendAll(fd, reinterpret_cast<const char*>(body.data()), body.size());
+
+    std::string raw;
+    char buffer[8192];
+    while (sent) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        raw.append(buffer, received);
+    }
+    close(fd);
+
+    size_t header_end = raw.find("\r\n\r\n");
+    if (!sent || header_end == std::string::npos || raw.compare(0, 5, "HTTP/") != 0) {
+        return false;
+    }
+    size_t space = raw.find(' ');
+    try {
+        status = std::stoi(raw.substr(space + 1, 3));
+    } catch (...) {
+        return false;
+    }
+
+    std::string headers = raw.substr(0, header_end);
+    std::transform(headers.begin(), headers.end(), headers.begin(), ::tolower);
+    response = raw.substr(header_end + 4);
+    if (headers.find("transfer-encoding: chunked") != std::string::npos) {
+        response = DecodeChunked(response);
+    }
+    return true;
+}
+
+} // namespace replication_utils
+
+// ReplicationClient
+
+class ReplicationClient::Impl {
+public:
+    Impl() : m_running(false), m_stopping(false), m_sourceId(0), m_port(0) {}
+
+    ~Impl() {
+        Stop();
+    }
+
+    bool Initialize(const ReplicationConfig& config, std::shared_ptr<EncryptedStorageManager> storage) {
+        if (!config.IsValid() || !storage || !storage->IsReady()) {
+            std::cerr << "Invalid replication configuration" << std::endl;
+            return false;
+        }
+        m_config = config;
+        if (m_config.workstation_id.empty()) {
+            m_config.workstation_id = DefaultWorkstationId();
+        }
+        if (!replication_utils::IsValidWorkstationId(m_config.workstation_id)) {
+            std::cerr << "Invalid workstation id: " << m_config.workstation_id << std::endl;
+            return false;
+        }
+
+        std::string url_path;
+        if (!replication_utils::ParseHttpUrl(m_config.aggregator_url, m_host, m_port, url_path)) {
+            std::cerr << "Unsupported aggregator URL: " << m_config.aggregator_url << std::endl;
+            return false;
+        }
+        m_basePath = url_path + m_config.api_prefix + "/replication";
+        m_storage = storage;
+
+        // Identifies this database for as long as it exists
+        std::string source;
+        if (m_storage->GetStateValue(SOURCE_ID_KEY, source)) {
+            try {
+                m_sourceId = std::stoull(source);
+            } catch (...) {
+                m_sourceId = 0;
+            }
+        }
+        if (m_sourceId == 0) {
+            std::random_device random;
+            m_sourceId = (static_cast<uint64_t>(random()) << 32 | random()) >> 1;
+            m_sourceId = m_sourceId ? m_sourceId : 1;
+            if (!m_storage->SetStateValue(SOURCE_ID_KEY, std::to_string(m_sourceId))) {
+                std::cerr << "Failed to persist replication source id" << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << "Replicating " << m_config.workstation_id << " to " << m_config.aggregator_url
+                  << (m_config.include_text ? " (with text)" : "") << std::endl;
+        return true;
+    }
+
+    bool Start() {
+        if (!m_storage || m_running) {
+            return m_running;
+        }
+        m_stopping = false;
+        m_running = true;
+        m_thread = std::thread([this]() { Run(); });
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stopping = true;
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool IsRunning() const {
+        return m_running;
+    }
+
+    bool SyncOnce() {
+        std::lock_guard<std::mutex> sync_lock(m_syncMutex);
+        if (!m_storage) {
+            return false;
+        }
+
+        int status = 0;
+        std::string response;
+        uint64_t position = 0;
+        std::string query = "/position?workstation=" + m_config.workstation_id +
+                            "&source=" + std::to_string(m_sourceId);
+        if (!replication_utils::HttpRequest(m_host, m_port, "GET", m_basePath + query, "", {},
+                                            m_config.timeout, status, response, m_config.token) ||
+            status != 200 || !ExtractUnsigned(response, "sequence", position)) {
+            return Fail("position request failed", status);
+        }
+
+        while (true) {
+            ReplicationDelta delta;
+            delta.workstation = m_config.workstation_id;
+            delta.source_id = m_sourceId;
+            delta.base = position;
+            if (!m_storage->GetRecordsAfter(position, m_config.batch_records,
+                                            delta.activities, delta.analyses, delta.sequence)) {
+                return Fail("reading local records failed", 0);
+            }
+            if (delta.sequence == position) {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                m_stats.acknowledged_sequence = position;
+                return true;
+            }
+
+            if (!m_config.include_text) {
+                for (auto& activity : delta.activities) {
+                    activity.window_title.clear();
+                }
+                for (auto& analysis : delta.analyses) {
+                    analysis.window_title.clear();
+                    analysis.extracted_text.clear();
+                    analysis.keywords.clear();
+                }
+            }
+
+            std::vector<uint8_t> encoded = replication_utils::EncodeDelta(delta);
+            if (!replication_utils::HttpRequest(m_host, m_port, "POST", m_basePath + "/delta",
+                                                "application/octet-stream", encoded,
+                                                m_config.timeout, status, response, m_config.token) ||
+                (status != 200 && status != 409) ||
+                !ExtractUnsigned(response, "sequence", position)) {
+                return Fail("delta rejected", status);
+            }
+
+            // 409: the aggregator is behind the base we assumed (e.g. it
+            // was restored from a backup); continue from its position
+            if (status == 200) {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                m_stats.deltas_sent++;
+                m_stats.records_sent += delta.activities.size() + delta.analyses.size();
+                m_stats.bytes_sent += encoded.size();
+                m_stats.acknowledged_sequence = position;
+            }
+            if (m_stopping) {
+                return true;    // The next run resumes from the aggregator's position
+            }
+        }
+    }
+
+    Statistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_stats;
+    }
+
+private:
+    static constexpr const char* SOURCE_ID_KEY = "replication.source_id";
+
+    void Run() {
+        auto retry = std::chrono::seconds(1);
+        while (m_running) {
+            bool synced = SyncOnce();
+            auto wait = synced ? m_config.interval : std::min(retry, m_config.interval);
+            retry = synced ? std::chrono::seconds(1) : std::min(retry * 2, m_config.interval);
+
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, wait, [this]() { return !m_running; });
+        }
+    }
+
+    bool Fail(const char* what, int status) {
+        std::cerr << "Replication to " << m_config.aggregator_url << ": " << what;
+        if (status != 0) {
+            std::cerr << " (HTTP " << status << ")";
+        }
+        std::cerr << std::endl;
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.failures++;
+        return false;
+    }
+
+    ReplicationConfig m_config;
+    std::shared_ptr<EncryptedStorageManager> m_storage;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_stopping;
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::mutex m_syncMutex;             // One round at a time
+
+    uint64_t m_sourceId;
+    std::string m_host;
+    int m_port;
+    std::string m_basePath;
+
+    mutable std::mutex m_statsMutex;
+    Statistics m_stats;
+};
+
+ReplicationClient::ReplicationClient() : m_impl(std::make_unique<Impl>()) {}
+ReplicationClient::~ReplicationClient() = default;
+
+bool ReplicationClient::Initialize(const ReplicationConfig& config,
+                                   std::shared_ptr<EncryptedStorageManager> storage) {
+    return m_impl->Initialize(config, storage);
+}
+
+bool ReplicationClient::Start() {
+    return m_impl->Start();
+}
+
+void ReplicationClient::Stop() {
+    m_impl->Stop();
+}
+
+bool ReplicationClient::IsRunning() const {
+    return m_impl->IsRunning();
+}
+
+bool ReplicationClient::SyncOnce() {
+    return m_impl->SyncOnce();
+}
+
+ReplicationClient::Statistics ReplicationClient::GetStatistics() const {
+    return m_impl->GetStatistics();
+}
+
+} // namespace work_assistant
@@ -0,0 +1,129 @@
+#include "timeline_downsampling.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace work_assistant {
+namespace downsampling {
+
+std::vector<size_t> LargestTriangleThreeBuckets(const std::vector<TimelinePoint>& points,
+                                                size_t threshold) {
+    std::vector<size_t> sampled;
+    const size_t n = points.size();
+    if (threshold >= n || n <= 2) {
+        for (size_t i = 0; i < n; ++i) {
+            sampled.push_back(i);
+        }
+        return sampled;
+    }
+    if (threshold < 3) {
+        // Only the end points fit
+        sampled.push_back(0);
+        if (threshold == 2) {
+            sampled.push_back(n - 1);
+        }
+        return sampled;
+    }
+
+    // Seconds from the first point keep x well inside double precision
+    auto x = [&points](size_t i) {
+        return std::chrono::duration<double>(points[i].timestamp - points[0].timestamp).count();
+    };
+
+    // The inner n - 2 points are split into threshold - 2 buckets; each
+    // bucket keeps the point forming the largest triangle with the point
+    // kept before it and the average of the next bucket
+    const double every = static_cast<double>(n - 2) / (threshold - 2);
+    size_t a = 0;
+    sampled.reserve(threshold);
+    sampled.push_back(0);
+
+    for (size_t i = 0; i < threshold - 2; ++i) {
+        size_t next_start = static_cast<size_t>(std::floor((i + 1) * every)) + 1;
+        size_t next_end = std::min(static_cast<size_t>(std::floor((i + 2) * every)) + 1, n);
+        double avg_x = 0.0;
+        double avg_y = 0.0;
+        for (size_t j = next_start; j < next_end; ++j) {
+            avg_x += x(j);
+            avg_y += points[j].value;
+        }
+        size_t next_count = next_end - next_start;
+        avg_x /= next_count;
+        avg_y /= next_count;
+
+        size_t range_start = static_cast<size_t>(std::floor(i * every)) + 1;
+        size_t range_end = static_cast<size_t>(std::floor((i + 1) * every)) + 1;
+        double ax = x(a);
+        double ay = points[a].value;
+        double max_area = -1.0;
+        size_t chosen = range_start;
+        for (size_t j = range_start; j < range_end; ++j) {
+            double area = std::abs((ax - avg_x) * (points[j].value - ay) -
+                                   (ax - x(j)) * (avg_y - ay));
+            if (area > max_area) {
+                max_area = area;
+                chosen = j;
+            }
+        }
+
+        sampled.push_back(chosen);
+        a = chosen;
+    }
+
+    sampled.push_back(n - 1);
+    return sampled;
+}
+
+std::vector<TimelineBucket> AggregateBuckets(const std::vector<TimelinePoint>& points,
+                                             const std::chrono::system_clock::time_point& start,
+                                             const std::chrono::system_clock::time_point& end,
+                                             size_t bucket_count) {
+    std::vector<TimelineBucket> buckets;
+    if (bucket_count == 0 || end <= start) {
+        return buckets;
+    }
+
+    // In double: a year in clock ticks times the bucket count overflows int64
+    const double span = std::chrono::duration<double>(end - start).count();
+    const double width = span / bucket_count;
+    auto bucket_start = [&](size_t index) {
+        if (index >= bucket_count) {
+            return end;
+        }
+        return start + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<double>(width * index));
+    };
+
+    // (bucket, category) keeps the output in bucket order, then category
+    std::map<std::pair<size_t, int>, TimelineBucket> aggregates;
+    for (const auto& point : points) {
+        if (point.timestamp < start || point.timestamp > end) {
+            continue;
+        }
+        double offset = std::chrono::duration<double>(point.timestamp - start).count();
+        size_t index = std::min(static_cast<size_t>(offset / width), bucket_count - 1);
+
+        TimelineBucket& bucket = aggregates[{index, point.category}];
+        if (bucket.count == 0) {
+            bucket.start = bucket_start(index);
+            bucket.end = bucket_start(index + 1);
+            bucket.category = point.category;
+            bucket.min = point.value;
+            bucket.max = point.value;
+        }
+        bucket.count++;
+        bucket.min = std::min(bucket.min, point.value);
+        bucket.max = std::max(bucket.max, point.value);
+        bucket.avg += point.value;       // Sum until the pass is done
+    }
+
+    buckets.reserve(aggregates.size());
+    for (auto& [key, bucket] : aggregates) {
+        bucket.avg /= bucket.count;
+        buckets.push_back(bucket);
+    }
+    return buckets;
+}
+
+} // namespace downsampling
+} // namespace work_assistant
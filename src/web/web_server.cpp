@@ -1,5 +1,10 @@
 #include "web_server.h"
 #include "storage_engine.h"
+#include "memory_governor.h"
+#include "screen_capture.h"
+#include "semantic_search.h"
+#include "replication.h"
+#include "thread_pool.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -71,7 +76,8 @@ public:
     Impl() 
         : m_initialized(false)
         , m_running(false)
-        , m_websocket_manager(std::make_unique<WebSocketManager>()) {
+        , m_websocket_manager(std::make_unique<WebSocketManager>())
+        , m_memory_consumer(-1) {
     }
     
     bool Initialize(const WebServerConfig& config, 
@@ -93,6 +99,8 @@ public:
         m_config = config;
         m_storage = storage;
         
+        RegisterMemoryConsumer();
+        
 #if 0 // Disable Drogon temporarily
 #ifdef DROGON_ENABLED
         // Initialize Drogon framework
@@ -193,11 +201,17 @@ public:
     void Shutdown() {
         Stop();
         
+        if (m_memory_consumer >= 0) {
+            MemoryGovernor::GetInstance().UnregisterConsumer(m_memory_consumer);
+            m_memory_consumer = -1;
+        }
+        
         if (m_websocket_manager) {
             m_websocket_manager.reset();
         }
         
         m_storage.reset();
+        
         m_initialized = false;
         std::cout << "Web server shut down" << std::endl;
     }
@@ -276,6 +290,10 @@ public:
         // In a real implementation, update the running server
     }
     
+    void SetSemanticSearch(std::shared_ptr<SemanticSearch> search) {
+        m_semantic_search = std::move(search);
+    }
+    
     WebServer::WebServerStats GetStatistics() const {
         WebServer::WebServerStats stats;
         stats.total_requests = m_stats.total_requests;
@@ -285,6 +303,27 @@ public:
     }
     
 private:
+    // The offline WebSocket buffer is the web layer's only unbounded-ish pool
+    void RegisterMemoryConsumer() {
+        MemoryConsumer consumer;
+        consumer.name = "websocket_queue";
+        consumer.get_usage_bytes = []() { return websocket_utils::GetQueueMemoryUsage(); };
+        consumer.on_level_changed = [](MemoryPressureLevel level) {
+            switch (level) {
+                case MemoryPressureLevel::NORMAL:
+                    websocket_utils::SetQueueLimit(websocket_utils::DEFAULT_QUEUE_LIMIT);
+                    break;
+                case MemoryPressureLevel::MODERATE:
+                    websocket_utils::SetQueueLimit(websocket_utils::DEFAULT_QUEUE_LIMIT / 10);
+                    break;
+                case MemoryPressureLevel::CRITICAL:
+                    websocket_utils::SetQueueLimit(0);
+                    break;
+            }
+        };
+        m_memory_consumer = MemoryGovernor::GetInstance().RegisterConsumer(consumer);
+    }
+    
 #ifdef WEB_ENABLED
     void SetupRoutes() {
         auto api_prefix = m_config.api_prefix;
@@ -308,6 +347,26 @@ private:
             },
             {Get, Post});
         
+        // Several dashboard queries in one round trip
+        app().registerHandler(api_prefix + "/batch",
+            [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                HandleBatch(req, std::move(callback));
+            },
+            {Get, Post});
+        
+        // Screenshot thumbnail endpoints
+        app().registerHandler(api_prefix + "/screenshots",
+            [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                HandleScreenshotTimeline(req, std::move(callback));
+            },
+            {Get});
+        
+        app().registerHandler(api_prefix + "/screenshots/thumbnail",
+            [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                HandleScreenshotThumbnail(req, std::move(callback));
+            },
+            {Get});
+        
         // Search endpoints
         app().registerHandler(api_prefix + "/search",
             [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
@@ -315,6 +374,12 @@ private:
             },
             {Get, Post});
         
+        app().registerHandler(api_prefix + "/search/semantic",
+            [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                HandleSemanticSearch(req, std::move(callback));
+            },
+            {Get, Post});
+        
         // Export endpoints
         app().registerHandler(api_prefix + "/export",
             [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
@@ -329,6 +394,27 @@ private:
             },
             {Get});
         
+        app().registerHandler(api_prefix + "/system/budget",
+            [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                HandleResourceBudget(req, std::move(callback));
+            },
+            {Get});
+        
+        // Workstation deltas, aggregator mode only
+        if (m_config.accept_replication) {
+            app().registerHandler(api_prefix + "/replication/position",
+                [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                    HandleReplicationPosition(req, std::move(callback));
+                },
+                {Get});
+            
+            app().registerHandler(api_prefix + "/replication/delta",
+                [this](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                    HandleReplicationDelta(req, std::move(callback));
+                },
+                {Post});
+        }
+        
         // WebSocket endpoint
         if (m_config.enable_websocket) {
             app().registerHandler(api_prefix + "/ws",
@@ -351,28 +437,116 @@ private:
                                  std::function<void(const HttpResponsePtr&)>&& callback) {
         m_stats.total_requests++;
         
-        // Parse time range from request
-        auto start = std::chrono::system_clock::now() - std::chrono::hours(24);
-        auto end = std::chrono::system_clock::now();
+        std::chrono::system_clock::time_point start, end;
+        ParseTimeRange(req, start, end);
         
-        auto response = api_handlers::GetProductivitySummary(start, end, m_storage.get());
+        auto storage = m_storage;
+        RunAnalytics(req, std::move(callback), [storage, start, end](const CancellationCheck& cancelled) {
+            return api_handlers::GetProductivitySummary(start, end, storage.get(), cancelled);
+        });
+    }
+    
+    void HandleActivityTimeline(const HttpRequestPtr& req,
+                              std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
         
-        auto resp = HttpResponse::newHttpResponse();
-        resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
-        resp->setContentTypeCode(CT_APPLICATION_JSON);
-        resp->setBody(response.ToJson());
+        std::chrono::system_clock::time_point start, end;
+        ParseTimeRange(req, start, end);
         
-        callback(resp);
+        // A target point count alone asks for the shape-preserving sample
+        TimelineOptions options;
+        try {
+            std::string points_str = req->getParameter("points");
+            if (!points_str.empty()) {
+                options.points = std::stoul(points_str);
+                options.mode = "lttb";
+            }
+        } catch (...) {
+            options.points = 0;
+        }
+        if (!req->getParameter("mode").empty()) {
+            options.mode = req->getParameter("mode");
+        }
+        if (!req->getParameter("metric").empty()) {
+            options.metric = req->getParameter("metric");
+        }
+        
+        auto storage = m_storage;
+        RunAnalytics(req, std::move(callback), [storage, start, end, options](const CancellationCheck& cancelled) {
+            return api_handlers::GetActivityTimeline(start, end, storage.get(), options, cancelled);
+        });
     }
     
-    void HandleActivityTimeline(const HttpRequestPtr& req,
+    void HandleApplicationUsage(const HttpRequestPtr& req,
                               std::function<void(const HttpResponsePtr&)>&& callback) {
         m_stats.total_requests++;
         
+        std::chrono::system_clock::time_point start, end;
+        ParseTimeRange(req, start, end);
+        
+        auto storage = m_storage;
+        RunAnalytics(req, std::move(callback), [storage, start, end](const CancellationCheck& cancelled) {
+            return api_handlers::GetApplicationUsage(start, end, storage.get(), cancelled);
+        });
+    }
+    
+    // POST {"start", "end", "queries": {"<name>": {"type", "start", "end"}}}
+    // where type defaults to the name and the range to the batch's; or GET
+    // ?queries=summary,timeline&start=&end= with each name as its type
+    void HandleBatch(const HttpRequestPtr& req,
+                    std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
+        
+        std::chrono::system_clock::time_point start, end;
+        ParseTimeRange(req, start, end);
+        
+        std::vector<BatchSubQuery> queries;
+        auto body = req->getJsonObject();
+        if (body && body->isObject() && (*body)["queries"].isObject()) {
+            if (body->isMember("start")) {
+                start = web_utils::ParseTimestamp((*body)["start"].asString());
+            }
+            if (body->isMember("end")) {
+                end = web_utils::ParseTimestamp((*body)["end"].asString());
+            }
+            
+            const Json::Value& specs = (*body)["queries"];
+            for (const auto& name : specs.getMemberNames()) {
+                const Json::Value& spec = specs[name];
+                BatchSubQuery query;
+                query.name = name;
+                query.type = spec.isObject() ? spec.get("type", name).asString() : name;
+                query.start = spec.isObject() && spec.isMember("start")
+                    ? web_utils::ParseTimestamp(spec["start"].asString()) : start;
+                query.end = spec.isObject() && spec.isMember("end")
+                    ? web_utils::ParseTimestamp(spec["end"].asString()) : end;
+                queries.push_back(query);
+            }
+        } else {
+            std::istringstream names(req->getParameter("queries"));
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) {
+                    queries.push_back({name, name, start, end});
+                }
+            }
+        }
+        
+        auto storage = m_storage;
+        RunAnalytics(req, std::move(callback), [storage, queries](const CancellationCheck& cancelled) {
+            return api_handlers::ExecuteBatch(queries, storage.get(), cancelled);
+        });
+    }
+    
+    void HandleScreenshotTimeline(const HttpRequestPtr& req,
+                                std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
+        
         auto start = std::chrono::system_clock::now() - std::chrono::hours(24);
         auto end = std::chrono::system_clock::now();
         
-        auto response = api_handlers::GetActivityTimeline(start, end, m_storage.get());
+        auto response = api_handlers::GetScreenshotTimeline(
+            start, end, m_config.api_prefix + "/screenshots/thumbnail", m_storage.get());
         
         auto resp = HttpResponse::newHttpResponse();
         resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
@@ -382,19 +556,63 @@ private:
         callback(resp);
     }
     
-    void HandleApplicationUsage(const HttpRequestPtr& req,
-                              std::function<void(const HttpResponsePtr&)>&& callback) {
+    // GET .../screenshots/thumbnail?id=<capture>&width=<pixels>. Stored
+    // thumbnails never change, so the ETag is derived from the request
+    // alone and revalidation is answered without touching storage.
+    void HandleScreenshotThumbnail(const HttpRequestPtr& req,
+                                 std::function<void(const HttpResponsePtr&)>&& callback) {
         m_stats.total_requests++;
         
-        auto start = std::chrono::system_clock::now() - std::chrono::hours(24);
-        auto end = std::chrono::system_clock::now();
+        uint64_t capture_id = 0;
+        int width = capture_utils::THUMBNAIL_WIDTHS[1];
+        try {
+            capture_id = std::stoull(req->getParameter("id"));
+            std::string width_str = req->getParameter("width");
+            if (!width_str.empty()) {
+                width = std::stoi(width_str);
+            }
+        } catch (...) {
+            capture_id = 0;
+        }
+        
+        // Snap to a pyramid level so every width maps onto a few cache entries
+        int level = capture_utils::THUMBNAIL_WIDTHS[0];
+        for (int level_width : capture_utils::THUMBNAIL_WIDTHS) {
+            level = level_width;
+            if (level_width >= width) {
+                break;
+            }
+        }
+        
+        const std::string etag = "\"thumb-" + std::to_string(capture_id) + "-" + std::to_string(level) + "\"";
+        const std::string if_none_match = req->getHeader("If-None-Match");
+        if (capture_id > 0 && !if_none_match.empty() &&
+            (if_none_match == "*" || if_none_match.find(etag) != std::string::npos)) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k304NotModified);
+            resp->addHeader("ETag", etag);
+            resp->addHeader("Cache-Control", THUMBNAIL_CACHE_CONTROL);
+            callback(resp);
+            return;
+        }
         
-        auto response = api_handlers::GetApplicationUsage(start, end, m_storage.get());
+        ScreenThumbnail thumbnail;
+        auto response = api_handlers::GetScreenshotThumbnail(capture_id, level, m_storage.get(), thumbnail);
         
         auto resp = HttpResponse::newHttpResponse();
-        resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
-        resp->setContentTypeCode(CT_APPLICATION_JSON);
-        resp->setBody(response.ToJson());
+        if (!response.success) {
+            resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            resp->setBody(response.ToJson());
+            callback(resp);
+            return;
+        }
+        
+        resp->setStatusCode(k200OK);
+        resp->setContentTypeCode(CT_IMAGE_PNG);
+        resp->addHeader("ETag", etag);
+        resp->addHeader("Cache-Control", THUMBNAIL_CACHE_CONTROL);
+        resp->setBody(std::string(thumbnail.data.begin(), thumbnail.data.end()));
         
         callback(resp);
     }
@@ -415,7 +633,111 @@ private:
             max_results = 50;
         }
         
-        auto response = api_handlers::SearchContent(query, max_results, m_storage.get());
+        auto response = api_handlers::SearchContent(query, max_results, m_storage.get(),
+                                                    req->getParameter("app"));
+        
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->setBody(response.ToJson());
+        
+        callback(resp);
+    }
+    
+    void HandleReplicationPosition(const HttpRequestPtr& req,
+                                   std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
+        if (!AuthorizeReplication(req, callback)) {
+            return;
+        }
+        
+        uint64_t source_id = 0;
+        try {
+            source_id = std::stoull(req->getParameter("source"));
+        } catch (...) {
+            source_id = 0;
+        }
+        
+        auto response = api_handlers::GetReplicationPosition(req->getParameter("workstation"),
+                                                             source_id, m_storage.get());
+        
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->setBody(response.ToJson());
+        
+        callback(resp);
+    }
+    
+    void HandleReplicationDelta(const HttpRequestPtr& req,
+                                std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
+        if (!AuthorizeReplication(req, callback)) {
+            return;
+        }
+        
+        auto body = req->body();
+        auto response = api_handlers::ApplyReplicationDelta(
+            std::vector<uint8_t>(body.begin(), body.end()), m_storage.get());
+        
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->setBody(response.ToJson());
+        
+        callback(resp);
+    }
+    
+    // The aggregator listens on all interfaces; only workstations holding
+    // the shared token may read positions or write deltas
+    bool AuthorizeReplication(const HttpRequestPtr& req,
+                              std::function<void(const HttpResponsePtr&)>& callback) {
+        if (replication_utils::IsAuthorized(req->getHeader("Authorization"), m_config.replication_token)) {
+            return true;
+        }
+        ApiResponse response;
+        response.success = false;
+        response.message = "Replication token required";
+        response.status_code = 401;
+        
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k401Unauthorized);
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->setBody(response.ToJson());
+        callback(resp);
+        return false;
+    }
+    
+    void HandleSemanticSearch(const HttpRequestPtr& req,
+                             std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
+        
+        std::string query = req->getParameter("q");
+        int max_results = 20;
+        
+        try {
+            std::string k_str = req->getParameter("k");
+            if (!k_str.empty()) {
+                max_results = std::stoi(k_str);
+            }
+        } catch (...) {
+            max_results = 20;
+        }
+        
+        // Whole history unless a range is given
+        auto start = std::chrono::system_clock::time_point();
+        auto end = std::chrono::system_clock::now();
+        std::string start_str = req->getParameter("start");
+        std::string end_str = req->getParameter("end");
+        if (!start_str.empty()) {
+            start = web_utils::ParseTimestamp(start_str);
+        }
+        if (!end_str.empty()) {
+            end = web_utils::ParseTimestamp(end_str);
+        }
+        
+        auto response = api_handlers::SemanticSearchContent(query, max_results, start, end,
+                                                            m_semantic_search.get());
         
         auto resp = HttpResponse::newHttpResponse();
         resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
@@ -458,6 +780,60 @@ private:
         callback(resp);
     }
     
+    void HandleResourceBudget(const HttpRequestPtr& req,
+                            std::function<void(const HttpResponsePtr&)>&& callback) {
+        m_stats.total_requests++;
+        
+        auto response = api_handlers::GetResourceBudget();
+        
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->setBody(response.ToJson());
+        
+        callback(resp);
+    }
+    
+    // Optional start/end parameters, defaulting to the last 24 hours
+    void ParseTimeRange(const HttpRequestPtr& req,
+                        std::chrono::system_clock::time_point& start,
+                        std::chrono::system_clock::time_point& end) {
+        end = std::chrono::system_clock::now();
+        start = end - std::chrono::hours(24);
+        std::string start_str = req->getParameter("start");
+        std::string end_str = req->getParameter("end");
+        if (!start_str.empty()) {
+            start = web_utils::ParseTimestamp(start_str);
+        }
+        if (!end_str.empty()) {
+            end = web_utils::ParseTimestamp(end_str);
+        }
+    }
+    
+    // Range analytics can scan months of records, so they run off the IO
+    // loop; the loop keeps serving and notices when the client disconnects,
+    // which cancels the scan
+    void RunAnalytics(const HttpRequestPtr& req,
+                      std::function<void(const HttpResponsePtr&)>&& callback,
+                      std::function<ApiResponse(const CancellationCheck&)> query) {
+        std::weak_ptr<trantor::TcpConnection> connection = req->connectionPtr();
+        CancellationCheck cancelled = [connection]() {
+            auto conn = connection.lock();
+            return !conn || !conn->connected();
+        };
+        
+        m_analytics_pool->enqueue([callback = std::move(callback), query = std::move(query), cancelled]() {
+            auto response = query(cancelled);
+            
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(static_cast<HttpStatusCode>(response.status_code));
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            resp->setBody(response.ToJson());
+            
+            callback(resp);
+        });
+    }
+    
     void HandleWebSocket(const HttpRequestPtr& req,
                         std::function<void(const HttpResponsePtr&)>&& callback) {
         // WebSocket implementation would go here
@@ -474,15 +850,23 @@ private:
     bool m_running;
     WebServerConfig m_config;
     std::shared_ptr<EncryptedStorageManager> m_storage;
+    std::shared_ptr<SemanticSearch> m_semantic_search;
     std::unique_ptr<WebSocketManager> m_websocket_manager;
     std::chrono::system_clock::time_point m_start_time;
+    int m_memory_consumer;
     
     struct {
         size_t total_requests = 0;
     } m_stats;
     
+    // Screenshots are private; a stored thumbnail is never rewritten
+    static constexpr const char* THUMBNAIL_CACHE_CONTROL = "private, max-age=31536000, immutable";
+    
 #ifdef WEB_ENABLED
     std::unique_ptr<std::thread> m_server_thread;
+    // Range queries parallelise internally; this only bounds how many run at once
+    std::unique_ptr<WorkAssistant::ThreadPool> m_analytics_pool =
+        std::make_unique<WorkAssistant::ThreadPool>(2);
 #endif
 };
 
@@ -551,6 +935,10 @@ void WebServer::OnAIAnalysis(const ContentAnalysis& analysis) {
     m_impl->OnAIAnalysis(analysis);
 }
 
+void WebServer::SetSemanticSearch(std::shared_ptr<SemanticSearch> search) {
+    m_impl->SetSemanticSearch(std::move(search));
+}
+
 WebServerConfig WebServer::GetConfig() const {
     return m_impl->GetConfig();
 }
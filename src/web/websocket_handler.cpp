@@ -6,6 +6,7 @@
 #include <unordered_set>
 #include <queue>
 #include <iomanip>
+#include <algorithm>
 
 #ifdef WEB_ENABLED
 #include <drogon/WebSocketController.h>
@@ -265,11 +266,10 @@ public:
         std::lock_guard<std::mutex> lock(m_mutex);
         
         m_message_queue.push(message);
+        m_queued_bytes += message.data.size();
         
         // Limit queue size to prevent memory growth
-        while (m_message_queue.size() > MAX_QUEUE_SIZE) {
-            m_message_queue.pop();
-        }
+        TrimLocked();
     }
     
     std::vector<WSMessage> GetQueuedMessages() {
@@ -280,20 +280,39 @@ public:
             messages.push_back(m_message_queue.front());
             m_message_queue.pop();
         }
+        m_queued_bytes = 0;
         
         return messages;
     }
     
+    void SetMaxSize(size_t max_size) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_size = max_size;
+        TrimLocked();
+    }
+    
+    size_t GetMemoryUsage() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queued_bytes + m_message_queue.size() * sizeof(WSMessage);
+    }
+    
     size_t GetQueueSize() const {
         std::lock_guard<std::mutex> lock(m_mutex);
         return m_message_queue.size();
     }
     
 private:
-    static constexpr size_t MAX_QUEUE_SIZE = 1000;
+    void TrimLocked() {
+        while (m_message_queue.size() > m_max_size) {
+            m_queued_bytes -= std::min(m_queued_bytes, m_message_queue.front().data.size());
+            m_message_queue.pop();
+        }
+    }
     
     mutable std::mutex m_mutex;
     std::queue<WSMessage> m_message_queue;
+    size_t m_max_size = websocket_utils::DEFAULT_QUEUE_LIMIT;
+    size_t m_queued_bytes = 0;
 };
 
 // WebSocket utility functions
@@ -327,6 +346,14 @@ std::vector<WSMessage> GetQueuedMessages() {
     return MessageQueue::GetInstance().GetQueuedMessages();
 }
 
+void SetQueueLimit(size_t max_messages) {
+    MessageQueue::GetInstance().SetMaxSize(max_messages);
+}
+
+size_t GetQueueMemoryUsage() {
+    return MessageQueue::GetInstance().GetMemoryUsage();
+}
+
 WSMessage CreateWindowEventMessage(const WindowEvent& event, const WindowInfo& info) {
     WSMessage message;
     message.type = WSMessageType::WINDOW_EVENT;
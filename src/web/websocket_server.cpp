@@ -5,10 +5,12 @@
 #include <cstring>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <arpa/inet.h>
 #include <unistd.h>
 #include <algorithm>
 #include <openssl/sha.h>
 #include <openssl/evp.h>
+#include <openssl/buffer.h>
 #include <iomanip>
 
 namespace work_assistant {
@@ -117,6 +119,10 @@ void SimpleWebSocketConnection::Send(const WSMessage& message) {
 }
 
 void SimpleWebSocketConnection::Send(const std::string& data) {
+    SendFrame(EncodeWebSocketFrame(data));
+}
+
+void SimpleWebSocketConnection::SendFrame(const std::string& frame) {
     if (!m_is_open) {
         return;
     }
@@ -124,7 +130,6 @@ void SimpleWebSocketConnection::Send(const std::string& data) {
     std::lock_guard<std::mutex> lock(m_send_mutex);
     
     try {
-        std::string frame = EncodeWebSocketFrame(data);
         ssize_t bytes_sent = ::send(m_socket_fd, frame.c_str(), frame.length(), MSG_NOSIGNAL);
         
         if (bytes_sent <= 0) {
@@ -373,6 +378,18 @@ void SimpleWebSocketServer::SendToClient(const std::string& client_id, const WSM
     }
 }
 
+void SimpleWebSocketServer::SendToClients(const std::vector<std::string>& client_ids, const std::string& payload) {
+    std::string frame = SimpleWebSocketConnection::EncodeWebSocketFrame(payload);
+    
+    std::lock_guard<std::mutex> lock(m_connections_mutex);
+    for (const auto& client_id : client_ids) {
+        auto it = m_connections.find(client_id);
+        if (it != m_connections.end() && it->second->IsOpen()) {
+            it->second->SendFrame(frame);
+        }
+    }
+}
+
 std::vector<std::string> SimpleWebSocketServer::GetConnectedClients() const {
     std::lock_guard<std::mutex> lock(m_connections_mutex);
     
@@ -573,6 +590,22 @@ WSMessage WSMessageBuilder::CreateProductivityUpdate(int score) {
     return message;
 }
 
+WSMessage WSMessageBuilder::CreateSystemStatus(const std::string& status) {
+    WSMessage message;
+    message.type = WSMessageType::SYSTEM_STATUS;
+    message.timestamp = std::chrono::system_clock::now();
+    
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"status\":\"" << status << "\",";
+    ss << "\"timestamp\":\"" << std::chrono::duration_cast<std::chrono::milliseconds>(
+        message.timestamp.time_since_epoch()).count() << "\"";
+    ss << "}";
+    
+    message.data = ss.str();
+    return message;
+}
+
 WSMessage WSMessageBuilder::CreateWelcomeMessage() {
     WSMessage message;
     message.type = WSMessageType::SYSTEM_STATUS;
@@ -604,35 +637,63 @@ void WebSocketClientManager::OnClientConnected(std::shared_ptr<IWebSocketConnect
 }
 
 void WebSocketClientManager::BroadcastWindowEvent(const WindowEvent& event, const WindowInfo& info) {
-    if (!m_server) return;
-    
-    WSMessage message = WSMessageBuilder::CreateWindowEvent(event, info);
-    
-    std::lock_guard<std::mutex> lock(m_subscriptions_mutex);
-    for (const auto& [client_id, subscriptions] : m_client_subscriptions) {
-        if (IsClientSubscribed(client_id, "window_events")) {
-            m_server->SendToClient(client_id, message);
-        }
-    }
+    WSMessageAttributes attributes;
+    attributes.event_type = "window_events";
+    attributes.application = info.process_name;
+    attributes.window_id = reinterpret_cast<uintptr_t>(info.window_handle);
+    Dispatch(WSMessageBuilder::CreateWindowEvent(event, info), attributes);
 }
 
-bool WebSocketClientManager::IsClientSubscribed(const std::string& client_id, const std::string& event_type) const {
-    auto it = m_client_subscriptions.find(client_id);
-    if (it == m_client_subscriptions.end()) {
-        return false;
-    }
+void WebSocketClientManager::BroadcastOCRResult(const OCRDocument& document, const WindowInfo& source) {
+    WSMessageAttributes attributes;
+    attributes.event_type = "ocr_results";
+    attributes.application = source.process_name;
+    attributes.window_id = reinterpret_cast<uintptr_t>(source.window_handle);
+    Dispatch(WSMessageBuilder::CreateOCRResult(document), attributes);
+}
+
+void WebSocketClientManager::BroadcastAIAnalysis(const ContentAnalysis& analysis, const WindowInfo& source) {
+    WSMessageAttributes attributes;
+    attributes.event_type = "ai_analysis";
+    attributes.application = analysis.application.empty() ? source.process_name : analysis.application;
+    attributes.content_type = static_cast<int>(analysis.content_type);
+    attributes.work_category = static_cast<int>(analysis.work_category);
+    attributes.priority = static_cast<int>(analysis.priority);
+    attributes.window_id = reinterpret_cast<uintptr_t>(source.window_handle);
+    Dispatch(WSMessageBuilder::CreateAIAnalysis(analysis), attributes);
+}
+
+void WebSocketClientManager::BroadcastProductivityUpdate(int score) {
+    WSMessageAttributes attributes;
+    attributes.event_type = "productivity_updates";
+    Dispatch(WSMessageBuilder::CreateProductivityUpdate(score), attributes);
+}
+
+void WebSocketClientManager::BroadcastSystemStatus(const std::string& status) {
+    WSMessageAttributes attributes;
+    attributes.event_type = "system_status";
+    Dispatch(WSMessageBuilder::CreateSystemStatus(status), attributes);
+}
+
+void WebSocketClientManager::Dispatch(const WSMessage& message, const WSMessageAttributes& attributes) {
+    if (!m_server) return;
     
-    const auto& subscriptions = it->second;
-    return std::find(subscriptions.begin(), subscriptions.end(), event_type) != subscriptions.end();
+    // The payload does not depend on the filter: serialize (and frame)
+    // once for every recipient
+    std::vector<std::string> recipients = m_subscriptions.GetRecipients(attributes);
+    if (!recipients.empty()) {
+        m_server->SendToClients(recipients, message.ToJSON());
+    }
 }
 
 void WebSocketClientManager::OnClientMessage(std::shared_ptr<IWebSocketConnection> connection, const WSMessage& message) {
     // Handle subscription messages
     if (message.type == WSMessageType::SUBSCRIPTION) {
-        // Parse subscription data (simplified)
-        // In a real implementation, you would properly parse JSON
-        std::vector<std::string> subscriptions = {"window_events", "ocr_results", "ai_analysis"};
-        HandleClientSubscription(connection->GetClientId(), subscriptions);
+        WSSubscriptionFilter filter = WSSubscriptionFilter::FromJSON(message.data);
+        if (filter.event_types.empty()) {
+            filter.event_types = {"window_events", "ocr_results", "ai_analysis"};
+        }
+        HandleClientSubscription(connection->GetClientId(), filter);
     }
 }
 
@@ -642,15 +703,31 @@ void WebSocketClientManager::OnClientDisconnected(const std::string& client_id)
 }
 
 void WebSocketClientManager::HandleClientSubscription(const std::string& client_id, const std::vector<std::string>& subscriptions) {
-    std::lock_guard<std::mutex> lock(m_subscriptions_mutex);
-    m_client_subscriptions[client_id] = subscriptions;
-    
-    LOG_INFO("Client " + client_id + " subscribed to " + std::to_string(subscriptions.size()) + " event types");
+    WSSubscriptionFilter filter;
+    filter.event_types = subscriptions;
+    HandleClientSubscription(client_id, filter);
+}
+
+void WebSocketClientManager::HandleClientSubscription(const std::string& client_id, const WSSubscriptionFilter& filter) {
+    m_subscriptions.Subscribe(client_id, filter);
+    LOG_INFO("Client " + client_id + " subscribed to " + std::to_string(filter.event_types.size()) +
+             " event types (" + std::to_string(m_subscriptions.GetGroupCount()) + " filter groups)");
 }
 
 void WebSocketClientManager::UnsubscribeClient(const std::string& client_id) {
-    std::lock_guard<std::mutex> lock(m_subscriptions_mutex);
-    m_client_subscriptions.erase(client_id);
+    m_subscriptions.Unsubscribe(client_id);
+}
+
+size_t WebSocketClientManager::GetSubscribedClientCount() const {
+    return m_subscriptions.GetClientCount();
+}
+
+size_t WebSocketClientManager::GetFilterGroupCount() const {
+    return m_subscriptions.GetGroupCount();
+}
+
+std::vector<std::string> WebSocketClientManager::GetClientSubscriptions(const std::string& client_id) const {
+    return m_subscriptions.GetEventTypes(client_id);
 }
 
 } // namespace work_assistant
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "websocket_subscription.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace work_assistant {
+
+namespace {
+
+// Event types a filter can name, one bit each
+const char* const FILTER_EVENT_TYPES[] = {
+    "window_events", "ocr_results", "ai_analysis", "productivity_updates", "system_status"
+};
+
+uint32_t EventTypeBit(const std::string& event_type) {
+    for (size_t i = 0; i < sizeof(FILTER_EVENT_TYPES) / sizeof(FILTER_EVENT_TYPES[0]); ++i) {
+        if (event_type == FILTER_EVENT_TYPES[i]) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+// Attributes each event type carries, by FILTER_EVENT_TYPES index
+enum : uint32_t {
+    CARRIES_APPLICATION = 1u << 0,
+    CARRIES_WINDOW = 1u << 1,
+    CARRIES_CONTENT_TYPE = 1u << 2,
+    CARRIES_WORK_CATEGORY = 1u << 3,
+    CARRIES_PRIORITY = 1u << 4
+};
+
+const uint32_t EVENT_ATTRIBUTES[] = {
+    CARRIES_APPLICATION | CARRIES_WINDOW,
+    CARRIES_APPLICATION | CARRIES_WINDOW,
+    CARRIES_APPLICATION | CARRIES_WINDOW | CARRIES_CONTENT_TYPE | CARRIES_WORK_CATEGORY | CARRIES_PRIORITY,
+    0,
+    0
+};
+
+uint32_t CarriedAttributes(uint32_t event_bit) {
+    for (size_t i = 0; i < sizeof(EVENT_ATTRIBUTES) / sizeof(EVENT_ATTRIBUTES[0]); ++i) {
+        if (event_bit == 1u << i) {
+            return EVENT_ATTRIBUTES[i];
+        }
+    }
+    return 0;
+}
+
+// Elements of the array value of "key" (strings unquoted); empty if absent
+std::vector<std::string> ExtractJsonArray(const std::string& json, const std::string& key) {
+    std::vector<std::string> values;
+    size_t pos = json.find("\"" + key + "\"");
+    if (pos == std::string::npos) {
+        return values;
+    }
+    pos = json.find_first_not_of(" \t\r\n:", pos + key.size() + 2);
+    if (pos == std::string::npos || json[pos] != '[') {
+        return values;
+    }
+    
+    std::string current;
+    bool in_string = false;
+    for (size_t i = pos + 1; i < json.length(); ++i) {
+        char c = json[i];
+        if (in_string) {
+            if (c == '\\' && i + 1 < json.length()) {
+                current += json[++i];
+            } else if (c == '"') {
+                in_string = false;
+            } else {
+                current += c;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == ',' || c == ']') {
+            if (!current.empty()) {
+                values.push_back(current);
+                current.clear();
+            }
+            if (c == ']') {
+                break;
+            }
+        } else if (!std::isspace(static_cast<unsigned char>(c))) {
+            current += c;
+        }
+    }
+    return values;
+}
+
+template <typename T>
+std::vector<T> ParseNumbers(const std::vector<std::string>& values) {
+    std::vector<T> numbers;
+    for (const auto& value : values) {
+        try {
+            numbers.push_back(static_cast<T>(std::stoull(value)));
+        } catch (...) {
+            // Skip non-numeric entries
+        }
+    }
+    return numbers;
+}
+
+} // namespace
+
+std::string WSSubscriptionFilter::Key() const {
+    // Sorted and de-duplicated, so equivalent filters compare equal
+    auto canonical = [](auto values) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        std::stringstream ss;
+        for (const auto& value : values) {
+            ss << value << ",";
+        }
+        return ss.str();
+    };
+    
+    std::stringstream key;
+    key << "e:" << canonical(event_types) << "|a:" << canonical(applications)
+        << "|c:" << canonical(content_types) << "|w:" << canonical(work_categories)
+        << "|p:" << min_priority << "|h:" << canonical(window_ids);
+    return key.str();
+}
+
+WSSubscriptionFilter WSSubscriptionFilter::FromJSON(const std::string& json) {
+    WSSubscriptionFilter filter;
+    filter.event_types = ExtractJsonArray(json, "events");
+    filter.applications = ExtractJsonArray(json, "applications");
+    filter.content_types = ParseNumbers<int>(ExtractJsonArray(json, "content_types"));
+    filter.work_categories = ParseNumbers<int>(ExtractJsonArray(json, "categories"));
+    filter.window_ids = ParseNumbers<uint64_t>(ExtractJsonArray(json, "windows"));
+    
+    size_t pos = json.find("\"min_priority\"");
+    if (pos != std::string::npos) {
+        pos = json.find_first_not_of(" \t\r\n:", pos + 14);
+        try {
+            filter.min_priority = pos != std::string::npos ? std::stoi(json.substr(pos)) : 0;
+        } catch (...) {
+            filter.min_priority = 0;
+        }
+    }
+    return filter;
+}
+
+WSCompiledFilter::WSCompiledFilter(const WSSubscriptionFilter& filter)
+    : m_filter(filter)
+    , m_event_mask(0)
+    , m_applications(filter.applications.begin(), filter.applications.end())
+    , m_window_ids(filter.window_ids.begin(), filter.window_ids.end()) {
+    for (const auto& event_type : filter.event_types) {
+        m_event_mask |= EventTypeBit(event_type);
+    }
+    for (int value : filter.content_types) {
+        if (value >= 0 && value < 64) {
+            m_content_types.set(value);
+        }
+    }
+    for (int value : filter.work_categories) {
+        if (value >= 0 && value < 64) {
+            m_work_categories.set(value);
+        }
+    }
+}
+
+bool WSCompiledFilter::Matches(const WSMessageAttributes& attributes) const {
+    const uint32_t event_bit = EventTypeBit(attributes.event_type);
+    if (!(m_event_mask & event_bit)) {
+        return false;
+    }
+    // An unknown value never satisfies a constraint on an attribute the
+    // event type carries
+    const uint32_t carried = CarriedAttributes(event_bit);
+    if ((carried & CARRIES_APPLICATION) && !m_applications.empty() &&
+        !m_applications.count(attributes.application)) {
+        return false;
+    }
+    if ((carried & CARRIES_CONTENT_TYPE) && m_content_types.any() &&
+        (attributes.content_type < 0 || attributes.content_type >= 64 ||
+         !m_content_types.test(attributes.content_type))) {
+        return false;
+    }
+    if ((carried & CARRIES_WORK_CATEGORY) && m_work_categories.any() &&
+        (attributes.work_category < 0 || attributes.work_category >= 64 ||
+         !m_work_categories.test(attributes.work_category))) {
+        return false;
+    }
+    if ((carried & CARRIES_PRIORITY) && m_filter.min_priority > 0 &&
+        attributes.priority < m_filter.min_priority) {
+        return false;
+    }
+    if ((carried & CARRIES_WINDOW) && !m_window_ids.empty() &&
+        (attributes.window_id == 0 || !m_window_ids.count(attributes.window_id))) {
+        return false;
+    }
+    return true;
+}
+
+void WSSubscriptionRegistry::Subscribe(const std::string& client_id, const WSSubscriptionFilter& filter) {
+    std::string key = filter.Key();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    UnsubscribeLocked(client_id);
+
+    auto& group = m_groups[key];
+    if (!group) {
+        group = std::make_shared<Group>(filter);
+    }
+    group->clients.push_back(client_id);
+    m_client_groups[client_id] = key;
+}
+
+void WSSubscriptionRegistry::Unsubscribe(const std::string& client_id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    UnsubscribeLocked(client_id);
+}
+
+void WSSubscriptionRegistry::UnsubscribeLocked(const std::string& client_id) {
+    auto it = m_client_groups.find(client_id);
+    if (it == m_client_groups.end()) {
+        return;
+    }
+
+    auto group = m_groups.find(it->second);
+    if (group != m_groups.end()) {
+        auto& clients = group->second->clients;
+        clients.erase(std::remove(clients.begin(), clients.end(), client_id), clients.end());
+        if (clients.empty()) {
+            m_groups.erase(group);
+        }
+    }
+    m_client_groups.erase(it);
+}
+
+std::vector<std::string> WSSubscriptionRegistry::GetRecipients(const WSMessageAttributes& attributes) const {
+    std::vector<std::string> recipients;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [key, group] : m_groups) {
+        if (group->filter.Matches(attributes)) {
+            recipients.insert(recipients.end(), group->clients.begin(), group->clients.end());
+        }
+    }
+    return recipients;
+}
+
+size_t WSSubscriptionRegistry::GetClientCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_client_groups.size();
+}
+
+size_t WSSubscriptionRegistry::GetGroupCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_groups.size();
+}
+
+std::vector<std::string> WSSubscriptionRegistry::GetEventTypes(const std::string& client_id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_client_groups.find(client_id);
+    if (it == m_client_groups.end()) {
+        return {};
+    }
+    return m_groups.at(it->second)->filter.GetFilter().event_types;
+}
+
+} // namespace work_assistant
@@ -0,0 +1,868 @@
+// Storage load generator and benchmark. Drives EncryptedStorageManager and
+// IStorageEngine with synthetic window events, OCR text and analyses, and
+// reports throughput, latency percentiles, bytes per record and write
+// amplification per workload as JSON.
+//
+//   storage_bench --workloads ingest,dashboard --records 50000 --output out.json
+//
+// Each workload runs against its own fresh database under --dir. Storage
+// logging goes to stderr; the JSON report goes to stdout or --output.
+
+#include "storage_engine.h"
+#include "command_line_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace work_assistant;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Samples 0..n-1 with probability proportional to 1/(rank+1)^s, which is
+// how app usage and word frequencies are distributed in practice
+class ZipfDistribution {
+public:
+    ZipfDistribution(size_t n, double s) {
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            total += 1.0 / std::pow(static_cast<double>(i + 1), s);
+            m_cumulative.push_back(total);
+        }
+        for (double& value : m_cumulative) {
+            value /= total;
+        }
+    }
+
+    size_t Sample(std::mt19937_64& rng) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        auto it = std::lower_bound(m_cumulative.begin(), m_cumulative.end(), u);
+        return std::min(static_cast<size_t>(it - m_cumulative.begin()), m_cumulative.size() - 1);
+    }
+
+private:
+    std::vector<double> m_cumulative;
+};
+
+struct AppProfile {
+    const char* process_name;
+    const char* title_pattern;      // %s is replaced with a topic word
+    ContentType content_type;
+    WorkCategory work_category;
+    bool productive;
+};
+
+// Ordered by typical share of screen time
+const AppProfile APP_PROFILES[] = {
+    {"code", "%s.cpp - WorkAssistant - Visual Studio Code", ContentType::CODE, WorkCategory::FOCUSED_WORK, true},
+    {"firefox", "%s - Search - Mozilla Firefox", ContentType::WEB_BROWSING, WorkCategory::RESEARCH, true},
+    {"slack", "#%s | Team - Slack", ContentType::CHAT, WorkCategory::COMMUNICATION, false},
+    {"gnome-terminal", "build: make %s", ContentType::DEVELOPMENT, WorkCategory::FOCUSED_WORK, true},
+    {"thunderbird", "Re: %s - Inbox - Thunderbird", ContentType::EMAIL, WorkCategory::COMMUNICATION, true},
+    {"chrome", "%s - Google Docs", ContentType::DOCUMENT, WorkCategory::PLANNING, true},
+    {"zoom", "Zoom Meeting - %s sync", ContentType::COMMUNICATION, WorkCategory::MEETING, true},
+    {"libreoffice", "%s report.ods - LibreOffice Calc", ContentType::PRODUCTIVITY, WorkCategory::ANALYSIS, true},
+    {"figma", "%s mockups - Figma", ContentType::DESIGN, WorkCategory::CREATIVE, true},
+    {"youtube", "%s - YouTube", ContentType::VIDEO, WorkCategory::BREAK, false},
+    {"reddit", "r/%s - Reddit", ContentType::SOCIAL_MEDIA, WorkCategory::BREAK, false},
+    {"evince", "%s specification.pdf", ContentType::DOCUMENT, WorkCategory::LEARNING, true},
+    {"nautilus", "%s - Files", ContentType::PRODUCTIVITY, WorkCategory::ADMINISTRATIVE, true},
+    {"spotify", "%s - Spotify", ContentType::ENTERTAINMENT, WorkCategory::BREAK, false},
+    {"steam", "%s - Steam", ContentType::GAME, WorkCategory::BREAK_TIME, false},
+};
+const size_t APP_COUNT = sizeof(APP_PROFILES) / sizeof(APP_PROFILES[0]);
+
+const char* SYLLABLES[] = {"ka", "lo", "mi", "ner", "tas", "vin", "dro", "pel", "su", "gra",
+                           "fen", "tor", "bli", "qua", "zen", "mar", "cu", "sto", "rim", "hex"};
+
+// Synthetic activity with realistic app, title and keyword distributions
+class WorkloadGenerator {
+public:
+    WorkloadGenerator(uint64_t seed, size_t vocabularySize)
+        : m_rng(seed), m_apps(APP_COUNT, 1.2), m_words(vocabularySize, 1.0) {
+        // Pronounceable pseudo-words keep text compressible like real prose
+        const size_t syllables = sizeof(SYLLABLES) / sizeof(SYLLABLES[0]);
+        for (size_t i = 0; i < vocabularySize; ++i) {
+            std::string word;
+            size_t value = i;
+            do {
+                word += SYLLABLES[value % syllables];
+                value /= syllables;
+            } while (value > 0);
+            m_vocabulary.push_back(word);
+        }
+    }
+
+    const AppProfile& NextApp() {
+        return APP_PROFILES[m_apps.Sample(m_rng)];
+    }
+
+    const std::string& NextWord() {
+        return m_vocabulary[m_words.Sample(m_rng)];
+    }
+
+    // A timestamp spread uniformly over the last `span`
+    std::chrono::system_clock::time_point NextTime(std::chrono::hours span) {
+        auto offset = std::uniform_int_distribution<int64_t>(
+            0, std::chrono::duration_cast<std::chrono::seconds>(span).count())(m_rng);
+        return std::chrono::system_clock::now() - std::chrono::seconds(offset);
+    }
+
+    std::string Title(const AppProfile& app) {
+        std::string title = app.title_pattern;
+        size_t at = title.find("%s");
+        return title.replace(at, 2, NextWord());
+    }
+
+    // Screen text: tens to hundreds of words, long-tailed
+    std::string Text() {
+        std::lognormal_distribution<double> length(4.5, 0.7);
+        size_t words = std::max<size_t>(5, std::min<size_t>(2000, static_cast<size_t>(length(m_rng))));
+        std::string text;
+        for (size_t i = 0; i < words; ++i) {
+            if (i > 0) {
+                text += (i % 12 == 0) ? '\n' : ' ';
+            }
+            text += NextWord();
+        }
+        return text;
+    }
+
+    std::vector<std::string> Keywords() {
+        std::vector<std::string> keywords;
+        size_t count = std::uniform_int_distribution<size_t>(2, 8)(m_rng);
+        for (size_t i = 0; i < count; ++i) {
+            keywords.push_back(NextWord());
+        }
+        return keywords;
+    }
+
+    WindowEvent MakeWindowEvent(WindowInfo& info) {
+        const AppProfile& app = NextApp();
+        WindowEvent event;
+        event.type = WindowEventType::WINDOW_FOCUSED;
+        event.timestamp = std::chrono::system_clock::now();
+        info.title = Title(app);
+        info.process_name = app.process_name;
+        info.class_name = app.process_name;
+        info.process_id = 1000 + static_cast<uint32_t>(&app - APP_PROFILES);
+        info.x = 0;
+        info.y = 0;
+        info.width = 1920;
+        info.height = 1080;
+        info.is_visible = true;
+        info.timestamp = event.timestamp;
+        event.window_info = info;
+        return event;
+    }
+
+    OCRDocument MakeOCRDocument() {
+        OCRDocument document;
+        document.full_text = Text();
+        document.overall_confidence = std::uniform_real_distribution<float>(0.6f, 0.99f)(m_rng);
+        document.timestamp = std::chrono::system_clock::now();
+        return document;
+    }
+
+    ContentAnalysis MakeAnalysis(std::chrono::hours span) {
+        const AppProfile& app = NextApp();
+        ContentAnalysis analysis;
+        analysis.timestamp = NextTime(span);
+        analysis.title = Title(app);
+        analysis.application = app.process_name;
+        analysis.extracted_text = Text();
+        analysis.keywords = Keywords();
+        analysis.content_type = app.content_type;
+        analysis.work_category = app.work_category;
+        analysis.is_productive = app.productive;
+        analysis.is_focused_work = app.work_category == WorkCategory::FOCUSED_WORK;
+        analysis.classification_confidence = std::uniform_real_distribution<float>(0.5f, 0.95f)(m_rng);
+        analysis.distraction_level = app.productive ? 1 : 6;
+        analysis.processing_time = std::chrono::milliseconds(std::uniform_int_distribution<int>(20, 400)(m_rng));
+        return analysis;
+    }
+
+    WindowActivityRecord MakeActivityRecord(std::chrono::hours span) {
+        const AppProfile& app = NextApp();
+        WindowActivityRecord activity;
+        activity.timestamp = NextTime(span);
+        activity.window_title = Title(app);
+        activity.application_name = app.process_name;
+        activity.process_id = 1000 + static_cast<uint32_t>(&app - APP_PROFILES);
+        activity.width = 1920;
+        activity.height = 1080;
+        activity.event_type = "focused";
+        activity.duration = std::chrono::milliseconds(std::uniform_int_distribution<int>(1000, 600000)(m_rng));
+        return activity;
+    }
+
+    ContentAnalysisRecord MakeAnalysisRecord(std::chrono::hours span, const std::string& session) {
+        ContentAnalysis analysis = MakeAnalysis(span);
+        ContentAnalysisRecord record;
+        record.timestamp = analysis.timestamp;
+        record.session_id = session;
+        record.window_title = analysis.title;
+        record.application_name = analysis.application;
+        record.extracted_text = analysis.extracted_text;
+        record.keywords = analysis.keywords;
+        record.content_type = analysis.content_type;
+        record.work_category = analysis.work_category;
+        record.is_productive = analysis.is_productive;
+        record.is_focused_work = analysis.is_focused_work;
+        record.ai_confidence = analysis.classification_confidence;
+        record.distraction_level = analysis.distraction_level;
+        record.processing_time = analysis.processing_time;
+        return record;
+    }
+
+    double Uniform() {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(m_rng);
+    }
+
+    std::mt19937_64& Rng() { return m_rng; }
+
+private:
+    std::mt19937_64 m_rng;
+    ZipfDistribution m_apps;
+    ZipfDistribution m_words;
+    std::vector<std::string> m_vocabulary;
+};
+
+// Logical bytes of a record: what the caller asked to store
+size_t LogicalBytes(const DataRecord& record) {
+    size_t bytes = record.data.size() + record.session_id.size();
+    for (const auto& entry : record.metadata) {
+        bytes += entry.first.size() + entry.second.size();
+    }
+    return bytes;
+}
+
+size_t LogicalBytes(const ContentAnalysis& analysis) {
+    ContentAnalysisRecord record;
+    record.window_title = analysis.title;
+    record.application_name = analysis.application;
+    record.extracted_text = analysis.extracted_text;
+    record.keywords = analysis.keywords;
+    return LogicalBytes(record.ToDataRecord());
+}
+
+// Bytes this process has caused to be written to storage, -1 if unknown
+int64_t ProcessWriteBytes() {
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    int64_t value = 0;
+    while (io >> key >> value) {
+        if (key == "write_bytes:") {
+            return value;
+        }
+    }
+    return -1;
+}
+
+struct LatencySummary {
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double p999_us = 0.0;
+    double max_us = 0.0;
+};
+
+class LatencyRecorder {
+public:
+    // Times fn and records it; returns fn's result
+    template <typename Fn>
+    auto Time(Fn&& fn) {
+        auto start = Clock::now();
+        auto result = fn();
+        m_samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        return result;
+    }
+
+    size_t Count() const { return m_samples.size(); }
+
+    LatencySummary Summarize() {
+        LatencySummary summary;
+        if (m_samples.empty()) {
+            return summary;
+        }
+        std::sort(m_samples.begin(), m_samples.end());
+        auto at = [this](double q) {
+            size_t index = static_cast<size_t>(std::ceil(q * m_samples.size())) - 1;
+            return m_samples[std::min(index, m_samples.size() - 1)];
+        };
+        double total = 0.0;
+        for (double sample : m_samples) {
+            total += sample;
+        }
+        summary.mean_us = total / m_samples.size();
+        summary.p50_us = at(0.50);
+        summary.p90_us = at(0.90);
+        summary.p99_us = at(0.99);
+        summary.p999_us = at(0.999);
+        summary.max_us = m_samples.back();
+        return summary;
+    }
+
+private:
+    std::vector<double> m_samples;
+};
+
+// One measured workload; operation kinds are reported separately
+struct PhaseResult {
+    std::string name;
+    bool ok = true;
+    double seconds = 0.0;
+    size_t records_written = 0;
+    size_t records_stored = 0;        // Rows the database gained, by its own count
+    size_t logical_bytes = 0;
+    int64_t disk_write_bytes = -1;
+    size_t database_bytes_before = 0;
+    size_t database_bytes_after = 0;
+    std::map<std::string, LatencyRecorder> operations;
+    std::map<std::string, double> extra;
+};
+
+struct BenchOptions {
+    std::string directory = "storage_bench_data";
+    size_t records = 20000;           // Written by ingest, preloaded by the read workloads
+    size_t operations = 500;          // Measured reads per read workload
+    size_t batch_size = 256;          // Records per IStorageEngine::StoreRecords call
+    double read_ratio = 0.9;          // Reads in the dashboard mix
+    int span_days = 14;               // Preloaded history
+    uint64_t seed = 42;
+    bool keep = false;
+};
+
+StorageConfig MakeStorageConfig(const std::string& path, int retentionDays) {
+    StorageConfig config;
+    config.storage_path = path;
+    config.database_name = "bench.db";
+    config.master_password = "storage_bench_password";
+    config.security_level = SecurityLevel::STANDARD;
+    config.data_retention_hours = std::chrono::hours(24 * retentionDays);
+    config.auto_cleanup = false;
+    return config;
+}
+
+class StorageBench {
+public:
+    explicit StorageBench(const BenchOptions& options)
+        : m_options(options), m_generator(options.seed, 4000) {}
+
+    bool Run(const std::string& workload) {
+        std::string path = (std::filesystem::path(m_options.directory) / workload).string();
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+        std::filesystem::create_directories(path, ec);
+
+        PhaseResult result;
+        result.name = workload;
+
+        std::cerr << "storage_bench: running " << workload << std::endl;
+        if (workload == "ingest") {
+            result.ok = RunIngest(path, result);
+        } else if (workload == "engine_ingest") {
+            result.ok = RunEngineIngest(path, result);
+        } else if (workload == "dashboard") {
+            result.ok = RunDashboard(path, result);
+        } else if (workload == "search") {
+            result.ok = RunSearch(path, result);
+        } else if (workload == "export") {
+            result.ok = RunExport(path, result);
+        } else if (workload == "retention") {
+            result.ok = RunRetention(path, result);
+        } else {
+            std::cerr << "storage_bench: unknown workload " << workload << std::endl;
+            return false;
+        }
+
+        if (!m_options.keep) {
+            std::filesystem::remove_all(path, ec);
+        }
+        m_results.push_back(std::move(result));
+        return m_results.back().ok;
+    }
+
+    std::string ToJson() {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3);
+        json << "{\n";
+        json << "  \"benchmark\": \"storage_bench\",\n";
+        json << "  \"seed\": " << m_options.seed << ",\n";
+        json << "  \"records\": " << m_options.records << ",\n";
+        json << "  \"operations\": " << m_options.operations << ",\n";
+        json << "  \"batch_size\": " << m_options.batch_size << ",\n";
+        json << "  \"span_days\": " << m_options.span_days << ",\n";
+        json << "  \"workloads\": [";
+        for (size_t i = 0; i < m_results.size(); ++i) {
+            PhaseResult& result = m_results[i];
+            size_t operations = 0;
+            for (auto& entry : result.operations) {
+                operations += entry.second.Count();
+            }
+            size_t growth = result.database_bytes_after > result.database_bytes_before
+                                ? result.database_bytes_after - result.database_bytes_before : 0;
+
+            json << (i > 0 ? "," : "") << "\n    {\n";
+            json << "      \"name\": \"" << result.name << "\",\n";
+            json << "      \"ok\": " << (result.ok ? "true" : "false") << ",\n";
+            json << "      \"seconds\": " << result.seconds << ",\n";
+            json << "      \"operations\": " << operations << ",\n";
+            json << "      \"ops_per_sec\": " << (result.seconds > 0 ? operations / result.seconds : 0.0) << ",\n";
+            json << "      \"records_written\": " << result.records_written << ",\n";
+            json << "      \"records_per_sec\": "
+                 << (result.seconds > 0 ? result.records_written / result.seconds : 0.0) << ",\n";
+            json << "      \"logical_bytes\": " << result.logical_bytes << ",\n";
+            json << "      \"database_bytes\": " << result.database_bytes_after << ",\n";
+            json << "      \"records_stored\": " << result.records_stored << ",\n";
+            json << "      \"bytes_per_record\": ";
+            if (result.records_stored > 0) {
+                json << static_cast<double>(growth) / result.records_stored;
+            } else {
+                json << "null";
+            }
+            json << ",\n";
+            // Disk writes per logical byte; file growth stands in when the
+            // kernel doesn't report I/O accounting
+            json << "      \"disk_write_bytes\": ";
+            if (result.disk_write_bytes >= 0) {
+                json << result.disk_write_bytes;
+            } else {
+                json << "null";
+            }
+            json << ",\n";
+            json << "      \"write_amplification\": ";
+            if (result.logical_bytes > 0) {
+                double written = result.disk_write_bytes > 0 ? static_cast<double>(result.disk_write_bytes)
+                                                             : static_cast<double>(growth);
+                json << written / result.logical_bytes;
+            } else {
+                json << "null";
+            }
+            json << ",\n";
+            for (const auto& entry : result.extra) {
+                json << "      \"" << entry.first << "\": " << entry.second << ",\n";
+            }
+            json << "      \"latency_us\": {";
+            bool first = true;
+            for (auto& entry : result.operations) {
+                LatencySummary summary = entry.second.Summarize();
+                json << (first ? "" : ",") << "\n        \"" << entry.first << "\": {"
+                     << "\"count\": " << entry.second.Count()
+                     << ", \"mean\": " << summary.mean_us
+                     << ", \"p50\": " << summary.p50_us
+                     << ", \"p90\": " << summary.p90_us
+                     << ", \"p99\": " << summary.p99_us
+                     << ", \"p999\": " << summary.p999_us
+                     << ", \"max\": " << summary.max_us << "}";
+                first = false;
+            }
+            json << (first ? "" : "\n      ") << "}\n";
+            json << "    }";
+        }
+        json << "\n  ]\n}\n";
+        return json.str();
+    }
+
+private:
+    std::chrono::hours Span() const {
+        return std::chrono::hours(24 * m_options.span_days);
+    }
+
+    // Starts the measured part of a phase
+    // countRecords, when given, reads the database's record count so the
+    // phase reports what was stored rather than what was attempted
+    void Begin(const std::string& path, PhaseResult& result,
+               std::function<size_t()> countRecords = nullptr) {
+        m_countRecords = std::move(countRecords);
+        m_recordsStart = m_countRecords ? m_countRecords() : 0;
+        result.database_bytes_before = storage_utils::GetDirectorySize(path);
+        m_writeBytesStart = ProcessWriteBytes();
+        m_phaseStart = Clock::now();
+    }
+
+    void End(const std::string& path, PhaseResult& result) {
+        result.seconds = std::chrono::duration<double>(Clock::now() - m_phaseStart).count();
+        int64_t written = ProcessWriteBytes();
+        if (written >= 0 && m_writeBytesStart >= 0) {
+            result.disk_write_bytes = written - m_writeBytesStart;
+        }
+        result.database_bytes_after = storage_utils::GetDirectorySize(path);
+        if (m_countRecords) {
+            size_t records = m_countRecords();
+            result.records_stored = records > m_recordsStart ? records - m_recordsStart : 0;
+            m_countRecords = nullptr;
+        }
+    }
+
+    // History for the read workloads, written in engine-sized batches
+    bool Preload(EncryptedStorageManager& manager) {
+        std::vector<WindowActivityRecord> activities;
+        std::vector<ContentAnalysisRecord> analyses;
+        const std::string session = manager.GetCurrentSessionId();
+        for (size_t i = 0; i < m_options.records; ++i) {
+            if (i % 2 == 0) {
+                activities.push_back(m_generator.MakeActivityRecord(Span()));
+            } else {
+                analyses.push_back(m_generator.MakeAnalysisRecord(Span(), session));
+            }
+            if (activities.size() + analyses.size() >= m_options.batch_size || i + 1 == m_options.records) {
+                if (!manager.StoreBatch(activities, analyses)) {
+                    std::cerr << "storage_bench: preload failed" << std::endl;
+                    return false;
+                }
+                activities.clear();
+                analyses.clear();
+            }
+        }
+        return true;
+    }
+
+    bool OpenManager(EncryptedStorageManager& manager, const std::string& path, int retentionDays) {
+        if (!manager.Initialize(MakeStorageConfig(path, retentionDays)) || !manager.StartSession("storage_bench")) {
+            std::cerr << "storage_bench: failed to open storage at " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Application write path: one record per call, as captured
+    bool RunIngest(const std::string& path, PhaseResult& result) {
+        EncryptedStorageManager manager;
+        if (!OpenManager(manager, path, m_options.span_days * 2)) {
+            return false;
+        }
+
+        Begin(path, result, [&manager]() { return manager.GetStatistics().total_records; });
+        bool ok = true;
+        for (size_t i = 0; i < m_options.records && ok; ++i) {
+            // Roughly what a session produces: a window event per focus
+            // change, with OCR and analysis for a subset of screens
+            double pick = m_generator.Uniform();
+            if (pick < 0.6) {
+                WindowInfo info;
+                WindowEvent event = m_generator.MakeWindowEvent(info);
+                ok = result.operations["store_window_event"].Time([&]() {
+                    return manager.StoreWindowEvent(event, info);
+                });
+                WindowActivityRecord activity;
+                activity.window_title = info.title;
+                activity.application_name = info.process_name;
+                activity.event_type = "focused";
+                result.logical_bytes += LogicalBytes(activity.ToDataRecord());
+            } else if (pick < 0.8) {
+                OCRDocument document = m_generator.MakeOCRDocument();
+                ok = result.operations["store_ocr_result"].Time([&]() {
+                    return manager.StoreOCRResult(document, "storage_bench") != 0;
+                });
+                result.logical_bytes += document.full_text.size();
+            } else {
+                ContentAnalysis analysis = m_generator.MakeAnalysis(std::chrono::hours(1));
+                ok = result.operations["store_ai_analysis"].Time([&]() {
+                    return manager.StoreAIAnalysis(analysis) != 0;
+                });
+                result.logical_bytes += LogicalBytes(analysis);
+            }
+            result.records_written += ok ? 1 : 0;
+        }
+        End(path, result);
+
+        manager.Shutdown();
+        return ok;
+    }
+
+    // Engine write path without the manager: batched and single inserts
+    bool RunEngineIngest(const std::string& path, PhaseResult& result) {
+        auto engine = StorageEngineFactory::Create(StorageEngineFactory::EngineType::SQLITE_ENCRYPTED);
+        StorageConfig config = MakeStorageConfig(path, m_options.span_days * 2);
+        if (!engine || !engine->Initialize(config)) {
+            std::cerr << "storage_bench: failed to initialize storage engine" << std::endl;
+            return false;
+        }
+        if (!engine->OpenDatabase(config.master_password) &&
+            (!engine->CreateDatabase() || !engine->OpenDatabase(config.master_password))) {
+            std::cerr << "storage_bench: failed to open database" << std::endl;
+            return false;
+        }
+
+        std::vector<DataRecord> batch;
+        auto makeRecord = [&]() {
+            return m_generator.Uniform() < 0.5
+                ? m_generator.MakeActivityRecord(Span()).ToDataRecord()
+                : m_generator.MakeAnalysisRecord(Span(), "storage_bench").ToDataRecord();
+        };
+
+        Begin(path, result, [&engine]() { return engine->GetStatistics().total_records; });
+        bool ok = true;
+        const size_t single = std::min(m_options.records / 10, static_cast<size_t>(2000));
+        for (size_t i = 0; i < single && ok; ++i) {
+            DataRecord record = makeRecord();
+            result.logical_bytes += LogicalBytes(record);
+            ok = result.operations["store_record"].Time([&]() { return engine->StoreRecord(record) != 0; });
+            result.records_written += ok ? 1 : 0;
+        }
+        for (size_t i = single; i < m_options.records && ok; ++i) {
+            batch.push_back(makeRecord());
+            result.logical_bytes += LogicalBytes(batch.back());
+            if (batch.size() >= m_options.batch_size || i + 1 == m_options.records) {
+                ok = result.operations["store_records_batch"].Time([&]() { return engine->StoreRecords(batch); });
+                result.records_written += ok ? batch.size() : 0;
+                batch.clear();
+            }
+        }
+        End(path, result);
+
+        engine->Shutdown();
+        return ok;
+    }
+
+    // Dashboard refreshes over recent windows, with ongoing capture
+    bool RunDashboard(const std::string& path, PhaseResult& result) {
+        EncryptedStorageManager manager;
+        if (!OpenManager(manager, path, m_options.span_days * 2) || !Preload(manager)) {
+            return false;
+        }
+
+        const std::chrono::hours windows[] = {std::chrono::hours(1), std::chrono::hours(8),
+                                              std::chrono::hours(24), std::chrono::hours(24 * 7)};
+        Begin(path, result, [&manager]() { return manager.GetStatistics().total_records; });
+        size_t rows = 0;
+        for (size_t i = 0; i < m_options.operations; ++i) {
+            auto end = std::chrono::system_clock::now();
+            auto window = windows[std::uniform_int_distribution<size_t>(0, 3)(m_generator.Rng())];
+            auto start = end - window;
+
+            if (m_generator.Uniform() >= m_options.read_ratio) {
+                ContentAnalysis analysis = m_generator.MakeAnalysis(std::chrono::hours(1));
+                if (result.operations["store_ai_analysis"].Time([&]() { return manager.StoreAIAnalysis(analysis); })) {
+                    result.records_written++;
+                    result.logical_bytes += LogicalBytes(analysis);
+                }
+                continue;
+            }
+
+            switch (i % 4) {
+                case 0:
+                    rows += result.operations["content_analyses"].Time([&]() {
+                        return manager.GetContentAnalyses(start, end);
+                    }).size();
+                    break;
+                case 1:
+                    rows += result.operations["window_activities"].Time([&]() {
+                        return manager.GetWindowActivities(start, end);
+                    }).size();
+                    break;
+                case 2:
+                    rows += result.operations["time_by_application"].Time([&]() {
+                        return manager.GetTimeSpentByApplication(start, end);
+                    }).size();
+                    break;
+                default:
+                    rows += result.operations["productivity_report"].Time([&]() {
+                        return manager.GetProductivityReport(start, end);
+                    }).size();
+                    break;
+            }
+        }
+        End(path, result);
+        result.extra["rows_returned"] = static_cast<double>(rows);
+
+        manager.Shutdown();
+        return true;
+    }
+
+    // Keyword lookups, drawn with the same skew as the stored text
+    bool RunSearch(const std::string& path, PhaseResult& result) {
+        EncryptedStorageManager manager;
+        if (!OpenManager(manager, path, m_options.span_days * 2) || !Preload(manager)) {
+            return false;
+        }
+
+        Begin(path, result);
+        size_t hits = 0;
+        for (size_t i = 0; i < m_options.operations; ++i) {
+            std::string query = m_generator.NextWord();
+            hits += result.operations["search_content"].Time([&]() {
+                return manager.SearchContent(query, 100);
+            }).size();
+        }
+        End(path, result);
+        result.extra["hits_per_query"] = m_options.operations > 0
+            ? static_cast<double>(hits) / m_options.operations : 0.0;
+
+        manager.Shutdown();
+        return true;
+    }
+
+    // Full-history export to JSON
+    bool RunExport(const std::string& path, PhaseResult& result) {
+        EncryptedStorageManager manager;
+        if (!OpenManager(manager, path, m_options.span_days * 2) || !Preload(manager)) {
+            return false;
+        }
+
+        const std::string exportPath = (std::filesystem::path(path) / "export.json").string();
+        auto end = std::chrono::system_clock::now();
+        auto start = end - Span() - std::chrono::hours(1);
+        const size_t runs = 3;
+
+        Begin(path, result);
+        bool ok = true;
+        for (size_t i = 0; i < runs && ok; ++i) {
+            ok = result.operations["export_data"].Time([&]() { return manager.ExportData(exportPath, start, end); });
+        }
+        End(path, result);
+
+        std::error_code ec;
+        auto exportBytes = std::filesystem::file_size(exportPath, ec);
+        if (!ec) {
+            result.extra["export_bytes"] = static_cast<double>(exportBytes);
+            result.extra["export_mb_per_sec"] = result.seconds > 0
+                ? exportBytes * runs / (1024.0 * 1024.0) / result.seconds : 0.0;
+            result.extra["records_per_export_sec"] = result.seconds > 0
+                ? m_options.records * runs / result.seconds : 0.0;
+        }
+
+        manager.Shutdown();
+        return ok;
+    }
+
+    // Retention cleanup of the older half of the history, then compaction
+    bool RunRetention(const std::string& path, PhaseResult& result) {
+        EncryptedStorageManager manager;
+        int retentionDays = std::max(1, m_options.span_days / 2);
+        if (!OpenManager(manager, path, retentionDays) || !Preload(manager)) {
+            return false;
+        }
+
+        auto countRecords = [&manager]() {
+            StorageStatistics stats = manager.GetStatistics();
+            return stats.total_records;
+        };
+        size_t before = countRecords();
+
+        Begin(path, result);
+        bool ok = result.operations["cleanup_old_data"].Time([&]() {
+            return manager.CleanupOldData(std::chrono::hours(24 * retentionDays));
+        });
+        // Deleted rows only leave the files once compaction has rewritten
+        // the database and checkpointed the WAL
+        ok = ok && result.operations["compact_database"].Time([&]() { return manager.CompactDatabase(); });
+        End(path, result);
+        size_t afterCleanup = storage_utils::GetDirectorySize(path);
+
+        size_t after = countRecords();
+        result.extra["records_deleted"] = static_cast<double>(before > after ? before - after : 0);
+        result.extra["database_bytes_after_cleanup"] = static_cast<double>(afterCleanup);
+
+        manager.Shutdown();
+        return ok;
+    }
+
+    BenchOptions m_options;
+    WorkloadGenerator m_generator;
+    std::vector<PhaseResult> m_results;
+    Clock::time_point m_phaseStart;
+    int64_t m_writeBytesStart = -1;
+    std::function<size_t()> m_countRecords;
+    size_t m_recordsStart = 0;
+};
+
+std::vector<std::string> SplitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    CommandLineParser parser;
+    parser.SetProgramName("storage_bench");
+    parser.SetProgramDescription("Storage load generator and benchmark");
+    parser.SetProgramVersion("1.0.0");
+    parser.AddExample("--workloads ingest,dashboard --records 50000 --output bench.json");
+    parser.AddExample("--workloads retention --span-days 30 --dir /tmp/bench --keep");
+    parser.AddOption("h", "help", "Show this help message");
+    parser.AddOption("w", "workloads",
+                     "Comma-separated workloads: ingest, engine_ingest, dashboard, search, export, retention", true);
+    parser.AddOption("n", "records", "Records written by ingest and preloaded by the other workloads", true);
+    parser.AddOption("", "operations", "Measured operations per read workload", true);
+    parser.AddOption("", "batch-size", "Records per batch write", true);
+    parser.AddOption("", "read-percent", "Share of reads in the dashboard mix", true);
+    parser.AddOption("", "span-days", "Days of history the preloaded records cover", true);
+    parser.AddOption("", "seed", "Random seed", true);
+    parser.AddOption("d", "dir", "Directory for the benchmark databases", true);
+    parser.AddOption("o", "output", "Write the JSON report to this file instead of stdout", true);
+    parser.AddOption("", "keep", "Keep the benchmark databases");
+
+    if (!parser.Parse(argc, argv)) {
+        std::cerr << "Error: " << parser.GetLastError() << std::endl;
+        parser.PrintUsage();
+        return 1;
+    }
+    if (parser.HasOption("help")) {
+        parser.PrintHelp();
+        return 0;
+    }
+
+    BenchOptions options;
+    options.records = static_cast<size_t>(std::max(1, parser.GetIntValue("records", 20000)));
+    options.operations = static_cast<size_t>(std::max(1, parser.GetIntValue("operations", 500)));
+    options.batch_size = static_cast<size_t>(std::max(1, parser.GetIntValue("batch-size", 256)));
+    options.read_ratio = std::max(0, std::min(100, parser.GetIntValue("read-percent", 90))) / 100.0;
+    options.span_days = std::max(2, parser.GetIntValue("span-days", 14));
+    options.seed = static_cast<uint64_t>(parser.GetIntValue("seed", 42));
+    options.directory = parser.GetValue("dir", options.directory);
+    options.keep = parser.HasOption("keep");
+
+    std::vector<std::string> workloads = SplitList(
+        parser.GetValue("workloads", "ingest,engine_ingest,dashboard,search,export,retention"));
+
+    // Storage components log to stdout; keep it for the report
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    StorageBench bench(options);
+    bool ok = true;
+    for (const std::string& workload : workloads) {
+        ok = bench.Run(workload) && ok;
+    }
+
+    std::cout.rdbuf(stdoutBuffer);
+    std::string report = bench.ToJson();
+    std::string output = parser.GetValue("output");
+    if (output.empty()) {
+        std::cout << report;
+    } else {
+        std::ofstream file(output);
+        file << report;
+        if (!file) {
+            std::cerr << "Failed to write report: " << output << std::endl;
+            return 1;
+        }
+    }
+
+    if (!options.keep) {
+        std::error_code ec;
+        std::filesystem::remove(options.directory, ec);
+    }
+    return ok ? 0 : 1;
+}
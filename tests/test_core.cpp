@@ -0,0 +1,594 @@
+#include "startup_sequencer.h"
+#include "common_types.h"
+#include "cpu_governor.h"
+#include "memory_governor.h"
+#include "ocr_scheduler.h"
+#include "thread_pool.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace work_assistant;
+
+// Simple test framework
+class TestFramework {
+private:
+    int tests_run = 0;
+    int tests_passed = 0;
+
+public:
+    void run_test(const std::string& name, std::function<bool()> test_func) {
+        tests_run++;
+        std::cout << "Running test: " << name << "... ";
+
+        try {
+            if (test_func()) {
+                tests_passed++;
+                std::cout << "PASSED" << std::endl;
+            } else {
+                std::cout << "FAILED" << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cout << "FAILED (Exception: " << e.what() << ")" << std::endl;
+        }
+    }
+
+    int summary() {
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "Tests run: " << tests_run << std::endl;
+        std::cout << "Tests passed: " << tests_passed << std::endl;
+        std::cout << "Tests failed: " << (tests_run - tests_passed) << std::endl;
+
+        if (tests_passed == tests_run) {
+            std::cout << "All tests PASSED!" << std::endl;
+            return 0;
+        } else {
+            std::cout << "Some tests FAILED!" << std::endl;
+            return 1;
+        }
+    }
+};
+
+// Records the order in which stages ran
+class StageLog {
+public:
+    StartupSequencer::StageFunction Stage(const std::string& name, bool result = true) {
+        return [this, name, result]() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_order.push_back(name);
+            return result;
+        };
+    }
+
+    std::vector<std::string> Order() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_order;
+    }
+
+    int Position(const std::string& name) {
+        auto order = Order();
+        auto it = std::find(order.begin(), order.end(), name);
+        return it == order.end() ? -1 : static_cast<int>(it - order.begin());
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::string> m_order;
+};
+
+StageState StateOf(const StartupSequencer& sequencer, const std::string& name) {
+    for (const auto& timing : sequencer.GetTimings()) {
+        if (timing.name == name) {
+            return timing.state;
+        }
+    }
+    return StageState::PENDING;
+}
+
+bool test_startup_dependency_order() {
+    WorkAssistant::ThreadPool pool(4);
+    StageLog log;
+    StartupSequencer sequencer;
+    // Added out of order: dependencies may name later stages
+    sequencer.AddStage("web_server", log.Stage("web_server"), {"storage"});
+    sequencer.AddStage("storage", log.Stage("storage"), {"directories"});
+    sequencer.AddStage("directories", log.Stage("directories"));
+    sequencer.AddStage("capture", log.Stage("capture"));
+
+    if (!sequencer.Run(pool)) {
+        return false;
+    }
+
+    bool all_ran = log.Order().size() == 4;
+    for (const auto& timing : sequencer.GetTimings()) {
+        all_ran = all_ran && timing.state == StageState::SUCCEEDED;
+    }
+    return all_ran &&
+           log.Position("directories") < log.Position("storage") &&
+           log.Position("storage") < log.Position("web_server");
+}
+
+bool test_startup_invalid_graphs() {
+    WorkAssistant::ThreadPool pool(2);
+    StageLog log;
+
+    StartupSequencer cycle;
+    cycle.AddStage("a", log.Stage("a"), {"c"});
+    cycle.AddStage("b", log.Stage("b"), {"a"});
+    cycle.AddStage("c", log.Stage("c"), {"b"});
+
+    StartupSequencer unknown;
+    unknown.AddStage("a", log.Stage("a"), {"missing"});
+
+    // Immediate stages can't wait for stages held back until later
+    StartupSequencer inverted;
+    inverted.AddStage("late", log.Stage("late"), {}, true);
+    inverted.AddStage("early", log.Stage("early"), {"late"});
+
+    StartupSequencer duplicate;
+    duplicate.AddStage("a", log.Stage("a"));
+    duplicate.AddStage("a", log.Stage("a"));
+
+    // Rejected graphs run nothing
+    return !cycle.Run(pool) && !unknown.Run(pool) && !inverted.Run(pool) && !duplicate.Run(pool) &&
+           log.Order().empty();
+}
+
+bool test_startup_failure_skips_dependents() {
+    WorkAssistant::ThreadPool pool(4);
+    StageLog log;
+    StartupSequencer sequencer;
+    sequencer.AddStage("storage", log.Stage("storage", false));
+    sequencer.AddStage("web_server", log.Stage("web_server"), {"storage"});
+    sequencer.AddStage("replication", log.Stage("replication"), {"web_server"}, true);
+    sequencer.AddStage("capture", log.Stage("capture"));
+
+    if (!sequencer.Run(pool)) {
+        return false;
+    }
+    sequencer.RunDeferred(pool);
+    sequencer.WaitForDeferred();
+
+    return StateOf(sequencer, "storage") == StageState::FAILED &&
+           StateOf(sequencer, "web_server") == StageState::SKIPPED &&
+           StateOf(sequencer, "replication") == StageState::SKIPPED &&
+           StateOf(sequencer, "capture") == StageState::SUCCEEDED &&
+           log.Position("web_server") < 0 && log.Position("replication") < 0;
+}
+
+bool test_startup_deferred_stages() {
+    WorkAssistant::ThreadPool pool(4);
+    StageLog log;
+    StartupSequencer sequencer;
+    sequencer.AddStage("screen_capture", log.Stage("screen_capture"));
+    sequencer.AddStage("ocr", log.Stage("ocr"), {}, true);
+    sequencer.AddStage("ocr_secondary", log.Stage("ocr_secondary"), {"ocr", "screen_capture"}, true);
+
+    if (!sequencer.Run(pool)) {
+        return false;
+    }
+
+    // Run() returns with the deferred stages untouched, as it does before
+    // the application's first frame
+    bool held_back = !sequencer.HasDeferredStarted() &&
+                     log.Order() == std::vector<std::string>{"screen_capture"} &&
+                     StateOf(sequencer, "ocr") == StageState::PENDING;
+
+    // The first frame starts them; a second call is a no-op
+    sequencer.RunDeferred(pool);
+    sequencer.RunDeferred(pool);
+    sequencer.WaitForDeferred();
+
+    return held_back && sequencer.HasDeferredStarted() &&
+           log.Order().size() == 3 &&
+           log.Position("ocr") < log.Position("ocr_secondary") &&
+           StateOf(sequencer, "ocr_secondary") == StageState::SUCCEEDED;
+}
+
+// Detection frame with the given damage; OCRScheduler only reads geometry
+CaptureFrame DamagedFrame(int width, int height, std::vector<DirtyRect> damage, int scale = 1) {
+    CaptureFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.scale_factor = scale;
+    frame.monitor_id = 0;
+    frame.dirty_rects = std::move(damage);
+    return frame;
+}
+
+// 1 ms per 10,000 pixels, no padding, so costs are easy to reason about
+OCRSchedulerConfig SchedulerTestConfig(int budgetMs) {
+    OCRSchedulerConfig config;
+    config.frame_budget = std::chrono::milliseconds(budgetMs);
+    config.region_padding = 0;
+    config.initial_ms_per_megapixel = 100.0;
+    return config;
+}
+
+bool test_ocr_scheduler_budget_cutoff() {
+    OCRScheduler scheduler;
+    scheduler.SetConfig(SchedulerTestConfig(100));
+
+    // Three separate 500x1000 columns, 50 ms each
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{0, 0, 500, 1000}, {750, 0, 500, 1000},
+                                                  {1500, 0, 500, 1000}}));
+    OCRSchedule schedule = scheduler.Plan(0, 2000, 1000, 0, 0);
+    bool cut = schedule.regions.size() == 2 && schedule.deferred == 1 &&
+               schedule.estimated_ms <= 100.0 && schedule.budget.count() == 100;
+
+    // A region over the whole budget still runs on its own
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{0, 0, 2000, 1000}}));
+    OCRSchedule oversized = scheduler.Plan(0, 2000, 1000, 0, 0);
+    bool best_runs = oversized.regions.size() == 1 && oversized.regions[0].Area() == 2000u * 1000u;
+
+    // Damage of reduced frames is scaled up to full-resolution pixels
+    scheduler.AddDamage(DamagedFrame(1000, 500, {{10, 20, 30, 40}}, 2));
+    OCRSchedule scaled = scheduler.Plan(0, 2000, 1000, 0, 0);
+    bool scales = scaled.regions.size() == 1 && scaled.regions[0].x == 20 && scaled.regions[0].y == 40 &&
+                  scaled.regions[0].width == 60 && scaled.regions[0].height == 80;
+
+    return cut && best_runs && scales;
+}
+
+bool test_ocr_scheduler_focus_and_caret_order() {
+    OCRScheduler scheduler;
+    scheduler.SetConfig(SchedulerTestConfig(1000));
+
+    // The focused window covers the right half of a monitor at (1000, 0)
+    WindowInfo editor;
+    editor.process_name = "editor";
+    editor.x = 2000;
+    editor.y = 0;
+    editor.width = 1000;
+    editor.height = 1000;
+    scheduler.SetFocusedWindow(editor);
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{100, 500, 200, 200}, {1500, 500, 200, 200}}));
+    OCRSchedule focused = scheduler.Plan(0, 2000, 1000, 1000, 0);
+    bool focus_first = focused.regions.size() == 2 && focused.regions[0].x == 1500;
+
+    // Without a focused window the region around the caret comes first
+    scheduler.SetFocusedWindow(WindowInfo());
+    scheduler.SetCaretPosition(1150, 550);
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{1500, 500, 200, 200}, {100, 500, 200, 200}}));
+    OCRSchedule caret = scheduler.Plan(0, 2000, 1000, 1000, 0);
+    bool caret_first = caret.regions.size() == 2 && caret.regions[0].x == 100;
+
+    // An application weighted to zero loses the focus terms
+    scheduler.SetCaretPosition(-1, -1);
+    scheduler.SetFocusedWindow(editor);
+    scheduler.SetApplicationImportance(std::unordered_map<std::string, double>{{"editor", 0.0}});
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{1500, 500, 200, 200}}));
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{100, 500, 200, 200}}));
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{100, 500, 200, 200}}));
+    OCRSchedule unimportant = scheduler.Plan(0, 2000, 1000, 1000, 0);
+    bool weighted = unimportant.regions.size() == 2 && unimportant.regions[0].x == 100;
+
+    return focus_first && caret_first && weighted;
+}
+
+bool test_ocr_scheduler_deferral() {
+    OCRScheduler scheduler;
+    OCRSchedulerConfig config = SchedulerTestConfig(100);
+    config.max_deferrals = 1;
+    scheduler.SetConfig(config);
+
+    // The budget holds back the third column...
+    scheduler.AddDamage(DamagedFrame(2000, 1000, {{0, 0, 500, 1000}, {750, 0, 500, 1000},
+                                                  {1500, 0, 500, 1000}}));
+    OCRSchedule first = scheduler.Plan(0, 2000, 1000, 0, 0);
+    if (first.regions.size() != 2 || first.deferred != 1) {
+        return false;
+    }
+
+    // ...which the next pass picks up without new damage
+    OCRSchedule second = scheduler.Plan(0, 2000, 1000, 0, 0);
+    bool requeued = second.regions.size() == 1 && second.regions[0].deferrals == 1;
+
+    // Regions a pass could not finish come back once, then are dropped
+    std::vector<OCRRegion> unfinished(first.regions.begin() + 1, first.regions.end());
+    scheduler.Defer(0, unfinished);
+    OCRSchedule third = scheduler.Plan(0, 2000, 1000, 0, 0);
+    bool deferred_back = third.regions.size() == 1 && third.regions[0].x == unfinished[0].x &&
+                         third.regions[0].deferrals == 1;
+    scheduler.Defer(0, third.regions);
+    OCRSchedule fourth = scheduler.Plan(0, 2000, 1000, 0, 0);
+
+    OCRSchedulerStatistics stats = scheduler.GetStatistics();
+    return requeued && deferred_back && fourth.regions.empty() &&
+           stats.regions_deferred == 2 && stats.regions_dropped == 1;
+}
+
+CpuGovernorStatus CpuSample(double process_share, uint64_t throttled_periods = 0,
+                            double system_usage_percent = 10.0) {
+    CpuGovernorStatus sample;
+    sample.process_share = process_share;
+    sample.throttled_periods = throttled_periods;
+    sample.system_usage_percent = system_usage_percent;
+    return sample;
+}
+
+bool NearlyEqual(double a, double b) {
+    return std::fabs(a - b) < 1e-9;
+}
+
+bool test_cpu_budget_aimd() {
+    CpuGovernorConfig config;   // 25% target, x0.7 cut, x1.2 recovery below 15%
+    CpuBudgetPolicy policy;
+    auto now = std::chrono::steady_clock::now();
+
+    // Over target: multiplicative cut down to min_scale
+    CpuGovernorStatus sample = CpuSample(40.0);
+    CpuBudget budget = policy.NextBudget(config, sample, "", CpuBudget(), now);
+    bool cut = budget.mode == CpuBudgetMode::THROTTLED && NearlyEqual(budget.scale, 0.7) &&
+               sample.reason == "over target share";
+    for (int i = 0; i < 20; ++i) {
+        sample = CpuSample(40.0);
+        budget = policy.NextBudget(config, sample, "", budget, now);
+    }
+    bool floored = NearlyEqual(budget.scale, config.min_scale);
+
+    // Near the target the scale holds
+    sample = CpuSample(20.0);
+    CpuBudget held = policy.NextBudget(config, sample, "", budget, now);
+    bool holds = NearlyEqual(held.scale, budget.scale) && sample.reason == "near target share";
+
+    // Busy machine: back off once using more than the recovery share
+    sample = CpuSample(20.0, 0, 95.0);
+    CpuBudget busy = policy.NextBudget(config, sample, "", CpuBudget(), now);
+    bool backs_off = NearlyEqual(busy.scale, 0.7) && sample.reason == "system busy";
+
+    // Well under: gradual recovery, capped at full scale and back to normal
+    int steps = 0;
+    while (budget.scale < 1.0 && steps < 50) {
+        sample = CpuSample(5.0);
+        CpuBudget next = policy.NextBudget(config, sample, "", budget, now);
+        if (next.scale > budget.scale * config.increase_factor + 1e-9) {
+            return false;
+        }
+        budget = next;
+        steps++;
+    }
+    bool recovered = budget.mode == CpuBudgetMode::NORMAL && NearlyEqual(budget.scale, 1.0) && steps > 1;
+
+    return cut && floored && holds && backs_off && recovered;
+}
+
+bool test_cpu_budget_cgroup_throttle() {
+    CpuGovernorConfig config;
+    CpuBudgetPolicy policy;
+    auto now = std::chrono::steady_clock::now();
+
+    // Throttled periods cut the scale even well under the target share
+    CpuGovernorStatus sample = CpuSample(5.0, 3);
+    CpuBudget budget = policy.NextBudget(config, sample, "", CpuBudget(), now);
+    bool cut = budget.mode == CpuBudgetMode::THROTTLED && NearlyEqual(budget.scale, 0.7) &&
+               sample.reason == "cgroup throttling";
+
+    sample = CpuSample(5.0, 1);
+    budget = policy.NextBudget(config, sample, "", budget, now);
+    bool cut_again = NearlyEqual(budget.scale, 0.7 * 0.7);
+
+    // Once throttling stops the scale recovers
+    sample = CpuSample(5.0, 0);
+    CpuBudget next = policy.NextBudget(config, sample, "", budget, now);
+    return cut && cut_again && next.scale > budget.scale;
+}
+
+bool test_cpu_budget_foreground_yield() {
+    CpuGovernorConfig config;
+    config.yield_hold = std::chrono::seconds(10);
+    CpuBudgetPolicy policy;
+    auto now = std::chrono::steady_clock::now();
+
+    CpuGovernorStatus sample = CpuSample(5.0);
+    CpuBudget budget = policy.NextBudget(config, sample, "compile in progress (cc1plus)", CpuBudget(), now);
+    bool yields = budget.mode == CpuBudgetMode::YIELDING && sample.reason == "compile in progress (cc1plus)";
+
+    // The load is gone, but yielding holds for yield_hold
+    sample = CpuSample(5.0);
+    CpuBudget held = policy.NextBudget(config, sample, "", budget, now + std::chrono::seconds(5));
+    bool holds = held.mode == CpuBudgetMode::YIELDING && sample.reason == "recently compile in progress (cc1plus)";
+
+    sample = CpuSample(5.0);
+    CpuBudget resumed = policy.NextBudget(config, sample, "", held, now + std::chrono::seconds(11));
+    bool resumes = resumed.mode == CpuBudgetMode::NORMAL && sample.reason == "within budget";
+
+    return yields && holds && resumes;
+}
+
+// Sample with the given PSI averages and system RAM in use
+MemoryGovernorStatus MemorySample(double psi_some, double psi_full, double used_ratio) {
+    MemoryGovernorStatus sample;
+    sample.psi_available = true;
+    sample.psi_some_avg10 = psi_some;
+    sample.psi_full_avg10 = psi_full;
+    sample.system_total_bytes = 1000;
+    sample.system_available_bytes = static_cast<size_t>(1000 * (1.0 - used_ratio));
+    return sample;
+}
+
+bool test_memory_pressure_classify() {
+    MemoryGovernorConfig config;    // some >= 10 / usage >= 0.85 moderate; full >= 5 / usage >= 0.95 critical
+    using Level = MemoryPressureLevel;
+
+    bool by_psi = MemoryPressurePolicy::Classify(config, MemorySample(0.0, 0.0, 0.5)) == Level::NORMAL &&
+                  MemoryPressurePolicy::Classify(config, MemorySample(12.0, 0.0, 0.5)) == Level::MODERATE &&
+                  MemoryPressurePolicy::Classify(config, MemorySample(12.0, 6.0, 0.5)) == Level::CRITICAL;
+    bool by_usage = MemoryPressurePolicy::Classify(config, MemorySample(0.0, 0.0, 0.9)) == Level::MODERATE &&
+                    MemoryPressurePolicy::Classify(config, MemorySample(0.0, 0.0, 0.96)) == Level::CRITICAL;
+
+    // The cgroup limit and the process budget count like system RAM
+    MemoryGovernorStatus cgroup = MemorySample(0.0, 0.0, 0.1);
+    cgroup.cgroup_usage_bytes = 90;
+    cgroup.cgroup_limit_bytes = 100;
+    MemoryGovernorConfig budgeted = config;
+    budgeted.process_budget_mb = 100;
+    MemoryGovernorStatus rss = MemorySample(0.0, 0.0, 0.1);
+    rss.process_rss_bytes = 99 * 1024 * 1024;
+    bool by_limits = MemoryPressurePolicy::Classify(config, cgroup) == Level::MODERATE &&
+                     MemoryPressurePolicy::Classify(config, rss) == Level::NORMAL &&
+                     MemoryPressurePolicy::Classify(budgeted, rss) == Level::CRITICAL;
+
+    // Scaled thresholds, as used for the recovery check
+    bool scaled = MemoryPressurePolicy::Classify(config, MemorySample(9.5, 0.0, 0.5), 0.9) == Level::MODERATE;
+
+    return by_psi && by_usage && by_limits && scaled;
+}
+
+bool test_memory_pressure_hysteresis() {
+    MemoryGovernorConfig config;
+    config.restore_delay = std::chrono::seconds(30);
+    using Level = MemoryPressureLevel;
+    MemoryPressurePolicy policy;
+    auto t0 = std::chrono::steady_clock::now();
+    auto at = [t0](int seconds) { return t0 + std::chrono::seconds(seconds); };
+
+    // Escalation is immediate, straight to the level the sample shows
+    Level level = policy.NextLevel(config, MemorySample(12.0, 6.0, 0.5), Level::NORMAL, at(0));
+    bool escalated = level == Level::CRITICAL;
+
+    // Below the enter threshold but inside the margin: no step down
+    level = policy.NextLevel(config, MemorySample(0.0, 4.8, 0.5), level, at(60));
+    bool margin_holds = level == Level::CRITICAL;
+
+    // Calm, but not for restore_delay yet
+    level = policy.NextLevel(config, MemorySample(12.0, 0.0, 0.5), level, at(70));
+    bool delay_holds = level == Level::CRITICAL;
+
+    // One level per restore_delay of calm
+    level = policy.NextLevel(config, MemorySample(12.0, 0.0, 0.5), level, at(101));
+    bool stepped = level == Level::MODERATE;
+    level = policy.NextLevel(config, MemorySample(0.0, 0.0, 0.5), level, at(110));
+    bool waits_again = level == Level::MODERATE;
+    level = policy.NextLevel(config, MemorySample(0.0, 0.0, 0.5), level, at(132));
+    bool normal = level == Level::NORMAL;
+
+    // Renewed pressure while calming down resets the calm period
+    level = policy.NextLevel(config, MemorySample(12.0, 0.0, 0.5), level, at(140));
+    level = policy.NextLevel(config, MemorySample(0.0, 0.0, 0.5), level, at(150));
+    level = policy.NextLevel(config, MemorySample(9.5, 0.0, 0.5), level, at(175));
+    level = policy.NextLevel(config, MemorySample(0.0, 0.0, 0.5), level, at(190));
+    bool reset = level == Level::MODERATE;
+
+    return escalated && margin_holds && delay_holds && stepped && waits_again && normal && reset;
+}
+
+// 10x8 RGBA frame with 8 bytes of row padding; each pixel holds its x, y
+CaptureFrame PatternFrame() {
+    CaptureFrame frame;
+    frame.width = 10;
+    frame.height = 8;
+    frame.bytes_per_pixel = 4;
+    frame.stride = 48;
+    frame.monitor_id = 1;
+    frame.data.assign(frame.GetDataSize(), 0xEE);
+    for (int y = 0; y < frame.height; ++y) {
+        for (int x = 0; x < frame.width; ++x) {
+            uint8_t* pixel = frame.data.data() + y * frame.stride + x * 4;
+            pixel[0] = static_cast<uint8_t>(x);
+            pixel[1] = static_cast<uint8_t>(y);
+            pixel[2] = 0;
+            pixel[3] = 255;
+        }
+    }
+    return frame;
+}
+
+bool PixelIs(const FrameView& view, int x, int y, int frameX, int frameY) {
+    const uint8_t* pixel = view.Pixel(x, y);
+    return pixel[0] == frameX && pixel[1] == frameY;
+}
+
+bool test_frame_view_subview() {
+    CaptureFrame frame = PatternFrame();
+    FrameView view(frame);
+
+    // Crossing the bottom-right edge: clamped, same stride and buffer
+    FrameView edge = view.SubView(6, 5, 10, 10);
+    bool clamped = edge.IsValid() && edge.width == 4 && edge.height == 3 &&
+                   edge.origin_x == 6 && edge.origin_y == 5 && edge.stride == 48 &&
+                   edge.data == frame.data.data() + 5 * 48 + 6 * 4 &&
+                   PixelIs(edge, 0, 0, 6, 5) && PixelIs(edge, 3, 2, 9, 7) && edge.monitor_id == 1;
+
+    // Crossing the top-left edge, and crops of crops
+    FrameView corner = view.SubView(-3, -2, 5, 4);
+    FrameView nested = edge.SubView(1, 1, 2, 1);
+    bool negative = corner.width == 2 && corner.height == 2 && corner.origin_x == 0 &&
+                    corner.data == frame.data.data();
+    bool composed = nested.origin_x == 7 && nested.origin_y == 6 && nested.width == 2 &&
+                    PixelIs(nested, 0, 0, 7, 6);
+
+    bool disjoint = !view.SubView(10, 0, 5, 5).IsValid() && !view.SubView(2, 2, 0, 3).IsValid();
+
+    // ToFrame packs the rows and counts a pixel pass
+    CaptureFrame copy = edge.ToFrame();
+    FrameView copied(copy);
+    bool packed = copy.IsValid() && copy.width == 4 && copy.height == 3 && copy.stride == 16 &&
+                  copy.data.size() == 48 && copy.pixel_passes == frame.pixel_passes + 1 &&
+                  PixelIs(copied, 0, 0, 6, 5) && PixelIs(copied, 3, 2, 9, 7);
+
+    return clamped && negative && composed && disjoint && packed;
+}
+
+bool test_frame_view_sharing() {
+    auto frame = std::make_shared<CaptureFrame>(PatternFrame());
+    const uint8_t* pixels = frame->data.data();
+
+    // Crops of a shared view share its owner and buffer
+    FrameView shared = FrameView::Shared(frame);
+    FrameView crop = shared.SubView(2, 3, 4, 4);
+    long owners = frame.use_count();
+    bool shares = crop.owner == shared.owner && owners == 3 && crop.data == pixels + 3 * 48 + 2 * 4;
+
+    // Retaining an owning view copies nothing
+    FrameView kept = crop.Retain();
+    bool no_copy = kept.data == crop.data && frame.use_count() == owners + 1;
+
+    // A borrowed crop retained outlives its frame: just its pixels are
+    // copied, with its position in the source kept
+    FrameView retained;
+    {
+        CaptureFrame local = PatternFrame();
+        retained = FrameView(local).SubView(5, 4, 3, 2).Retain();
+        if (retained.data == local.data.data() + 4 * 48 + 5 * 4) {
+            return false;
+        }
+    }
+    bool outlives = retained.IsValid() && retained.owner != nullptr &&
+                    retained.width == 3 && retained.height == 2 && retained.stride == 12 &&
+                    retained.origin_x == 5 && retained.origin_y == 4 &&
+                    PixelIs(retained, 0, 0, 5, 4) && PixelIs(retained, 2, 1, 7, 5);
+
+    // The shared buffer stays alive for views after the last pointer goes
+    frame.reset();
+    bool alive = PixelIs(crop, 3, 3, 5, 6) && PixelIs(kept, 0, 0, 2, 3);
+
+    return shares && no_copy && outlives && alive;
+}
+
+int main() {
+    TestFramework framework;
+
+    std::cout << "=== Core Component Tests ===" << std::endl;
+
+    framework.run_test("Startup Dependency Order", test_startup_dependency_order);
+    framework.run_test("Startup Invalid Graphs", test_startup_invalid_graphs);
+    framework.run_test("Startup Failure Skips Dependents", test_startup_failure_skips_dependents);
+    framework.run_test("Startup Deferred Stages", test_startup_deferred_stages);
+    framework.run_test("OCR Scheduler Budget Cut-off", test_ocr_scheduler_budget_cutoff);
+    framework.run_test("OCR Scheduler Focus And Caret Order", test_ocr_scheduler_focus_and_caret_order);
+    framework.run_test("OCR Scheduler Deferral", test_ocr_scheduler_deferral);
+    framework.run_test("CPU Budget AIMD", test_cpu_budget_aimd);
+    framework.run_test("CPU Budget Cgroup Throttle", test_cpu_budget_cgroup_throttle);
+    framework.run_test("CPU Budget Foreground Yield", test_cpu_budget_foreground_yield);
+    framework.run_test("Memory Pressure Classify", test_memory_pressure_classify);
+    framework.run_test("Memory Pressure Hysteresis", test_memory_pressure_hysteresis);
+    framework.run_test("Frame View SubView", test_frame_view_subview);
+    framework.run_test("Frame View Sharing", test_frame_view_sharing);
+
+    return framework.summary();
+}
@@ -2,10 +2,19 @@
 #include "storage_engine.h"
 #include "ai_engine.h"
 #include "web_server.h"
+#include "timeline_downsampling.h"
+#include "replication.h"
+#include "websocket_subscription.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 using namespace work_assistant;
 
@@ -143,6 +152,486 @@ bool test_web_storage_integration() {
     return web_initialized && web_ready && config_match;
 }
 
+bool test_batch_queries() {
+    EncryptedStorageManager storage;
+    
+    StorageConfig storage_config;
+    storage_config.storage_path = "batch_test_data";
+    storage_config.database_name = "batch_test.db";
+    storage_config.master_password = "batch_test_pass";
+    storage_config.security_level = SecurityLevel::STANDARD;
+    
+    if (!storage.Initialize(storage_config)) {
+        return false;
+    }
+    
+    auto now = std::chrono::system_clock::now();
+    std::vector<WindowActivityRecord> activities;
+    std::vector<ContentAnalysisRecord> analyses;
+    for (int i = 0; i < 120; ++i) {
+        WindowActivityRecord activity;
+        activity.timestamp = now - std::chrono::minutes(i);
+        activity.application_name = (i % 4 == 0) ? "terminal" : "editor";
+        activity.event_type = "focused";
+        activities.push_back(activity);
+        
+        ContentAnalysisRecord analysis;
+        analysis.timestamp = now - std::chrono::minutes(i);
+        analysis.application_name = activity.application_name;
+        analysis.is_productive = (i % 2 == 0);
+        analysis.ai_confidence = 0.8f;
+        analyses.push_back(analysis);
+    }
+    bool stored = storage.StoreBatch(activities, analyses);
+    
+    // Summary and applications overlap and share a scan; the older
+    // timeline range needs its own
+    std::vector<BatchSubQuery> queries = {
+        {"summary", "summary", now - std::chrono::hours(2), now},
+        {"apps", "applications", now - std::chrono::hours(1), now},
+        {"yesterday", "timeline", now - std::chrono::hours(48), now - std::chrono::hours(24)},
+        {"status", "status", {}, {}}
+    };
+    auto batch = api_handlers::ExecuteBatch(queries, &storage);
+    auto single = api_handlers::GetApplicationUsage(now - std::chrono::hours(1), now, &storage);
+    auto duplicate = api_handlers::ExecuteBatch({queries[0], queries[0]}, &storage);
+    
+    storage.Shutdown();
+    
+    try {
+        std::filesystem::remove_all("batch_test_data");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    // The batched applications result matches the standalone endpoint
+    return stored && batch.success &&
+           batch.data.find("\"scans\": 2") != std::string::npos &&
+           batch.data.find("\"apps\": " + single.ToJson()) != std::string::npos &&
+           batch.data.find("\"total_activities\": 120") != std::string::npos &&
+           !duplicate.success && duplicate.status_code == 400;
+}
+
+bool test_timeline_downsampling() {
+    // A week of one-minute samples: a flat line with a single spike
+    auto start = std::chrono::system_clock::now() - std::chrono::hours(24 * 7);
+    std::vector<TimelinePoint> points;
+    for (int i = 0; i < 7 * 24 * 60; ++i) {
+        TimelinePoint point;
+        point.timestamp = start + std::chrono::minutes(i);
+        point.value = (i == 5000) ? 10.0 : 1.0;
+        point.category = i % 2;
+        points.push_back(point);
+    }
+    auto end = points.back().timestamp;
+    
+    // LTTB keeps the requested count, both ends and the spike
+    auto sampled = downsampling::LargestTriangleThreeBuckets(points, 200);
+    bool lttb_ok = sampled.size() == 200 && sampled.front() == 0 &&
+                   sampled.back() == points.size() - 1 &&
+                   std::find(sampled.begin(), sampled.end(), size_t(5000)) != sampled.end() &&
+                   std::is_sorted(sampled.begin(), sampled.end());
+    
+    // Buckets: at most one per category per bucket, every sample counted
+    auto buckets = downsampling::AggregateBuckets(points, start, end, 50);
+    size_t counted = 0;
+    double peak = 0.0;
+    for (const auto& bucket : buckets) {
+        counted += bucket.count;
+        peak = std::max(peak, bucket.max);
+    }
+    bool buckets_ok = buckets.size() == 100 && counted == points.size() && peak == 10.0 &&
+                      buckets.front().start == start;
+    
+    return lttb_ok && buckets_ok;
+}
+
+bool test_websocket_subscriptions() {
+    // Parsing: arrays, escaped strings and min_priority
+    auto filter = WSSubscriptionFilter::FromJSON(
+        R"({"events":["ai_analysis","ocr_results"],"applications":["code","my \"app\""],)"
+        R"("content_types":[2, 3],"categories":[1],"min_priority":4,"windows":[12345]})");
+    bool parsed = filter.event_types == std::vector<std::string>{"ai_analysis", "ocr_results"} &&
+                  filter.applications == std::vector<std::string>{"code", "my \"app\""} &&
+                  filter.content_types == std::vector<int>{2, 3} &&
+                  filter.work_categories == std::vector<int>{1} &&
+                  filter.min_priority == 4 && filter.window_ids == std::vector<uint64_t>{12345};
+
+    // Key: order and duplicates don't matter, any other difference does
+    WSSubscriptionFilter same = filter;
+    same.event_types = {"ocr_results", "ai_analysis", "ocr_results"};
+    same.content_types = {3, 2};
+    WSSubscriptionFilter other = filter;
+    other.min_priority = 3;
+    bool keyed = filter.Key() == same.Key() && filter.Key() != other.Key();
+
+    // Matching
+    WSCompiledFilter compiled(filter);
+    WSMessageAttributes analysis;
+    analysis.event_type = "ai_analysis";
+    analysis.application = "code";
+    analysis.content_type = 2;
+    analysis.work_category = 1;
+    analysis.priority = 4;
+    analysis.window_id = 12345;
+    WSMessageAttributes low = analysis;
+    low.priority = 3;
+    WSMessageAttributes elsewhere = analysis;
+    elsewhere.application = "browser";
+    WSMessageAttributes status;
+    status.event_type = "system_status";
+    bool matches = compiled.Matches(analysis) && !compiled.Matches(low) &&
+                   !compiled.Matches(elsewhere) && !compiled.Matches(status);
+
+    // An OCR result from an unknown window reaches no application- or
+    // window-filtered client; it carries no content type, so that
+    // constraint does not apply to it
+    WSMessageAttributes ocr;
+    ocr.event_type = "ocr_results";
+    ocr.application = "code";
+    ocr.window_id = 12345;
+    WSMessageAttributes unknown_source;
+    unknown_source.event_type = "ocr_results";
+    WSSubscriptionFilter everything;
+    everything.event_types = {"ocr_results", "system_status"};
+    everything.content_types = {2};
+    WSCompiledFilter unfiltered(everything);
+    bool missing = compiled.Matches(ocr) && !compiled.Matches(unknown_source) &&
+                   unfiltered.Matches(unknown_source) && unfiltered.Matches(status);
+
+    // Clients with equivalent filters share one group
+    WSSubscriptionRegistry registry;
+    registry.Subscribe("a", filter);
+    registry.Subscribe("b", same);
+    registry.Subscribe("c", other);
+    bool grouped = registry.GetGroupCount() == 2 && registry.GetClientCount() == 3;
+    auto recipients = registry.GetRecipients(analysis);
+    std::sort(recipients.begin(), recipients.end());
+    bool delivered = recipients == std::vector<std::string>{"a", "b", "c"} &&
+                     registry.GetRecipients(low) == std::vector<std::string>{"c"};
+    registry.Subscribe("c", filter);    // Resubscribing moves the client
+    registry.Unsubscribe("a");
+    bool regrouped = registry.GetGroupCount() == 1 && registry.GetClientCount() == 2 &&
+                     registry.GetEventTypes("b") == filter.event_types && registry.GetEventTypes("a").empty();
+
+    return parsed && keyed && matches && missing && grouped && delivered && regrouped;
+}
+
+bool test_delta_replication() {
+    StorageConfig storage_config;
+    storage_config.master_password = "replication_test_pass";
+    storage_config.security_level = SecurityLevel::STANDARD;
+    
+    EncryptedStorageManager workstation;
+    storage_config.storage_path = "replication_test_data/workstation";
+    storage_config.database_name = "workstation.db";
+    bool initialized = workstation.Initialize(storage_config);
+    
+    EncryptedStorageManager aggregator;
+    storage_config.storage_path = "replication_test_data/aggregator";
+    storage_config.database_name = "aggregator.db";
+    initialized = aggregator.Initialize(storage_config) && initialized;
+    if (!initialized) {
+        return false;
+    }
+    
+    auto now = std::chrono::system_clock::now();
+    std::vector<WindowActivityRecord> activities;
+    std::vector<ContentAnalysisRecord> analyses;
+    for (int i = 0; i < 60; ++i) {
+        WindowActivityRecord activity;
+        activity.timestamp = now - std::chrono::minutes(i);
+        activity.application_name = (i % 3 == 0) ? "terminal" : "editor";
+        activity.window_title = "secret.txt";
+        activity.event_type = "focused";
+        activities.push_back(activity);
+        
+        ContentAnalysisRecord analysis;
+        analysis.timestamp = activity.timestamp;
+        analysis.application_name = activity.application_name;
+        analysis.extracted_text = "confidential text";
+        analysis.is_productive = (i % 2 == 0);
+        analysis.ai_confidence = 0.75f;
+        analyses.push_back(analysis);
+    }
+    bool stored = workstation.StoreBatch(activities, analyses);
+    
+    // Two deltas of at most 80 records, text stripped as the client does
+    std::vector<ReplicationDelta> deltas;
+    uint64_t position = 0;
+    for (int i = 0; i < 2; ++i) {
+        ReplicationDelta delta;
+        delta.workstation = "ws-1";
+        delta.source_id = 42;
+        delta.base = position;
+        workstation.GetRecordsAfter(position, 80, delta.activities, delta.analyses, delta.sequence);
+        for (auto& activity : delta.activities) {
+            activity.window_title.clear();
+        }
+        for (auto& analysis : delta.analyses) {
+            analysis.extracted_text.clear();
+        }
+        position = delta.sequence;
+        deltas.push_back(delta);
+    }
+    
+    ReplicationDelta decoded;
+    auto encoded = replication_utils::EncodeDelta(deltas[0]);
+    bool round_trip = replication_utils::DecodeDelta(encoded, decoded) &&
+                      decoded.sequence == deltas[0].sequence &&
+                      decoded.activities.size() + decoded.analyses.size() == 80 &&
+                      decoded.analyses.back().ai_confidence == 0.75f &&
+                      decoded.activities.front().application_name == deltas[0].activities.front().application_name;
+    encoded.resize(encoded.size() / 2);
+    bool truncated_rejected = !replication_utils::DecodeDelta(encoded, decoded);
+    
+    // One table entry referenced by every record must not expand past the
+    // decode limit
+    ReplicationDelta amplified;
+    amplified.workstation = "ws-1";
+    amplified.activities.resize(65);
+    for (auto& activity : amplified.activities) {
+        activity.timestamp = now;
+        activity.window_title.assign(1024 * 1024, 'x');
+    }
+    bool amplification_rejected = !replication_utils::DecodeDelta(replication_utils::EncodeDelta(amplified), decoded);
+    amplified.activities.clear();
+    
+    bool token_checked = replication_utils::IsAuthorized("Bearer team-secret", "team-secret") &&
+                         !replication_utils::IsAuthorized("Bearer team-secreT", "team-secret") &&
+                         !replication_utils::IsAuthorized("team-secret", "team-secret") &&
+                         !replication_utils::IsAuthorized("Bearer ", "");
+    
+    // Out of order: the second delta before the first is refused with
+    // the position to resume from
+    auto gap = api_handlers::ApplyReplicationDelta(replication_utils::EncodeDelta(deltas[1]), &aggregator);
+    auto first = api_handlers::ApplyReplicationDelta(replication_utils::EncodeDelta(deltas[0]), &aggregator);
+    auto repeat = api_handlers::ApplyReplicationDelta(replication_utils::EncodeDelta(deltas[0]), &aggregator);
+    auto second = api_handlers::ApplyReplicationDelta(replication_utils::EncodeDelta(deltas[1]), &aggregator);
+    auto resume = api_handlers::GetReplicationPosition("ws-1", 42, &aggregator);
+    
+    // The aggregator's rollups match the workstation's; no text arrived
+    auto local_usage = api_handlers::GetApplicationUsage(now - std::chrono::hours(2), now, &workstation);
+    auto merged_usage = api_handlers::GetApplicationUsage(now - std::chrono::hours(2), now, &aggregator);
+    auto leaked = api_handlers::SearchContent("confidential", 10, &aggregator);
+    auto merged_activities = aggregator.GetWindowActivities(now - std::chrono::hours(2), now);
+    bool tagged = !merged_activities.empty();
+    for (const auto& activity : merged_activities) {
+        tagged = tagged && activity.session_id == "ws-1";
+    }
+    
+    workstation.Shutdown();
+    aggregator.Shutdown();
+    
+    try {
+        std::filesystem::remove_all("replication_test_data");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    const std::string sequence = "\"sequence\":" + std::to_string(position);
+    return stored && round_trip && truncated_rejected && amplification_rejected && token_checked &&
+           tagged && position == deltas[0].sequence + 40 &&
+           gap.status_code == 409 && gap.data.find("\"sequence\":0") != std::string::npos &&
+           first.success && first.data.find("\"applied\":80") != std::string::npos &&
+           repeat.success && repeat.data.find("\"applied\":0") != std::string::npos &&
+           second.success && second.data.find("\"applied\":40") != std::string::npos &&
+           resume.data.find(sequence) != std::string::npos &&
+           merged_usage.data == local_usage.data &&
+           leaked.data.find("\"total_results\": 0") != std::string::npos;
+}
+
+// Backend producing a fixed sequence of desktop frames; a repeated frame
+// is reported unchanged like a damage-tracking backend would
+class ScriptedCapture : public IScreenCapture {
+public:
+    explicit ScriptedCapture(std::vector<CaptureFrame> frames) : m_frames(std::move(frames)) {}
+
+    bool Initialize() override { return true; }
+    void Shutdown() override {}
+    std::vector<MonitorInfo> GetMonitors() const override {
+        return {MonitorInfo{0, "scripted", 0, 0, m_frames[0].width, m_frames[0].height, true}};
+    }
+    bool CaptureDesktop(CaptureFrame& frame) override {
+        bool changed = false;
+        return CaptureDesktopIncremental(frame, changed);
+    }
+    bool CaptureMonitor(int, CaptureFrame& frame) override { return CaptureDesktop(frame); }
+    bool CaptureWindow(WindowHandle, CaptureFrame&) override { return false; }
+    bool CaptureRegion(int, int, int, int, CaptureFrame&) override { return false; }
+    bool SupportsHardwareAcceleration() const override { return false; }
+    void SetCaptureSettings(bool, int) override {}
+
+    bool CaptureDesktopIncremental(CaptureFrame& frame, bool& changed) override {
+        const CaptureFrame& next = m_frames[std::min(m_next++, m_frames.size() - 1)];
+        changed = frame.data != next.data;
+        frame = next;
+        return true;
+    }
+
+private:
+    std::vector<CaptureFrame> m_frames;
+    size_t m_next = 0;
+};
+
+// Frames of more than one tile, each differing from the last in part
+std::vector<CaptureFrame> MakeScriptedFrames() {
+    std::vector<CaptureFrame> frames(3);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        CaptureFrame& frame = frames[i];
+        frame.width = 150;
+        frame.height = 70;
+        frame.bytes_per_pixel = 4;
+        frame.stride = frame.width * 4;
+        frame.format = ImageFormat::BGRA;
+        frame.timestamp = std::chrono::system_clock::now() + std::chrono::milliseconds(i);
+        frame.data.resize(frame.GetDataSize());
+        for (size_t b = 0; b < frame.data.size(); ++b) {
+            frame.data[b] = static_cast<uint8_t>(b < frame.data.size() / 2 ? b * 7 : b * 7 + i * 31);
+        }
+    }
+    return frames;
+}
+
+// Records the frames through a wrapped backend; the last call repeats the
+// final frame and must not be recorded
+bool RecordScriptedFrames(const std::string& path, const std::vector<CaptureFrame>& frames) {
+    auto recorder = std::make_shared<CaptureRecorder>();
+    bool recorded = recorder->Open(path);
+    {
+        auto capture = CaptureRecorder::WrapBackend(std::make_unique<ScriptedCapture>(frames), recorder);
+        recorded = recorded && capture->Initialize();
+        CaptureFrame frame;
+        for (size_t i = 0; i <= frames.size(); ++i) {
+            bool changed = false;
+            recorded = capture->CaptureDesktopIncremental(frame, changed) && recorded;
+        }
+    }
+    recorded = recorded && recorder->GetStatistics().frames == frames.size();
+    recorder->Close();
+    return recorded;
+}
+
+// Replays a recording as fast as possible; false unless it opens and
+// reaches its end
+bool ReplayRecording(const std::string& path, std::vector<CaptureFrame>& replayed) {
+    CaptureReplayOptions options;
+    options.speed = 0.0;
+    auto replay = std::make_shared<CaptureReplay>();
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+    bool opened = replay->Open(path, options);
+    if (opened) {
+        replay->SetFinishedCallback([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+            done.notify_all();
+        });
+        auto capture = replay->CreateScreenCapture();
+        opened = capture->Initialize() && capture->StartStreaming([&](const CaptureFrame& frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            replayed.push_back(frame);
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait_for(lock, std::chrono::seconds(10), [&]() { return finished; });
+        lock.unlock();
+        capture->StopStreaming();
+    }
+    replay->Close();
+    return opened && finished;
+}
+
+bool test_capture_record_replay() {
+    std::filesystem::create_directories("capture_test_data");
+    const std::string path = "capture_test_data/session.wacr";
+    
+    std::vector<CaptureFrame> frames = MakeScriptedFrames();
+    bool recorded = RecordScriptedFrames(path, frames);
+    
+    std::vector<CaptureFrame> replayed;
+    bool finished = ReplayRecording(path, replayed);
+    
+    bool identical = replayed.size() == frames.size();
+    for (size_t i = 0; identical && i < frames.size(); ++i) {
+        const CaptureFrame& original = frames[i];
+        const CaptureFrame& frame = replayed[i];
+        identical = frame.width == original.width && frame.height == original.height &&
+                    frame.bytes_per_pixel == original.bytes_per_pixel;
+        const int stride = frame.stride > 0 ? frame.stride : frame.width * frame.bytes_per_pixel;
+        for (int row = 0; identical && row < original.height; ++row) {
+            identical = std::equal(original.data.begin() + row * original.stride,
+                                   original.data.begin() + (row + 1) * original.stride,
+                                   frame.data.begin() + row * stride);
+        }
+    }
+    
+    try {
+        std::filesystem::remove_all("capture_test_data");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return recorded && finished && identical;
+}
+
+bool test_capture_replay_corrupt_frames() {
+    std::filesystem::create_directories("capture_test_data");
+    const std::string path = "capture_test_data/corrupt.wacr";
+    bool recorded = RecordScriptedFrames(path, MakeScriptedFrames());
+    
+    // Patch the frame records in place, following the on-disk layout: a
+    // 64-byte file header, then 8-byte aligned records of a 16-byte record
+    // header and a payload starting with the frame header
+    const size_t fileHeaderSize = 64;
+    const size_t recordHeaderSize = 16;
+    const size_t compressedOffset = 2;
+    const size_t dirtyCountOffset = 32;
+    const size_t rawBytesOffset = 40;
+    const uint32_t frameRecord = 2;
+    
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    int patched = 0;
+    for (size_t offset = fileHeaderSize; offset + recordHeaderSize + rawBytesOffset + 8 <= bytes.size();) {
+        uint32_t type = 0, size = 0;
+        std::memcpy(&type, &bytes[offset], sizeof(type));
+        std::memcpy(&size, &bytes[offset + 4], sizeof(size));
+        char* frame = &bytes[offset + recordHeaderSize];
+        if (type == frameRecord && patched == 0) {
+            // A dirty rect count the payload cannot hold
+            const uint32_t count = 0xFFFFFFFFu;
+            std::memcpy(frame + dirtyCountOffset, &count, sizeof(count));
+            ++patched;
+        } else if (type == frameRecord && patched == 1) {
+            // Claims uncompressed pixels beyond the stored bytes
+            uint32_t rawBytes = 0;
+            std::memcpy(&rawBytes, frame + rawBytesOffset, sizeof(rawBytes));
+            rawBytes += 4096;
+            frame[compressedOffset] = 0;
+            std::memcpy(frame + rawBytesOffset, &rawBytes, sizeof(rawBytes));
+            ++patched;
+        }
+        offset += (recordHeaderSize + size + 7) & ~size_t(7);
+    }
+    file.seekp(0);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    
+    // Corrupt frames are skipped, and the delta frame after them has no
+    // chain to apply to; replay still runs to the end
+    std::vector<CaptureFrame> replayed;
+    bool finished = ReplayRecording(path, replayed);
+    
+    try {
+        std::filesystem::remove_all("capture_test_data");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return recorded && patched == 2 && finished && replayed.empty();
+}
+
 bool test_full_pipeline() {
     // Test the complete pipeline: OCR -> AI -> Storage
     auto storage = std::make_shared<EncryptedStorageManager>();
@@ -320,6 +809,12 @@ int main() {
     // Run integration tests
     framework.run_test("Storage-AI Integration", test_storage_ai_integration);
     framework.run_test("Web-Storage Integration", test_web_storage_integration);
+    framework.run_test("Batched Dashboard Queries", test_batch_queries);
+    framework.run_test("Timeline Downsampling", test_timeline_downsampling);
+    framework.run_test("WebSocket Subscriptions", test_websocket_subscriptions);
+    framework.run_test("Delta Replication", test_delta_replication);
+    framework.run_test("Capture Record and Replay", test_capture_record_replay);
+    framework.run_test("Capture Replay Corrupt Frames", test_capture_replay_corrupt_frames);
     framework.run_test("Full Pipeline Test", test_full_pipeline);
     framework.run_test("Concurrent Operations", test_concurrent_operations);
     framework.run_test("Error Handling", test_error_handling);
@@ -1,7 +1,17 @@
 #include "storage_engine.h"
+#include "deferred_work_queue.h"
+#include "fingerprint_index.h"
+#include "vector_index.h"
+#include "range_query_executor.h"
+#include "record_cache.h"
 #include <iostream>
 #include <cassert>
 #include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
 
 using namespace work_assistant;
 
@@ -178,12 +188,600 @@ bool test_data_record_operations() {
     record.SetStringData("test data");
     record.checksum = storage_utils::CalculateChecksum(record.data);
     
-    // Test serialization
+    // Test serialization of an analysis converted from a record
+    ContentAnalysisRecord analysis;
+    analysis.session_id = record.session_id;
+    analysis.extracted_text = record.GetStringData();
     std::string json = storage_utils::SerializeToJson(
-        *reinterpret_cast<const ContentAnalysisRecord*>(&record)
+        ContentAnalysisRecord::FromDataRecord(analysis.ToDataRecord())
     );
     
-    return !json.empty() && json.find("test_session") != std::string::npos;
+    return storage_utils::VerifyChecksum(record.data, record.checksum) &&
+           !json.empty() && json.find("test_session") != std::string::npos;
+}
+
+bool test_deferred_job_serialization() {
+    DeferredJobRecord job;
+    job.id = 42;
+    job.enqueued_at = std::chrono::system_clock::now();
+    job.kind = "storage.maintenance";
+    job.payload = "{\"path\": \"C:\\data\"}\nline two";
+    job.cursor = "verify";
+    job.priority = 3;
+    job.attempts = 1;
+    
+    // Round trip through the storage representation
+    DeferredJobRecord restored = DeferredJobRecord::FromDataRecord(job.ToDataRecord());
+    
+    return restored.id == job.id &&
+           restored.kind == job.kind &&
+           restored.payload == job.payload &&
+           restored.cursor == job.cursor &&
+           restored.priority == job.priority &&
+           restored.attempts == job.attempts;
+}
+
+bool test_deferred_job_persistence() {
+    StorageConfig config;
+    config.storage_path = "test_storage";
+    config.database_name = "test_deferred.db";
+    config.master_password = "test_password_123";
+    config.security_level = SecurityLevel::STANDARD;
+    
+    // Never idle during the test, so the job stays pending
+    DeferredWorkConfig work_config;
+    work_config.idle_threshold = std::chrono::minutes(24 * 60);
+    work_config.run_on_ac_power = false;
+    
+    uint64_t id = 0;
+    {
+        auto storage = std::make_shared<EncryptedStorageManager>();
+        if (!storage->Initialize(config)) {
+            return false;
+        }
+        DeferredWorkQueue queue;
+        queue.Start(storage, work_config);
+        id = queue.Enqueue("test.persisted", "payload", 2);
+        queue.Stop();
+        storage->Shutdown();
+    }
+    
+    // Reopen the store: the job comes back, and the queue reuses it
+    bool restored = false;
+    size_t pending = 0;
+    uint64_t requeued = 0;
+    {
+        auto storage = std::make_shared<EncryptedStorageManager>();
+        if (!storage->Initialize(config)) {
+            return false;
+        }
+        for (const auto& job : storage->GetDeferredJobs()) {
+            restored = restored || (job.id == id && job.kind == "test.persisted" &&
+                                    job.payload == "payload" && job.priority == 2);
+        }
+        DeferredWorkQueue queue;
+        queue.Start(storage, work_config);
+        pending = queue.GetStatistics().pending_jobs;
+        requeued = queue.Enqueue("test.persisted", "payload", 2);
+        queue.Stop();
+        storage->Shutdown();
+    }
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return id > 0 && restored && pending == 1 && requeued == id;
+}
+
+bool test_screen_capture_thumbnails() {
+    StorageConfig config;
+    config.storage_path = "test_storage";
+    config.database_name = "test_thumbnails.db";
+    config.master_password = "test_password_123";
+    config.security_level = SecurityLevel::STANDARD;
+    
+    EncryptedStorageManager manager;
+    if (!manager.Initialize(config) || !manager.StartSession("test_session")) {
+        return false;
+    }
+    
+    CaptureFrame frame;
+    frame.width = 640;
+    frame.height = 360;
+    frame.bytes_per_pixel = 4;
+    frame.stride = frame.width * 4;
+    frame.format = ImageFormat::BGRX;
+    frame.data.assign(static_cast<size_t>(frame.stride) * frame.height, 128);
+    
+    bool stored = manager.StoreScreenCapture(frame, "Thumbnail test");
+    
+    // 640 px wide: the 64 and 256 levels exist, 1024 does not
+    auto now = std::chrono::system_clock::now();
+    auto levels = manager.GetScreenCaptureThumbnails(now - std::chrono::hours(1),
+                                                     now + std::chrono::hours(1));
+    
+    ScreenThumbnail small, fallback;
+    bool found = !levels.empty() &&
+                 manager.GetScreenCaptureThumbnail(levels[0].capture_id, 100, small) &&
+                 manager.GetScreenCaptureThumbnail(levels[0].capture_id, 1024, fallback);
+    
+    manager.EndSession();
+    manager.Shutdown();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    const uint8_t png_signature[4] = {0x89, 'P', 'N', 'G'};
+    return stored && found &&
+           levels.size() == 2 &&
+           small.width == 256 && small.height == 144 &&
+           fallback.width == 256 &&
+           small.data.size() > 8 && std::equal(png_signature, png_signature + 4, small.data.begin());
+}
+
+bool test_fingerprint_index() {
+    std::filesystem::create_directories("test_storage");
+    const std::string path = "test_storage/fingerprints.idx";
+    
+    const uint64_t screen = 0x0123456789ABCDEFULL;
+    const uint64_t other = ~screen;
+    bool ok = true;
+    {
+        FingerprintIndex index;
+        ok = ok && index.Open(path);
+        ok = ok && index.Add(screen, 10, 11);
+        ok = ok && index.Add(other, 20, 21);
+        ok = ok && index.Add(screen, 30, 31);   // Replaces the first entry
+        ok = ok && index.Size() == 2;
+    }
+    
+    // Reloaded from disk: a 3-bit difference matches, a 6-bit one does not
+    FingerprintIndex index;
+    FingerprintMatch match;
+    ok = ok && index.Open(path) && index.Size() == 2;
+    ok = ok && index.FindNearest(screen ^ 0x8000000100000001ULL, 4, match);
+    ok = ok && match.hash == screen && match.distance == 3 &&
+         match.ocr_record_id == 30 && match.analysis_record_id == 31;
+    ok = ok && !index.FindNearest(screen ^ 0x3F, 4, match);
+    index.Close();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return ok;
+}
+
+bool test_fingerprint_index_recovery() {
+    std::filesystem::create_directories("test_storage");
+    const std::string path = "test_storage/fingerprints.idx";
+    const size_t header = 8, entry = 24;
+    
+    const uint64_t screen = 0x0123456789ABCDEFULL;
+    const uint64_t other = ~screen;
+    bool ok = true;
+    {
+        FingerprintIndex index;
+        ok = ok && index.Open(path) && index.Add(screen, 10, 11);
+    }
+    {
+        // A crash mid-append leaves a partial entry behind
+        std::ofstream torn(path, std::ios::binary | std::ios::app);
+        torn.write("\x01\x02\x03\x04\x05", 5);
+    }
+    {
+        FingerprintIndex index;
+        ok = ok && index.Open(path) && index.Add(other, 20, 21);
+    }
+    FingerprintIndex index;
+    FingerprintMatch match;
+    ok = ok && index.Open(path) && index.Size() == 2;
+    ok = ok && index.FindNearest(other, 0, match) && match.ocr_record_id == 20;
+    ok = ok && std::filesystem::file_size(path) == header + 2 * entry;
+    
+    // Replacing one screen over and over leaves dead entries that get
+    // compacted away
+    for (uint64_t i = 0; ok && i < 5000; ++i) {
+        ok = index.Add(screen, 100 + i, 0);
+    }
+    ok = ok && index.Size() == 2 && std::filesystem::file_size(path) < header + 5000 * entry;
+    index.Close();
+    ok = ok && index.Open(path) && index.Size() == 2;
+    ok = ok && index.FindNearest(screen, 0, match) && match.ocr_record_id == 5099;
+    index.Close();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return ok;
+}
+
+bool test_fingerprint_index_recency() {
+    std::filesystem::create_directories("test_storage");
+    const std::string path = "test_storage/fingerprints.idx";
+    const size_t header = 8, entry = 24;
+    
+    // The query is one bit from each screen; the one added last wins
+    const uint64_t first = 0x0;
+    const uint64_t second = 0x3;
+    const uint64_t query = 0x1;
+    bool ok = true;
+    FingerprintIndex index;
+    FingerprintMatch match;
+    ok = ok && index.Open(path);
+    ok = ok && index.Add(first, 10, 0) && index.Add(second, 20, 0);
+    ok = ok && index.FindNearest(query, 1, match) && match.hash == second;
+    ok = ok && index.Add(first, 30, 0);     // A repeat becomes the newest
+    ok = ok && index.FindNearest(query, 1, match) && match.hash == first && match.ocr_record_id == 30;
+    index.Close();
+    ok = ok && index.Open(path) && index.FindNearest(query, 1, match) && match.hash == first;
+    
+    // Recency also survives compaction, which rewrites the file: stop right
+    // after the rewrite, before any further append
+    for (uint64_t i = 0; ok && i < 10000; ++i) {
+        ok = index.Add(first, 100 + i, 0);
+        if (std::filesystem::file_size(path) == header + 2 * entry) {
+            break;
+        }
+    }
+    ok = ok && std::filesystem::file_size(path) == header + 2 * entry;
+    index.Close();
+    ok = ok && index.Open(path) && index.FindNearest(query, 1, match) && match.hash == first;
+    
+    // An entry just past the distance limit is never returned
+    ok = ok && !index.FindNearest(0xF0, 3, match);
+    index.Close();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return ok;
+}
+
+bool test_vector_index() {
+    std::filesystem::create_directories("test_storage");
+    const std::string path = "test_storage/vectors.vdb";
+    
+    const int dimension = 32;
+    const int count = 300;
+    std::mt19937 rng(7);
+    std::normal_distribution<float> normal;
+    std::vector<std::vector<float>> vectors(count, std::vector<float>(dimension));
+    for (auto& vector : vectors) {
+        for (auto& value : vector) value = normal(rng);
+    }
+    
+    const auto base = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    auto at = [&](int i) { return base + std::chrono::seconds(i); };
+    
+    // Graph search (exact scans disabled) must still find every vector
+    VectorIndexConfig config;
+    config.exact_scan_limit = 0;
+    bool ok = true;
+    {
+        VectorIndex index;
+        ok = ok && index.Open(path, dimension, "model-a", config);
+        for (int i = 0; i < count; ++i) {
+            ok = ok && index.Add(i, at(i), vectors[i]);
+        }
+        index.SetWatermark(count);
+    }
+    
+    VectorIndex index;
+    ok = ok && index.Open(path, dimension, "model-a", config);
+    ok = ok && index.Size() == static_cast<size_t>(count) && index.GetWatermark() == static_cast<uint64_t>(count);
+    int found = 0;
+    for (int i = 0; i < count; i += 10) {
+        auto matches = index.Search(vectors[i], 1, at(0), at(count));
+        if (!matches.empty() && matches[0].id == static_cast<uint64_t>(i) && matches[0].similarity > 0.98f) {
+            found++;
+        }
+    }
+    ok = ok && found >= 29;
+    
+    // Time filter
+    auto matches = index.Search(vectors[5], 10, at(100), at(149));
+    ok = ok && matches.size() == 10;
+    for (const auto& match : matches) {
+        ok = ok && match.timestamp >= at(100) && match.timestamp <= at(149);
+    }
+    ok = ok && index.Search(vectors[5], 10, at(count + 1), at(count + 100)).empty();
+    index.Close();
+    
+    // Another model's vectors are discarded
+    ok = ok && index.Open(path, dimension, "model-b", config);
+    ok = ok && index.Size() == 0 && index.GetWatermark() == 0;
+    index.Close();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return ok;
+}
+
+bool test_range_queries() {
+    RangeQueryConfig range_config;
+    range_config.parallelism = 4;
+    RangeQueryExecutor executor(range_config);
+    
+    // Partitions tile the range: contiguous, non-overlapping, ends exact
+    auto now = std::chrono::system_clock::now();
+    auto begin = now - std::chrono::hours(24 * 90);
+    auto partitions = executor.Partition(begin, now);
+    bool tiled = partitions.size() >= 90 && partitions.front().start == begin && partitions.back().end == now;
+    for (size_t i = 1; i < partitions.size(); ++i) {
+        tiled = tiled && partitions[i].index == i &&
+                partitions[i].start == partitions[i - 1].end + std::chrono::seconds(1);
+    }
+    
+    // Short ranges are still spread across the workers
+    bool spread = executor.Partition(now - std::chrono::hours(8), now).size() == 4;
+    
+    // A cancelled query stops every partition and reports failure
+    bool cancelled = !executor.Execute(partitions,
+        [](const RangePartition&, const std::atomic<bool>& stop) {
+            while (!stop) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        },
+        []() { return true; });
+    
+    // Window events over 30 days, more than a single query page holds
+    StorageConfig config;
+    config.storage_path = "test_storage";
+    config.database_name = "test_range.db";
+    config.master_password = "test_password_123";
+    config.security_level = SecurityLevel::STANDARD;
+    
+    EncryptedStorageManager manager;
+    if (!manager.Initialize(config)) {
+        return false;
+    }
+    
+    std::vector<WindowActivityRecord> activities;
+    for (int i = 0; i < 2400; ++i) {
+        WindowActivityRecord activity;
+        activity.timestamp = now - std::chrono::minutes(i * 18);
+        activity.application_name = (i % 3 == 0) ? "browser" : "editor";
+        activity.window_title = "window " + std::to_string(i);
+        activity.event_type = "focused";
+        activities.push_back(activity);
+    }
+    bool stored = manager.StoreBatch(activities, {});
+    
+    auto usage = manager.GetTimeSpentByApplication(now - std::chrono::hours(24 * 31), now);
+    auto abandoned = manager.GetTimeSpentByApplication(now - std::chrono::hours(24 * 31), now,
+                                                       []() { return true; });
+    
+    manager.Shutdown();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    // 1600 editor and 800 browser events at 30 seconds each
+    return tiled && spread && cancelled && stored &&
+           usage.size() == 2 &&
+           usage[0].first == "editor" && usage[0].second.count() == 800 &&
+           usage[1].first == "browser" && usage[1].second.count() == 400 &&
+           abandoned.empty();
+}
+
+bool test_partition_pruning() {
+    StorageConfig config;
+    config.storage_path = "test_storage";
+    config.database_name = "test_pruning.db";
+    config.master_password = "test_password_123";
+    config.security_level = SecurityLevel::STANDARD;
+    
+    // One analysis a day for 10 days; only day 3 mentions the parser
+    auto now = std::chrono::system_clock::now();
+    std::vector<ContentAnalysisRecord> analyses;
+    for (int day = 0; day < 10; ++day) {
+        ContentAnalysisRecord analysis;
+        analysis.timestamp = now - std::chrono::hours(24 * day);
+        analysis.application_name = (day == 3) ? "editor" : "browser";
+        analysis.window_title = "day " + std::to_string(day);
+        analysis.extracted_text = (day == 3) ? "Refactor the Parser module" : "reading documentation";
+        analyses.push_back(analysis);
+    }
+    
+    EncryptedStorageManager manager;
+    if (!manager.Initialize(config)) {
+        return false;
+    }
+    bool stored = manager.StoreBatch({}, analyses);
+    
+    PruningStats by_text;
+    auto parser = manager.SearchContent("parser", 10, "", &by_text);
+    PruningStats by_app;
+    auto docs = manager.SearchContent("documentation", 20, "browser", &by_app);
+    auto none = manager.SearchContent("documentation", 20, "editor");
+    manager.Shutdown();
+    
+    // Synopses survive a restart
+    EncryptedStorageManager reopened;
+    if (!reopened.Initialize(config)) {
+        return false;
+    }
+    PruningStats after_restart;
+    auto again = reopened.SearchContent("parser", 10, "", &after_restart);
+    reopened.Shutdown();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return stored &&
+           parser.size() == 1 && parser[0].application_name == "editor" &&
+           by_text.partitions_scanned >= 1 && by_text.partitions_pruned >= 8 &&
+           docs.size() == 9 && by_app.partitions_pruned >= 1 &&
+           none.empty() &&
+           again.size() == 1 && after_restart.partitions_pruned == by_text.partitions_pruned;
+}
+
+bool test_record_cache() {
+    // One shard of 4 KiB holds three 1 KiB records; the least recently
+    // used goes first
+    RecordCache cache(4096, 1);
+    for (uint64_t id = 1; id <= 4; ++id) {
+        DataRecord record;
+        record.id = id;
+        record.type = RecordType::OCR_RESULT;
+        record.data.assign(900, static_cast<uint8_t>(id));
+        cache.Put(record);
+        if (id == 3) {
+            DataRecord touched;
+            cache.Get(1, touched);
+        }
+    }
+    DataRecord record;
+    bool lru = cache.Get(1, record) && record.data.size() == 900 && record.data[0] == 1 &&
+               !cache.Get(2, record) && cache.Get(4, record);
+    cache.Erase(4);
+    bool erased = !cache.Get(4, record);
+    auto cache_stats = cache.GetStats();
+    bool bounded = cache_stats.entries == 2 && cache_stats.bytes <= 4096;
+    
+    // Records are cached as they are written, so reading them back hits
+    StorageConfig config;
+    config.storage_path = "test_storage";
+    config.database_name = "test_cache.db";
+    config.master_password = "test_password_123";
+    config.security_level = SecurityLevel::STANDARD;
+    
+    EncryptedStorageManager manager;
+    if (!manager.Initialize(config)) {
+        return false;
+    }
+    
+    auto now = std::chrono::system_clock::now();
+    std::vector<WindowActivityRecord> activities;
+    for (int i = 0; i < 50; ++i) {
+        WindowActivityRecord activity;
+        activity.timestamp = now - std::chrono::minutes(i);
+        activity.application_name = "editor";
+        activity.window_title = "file " + std::to_string(i);
+        activity.event_type = "focused";
+        activities.push_back(activity);
+    }
+    bool stored = manager.StoreBatch(activities, {});
+    auto read = manager.GetWindowActivities(now - std::chrono::hours(1), now);
+    auto stats = manager.GetStatistics();
+    manager.Shutdown();
+    
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+    
+    return lru && erased && bounded && stored &&
+           read.size() == 50 && read.front().window_title == "file 0" &&
+           stats.record_cache_hits >= 50 && stats.record_cache_hit_rate > 0.5 &&
+           stats.record_cache_bytes > 0;
+}
+
+bool test_record_cache_invalidation() {
+    // A read that raced an update: its copy predates the invalidation, so
+    // it must not be cached
+    RecordCache cache(1 << 20);
+    DataRecord stale;
+    stale.id = 7;
+    stale.SetStringData("before");
+    uint64_t epoch = cache.GetEpoch();
+    cache.Erase(7);
+    cache.Put(stale, epoch);
+    DataRecord record;
+    bool dropped = !cache.Get(7, record);
+
+    epoch = cache.GetEpoch();
+    cache.Clear();
+    cache.Put(stale, epoch);
+    bool dropped_after_clear = !cache.Get(7, record);
+
+    epoch = cache.GetEpoch();
+    cache.Put(stale, epoch);
+    bool cached = cache.Get(7, record) && record.GetStringData() == "before";
+
+    // Updates interleaved with reads of the same record on the engine:
+    // once the writer is done, the cache serves the last version
+    StorageConfig config;
+    config.storage_path = "test_storage";
+    config.database_name = "test_cache_race.db";
+    config.master_password = "test_password_123";
+    config.security_level = SecurityLevel::STANDARD;
+
+    auto engine = StorageEngineFactory::Create();
+    if (!engine || !engine->Initialize(config) ||
+        (!engine->OpenDatabase(config.master_password) &&
+         (!engine->CreateDatabase() || !engine->OpenDatabase(config.master_password)))) {
+        return false;
+    }
+    DataRecord original;
+    original.type = RecordType::OCR_RESULT;
+    original.session_id = "test_session";
+    original.timestamp = std::chrono::system_clock::now();
+    original.SetStringData("version 0");
+    original.checksum = storage_utils::CalculateChecksum(original.data);
+    uint64_t id = engine->StoreRecord(original);
+
+    const int updates = 200;
+    QueryParams around;
+    around.start_time = original.timestamp - std::chrono::hours(1);
+    around.end_time = original.timestamp + std::chrono::hours(1);
+    std::atomic<bool> writing{true};
+    std::thread reader([&]() {
+        DataRecord read;
+        while (writing) {
+            engine->GetRecord(id, read);
+            engine->QueryRecords(around);
+        }
+    });
+    bool updated = id != 0;
+    for (int i = 1; i <= updates && updated; ++i) {
+        DataRecord next = original;
+        next.id = id;
+        next.SetStringData("version " + std::to_string(i));
+        next.checksum = storage_utils::CalculateChecksum(next.data);
+        updated = engine->UpdateRecord(next);
+    }
+    writing = false;
+    reader.join();
+
+    DataRecord last;
+    bool current = engine->GetRecord(id, last) && last.GetStringData() == "version " + std::to_string(updates);
+    engine->Shutdown();
+
+    try {
+        std::filesystem::remove_all("test_storage");
+    } catch (...) {
+        // Ignore cleanup errors
+    }
+
+    return dropped && dropped_after_clear && cached && updated && current;
 }
 
 int main() {
@@ -203,6 +801,17 @@ int main() {
     framework.run_test("Storage Config Validation", test_storage_config);
     framework.run_test("Encrypted Storage Manager", test_encrypted_storage_manager);
     framework.run_test("Data Record Operations", test_data_record_operations);
+    framework.run_test("Deferred Job Serialization", test_deferred_job_serialization);
+    framework.run_test("Deferred Job Persistence", test_deferred_job_persistence);
+    framework.run_test("Screen Capture Thumbnails", test_screen_capture_thumbnails);
+    framework.run_test("Fingerprint Index", test_fingerprint_index);
+    framework.run_test("Fingerprint Index Recovery", test_fingerprint_index_recovery);
+    framework.run_test("Fingerprint Index Recency", test_fingerprint_index_recency);
+    framework.run_test("Vector Index", test_vector_index);
+    framework.run_test("Range Queries", test_range_queries);
+    framework.run_test("Partition Pruning", test_partition_pruning);
+    framework.run_test("Record Cache", test_record_cache);
+    framework.run_test("Record Cache Invalidation", test_record_cache_invalidation);
     
     return framework.summary();
 }
\ No newline at end of file
@@ -118,11 +118,28 @@ class WorkAssistantApp {
     
     async loadInitialData() {
         try {
-            // Load application status
-            const statusResponse = await fetch(`${this.apiBase}/api/status`);
-            if (statusResponse.ok) {
-                const status = await statusResponse.json();
-                this.updateApplicationStatus(status);
+            // Status, productivity summary and recent activities in one round
+            // trip; the server answers both ranged queries from one scan
+            const batchResponse = await fetch(`${this.apiBase}/api/v1/batch`, {
+                method: 'POST',
+                headers: { 'Content-Type': 'application/json' },
+                body: JSON.stringify({
+                    queries: { status: {}, summary: {}, timeline: {} }
+                })
+            });
+            if (batchResponse.ok) {
+                const batch = await batchResponse.json();
+                const results = (batch.data && batch.data.results) || {};
+                
+                if (results.status && results.status.success) {
+                    this.updateApplicationStatus(results.status.data.components || {});
+                }
+                if (results.summary && results.summary.success) {
+                    this.updateProductivitySummary(results.summary.data);
+                }
+                if (results.timeline && results.timeline.success) {
+                    this.updateRecentActivities(results.timeline.data.activities.slice(0, 10));
+                }
             }
             
             // Load OCR statistics
@@ -131,13 +148,6 @@ class WorkAssistantApp {
                 const stats = await statsResponse.json();
                 this.updateStats(stats);
             }
-            
-            // Load recent activities
-            const activitiesResponse = await fetch(`${this.apiBase}/api/activities/recent`);
-            if (activitiesResponse.ok) {
-                const activities = await activitiesResponse.json();
-                this.updateRecentActivities(activities);
-            }
         } catch (error) {
             console.error('Failed to load initial data:', error);
             this.showError('Failed to load application data');
@@ -232,6 +242,17 @@ class WorkAssistantApp {
         }
     }
     
+    updateProductivitySummary(summary) {
+        const statusEl = document.getElementById('app-status');
+        if (!statusEl || !summary.productivity) return;
+        
+        const topApp = (summary.applications && summary.applications[0]) || null;
+        const summaryEl = document.createElement('div');
+        summaryEl.innerHTML = `<strong>Productivity:</strong> ${summary.productivity.level} (${summary.productivity.score})` +
+            (topApp ? `, mostly ${topApp.name}` : '');
+        statusEl.appendChild(summaryEl);
+    }
+    
     updateStats(stats) {
         this.stats = { ...this.stats, ...stats };
         
@@ -323,7 +344,7 @@ class WorkAssistantApp {
             activityEl.innerHTML = `
                 <div class="activity-time">${new Date(activity.timestamp).toLocaleString()}</div>
                 <div class="activity-window">${activity.window_title}</div>
-                <div class="activity-content">${activity.content_summary}</div>
+                <div class="activity-content">${activity.content_summary || activity.application || ''}</div>
                 <div class="activity-category">${activity.work_category}</div>
             `;
             